@@ -61,6 +61,31 @@ int bench_oop_core(
         int n_out = conv_oop(signal, &state, filter, sz_filter, y);
         n_out_sum += n_out;
     }
+    perf_counter.set_samples(n_out_sum, __func__);
+    return n_out_sum;
+}
+
+int bench_sym_oop_core(
+        const conv_f_ptrs & conv_arch,
+        const float * signal, const int sz_signal,
+        const float * filter, const int sz_filter,
+        const int blockLen,
+        float * y
+        )
+{
+    conv_buffer_state state;
+    const auto conv_sym_oop = conv_arch.fp_conv_float_sym_oop;
+    int n_out_sum = 0;
+    state.offset = 0;
+    state.size = 0;
+    papi_perf_counter perf_counter(1);
+    for (int off = 0; off + blockLen <= sz_signal; off += blockLen)
+    {
+        state.size += blockLen;
+        int n_out = conv_sym_oop(signal, &state, filter, sz_filter, y);
+        n_out_sum += n_out;
+    }
+    perf_counter.set_samples(n_out_sum, __func__);
     return n_out_sum;
 }
 
@@ -83,6 +108,7 @@ int bench_inplace_core(
         int n_out = conv_inplace(signal, &state, filter, sz_filter);
         n_out_sum += n_out;
     }
+    perf_counter.set_samples(n_out_sum, __func__);
     return n_out_sum;
 }
 
@@ -112,6 +138,7 @@ int bench_oop(
         int n_out = conv_oop(buffer, &state, filter, sz_filter, &y[n_out_sum]);
         n_out_sum += n_out;
     }
+    perf_counter.set_samples(n_out_sum, __func__);
     return n_out_sum;
 }
 
@@ -144,6 +171,63 @@ int bench_cx_real_oop(
         int n_out = conv_oop(buffer, &state, filter, sz_filter, &y[n_out_sum]);
         n_out_sum += n_out;
     }
+    perf_counter.set_samples(n_out_sum, __func__);
+    return n_out_sum;
+}
+
+int bench_decim_oop(
+        const conv_f_ptrs & conv_arch,
+        float * buffer,
+        const float * signal, const int sz_signal,
+        const float * filter, const int sz_filter, const int decim,
+        const int blockLen,
+        float * y
+        )
+{
+    conv_buffer_state state;
+    const auto conv_decim_oop = conv_arch.fp_conv_float_decim_oop;
+    const auto move_rest = conv_arch.fp_conv_float_move_rest;
+    int n_out_sum = 0;
+    state.offset = 0;
+    state.size = 0;
+    papi_perf_counter perf_counter(1);
+    for (int off = 0; off + blockLen <= sz_signal; off += blockLen)
+    {
+        move_rest(buffer, &state);
+        std::copy(&signal[off], &signal[off+blockLen], buffer+state.size);
+        state.size += blockLen;
+        int n_out = conv_decim_oop(buffer, &state, filter, sz_filter, decim, &y[n_out_sum]);
+        n_out_sum += n_out;
+    }
+    perf_counter.set_samples(n_out_sum, __func__);
+    return n_out_sum;
+}
+
+int bench_interp_oop(
+        const conv_f_ptrs & conv_arch,
+        float * buffer,
+        const float * signal, const int sz_signal,
+        const float * filter, const int sz_filter, const int interp,
+        const int blockLen,
+        float * y
+        )
+{
+    conv_buffer_state state;
+    const auto conv_interp_oop = conv_arch.fp_conv_float_interp_oop;
+    const auto move_rest = conv_arch.fp_conv_float_move_rest;
+    int n_out_sum = 0;
+    state.offset = 0;
+    state.size = 0;
+    papi_perf_counter perf_counter(1);
+    for (int off = 0; off + blockLen <= sz_signal; off += blockLen)
+    {
+        move_rest(buffer, &state);
+        std::copy(&signal[off], &signal[off+blockLen], buffer+state.size);
+        state.size += blockLen;
+        int n_out = conv_interp_oop(buffer, &state, filter, sz_filter, interp, &y[n_out_sum]);
+        n_out_sum += n_out * interp;
+    }
+    perf_counter.set_samples(n_out_sum, __func__);
     return n_out_sum;
 }
 
@@ -173,6 +257,8 @@ int main(int argc, char *argv[])
             seed_filter = atoi(argv[++i]);
         else if (!strcmp(argv[i], "-v"))
             verbose = true;
+        else if (!strcmp(argv[i], "--counters"))
+            papi_perf_counter::enable(true);
         else if (!strcmp(argv[i], "-h"))
             showUsage = exitFromUsage = true;
         else
@@ -197,6 +283,7 @@ int main(int argc, char *argv[])
     {
         fprintf(stderr, "%s [-v] [-a <arch>] [-n <total # of MSamples> [-f <filter length>] [-b <blockLength in samples>]\n", argv[0]);
         fprintf(stderr, "    [-ss <random seed for signal>] [-sf <random seed for filter coeffs>]\n");
+        fprintf(stderr, "    [--counters]  report hardware counters: cycles/sample, IPC, cache misses, ..\n");
         fprintf(stderr, "arch is one of:");
         for (int a = 0; a < num_arch; ++a)
             if (conv_arch_ptrs[a])
@@ -213,6 +300,8 @@ int main(int argc, char *argv[])
         #else
         fprintf(stderr, "PAPI is NOT available!\n");
         #endif
+        if (papi_perf_counter::enabled() && papi_perf_counter::counters())
+            fprintf(stderr, "hardware counters from %s\n", bench_counters_backend(papi_perf_counter::counters()));
     }
     #if !defined(HAVE_MIPP)
     fprintf(stderr, "MIPP is NOT available!\n");
@@ -236,7 +325,12 @@ int main(int argc, char *argv[])
     }
     //const int max_simd_size = *std::max_element( &float_simd_size[0], &float_simd_size[num_arch] );
     if (verbose)
+    {
         fprintf(stderr, "max float simd size: %d\n", max_simd_size);
+        fprintf(stderr, "best arch by order: '%s', by micro-benchmark: '%s'\n",
+            get_best_conv_arch_ptrs(CONV_ARCH_SELECT_BY_ORDER)->id,
+            get_best_conv_arch_ptrs(CONV_ARCH_SELECT_BY_BENCH)->id);
+    }
 
 #if TEST_WITH_MIN_LEN
     filterLen = 2;
@@ -289,6 +383,59 @@ int main(int argc, char *argv[])
     fprintf(stderr, "\n");
 #endif
 
+    {
+        // symmetric filter: folded kernel - compared against the generic one
+        MIPP_VECTOR<float> filter_sym(filter);
+        for (int k = 0; k < filterLen / 2; ++k)
+            filter_sym[filterLen - 1 - k] = filter_sym[k];
+        MIPP_VECTOR<float> y_sym(N + 1, 0.0F);
+        fprintf(stderr, "\nrunning out-of-place symmetric convolution core for '%s':\n", conv_arch.id);
+        int n_sym_out = bench_sym_oop_core(conv_arch, s.data(), N, filter_sym.data(), filterLen, blockLen, y_sym.data());
+        fprintf(stderr, "sym oop produced %d output samples\n", n_sym_out);
+        n_oop_out = bench_oop_core(conv_arch, s.data(), N, filter_sym.data(), filterLen, blockLen, y.data());
+        float max_err = 0.0F;
+        for (int k = 0; k < std::min(n_sym_out, n_oop_out); ++k)
+            max_err = std::max(max_err, std::fabs(y_sym[k] - y[k]));
+        fprintf(stderr, "sym oop: max deviation from non-sym oop: %g\n", max_err);
+        assert(n_sym_out == n_oop_out);
+    }
+
+    {
+        // polyphase decimation: every decim'th output of the generic kernel
+        const int decim = 3;
+        MIPP_VECTOR<float> y_dec(N / decim + 1, 0.0F);
+        n_oop_out = bench_oop_core(conv_arch, s.data(), N, filter.data(), filterLen, blockLen, y.data());
+        fprintf(stderr, "\nrunning out-of-place decimating (by %d) convolution for '%s':\n", decim, conv_arch.id);
+        int n_dec_out = bench_decim_oop(conv_arch, buffer.data(), s.data(), N, filter.data(), filterLen, decim, blockLen, y_dec.data());
+        fprintf(stderr, "decim oop produced %d output samples\n", n_dec_out);
+        float max_err = 0.0F;
+        for (int k = 0; k < n_dec_out; ++k)
+            max_err = std::max(max_err, std::fabs(y_dec[k] - y[k * decim]));
+        fprintf(stderr, "decim oop: max deviation from non-decimating oop: %g\n", max_err);
+        assert(n_dec_out == (n_oop_out + decim - 1) / decim);
+        assert(buffer[blockLen + filterLen] == 789.0F);
+    }
+
+    {
+        // polyphase interpolation: compared against the generic kernel on the zero-stuffed signal
+        const int interp = 4;
+        const int N_in = N / interp;
+        MIPP_VECTOR<float> s_up(N_in * interp, 0.0F);
+        MIPP_VECTOR<float> y_int(N_in * interp + 1, 0.0F);
+        for (int k = 0; k < N_in; ++k)
+            s_up[k * interp] = s[k];
+        n_oop_out = bench_oop_core(conv_arch, s_up.data(), N_in * interp, filter.data(), filterLen, blockLen * interp, y.data());
+        fprintf(stderr, "\nrunning out-of-place interpolating (by %d) convolution for '%s':\n", interp, conv_arch.id);
+        int n_int_out = bench_interp_oop(conv_arch, buffer.data(), s.data(), N_in, filter.data(), filterLen, interp, blockLen, y_int.data());
+        fprintf(stderr, "interp oop produced %d output samples\n", n_int_out);
+        float max_err = 0.0F;
+        for (int k = 0; k < std::min(n_int_out, n_oop_out); ++k)
+            max_err = std::max(max_err, std::fabs(y_int[k] - y[k]));
+        fprintf(stderr, "interp oop: max deviation from oop on zero-stuffed input: %g\n", max_err);
+        assert(n_int_out <= n_oop_out && n_int_out + interp > n_oop_out);
+        assert(buffer[blockLen + filterLen] == 789.0F);
+    }
+
     fprintf(stderr, "\nrunning out-of-place convolution for '%s':\n", conv_arch.id);
     n_oop_out = bench_oop(conv_arch, buffer.data(), s.data(), N, filter.data(), filterLen, blockLen, y.data());
     fprintf(stderr, "oop produced %d output samples\n", n_oop_out);
@@ -0,0 +1,303 @@
+/*
+  hardware performance counters for the benchmarks: see bench_counters.h
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "bench_counters.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_PAPI
+#  include <papi.h>
+#endif
+
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  include <stdint.h>
+#  define HAVE_PERF_EVENT 1
+#endif
+
+
+struct bench_counters
+{
+  const char * backend;
+  int available[BENCH_NUM_COUNTERS];
+#ifdef HAVE_PAPI
+  int event_set;
+  int num_papi;
+  int papi_index[BENCH_NUM_COUNTERS];   /* position in PAPI's values, -1 if not added */
+#endif
+#ifdef HAVE_PERF_EVENT
+  int fd[BENCH_NUM_COUNTERS];           /* -1 if not available */
+#endif
+};
+
+
+static const char * counter_names[BENCH_NUM_COUNTERS] = {
+  "cycles", "instructions", "L1D misses", "L2 misses", "LLC misses", "vector instructions"
+};
+
+const char * bench_counter_name(int counter)
+{
+  return (counter >= 0 && counter < BENCH_NUM_COUNTERS) ? counter_names[counter] : "";
+}
+
+
+#ifdef HAVE_PAPI
+
+static int papi_open(bench_counters * c)
+{
+  /* alternatives, if the first one isn't available on the CPU */
+  static const int events[BENCH_NUM_COUNTERS][2] = {
+    { PAPI_TOT_CYC, PAPI_REF_CYC },
+    { PAPI_TOT_INS, PAPI_TOT_INS },
+    { PAPI_L1_DCM,  PAPI_L1_TCM },
+    { PAPI_L2_DCM,  PAPI_L2_TCM },
+    { PAPI_L3_TCM,  PAPI_L3_DCM },
+    { PAPI_VEC_INS, PAPI_VEC_SP }
+  };
+  int k, a, num = 0;
+
+  if (PAPI_library_init(PAPI_VER_CURRENT) != PAPI_VER_CURRENT)
+    return 0;
+  c->event_set = PAPI_NULL;
+  if (PAPI_create_eventset(&c->event_set) != PAPI_OK)
+    return 0;
+  for (k = 0; k < BENCH_NUM_COUNTERS; ++k)
+  {
+    c->papi_index[k] = -1;
+    for (a = 0; a < 2 && c->papi_index[k] < 0; ++a)
+    {
+      if (PAPI_query_event(events[k][a]) == PAPI_OK && PAPI_add_event(c->event_set, events[k][a]) == PAPI_OK)
+      {
+        c->papi_index[k] = num++;
+        c->available[k] = 1;
+      }
+    }
+  }
+  c->num_papi = num;
+  if (!num)
+  {
+    PAPI_destroy_eventset(&c->event_set);
+    return 0;
+  }
+  c->backend = "PAPI";
+  return 1;
+}
+
+#endif
+
+
+#ifdef HAVE_PERF_EVENT
+
+static int perf_open_event(uint32_t type, uint64_t config)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  /* the events are not grouped: the kernel multiplexes them, if there are too
+   * few hardware counters. the times allow scaling of the values */
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return (int)syscall(__NR_perf_event_open, &attr, 0 /* this process */, -1 /* any cpu */, -1, 0);
+}
+
+/* raw event config from an environment variable */
+static int perf_open_raw_env(const char * env)
+{
+  const char * v = getenv(env);
+  if (!v || !v[0])
+    return -1;
+  return perf_open_event(PERF_TYPE_RAW, (uint64_t)strtoull(v, NULL, 0));
+}
+
+#define PERF_CACHE_CONFIG(CACHE, OP, RESULT) \
+  ((uint64_t)(CACHE) | ((uint64_t)(OP) << 8) | ((uint64_t)(RESULT) << 16))
+
+static int perf_open(bench_counters * c)
+{
+  int k, num = 0;
+  c->fd[BENCH_CNT_CYCLES] = perf_open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  c->fd[BENCH_CNT_INSTRUCTIONS] = perf_open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  c->fd[BENCH_CNT_L1D_MISSES] = perf_open_event(PERF_TYPE_HW_CACHE,
+      PERF_CACHE_CONFIG(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+  c->fd[BENCH_CNT_L2_MISSES] = perf_open_raw_env("PF_BENCH_L2_EVENT");
+  c->fd[BENCH_CNT_LLC_MISSES] = perf_open_event(PERF_TYPE_HW_CACHE,
+      PERF_CACHE_CONFIG(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+  c->fd[BENCH_CNT_VEC_INS] = perf_open_raw_env("PF_BENCH_VEC_EVENT");
+  for (k = 0; k < BENCH_NUM_COUNTERS; ++k)
+  {
+    c->available[k] = (c->fd[k] >= 0);
+    num += c->available[k];
+  }
+  if (!num)
+    return 0;
+  c->backend = "perf_event";
+  return 1;
+}
+
+static void perf_close(bench_counters * c)
+{
+  int k;
+  for (k = 0; k < BENCH_NUM_COUNTERS; ++k)
+    if (c->fd[k] >= 0)
+      close(c->fd[k]);
+}
+
+#endif
+
+
+bench_counters * bench_counters_open(void)
+{
+  bench_counters * c = (bench_counters *)calloc(1, sizeof(bench_counters));
+  int k;
+  if (!c)
+    return NULL;
+#ifdef HAVE_PERF_EVENT
+  for (k = 0; k < BENCH_NUM_COUNTERS; ++k)
+    c->fd[k] = -1;
+#endif
+  (void)k;
+#ifdef HAVE_PAPI
+  if (papi_open(c))
+    return c;
+#endif
+#ifdef HAVE_PERF_EVENT
+  if (perf_open(c))
+    return c;
+  perf_close(c);
+#endif
+  free(c);
+  return NULL;
+}
+
+
+void bench_counters_close(bench_counters * c)
+{
+  if (!c)
+    return;
+#ifdef HAVE_PAPI
+  if (c->num_papi)
+  {
+    PAPI_cleanup_eventset(c->event_set);
+    PAPI_destroy_eventset(&c->event_set);
+  }
+#endif
+#ifdef HAVE_PERF_EVENT
+  perf_close(c);
+#endif
+  free(c);
+}
+
+
+const char * bench_counters_backend(const bench_counters * c)
+{
+  return c ? c->backend : "none";
+}
+
+
+int bench_counters_start(bench_counters * c)
+{
+  int k;
+  if (!c)
+    return -1;
+#ifdef HAVE_PAPI
+  if (c->num_papi)
+    return (PAPI_start(c->event_set) == PAPI_OK) ? 0 : -1;
+#endif
+#ifdef HAVE_PERF_EVENT
+  for (k = 0; k < BENCH_NUM_COUNTERS; ++k)
+  {
+    if (c->fd[k] < 0)
+      continue;
+    ioctl(c->fd[k], PERF_EVENT_IOC_RESET, 0);
+    ioctl(c->fd[k], PERF_EVENT_IOC_ENABLE, 0);
+  }
+  return 0;
+#else
+  (void)k;
+  return -1;
+#endif
+}
+
+
+int bench_counters_stop(bench_counters * c, bench_counter_values * values)
+{
+  int k;
+  memset(values, 0, sizeof(*values));
+  if (!c)
+    return -1;
+#ifdef HAVE_PAPI
+  if (c->num_papi)
+  {
+    long long papi_values[BENCH_NUM_COUNTERS];
+    if (PAPI_stop(c->event_set, papi_values) != PAPI_OK)
+      return -1;
+    for (k = 0; k < BENCH_NUM_COUNTERS; ++k)
+    {
+      if (c->papi_index[k] < 0)
+        continue;
+      values->values[k] = papi_values[c->papi_index[k]];
+      values->valid[k] = 1;
+    }
+    return 0;
+  }
+#endif
+#ifdef HAVE_PERF_EVENT
+  for (k = 0; k < BENCH_NUM_COUNTERS; ++k)
+    if (c->fd[k] >= 0)
+      ioctl(c->fd[k], PERF_EVENT_IOC_DISABLE, 0);
+  for (k = 0; k < BENCH_NUM_COUNTERS; ++k)
+  {
+    uint64_t data[3];   /* value, time enabled, time running */
+    if (c->fd[k] < 0 || read(c->fd[k], data, sizeof(data)) != (ssize_t)sizeof(data) || !data[2])
+      continue;
+    values->values[k] = (data[2] < data[1])
+      ? (long long)((double)data[0] * (double)data[1] / (double)data[2])
+      : (long long)data[0];
+    values->valid[k] = 1;
+  }
+  return 0;
+#else
+  (void)k;
+  return -1;
+#endif
+}
+
+
+void bench_counters_print(FILE * f, const char * label, const bench_counter_values * values, double samples)
+{
+  const long long * v = values->values;
+  const int * valid = values->valid;
+  const double n = (samples > 0.0) ? samples : 1.0;
+  const char * unit = (samples > 0.0) ? "/sample" : "";
+
+  fprintf(f, "%s:", label ? label : "counters");
+  if (valid[BENCH_CNT_CYCLES])
+    fprintf(f, " cycles%s %.2f", unit, v[BENCH_CNT_CYCLES] / n);
+  if (valid[BENCH_CNT_CYCLES] && valid[BENCH_CNT_INSTRUCTIONS] && v[BENCH_CNT_CYCLES])
+    fprintf(f, ", IPC %.2f", (double)v[BENCH_CNT_INSTRUCTIONS] / (double)v[BENCH_CNT_CYCLES]);
+  else if (valid[BENCH_CNT_INSTRUCTIONS])
+    fprintf(f, ", instructions%s %.2f", unit, v[BENCH_CNT_INSTRUCTIONS] / n);
+  if (valid[BENCH_CNT_L1D_MISSES])
+    fprintf(f, ", L1D misses%s %.4f", unit, v[BENCH_CNT_L1D_MISSES] / n);
+  if (valid[BENCH_CNT_L2_MISSES])
+    fprintf(f, ", L2 misses%s %.4f", unit, v[BENCH_CNT_L2_MISSES] / n);
+  if (valid[BENCH_CNT_LLC_MISSES])
+    fprintf(f, ", LLC misses%s %.4f", unit, v[BENCH_CNT_LLC_MISSES] / n);
+  if (valid[BENCH_CNT_VEC_INS])
+    fprintf(f, ", vector ins%s %.2f", unit, v[BENCH_CNT_VEC_INS] / n);
+  fprintf(f, "\n");
+}
+
@@ -0,0 +1,66 @@
+#pragma once
+
+/* bench_counters.h/.c: hardware performance counters for the benchmarks
+ *
+ * backends, tried in this order:
+ * - PAPI, when compiled with HAVE_PAPI (libpapi-dev)
+ * - perf_event_open() on Linux - without any library. the kernel has to allow
+ *   it for user space, see /proc/sys/kernel/perf_event_paranoid
+ *
+ * counted are cycles, instructions, L1 data cache misses, L2 misses,
+ * last level cache misses and vector (SIMD) instructions - each one if the
+ * backend and CPU support it. perf_event has no generic events for L2 misses
+ * and vector instructions: these can be given as raw (hex) event configs with
+ * the environment variables PF_BENCH_L2_EVENT and PF_BENCH_VEC_EVENT,
+ * e.g. PF_BENCH_VEC_EVENT=0xfcc7 for FP_ARITH_INST_RETIRED.*_PACKED on Intel.
+ *
+ * it's plain C, to be usable from bench_pffft.c and the C++ benchmarks.
+ */
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+  BENCH_CNT_CYCLES = 0,
+  BENCH_CNT_INSTRUCTIONS,
+  BENCH_CNT_L1D_MISSES,
+  BENCH_CNT_L2_MISSES,
+  BENCH_CNT_LLC_MISSES,
+  BENCH_CNT_VEC_INS,
+  BENCH_NUM_COUNTERS
+};
+
+typedef struct
+{
+  long long values[BENCH_NUM_COUNTERS];
+  int valid[BENCH_NUM_COUNTERS];    /* counter is supported and was running */
+} bench_counter_values;
+
+typedef struct bench_counters bench_counters;
+
+/* NULL, when no backend or none of the counters is available */
+bench_counters * bench_counters_open(void);
+void bench_counters_close(bench_counters * c);
+
+/* "PAPI" or "perf_event" */
+const char * bench_counters_backend(const bench_counters * c);
+
+/* name of counter index, e.g. "cycles" */
+const char * bench_counter_name(int counter);
+
+/* start resets all counters. returns 0 on success */
+int bench_counters_start(bench_counters * c);
+int bench_counters_stop(bench_counters * c, bench_counter_values * values);
+
+/* one line with cycles/sample, IPC, misses/sample and vector instructions/sample,
+ * starting with label. samples > 0 is the number of processed samples (or transforms ..)
+ */
+void bench_counters_print(FILE * f, const char * label, const bench_counter_values * values, double samples);
+
+#ifdef __cplusplus
+}
+#endif
+
@@ -0,0 +1,471 @@
+/*
+  statistically robust, machine readable benchmark measurements:
+  see bench_harness.h
+ */
+
+/* for sched_setaffinity() and clock_gettime() */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "bench_harness.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__linux__)
+#  include <sched.h>
+#  include <unistd.h>
+#elif defined(_WIN32)
+#  include <windows.h>
+#elif !defined(_WIN32)
+#  include <unistd.h>
+#endif
+
+
+#define BENCH_NAME_LEN      64
+#define BENCH_VARIANT_LEN   32
+#define BENCH_LINE_LEN      1024
+
+typedef struct
+{
+  char name[BENCH_NAME_LEN];
+  char variant[BENCH_VARIANT_LEN];
+  int size;
+  bench_stats stats;
+  double mflops;
+} bench_record;
+
+struct bench_results
+{
+  char benchmark[BENCH_NAME_LEN];
+  char arch[BENCH_NAME_LEN];
+  bench_record * records;
+  int count;
+  int capacity;
+};
+
+
+void bench_config_default(bench_config * config)
+{
+  config->repetitions = 11;
+  config->warmup = 2;
+  config->min_rep_sec = 0.020;
+  config->cpu = -1;
+}
+
+
+int bench_config_parse_arg(bench_config * config, int argc, char **argv, int * i)
+{
+  const char * opt = argv[*i];
+  if (*i + 1 >= argc)
+    return 0;
+  if (!strcmp(opt, "--reps"))
+    config->repetitions = atoi(argv[*i + 1]);
+  else if (!strcmp(opt, "--warmup"))
+    config->warmup = atoi(argv[*i + 1]);
+  else if (!strcmp(opt, "--min-time"))
+    config->min_rep_sec = atof(argv[*i + 1]) * 1E-3;
+  else if (!strcmp(opt, "--pin"))
+    config->cpu = atoi(argv[*i + 1]);
+  else
+    return 0;
+  if (config->repetitions < 1)
+    config->repetitions = 1;
+  if (config->warmup < 0)
+    config->warmup = 0;
+  ++(*i);
+  return 1;
+}
+
+
+const char * bench_config_usage(void)
+{
+  return "[--reps <n>] [--warmup <n>] [--min-time <ms per repetition>] [--pin <cpu>]";
+}
+
+
+int bench_harness_init(const bench_config * config)
+{
+  if (config->cpu < 0)
+    return 0;
+#if defined(__linux__)
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(config->cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) ? -1 : 0;
+  }
+#elif defined(_WIN32)
+  return SetThreadAffinityMask(GetCurrentThread(), ((DWORD_PTR)1) << config->cpu) ? 0 : -1;
+#else
+  return -1;
+#endif
+}
+
+
+double bench_clock_sec(void)
+{
+#if defined(_POSIX_CPUTIME) && (_POSIX_CPUTIME >= 0)
+  struct timespec ts;
+  if (!clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts))
+    return (double)ts.tv_sec + 1E-9 * (double)ts.tv_nsec;
+#endif
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+}
+
+
+static int cmp_double(const void * a, const void * b)
+{
+  const double x = *(const double *)a, y = *(const double *)b;
+  return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+double bench_percentile(const double * sorted, int n, double p)
+{
+  const double pos = p * (n - 1);
+  const int k = (int)pos;
+  if (k + 1 >= n)
+    return sorted[n - 1];
+  return sorted[k] + (pos - k) * (sorted[k + 1] - sorted[k]);
+}
+
+
+void bench_compute_stats(double * samples, int n, bench_stats * stats)
+{
+  double sum = 0.0;
+  int k;
+  memset(stats, 0, sizeof(*stats));
+  if (n <= 0)
+    return;
+  qsort(samples, (size_t)n, sizeof(double), cmp_double);
+  for (k = 0; k < n; ++k)
+    sum += samples[k];
+  stats->min = samples[0];
+  stats->max = samples[n - 1];
+  stats->p10 = bench_percentile(samples, n, 0.1);
+  stats->median = bench_percentile(samples, n, 0.5);
+  stats->p90 = bench_percentile(samples, n, 0.9);
+  stats->mean = sum / n;
+  stats->repetitions = n;
+}
+
+
+int bench_measure(const bench_config * config, bench_func func, void * ctx, bench_stats * stats)
+{
+  double * samples;
+  double t0, t1;
+  long iterations = 1;
+  int k;
+
+  /* calibrate the iterations per repetition - this also warms up caches and clocks */
+  for (;;)
+  {
+    t0 = bench_clock_sec();
+    func(ctx, iterations);
+    t1 = bench_clock_sec();
+    if (t1 - t0 >= config->min_rep_sec || iterations >= (1L << 30))
+      break;
+    if (t1 - t0 < 0.1 * config->min_rep_sec)
+      iterations *= 10;
+    else
+      iterations = (long)(1.2 * iterations * config->min_rep_sec / (t1 - t0)) + 1;
+  }
+
+  for (k = 0; k < config->warmup; ++k)
+    func(ctx, iterations);
+
+  samples = (double *)malloc((size_t)config->repetitions * sizeof(double));
+  if (!samples)
+    return -1;
+  for (k = 0; k < config->repetitions; ++k)
+  {
+    t0 = bench_clock_sec();
+    func(ctx, iterations);
+    t1 = bench_clock_sec();
+    samples[k] = 1E9 * (t1 - t0) / iterations;
+  }
+  bench_compute_stats(samples, config->repetitions, stats);
+  stats->iterations = iterations;
+  free(samples);
+  return 0;
+}
+
+
+/* copy without the characters, which would need escaping in JSON or CSV */
+static void copy_token(char * dst, const char * src, size_t dst_len)
+{
+  size_t k;
+  for (k = 0; src && src[k] && k + 1 < dst_len; ++k)
+    dst[k] = (src[k] == '"' || src[k] == ',' || src[k] == '\\' || src[k] < ' ') ? '_' : src[k];
+  dst[k] = 0;
+  /* no trailing blanks - e.g. from column aligned names */
+  while (k > 0 && dst[k - 1] == ' ')
+    dst[--k] = 0;
+}
+
+
+bench_results * bench_results_new(const char * benchmark, const char * arch)
+{
+  bench_results * r = (bench_results *)calloc(1, sizeof(bench_results));
+  if (!r)
+    return NULL;
+  copy_token(r->benchmark, benchmark, BENCH_NAME_LEN);
+  copy_token(r->arch, arch, BENCH_NAME_LEN);
+  return r;
+}
+
+
+void bench_results_free(bench_results * results)
+{
+  if (!results)
+    return;
+  free(results->records);
+  free(results);
+}
+
+
+int bench_results_add(bench_results * results, const char * name, const char * variant, int size,
+                      const bench_stats * stats, double flops_per_iter)
+{
+  bench_record * rec;
+  if (results->count == results->capacity)
+  {
+    const int capacity = results->capacity ? 2 * results->capacity : 64;
+    bench_record * records = (bench_record *)realloc(results->records, (size_t)capacity * sizeof(bench_record));
+    if (!records)
+      return -1;
+    results->records = records;
+    results->capacity = capacity;
+  }
+  rec = &results->records[results->count++];
+  copy_token(rec->name, name, BENCH_NAME_LEN);
+  copy_token(rec->variant, variant, BENCH_VARIANT_LEN);
+  rec->size = size;
+  rec->stats = *stats;
+  rec->mflops = (flops_per_iter > 0.0 && stats->median > 0.0) ? 1E3 * flops_per_iter / stats->median : 0.0;
+  return 0;
+}
+
+
+int bench_results_count(const bench_results * results)
+{
+  return results->count;
+}
+
+
+int bench_results_write_file(const bench_results * results, FILE * f, int format)
+{
+  int k;
+  if (format == BENCH_FORMAT_CSV)
+  {
+    fprintf(f, "benchmark,arch,name,variant,size,median_ns,min_ns,p10_ns,p90_ns,max_ns,mean_ns,repetitions,iterations,mflops\n");
+    for (k = 0; k < results->count; ++k)
+    {
+      const bench_record * r = &results->records[k];
+      fprintf(f, "%s,%s,%s,%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%ld,%.1f\n",
+              results->benchmark, results->arch, r->name, r->variant, r->size,
+              r->stats.median, r->stats.min, r->stats.p10, r->stats.p90, r->stats.max, r->stats.mean,
+              r->stats.repetitions, r->stats.iterations, r->mflops);
+    }
+  }
+  else
+  {
+    /* one result per line: bench_results_read() depends on it */
+    fprintf(f, "{\n  \"benchmark\": \"%s\",\n  \"arch\": \"%s\",\n  \"results\": [\n",
+            results->benchmark, results->arch);
+    for (k = 0; k < results->count; ++k)
+    {
+      const bench_record * r = &results->records[k];
+      fprintf(f, "    { \"name\": \"%s\", \"variant\": \"%s\", \"size\": %d, \"median_ns\": %.3f, "
+              "\"min_ns\": %.3f, \"p10_ns\": %.3f, \"p90_ns\": %.3f, \"max_ns\": %.3f, \"mean_ns\": %.3f, "
+              "\"repetitions\": %d, \"iterations\": %ld, \"mflops\": %.1f }%s\n",
+              r->name, r->variant, r->size, r->stats.median,
+              r->stats.min, r->stats.p10, r->stats.p90, r->stats.max, r->stats.mean,
+              r->stats.repetitions, r->stats.iterations, r->mflops,
+              (k + 1 < results->count) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+  }
+  return ferror(f) ? -1 : 0;
+}
+
+
+int bench_results_write(const bench_results * results, const char * filename, int format)
+{
+  FILE * f = fopen(filename, "w");
+  int ret;
+  if (!f)
+    return -1;
+  ret = bench_results_write_file(results, f, format);
+  if (fclose(f))
+    ret = -1;
+  return ret;
+}
+
+
+/* value of "key": in a JSON line - strings without the quotes */
+static const char * json_value(const char * line, const char * key)
+{
+  char pattern[BENCH_NAME_LEN + 4];
+  const char * p;
+  snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+  p = strstr(line, pattern);
+  if (!p)
+    return NULL;
+  p += strlen(pattern);
+  while (*p == ' ')
+    ++p;
+  return (*p == '"') ? p + 1 : p;
+}
+
+static void json_string(const char * line, const char * key, char * dst, size_t dst_len)
+{
+  const char * p = json_value(line, key);
+  size_t k = 0;
+  if (p)
+    for (; p[k] && p[k] != '"' && k + 1 < dst_len; ++k)
+      dst[k] = p[k];
+  dst[k] = 0;
+}
+
+static double json_number(const char * line, const char * key)
+{
+  const char * p = json_value(line, key);
+  return p ? atof(p) : 0.0;
+}
+
+
+static int read_json_line(bench_results * results, const char * line)
+{
+  bench_stats st;
+  char name[BENCH_NAME_LEN], variant[BENCH_VARIANT_LEN];
+  if (!json_value(line, "name"))
+  {
+    if (json_value(line, "benchmark"))
+      json_string(line, "benchmark", results->benchmark, BENCH_NAME_LEN);
+    if (json_value(line, "arch"))
+      json_string(line, "arch", results->arch, BENCH_NAME_LEN);
+    return 0;
+  }
+  json_string(line, "name", name, BENCH_NAME_LEN);
+  json_string(line, "variant", variant, BENCH_VARIANT_LEN);
+  st.median = json_number(line, "median_ns");
+  st.min = json_number(line, "min_ns");
+  st.p10 = json_number(line, "p10_ns");
+  st.p90 = json_number(line, "p90_ns");
+  st.max = json_number(line, "max_ns");
+  st.mean = json_number(line, "mean_ns");
+  st.repetitions = (int)json_number(line, "repetitions");
+  st.iterations = (long)json_number(line, "iterations");
+  if (bench_results_add(results, name, variant, (int)json_number(line, "size"), &st, 0.0))
+    return -1;
+  results->records[results->count - 1].mflops = json_number(line, "mflops");
+  return 0;
+}
+
+
+static int read_csv_line(bench_results * results, const char * line)
+{
+  bench_stats st;
+  char benchmark[BENCH_NAME_LEN], arch[BENCH_NAME_LEN], name[BENCH_NAME_LEN], variant[BENCH_VARIANT_LEN];
+  double mflops;
+  int size;
+  if (!strncmp(line, "benchmark,", 10) || line[strspn(line, " \t\r\n")] == 0)
+    return 0;   /* header or empty line */
+  if (sscanf(line, "%63[^,],%63[^,],%63[^,],%31[^,],%d,%lf,%lf,%lf,%lf,%lf,%lf,%d,%ld,%lf",
+             benchmark, arch, name, variant, &size, &st.median, &st.min, &st.p10, &st.p90,
+             &st.max, &st.mean, &st.repetitions, &st.iterations, &mflops) != 14)
+    return -1;
+  copy_token(results->benchmark, benchmark, BENCH_NAME_LEN);
+  copy_token(results->arch, arch, BENCH_NAME_LEN);
+  if (bench_results_add(results, name, variant, size, &st, 0.0))
+    return -1;
+  results->records[results->count - 1].mflops = mflops;
+  return 0;
+}
+
+
+bench_results * bench_results_read(const char * filename)
+{
+  char line[BENCH_LINE_LEN];
+  int csv = -1;
+  bench_results * results;
+  FILE * f = fopen(filename, "r");
+  if (!f)
+    return NULL;
+  results = bench_results_new("", "");
+  while (results && fgets(line, sizeof(line), f))
+  {
+    /* JSON starts with '{', CSV with the header */
+    if (csv < 0)
+      csv = (line[strspn(line, " \t\r\n")] == '{') ? 0 : 1;
+    if ((csv ? read_csv_line(results, line) : read_json_line(results, line)))
+    {
+      bench_results_free(results);
+      results = NULL;
+    }
+  }
+  fclose(f);
+  return results;
+}
+
+
+static const bench_record * find_record(const bench_results * results, const bench_record * key)
+{
+  int k;
+  for (k = 0; k < results->count; ++k)
+  {
+    const bench_record * r = &results->records[k];
+    if (r->size == key->size && !strcmp(r->name, key->name) && !strcmp(r->variant, key->variant))
+      return r;
+  }
+  return NULL;
+}
+
+
+int bench_results_compare(const bench_results * baseline, const bench_results * current,
+                          double threshold, FILE * out)
+{
+  int k, regressions = 0;
+  if (out)
+  {
+    if (strcmp(baseline->arch, current->arch))
+      fprintf(out, "warning: comparing different architectures '%s' and '%s'\n", baseline->arch, current->arch);
+    fprintf(out, "%-16s %-8s %9s %14s %14s %8s  status (threshold %.1f %%)\n",
+            "name", "variant", "size", "baseline ns", "current ns", "ratio", 100.0 * threshold);
+  }
+  for (k = 0; k < baseline->count; ++k)
+  {
+    const bench_record * b = &baseline->records[k];
+    const bench_record * c = find_record(current, b);
+    const char * status;
+    double ratio = 0.0;
+    if (!c)
+      status = "missing";
+    else
+    {
+      ratio = (b->stats.median > 0.0) ? c->stats.median / b->stats.median : 1.0;
+      if (ratio > 1.0 + threshold)
+      {
+        status = "REGRESSION";
+        ++regressions;
+      }
+      else if (ratio < 1.0 - threshold)
+        status = "faster";
+      else
+        status = "ok";
+    }
+    if (out)
+      fprintf(out, "%-16s %-8s %9d %14.1f %14.1f %8.3f  %s\n", b->name, b->variant, b->size,
+              b->stats.median, (c ? c->stats.median : 0.0), ratio, status);
+  }
+  if (out)
+    fprintf(out, "%d regression(s) in %d measurements\n", regressions, baseline->count);
+  return regressions;
+}
+
@@ -0,0 +1,112 @@
+#pragma once
+
+/* bench_harness.h/.c: statistically robust, machine readable benchmark measurements
+ *
+ * - each benchmark is measured in 'repetitions', after 'warmup' unmeasured ones.
+ *   the number of iterations per repetition is calibrated, that one repetition
+ *   takes at least 'min_rep_sec'. reported are min, percentiles, median and max
+ *   of the durations per iteration over the repetitions: the median is robust
+ *   against the outliers on noisy (cloud) hosts.
+ * - the process can be pinned to one CPU.
+ * - results are written as JSON or CSV - tagged with an architecture string,
+ *   e.g. pffft_simd_arch() - and read back for a comparison of two result files
+ *   against a threshold: for regression checks in CI.
+ *
+ * the timer is the CPU time of the process (not the wall clock),
+ * as with uclock_sec() in bench_pffft.c
+ *
+ * it's plain C, to be usable from bench_pffft.c and the C++ benchmarks.
+ */
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+  int repetitions;      /* measured repetitions: statistics over these */
+  int warmup;           /* unmeasured repetitions before */
+  double min_rep_sec;   /* minimum duration of one repetition in seconds */
+  int cpu;              /* pin to this CPU with bench_harness_init(); -1 for no pinning */
+} bench_config;
+
+typedef struct
+{
+  /* duration per iteration in ns */
+  double min, p10, median, p90, max, mean;
+  int repetitions;
+  long iterations;      /* per repetition */
+} bench_stats;
+
+/* 11 repetitions, 2 warmup, 20 ms per repetition, no pinning */
+void bench_config_default(bench_config * config);
+
+/* parses harness options at argv[*i] and advances *i over the consumed arguments:
+ *   --reps <n>  --warmup <n>  --min-time <ms>  --pin <cpu>
+ * returns 1 if the option was consumed, else 0.
+ */
+int bench_config_parse_arg(bench_config * config, int argc, char **argv, int * i);
+
+/* usage text of bench_config_parse_arg() options */
+const char * bench_config_usage(void);
+
+/* applies the CPU pinning: returns 0 on success or without pinning,
+ * -1 when pinning is not supported on this platform or failed
+ */
+int bench_harness_init(const bench_config * config);
+
+/* CPU time of the process in seconds */
+double bench_clock_sec(void);
+
+/* p-quantile (0 .. 1) of n sorted samples: linear interpolation between the samples */
+double bench_percentile(const double * sorted, int n, double p);
+
+/* statistics of n samples (durations in ns) - samples[] gets sorted */
+void bench_compute_stats(double * samples, int n, bench_stats * stats);
+
+/* the function to measure: has to execute 'iterations' times the operation */
+typedef void (*bench_func)(void * ctx, long iterations);
+
+/* calibrates, warms up and measures func with config. returns 0 on success */
+int bench_measure(const bench_config * config, bench_func func, void * ctx, bench_stats * stats);
+
+
+/* collected results of one benchmark run */
+typedef struct bench_results bench_results;
+
+enum { BENCH_FORMAT_JSON = 0, BENCH_FORMAT_CSV = 1 };
+
+/* 'benchmark' names the program, 'arch' e.g. pffft_simd_arch() */
+bench_results * bench_results_new(const char * benchmark, const char * arch);
+void bench_results_free(bench_results * results);
+
+/* adds one measurement. name and variant (e.g. "PFFFT-U" and "real") with the size
+ * identify the measurement for comparisons. flops_per_iter gives the MFlops
+ * (from the median) - or <= 0 without.
+ */
+int bench_results_add(bench_results * results, const char * name, const char * variant, int size,
+                      const bench_stats * stats, double flops_per_iter);
+
+int bench_results_count(const bench_results * results);
+
+/* format is BENCH_FORMAT_JSON or BENCH_FORMAT_CSV. returns 0 on success */
+int bench_results_write(const bench_results * results, const char * filename, int format);
+int bench_results_write_file(const bench_results * results, FILE * f, int format);
+
+/* reads a file, written with bench_results_write() - in either format: NULL on error */
+bench_results * bench_results_read(const char * filename);
+
+/* compares the medians of the measurements in both results:
+ * current slower than baseline by more than threshold (e.g. 0.1 for 10 %)
+ * is a regression. measurements missing in current are reported, too.
+ * prints a table to out (if not NULL) and returns the number of regressions.
+ */
+int bench_results_compare(const bench_results * baseline, const bench_results * current,
+                          double threshold, FILE * out);
+
+#ifdef __cplusplus
+}
+#endif
+
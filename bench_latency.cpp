@@ -0,0 +1,406 @@
+/*
+  latency distribution of single calls - for streaming / real-time use
+
+  the other benchmarks measure throughput. here, each call of
+    - pffft::Fft<>::forward() - with the work memory on the stack or on the heap,
+      see stackThresholdLen of the Fft<> constructor
+    - pffastconv_apply() for one block
+    - shift_mixer_inp_c() for one block
+  is timed on its own (wall clock) and reported as distribution:
+  min, p50, p99, p99.9, max - optionally as histogram.
+
+  each case is run with warm caches and with cold caches - a big buffer is
+  touched before each call - and with and without background load:
+  threads, streaming through their own memory.
+ */
+
+#include "pffft.hpp"
+#include "pffastconv.hpp"
+#include "pf_mixer.h"
+#include "bench_harness.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#ifndef BENCH_LATENCY_NO_THREADS
+#include <atomic>
+#include <thread>
+#endif
+
+
+typedef std::chrono::steady_clock Clock;
+
+struct latency_options
+{
+    int fftLen = 1024;
+    int blockLen = 1024;        // for pffastconv and mixer
+    int filterLen = 128;
+    int calls = 10000;          // measured calls per case
+    int warmup = 100;
+    int loadThreads = 1;        // background threads of the loaded runs; 0 for none
+    int evictMB = 32;           // cold cache: touched memory before each call
+    bool histogram = false;
+    const char * csvFilename = nullptr;
+};
+
+
+// memory, touched before each call for a cold cache
+class cache_evictor
+{
+public:
+    explicit cache_evictor(int megaBytes)
+        : mem(size_t(megaBytes) * 1024 * 1024, 0)
+    { }
+
+    void evict()
+    {
+        unsigned char * p = mem.data();
+        const size_t n = mem.size();
+        for (size_t k = 0; k < n; k += 64)  // one write per cache line
+            ++p[k];
+    }
+
+private:
+    std::vector<unsigned char> mem;
+};
+
+
+// threads streaming through their own memory: interference in caches and memory bandwidth
+class background_load
+{
+public:
+    explicit background_load(int numThreads)
+    {
+#ifndef BENCH_LATENCY_NO_THREADS
+        stop = false;
+        for (int t = 0; t < numThreads; ++t)
+            threads.push_back(std::thread(&background_load::run, this));
+#else
+        (void)numThreads;
+#endif
+    }
+
+    ~background_load()
+    {
+#ifndef BENCH_LATENCY_NO_THREADS
+        stop = true;
+        for (size_t t = 0; t < threads.size(); ++t)
+            threads[t].join();
+#endif
+    }
+
+private:
+#ifndef BENCH_LATENCY_NO_THREADS
+    void run()
+    {
+        std::vector<float> a(4 * 1024 * 1024, 1.0F);  // 16 MB
+        while (!stop)
+            for (size_t k = 0; k < a.size(); ++k)
+                a[k] = a[k] * 0.999F + 0.001F;
+    }
+
+    std::atomic<bool> stop;
+    std::vector<std::thread> threads;
+#endif
+};
+
+
+// one call per invocation - with bench_harness' bench_func signature
+template <typename T>
+struct fft_ctx
+{
+    fft_ctx(int len, int stackThresholdLen)
+        : fft(len, stackThresholdLen)
+        , x(fft.valueVector())
+        , y(fft.spectrumVector())
+    {
+        for (int k = 0; k < fft.getLength(); ++k)
+            x[k] = T(float(k % 17) - 8.0F);
+    }
+
+    static void call(void * ctx, long iterations)
+    {
+        fft_ctx * c = static_cast<fft_ctx *>(ctx);
+        for (long k = 0; k < iterations; ++k)
+            c->fft.forward(c->x, c->y);
+    }
+
+    pffft::Fft<T> fft;
+    pffft::AlignedVector<T> x;
+    pffft::AlignedVector<typename pffft::Fft<T>::Complex> y;
+};
+
+
+struct fastconv_ctx
+{
+    fastconv_ctx(int filterLen, int blockLen)
+        : setup(nullptr), blockLen(blockLen), filterLen(filterLen)
+    {
+        std::vector<float> filter(filterLen);
+        for (int k = 0; k < filterLen; ++k)
+            filter[k] = 1.0F / float(k + 1);
+        setup = pffft::detail::pffastconv_new_setup(filter.data(), filterLen, &this->blockLen, 0);
+        // one call processes one output block: overlap-save
+        input.resize(this->blockLen + filterLen - 1);
+        output.resize(input.size());
+        for (size_t k = 0; k < input.size(); ++k)
+            input[k] = float(k % 13) - 6.0F;
+    }
+
+    ~fastconv_ctx()
+    {
+        if (setup)
+            pffft::detail::pffastconv_destroy_setup(setup);
+    }
+
+    static void call(void * ctx, long iterations)
+    {
+        fastconv_ctx * c = static_cast<fastconv_ctx *>(ctx);
+        for (long k = 0; k < iterations; ++k)
+            pffft::detail::pffastconv_apply(c->setup, c->input.data(), int(c->input.size()), c->output.data(), 0);
+    }
+
+    pffft::detail::PFFASTCONV_Setup * setup;
+    int blockLen;
+    int filterLen;
+    std::vector<float> input, output;
+};
+
+
+struct mixer_ctx
+{
+    explicit mixer_ctx(int blockLen)
+        : blockLen(blockLen), buf(blockLen)
+    {
+        algo = shift_mixer_init(&m, 0.0123F, 0.0F, blockLen, 1E-3F, PF_MIXER_AUTO);
+        for (int k = 0; k < blockLen; ++k)
+        {
+            buf[k].i = 1.0F;
+            buf[k].q = 0.0F;
+        }
+    }
+
+    static void call(void * ctx, long iterations)
+    {
+        mixer_ctx * c = static_cast<mixer_ctx *>(ctx);
+        for (long k = 0; k < iterations; ++k)
+            shift_mixer_inp_c(&c->m, c->buf.data(), c->blockLen);
+    }
+
+    shift_mixer_t m;
+    int algo;
+    int blockLen;
+    std::vector<complexf> buf;
+};
+
+
+struct latency_stats
+{
+    double min, p50, p99, p999, max, mean;
+};
+
+// durations in ns of each call
+static void measure_calls(bench_func func, void * ctx, const latency_options & opt,
+                          cache_evictor * evictor, std::vector<double> & ns)
+{
+    ns.resize(opt.calls);
+    for (int k = -opt.warmup; k < opt.calls; ++k)
+    {
+        if (evictor)
+            evictor->evict();
+        const Clock::time_point t0 = Clock::now();
+        func(ctx, 1);
+        const Clock::time_point t1 = Clock::now();
+        if (k >= 0)
+            ns[k] = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    }
+}
+
+static latency_stats compute_latency_stats(std::vector<double> & ns)
+{
+    latency_stats st;
+    const int n = int(ns.size());
+    double sum = 0.0;
+    std::sort(ns.begin(), ns.end());
+    for (int k = 0; k < n; ++k)
+        sum += ns[k];
+    st.min = ns[0];
+    st.p50 = bench_percentile(ns.data(), n, 0.5);
+    st.p99 = bench_percentile(ns.data(), n, 0.99);
+    st.p999 = bench_percentile(ns.data(), n, 0.999);
+    st.max = ns[n - 1];
+    st.mean = sum / n;
+    return st;
+}
+
+// log2 spaced buckets of the sorted durations
+static void print_histogram(const std::vector<double> & ns)
+{
+    const int n = int(ns.size());
+    int k = 0;
+    for (double upper = 64.0; k < n; upper *= 2.0)
+    {
+        int count = 0;
+        while (k < n && ns[k] < upper)
+        {
+            ++count;
+            ++k;
+        }
+        if (!count)
+            continue;
+        const int bar = int(ceil(50.0 * count / n));
+        printf("    < %10.0f ns: %7d  %.*s\n", upper, count, bar, "##################################################");
+    }
+}
+
+
+static void run_case(const char * name, bench_func func, void * ctx, const latency_options & opt,
+                     cache_evictor & evictor, FILE * csv)
+{
+    std::vector<double> ns;
+    for (int loaded = 0; loaded < 2; ++loaded)
+    {
+        if (loaded && !opt.loadThreads)
+            break;
+        for (int cold = 0; cold < 2; ++cold)
+        {
+            {
+                background_load load(loaded ? opt.loadThreads : 0);
+                measure_calls(func, ctx, opt, (cold ? &evictor : nullptr), ns);
+            }
+            const latency_stats st = compute_latency_stats(ns);
+            const char * cache = (cold ? "cold" : "warm");
+            printf("%-28s %s, %d load threads: min %8.0f  p50 %8.0f  p99 %8.0f  p99.9 %8.0f  max %9.0f ns\n",
+                   name, cache, (loaded ? opt.loadThreads : 0), st.min, st.p50, st.p99, st.p999, st.max);
+            if (opt.histogram)
+                print_histogram(ns);
+            if (csv)
+                fprintf(csv, "%s,%s,%d,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+                        name, cache, (loaded ? opt.loadThreads : 0), opt.calls,
+                        st.min, st.p50, st.p99, st.p999, st.max, st.mean);
+            fflush(stdout);
+        }
+    }
+}
+
+
+static void usage(const char * prog)
+{
+    fprintf(stderr, "%s [--len <fft length>] [--block <block length>] [--filter-len <taps>]\n", prog);
+    fprintf(stderr, "    [--calls <n>] [--warmup <n>] [--load <threads>] [--evict <MB>] [--pin <cpu>]\n");
+    fprintf(stderr, "    [--hist] [--csv <file>]\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+    latency_options opt;
+    bench_config config;
+    bench_config_default(&config);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i+1 < argc && !strcmp(argv[i], "--len"))
+            opt.fftLen = atoi(argv[++i]);
+        else if (i+1 < argc && !strcmp(argv[i], "--block"))
+            opt.blockLen = atoi(argv[++i]);
+        else if (i+1 < argc && !strcmp(argv[i], "--filter-len"))
+            opt.filterLen = atoi(argv[++i]);
+        else if (i+1 < argc && !strcmp(argv[i], "--calls"))
+            opt.calls = atoi(argv[++i]);
+        else if (i+1 < argc && !strcmp(argv[i], "--warmup"))
+            opt.warmup = atoi(argv[++i]);
+        else if (i+1 < argc && !strcmp(argv[i], "--load"))
+            opt.loadThreads = atoi(argv[++i]);
+        else if (i+1 < argc && !strcmp(argv[i], "--evict"))
+            opt.evictMB = atoi(argv[++i]);
+        else if (i+1 < argc && !strcmp(argv[i], "--pin"))
+            config.cpu = atoi(argv[++i]);
+        else if (i+1 < argc && !strcmp(argv[i], "--csv"))
+            opt.csvFilename = argv[++i];
+        else if (!strcmp(argv[i], "--hist"))
+            opt.histogram = true;
+        else
+        {
+            usage(argv[0]);
+            return (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) ? 0 : 1;
+        }
+    }
+#ifdef BENCH_LATENCY_NO_THREADS
+    opt.loadThreads = 0;
+#endif
+
+    if (opt.calls <= 0 || opt.warmup < 0 || opt.loadThreads < 0 || opt.evictMB <= 0
+        || opt.blockLen <= 0 || opt.filterLen <= 0)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    if (!pffft::Fft<float>::isValidSize(opt.fftLen))
+    {
+        fprintf(stderr, "error: fft length %d is not supported - next one is %d\n",
+                opt.fftLen, pffft::Fft<float>::nearestTransformSize(opt.fftLen));
+        return 1;
+    }
+    if (bench_harness_init(&config))
+        fprintf(stderr, "warning: pinning to CPU %d failed!\n", config.cpu);
+
+    FILE * csv = nullptr;
+    if (opt.csvFilename)
+    {
+        csv = fopen(opt.csvFilename, "w");
+        if (!csv)
+        {
+            fprintf(stderr, "error: can't write '%s'\n", opt.csvFilename);
+            return 1;
+        }
+        fprintf(csv, "case,cache,load_threads,calls,min_ns,p50_ns,p99_ns,p999_ns,max_ns,mean_ns\n");
+    }
+
+    printf("pffft architecture '%s': %d calls per case after %d warmup, cold cache: %d MB touched before each call\n",
+           pffft::Fft<float>::simd_arch(), opt.calls, opt.warmup, opt.evictMB);
+    cache_evictor evictor(opt.evictMB);
+    char name[64];
+
+    // work memory on the stack: stackThresholdLen >= length, else on the heap
+    for (int heap = 0; heap < 2; ++heap)
+    {
+        fft_ctx<float> real(opt.fftLen, heap ? 0 : opt.fftLen);
+        snprintf(name, sizeof(name), "fft real %d %s", opt.fftLen, heap ? "heap" : "stack");
+        run_case(name, fft_ctx<float>::call, &real, opt, evictor, csv);
+
+        fft_ctx< std::complex<float> > cplx(opt.fftLen, heap ? 0 : opt.fftLen);
+        snprintf(name, sizeof(name), "fft cplx %d %s", opt.fftLen, heap ? "heap" : "stack");
+        run_case(name, fft_ctx< std::complex<float> >::call, &cplx, opt, evictor, csv);
+    }
+
+    fastconv_ctx conv(opt.filterLen, opt.blockLen);
+    if (conv.setup)
+    {
+        snprintf(name, sizeof(name), "fastconv %d/%d", conv.blockLen, opt.filterLen);
+        run_case(name, fastconv_ctx::call, &conv, opt, evictor, csv);
+    }
+    else
+        fprintf(stderr, "warning: pffastconv_new_setup() failed for filter length %d, block length %d\n",
+                opt.filterLen, opt.blockLen);
+
+    mixer_ctx mixer(opt.blockLen);
+    if (mixer.algo >= 0 && (opt.blockLen % mixer.m.simd_size) == 0)
+    {
+        snprintf(name, sizeof(name), "mixer %s %d", shift_mixer_name(mixer.algo), opt.blockLen);
+        run_case(name, mixer_ctx::call, &mixer, opt, evictor, csv);
+    }
+    else
+        fprintf(stderr, "warning: no mixer for block length %d\n", opt.blockLen);
+
+    if (csv)
+        fclose(csv);
+    return 0;
+}
+
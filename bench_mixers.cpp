@@ -50,6 +50,12 @@
   #define BENCH_FILE_REC_OSC_CC              ""
   #define BENCH_FILE_REC_OSC_INP_C           "/home/ayguen/WindowsDesktop/mixer_test/I_shift_recursive_osc_inp_c.bin"
   #define BENCH_FILE_REC_OSC_SSE_INP_C       "/home/ayguen/WindowsDesktop/mixer_test/J_shift_recursive_osc_sse_inp_c.bin"
+  #define BENCH_FILE_LTD_UNROLL_AVX_INP_C    "/home/ayguen/WindowsDesktop/mixer_test/K_shift_limited_unroll_avx_inp_c.bin"
+  #define BENCH_FILE_REC_OSC_AVX_INP_C       "/home/ayguen/WindowsDesktop/mixer_test/L_shift_recursive_osc_avx_inp_c.bin"
+  #define BENCH_FILE_LTD_UNROLL_C_NEON_INP_C "/home/ayguen/WindowsDesktop/mixer_test/M_shift_limited_unroll_C_neon_inp_c.bin"
+  #define BENCH_FILE_REC_OSC_NEON_INP_C      "/home/ayguen/WindowsDesktop/mixer_test/N_shift_recursive_osc_neon_inp_c.bin"
+  #define BENCH_FILE_NCO_INP_C               "/home/ayguen/WindowsDesktop/mixer_test/O_shift_nco_inp_c.bin"
+  #define BENCH_FILE_NCO_CS16_C              "/home/ayguen/WindowsDesktop/mixer_test/O_shift_nco_cs16_c.bin"
 #else
   #define BENCH_FILE_SHIFT_MATH_CC           ""
   #define BENCH_FILE_ADD_FAST_CC             ""
@@ -62,6 +68,12 @@
   #define BENCH_FILE_REC_OSC_CC              ""
   #define BENCH_FILE_REC_OSC_INP_C           ""
   #define BENCH_FILE_REC_OSC_SSE_INP_C       ""
+  #define BENCH_FILE_LTD_UNROLL_AVX_INP_C    ""
+  #define BENCH_FILE_REC_OSC_AVX_INP_C       ""
+  #define BENCH_FILE_LTD_UNROLL_C_NEON_INP_C ""
+  #define BENCH_FILE_REC_OSC_NEON_INP_C      ""
+  #define BENCH_FILE_NCO_INP_C               ""
+  #define BENCH_FILE_NCO_CS16_C              ""
 #endif
 
 
@@ -160,6 +172,7 @@ double bench_core_shift_math_cc(
 
     iters_out = iter;
     off_out = off;
+    perf_counter.set_samples(off, __func__);
     return t1 - t0;
 }
 
@@ -284,6 +297,7 @@ double bench_core_shift_addfast_inplace(
 
     iters_out = iter;
     off_out = off;
+    perf_counter.set_samples(off, __func__);
     return t1 - t0;
 }
 
@@ -371,6 +385,7 @@ double bench_core_shift_unroll_inplace(
 
     iters_out = iter;
     off_out = off;
+    perf_counter.set_samples(off, __func__);
     return t1 - t0;
 }
 
@@ -458,6 +473,7 @@ double bench_core_shift_limited_unroll_inplace(
 
     iters_out = iter;
     off_out = off;
+    perf_counter.set_samples(off, __func__);
     return t1 - t0;
 }
 
@@ -508,6 +524,7 @@ double bench_core_shift_limited_unroll_A_sse_inplace(
 
     iters_out = iter;
     off_out = off;
+    perf_counter.set_samples(off, __func__);
     return t1 - t0;
 }
 
@@ -561,6 +578,7 @@ double bench_core_shift_limited_unroll_B_sse_inplace(
 
     iters_out = iter;
     off_out = off;
+    perf_counter.set_samples(off, __func__);
     return t1 - t0;
 }
 
@@ -615,6 +633,7 @@ double bench_core_shift_limited_unroll_C_sse_inplace(
 
     iters_out = iter;
     off_out = off;
+    perf_counter.set_samples(off, __func__);
     return t1 - t0;
 }
 
@@ -645,6 +664,114 @@ double bench_shift_limited_unroll_C_sse_inp(const int B, const int N, const bool
 }
 
 
+double bench_core_shift_limited_unroll_avx_inplace(
+        const int B, const int N, const bool ignore_time,
+        complexf *data,
+        shift_limited_unroll_avx_data_t &state,
+        int &iters_out, int &off_out
+        )
+{
+    const double t0 = uclock_sec(1);
+    const double tstop = t0 + 0.5;  /* benchmark duration: 500 ms */
+    double t1;
+    int off = 0, iter = 0;
+    papi_perf_counter perf_counter(1);
+
+    do {
+        // work
+        shift_limited_unroll_avx_inp_c(data+off, B, &state);
+        off += B;
+        ++iter;
+        t1 = uclock_sec(0);
+    } while ( off + B < N && (ignore_time || t1 < tstop) );
+
+    iters_out = iter;
+    off_out = off;
+    perf_counter.set_samples(off, __func__);
+    return t1 - t0;
+}
+
+double bench_shift_limited_unroll_avx_inp(const int B, const int N, const bool ignore_time) {
+    complexf *input = (complexf *)malloc(N * sizeof(complexf));
+    shift_recursive_osc_t gen_state;
+    shift_recursive_osc_conf_t gen_conf;
+    shift_limited_unroll_avx_data_t *state = (shift_limited_unroll_avx_data_t*)malloc(sizeof(shift_limited_unroll_avx_data_t));
+    int iter, off;
+
+    *state = shift_limited_unroll_avx_init(-0.0009F, 0.0F);
+
+    shift_recursive_osc_init(0.001F, 0.0F, &gen_conf, &gen_state);
+    gen_recursive_osc_c(input, N, &gen_conf, &gen_state);
+
+    double T = bench_core_shift_limited_unroll_avx_inplace(
+                B, N, ignore_time, input, *state,
+                iter, off
+                );
+
+    save(input, B, off, BENCH_FILE_LTD_UNROLL_AVX_INP_C);
+
+    free(input);
+    free(state);
+    printf("processed %f Msamples in %f ms\n", off * 1E-6, T*1E3);
+    double nI = ((double)iter) * B;  /* number of iterations "normalized" to O(N) = N */
+    return (nI / T);    /* normalized iterations per second */
+}
+
+
+double bench_core_shift_limited_unroll_C_neon_inplace(
+        const int B, const int N, const bool ignore_time,
+        complexf *data,
+        shift_limited_unroll_C_sse_data_t &state,
+        int &iters_out, int &off_out
+        )
+{
+    const double t0 = uclock_sec(1);
+    const double tstop = t0 + 0.5;  /* benchmark duration: 500 ms */
+    double t1;
+    int off = 0, iter = 0;
+    papi_perf_counter perf_counter(1);
+
+    do {
+        // work
+        shift_limited_unroll_C_neon_inp_c(data+off, B, &state);
+        off += B;
+        ++iter;
+        t1 = uclock_sec(0);
+    } while ( off + B < N && (ignore_time || t1 < tstop) );
+
+    iters_out = iter;
+    off_out = off;
+    perf_counter.set_samples(off, __func__);
+    return t1 - t0;
+}
+
+double bench_shift_limited_unroll_C_neon_inp(const int B, const int N, const bool ignore_time) {
+    complexf *input = (complexf *)malloc(N * sizeof(complexf));
+    shift_recursive_osc_t gen_state;
+    shift_recursive_osc_conf_t gen_conf;
+    shift_limited_unroll_C_sse_data_t *state = (shift_limited_unroll_C_sse_data_t*)malloc(sizeof(shift_limited_unroll_C_sse_data_t));
+    int iter, off;
+
+    *state = shift_limited_unroll_C_sse_init(-0.0009F, 0.0F);
+
+    shift_recursive_osc_init(0.001F, 0.0F, &gen_conf, &gen_state);
+    gen_recursive_osc_c(input, N, &gen_conf, &gen_state);
+
+    double T = bench_core_shift_limited_unroll_C_neon_inplace(
+                B, N, ignore_time, input, *state,
+                iter, off
+                );
+
+    save(input, B, off, BENCH_FILE_LTD_UNROLL_C_NEON_INP_C);
+
+    free(input);
+    free(state);
+    printf("processed %f Msamples in %f ms\n", off * 1E-6, T*1E3);
+    double nI = ((double)iter) * B;  /* number of iterations "normalized" to O(N) = N */
+    return (nI / T);    /* normalized iterations per second */
+}
+
+
 double bench_shift_rec_osc_cc_oop(int B, int N) {
     double t0, t1, tstop, T, nI;
     int iter, off;
@@ -705,6 +832,7 @@ double bench_core_shift_rec_osc_cc_inplace(
 
     iters_out = iter;
     off_out = off;
+    perf_counter.set_samples(off, __func__);
     return t1 - t0;
 }
 
@@ -754,6 +882,7 @@ double bench_core_shift_rec_osc_sse_c_inplace(
 
     iters_out = iter;
     off_out = off;
+    perf_counter.set_samples(off, __func__);
     return t1 - t0;
 }
 
@@ -785,6 +914,214 @@ double bench_shift_rec_osc_sse_c_inp(const int B, const int N, const bool ignore
 }
 
 
+double bench_core_shift_rec_osc_avx_inplace(
+        const int B, const int N, const bool ignore_time,
+        complexf *data,
+        shift_recursive_osc_conf_t &conf, shift_recursive_osc_t &state,
+        int &iters_out, int &off_out
+        )
+{
+    const double t0 = uclock_sec(1);
+    const double tstop = t0 + 0.5;  /* benchmark duration: 500 ms */
+    double t1;
+    int off = 0, iter = 0;
+    papi_perf_counter perf_counter(1);
+
+    do {
+        // work
+        shift_recursive_osc_avx_inp_c(data+off, B, &conf, &state);
+        off += B;
+        ++iter;
+        t1 = uclock_sec(0);
+    } while ( off + B < N && (ignore_time || t1 < tstop) );
+
+    iters_out = iter;
+    off_out = off;
+    perf_counter.set_samples(off, __func__);
+    return t1 - t0;
+}
+
+double bench_shift_rec_osc_avx_inp(const int B, const int N, const bool ignore_time) {
+    complexf *input = (complexf *)malloc(N * sizeof(complexf));
+    shift_recursive_osc_t gen_state, shift_state;
+    shift_recursive_osc_conf_t gen_conf, shift_conf;
+    int iter, off;
+
+    shift_recursive_osc_init(0.001F, 0.0F, &gen_conf, &gen_state);
+    gen_recursive_osc_c(input, N, &gen_conf, &gen_state);
+    shift_recursive_osc_init(-0.0009F, 0.0F, &shift_conf, &shift_state);
+
+    double T = bench_core_shift_rec_osc_avx_inplace(
+                B, N, ignore_time, input, shift_conf, shift_state,
+                iter, off
+                );
+
+    save(input, B, off, BENCH_FILE_REC_OSC_AVX_INP_C);
+    free(input);
+    printf("processed %f Msamples in %f ms\n", off * 1E-6, T*1E3);
+    double nI = ((double)iter) * B;  /* number of iterations "normalized" to O(N) = N */
+    return (nI / T);    /* normalized iterations per second */
+}
+
+
+double bench_core_shift_rec_osc_neon_inplace(
+        const int B, const int N, const bool ignore_time,
+        complexf *data,
+        shift_recursive_osc_sse_conf_t &conf, shift_recursive_osc_sse_t &state,
+        int &iters_out, int &off_out
+        )
+{
+    const double t0 = uclock_sec(1);
+    const double tstop = t0 + 0.5;  /* benchmark duration: 500 ms */
+    double t1;
+    int off = 0, iter = 0;
+    papi_perf_counter perf_counter(1);
+
+    do {
+        // work
+        shift_recursive_osc_neon_inp_c(data+off, B, &conf, &state);
+        off += B;
+        ++iter;
+        t1 = uclock_sec(0);
+    } while ( off + B < N && (ignore_time || t1 < tstop) );
+
+    iters_out = iter;
+    off_out = off;
+    perf_counter.set_samples(off, __func__);
+    return t1 - t0;
+}
+
+double bench_shift_rec_osc_neon_inp(const int B, const int N, const bool ignore_time) {
+    complexf *input = (complexf *)malloc(N * sizeof(complexf));
+    shift_recursive_osc_t gen_state;
+    shift_recursive_osc_conf_t gen_conf;
+
+    shift_recursive_osc_sse_t *shift_state = (shift_recursive_osc_sse_t*)malloc(sizeof(shift_recursive_osc_sse_t));
+    shift_recursive_osc_sse_conf_t shift_conf;
+    int iter, off;
+
+    shift_recursive_osc_init(0.001F, 0.0F, &gen_conf, &gen_state);
+    gen_recursive_osc_c(input, N, &gen_conf, &gen_state);
+
+    shift_recursive_osc_sse_init(-0.0009F, 0.0F, &shift_conf, shift_state);
+
+    double T = bench_core_shift_rec_osc_neon_inplace(
+                B, N, ignore_time, input, shift_conf, *shift_state,
+                iter, off
+                );
+
+    save(input, B, off, BENCH_FILE_REC_OSC_NEON_INP_C);
+    free(input);
+    free(shift_state);
+    printf("processed %f Msamples in %f ms\n", off * 1E-6, T*1E3);
+    double nI = ((double)iter) * B;  /* number of iterations "normalized" to O(N) = N */
+    return (nI / T);    /* normalized iterations per second */
+}
+
+
+
+double bench_core_shift_nco_inplace(
+        const int B, const int N, const bool ignore_time,
+        complexf *data,
+        shift_nco_t &state,
+        int &iters_out, int &off_out
+        )
+{
+    const double t0 = uclock_sec(1);
+    const double tstop = t0 + 0.5;  /* benchmark duration: 500 ms */
+    double t1;
+    int off = 0, iter = 0;
+    papi_perf_counter perf_counter(1);
+
+    do {
+        // work
+        shift_nco_inp_c(data+off, B, &state);
+        off += B;
+        ++iter;
+        t1 = uclock_sec(0);
+    } while ( off + B < N && (ignore_time || t1 < tstop) );
+
+    iters_out = iter;
+    off_out = off;
+    perf_counter.set_samples(off, __func__);
+    return t1 - t0;
+}
+
+double bench_shift_nco_inp(const int B, const int N, const bool ignore_time) {
+    complexf *input = (complexf *)malloc(N * sizeof(complexf));
+    shift_recursive_osc_t gen_state;
+    shift_recursive_osc_conf_t gen_conf;
+    shift_nco_t shift_state = shift_nco_init(-0.0009, 0.0);
+    int iter, off;
+
+    shift_recursive_osc_init(0.001F, 0.0F, &gen_conf, &gen_state);
+    gen_recursive_osc_c(input, N, &gen_conf, &gen_state);
+
+    double T = bench_core_shift_nco_inplace(
+                B, N, ignore_time, input, shift_state,
+                iter, off
+                );
+
+    save(input, B, off, BENCH_FILE_NCO_INP_C);
+    free(input);
+    printf("processed %f Msamples in %f ms\n", off * 1E-6, T*1E3);
+    double nI = ((double)iter) * B;  /* number of iterations "normalized" to O(N) = N */
+    return (nI / T);    /* normalized iterations per second */
+}
+
+
+double bench_core_shift_nco_cs16(
+        const int B, const int N, const bool ignore_time,
+        const int16_t *input, complexf *output,
+        shift_nco_t &state,
+        int &iters_out, int &off_out
+        )
+{
+    const double t0 = uclock_sec(1);
+    const double tstop = t0 + 0.5;  /* benchmark duration: 500 ms */
+    double t1;
+    int off = 0, iter = 0;
+    papi_perf_counter perf_counter(1);
+
+    do {
+        // work
+        shift_nco_cs16_c(input+2*off, output+off, B, 1.0F / 32768.0F, &state);
+        off += B;
+        ++iter;
+        t1 = uclock_sec(0);
+    } while ( off + B < N && (ignore_time || t1 < tstop) );
+
+    iters_out = iter;
+    off_out = off;
+    perf_counter.set_samples(off, __func__);
+    return t1 - t0;
+}
+
+double bench_shift_nco_cs16(const int B, const int N, const bool ignore_time) {
+    int16_t *input = (int16_t *)malloc(2 * N * sizeof(int16_t));
+    complexf *output = (complexf *)malloc(N * sizeof(complexf));
+    shift_nco_t shift_state = shift_nco_init(-0.0009, 0.0);
+    int iter, off;
+
+    for (int k = 0; k < N; ++k) {
+        input[2*k] = (int16_t)(30000.0 * cos(0.001 * 2.0 * M_PI * k));
+        input[2*k+1] = (int16_t)(30000.0 * sin(0.001 * 2.0 * M_PI * k));
+    }
+
+    double T = bench_core_shift_nco_cs16(
+                B, N, ignore_time, input, output, shift_state,
+                iter, off
+                );
+
+    save(output, B, off, BENCH_FILE_NCO_CS16_C);
+    free(input);
+    free(output);
+    printf("processed %f Msamples in %f ms\n", off * 1E-6, T*1E3);
+    double nI = ((double)iter) * B;  /* number of iterations "normalized" to O(N) = N */
+    return (nI / T);    /* normalized iterations per second */
+}
+
+
 
 int main(int argc, char **argv)
 {
@@ -799,6 +1136,17 @@ int main(int argc, char **argv)
     if (argc == 1)
         showUsage = 1;
 
+    // '--counters' anywhere: hardware counter reports. the positional arguments follow
+    int num_pos = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--counters"))
+            papi_perf_counter::enable(true);
+        else
+            argv[1 + num_pos++] = argv[i];
+    }
+    argc = 1 + num_pos;
+
     if (1 < argc)
         B = atoi(argv[1]);
     if (2 < argc)
@@ -806,7 +1154,7 @@ int main(int argc, char **argv)
 
     if ( !B || !N || showUsage )
     {
-        fprintf(stderr, "%s [<blockLength in samples> [<total # of MSamples>] ]\n", argv[0]);
+        fprintf(stderr, "%s [--counters] [<blockLength in samples> [<total # of MSamples>] ]\n", argv[0]);
         if ( !B || !N )
             return 0;
     }
@@ -872,6 +1220,20 @@ int main(int argc, char **argv)
         printf("  %f MSamples/sec\n\n", rt * 1E-6);
     }
 
+    if ( have_avx_shift_mixer_impl() )
+    {
+        printf("starting bench of shift_limited_unroll_avx_inp_c in-place ..\n");
+        rt = bench_shift_limited_unroll_avx_inp(B, N, ignore_time);
+        printf("  %f MSamples/sec\n\n", rt * 1E-6);
+    }
+
+    if ( have_neon_shift_mixer_impl() )
+    {
+        printf("starting bench of shift_limited_unroll_C_neon_inp_c in-place ..\n");
+        rt = bench_shift_limited_unroll_C_neon_inp(B, N, ignore_time);
+        printf("  %f MSamples/sec\n\n", rt * 1E-6);
+    }
+
     printf("starting bench of shift_recursive_osc_cc in-place ..\n");
     rt = bench_shift_rec_osc_cc_inp(B, N, ignore_time);
     printf("  %f MSamples/sec\n\n", rt * 1E-6);
@@ -882,6 +1244,28 @@ int main(int argc, char **argv)
         rt = bench_shift_rec_osc_sse_c_inp(B, N, ignore_time);
         printf("  %f MSamples/sec\n\n", rt * 1E-6);
     }
+
+    if ( have_avx_shift_mixer_impl() )
+    {
+        printf("starting bench of shift_recursive_osc_avx_inp_c in-place ..\n");
+        rt = bench_shift_rec_osc_avx_inp(B, N, ignore_time);
+        printf("  %f MSamples/sec\n\n", rt * 1E-6);
+    }
+
+    if ( have_neon_shift_mixer_impl() )
+    {
+        printf("starting bench of shift_recursive_osc_neon_inp_c in-place ..\n");
+        rt = bench_shift_rec_osc_neon_inp(B, N, ignore_time);
+        printf("  %f MSamples/sec\n\n", rt * 1E-6);
+    }
+
+    printf("starting bench of shift_nco_inp_c in-place ..\n");
+    rt = bench_shift_nco_inp(B, N, ignore_time);
+    printf("  %f MSamples/sec\n\n", rt * 1E-6);
+
+    printf("starting bench of shift_nco_cs16_c (int16 input) ..\n");
+    rt = bench_shift_nco_cs16(B, N, ignore_time);
+    printf("  %f MSamples/sec\n\n", rt * 1E-6);
 #endif
 
     return 0;
@@ -28,6 +28,11 @@
 
  */
 
+/* for setenv() in strict C99 mode */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
 #define CONCAT_TOKENS(A, B)  A ## B
 #define CONCAT_THREE_TOKENS(A, B, C)  A ## B ## C
 
@@ -92,6 +97,9 @@ typedef PFFFTD_Setup PFFFT_SETUP;
 #include <assert.h>
 #include <string.h>
 
+#include "bench_harness.h"
+#include "bench_counters.h"
+
 #ifdef HAVE_SYS_TIMES
 #  include <sys/times.h>
 #  include <unistd.h>
@@ -531,6 +539,58 @@ double cal_benchmark(int N, int cplx) {
 
 
 
+/* PFFFT_NO_CODELETS is evaluated when creating a setup */
+static void set_no_codelets(int disable) {
+#ifdef _WIN32
+  _putenv(disable ? "PFFFT_NO_CODELETS=1" : "PFFFT_NO_CODELETS=0");
+#else
+  setenv("PFFFT_NO_CODELETS", disable ? "1" : "0", 1);
+#endif
+}
+
+/* duration in ns of a PFFFT-U forward + backward transform */
+static double time_pffft_u(int N, int cplx) {
+  int Nfloat = (cplx ? N*2 : N);
+  int Nbytes = Nfloat * sizeof(pffft_scalar);
+  pffft_scalar *X = PFFFT_FUNC(aligned_malloc)(Nbytes), *Y = PFFFT_FUNC(aligned_malloc)(Nbytes), *Z = PFFFT_FUNC(aligned_malloc)(Nbytes);
+  PFFFT_SETUP *s = PFFFT_FUNC(new_setup)(N, cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+  double t0, t1, tstop;
+  int k, iter = 0;
+
+  assert(s);
+  for (k = 0; k < Nfloat; ++k)
+    X[k] = sqrtf(k+1);
+  t0 = uclock_sec();
+  tstop = t0 + 0.25;
+  do {
+    for ( k = 0; k < 512; ++k ) {
+      PFFFT_FUNC(transform)(s, X, Z, Y, PFFFT_FORWARD);
+      PFFFT_FUNC(transform)(s, X, Z, Y, PFFFT_BACKWARD);
+      ++iter;
+    }
+    t1 = uclock_sec();
+  } while ( t1 < tstop );
+  PFFFT_FUNC(destroy_setup)(s);
+  PFFFT_FUNC(aligned_free)(X);
+  PFFFT_FUNC(aligned_free)(Y);
+  PFFFT_FUNC(aligned_free)(Z);
+  return 1e9 * (t1 - t0) / iter;
+}
+
+/* compare the small N codelets against the generic fftpack drivers */
+void benchmark_codelets(int cplx) {
+  int N;
+  for (N = PFFFT_FUNC(min_fft_size)(cplx ? PFFFT_COMPLEX : PFFFT_REAL); N <= 256; N *= 2) {
+    double t_generic, t_codelet;
+    set_no_codelets(1);
+    t_generic = time_pffft_u(N, cplx);
+    set_no_codelets(0);
+    t_codelet = time_pffft_u(N, cplx);
+    printf("%s N = %4d: generic %9.1f ns, codelet %9.1f ns, speedup %.2f\n", (cplx ? "cplx" : "real"),
+           N, t_generic, t_codelet, t_generic / t_codelet);
+  }
+}
+
 void benchmark_ffts(int N, int cplx, int withFFTWfullMeas, double iterCal, double tmeas[NUM_TYPES][NUM_FFT_ALGOS], int haveAlgo[NUM_FFT_ALGOS], FILE *tableFile ) {
   const int log2N = Log2(N);
   int nextPow2N = PFFFT_FUNC(next_power_of_two)(N);
@@ -1123,6 +1183,71 @@ void benchmark_ffts(int N, int cplx, int withFFTWfullMeas, double iterCal, doubl
 }
 
 
+/* PFFFT-U (unordered) or PFFFT (ordered) with bench_measure():
+ * one iteration is one transform, alternating forward and backward */
+typedef struct {
+  PFFFT_SETUP *s;
+  pffft_scalar *X, *Y, *Z;
+  int ordered;
+} harness_ctx;
+
+static void harness_transforms(void *ctx, long iterations) {
+  harness_ctx *c = (harness_ctx *)ctx;
+  long k;
+  for (k = 0; k < iterations; ++k) {
+    const pffft_direction_t dir = (k & 1) ? PFFFT_BACKWARD : PFFFT_FORWARD;
+    if (c->ordered)
+      PFFFT_FUNC(transform_ordered)(c->s, c->X, c->Z, c->Y, dir);
+    else
+      PFFFT_FUNC(transform)(c->s, c->X, c->Z, c->Y, dir);
+  }
+}
+
+/* median/percentile measurement of PFFFT-U and PFFFT for size N into results.
+ * with counters, one more repetition is counted: reported per sample of the transforms */
+void benchmark_pffft_harness(int N, int cplx, const bench_config *config, bench_results *results,
+                             bench_counters *counters) {
+  const int Nfloat = (cplx ? N*2 : N);
+  const int Nbytes = Nfloat * sizeof(pffft_scalar);
+  const double flops = (cplx ? 5 : 2.5) * N * log((double)N) / M_LN2;  /* per transform */
+  harness_ctx c;
+  bench_stats st;
+  int k, ordered;
+
+  if (!PFFFT_FUNC(is_valid_size)(N, cplx ? PFFFT_COMPLEX : PFFFT_REAL))
+    return;
+  c.s = PFFFT_FUNC(new_setup)(N, cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+  c.X = PFFFT_FUNC(aligned_malloc)(Nbytes);
+  c.Y = PFFFT_FUNC(aligned_malloc)(Nbytes);
+  c.Z = PFFFT_FUNC(aligned_malloc)(Nbytes);
+  if (c.s && c.X && c.Y && c.Z) {
+    for (k = 0; k < Nfloat; ++k)
+      c.X[k] = sqrtf(k+1);
+    for (ordered = 0; ordered < 2; ++ordered) {
+      c.ordered = ordered;
+      if (bench_measure(config, harness_transforms, &c, &st))
+        continue;
+      bench_results_add(results, (ordered ? "PFFFT" : "PFFFT-U"), (cplx ? "cplx" : "real"), N, &st, flops);
+      printf("N=%5d, %s %-8s : median %10.1f ns [p10 %10.1f, p90 %10.1f, min %10.1f], %6.0f MFlops, %d x %ld runs\n",
+             N, (cplx ? "CPLX" : "REAL"), (ordered ? "PFFFT" : "PFFFT-U"), st.median, st.p10, st.p90, st.min,
+             1E3 * flops / st.median, st.repetitions, st.iterations);
+      if (counters && !bench_counters_start(counters)) {
+        bench_counter_values cv;
+        harness_transforms(&c, st.iterations);
+        if (!bench_counters_stop(counters, &cv))
+          bench_counters_print(stdout, "  counters", &cv, (double)st.iterations * N);
+      }
+      fflush(stdout);
+    }
+  }
+  if (c.s)
+    PFFFT_FUNC(destroy_setup)(c.s);
+  PFFFT_FUNC(aligned_free)(c.X);
+  PFFFT_FUNC(aligned_free)(c.Y);
+  PFFFT_FUNC(aligned_free)(c.Z);
+}
+
+
 /* small functions inside pffft.c that will detect (compiler) bugs with respect to simd instructions */
 void validate_pffft_simd();
 int  validate_pffft_simd_ex(FILE * DbgOut);
@@ -1166,6 +1291,13 @@ int main(int argc, char **argv) {
   int haveAlgo[NUM_FFT_ALGOS];
   char acCsvFilename[64];
 
+  /* statistically robust measurement of pffft with bench_harness */
+  bench_config harnessConfig;
+  const char *harnessFilename[2] = { NULL, NULL };  /* JSON, CSV */
+  const char *compareFilename[2] = { NULL, NULL };  /* baseline, current */
+  double compareThreshold = 0.1;
+  int withCounters = 0;
+
   for ( k = 1; k <= NUMPOW2FFTLENS; ++k )
     Npow2[k-1] = (k == NUMPOW2FFTLENS) ? -1 : (1 << k);
   Nvalues = Npow2;  /* set default .. for comparisons .. */
@@ -1173,6 +1305,8 @@ int main(int argc, char **argv) {
   for ( i = 0; i < NUM_FFT_ALGOS; ++i )
     haveAlgo[i] = 0;
 
+  bench_config_default(&harnessConfig);
+
   printf("pffft architecture:    '%s'\n", PFFFT_FUNC(simd_arch)());
   printf("pffft SIMD size:       %d\n", PFFFT_FUNC(simd_size)());
   printf("pffft min real fft:    %d\n", PFFFT_FUNC(min_fft_size)(PFFFT_REAL));
@@ -1207,6 +1341,13 @@ int main(int argc, char **argv) {
       fprintf(stdout, "actived quicktest mode\n");
       quicktest = 1;
     }
+    else if (!strcmp(argv[i], "--codelets")) {
+      if (benchReal)
+        benchmark_codelets(0);
+      if (benchCplx)
+        benchmark_codelets(1);
+      return 0;
+    }
     else if (!strcmp(argv[i], "--validate")) {
 #ifdef HAVE_FFTPACK
       int r;
@@ -1219,12 +1360,79 @@ int main(int argc, char **argv) {
 #endif
       return 0;
     }
+    else if ((!strcmp(argv[i], "--json") || !strcmp(argv[i], "--csv")) && i+1 < argc) {
+      harnessFilename[argv[i][2] == 'j' ? 0 : 1] = argv[i+1];
+      ++i;
+    }
+    else if (!strcmp(argv[i], "--compare") && i+2 < argc) {
+      compareFilename[0] = argv[i+1];
+      compareFilename[1] = argv[i+2];
+      i += 2;
+    }
+    else if (!strcmp(argv[i], "--counters")) {
+      withCounters = 1;
+    }
+    else if (!strcmp(argv[i], "--threshold") && i+1 < argc) {
+      compareThreshold = atof(argv[i+1]) / 100.0;
+      ++i;
+    }
+    else if (bench_config_parse_arg(&harnessConfig, argc, argv, &i)) {
+      /* harness option consumed */
+    }
     else /* if (!strcmp(argv[i], "--help")) */ {
-      printf("usage: %s [--array-format|--table] [--no-tab] [--real|--cplx] [--validate] [--fftw-full-measure] [--non-pow2] [--max-len <N>] [--quick]\n", argv[0]);
+      printf("usage: %s [--array-format|--table] [--no-tab] [--real|--cplx] [--validate] [--codelets] [--fftw-full-measure] [--non-pow2] [--max-len <N>] [--quick]\n", argv[0]);
+      printf("  robust pffft measurement: %s [--real|--cplx] [--non-pow2] [--max-len <N>] [--json <file>] [--csv <file>] [--counters] %s\n", argv[0], bench_config_usage());
+      printf("  regression check:         %s --compare <baseline> <current> [--threshold <percent>]\n", argv[0]);
       exit(0);
     }
   }
 
+  if (compareFilename[0]) {
+    bench_results *baseline = bench_results_read(compareFilename[0]);
+    bench_results *current = bench_results_read(compareFilename[1]);
+    int regressions = -1;
+    if (baseline && current)
+      regressions = bench_results_compare(baseline, current, compareThreshold, stdout);
+    else
+      fprintf(stderr, "error reading '%s' or '%s'!\n", compareFilename[0], compareFilename[1]);
+    bench_results_free(baseline);
+    bench_results_free(current);
+    return regressions ? 1 : 0;
+  }
+
+  if (harnessFilename[0] || harnessFilename[1] || withCounters) {
+    bench_counters *counters = (withCounters ? bench_counters_open() : NULL);
+    bench_results *results = bench_results_new(
+#ifdef PFFFT_ENABLE_FLOAT
+      "bench_pffft_float",
+#else
+      "bench_pffft_double",
+#endif
+      PFFFT_FUNC(simd_arch)());
+    int r = (results ? 0 : 1);
+    if (bench_harness_init(&harnessConfig))
+      fprintf(stderr, "warning: pinning to CPU %d failed!\n", harnessConfig.cpu);
+    if (withCounters)
+      printf("hardware counters: %s\n", (counters ? bench_counters_backend(counters) : "not available (PAPI or perf_event)"));
+    printf("%d repetitions after %d warmup, min %.1f ms each: durations per transform\n",
+           harnessConfig.repetitions, harnessConfig.warmup, 1E3 * harnessConfig.min_rep_sec);
+    for (realCplxIdx = 0; realCplxIdx < 2 && results; ++realCplxIdx) {
+      if ( (realCplxIdx == 0 && !benchReal) || (realCplxIdx == 1 && !benchCplx) )
+        continue;
+      for (i=0; Nvalues[i] > 0 && Nvalues[i] <= max_N; ++i)
+        benchmark_pffft_harness(Nvalues[i], realCplxIdx, &harnessConfig, results, counters);
+    }
+    for (k = 0; k < 2 && results; ++k) {
+      if (harnessFilename[k] && bench_results_write(results, harnessFilename[k], (k ? BENCH_FORMAT_CSV : BENCH_FORMAT_JSON))) {
+        fprintf(stderr, "error writing '%s'!\n", harnessFilename[k]);
+        r = 1;
+      }
+    }
+    bench_results_free(results);
+    bench_counters_close(counters);
+    return r;
+  }
+
 #ifdef HAVE_FFTW
 #ifdef PFFFT_ENABLE_DOUBLE
   algoName[ALGO_FFTW_ESTIM] = "FFTW D(estim)";
@@ -5,6 +5,7 @@
 # provided:
 #   - function: target_set_c_arch_flags(<target>)    # uses options TARGET_C_ARCH and TARGET_C_EXTRA
 #   - function: target_set_cxx_arch_flags(<target>)  # uses options TARGET_CXX_ARCH and TARGET_CXX_EXTRA
+#   - macro:    target_set_c_arch_option(<target> <gcc/clang_march> <gcc/clang_extra> <msvc_arch>)
 #   - macro:    target_set_cxx_arch_option(<target> <gcc/clang_march> <gcc/clang_extra> <msvc_arch>)
 #
 # see https://en.wikichip.org/wiki/x86/extensions
@@ -40,6 +41,17 @@ set(GCC_EXTRA_OPT_none "")
 set(GCC_EXTRA_OPT_neon_vfpv4    "-mfloat-abi=hard" "-mfpu=neon-vfpv4")
 set(GCC_EXTRA_OPT_neon_rpi3_a53 "-mfloat-abi=hard" "-mfpu=neon-vfpv4" "-mtune=cortex-a53")
 set(GCC_EXTRA_OPT_neon_rpi4_a72 "-mfloat-abi=hard" "-mfpu=neon-fp-armv8" "-mtune=cortex-a72")
+# x86 extensions for the architecture specific builds of the pffft dispatcher
+set(GCC_EXTRA_OPT_x86_sse2      "-msse2")
+set(GCC_EXTRA_OPT_x86_avx       "-mavx")
+set(GCC_EXTRA_OPT_x86_avx2      "-mavx2" "-mfma" "-mf16c")
+set(GCC_EXTRA_OPT_x86_avx512    "-mavx512f" "-mf16c")
+# scalable vectors with a vector length fixed at compile time - see simd/pf_sve_float.h and simd/pf_rvv_float.h
+set(GCC_EXTRA_OPT_sve256        "-march=armv8.2-a+sve" "-msve-vector-bits=256")
+set(GCC_EXTRA_OPT_sve512        "-march=armv8.2-a+sve" "-msve-vector-bits=512")
+set(GCC_EXTRA_OPT_rvv128        "-march=rv64gcv" "-mrvv-vector-bits=zvl")
+set(GCC_EXTRA_OPT_rvv256        "-march=rv64gcv_zvl256b" "-mrvv-vector-bits=zvl")
+set(GCC_EXTRA_OPT_rvv512        "-march=rv64gcv_zvl512b" "-mrvv-vector-bits=zvl")
 
 if ( (CMAKE_SYSTEM_PROCESSOR STREQUAL "i686") OR (CMAKE_SYSTEM_PROCESSOR STREQUAL "x86_64") )
     set(GCC_MARCH_DESC "native/SSE2:pentium4/SSE3:core2/SSE4:nehalem/AVX:sandybridge/AVX2:haswell")
@@ -48,11 +60,15 @@ if ( (CMAKE_SYSTEM_PROCESSOR STREQUAL "i686") OR (CMAKE_SYSTEM_PROCESSOR STREQUA
 elseif (CMAKE_SYSTEM_PROCESSOR MATCHES "aarch64")
     set(GCC_MARCH_DESC "native/ARMwNEON:armv8-a")
     set(GCC_MARCH_VALUES "none;native;armv8-a" CACHE INTERNAL "List of possible architectures")
-    set(GCC_EXTRA_VALUES "" CACHE INTERNAL "List of possible additional options")
+    set(GCC_EXTRA_VALUES "none;sve256;sve512" CACHE INTERNAL "List of possible additional options")
 elseif (CMAKE_SYSTEM_PROCESSOR MATCHES "armv7l")
     set(GCC_MARCH_DESC "native/ARMwNEON:armv7-a")
     set(GCC_MARCH_VALUES "none;native;armv7-a" CACHE INTERNAL "List of possible architectures")
     set(GCC_EXTRA_VALUES "none;neon_vfpv4;neon_rpi3_a53;neon_rpi4_a72" CACHE INTERNAL "List of possible additional options")
+elseif (CMAKE_SYSTEM_PROCESSOR MATCHES "riscv64")
+    set(GCC_MARCH_DESC "native/RVV:rv64gcv")
+    set(GCC_MARCH_VALUES "none;native;rv64gcv" CACHE INTERNAL "List of possible architectures")
+    set(GCC_EXTRA_VALUES "none;rvv128;rvv256;rvv512" CACHE INTERNAL "List of possible additional options")
 else()
     message(WARNING "unsupported CMAKE_SYSTEM_PROCESSOR '${CMAKE_SYSTEM_PROCESSOR}'")
     # other PROCESSORs could be "ppc", "ppc64",  "arm" - or something else?!
@@ -137,6 +153,14 @@ function(target_set_c_arch_flags target)
             message(STATUS "additional option contains neon: setting PFFFT_ENABLE_NEON for C target ${target}")
             target_compile_definitions(${target} PRIVATE PFFFT_ENABLE_NEON=1)
         endif()
+        if ("${TARGET_C_EXTRA}" MATCHES "^sve.*")
+            message(STATUS "additional option contains 'sve': setting PFFFT_ENABLE_SVE for C target ${target}")
+            target_compile_definitions(${target} PRIVATE PFFFT_ENABLE_SVE=1)
+        endif()
+        if ("${TARGET_C_EXTRA}" MATCHES "^rvv.*")
+            message(STATUS "additional option contains 'rvv': setting PFFFT_ENABLE_RVV for C target ${target}")
+            target_compile_definitions(${target} PRIVATE PFFFT_ENABLE_RVV=1)
+        endif()
     endif()
 endfunction()
 
@@ -170,10 +194,40 @@ function(target_set_cxx_arch_flags target)
             message(STATUS "additional option contains 'neon': setting PFFFT_ENABLE_NEON for C++ target ${target}")
             target_compile_definitions(${target} PRIVATE PFFFT_ENABLE_NEON=1)
         endif()
+        if ("${TARGET_CXX_EXTRA}" MATCHES "^sve.*")
+            message(STATUS "additional option contains 'sve': setting PFFFT_ENABLE_SVE for C++ target ${target}")
+            target_compile_definitions(${target} PRIVATE PFFFT_ENABLE_SVE=1)
+        endif()
+        if ("${TARGET_CXX_EXTRA}" MATCHES "^rvv.*")
+            message(STATUS "additional option contains 'rvv': setting PFFFT_ENABLE_RVV for C++ target ${target}")
+            target_compile_definitions(${target} PRIVATE PFFFT_ENABLE_RVV=1)
+        endif()
     endif()
 endfunction()
 
 
+macro(target_set_c_arch_option target gcc_clang_arch gcc_clang_extra msvc_arch )
+    if ( (CMAKE_C_COMPILER_ID STREQUAL "GNU") OR (CMAKE_C_COMPILER_ID STREQUAL "Clang") )
+
+        if ( NOT (("${gcc_clang_arch}" STREQUAL "") OR ("${gcc_clang_arch}" STREQUAL "none") ) )
+            target_compile_options(${target} PRIVATE "-march=${gcc_clang_arch}")
+            message(STATUS "C ARCH for target ${target}: ${gcc_clang_arch}")
+        endif()
+        if (NOT ( ("${gcc_clang_extra}" STREQUAL "") OR ("${gcc_clang_extra}" STREQUAL "none") ) )
+            target_compile_options(${target} PRIVATE "${GCC_EXTRA_OPT_${gcc_clang_extra}}")
+            message(STATUS "C additional options for target ${target}: ${GCC_EXTRA_OPT_${gcc_clang_extra}}")
+        endif()
+    elseif (CMAKE_C_COMPILER_ID MATCHES "MSVC")
+        if ( NOT (("${msvc_arch}" STREQUAL "") OR ("${msvc_arch}" STREQUAL "none") ) )
+            target_compile_options(${target} PRIVATE "/arch:${msvc_arch}")
+            message(STATUS "C ARCH for target ${target} set: ${msvc_arch}")
+        endif()
+    else()
+        message(WARNING "unsupported C compiler '${CMAKE_C_COMPILER_ID}' for target_set_c_arch_option(), see https://cmake.org/cmake/help/latest/variable/CMAKE_LANG_COMPILER_ID.html")
+    endif()
+endmacro()
+
+
 macro(target_set_cxx_arch_option target gcc_clang_arch gcc_clang_extra msvc_arch )
     if ( (CMAKE_CXX_COMPILER_ID STREQUAL "GNU") OR (CMAKE_CXX_COMPILER_ID STREQUAL "Clang") )
 
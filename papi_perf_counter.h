@@ -1,16 +1,17 @@
 #pragma once
 
-/* for measurement of CPU cycles ..
+/* for measurement of CPU cycles, IPC, cache misses and vector instructions ..
  *
- * requires
+ * uses PAPI, when compiled with HAVE_PAPI, which requires
  *   sudo apt-get install libpapi-dev papi-tools
- * on debian/ubuntu linux distributions
+ * on debian/ubuntu linux distributions.
+ * without PAPI, Linux' perf_event_open() is used: see bench_counters.h
  *
+ * counting is active by default with PAPI. else it has to be activated
+ * with papi_perf_counter::enable(true), e.g. from a '--counters' option.
  */
 
-#ifdef HAVE_PAPI
-#include <papi.h>
-#endif
+#include "bench_counters.h"
 
 #include <stdio.h>
 
@@ -18,12 +19,13 @@
 struct papi_perf_counter
 {
     papi_perf_counter()
-        : realTime(0.0F), processTime(0.0F), instructions(0LL), ipc(0.0F)
+        : samples(0.0), label(0)
         , started(false), finished(false), print_at_destruction(false)
     { }
 
     papi_perf_counter(int _start, bool print_at_destruction_ = true)
-        : print_at_destruction(print_at_destruction_)
+        : samples(0.0), label(0)
+        , started(false), finished(false), print_at_destruction(print_at_destruction_)
     {
         (void)_start;
         start();
@@ -35,42 +37,58 @@ struct papi_perf_counter
             print(stderr);
     }
 
-    bool start()
+    static bool & enabled()
     {
-        static bool reported_start_error = false;
 #ifdef HAVE_PAPI
-        int ret = PAPI_ipc(&realTime, &processTime, &instructions, &ipc);
-        if (ret && !reported_start_error)
-        {
-            reported_start_error = true;
-            fprintf(stderr, "papi_perf_counter::start(): PAPI_ipc() returned error %d\n", ret);
-        }
+        static bool is_enabled = true;
 #else
-        if (!reported_start_error)
+        static bool is_enabled = false;
+#endif
+        return is_enabled;
+    }
+
+    static void enable(bool on)
+    {
+        enabled() = on;
+    }
+
+    /* opened once, at first use. NULL if not available */
+    static bench_counters * counters()
+    {
+        static bool opened = false;
+        static bench_counters * c = 0;
+        if (!opened)
         {
-            reported_start_error = true;
-            fprintf(stderr, "papi_perf_counter::start(): no HAVE_PAPI\n");
+            opened = true;
+            c = bench_counters_open();
+            if (!c)
+                fprintf(stderr, "papi_perf_counter: no hardware counters available (PAPI or perf_event)\n");
         }
-        int ret = 1;
-#endif
-        started = (!ret);
-        finished = false;
+        return c;
+    }
+
+    bool start()
+    {
+        started = finished = false;
+        if (!enabled() || !counters())
+            return false;
+        started = (bench_counters_start(counters()) == 0);
         return started;
     }
 
     bool finish()
     {
-        papi_perf_counter end(1, false);
-        if (started && !finished && end.started)
-        {
-            realTime = end.realTime - realTime;
-            processTime = end.processTime - processTime;
-            instructions = end.instructions - instructions;
-            ipc = end.ipc;
-            finished = true;
-            return true;
-        }
-        return false;
+        if (started && !finished)
+            finished = (bench_counters_stop(counters(), &values) == 0);
+        return finished;
+    }
+
+    /* number of processed samples - for the normalized values, e.g. cycles/sample */
+    void set_samples(double num_samples, const char * label_ = 0)
+    {
+        samples = num_samples;
+        if (label_)
+            label = label_;
     }
 
     void print(FILE *f = stdout)
@@ -79,17 +97,13 @@ struct papi_perf_counter
             finish();
         if (!started || !finished)
             return;
-        double cycles = instructions / ipc;
-        fprintf(f, "real %g, process %g, instructions %lld, ins/cycle %f => cycles %g\n"
-                , realTime, processTime, instructions, ipc, cycles
-                );
+        bench_counters_print(f, (label ? label : bench_counters_backend(counters())), &values, samples);
         started = false;
     }
 
-    float realTime;
-    float processTime;
-    long long instructions;
-    float ipc;
+    bench_counter_values values;
+    double samples;
+    const char * label;
     bool started;
     bool finished;
     bool print_at_destruction;
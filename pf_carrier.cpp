@@ -31,268 +31,357 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 /* include own header first, to see missing includes */
 #include "pf_carrier.h"
-#include "fmv.h"
+#include "pf_mixer.h"
 
+#include <math.h>
 #include <limits.h>
 #include <assert.h>
+#include <stdint.h>
 
+#ifndef PFFFT_SIMD_DISABLE
+#if (defined(__x86_64__) || defined(_M_X64) || defined(i386) || defined(_M_IX86))
+  #include <emmintrin.h>
+  #define HAVE_SSE2_INTRINSICS 1
+#elif (defined(PFFFT_ENABLE_NEON) || defined(__ARM_NEON))
+  #include <arm_neon.h>
+  #define HAVE_NEON_INTRINSICS 1
+#endif
+#endif
 
-PF_TARGET_CLONES
-void generate_dc_f(float* output, int size)
+#ifndef M_PI
+#define M_PI  3.14159265358979323846
+#endif
+
+
+/* all the carriers are periodic with 4 complex samples: 8 shorts or floats.
+ * fill n values with the pattern - starting with pattern[0] */
+
+static void fill_pattern_s16(short* output, int n, const short* pattern)
 {
-    for(int i=0;i<2*size;)
+    int i = 0;
+#if defined(HAVE_SSE2_INTRINSICS)
+    while (i < n && ((uintptr_t)(output + i) & 15))
     {
-        /* exp(i*0) = 1+i*0 */
-        output[i++]=(127.0F / 128.0F);
-        output[i++]=0.0F;
+        output[i] = pattern[i & 7];
+        ++i;
     }
+    if (n - i >= 8)
+    {
+        short rot[8];
+        for (int j = 0; j < 8; ++j)
+            rot[j] = pattern[(i + j) & 7];
+        const __m128i v = _mm_loadu_si128((const __m128i*)rot);
+        __m128i* p = (__m128i*)(output + i);
+        const int nv = (n - i) / 8;
+        if ((size_t)n * sizeof(short) >= PF_CARRIER_STREAM_BYTES)
+        {
+            for (int k = 0; k < nv; ++k)
+                _mm_stream_si128(p + k, v);
+            _mm_sfence();
+        }
+        else
+        {
+            for (int k = 0; k < nv; ++k)
+                _mm_store_si128(p + k, v);
+        }
+        i += 8 * nv;
+    }
+#elif defined(HAVE_NEON_INTRINSICS)
+    const int16x8_t v = vld1q_s16(pattern);
+    for ( ; i + 8 <= n; i += 8)
+        vst1q_s16(output + i, v);
+#endif
+    for ( ; i < n; ++i)
+        output[i] = pattern[i & 7];
 }
 
-PF_TARGET_CLONES
-void generate_dc_s16(short* output, int size)
+static void fill_pattern_f(float* output, int n, const float* pattern)
 {
-    for(int i=0;i<2*size;)
+    int i = 0;
+#if defined(HAVE_SSE2_INTRINSICS)
+    while (i < n && ((uintptr_t)(output + i) & 15))
+    {
+        output[i] = pattern[i & 7];
+        ++i;
+    }
+    if (n - i >= 8)
     {
-        /* exp(i*0) = 1+i*0 */
-        output[i++]=SHRT_MAX;
-        output[i++]=0;
+        float rot[8];
+        for (int j = 0; j < 8; ++j)
+            rot[j] = pattern[(i + j) & 7];
+        const __m128 v0 = _mm_loadu_ps(rot);
+        const __m128 v1 = _mm_loadu_ps(rot + 4);
+        float* p = output + i;
+        const int nv = (n - i) / 8;
+        if ((size_t)n * sizeof(float) >= PF_CARRIER_STREAM_BYTES)
+        {
+            for (int k = 0; k < nv; ++k, p += 8)
+            {
+                _mm_stream_ps(p, v0);
+                _mm_stream_ps(p + 4, v1);
+            }
+            _mm_sfence();
+        }
+        else
+        {
+            for (int k = 0; k < nv; ++k, p += 8)
+            {
+                _mm_store_ps(p, v0);
+                _mm_store_ps(p + 4, v1);
+            }
+        }
+        i += 8 * nv;
     }
+#elif defined(HAVE_NEON_INTRINSICS)
+    const float32x4_t v0 = vld1q_f32(pattern);
+    const float32x4_t v1 = vld1q_f32(pattern + 4);
+    for ( ; i + 8 <= n; i += 8)
+    {
+        vst1q_f32(output + i, v0);
+        vst1q_f32(output + i + 4, v1);
+    }
+#endif
+    for ( ; i < n; ++i)
+        output[i] = pattern[i & 7];
+}
+
+
+void generate_dc_f(float* output, int size)
+{
+    /* exp(i*0) = 1+i*0 */
+    static const float pattern[8] = {
+        (127.0F / 128.0F), 0.0F, (127.0F / 128.0F), 0.0F,
+        (127.0F / 128.0F), 0.0F, (127.0F / 128.0F), 0.0F
+    };
+    fill_pattern_f(output, 2*size, pattern);
+}
+
+void generate_dc_s16(short* output, int size)
+{
+    /* exp(i*0) = 1+i*0 */
+    static const short pattern[8] = { SHRT_MAX, 0, SHRT_MAX, 0, SHRT_MAX, 0, SHRT_MAX, 0 };
+    fill_pattern_s16(output, 2*size, pattern);
 }
 
-PF_TARGET_CLONES
 void generate_pos_fs4_f(float* output, int size)
 {
+    static const float pattern[8] = {
+        (127.0F / 128.0F), 0.0F,    /* exp(i*0) = 1+i*0 */
+        0.0F, (127.0F / 128.0F),    /* exp(i* +pi/2) = 0+i*1 */
+        (-127.0F / 128.0F), 0.0F,   /* exp(i* +pi) = -1+i*0 */
+        0.0F, (-127.0F / 128.0F)    /* exp(i* -pi/2) = 0+i*-1 */
+    };
     /* size must be multiple of 4 */
     assert(!(size&3));
-    for(int i=0;i<2*size;)
-    {
-        /* exp(i*0) = 1+i*0 */
-        output[i++]=(127.0F / 128.0F);
-        output[i++]=0.0F;
-        /* exp(i* +pi/2) = 0+i*1 */
-        output[i++]=0.0F;
-        output[i++]=(127.0F / 128.0F);
-        /* exp(i* +pi) = -1+i*0 */
-        output[i++]=(-127.0F / 128.0F);
-        output[i++]=0.0F;
-        /* exp(i* -pi/2) = 0+i*-1 */
-        output[i++]=0.0F;
-        output[i++]=(-127.0F / 128.0F);
-    }
+    fill_pattern_f(output, 2*size, pattern);
 }
 
-PF_TARGET_CLONES
 void generate_pos_fs4_s16(short* output, int size)
 {
+    static const short pattern[8] = {
+        SHRT_MAX, 0,        /* exp(i*0) = 1+i*0 */
+        0, SHRT_MAX,        /* exp(i* +pi/2) = 0+i*1 */
+        -SHRT_MAX, 0,       /* exp(i* +pi) = -1+i*0 */
+        0, -SHRT_MAX        /* exp(i* -pi/2) = 0+i*-1 */
+    };
     /* size must be multiple of 4 */
     assert(!(size&3));
-    for(int i=0;i<2*size;)
-    {
-        /* exp(i*0) = 1+i*0 */
-        output[i++]=SHRT_MAX;
-        output[i++]=0;
-        /* exp(i* +pi/2) = 0+i*1 */
-        output[i++]=0;
-        output[i++]=SHRT_MAX;
-        /* exp(i* +pi) = -1+i*0 */
-        output[i++]=-SHRT_MAX;
-        output[i++]=0;
-        /* exp(i* -pi/2) = 0+i*-1 */
-        output[i++]=0;
-        output[i++]=-SHRT_MAX;
-    }
+    fill_pattern_s16(output, 2*size, pattern);
 }
 
-PF_TARGET_CLONES
 void generate_neg_fs4_f(float* output, int size)
 {
+    static const float pattern[8] = {
+        (127.0F / 128.0F), 0.0F,    /* exp(i*0) = 1+i*0 */
+        0.0F, (-127.0F / 128.0F),   /* exp(i* -pi/2) = 0+i*-1 */
+        (-127.0F / 128.0F), 0.0F,   /* exp(i* +pi) = -1+i*0 */
+        0.0F, (127.0F / 128.0F)     /* exp(i* +pi/2) = 0+i*1 */
+    };
     /* size must be multiple of 4 */
     assert(!(size&3));
-    for(int i=0;i<2*size;)
-    {
-        /* exp(i*0) = 1+i*0 */
-        output[i++]=(127.0F / 128.0F);
-        output[i++]=0.0F;
-        /* exp(i* -pi/2) = 0+i*-1 */
-        output[i++]=0.0F;
-        output[i++]=(-127.0F / 128.0F);
-        /* exp(i* +pi) = -1+i*0 */
-        output[i++]=(-127.0F / 128.0F);
-        output[i++]=0.0F;
-        /* exp(i* +pi/2) = 0+i*1 */
-        output[i++]=0.0F;
-        output[i++]=(127.0F / 128.0F);
-    }
+    fill_pattern_f(output, 2*size, pattern);
 }
 
-PF_TARGET_CLONES
 void generate_neg_fs4_s16(short* output, int size)
 {
+    static const short pattern[8] = {
+        SHRT_MAX, 0,        /* exp(i*0) = 1+i*0 */
+        0, -SHRT_MAX,       /* exp(i* -pi/2) = 0+i*-1 */
+        -SHRT_MAX, 0,       /* exp(i* +pi) = -1+i*0 */
+        0, SHRT_MAX         /* exp(i* +pi/2) = 0+i*1 */
+    };
     /* size must be multiple of 4 */
     assert(!(size&3));
-    for(int i=0;i<2*size;)
-    {
-        /* exp(i*0) = 1+i*0 */
-        output[i++]=SHRT_MAX;
-        output[i++]=0;
-        /* exp(i* -pi/2) = 0+i*-1 */
-        output[i++]=0;
-        output[i++]=-SHRT_MAX;
-        /* exp(i* +pi) = -1+i*0 */
-        output[i++]=-SHRT_MAX;
-        output[i++]=0;
-        /* exp(i* +pi/2) = 0+i*1 */
-        output[i++]=0;
-        output[i++]=SHRT_MAX;
-    }
+    fill_pattern_s16(output, 2*size, pattern);
 }
 
 /****************************************************/
 
-PF_TARGET_CLONES
+#define M_HALF  (SHRT_MAX / 2)
+
 void generate_dc_pos_fs4_s16(short* output, int size)
 {
-    const int m = SHRT_MAX / 2;
+    static const short pattern[8] = {
+        M_HALF+M_HALF, 0,   /* exp(i*0) = 1+1+i*0 */
+        M_HALF+0, M_HALF,   /* exp(i* +pi/2) = 1+0+i*1 */
+        M_HALF-M_HALF, 0,   /* exp(i* +pi) = 1-1+i*0 */
+        M_HALF, -M_HALF     /* exp(i* -pi/2) = 1+0+i*-1 */
+    };
     /* size must be multiple of 4 */
     assert(!(size&3));
-    for(int i=0;i<2*size;)
-    {
-        /* exp(i*0) = 1+1+i*0 */
-        output[i++]=m+m;
-        output[i++]=0;
-        /* exp(i* +pi/2) = 1+0+i*1 */
-        output[i++]=m+0;
-        output[i++]=m;
-        /* exp(i* +pi) = 1-1+i*0 */
-        output[i++]=m-m;
-        output[i++]=0;
-        /* exp(i* -pi/2) = 1+0+i*-1 */
-        output[i++]=m;
-        output[i++]=-m;
-    }
+    fill_pattern_s16(output, 2*size, pattern);
 }
 
-PF_TARGET_CLONES
 void generate_dc_neg_fs4_s16(short* output, int size)
 {
-    const int m = SHRT_MAX / 2;
+    static const short pattern[8] = {
+        M_HALF+M_HALF, 0,   /* exp(i*0) = 1+1+i*0 */
+        M_HALF+0, -M_HALF,  /* exp(i* -pi/2) = 1+0+i*-1 */
+        M_HALF-M_HALF, 0,   /* exp(i* +pi) = 1-1+i*0 */
+        M_HALF+0, M_HALF    /* exp(i* +pi/2) = 1+0+i*1 */
+    };
     /* size must be multiple of 4 */
     assert(!(size&3));
-    for(int i=0;i<2*size;)
-    {
-        /* exp(i*0) = 1+1+i*0 */
-        output[i++]=m+m;
-        output[i++]=0;
-        /* exp(i* -pi/2) = 1+0+i*-1 */
-        output[i++]=m+0;
-        output[i++]=-m;
-        /* exp(i* +pi) = 1-1+i*0 */
-        output[i++]=m-m;
-        output[i++]=0;
-        /* exp(i* +pi/2) = 1+0+i*1 */
-        output[i++]=m+0;
-        output[i++]=m;
-    }
+    fill_pattern_s16(output, 2*size, pattern);
 }
 
-PF_TARGET_CLONES
 void generate_pos_neg_fs4_s16(short* output, int size)
 {
-    const int m = SHRT_MAX / 2;
-    /* size must be multiple of 4 */
-    assert(!(size&3));
-    for(int i=0;i<2*size;)
-    {
+    static const short pattern[8] = {
         /* pos(0) + neg(0) = exp(i*  0   ) + exp(i*  0   ) =  1 +i*  0  +  1 +i*  0 */
-        output[i++]=m;
-        output[i++]=-m;
-
+        M_HALF, -M_HALF,
         /* pos(1) + neg(1) = exp(i* +pi/2) + exp(i* -pi/2) =  0 +i*  1  +  0 +i* -1 */
-        output[i++]=-m;
-        output[i++]=m;
-
+        -M_HALF, M_HALF,
         /* pos(2) + neg(2) = exp(i* +pi  ) + exp(i* +pi  ) = -1 +i*  0  + -1 +i*  0 */
-        output[i++]=-m;
-        output[i++]=m;
-
+        -M_HALF, M_HALF,
         /* pos(3) + neg(3) = exp(i* -pi/2) + exp(i* +pi/2) =  0 +i* -1  +  0 +i*  1 */
-        output[i++]=m;
-        output[i++]=-m;
-    }
+        M_HALF, -M_HALF
+    };
+    /* size must be multiple of 4 */
+    assert(!(size&3));
+    fill_pattern_s16(output, 2*size, pattern);
 }
 
-PF_TARGET_CLONES
 void generate_dc_pos_neg_fs4_s16(short* output, int size)
 {
-    const int m = SHRT_MAX / 2;
-    /* size must be multiple of 4 */
-    assert(!(size&3));
-    for(int i=0;i<2*size;)
-    {
+    static const short pattern[8] = {
         /* dc + pos(0) + neg(0) = dc + exp(i*  0   ) + exp(i*  0   ) =  1 +i*  0  +  1 +i*  0 */
-        output[i++]=m+m;
-        output[i++]=-m;
-
+        M_HALF+M_HALF, -M_HALF,
         /* dc + pos(1) + neg(1) = dc + exp(i* +pi/2) + exp(i* -pi/2) =  0 +i*  1  +  0 +i* -1 */
-        output[i++]=0;
-        output[i++]=m;
-
+        0, M_HALF,
         /* dc + pos(2) + neg(2) = dc + exp(i* +pi  ) + exp(i* +pi  ) = -1 +i*  0  + -1 +i*  0 */
-        output[i++]=0;
-        output[i++]=m;
-
+        0, M_HALF,
         /* dc + pos(3) + neg(3) = dc + exp(i* -pi/2) + exp(i* +pi/2) =  0 +i* -1  +  0 +i*  1 */
-        output[i++]=m+m;
-        output[i++]=-m;
-    }
+        M_HALF+M_HALF, -M_HALF
+    };
+    /* size must be multiple of 4 */
+    assert(!(size&3));
+    fill_pattern_s16(output, 2*size, pattern);
 }
 
 
-PF_TARGET_CLONES
 void generate_pos_neg_fs2_s16(short* output, int size)
 {
-    const int m = SHRT_MAX / 2;
+    static const short pattern[8] = {
+        M_HALF, 0,          /* dc + exp(i* 0 ) = +1 */
+        -M_HALF, 0,         /* dc + exp(i* pi) = -1 */
+        M_HALF, 0,          /* dc + exp(i* 0 ) = +1 */
+        -M_HALF, 0          /* dc + exp(i* pi) = -1 */
+    };
     /* size must be multiple of 4 */
     assert(!(size&3));
-    for(int i=0;i<2*size;)
-    {
-        /* dc + exp(i* 0 ) = +1 */
-        output[i++]=m;
-        output[i++]=0;
-        /* dc + exp(i* pi) = -1 */
-        output[i++]=-m;
-        output[i++]=0;
-        /* dc + exp(i* 0 ) = +1 */
-        output[i++]=m;
-        output[i++]=0;
-        /* dc + exp(i* pi) = -1 */
-        output[i++]=-m;
-        output[i++]=0;
-    }
+    fill_pattern_s16(output, 2*size, pattern);
 }
 
-PF_TARGET_CLONES
 void generate_dc_pos_neg_fs2_s16(short* output, int size)
 {
-    const int m = SHRT_MAX / 2;
+    /* with dc = i*1 */
+    static const short pattern[8] = {
+        M_HALF, M_HALF,     /* dc + exp(i* 0 ) = i*1 +1 */
+        -M_HALF, M_HALF,    /* dc + exp(i* pi) = i*1 -1 */
+        M_HALF, M_HALF,     /* dc + exp(i* 0 ) = i*1 +1 */
+        -M_HALF, M_HALF     /* dc + exp(i* pi) = i*1 -1 */
+    };
     /* size must be multiple of 4 */
     assert(!(size&3));
-    for(int i=0;i<2*size;)
+    fill_pattern_s16(output, 2*size, pattern);
+}
+
+/****************************************************/
+
+void tone_gen_init(tone_gen_t * gen, float relative_freq, float starting_phase, float amplitude)
+{
+    gen->phase = starting_phase;
+    gen->phase_increment = 2.0 * M_PI * relative_freq;
+    gen->amplitude = amplitude;
+}
+
+/* n <= PF_TONE_GEN_BLOCK samples of the unit phasor into tmp:
+ * the oscillator is restarted from the exact phase. the state and constants
+ * are those of shift_recursive_osc_init() - computed in double precision,
+ * which matters close to +/- samplerate/2, where the float wrapping of
+ * the phase increment for PF_SHIFT_RECURSIVE_SIMD_SZ steps loses precision */
+static void tone_gen_block(tone_gen_t * gen, complexf * tmp, int n)
+{
+    shift_recursive_osc_conf_t conf;
+    shift_recursive_osc_t osc;
+    const int n8 = (n + PF_SHIFT_RECURSIVE_SIMD_SZ - 1) & ~(PF_SHIFT_RECURSIVE_SIMD_SZ - 1);
+    const double inc_b = remainder(PF_SHIFT_RECURSIVE_SIMD_SZ * gen->phase_increment, 2.0 * M_PI);
+    const double k1 = tan(0.5 * inc_b);
+    for (int j = 0; j < PF_SHIFT_RECURSIVE_SIMD_SZ; ++j)
     {
-        /* with dc = i*1 */
-        /* dc + exp(i* 0 ) = i*1 +1 */
-        output[i++]=m;
-        output[i++]=m;
-        /* dc + exp(i* pi) = i*1 -1 */
-        output[i++]=-m;
-        output[i++]=m;
-        /* dc + exp(i* 0 ) = i*1 +1 */
-        output[i++]=m;
-        output[i++]=m;
-        /* dc + exp(i* pi) = i*1 -1 */
-        output[i++]=-m;
-        output[i++]=m;
+        osc.u_cos[j] = (float)cos(gen->phase + j * gen->phase_increment);
+        osc.v_sin[j] = (float)sin(gen->phase + j * gen->phase_increment);
     }
+    conf.k1 = (float)k1;
+    conf.k2 = (float)(2.0 * k1 / (1.0 + k1 * k1));
+    gen_recursive_osc_c(tmp, n8, &conf, &osc);
+    gen->phase = fmod(gen->phase + n * gen->phase_increment, 2.0 * M_PI);
 }
 
+void generate_tone_f(float* output, int size, tone_gen_t * gen)
+{
+    complexf tmp[PF_TONE_GEN_BLOCK];
+    const float a = gen->amplitude;
+    for (int off = 0; off < size; off += PF_TONE_GEN_BLOCK)
+    {
+        const int n = (size - off < PF_TONE_GEN_BLOCK) ? (size - off) : PF_TONE_GEN_BLOCK;
+        float* y = output + 2 * off;
+        tone_gen_block(gen, tmp, n);
+        for (int k = 0; k < n; ++k)
+        {
+            y[2*k]   = a * tmp[k].i;
+            y[2*k+1] = a * tmp[k].q;
+        }
+    }
+}
+
+void generate_tone_s16(short* output, int size, tone_gen_t * gen)
+{
+    complexf tmp[PF_TONE_GEN_BLOCK];
+    const float a = gen->amplitude * SHRT_MAX;
+    for (int off = 0; off < size; off += PF_TONE_GEN_BLOCK)
+    {
+        const int n = (size - off < PF_TONE_GEN_BLOCK) ? (size - off) : PF_TONE_GEN_BLOCK;
+        const float* x = &tmp[0].i;
+        short* y = output + 2 * off;
+        int k = 0;
+        tone_gen_block(gen, tmp, n);
+#if defined(HAVE_SSE2_INTRINSICS)
+        /* round to nearest and saturate */
+        const __m128 va = _mm_set1_ps(a);
+        for ( ; k + 8 <= 2 * n; k += 8)
+        {
+            const __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(x + k), va));
+            const __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(x + k + 4), va));
+            _mm_storeu_si128((__m128i*)(y + k), _mm_packs_epi32(lo, hi));
+        }
+#endif
+        for ( ; k < 2 * n; ++k)
+        {
+            const float v = floorf(a * x[k] + 0.5F);
+            y[k] = (short)(v > SHRT_MAX ? SHRT_MAX : (v < SHRT_MIN ? SHRT_MIN : v));
+        }
+    }
+}
 
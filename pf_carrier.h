@@ -30,6 +30,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include "pf_cplx.h"
+
 #include <stdio.h>
 #include <stdint.h>
 
@@ -38,21 +40,12 @@ extern "C" {
 #endif
 
 
-/*
-   _____                      _
-  / ____|                    | |
- | |     ___  _ __ ___  _ __ | | _____  __
- | |    / _ \| '_ ` _ \| '_ \| |/ _ \ \/ /
- | |___| (_) | | | | | | |_) | |  __/>  <
-  \_____\___/|_| |_| |_| .__/|_|\___/_/\_\
-                       | |
-                       |_|
-*/
-
-typedef struct complexf_s { float i; float q; } complexf;
-
+/* generation functions: size is the number of complex samples, written interleaved I/Q.
+ * the periodic patterns are broadcasted with SIMD stores - non-temporal (streaming)
+ * stores for buffers of at least PF_CARRIER_STREAM_BYTES, which would only evict the caches.
+ */
+#define PF_CARRIER_STREAM_BYTES  (1 << 20)
 
-/* generation functions */
 void generate_dc_f(float* output, int size);
 void generate_dc_s16(short* output, int size);
 void generate_pos_fs4_f(float* output, int size);
@@ -69,6 +62,31 @@ void generate_pos_neg_fs2_s16(short* output, int size);
 void generate_dc_pos_neg_fs2_s16(short* output, int size);
 
 
+/* complex tone of any frequency: amplitude * exp(i * phase), with the
+ * recursive oscillator from pf_mixer.h. the phase is kept in double precision
+ * and the oscillator is restarted from it every PF_TONE_GEN_BLOCK samples:
+ * neither phase nor amplitude drift over long signals.
+ * the phase continues from call to call.
+ */
+#define PF_TONE_GEN_BLOCK  512
+
+typedef struct tone_gen_s
+{
+    double phase;               /* phase of the next sample in radians */
+    double phase_increment;     /* 2 pi relative_freq */
+    float amplitude;
+} tone_gen_t;
+
+/* relative_freq = frequency / samplerate, in -0.5 .. 0.5 */
+void tone_gen_init(tone_gen_t * gen, float relative_freq, float starting_phase, float amplitude);
+
+/* float output: any size */
+void generate_tone_f(float* output, int size, tone_gen_t * gen);
+
+/* s16 output: amplitude 1.0 is SHRT_MAX - with rounding and saturation. any size */
+void generate_tone_s16(short* output, int size, tone_gen_t * gen);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,226 @@
+
+#include "pf_channelizer.h"
+#include "pffft.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <new>
+
+#if defined(_MSC_VER)
+#  define RESTRICT __restrict
+#elif defined(__GNUC__)
+#  define RESTRICT __restrict
+#else
+#  define RESTRICT
+#endif
+
+// minimum number of output steps per pffft_transform_batch() call
+#define CHANNELIZER_MIN_BATCH   8
+
+
+struct channelizer_setup
+{
+    int M;              // number of channels = FFT size
+    int OS;             // oversampling: 1 or 2
+    int D;              // decimation: M / OS
+    int P;              // taps per polyphase branch
+    int L;              // P * M taps of the padded prototype
+    int B;              // output steps per batch
+
+    float * hrev;       // prototype, reversed - each coefficient twice for re/im: 2 * L floats
+    complexf * buf;     // input window of the next output step: L - 1 + B * D samples
+    int fill;           // number of samples in buf
+    float * batch;      // B polyphase sums / spectra, each 2 * M floats
+    float * work;       // 2 * M floats for pffft
+    int * idx;          // position of re/im of channel k in the unordered spectrum: 2 * M
+    complexf * tw;      // phase correction of channel k, for (m * D) % M == q * D: OS * M
+    int q;              // (m * D) % M / D of the next output step m
+
+    PFFFT_Setup * fft;
+};
+
+
+void channelizer_destroy_setup(channelizer_setup * s)
+{
+    if (!s)
+        return;
+    pffft_aligned_free(s->hrev);
+    pffft_aligned_free(s->buf);
+    pffft_aligned_free(s->batch);
+    pffft_aligned_free(s->work);
+    pffft_aligned_free(s->idx);
+    pffft_aligned_free(s->tw);
+    if (s->fft)
+        pffft_destroy_setup(s->fft);
+    delete s;
+}
+
+
+channelizer_setup * channelizer_new_setup(int numChannels, int oversampling, const float * prototype, int protoLen)
+{
+    const int M = numChannels;
+    channelizer_setup * s;
+    int k, q;
+
+    if (M < 2 || (oversampling != 1 && oversampling != 2) || (M % oversampling)
+        || !prototype || protoLen <= 0 || !pffft_is_valid_size(M, PFFFT_COMPLEX))
+        return nullptr;
+
+    s = new (std::nothrow) channelizer_setup();
+    if (!s)
+        return nullptr;
+    s->M = M;
+    s->OS = oversampling;
+    s->D = M / oversampling;
+    s->P = (protoLen + M - 1) / M;
+    s->L = s->P * M;
+    // the buffer is shifted after each batch: keep the moved history below half of it
+    s->B = std::max(CHANNELIZER_MIN_BATCH, (2 * s->L + s->D - 1) / s->D);
+
+    s->fft = pffft_new_setup(M, PFFFT_COMPLEX);
+    s->hrev = (float*)pffft_aligned_malloc((size_t)2 * s->L * sizeof(float));
+    s->buf = (complexf*)pffft_aligned_malloc((size_t)(s->L - 1 + s->B * s->D) * sizeof(complexf));
+    s->batch = (float*)pffft_aligned_malloc((size_t)2 * M * s->B * sizeof(float));
+    s->work = (float*)pffft_aligned_malloc((size_t)2 * M * sizeof(float));
+    s->idx = (int*)pffft_aligned_malloc((size_t)2 * M * sizeof(int));
+    s->tw = (complexf*)pffft_aligned_malloc((size_t)s->OS * M * sizeof(complexf));
+    if (!s->fft || !s->hrev || !s->buf || !s->batch || !s->work || !s->idx || !s->tw)
+    {
+        channelizer_destroy_setup(s);
+        return nullptr;
+    }
+
+    for (k = 0; k < s->L; ++k)
+    {
+        const int j = s->L - 1 - k;
+        s->hrev[2 * k] = s->hrev[2 * k + 1] = (j < protoLen) ? prototype[j] : 0.0F;
+    }
+
+    // the unordered layout is a fixed permutation of the floats:
+    // reorder their (exactly representable) indices, to get the positions
+    for (k = 0; k < 2 * M; ++k)
+        s->batch[k] = (float)k;
+    pffft_zreorder(s->fft, s->batch, s->work, PFFFT_FORWARD);
+    for (k = 0; k < 2 * M; ++k)
+        s->idx[k] = (int)s->work[k];
+
+    // the polyphase sum for output step m starts at x[m*D - L + 1]:
+    // its spectrum is multiplied by exp(-2 pi i k (m*D + 1) / M)
+    for (q = 0; q < s->OS; ++q)
+    {
+        for (k = 0; k < M; ++k)
+        {
+            const double phi = -2.0 * M_PI * (double)(((long long)k * (q * s->D + 1)) % M) / M;
+            s->tw[q * M + k].i = (float)cos(phi);
+            s->tw[q * M + k].q = (float)sin(phi);
+        }
+    }
+
+    channelizer_reset(s);
+    return s;
+}
+
+
+void channelizer_reset(channelizer_setup * s)
+{
+    // L - 1 zero samples before the first input: the window of output step 0
+    memset(s->buf, 0, (size_t)(s->L - 1) * sizeof(complexf));
+    s->fill = s->L - 1;
+    s->q = 0;
+}
+
+
+int channelizer_num_channels(const channelizer_setup * s)
+{
+    return s->M;
+}
+
+
+int channelizer_decimation(const channelizer_setup * s)
+{
+    return s->D;
+}
+
+
+int channelizer_max_output_len(const channelizer_setup * s, int inputLen)
+{
+    return (inputLen + s->D - 1) / s->D;
+}
+
+
+/* polyphase FIR: the window times the reversed prototype, summed over the P branches */
+static void polyphase_sum(const channelizer_setup * s, const complexf * window, float * RESTRICT acc)
+{
+    const int Mf = 2 * s->M;
+    const float * RESTRICT x = (const float*)window;
+    const float * RESTRICT h = s->hrev;
+    int p, f;
+
+    for (f = 0; f < Mf; ++f)
+        acc[f] = h[f] * x[f];
+    for (p = 1; p < s->P; ++p)
+    {
+        x += Mf;
+        h += Mf;
+        for (f = 0; f < Mf; ++f)
+            acc[f] += h[f] * x[f];
+    }
+}
+
+
+/* channels of one output step: the permutation of the unordered
+ * spectrum and the phase correction in one pass */
+static void write_channels(const channelizer_setup * s, const float * RESTRICT spec, const complexf * RESTRICT tw,
+                           complexf * RESTRICT y)
+{
+    const int * RESTRICT idx = s->idx;
+    int k;
+    for (k = 0; k < s->M; ++k)
+    {
+        const float re = spec[idx[2 * k]];
+        const float im = spec[idx[2 * k + 1]];
+        y[k].i = re * tw[k].i - im * tw[k].q;
+        y[k].q = re * tw[k].q + im * tw[k].i;
+    }
+}
+
+
+int channelizer_process(channelizer_setup * s, const complexf * input, int inputLen, complexf * output)
+{
+    const int M = s->M, D = s->D, L = s->L;
+    const int capacity = L - 1 + s->B * D;
+    int numOut = 0;
+
+    while (inputLen > 0)
+    {
+        const int n = std::min(inputLen, capacity - s->fill);
+        int count, t;
+
+        memcpy(s->buf + s->fill, input, (size_t)n * sizeof(complexf));
+        s->fill += n;
+        input += n;
+        inputLen -= n;
+
+        // output step t needs the window buf[t*D .. t*D + L)
+        count = (s->fill >= L) ? (s->fill - L) / D + 1 : 0;
+        if (!count)
+            continue;
+
+        for (t = 0; t < count; ++t)
+            polyphase_sum(s, s->buf + t * D, s->batch + 2 * M * t);
+        pffft_transform_batch(s->fft, count, s->batch, 2 * M, s->batch, 2 * M, s->work, PFFFT_FORWARD);
+        for (t = 0; t < count; ++t)
+        {
+            write_channels(s, s->batch + 2 * M * t, s->tw + s->q * M, output + (size_t)numOut * M);
+            s->q = (s->q + 1) % s->OS;
+            ++numOut;
+        }
+
+        s->fill -= count * D;
+        memmove(s->buf, s->buf + count * D, (size_t)s->fill * sizeof(complexf));
+    }
+    return numOut;
+}
+
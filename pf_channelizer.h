@@ -0,0 +1,69 @@
+#pragma once
+
+/* pf_channelizer.h/.cpp implements a polyphase FFT filter bank (channelizer):
+ * the complex wideband input is split into numChannels equally spaced channels,
+ * channel k centered at k * samplerate / numChannels (k >= numChannels/2 are the
+ * negative frequencies), each one decimated by
+ *
+ * - D = numChannels: critically sampled, oversampling = 1
+ * - D = numChannels / 2: 2x oversampled, oversampling = 2 - without aliasing
+ *   in the transition bands of the prototype filter
+ *
+ * per D input samples, there is one polyphase FIR step with the real prototype
+ * low-pass (numChannels branches) and one complex FFT of size numChannels.
+ * the FFTs of several output steps are done with one pffft_transform_batch() call,
+ * in pffft's unordered (internal) layout: the permutation - and the phase
+ * correction of each channel - is applied while writing the output.
+ *
+ * output m of channel k is the continuous (causal) output of mixer, prototype filter
+ * and decimation: with zero input samples before the first call,
+ *   y_k[m] = sum_l ( h[l] * x[m * D - l] * exp(-2 pi i k (m * D - l) / numChannels) )
+ *
+ * all memory is allocated in channelizer_new_setup(): processing is allocation free.
+ */
+
+#include "pf_cplx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct channelizer_setup channelizer_setup;
+
+/* numChannels has to be a native complex transform size, see pffft_is_valid_size(),
+ * of at least 2.
+ * oversampling is 1 or 2. the prototype filter h[] is copied - and padded with
+ * zeros to a multiple of numChannels taps: it's passband should be about
+ * samplerate / (2 * numChannels), with the stopband starting at
+ * samplerate / numChannels - samplerate / (2 * numChannels) with oversampling 1
+ * or samplerate / numChannels * (1 - 1/4) with oversampling 2.
+ * returns NULL for unsuitable parameters.
+ */
+channelizer_setup * channelizer_new_setup(int numChannels, int oversampling, const float * prototype, int protoLen);
+
+void channelizer_destroy_setup(channelizer_setup * s);
+
+/* forget the input history: as if a new setup was just created */
+void channelizer_reset(channelizer_setup * s);
+
+int channelizer_num_channels(const channelizer_setup * s);
+
+/* decimation D: numChannels / oversampling */
+int channelizer_decimation(const channelizer_setup * s);
+
+/* maximum number of output steps for a call with inputLen samples:
+ * the output needs room for numChannels times as many complex samples
+ */
+int channelizer_max_output_len(const channelizer_setup * s, int inputLen);
+
+/* process inputLen complex samples - of any length per call.
+ * output step m receives the numChannels channels at output[m * numChannels + k].
+ * returns the number of output steps.
+ * input and output don't need to be aligned.
+ */
+int channelizer_process(channelizer_setup * s, const complexf * input, int inputLen, complexf * output);
+
+#ifdef __cplusplus
+}
+#endif
+
@@ -40,6 +40,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string.h>
 #include <limits.h>
 
+#ifndef PFFFT_SIMD_DISABLE
+#if (defined(__x86_64__) || defined(_M_X64) || defined(i386) || defined(_M_IX86))
+  #include <emmintrin.h>
+  #define HAVE_SSE2_INTRINSICS 1
+#elif (defined(PFFFT_ENABLE_NEON) || defined(__ARM_NEON))
+  #include <arm_neon.h>
+  #define HAVE_NEON_INTRINSICS 1
+#endif
+#endif
+
 
 /*
    ____ ___ ____   ____  ____   ____
@@ -59,29 +69,52 @@ typedef struct {
     cic_dt ig0a, ig0b, ig1a, ig1b;
     cic_dt comb0a, comb0b, comb1a, comb1b;
     int16_t *sinetable;
+    int inplace;    // from cicddc_init_inplace(): nothing to free
 } cicddc_t;
 
-void *cicddc_init(int factor) {
+#define SINESIZE2  (SINESIZE * 5/4)  // 25% extra to get cosine from the same table
+#define CICDDC_STATE_BYTES  ( (sizeof(cicddc_t) + 63) & ~(size_t)63 )
+
+static void cicddc_init_state(cicddc_t *s, int factor, int16_t *sinetable) {
     int i;
-    int sinesize2 = SINESIZE * 5/4; // 25% extra to get cosine from the same table
-    cicddc_t *s;
-    s = (cicddc_t *)malloc(sizeof(cicddc_t));
     memset(s, 0, sizeof(cicddc_t));
 
     float sineamp = 32767.0f;
     s->factor = factor;
     s->gain = 1.0f / SHRT_MAX / sineamp / factor / factor / factor; // compensate for gain of 3 integrators
 
-    s->sinetable = (int16_t *)malloc(sinesize2 * sizeof(*s->sinetable));
+    s->sinetable = sinetable;
     double f = 2.0 * M_PI / (double)SINESIZE;
-    for(i = 0; i < sinesize2; i++) {
+    for(i = 0; i < SINESIZE2; i++) {
         s->sinetable[i] = sineamp * cos(f * i);
     }
+}
+
+void *cicddc_init(int factor) {
+    cicddc_t *s;
+    s = (cicddc_t *)malloc(sizeof(cicddc_t));
+    cicddc_init_state(s, factor, (int16_t *)malloc(SINESIZE2 * sizeof(*s->sinetable)));
+    return s;
+}
+
+size_t cicddc_state_size(int factor) {
+    (void)factor;
+    return CICDDC_STATE_BYTES + SINESIZE2 * sizeof(int16_t);
+}
+
+void *cicddc_init_inplace(void *mem, int factor) {
+    cicddc_t *s = (cicddc_t *)mem;
+    if (!mem || ((uintptr_t)mem % 64))
+        return NULL;
+    cicddc_init_state(s, factor, (int16_t *)((char *)mem + CICDDC_STATE_BYTES));
+    s->inplace = 1;
     return s;
 }
 
 void cicddc_free(void *state) {
     cicddc_t *s = (cicddc_t *)state;
+    if (s->inplace)
+        return;
     free(s->sinetable);
     free(s);
 }
@@ -253,3 +286,296 @@ void cicddc_cu8_c(void *state, uint8_t *input, complexf *output, int outsize, fl
     s->phase = phase;
 }
 
+
+
+/*
+   ____ ___ ____   ____            _
+  / ___|_ _/ ___| |  _ \  ___  ___(_)_ __ ___
+ | |    | | |     | | | |/ _ \/ __| | '_ ` _ \
+ | |___ | | |___  | |_| |  __/ (__| | | | | | |
+  \____|___\____| |____/ \___|\___|_|_| |_| |_|
+*/
+
+#define CIC_CHUNK_LEN  256  // input frames converted into the lane buffer at once
+
+typedef void (*cic_run_fn)(cic_decim_setup *s, int numFrames, float *output, int outOffset);
+
+struct cic_decim_setup {
+    int C;          // number of interleaved channels
+    int N;          // order
+    int R;          // decimation
+    int M;          // differential delay
+    int lanes;      // C rounded up to a multiple of the vector lanes
+    int wide;       // 64 bit integrators
+    int cnt;        // input frames until the next output
+    int ring;       // position in the comb delay lines
+    float gain;
+    void *ig;       // N * lanes integrators
+    void *comb;     // N * M * lanes comb delays
+    void *buf;      // CIC_CHUNK_LEN * C converted input samples - and room for a lane group
+    cic_run_fn run;
+};
+
+
+/* lane types: unsigned for the wrap around of the integrators */
+
+template <class T> struct signed_of;
+template <> struct signed_of<uint32_t> { typedef int32_t type; };
+template <> struct signed_of<uint64_t> { typedef int64_t type; };
+
+template <class T>
+struct cic_vec_scalar {
+    typedef T value_type;
+    typedef typename signed_of<T>::type signed_type;
+    typedef T v;
+    enum { LANES = 1 };
+    static inline v load(const T *p) { return *p; }
+    static inline void store(T *p, v a) { *p = a; }
+    static inline v add(v a, v b) { return a + b; }
+    static inline v sub(v a, v b) { return a - b; }
+};
+
+#if defined(HAVE_SSE2_INTRINSICS)
+
+struct cic_vec_32 {
+    typedef uint32_t value_type;
+    typedef int32_t signed_type;
+    typedef __m128i v;
+    enum { LANES = 4 };
+    static inline v load(const uint32_t *p) { return _mm_loadu_si128((const __m128i *)p); }
+    static inline void store(uint32_t *p, v a) { _mm_storeu_si128((__m128i *)p, a); }
+    static inline v add(v a, v b) { return _mm_add_epi32(a, b); }
+    static inline v sub(v a, v b) { return _mm_sub_epi32(a, b); }
+};
+
+struct cic_vec_64 {
+    typedef uint64_t value_type;
+    typedef int64_t signed_type;
+    typedef __m128i v;
+    enum { LANES = 2 };
+    static inline v load(const uint64_t *p) { return _mm_loadu_si128((const __m128i *)p); }
+    static inline void store(uint64_t *p, v a) { _mm_storeu_si128((__m128i *)p, a); }
+    static inline v add(v a, v b) { return _mm_add_epi64(a, b); }
+    static inline v sub(v a, v b) { return _mm_sub_epi64(a, b); }
+};
+
+#elif defined(HAVE_NEON_INTRINSICS)
+
+struct cic_vec_32 {
+    typedef uint32_t value_type;
+    typedef int32_t signed_type;
+    typedef uint32x4_t v;
+    enum { LANES = 4 };
+    static inline v load(const uint32_t *p) { return vld1q_u32(p); }
+    static inline void store(uint32_t *p, v a) { vst1q_u32(p, a); }
+    static inline v add(v a, v b) { return vaddq_u32(a, b); }
+    static inline v sub(v a, v b) { return vsubq_u32(a, b); }
+};
+
+struct cic_vec_64 {
+    typedef uint64_t value_type;
+    typedef int64_t signed_type;
+    typedef uint64x2_t v;
+    enum { LANES = 2 };
+    static inline v load(const uint64_t *p) { return vld1q_u64(p); }
+    static inline void store(uint64_t *p, v a) { vst1q_u64(p, a); }
+    static inline v add(v a, v b) { return vaddq_u64(a, b); }
+    static inline v sub(v a, v b) { return vsubq_u64(a, b); }
+};
+
+#else
+
+typedef cic_vec_scalar<uint32_t> cic_vec_32;
+typedef cic_vec_scalar<uint64_t> cic_vec_64;
+
+#endif
+
+
+/* integrators and combs for numFrames frames in s->buf.
+ * each group of lanes runs through all the frames with the integrators in registers.
+ * a group might read into the next frame: those lanes are padding, their output is dropped.
+ * the integrators are updated from the last to the first stage, with the values of the
+ * previous frame: they don't wait for each other - but the last one is N-1 frames late.
+ * at each output, it catches up with zero input: (N-1)*N/2 additions at the decimated rate.
+ */
+template <class V, int N>
+static void cic_run(cic_decim_setup *s, int numFrames, float *output, int outOffset)
+{
+    typedef typename V::value_type T;
+    typedef typename V::v vec;
+    typedef typename V::signed_type S;
+    const int L = s->lanes, C = s->C, R = s->R, M = s->M;
+    const float gain = s->gain;
+    T *ig = (T *)s->ig;
+    T *comb = (T *)s->comb;
+    const T *buf = (const T *)s->buf;
+    int g, n, k, j;
+
+    for (g = 0; g < L; g += V::LANES) {
+        vec acc[N];
+        int cnt = s->cnt, ring = s->ring, m = outOffset;
+        for (k = 0; k < N; ++k)
+            acc[k] = V::load(ig + k * L + g);
+
+        for (n = 0; n < numFrames; ++n) {
+            for (k = N - 1; k > 0; --k)
+                acc[k] = V::add(acc[k], acc[k - 1]);
+            acc[0] = V::add(acc[0], V::load(buf + n * C + g));
+            if (--cnt)
+                continue;
+
+            // comb filters at the decimated rate
+            cnt = R;
+            vec t[N];
+            for (k = 0; k < N; ++k)
+                t[k] = acc[k];
+            for (j = 1; j < N; ++j)
+                for (k = N - 1; k >= j; --k)
+                    t[k] = V::add(t[k], t[k - 1]);
+            vec y = t[N - 1];
+            for (k = 0; k < N; ++k) {
+                T *d = comb + (k * M + ring) * L + g;
+                const vec delayed = V::load(d);
+                V::store(d, y);
+                y = V::sub(y, delayed);
+            }
+            if (++ring == M)
+                ring = 0;
+
+            T out[V::LANES];
+            V::store(out, y);
+            for (j = 0; j < V::LANES && g + j < C; ++j)
+                output[m * C + g + j] = (float)(S)out[j] * gain;
+            ++m;
+        }
+
+        for (k = 0; k < N; ++k)
+            V::store(ig + k * L + g, acc[k]);
+        if (g + V::LANES >= L) {
+            s->cnt = cnt;
+            s->ring = ring;
+        }
+    }
+}
+
+
+template <class V>
+static cic_run_fn cic_select_run(int order)
+{
+    switch (order) {
+    case 1: return cic_run<V, 1>;
+    case 2: return cic_run<V, 2>;
+    case 3: return cic_run<V, 3>;
+    case 4: return cic_run<V, 4>;
+    case 5: return cic_run<V, 5>;
+    case 6: return cic_run<V, 6>;
+    case 7: return cic_run<V, 7>;
+    case 8: return cic_run<V, 8>;
+    default: return NULL;
+    }
+}
+
+
+cic_decim_setup * cic_decim_new_setup(int numChannels, int order, int decimation, int diffDelay) {
+    cic_decim_setup *s;
+    int vlanes;
+    size_t tsize;
+
+    if (numChannels <= 0 || order <= 0 || order > PF_CIC_MAX_ORDER || decimation <= 0 || diffDelay <= 0)
+        return NULL;
+    // register width for the output: Hogenauer
+    const double bits = 16.0 + ceil(order * log2((double)decimation * diffDelay) - 1E-9);
+    if (bits > 64.0)
+        return NULL;
+
+    s = (cic_decim_setup *)calloc(1, sizeof(cic_decim_setup));
+    if (!s)
+        return NULL;
+    s->C = numChannels;
+    s->N = order;
+    s->R = decimation;
+    s->M = diffDelay;
+    s->wide = (bits > 32.0) ? 1 : 0;
+    s->gain = (float)(1.0 / (pow((double)decimation * diffDelay, order) * 32768.0));
+    if (s->wide) {
+        vlanes = cic_vec_64::LANES;
+        tsize = sizeof(uint64_t);
+        s->run = cic_select_run<cic_vec_64>(order);
+    } else {
+        vlanes = cic_vec_32::LANES;
+        tsize = sizeof(uint32_t);
+        s->run = cic_select_run<cic_vec_32>(order);
+    }
+    s->lanes = ((numChannels + vlanes - 1) / vlanes) * vlanes;
+    s->ig = calloc((size_t)order * s->lanes, tsize);
+    s->comb = calloc((size_t)order * diffDelay * s->lanes, tsize);
+    s->buf = calloc((size_t)CIC_CHUNK_LEN * numChannels + vlanes, tsize);
+    if (!s->ig || !s->comb || !s->buf) {
+        cic_decim_destroy_setup(s);
+        return NULL;
+    }
+    cic_decim_reset(s);
+    return s;
+}
+
+void cic_decim_destroy_setup(cic_decim_setup *s) {
+    if (!s)
+        return;
+    free(s->ig);
+    free(s->comb);
+    free(s->buf);
+    free(s);
+}
+
+void cic_decim_reset(cic_decim_setup *s) {
+    const size_t tsize = s->wide ? sizeof(uint64_t) : sizeof(uint32_t);
+    memset(s->ig, 0, (size_t)s->N * s->lanes * tsize);
+    memset(s->comb, 0, (size_t)s->N * s->M * s->lanes * tsize);
+    // first output after frame 0
+    s->cnt = 1;
+    s->ring = 0;
+}
+
+int cic_decim_max_output_len(const cic_decim_setup *s, int inputLen) {
+    return (inputLen + s->R - 1) / s->R + 1;
+}
+
+int cic_decim_wide(const cic_decim_setup *s) {
+    return s->wide;
+}
+
+
+template <class T, class IN, int OFFSET, int SHIFT>
+static void cic_convert(cic_decim_setup *s, const IN *input, int numFrames) {
+    T *buf = (T *)s->buf;
+    const int len = numFrames * s->C;
+    int k;
+    for (k = 0; k < len; ++k)
+        buf[k] = (T)(int32_t)( ((int32_t)input[k] * (1 << SHIFT)) - OFFSET );
+}
+
+template <class IN, int OFFSET, int SHIFT>
+static int cic_decim_process(cic_decim_setup *s, const IN *input, int inputLen, float *output) {
+    int off, numOut = 0;
+    for (off = 0; off < inputLen; off += CIC_CHUNK_LEN) {
+        const int n = (inputLen - off < CIC_CHUNK_LEN) ? (inputLen - off) : CIC_CHUNK_LEN;
+        // outputs of this chunk - as counted in cic_run()
+        const int chunkOut = (n >= s->cnt) ? (1 + (n - s->cnt) / s->R) : 0;
+        if (s->wide)
+            cic_convert<uint64_t, IN, OFFSET, SHIFT>(s, input + off * s->C, n);
+        else
+            cic_convert<uint32_t, IN, OFFSET, SHIFT>(s, input + off * s->C, n);
+        s->run(s, n, output, numOut);
+        numOut += chunkOut;
+    }
+    return numOut;
+}
+
+int cic_decim_s16(cic_decim_setup *s, const int16_t *input, int inputLen, float *output) {
+    return cic_decim_process<int16_t, 0, 0>(s, input, inputLen, output);
+}
+
+int cic_decim_u8(cic_decim_setup *s, const uint8_t *input, int inputLen, float *output) {
+    // subtract 127.4 - as cicddc_cu8_c()
+    return cic_decim_process<uint8_t, 32614, 8>(s, input, inputLen, output);
+}
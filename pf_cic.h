@@ -30,7 +30,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include "pf_cplx.h"
+
 #include <stdint.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -44,14 +47,69 @@ extern "C" {
   \____|___\____| |____/|____/ \____|
 */
 
-typedef struct complexf_s { float i; float q; } complexf;
-
 void *cicddc_init(int factor);
 void cicddc_free(void *state);
+
+/* prepare the state - as cicddc_init() - in caller provided memory of
+ * cicddc_state_size() bytes, 64-byte aligned. returns NULL for unaligned mem.
+ * cicddc_free() frees nothing for this state.
+ */
+size_t cicddc_state_size(int factor);
+void *cicddc_init_inplace(void *mem, int factor);
 void cicddc_s16_c(void *state, int16_t *input, complexf *output, int outsize, float rate);
 void cicddc_cs16_c(void *state, int16_t *input, complexf *output, int outsize, float rate);
 void cicddc_cu8_c(void *state, uint8_t *input, complexf *output, int outsize, float rate);
 
+
+/*
+   ____ ___ ____   ____            _
+  / ___|_ _/ ___| |  _ \  ___  ___(_)_ __ ___
+ | |    | | |     | | | |/ _ \/ __| | '_ ` _ \
+ | |___ | | |___  | |_| |  __/ (__| | | | | | |
+  \____|___\____| |____/ \___|\___|_|_| |_| |_|
+*/
+
+/* CIC decimator with order N (number of integrator and comb stages),
+ * decimation R and differential delay M - without a mixer.
+ * the input has numChannels interleaved channels: 1 for real samples,
+ * 2 for I/Q - or several receivers/antennas, each a real or complex channel.
+ * the channels are processed in the SIMD lanes: SSE2 or NEON, 4 lanes with
+ * 32 bit integrators or 2 lanes with 64 bit integrators. the narrower type is used
+ * when the bit growth 16 + ceil(N * log2(R * M)) fits (Hogenauer): the
+ * integrators wrap around, the combs deliver the exact result.
+ * the output is normalized to the gain (R*M)^N and to 1.0 for full scale input:
+ *   y[m] = sum_k ( h[k] * x[m * R - k] ) / ( (R*M)^N * 32768 )
+ * with h = the N-fold convolution of R*M ones - and zeros before the first input sample.
+ */
+
+#define PF_CIC_MAX_ORDER  8
+
+typedef struct cic_decim_setup cic_decim_setup;
+
+/* returns NULL for unsuitable parameters: also when the bit growth exceeds 64 bits */
+cic_decim_setup * cic_decim_new_setup(int numChannels, int order, int decimation, int diffDelay);
+void cic_decim_destroy_setup(cic_decim_setup * s);
+
+/* forget the input history: as if a new setup was just created */
+void cic_decim_reset(cic_decim_setup * s);
+
+/* maximum number of output frames for inputLen input frames */
+int cic_decim_max_output_len(const cic_decim_setup * s, int inputLen);
+
+/* 1 with 64 bit integrators, 0 with 32 bit */
+int cic_decim_wide(const cic_decim_setup * s);
+
+/* decimate inputLen frames of numChannels interleaved samples - of any length per call.
+ * output receives the returned number of frames, each with numChannels floats.
+ * for numChannels = 2 the in- and output are interleaved I/Q: output can be a complexf array.
+ */
+int cic_decim_s16(cic_decim_setup * s, const int16_t * input, int inputLen, float * output);
+
+/* same for unsigned 8 bit samples: the offset 127.4 (good for rtl-sdr) is removed,
+ * the scaling is as for 16 bit samples
+ */
+int cic_decim_u8(cic_decim_setup * s, const uint8_t * input, int inputLen, float * output);
+
 #ifdef __cplusplus
 }
 #endif
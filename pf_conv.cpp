@@ -129,6 +129,32 @@ int ARCHFUNCNAME(conv_float_oop)(
 }
 
 
+int ARCHFUNCNAME(conv_float_sym_oop)(
+        const float * RESTRICT s, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter,
+        float * RESTRICT y
+        )
+{
+    const int off0 = state->offset;
+    const int sz_s = state->size;
+    const int half = sz_filter / 2;
+    int offset;
+
+    for ( offset = off0; offset + sz_filter <= sz_s; ++offset)
+    {
+        const float * RESTRICT a = &s[offset];
+        const float * RESTRICT b = &s[offset + sz_filter - 1];
+        float accu = (sz_filter & 1) ? a[half] * filter[half] : 0.0F;
+        for (int k = 0; k < half; ++k)
+            accu += (a[k] + b[-k]) * filter[k];
+        y[offset] = accu;
+    }
+
+    state->offset = offset;
+    return offset - off0;
+}
+
+
 int ARCHFUNCNAME(conv_cplx_float_oop)(
         const complexf * RESTRICT s_cplx, conv_buffer_state * RESTRICT state,
         const float * RESTRICT filter, const int sz_filter,
@@ -146,8 +172,8 @@ int ARCHFUNCNAME(conv_cplx_float_oop)(
         float accu_im = 0.0F;
         for (int k = 0; k < sz_filter; ++k)
         {
-            accu_re = s_cplx[offset+k].i * filter[k];   // accu += rS * rH;
-            accu_im = s_cplx[offset+k].q * filter[k];   // accu += rS * rH;
+            accu_re += s_cplx[offset+k].i * filter[k];  // accu += rS * rH;
+            accu_im += s_cplx[offset+k].q * filter[k];  // accu += rS * rH;
         }
         y_cplx[offset].i = accu_re;  // == hadd() == sum of real parts
         y_cplx[offset].q = accu_im;  // == hadd() == sum of imag parts
@@ -158,6 +184,117 @@ int ARCHFUNCNAME(conv_cplx_float_oop)(
 }
 
 
+int ARCHFUNCNAME(conv_float_decim_oop)(
+        const float * RESTRICT s, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter, const int decim,
+        float * RESTRICT y
+        )
+{
+    const int off0 = state->offset;
+    const int sz_s = state->size;
+    int offset;
+
+    for ( offset = off0; offset + sz_filter <= sz_s; offset += decim)
+    {
+        float accu = 0.0F;
+        for (int k = 0; k < sz_filter; ++k)
+            accu += s[offset+k] * filter[k];
+        y[offset / decim] = accu;
+    }
+
+    state->offset = offset;
+    return (offset - off0) / decim;
+}
+
+
+int ARCHFUNCNAME(conv_cplx_float_decim_oop)(
+        const complexf * RESTRICT s_cplx, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter, const int decim,
+        complexf * RESTRICT y_cplx
+        )
+{
+    const int off0 = state->offset;
+    const int sz_s = state->size;
+    int offset;
+
+    for ( offset = off0; offset + sz_filter <= sz_s; offset += decim)
+    {
+        float accu_re = 0.0F;
+        float accu_im = 0.0F;
+        for (int k = 0; k < sz_filter; ++k)
+        {
+            accu_re += s_cplx[offset+k].i * filter[k];
+            accu_im += s_cplx[offset+k].q * filter[k];
+        }
+        y_cplx[offset / decim].i = accu_re;
+        y_cplx[offset / decim].q = accu_im;
+    }
+
+    state->offset = offset;
+    return (offset - off0) / decim;
+}
+
+
+int ARCHFUNCNAME(conv_float_interp_oop)(
+        const float * RESTRICT s, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter, const int interp,
+        float * RESTRICT y
+        )
+{
+    const int off0 = state->offset;
+    const int sz_s = state->size;
+    const int sz_w = (sz_filter + interp - 2) / interp + 1;   // input samples per offset
+    int offset;
+
+    for ( offset = off0; offset + sz_w <= sz_s; ++offset)
+    {
+        for (int p = 0; p < interp; ++p)
+        {
+            // filter phase p: filter[j * interp - p]
+            float accu = 0.0F;
+            for (int j = (p ? 1 : 0), k = j * interp - p; k < sz_filter; ++j, k += interp)
+                accu += s[offset+j] * filter[k];
+            y[offset * interp + p] = accu;
+        }
+    }
+
+    state->offset = offset;
+    return offset - off0;
+}
+
+
+int ARCHFUNCNAME(conv_cplx_float_interp_oop)(
+        const complexf * RESTRICT s_cplx, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter, const int interp,
+        complexf * RESTRICT y_cplx
+        )
+{
+    const int off0 = state->offset;
+    const int sz_s = state->size;
+    const int sz_w = (sz_filter + interp - 2) / interp + 1;   // input samples per offset
+    int offset;
+
+    for ( offset = off0; offset + sz_w <= sz_s; ++offset)
+    {
+        for (int p = 0; p < interp; ++p)
+        {
+            float accu_re = 0.0F;
+            float accu_im = 0.0F;
+            for (int j = (p ? 1 : 0), k = j * interp - p; k < sz_filter; ++j, k += interp)
+            {
+                accu_re += s_cplx[offset+j].i * filter[k];
+                accu_im += s_cplx[offset+j].q * filter[k];
+            }
+            y_cplx[offset * interp + p].i = accu_re;
+            y_cplx[offset * interp + p].q = accu_im;
+        }
+    }
+
+    state->offset = offset;
+    return offset - off0;
+}
+
+
 #elif defined(HAVE_MIPP)
 
 
@@ -220,6 +357,55 @@ int ARCHFUNCNAME(conv_float_oop)(
 }
 
 
+int ARCHFUNCNAME(conv_float_sym_oop)(
+        const float * RESTRICT s, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter,
+        float * RESTRICT y
+        )
+{
+    // vectorized over mipp::N<float>() outputs: the folded pairs are loaded
+    // in forward direction - no reversal of registers - and filter[k] is broadcasted
+    mipp::Reg<float> accu, rA, rB;
+    const int off0 = state->offset;
+    const int sz_s = state->size;
+    const int half = sz_filter / 2;
+    int offset;
+
+    for ( offset = off0; offset + sz_filter + mipp::N<float>() - 1 <= sz_s; offset += mipp::N<float>())
+    {
+        const float * RESTRICT a = &s[offset];
+        const float * RESTRICT b = &s[offset + sz_filter - 1];
+        if (sz_filter & 1)
+        {
+            rA.loadu(&a[half]);
+            accu = rA * mipp::Reg<float>(filter[half]);
+        }
+        else
+            accu.set0();
+        for (int k = 0; k < half; ++k)
+        {
+            rA.loadu(&a[k]);
+            rB.loadu(&b[-k]);
+            accu = mipp::fmadd(rA + rB, mipp::Reg<float>(filter[k]), accu);   // accu += (rA + rB) * H
+        }
+        accu.storeu(&y[offset]);
+    }
+
+    for ( ; offset + sz_filter <= sz_s; ++offset)
+    {
+        const float * RESTRICT a = &s[offset];
+        const float * RESTRICT b = &s[offset + sz_filter - 1];
+        float sum = (sz_filter & 1) ? a[half] * filter[half] : 0.0F;
+        for (int k = 0; k < half; ++k)
+            sum += (a[k] + b[-k]) * filter[k];
+        y[offset] = sum;
+    }
+
+    state->offset = offset;
+    return offset - off0;
+}
+
+
 int ARCHFUNCNAME(conv_cplx_float_oop)(
         const complexf * RESTRICT s_cplx, conv_buffer_state * RESTRICT state,
         const float * RESTRICT filter, const int sz_filter,
@@ -258,6 +444,179 @@ int ARCHFUNCNAME(conv_cplx_float_oop)(
     return (offset - off0) / 2;
 }
 
+
+int ARCHFUNCNAME(conv_float_decim_oop)(
+        const float * RESTRICT s, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter, const int decim,
+        float * RESTRICT y
+        )
+{
+    assert( (sz_filter % mipp::N<float>()) == 0 );  // size of filter must be divisible by conv_float_simd_size()
+
+    mipp::Reg<float> accu, rS, rH;
+    const int off0 = state->offset;
+    const int sz_s = state->size;
+    int offset;
+
+    for ( offset = off0; offset + sz_filter <= sz_s; offset += decim)
+    {
+        accu.set0();
+        for (int k = 0; k < sz_filter; k += mipp::N<float>())
+        {
+            rS.loadu(&s[offset+k]);
+            rH.load(&filter[k]);
+            accu = mipp::fmadd(rS, rH, accu);   // accu += rS * rH;
+        }
+        y[offset / decim] = accu.sum();    // == hadd()
+    }
+
+    state->offset = offset;
+    return (offset - off0) / decim;
+}
+
+
+int ARCHFUNCNAME(conv_cplx_float_decim_oop)(
+        const complexf * RESTRICT s_cplx, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter, const int decim,
+        complexf * RESTRICT y_cplx
+        )
+{
+    assert( (sz_filter % mipp::N<float>()) == 0 );  // size of filter must be divisible by conv_float_simd_size()
+    const float * RESTRICT s = &(s_cplx[0].i);
+
+    mipp::Regx2<float> accu_x2, rS_x2, H_x2;
+    const int off0 = state->offset;
+    const int sz_s = state->size;
+    int offset;
+
+    for ( offset = off0; offset + sz_filter <= sz_s; offset += decim)
+    {
+        accu_x2.val[0].set0();
+        accu_x2.val[1].set0();
+        for (int k = 0; k < sz_filter; k += mipp::N<float>())
+        {
+            mipp::Reg<float> rH;
+            rS_x2.loadu(&s[2*(offset+k)]);
+            rH.load(&filter[k]);
+            H_x2 = mipp::interleave<float>(rH, rH);
+            accu_x2.val[0] = mipp::fmadd(rS_x2.val[0], H_x2.val[0], accu_x2.val[0]);   // accu += rS * rH;
+            accu_x2.val[1] = mipp::fmadd(rS_x2.val[1], H_x2.val[1], accu_x2.val[1]);   // accu += rS * rH;
+        }
+        H_x2 = mipp::deinterleave(accu_x2);
+        y_cplx[offset / decim].i = H_x2.val[0].sum();  // == hadd() == sum of real parts
+        y_cplx[offset / decim].q = H_x2.val[1].sum();  // == hadd() == sum of imag parts
+    }
+
+    state->offset = offset;
+    return (offset - off0) / decim;
+}
+
+
+int ARCHFUNCNAME(conv_float_interp_oop)(
+        const float * RESTRICT s, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter, const int interp,
+        float * RESTRICT y
+        )
+{
+    // vectorized over mipp::N<float>() input offsets - per filter phase:
+    // filter[j * interp - p] is broadcasted, the outputs are scattered with stride interp
+    constexpr int N = mipp::N<float>();
+    alignas(64) float tmp[N];
+    mipp::Reg<float> accu, rS;
+    const int off0 = state->offset;
+    const int sz_s = state->size;
+    const int sz_w = (sz_filter + interp - 2) / interp + 1;   // input samples per offset
+    int offset;
+
+    for ( offset = off0; offset + sz_w + N - 1 <= sz_s; offset += N)
+    {
+        for (int p = 0; p < interp; ++p)
+        {
+            accu.set0();
+            for (int j = (p ? 1 : 0), k = j * interp - p; k < sz_filter; ++j, k += interp)
+            {
+                rS.loadu(&s[offset+j]);
+                accu = mipp::fmadd(rS, mipp::Reg<float>(filter[k]), accu);   // accu += rS * H
+            }
+            accu.store(tmp);
+            for (int i = 0; i < N; ++i)
+                y[(offset + i) * interp + p] = tmp[i];
+        }
+    }
+
+    for ( ; offset + sz_w <= sz_s; ++offset)
+    {
+        for (int p = 0; p < interp; ++p)
+        {
+            float sum = 0.0F;
+            for (int j = (p ? 1 : 0), k = j * interp - p; k < sz_filter; ++j, k += interp)
+                sum += s[offset+j] * filter[k];
+            y[offset * interp + p] = sum;
+        }
+    }
+
+    state->offset = offset;
+    return offset - off0;
+}
+
+
+int ARCHFUNCNAME(conv_cplx_float_interp_oop)(
+        const complexf * RESTRICT s_cplx, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter, const int interp,
+        complexf * RESTRICT y_cplx
+        )
+{
+    // vectorized over mipp::N<float>() / 2 complex input offsets, as the real version:
+    // the interleaved re/im parts are multiplied with the same coefficient
+    constexpr int N = mipp::N<float>();
+    constexpr int NC = (N >= 2) ? N / 2 : 1;
+    alignas(64) float tmp[2 * NC];
+    const float * RESTRICT s = &(s_cplx[0].i);
+    mipp::Reg<float> accu, rS;
+    const int off0 = state->offset;
+    const int sz_s = state->size;
+    const int sz_w = (sz_filter + interp - 2) / interp + 1;   // input samples per offset
+    int offset = off0;
+
+    for ( ; N >= 2 && offset + sz_w + NC - 1 <= sz_s; offset += NC)
+    {
+        for (int p = 0; p < interp; ++p)
+        {
+            accu.set0();
+            for (int j = (p ? 1 : 0), k = j * interp - p; k < sz_filter; ++j, k += interp)
+            {
+                rS.loadu(&s[2*(offset+j)]);
+                accu = mipp::fmadd(rS, mipp::Reg<float>(filter[k]), accu);   // accu += rS * H
+            }
+            accu.store(tmp);
+            for (int i = 0; i < NC; ++i)
+            {
+                y_cplx[(offset + i) * interp + p].i = tmp[2*i];
+                y_cplx[(offset + i) * interp + p].q = tmp[2*i+1];
+            }
+        }
+    }
+
+    for ( ; offset + sz_w <= sz_s; ++offset)
+    {
+        for (int p = 0; p < interp; ++p)
+        {
+            float sum_re = 0.0F;
+            float sum_im = 0.0F;
+            for (int j = (p ? 1 : 0), k = j * interp - p; k < sz_filter; ++j, k += interp)
+            {
+                sum_re += s_cplx[offset+j].i * filter[k];
+                sum_im += s_cplx[offset+j].q * filter[k];
+            }
+            y_cplx[offset * interp + p].i = sum_re;
+            y_cplx[offset * interp + p].q = sum_im;
+        }
+    }
+
+    state->offset = offset;
+    return offset - off0;
+}
+
 #endif
 
 
@@ -279,12 +638,26 @@ static const conv_f_ptrs conv_ptrs =
     ARCHFUNCNAME(conv_float_oop),
 
     ARCHFUNCNAME(conv_cplx_move_rest),
-    ARCHFUNCNAME(conv_cplx_float_oop)
+    ARCHFUNCNAME(conv_cplx_float_oop),
+
+    ARCHFUNCNAME(conv_float_sym_oop),
+
+    ARCHFUNCNAME(conv_float_decim_oop),
+    ARCHFUNCNAME(conv_cplx_float_decim_oop),
+    ARCHFUNCNAME(conv_float_interp_oop),
+    ARCHFUNCNAME(conv_cplx_float_interp_oop)
 #else
     nullptr,
     nullptr,
     nullptr,
 
+    nullptr,
+    nullptr,
+
+    nullptr,
+
+    nullptr,
+    nullptr,
     nullptr,
     nullptr
 #endif
@@ -57,12 +57,59 @@ typedef int  (*f_conv_float_oop)(
         float * RESTRICT y
         );
 
+// for symmetric (linear-phase) filters: filter[k] == filter[sz_filter-1-k]
+// the input pairs are folded: half of the multiplications.
+// only the first (sz_filter+1)/2 coefficients are read.
+// there are no requirements on sz_filter or the alignment
+typedef int  (*f_conv_float_sym_oop)(
+        const float * RESTRICT s, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter,
+        float * RESTRICT y
+        );
+
 typedef int  (*f_conv_cplx_float_oop)(
         const complexf * RESTRICT s, conv_buffer_state * RESTRICT state,
         const float * RESTRICT filter, const int sz_filter,
         complexf * RESTRICT y
         );
 
+// polyphase decimation by 'decim': only every decim'th output of
+// conv_float_oop() / conv_cplx_float_oop() is computed.
+// state->offset advances by decim per output, move_rest() keeps the phase.
+// y is indexed with state->offset / decim:
+//   y[offset / decim] = sum_k ( s[offset + k] * filter[k] )
+// sz_filter has the same requirement as for conv_float_oop()
+typedef int  (*f_conv_float_decim_oop)(
+        const float * RESTRICT s, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter, const int decim,
+        float * RESTRICT y
+        );
+
+typedef int  (*f_conv_cplx_float_decim_oop)(
+        const complexf * RESTRICT s, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter, const int decim,
+        complexf * RESTRICT y
+        );
+
+// polyphase interpolation by 'interp': conv_float_oop() on the input with
+// interp-1 zeros inserted after each sample - without the multiplications with zero.
+// each input offset delivers interp outputs, it needs the input samples
+// s[offset .. offset + (sz_filter + interp - 2) / interp]:
+//   y[offset * interp + p] = sum_j ( s[offset + j] * filter[j * interp - p] ),  0 <= p < interp
+// there are no requirements on sz_filter or the alignment.
+// returns the number of consumed input samples: the output is interp times longer
+typedef int  (*f_conv_float_interp_oop)(
+        const float * RESTRICT s, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter, const int interp,
+        float * RESTRICT y
+        );
+
+typedef int  (*f_conv_cplx_float_interp_oop)(
+        const complexf * RESTRICT s, conv_buffer_state * RESTRICT state,
+        const float * RESTRICT filter, const int sz_filter, const int interp,
+        complexf * RESTRICT y
+        );
+
 
 // struct with the provided function pointers
 struct conv_f_ptrs
@@ -78,6 +125,13 @@ struct conv_f_ptrs
 
     f_conv_cplx_move_rest   fp_conv_cplx_move_rest;
     f_conv_cplx_float_oop   fp_conv_cplx_float_oop;
+
+    f_conv_float_sym_oop    fp_conv_float_sym_oop;
+
+    f_conv_float_decim_oop        fp_conv_float_decim_oop;
+    f_conv_cplx_float_decim_oop   fp_conv_cplx_float_decim_oop;
+    f_conv_float_interp_oop       fp_conv_float_interp_oop;
+    f_conv_cplx_float_interp_oop  fp_conv_cplx_float_interp_oop;
 };
 
 typedef const conv_f_ptrs * ptr_to_conv_f_ptrs;
@@ -1,6 +1,27 @@
 
 #include "pf_conv_dispatcher.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#if defined(CONV_ARCH_GCC_AMD64) || defined(CONV_ARCH_MSVC_AMD64)
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#elif defined(CONV_ARCH_GCC_ARM32NEON) && defined(__linux__)
+#  include <sys/auxv.h>
+#  ifndef HWCAP_NEON
+#    define HWCAP_NEON   (1 << 12)
+#  endif
+#  ifndef HWCAP_VFPv4
+#    define HWCAP_VFPv4  (1 << 16)
+#  endif
+#endif
+
 #if 0
 #include <stdio.h>
 
@@ -15,6 +36,102 @@
 // 0 is "none"
 // 1 "dflt"
 
+
+#if defined(CONV_ARCH_GCC_AMD64) || defined(CONV_ARCH_MSVC_AMD64)
+
+static void conv_cpuid(unsigned leaf, unsigned subleaf, unsigned r[4])
+{
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuidex(regs, (int)leaf, (int)subleaf);
+    r[0] = regs[0]; r[1] = regs[1]; r[2] = regs[2]; r[3] = regs[3];
+#else
+    __cpuid_count(leaf, subleaf, r[0], r[1], r[2], r[3]);
+#endif
+}
+
+static unsigned conv_xgetbv()
+{
+#if defined(_MSC_VER)
+    return (unsigned)_xgetbv(0);
+#else
+    unsigned eax, edx;
+    __asm__ __volatile__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return eax;
+#endif
+}
+
+// does the CPU support the instruction sets, the compiler may use with
+// the -march / /arch options of the architecture id - see CMakeLists.txt?
+static bool conv_arch_cpu_supports(const char * id)
+{
+    unsigned r[4], max_leaf, ecx1, edx1, ebx7 = 0, ecx81 = 0;
+    conv_cpuid(0, 0, r);
+    max_leaf = r[0];
+    if (max_leaf < 1)
+        return false;
+    conv_cpuid(1, 0, r);
+    ecx1 = r[2];
+    edx1 = r[3];
+    if (max_leaf >= 7)
+    {
+        conv_cpuid(7, 0, r);
+        ebx7 = r[1];
+    }
+    conv_cpuid(0x80000000U, 0, r);
+    if (r[0] >= 0x80000001U)
+    {
+        conv_cpuid(0x80000001U, 0, r);
+        ecx81 = r[2];
+    }
+
+    const bool sse2 = (edx1 & (1U << 26)) != 0;
+    const bool sse3 = sse2 && (ecx1 & (1U << 0)) && (ecx1 & (1U << 9));      // SSE3, SSSE3: core2
+    const bool sse4 = sse3 && (ecx1 & (1U << 19)) && (ecx1 & (1U << 20))     // SSE4.1, SSE4.2, POPCNT: nehalem
+                      && (ecx1 & (1U << 23));
+    // AVX needs the operating system to save the YMM registers: OSXSAVE and XCR0
+    const bool avx = sse4 && (ecx1 & (1U << 27)) && (ecx1 & (1U << 28))
+                     && (conv_xgetbv() & 0x06) == 0x06;
+    // haswell: AVX2, FMA, F16C, MOVBE, BMI1, BMI2, LZCNT
+    const bool avx2 = avx && (ebx7 & (1U << 5)) && (ecx1 & (1U << 12)) && (ecx1 & (1U << 29))
+                      && (ecx1 & (1U << 22)) && (ebx7 & (1U << 3)) && (ebx7 & (1U << 8))
+                      && (ecx81 & (1U << 5));
+
+    if (!strcmp(id, "sse2"))
+        return sse2;
+    if (!strcmp(id, "sse3"))
+        return sse3;
+    if (!strcmp(id, "sse4"))
+        return sse4;
+    if (!strcmp(id, "avx"))
+        return avx;
+    if (!strcmp(id, "avx2"))
+        return avx2;
+    return true;
+}
+
+#elif defined(CONV_ARCH_GCC_ARM32NEON) && defined(__linux__)
+
+static bool conv_arch_cpu_supports(const char * id)
+{
+    // all of neon_vfpv4, neon_rpi3_a53 and neon_rpi4_a72 are compiled with -mfpu=neon-vfpv4
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    (void)id;
+    return (hwcap & HWCAP_NEON) && (hwcap & HWCAP_VFPv4);
+}
+
+#else
+
+// aarch64: armv8-a includes NEON (ASIMD). unknown: nothing to check
+static bool conv_arch_cpu_supports(const char * id)
+{
+    (void)id;
+    return true;
+}
+
+#endif
+
+
 ptr_to_conv_f_ptrs * get_all_conv_arch_ptrs(int * p_num_arch)
 {
     static ptr_to_conv_f_ptrs * all_arches = nullptr;
@@ -22,7 +139,6 @@ ptr_to_conv_f_ptrs * get_all_conv_arch_ptrs(int * p_num_arch)
     if (!all_arches)
     {
         n_arch = N_DEFAULT_ARCHES;
-        // @TODO: runtime check if actual CPU supports specific architecture
 #if defined(CONV_ARCH_GCC_AMD64)
         static const conv_f_ptrs *conv_arch_ptrs[N_DEFAULT_ARCHES+4] = {0};
         DPRINT("CONV_ARCH_GCC_AMD64: sse3, sse4, avx, avx2\n");
@@ -52,6 +168,15 @@ ptr_to_conv_f_ptrs * get_all_conv_arch_ptrs(int * p_num_arch)
 #endif
         conv_arch_ptrs[0] = CONV_FN_ARCH(conv_ptrs, none)();
         conv_arch_ptrs[1] = CONV_FN_ARCH(conv_ptrs, dflt)();
+        // "none" and "dflt" are compiled for the same CPU as the main code
+        for (int k = N_DEFAULT_ARCHES; k < n_arch; ++k)
+        {
+            if (conv_arch_ptrs[k] && !conv_arch_cpu_supports(conv_arch_ptrs[k]->id))
+            {
+                DPRINT("arch '%s' is NOT supported by the CPU\n", conv_arch_ptrs[k]->id);
+                conv_arch_ptrs[k] = nullptr;
+            }
+        }
         all_arches = conv_arch_ptrs;
     }
     if (p_num_arch)
@@ -59,3 +184,91 @@ ptr_to_conv_f_ptrs * get_all_conv_arch_ptrs(int * p_num_arch)
     return all_arches;
 }
 
+
+static bool conv_arch_is_usable(ptr_to_conv_f_ptrs arch)
+{
+    return arch && arch->fp_conv_float_oop && arch->fp_conv_float_move_rest;
+}
+
+// the last usable one: the architectures are ordered by their SIMD width
+static ptr_to_conv_f_ptrs conv_select_by_order()
+{
+    int num_arch = 0;
+    ptr_to_conv_f_ptrs * arches = get_all_conv_arch_ptrs(&num_arch);
+    for (int k = num_arch - 1; k > 0; --k)
+        if (conv_arch_is_usable(arches[k]))
+            return arches[k];
+    return arches[0];
+}
+
+// minimum time of the out-of-place kernel over some repetitions: a typical
+// filter length, which is a multiple of any simd size, on an L1 cache sized buffer
+static ptr_to_conv_f_ptrs conv_select_by_bench()
+{
+    constexpr int sz_filter = 64;
+    constexpr int sz_signal = 4096;
+    constexpr int n_rep = 16;
+    alignas(64) static float filter[sz_filter];
+    alignas(64) static float signal[sz_signal + sz_filter];
+    alignas(64) static float y[sz_signal + sz_filter];
+    int num_arch = 0;
+    ptr_to_conv_f_ptrs * arches = get_all_conv_arch_ptrs(&num_arch);
+    ptr_to_conv_f_ptrs best = arches[0];
+    double best_time = -1.0;
+
+    for (int k = 0; k < sz_filter; ++k)
+        filter[k] = 1.0F / (k + 1);
+    for (int k = 0; k < sz_signal + sz_filter; ++k)
+        signal[k] = (float)((k * 7919) % 257) / 257.0F - 0.5F;
+
+    for (int a = 0; a < num_arch; ++a)
+    {
+        if (!conv_arch_is_usable(arches[a]) || sz_filter % arches[a]->fp_conv_float_simd_size())
+            continue;
+        double min_time = -1.0;
+        for (int r = 0; r < n_rep; ++r)
+        {
+            conv_buffer_state state;
+            state.offset = 0;
+            state.size = sz_signal + sz_filter - 1;
+            const auto t0 = std::chrono::steady_clock::now();
+            arches[a]->fp_conv_float_oop(signal, &state, filter, sz_filter, y);
+            const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+            if (min_time < 0.0 || dt.count() < min_time)
+                min_time = dt.count();
+        }
+        DPRINT("arch '%s': %g us\n", arches[a]->id, min_time * 1E6);
+        if (best_time < 0.0 || min_time < best_time)
+        {
+            best = arches[a];
+            best_time = min_time;
+        }
+    }
+    return best;
+}
+
+// the architecture forced with the environment variable PF_CONV_ARCH - if supported
+static ptr_to_conv_f_ptrs conv_select_by_env()
+{
+    const char * env = getenv("PF_CONV_ARCH");
+    int num_arch = 0;
+    ptr_to_conv_f_ptrs * arches = get_all_conv_arch_ptrs(&num_arch);
+    for (int k = 0; env && k < num_arch; ++k)
+        if (conv_arch_is_usable(arches[k]) && !strcmp(env, arches[k]->id))
+            return arches[k];
+    return nullptr;
+}
+
+ptr_to_conv_f_ptrs get_best_conv_arch_ptrs(int select_mode)
+{
+    static const ptr_to_conv_f_ptrs by_env = conv_select_by_env();
+    if (by_env)
+        return by_env;
+    if (select_mode == CONV_ARCH_SELECT_BY_BENCH)
+    {
+        static const ptr_to_conv_f_ptrs by_bench = conv_select_by_bench();
+        return by_bench;
+    }
+    static const ptr_to_conv_f_ptrs by_order = conv_select_by_order();
+    return by_order;
+}
@@ -2,5 +2,19 @@
 
 #include "pf_conv.h"
 
+// all architectures compiled into the build: [0] is "none", [1] is "dflt".
+// entries are nullptr, when the architecture has no implementation (e.g. without MIPP)
+// or when the running CPU (or operating system) doesn't support it:
+// detected with cpuid on x86 and with the HWCAPs on ARM/Linux
 ptr_to_conv_f_ptrs * get_all_conv_arch_ptrs(int * p_num_arch);
 
+// selection modes for get_best_conv_arch_ptrs()
+#define CONV_ARCH_SELECT_BY_ORDER   0   // widest supported SIMD architecture
+#define CONV_ARCH_SELECT_BY_BENCH   1   // fastest supported in a short micro-benchmark
+
+// the architecture to use in production code: always returns a supported one,
+// at least "none". the environment variable PF_CONV_ARCH=<id> forces a (supported)
+// architecture. the result of each mode is determined once and cached -
+// the micro-benchmark takes some milliseconds on the first call.
+ptr_to_conv_f_ptrs get_best_conv_arch_ptrs(int select_mode);
+
@@ -0,0 +1,279 @@
+
+#include "pf_ddc.h"
+#include "pf_mixer.h"
+#include "pffastconv.h"
+#include "pffft.h"
+
+#include <string.h>
+#include <assert.h>
+
+#include <algorithm>
+#include <new>
+
+#if defined(_MSC_VER)
+#  define RESTRICT __restrict
+#elif defined(__GNUC__)
+#  define RESTRICT __restrict
+#else
+#  define RESTRICT
+#endif
+
+#define DDC_DEFAULT_TILE_LEN    2048
+#define DDC_MIXER_SIMD_SZ       PF_SHIFT_RECURSIVE_SIMD_SZ
+
+// variants of the recursive oscillator from pf_mixer.h
+enum { DDC_MIXER_GENERIC, DDC_MIXER_SSE, DDC_MIXER_AVX, DDC_MIXER_NEON };
+
+
+struct ddc_channel_state
+{
+    float rate;         // mixer rate: in units of samplerate/2 for the recursive_osc
+    int D;              // decimation
+    int L;              // number of decimation taps
+    float * hrev;       // decimation filter, reversed
+    complexf * hist;    // L-1 mixed samples of the previous tile + the mixed tile
+    complexf * dec;     // decimated samples of a tile - input for the channel filter
+    int skip;           // offset of the next decimated output in the next tile
+
+    shift_recursive_osc_conf_t osc_conf;
+    shift_recursive_osc_t osc;
+    shift_recursive_osc_sse_conf_t osc_sse_conf;
+    shift_recursive_osc_sse_t osc_sse;
+
+    PFFASTCONV_Setup * chan_filter;
+    int chan_blockLen;
+};
+
+
+struct ddc_setup
+{
+    int N;              // number of channels
+    int tileLen;
+    int mixer;          // one of the DDC_MIXER_* variants
+    ddc_channel_state * ch;
+};
+
+
+static void channel_free(ddc_channel_state * c)
+{
+    pffft_aligned_free(c->hrev);
+    pffft_aligned_free(c->hist);
+    pffft_aligned_free(c->dec);
+    pffastconv_destroy_setup(c->chan_filter);
+}
+
+
+static bool channel_init(ddc_channel_state * c, const ddc_channel_t * conf, int tileLen)
+{
+    int k;
+
+    c->rate = -2.0F * conf->relative_freq;
+    c->D = conf->decimation;
+    c->L = conf->decim_taps ? conf->num_decim_taps : 1;
+    c->hrev = (float*)pffft_aligned_malloc((size_t)c->L * sizeof(float));
+    c->hist = (complexf*)pffft_aligned_malloc((size_t)(c->L - 1 + tileLen) * sizeof(complexf));
+    c->dec = (complexf*)pffft_aligned_malloc((size_t)(tileLen / c->D + 1) * sizeof(complexf));
+    if (!c->hrev || !c->hist || !c->dec)
+        return false;
+
+    for (k = 0; k < c->L; ++k)
+        c->hrev[k] = conf->decim_taps ? conf->decim_taps[c->L - 1 - k] : 1.0F;
+
+    if (conf->chan_taps)
+    {
+        // one FFT block for (about) the decimated samples of a tile
+        c->chan_blockLen = std::max(256, tileLen / c->D);
+        c->chan_filter = pffastconv_new_setup(conf->chan_taps, conf->num_chan_taps, &c->chan_blockLen, PFFASTCONV_CPLX_INP_OUT);
+        if (!c->chan_filter)
+            return false;
+    }
+    return true;
+}
+
+
+static void channel_reset(ddc_channel_state * c, int mixer)
+{
+    if (mixer == DDC_MIXER_SSE || mixer == DDC_MIXER_NEON)
+        shift_recursive_osc_sse_init(c->rate, 0.0F, &c->osc_sse_conf, &c->osc_sse);
+    else
+        shift_recursive_osc_init(c->rate, 0.0F, &c->osc_conf, &c->osc);
+    memset(c->hist, 0, (size_t)(c->L - 1) * sizeof(complexf));
+    c->skip = 0;
+    if (c->chan_filter)
+        pffastconv_reset(c->chan_filter);
+}
+
+
+ddc_setup * ddc_new_setup(const ddc_channel_t * channels, int numChannels, int tileLen)
+{
+    ddc_setup * s;
+    int c;
+
+    if (!channels || numChannels <= 0)
+        return nullptr;
+    for (c = 0; c < numChannels; ++c)
+    {
+        const ddc_channel_t * conf = &channels[c];
+        if (conf->decimation < 1
+            || (conf->decim_taps && conf->num_decim_taps <= 0)
+            || (conf->chan_taps && conf->num_chan_taps <= 0))
+            return nullptr;
+    }
+    if (tileLen <= 0)
+        tileLen = DDC_DEFAULT_TILE_LEN;
+    tileLen = ((tileLen + DDC_MIXER_SIMD_SZ - 1) / DDC_MIXER_SIMD_SZ) * DDC_MIXER_SIMD_SZ;
+
+    s = new (std::nothrow) ddc_setup();
+    if (!s)
+        return nullptr;
+    s->tileLen = tileLen;
+    if (have_avx_shift_mixer_impl())
+        s->mixer = DDC_MIXER_AVX;
+    else if (have_neon_shift_mixer_impl())
+        s->mixer = DDC_MIXER_NEON;
+    else if (have_sse_shift_mixer_impl())
+        s->mixer = DDC_MIXER_SSE;
+    else
+        s->mixer = DDC_MIXER_GENERIC;
+    s->ch = new (std::nothrow) ddc_channel_state[numChannels]();
+    if (!s->ch)
+    {
+        delete s;
+        return nullptr;
+    }
+    s->N = numChannels;
+
+    for (c = 0; c < numChannels; ++c)
+    {
+        if (!channel_init(&s->ch[c], &channels[c], tileLen))
+        {
+            ddc_destroy_setup(s);
+            return nullptr;
+        }
+    }
+    ddc_reset(s);
+    return s;
+}
+
+
+void ddc_destroy_setup(ddc_setup * s)
+{
+    int c;
+    if (!s)
+        return;
+    for (c = 0; c < s->N; ++c)
+        channel_free(&s->ch[c]);
+    delete [] s->ch;
+    delete s;
+}
+
+
+void ddc_reset(ddc_setup * s)
+{
+    int c;
+    for (c = 0; c < s->N; ++c)
+        channel_reset(&s->ch[c], s->mixer);
+}
+
+
+int ddc_num_channels(const ddc_setup * s)
+{
+    return s->N;
+}
+
+
+int ddc_tile_len(const ddc_setup * s)
+{
+    return s->tileLen;
+}
+
+
+int ddc_max_output_len(const ddc_setup * s, int channel, int inputLen)
+{
+    const ddc_channel_state * c = &s->ch[channel];
+    assert(channel >= 0 && channel < s->N);
+    // pffastconv_stream() might deliver up to one block more than it gets
+    return (inputLen + c->D - 1) / c->D + (c->chan_filter ? c->chan_blockLen : 0);
+}
+
+
+/* low-pass and decimation of the mixed tile in hist[L-1 .. L-1+n):
+ * only every D'th output is computed */
+static int decimate(ddc_channel_state * c, int n, complexf * RESTRICT y)
+{
+    const float * RESTRICT h = c->hrev;
+    const int L = c->L;
+    int p, m = 0;
+
+    for (p = c->skip; p < n; p += c->D)
+    {
+        const complexf * RESTRICT x = c->hist + p;
+        float sum_i = 0.0F, sum_q = 0.0F;
+        int k;
+        for (k = 0; k < L; ++k)
+        {
+            sum_i += h[k] * x[k].i;
+            sum_q += h[k] * x[k].q;
+        }
+        y[m].i = sum_i;
+        y[m].q = sum_q;
+        ++m;
+    }
+    c->skip = p - n;
+
+    // keep the last L-1 mixed samples for the next tile
+    memmove(c->hist, c->hist + n, (size_t)(L - 1) * sizeof(complexf));
+    return m;
+}
+
+
+/* all the stages of one channel for a tile of n samples */
+static int process_channel_tile(const ddc_setup * s, ddc_channel_state * c, const complexf * tile, int n, complexf * output)
+{
+    complexf * mixed = c->hist + (c->L - 1);
+    int m;
+
+    switch (s->mixer)
+    {
+    case DDC_MIXER_AVX:
+        memcpy(mixed, tile, (size_t)n * sizeof(complexf));
+        shift_recursive_osc_avx_inp_c(mixed, n, &c->osc_conf, &c->osc);
+        break;
+    case DDC_MIXER_NEON:
+        memcpy(mixed, tile, (size_t)n * sizeof(complexf));
+        shift_recursive_osc_neon_inp_c(mixed, n, &c->osc_sse_conf, &c->osc_sse);
+        break;
+    case DDC_MIXER_SSE:
+        memcpy(mixed, tile, (size_t)n * sizeof(complexf));
+        shift_recursive_osc_sse_inp_c(mixed, n, &c->osc_sse_conf, &c->osc_sse);
+        break;
+    default:
+        shift_recursive_osc_cc(tile, mixed, n, &c->osc_conf, &c->osc);
+    }
+
+    if (!c->chan_filter)
+        return decimate(c, n, output);
+
+    m = decimate(c, n, c->dec);
+    return pffastconv_stream(c->chan_filter, (const float*)c->dec, m, (float*)output);
+}
+
+
+int ddc_process(ddc_setup * s, const complexf * input, int inputLen, complexf * const * outputs, int * outLens)
+{
+    int off, c;
+
+    inputLen -= inputLen % DDC_MIXER_SIMD_SZ;
+    for (c = 0; c < s->N; ++c)
+        outLens[c] = 0;
+
+    // tile by tile: each tile is read from memory once - for all channels
+    for (off = 0; off < inputLen; off += s->tileLen)
+    {
+        const int n = std::min(s->tileLen, inputLen - off);
+        for (c = 0; c < s->N; ++c)
+            outLens[c] += process_channel_tile(s, &s->ch[c], input + off, n, outputs[c] + outLens[c]);
+    }
+    return inputLen;
+}
+
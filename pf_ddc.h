@@ -0,0 +1,75 @@
+#pragma once
+
+/* pf_ddc.h/.cpp implements a multi-channel digital downconverter (DDC):
+ * for each channel, the wideband complex input is
+ *
+ * - mixed down by the channel's center frequency, with the recursive
+ *   oscillator from pf_mixer.h (the AVX, NEON or SSE variant, when available)
+ * - low-pass filtered and decimated with a real FIR: only every
+ *   decimation'th output is computed
+ * - optionally filtered with a (long) real channel filter at the
+ *   decimated rate - with pffastconv_stream() from pffastconv.h
+ *
+ * instead of one complete pass over the input per stage and channel,
+ * the input is processed in tiles of 'tileLen' samples: all channels
+ * consume a tile before the next one is read. the tile and the
+ * intermediate data of a channel stay in the cache (L1/L2),
+ * only the wideband input is read once from memory.
+ *
+ * the output of a channel is the continuous (causal) filter output:
+ * with zero input samples before the first call, decimated output m is
+ *   y[m] = sum_k ( decim_taps[k] * x_mixed[m * decimation - k] )
+ * which is then the input of the channel filter.
+ */
+
+#include "pf_cplx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ddc_setup ddc_setup;
+
+typedef struct ddc_channel_s
+{
+    float relative_freq;        /* center frequency / samplerate: shifted to 0.
+                                 * avoid +/- 1/8 and +/- 1/16: the block steps of the
+                                 * recursive_osc would be exactly +/- pi */
+    int decimation;             /* >= 1 */
+    const float * decim_taps;   /* real low-pass for the decimation: NULL for no filter */
+    int num_decim_taps;
+    const float * chan_taps;    /* real channel filter at the decimated rate: NULL for none */
+    int num_chan_taps;
+} ddc_channel_t;
+
+/* prepare numChannels channels. the coefficients are copied.
+ * tileLen is rounded up to a multiple of 8. tileLen <= 0 selects 2048:
+ * the data of a tile in all the stages should fit into the L1/L2 cache.
+ * returns NULL for unsuitable parameters.
+ */
+ddc_setup * ddc_new_setup(const ddc_channel_t * channels, int numChannels, int tileLen);
+
+void ddc_destroy_setup(ddc_setup * s);
+
+/* required size of outputs[channel] for a call of ddc_process() with inputLen samples */
+int ddc_max_output_len(const ddc_setup * s, int channel, int inputLen);
+
+/* process inputLen complex input samples for all channels:
+ * outputs[c] receives outLens[c] samples of channel c,
+ * it needs room for ddc_max_output_len() samples.
+ * the mixer requires inputLen to be a multiple of 8: the return value is
+ * the number of consumed input samples, inputLen rounded down to a multiple of 8.
+ * input and outputs don't need to be aligned.
+ */
+int ddc_process(ddc_setup * s, const complexf * input, int inputLen, complexf * const * outputs, int * outLens);
+
+/* forget the input history and restart the oscillators: as if a new setup was just created */
+void ddc_reset(ddc_setup * s);
+
+int ddc_num_channels(const ddc_setup * s);
+int ddc_tile_len(const ddc_setup * s);
+
+#ifdef __cplusplus
+}
+#endif
+
@@ -0,0 +1,464 @@
+
+#include "pf_decim.h"
+#include "pf_cic.h"
+#include "pf_kaiser_impl.h"
+#include "pffastconv.h"
+#include "pffft.h"
+
+#include <math.h>
+#include <string.h>
+#include <assert.h>
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#if defined(_MSC_VER)
+#  define RESTRICT __restrict
+#elif defined(__GNUC__)
+#  define RESTRICT __restrict
+#else
+#  define RESTRICT
+#endif
+
+#define DECIM_DEFAULT_CIC_ORDER  4
+#define DECIM_TILE_OUT           1024   // CIC outputs per tile
+#define DECIM_MIN_BLOCK_LEN      256
+
+
+struct decim_halfband
+{
+    int L;              // number of taps: 4*k+3
+    int P;              // number of nonzero taps beside the center: (L+1)/4 pairs
+    float * g;          // taps at the odd offsets 1, 3, .. from the center
+    complexf * hist;    // L-1 samples of the previous tile + the input of the tile
+    int skip;           // offset of the next output in the next tile
+};
+
+
+struct decim_setup
+{
+    decim_plan_t plan;
+    int tileLen;            // input samples per tile
+    cic_decim_setup * cic;
+    decim_halfband * hb;
+    PFFASTCONV_Setup * cfir;
+    int blockLen;
+    complexf * fin;         // input of the CFIR
+    complexf * fout;        // output of the CFIR, before the decimation
+    int finLen;             // maximum number of samples in fin per tile
+    int skip;               // offset of the next output in fout
+};
+
+
+/*****************************************************************************/
+/* filter design */
+
+/* gain of the CIC at f - relative to its input rate - normalized to 1 at DC */
+static double cic_gain(int N, int R, double f)
+{
+    if (R <= 1 || fabs(f) < 1E-12)
+        return 1.0;
+    return pow(fabs(sin(M_PI * f * R) / (R * sin(M_PI * f))), N);
+}
+
+/* attenuation in dB for the ripple of one of numStages stages */
+static double stage_atten(const decim_spec_t * spec, int numStages)
+{
+    const double ds = pow(10.0, -spec->stopband_atten_db / 20.0);
+    const double rp = pow(10.0, spec->passband_ripple_db / 20.0);
+    const double dp = (rp - 1.0) / (rp + 1.0) / numStages;
+    return -20.0 * log10(std::min(ds, dp));
+}
+
+/* halfband for the passband fp, relative to the input rate */
+static int halfband_len(double A, double fp)
+{
+    // round up to 4*k+3: the outermost taps at the odd offsets from the center
+    const int L = kaiser_len(A, 0.5 - 2.0 * fp);
+    return 4 * (std::max(L, 3) / 4) + 3;
+}
+
+static int next_power_of_two(int n)
+{
+    int p = 1;
+    while (p < n)
+        p *= 2;
+    return p;
+}
+
+/* requested block length of the CFIR: some FFT lengths beyond the filter */
+static int cfir_block_len(int L)
+{
+    return std::max(DECIM_MIN_BLOCK_LEN, 4 * next_power_of_two(L));
+}
+
+/* the halfband taps at the odd offsets from the center, DC gain 1 */
+static void design_halfband(decim_halfband * hb, double A)
+{
+    const double beta = kaiser_beta(A);
+    const int c = (hb->L - 1) / 2;
+    double sum = 0.0;
+    int j;
+    for (j = 0; j < hb->P; ++j)
+    {
+        const int k = 2 * j + 1;
+        hb->g[j] = (float)( sin(M_PI * k / 2.0) / (M_PI * k) * kaiser_window(c + k, hb->L, beta) );
+        sum += 2.0 * hb->g[j];
+    }
+    // the center tap is 0.5: the others should sum up to 0.5
+    for (j = 0; j < hb->P && sum != 0.0; ++j)
+        hb->g[j] = (float)(hb->g[j] * 0.5 / sum);
+}
+
+/* windowed ideal low-pass with cutoff fc (relative to the rate of the CFIR),
+ * with the passband raised by 1 / cic_gain() */
+static void design_cfir(float * h, int L, double fc, double A, int N, int Rc, double cicRate)
+{
+    const double beta = kaiser_beta(A);
+    const int K = 8 * L + 64;   // integration points in [0, fc]
+    const double df = fc / K;
+    std::vector<double> C(K);
+    int n, k;
+
+    for (k = 0; k < K; ++k)
+        C[k] = 1.0 / cic_gain(N, Rc, (k + 0.5) * df * cicRate);
+
+    for (n = 0; n < L; ++n)
+    {
+        // 2 * integral_0^fc C(f) cos(2 pi f (n-c)) df - with rotating phasors
+        const double t = n - 0.5 * (L - 1);
+        const double rc = cos(2.0 * M_PI * df * t), rs = sin(2.0 * M_PI * df * t);
+        double pc = cos(M_PI * df * t), ps = sin(M_PI * df * t), sum = 0.0;
+        for (k = 0; k < K; ++k)
+        {
+            const double tc = pc * rc - ps * rs;
+            sum += C[k] * pc;
+            ps = pc * rs + ps * rc;
+            pc = tc;
+        }
+        h[n] = (float)( 2.0 * sum * df * kaiser_window(n, L, beta) );
+    }
+}
+
+
+/*****************************************************************************/
+/* planning */
+
+static int spec_decimation(const decim_spec_t * spec)
+{
+    if (!spec || spec->input_rate <= 0.0 || spec->output_rate <= 0.0)
+        return -1;
+    const double r = spec->input_rate / spec->output_rate;
+    const double D = floor(r + 0.5);
+    if (D < 1.0 || D > 1E9 || fabs(r - D) > 1E-6 * D)
+        return -1;
+    if (spec->passband <= 0.0 || spec->stopband <= spec->passband
+        || spec->stopband > spec->output_rate - spec->passband + 1E-9 * spec->output_rate
+        || spec->passband_ripple_db <= 0.0 || spec->stopband_atten_db <= 0.0
+        || spec->cic_order > PF_CIC_MAX_ORDER)
+        return -1;
+    return (int)D;
+}
+
+/* lengths of the filters and estimated operations for the decimations in plan.
+ * returns false, when the stages can't meet the spec */
+static bool plan_stages(const decim_spec_t * spec, decim_plan_t * plan)
+{
+    const double fi = spec->input_rate, fo = spec->output_rate, fp = spec->passband;
+    const int N = plan->cic_order, Rc = plan->cic_decimation, Dl = plan->final_decimation;
+    const int D = plan->decimation;
+    const double A = stage_atten(spec, plan->num_halfbands + 1);
+    const double Fl = fo * Dl;
+    const double fs = (Dl >= 2) ? std::min(spec->stopband, fo - fp) : spec->stopband;
+    double ops, F;
+    int j;
+
+    if (Rc < 1 || Dl < 1 || plan->num_halfbands < 0 || plan->num_halfbands > DECIM_MAX_HALFBANDS
+        || Rc * (1 << plan->num_halfbands) * Dl != D)
+        return false;
+    if (fs > 0.5 * Fl)
+        return false;
+    if (Rc > 1)
+    {
+        // bit growth of the integrators - and the bands aliasing into the passband
+        if (16.0 + ceil(N * log2((double)Rc) - 1E-9) > 64.0)
+            return false;
+        if (-20.0 * log10(cic_gain(N, Rc, (fi / Rc - fp) / fi) + 1E-300) < spec->stopband_atten_db)
+            return false;
+    }
+
+    // CIC: conversion and integrators at the input rate, combs at the decimated rate
+    ops = 2.0 * D + ((Rc > 1) ? (2.0 * N * D + 2.0 * N * D / Rc) : 0.0);
+
+    F = fi / Rc;
+    for (j = 0; j < plan->num_halfbands; ++j, F *= 0.5)
+    {
+        const int L = halfband_len(A, fp / F);
+        const int P = (L + 1) / 4;
+        plan->halfband_taps[j] = L;
+        // complex: fold, multiply and add P pairs - and the center
+        ops += (6.0 * P + 4.0) * (0.5 * F / fo);
+    }
+
+    plan->final_taps = kaiser_len(A, (fs - fp) / Fl) | 1;
+    {
+        const int L = plan->final_taps;
+        const int Nfft = std::max(2 * next_power_of_two(L - 1), next_power_of_two(cfir_block_len(L)));
+        // forward and backward complex FFT and the spectral multiplication per block
+        const double blockOps = 2.0 * 5.0 * Nfft * log2((double)Nfft) + 4.0 * Nfft;
+        ops += Dl * blockOps / (Nfft - L + 1);
+    }
+    plan->ops_per_output = ops;
+    return true;
+}
+
+
+int decim_plan(const decim_spec_t * spec, decim_plan_t * plan)
+{
+    const int D = spec_decimation(spec);
+    decim_plan_t p, best;
+    int Rc, h;
+
+    if (D < 1 || !plan)
+        return -1;
+    memset(&best, 0, sizeof(best));
+    best.ops_per_output = -1.0;
+
+    for (Rc = 1; Rc <= D; ++Rc)
+    {
+        if (D % Rc)
+            continue;
+        for (h = 0; h <= DECIM_MAX_HALFBANDS && ((D / Rc) % (1 << h)) == 0; ++h)
+        {
+            memset(&p, 0, sizeof(p));
+            p.decimation = D;
+            p.cic_order = (spec->cic_order > 0) ? spec->cic_order : DECIM_DEFAULT_CIC_ORDER;
+            p.cic_decimation = Rc;
+            p.num_halfbands = h;
+            p.final_decimation = D / Rc / (1 << h);
+            if (!plan_stages(spec, &p))
+                continue;
+            if (best.ops_per_output < 0.0 || p.ops_per_output < best.ops_per_output)
+                best = p;
+        }
+    }
+    if (best.ops_per_output < 0.0)
+        return -1;
+    *plan = best;
+    return 0;
+}
+
+
+/*****************************************************************************/
+/* setup */
+
+decim_setup * decim_new_setup(const decim_spec_t * spec, const decim_plan_t * plan)
+{
+    decim_plan_t check;
+    decim_setup * s;
+    int j, n;
+
+    if (!plan)
+    {
+        if (decim_plan(spec, &check))
+            return nullptr;
+        plan = &check;
+    }
+    else
+    {
+        // the decimations have to match the spec: the filter lengths are taken from plan
+        check = *plan;
+        if (spec_decimation(spec) != plan->decimation || !plan_stages(spec, &check))
+            return nullptr;
+        for (j = 0; j < plan->num_halfbands; ++j)
+            if (plan->halfband_taps[j] < 3 || (plan->halfband_taps[j] % 4) != 3)
+                return nullptr;
+        if (plan->final_taps < 1)
+            return nullptr;
+    }
+
+    s = new (std::nothrow) decim_setup();
+    if (!s)
+        return nullptr;
+    s->plan = *plan;
+    s->plan.ops_per_output = check.ops_per_output;
+    s->tileLen = DECIM_TILE_OUT * plan->cic_decimation;
+    s->cic = cic_decim_new_setup(2, plan->cic_order, plan->cic_decimation, 1);
+    s->hb = new (std::nothrow) decim_halfband[std::max(1, plan->num_halfbands)]();
+    if (!s->cic || !s->hb)
+    {
+        decim_destroy_setup(s);
+        return nullptr;
+    }
+
+    const double A = stage_atten(spec, plan->num_halfbands + 1);
+    n = cic_decim_max_output_len(s->cic, s->tileLen);
+    for (j = 0; j < plan->num_halfbands; ++j)
+    {
+        decim_halfband * hb = &s->hb[j];
+        hb->L = plan->halfband_taps[j];
+        hb->P = (hb->L + 1) / 4;
+        hb->g = (float*)pffft_aligned_malloc((size_t)hb->P * sizeof(float));
+        hb->hist = (complexf*)pffft_aligned_malloc((size_t)(hb->L - 1 + n) * sizeof(complexf));
+        if (!hb->g || !hb->hist)
+        {
+            decim_destroy_setup(s);
+            return nullptr;
+        }
+        design_halfband(hb, A);
+        n = n / 2 + 1;
+    }
+
+    {
+        const int L = plan->final_taps;
+        const double fo = spec->output_rate, fp = spec->passband, Fl = fo * plan->final_decimation;
+        const double fs = (plan->final_decimation >= 2) ? std::min(spec->stopband, fo - fp) : spec->stopband;
+        std::vector<float> h(L);
+        design_cfir(h.data(), L, 0.5 * (fp + fs) / Fl, A, plan->cic_order, plan->cic_decimation,
+                    Fl / spec->input_rate);
+        s->blockLen = cfir_block_len(L);
+        s->cfir = pffastconv_new_setup(h.data(), L, &s->blockLen, PFFASTCONV_CPLX_INP_OUT | PFFASTCONV_SYMMETRIC);
+    }
+    s->finLen = n;
+    s->fin = (complexf*)pffft_aligned_malloc((size_t)n * sizeof(complexf));
+    s->fout = (complexf*)pffft_aligned_malloc((size_t)(n + s->blockLen) * sizeof(complexf));
+    if (!s->cfir || !s->fin || !s->fout)
+    {
+        decim_destroy_setup(s);
+        return nullptr;
+    }
+    decim_reset(s);
+    return s;
+}
+
+
+void decim_destroy_setup(decim_setup * s)
+{
+    int j;
+    if (!s)
+        return;
+    cic_decim_destroy_setup(s->cic);
+    for (j = 0; s->hb && j < s->plan.num_halfbands; ++j)
+    {
+        pffft_aligned_free(s->hb[j].g);
+        pffft_aligned_free(s->hb[j].hist);
+    }
+    delete [] s->hb;
+    pffastconv_destroy_setup(s->cfir);
+    pffft_aligned_free(s->fin);
+    pffft_aligned_free(s->fout);
+    delete s;
+}
+
+
+void decim_reset(decim_setup * s)
+{
+    int j;
+    cic_decim_reset(s->cic);
+    for (j = 0; j < s->plan.num_halfbands; ++j)
+    {
+        memset(s->hb[j].hist, 0, (size_t)(s->hb[j].L - 1) * sizeof(complexf));
+        s->hb[j].skip = 0;
+    }
+    pffastconv_reset(s->cfir);
+    s->skip = 0;
+}
+
+
+const decim_plan_t * decim_get_plan(const decim_setup * s)
+{
+    return &s->plan;
+}
+
+
+int decim_max_output_len(const decim_setup * s, int inputLen)
+{
+    int j, n = cic_decim_max_output_len(s->cic, inputLen);
+    for (j = 0; j < s->plan.num_halfbands; ++j)
+        n = n / 2 + 1;
+    // pffastconv_stream() might deliver up to one block more than it gets
+    n += s->blockLen;
+    return n / s->plan.final_decimation + 1;
+}
+
+
+/*****************************************************************************/
+/* processing */
+
+/* halfband decimation of the tile in hist[L-1 .. L-1+n): only the taps at the
+ * odd offsets from the center are nonzero, they are symmetric */
+static int halfband_decimate(decim_halfband * hb, int n, complexf * RESTRICT y)
+{
+    const float * RESTRICT g = hb->g;
+    const int P = hb->P, c = (hb->L - 1) / 2;
+    int p, m = 0;
+
+    for (p = hb->skip; p < n; p += 2)
+    {
+        const complexf * RESTRICT x = hb->hist + p + c;
+        float sum_i = 0.0F, sum_q = 0.0F;
+        int j;
+        for (j = 0; j < P; ++j)
+        {
+            sum_i += g[j] * (x[-1 - 2 * j].i + x[1 + 2 * j].i);
+            sum_q += g[j] * (x[-1 - 2 * j].q + x[1 + 2 * j].q);
+        }
+        y[m].i = sum_i + 0.5F * x[0].i;
+        y[m].q = sum_q + 0.5F * x[0].q;
+        ++m;
+    }
+    hb->skip = p - n;
+
+    // keep the last L-1 samples for the next tile
+    memmove(hb->hist, hb->hist + n, (size_t)(hb->L - 1) * sizeof(complexf));
+    return m;
+}
+
+
+template <class T>
+static int decim_process(decim_setup * s, const T * input, int inputLen, complexf * output,
+                         int (*cic_fn)(cic_decim_setup *, const T *, int, float *))
+{
+    const int H = s->plan.num_halfbands, Dl = s->plan.final_decimation;
+    int off, numOut = 0;
+
+    for (off = 0; off < inputLen; off += s->tileLen)
+    {
+        const int len = std::min(s->tileLen, inputLen - off);
+        complexf * dst = H ? (s->hb[0].hist + s->hb[0].L - 1) : s->fin;
+        int n, j, p;
+
+        n = cic_fn(s->cic, input + 2 * off, len, (float*)dst);
+        for (j = 0; j < H; ++j)
+        {
+            dst = (j + 1 < H) ? (s->hb[j + 1].hist + s->hb[j + 1].L - 1) : s->fin;
+            n = halfband_decimate(&s->hb[j], n, dst);
+        }
+        assert(n <= s->finLen);
+
+        if (Dl == 1)
+        {
+            numOut += pffastconv_stream(s->cfir, (const float*)s->fin, n, (float*)(output + numOut));
+            continue;
+        }
+        n = pffastconv_stream(s->cfir, (const float*)s->fin, n, (float*)s->fout);
+        for (p = s->skip; p < n; p += Dl)
+            output[numOut++] = s->fout[p];
+        s->skip = p - n;
+    }
+    return numOut;
+}
+
+
+int decim_cs16(decim_setup * s, const int16_t * input, int inputLen, complexf * output)
+{
+    return decim_process<int16_t>(s, input, inputLen, output, cic_decim_s16);
+}
+
+
+int decim_cu8(decim_setup * s, const uint8_t * input, int inputLen, complexf * output)
+{
+    return decim_process<uint8_t>(s, input, inputLen, output, cic_decim_u8);
+}
+
@@ -0,0 +1,90 @@
+#pragma once
+
+/* pf_decim.h/.cpp implements a multi-stage decimator for complex 16 or 8 bit
+ * samples - e.g. from an SDR front end - planned from the specification of the output:
+ *
+ * - CIC decimator from pf_cic.h, with decimation R_cic
+ * - cascaded halfband filters, each decimating by 2: a polyphase kernel,
+ *   which skips the zero coefficients and folds the symmetric ones
+ * - the last stage is the compensation FIR (CFIR): a linear-phase filter,
+ *   with pffastconv_stream() from pffastconv.h, which flattens the passband droop
+ *   of the CIC, defines the transition band and decimates by the remaining factor
+ *
+ * decim_plan() chooses R_cic, the number of halfbands and the filter lengths with
+ * the minimum (estimated) number of operations per output sample: the CIC attenuates
+ * the bands which alias into the passband, the halfbands protect the passband,
+ * the CFIR is designed for the transition and stopband.
+ * the filters are Kaiser windowed designs.
+ *
+ * the output of the chain is continuous (causal): with zero input samples
+ * before the first call - and the group delay of all the stages.
+ */
+
+#include "pf_cplx.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct decim_setup decim_setup;
+
+typedef struct decim_spec_s
+{
+    double input_rate;          /* samples per second */
+    double output_rate;         /* input_rate / output_rate has to be an integer */
+    double passband;            /* edge of the passband in Hz */
+    double stopband;            /* start of the stopband in Hz: passband < stopband <= output_rate - passband */
+    double passband_ripple_db;  /* maximum ripple, peak to peak, e.g. 0.1 */
+    double stopband_atten_db;   /* minimum attenuation, e.g. 80 */
+    int cic_order;              /* 1 .. PF_CIC_MAX_ORDER - <= 0 selects 4 */
+} decim_spec_t;
+
+#define DECIM_MAX_HALFBANDS  16
+
+typedef struct decim_plan_s
+{
+    int decimation;             /* total decimation: input_rate / output_rate */
+    int cic_order;
+    int cic_decimation;         /* 1: the CIC stage just converts the samples */
+    int num_halfbands;
+    int halfband_taps[DECIM_MAX_HALFBANDS];
+    int final_decimation;       /* decimation of the CFIR */
+    int final_taps;
+    double ops_per_output;      /* estimated arithmetic operations per output sample */
+} decim_plan_t;
+
+/* choose the stages for spec. returns 0 - or -1 for an unsuitable spec */
+int decim_plan(const decim_spec_t * spec, decim_plan_t * plan);
+
+/* prepare the chain of plan - or of decim_plan(spec) for plan == NULL.
+ * the plan might be modified, e.g. with other filter lengths,
+ * but the decimations have to match the spec.
+ * returns NULL for an unsuitable spec or plan.
+ */
+decim_setup * decim_new_setup(const decim_spec_t * spec, const decim_plan_t * plan);
+
+void decim_destroy_setup(decim_setup * s);
+
+/* forget the input history: as if a new setup was just created */
+void decim_reset(decim_setup * s);
+
+const decim_plan_t * decim_get_plan(const decim_setup * s);
+
+/* required size of output for a call with inputLen samples */
+int decim_max_output_len(const decim_setup * s, int inputLen);
+
+/* decimate inputLen complex samples, interleaved I/Q - of any length per call.
+ * returns the number of samples written to output.
+ * full scale input delivers an amplitude of 1.0
+ */
+int decim_cs16(decim_setup * s, const int16_t * input, int inputLen, complexf * output);
+
+/* the same for unsigned 8 bit I/Q, with the offset 127.4 - see cic_decim_u8() */
+int decim_cu8(decim_setup * s, const uint8_t * input, int inputLen, complexf * output);
+
+#ifdef __cplusplus
+}
+#endif
+
@@ -0,0 +1,363 @@
+
+/* for pthread_setaffinity_np() */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "pf_executor.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <vector>
+
+#ifndef PF_EXECUTOR_NO_THREADS
+#include <thread>
+#  if defined(__linux__)
+#    include <pthread.h>
+#    include <sched.h>
+#  elif defined(_WIN32)
+#    include <windows.h>
+#  endif
+#endif
+
+#define PF_CACHE_LINE           64
+#define EXEC_ALIGN_FLOATS       16      // scratch parts start on a cache line
+
+
+/*****************************************************************************/
+/* each worker owns a range of the job list: [begin, end) packed into one
+ * 64 bit word - the owner advances begin, thieves lower end. jobs only
+ * leave a range, so a packed value with remaining jobs never repeats.
+ */
+
+struct pf_exec_worker
+{
+    alignas(PF_CACHE_LINE) std::atomic<uint64_t> range;
+    float * scratch;
+    size_t scratchBytes;
+    int cpu;
+    pf_exec_stats_t stats;
+};
+
+struct pf_executor
+{
+    std::vector<pf_exec_worker> workers;
+    // the current run
+    const pf_exec_job_t * jobs;
+    unsigned grain;
+    size_t needBytes;
+    std::atomic<int> failed;
+
+    explicit pf_executor(int numThreads) : workers(numThreads) { }
+};
+
+
+static inline uint64_t pack_range(unsigned begin, unsigned end)
+{
+    return ((uint64_t)begin << 32) | end;
+}
+
+
+pf_executor * pf_executor_new(int numThreads, const int * cpus)
+{
+    pf_executor * e;
+    int k;
+
+#ifndef PF_EXECUTOR_NO_THREADS
+    if (numThreads <= 0)
+        numThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+#else
+    numThreads = 1;
+    cpus = nullptr;
+#endif
+    try
+    {
+        e = new (std::nothrow) pf_executor(numThreads);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+    if (!e)
+        return nullptr;
+    for (k = 0; k < numThreads; ++k)
+    {
+        pf_exec_worker & w = e->workers[k];
+        w.range.store(0, std::memory_order_relaxed);
+        w.scratch = nullptr;
+        w.scratchBytes = 0;
+        w.cpu = cpus ? cpus[k] : -1;
+        memset(&w.stats, 0, sizeof(w.stats));
+    }
+    e->jobs = nullptr;
+    e->grain = 1;
+    e->needBytes = 0;
+    e->failed.store(0, std::memory_order_relaxed);
+    return e;
+}
+
+
+void pf_executor_destroy(pf_executor * e)
+{
+    if (!e)
+        return;
+    for (size_t k = 0; k < e->workers.size(); ++k)
+        pffft_aligned_free(e->workers[k].scratch);
+    delete e;
+}
+
+
+int pf_executor_num_threads(const pf_executor * e)
+{
+    return (int)e->workers.size();
+}
+
+
+/*****************************************************************************/
+/* the jobs */
+
+static inline int align_floats(int n)
+{
+    return (n + EXEC_ALIGN_FLOATS - 1) / EXEC_ALIGN_FLOATS * EXEC_ALIGN_FLOATS;
+}
+
+
+/* floats of scratch for the job - or -1 for an invalid job */
+static int job_scratch_floats(const pf_exec_job_t * j)
+{
+    int n;
+    if (!j->setup || !j->input || !j->output)
+        return -1;
+    n = pffft_work_size(j->setup);
+    switch (j->type)
+    {
+    case PF_EXEC_TRANSFORM:
+    case PF_EXEC_TRANSFORM_ORDERED:
+        return n;
+    case PF_EXEC_CONVOLVE:
+        // the zero padded input / its spectrum - and the work of the transforms.
+        // only native 1D sizes, where the work is the size of the transform:
+        // Bluestein's setups are the ones, which can't be serialized
+        if (!pffft_serialized_size(j->setup) || !j->filter || j->inputLen < 0 || j->inputLen > n)
+            return -1;
+        return align_floats(n) + n;
+    default:
+        return -1;
+    }
+}
+
+
+static void execute_job(const pf_exec_job_t * j, float * scratch)
+{
+    switch (j->type)
+    {
+    case PF_EXEC_TRANSFORM:
+        pffft_transform(j->setup, j->input, j->output, scratch, j->direction);
+        break;
+    case PF_EXEC_TRANSFORM_ORDERED:
+        pffft_transform_ordered(j->setup, j->input, j->output, scratch, j->direction);
+        break;
+    case PF_EXEC_CONVOLVE:
+    {
+        const int n = pffft_work_size(j->setup);
+        float * buf = scratch;
+        float * work = scratch + align_floats(n);
+        memcpy(buf, j->input, (size_t)j->inputLen * sizeof(float));
+        memset(buf + j->inputLen, 0, (size_t)(n - j->inputLen) * sizeof(float));
+        pffft_transform(j->setup, buf, buf, work, PFFFT_FORWARD);
+        pffft_zconvolve_transform_backward(j->setup, buf, j->filter, j->output, work, j->scaling);
+        break;
+    }
+    }
+}
+
+
+/* the scratch only grows: allocated - and first touched - by its worker */
+static int ensure_scratch(pf_exec_worker * w, size_t bytes)
+{
+    if (w->scratchBytes >= bytes)
+        return 1;
+    pffft_aligned_free(w->scratch);
+    w->scratch = (float*)pffft_aligned_malloc(bytes);
+    w->scratchBytes = w->scratch ? bytes : 0;
+    if (!w->scratch)
+        return 0;
+    memset(w->scratch, 0, bytes);
+    return 1;
+}
+
+
+#ifndef PF_EXECUTOR_NO_THREADS
+
+static int pin_self(int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) ? 0 : 1;
+#elif defined(_WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), ((DWORD_PTR)1) << cpu) ? 1 : 0;
+#else
+    (void)cpu;
+    return 0;
+#endif
+}
+
+
+/* take up to grain jobs from the front of the own range */
+static unsigned take_own(pf_exec_worker * w, unsigned grain, unsigned * first)
+{
+    uint64_t r = w->range.load(std::memory_order_acquire);
+    for (;;)
+    {
+        const unsigned b = (unsigned)(r >> 32), end = (unsigned)r;
+        if (b >= end)
+            return 0;
+        const unsigned n = std::min(grain, end - b);
+        if (w->range.compare_exchange_weak(r, pack_range(b + n, end), std::memory_order_acq_rel))
+        {
+            *first = b;
+            return n;
+        }
+    }
+}
+
+
+/* move the back half of another worker's range into the own - empty - range */
+static int steal(pf_executor * e, int self)
+{
+    const int T = (int)e->workers.size();
+    pf_exec_worker * w = &e->workers[self];
+    for (int off = 1; off < T; ++off)
+    {
+        pf_exec_worker * v = &e->workers[(self + off) % T];
+        uint64_t r = v->range.load(std::memory_order_acquire);
+        for (;;)
+        {
+            const unsigned b = (unsigned)(r >> 32), end = (unsigned)r;
+            if (b >= end)
+                break;
+            const unsigned n = (end - b + 1) / 2;
+            if (v->range.compare_exchange_weak(r, pack_range(b, end - n), std::memory_order_acq_rel))
+            {
+                w->range.store(pack_range(end - n, end), std::memory_order_release);
+                ++w->stats.steals;
+                w->stats.stolen_jobs += n;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+
+static void exec_worker(pf_executor * e, int self)
+{
+    pf_exec_worker * w = &e->workers[self];
+    unsigned first, n, k;
+
+    if (w->cpu >= 0)
+        w->stats.pinned = pin_self(w->cpu);
+    if (!ensure_scratch(w, e->needBytes))
+    {
+        // the others steal the range of this worker
+        e->failed.store(1);
+        return;
+    }
+    w->stats.scratch_bytes = (long long)w->scratchBytes;
+    for (;;)
+    {
+        while ((n = take_own(w, e->grain, &first)) != 0)
+        {
+            for (k = 0; k < n; ++k)
+                execute_job(&e->jobs[first + k], w->scratch);
+            w->stats.jobs += n;
+        }
+        if (!steal(e, self))
+            return;
+    }
+}
+
+#endif
+
+
+int pf_executor_run(pf_executor * e, const pf_exec_job_t * jobs, int numJobs, int grain)
+{
+    const int T = (int)e->workers.size();
+    int k, maxFloats = 0;
+
+    if (numJobs < 0 || (numJobs > 0 && !jobs))
+        return -1;
+    for (k = 0; k < numJobs; ++k)
+    {
+        const int f = job_scratch_floats(&jobs[k]);
+        if (f < 0)
+            return -1;
+        maxFloats = std::max(maxFloats, f);
+    }
+    e->jobs = jobs;
+    e->grain = (unsigned)std::max(1, grain);
+    e->needBytes = (size_t)maxFloats * sizeof(float);
+    e->failed.store(0);
+    for (k = 0; k < T; ++k)
+    {
+        pf_exec_worker & w = e->workers[k];
+        const unsigned b = (unsigned)((long long)numJobs * k / T);
+        const unsigned end = (unsigned)((long long)numJobs * (k + 1) / T);
+        w.range.store(pack_range(b, end), std::memory_order_relaxed);
+        memset(&w.stats, 0, sizeof(w.stats));
+    }
+
+#ifndef PF_EXECUTOR_NO_THREADS
+    {
+        std::vector<std::thread> threads;
+        int ret = 0;
+        threads.reserve(T);
+        try
+        {
+            for (k = 0; k < T; ++k)
+                threads.push_back(std::thread(exec_worker, e, k));
+        }
+        catch (...)
+        {
+            ret = -1;
+        }
+        for (k = 0; k < (int)threads.size(); ++k)
+            threads[k].join();
+        // a failed worker leaves its range - when all others are done before
+        for (k = 0; !ret && k < T; ++k)
+        {
+            const uint64_t r = e->workers[k].range.load();
+            if ((unsigned)(r >> 32) < (unsigned)r)
+                ret = -1;
+        }
+        return (ret || e->failed.load()) ? -1 : 0;
+    }
+#else
+    {
+        pf_exec_worker & w = e->workers[0];
+        if (!ensure_scratch(&w, e->needBytes))
+            return -1;
+        for (k = 0; k < numJobs; ++k)
+            execute_job(&jobs[k], w.scratch);
+        w.stats.jobs = numJobs;
+        w.stats.scratch_bytes = (long long)w.scratchBytes;
+        w.range.store(pack_range((unsigned)numJobs, (unsigned)numJobs));
+        return 0;
+    }
+#endif
+}
+
+
+int pf_executor_worker_stats(const pf_executor * e, int worker, pf_exec_stats_t * stats)
+{
+    if (worker < 0 || worker >= (int)e->workers.size())
+        return -1;
+    *stats = e->workers[worker].stats;
+    return 0;
+}
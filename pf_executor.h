@@ -0,0 +1,95 @@
+#pragma once
+
+/* pf_executor.h/.cpp executes long lists of independent jobs - transforms
+ * and fast convolutions of mixed sizes - on a set of worker threads:
+ *
+ * - the jobs only read their PFFFT_Setup: one setup is shared by all jobs
+ *   of its size, on all threads.
+ * - the job list is split into one contiguous range per worker. a worker
+ *   takes 'grain' jobs at a time from the front of its own range - when
+ *   it runs dry, it steals the back half of the range of another worker.
+ *   both are a single compare-and-swap: no locks, no queues.
+ * - each worker owns its scratch memory from pffft_aligned_malloc(), sized
+ *   for the largest job - so no job allocates, and no job runs with
+ *   work == NULL on the (small) stack of the thread. the worker allocates
+ *   and first touches its scratch itself, after pinning: with the usual
+ *   first-touch policy, the pages are local to the NUMA node of its cpu.
+ *   the scratch is kept for the next run - and only grows.
+ *
+ * without threads (compiled with PF_EXECUTOR_NO_THREADS), pf_executor_run()
+ * executes all jobs in the calling thread.
+ */
+
+#include "pffft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    PF_EXEC_TRANSFORM = 0,      /* pffft_transform() */
+    PF_EXEC_TRANSFORM_ORDERED,  /* pffft_transform_ordered() */
+    PF_EXEC_CONVOLVE            /* one block of fast convolution, see below */
+} pf_exec_job_type_t;
+
+/* input and output are aligned and sized as for pffft_transform() -
+ * except the input of PF_EXEC_CONVOLVE.
+ *
+ * PF_EXEC_CONVOLVE: the first inputLen floats of input[] - zero padded to
+ * the size of the transform - are transformed forward, multiplied with
+ * the unordered spectrum filter[] (see pffft_zconvolve_no_accu()) and
+ * 'scaling', and transformed backward into output[]: the circular
+ * convolution - which is the linear one, as long as inputLen and the
+ * length of the filter stay within the transform. inputLen counts floats:
+ * 2 per complex sample. not for Bluestein's sizes and not for 2D setups.
+ */
+typedef struct pf_exec_job_s
+{
+    pf_exec_job_type_t type;
+    PFFFT_Setup * setup;
+    const float * input;
+    float * output;
+    pffft_direction_t direction;    /* the transforms */
+    const float * filter;           /* PF_EXEC_CONVOLVE */
+    int inputLen;                   /* PF_EXEC_CONVOLVE */
+    float scaling;                  /* PF_EXEC_CONVOLVE */
+} pf_exec_job_t;
+
+typedef struct pf_executor pf_executor;
+
+/* numThreads <= 0 selects the number of hardware threads.
+ * with cpus != NULL, worker k is pinned to cpus[k]: a failure is only
+ * reported by pf_executor_worker_stats(). returns NULL on failure.
+ */
+pf_executor * pf_executor_new(int numThreads, const int * cpus);
+
+/* frees the scratch of the workers */
+void pf_executor_destroy(pf_executor * e);
+
+int pf_executor_num_threads(const pf_executor * e);
+
+/* execute jobs[0 .. numJobs-1] - in any order - and return when all are done.
+ * grain is the number of jobs a worker takes at once from its own range:
+ * <= 0 selects 1. larger values save atomic operations for tiny jobs.
+ * jobs must not write to memory read or written by other jobs.
+ * returns 0 - or -1 for an invalid job (before executing any), when the
+ * scratch couldn't be allocated or a thread couldn't be started.
+ */
+int pf_executor_run(pf_executor * e, const pf_exec_job_t * jobs, int numJobs, int grain);
+
+typedef struct pf_exec_stats_s
+{
+    long long jobs;         /* executed jobs */
+    long long steals;       /* successful steals from other workers */
+    long long stolen_jobs;  /* jobs obtained by these steals */
+    long long scratch_bytes;
+    int pinned;             /* 1 when pinned to the requested cpu */
+} pf_exec_stats_t;
+
+/* statistics of the last pf_executor_run(). returns -1 for an invalid worker */
+int pf_executor_worker_stats(const pf_executor * e, int worker, pf_exec_stats_t * stats);
+
+#ifdef __cplusplus
+}
+#endif
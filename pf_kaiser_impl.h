@@ -0,0 +1,48 @@
+#pragma once
+
+/* Kaiser window design for the FIR filters of pf_decim.cpp and
+ * pf_resample.cpp: the window, its beta for a stopband attenuation and the
+ * number of taps for a transition width.
+ *
+ * this file is only for library internal use
+ */
+
+#include <math.h>
+
+#include <algorithm>
+
+
+static inline double bessel_i0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    const double q = 0.25 * x * x;
+    for (int k = 1; k < 500 && term > 1E-14 * sum; ++k)
+    {
+        term *= q / ((double)k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+static inline double kaiser_beta(double A)
+{
+    if (A > 50.0)
+        return 0.1102 * (A - 8.7);
+    if (A > 21.0)
+        return 0.5842 * pow(A - 21.0, 0.4) + 0.07886 * (A - 21.0);
+    return 0.0;
+}
+
+/* number of taps for attenuation A (dB) and transition width dw (relative to the samplerate) */
+static inline int kaiser_len(double A, double dw)
+{
+    if (A > 21.0)
+        return (int)ceil((A - 7.95) / (14.36 * dw)) + 1;
+    return (int)ceil(0.9222 / dw) + 1;
+}
+
+static inline double kaiser_window(int n, int L, double beta)
+{
+    const double r = (L > 1) ? (2.0 * n / (L - 1) - 1.0) : 0.0;
+    return bessel_i0(beta * sqrt(std::max(0.0, 1.0 - r * r))) / bessel_i0(beta);
+}
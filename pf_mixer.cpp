@@ -35,6 +35,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <math.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
 
 //they dropped M_PI in C99, so we define it:
 #define PI ((float)3.14159265358979323846)
@@ -71,17 +75,32 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #if (defined(__x86_64__) || defined(_M_X64) || defined(i386) || defined(_M_IX86))
   #pragma message("Manual SSE x86/x64 optimizations are ON")
   #include <xmmintrin.h>
+  #include <emmintrin.h>
   #define HAVE_SSE_INTRINSICS 1
   
-#elif defined(PFFFT_ENABLE_NEON) && defined(__arm__)
+  #if defined(__GNUC__)
+    #include <immintrin.h>
+    #include <cpuid.h>
+    #define HAVE_AVX_INTRINSICS 1
+    #define PF_TARGET_AVX_FMA  __attribute__((target("avx,fma")))
+  #elif defined(_MSC_VER)
+    #include <immintrin.h>
+    #include <intrin.h>
+    #define HAVE_AVX_INTRINSICS 1
+    #define PF_TARGET_AVX_FMA
+  #endif
+
+#elif (defined(PFFFT_ENABLE_NEON) || defined(__ARM_NEON)) && defined(__arm__)
   #pragma message "Manual NEON (arm32) optimizations are ON"
   #include "sse2neon.h"
   #define HAVE_SSE_INTRINSICS 1
+  #define HAVE_NEON_INTRINSICS 1
   
-#elif defined(PFFFT_ENABLE_NEON) && defined(__aarch64__)
+#elif (defined(PFFFT_ENABLE_NEON) || defined(__ARM_NEON)) && defined(__aarch64__)
   #pragma message "Manual NEON (aarch64) optimizations are ON"
   #include "sse2neon.h"
   #define HAVE_SSE_INTRINSICS 1
+  #define HAVE_NEON_INTRINSICS 1
 
 #endif
 #endif
@@ -145,7 +164,7 @@ float shift_math_cc(const complexf *input, complexf* output, int input_size, flo
     //Shifts the complex spectrum. Basically a complex mixer. This version uses cmath.
     float phase=starting_phase;
     float phase_increment=rate*PI;
-    float cosval, sinval;
+    float cosval, sinval, inp_i, inp_q;
     for(int i=0;i<input_size; i++)
     {
         cosval=cosf(phase);
@@ -153,8 +172,11 @@ float shift_math_cc(const complexf *input, complexf* output, int input_size, flo
         //we multiply two complex numbers.
         //how? enter this to maxima (software) for explanation:
         //   (a+b*%i)*(c+d*%i), rectform;
-        iof(output,i)=cosval*iof(input,i)-sinval*qof(input,i);
-        qof(output,i)=sinval*iof(input,i)+cosval*qof(input,i);
+        // read input first: output might be input - for in-place use
+        inp_i=iof(input,i);
+        inp_q=qof(input,i);
+        iof(output,i)=cosval*inp_i-sinval*inp_q;
+        qof(output,i)=sinval*inp_i+cosval*inp_q;
         phase+=phase_increment;
         while(phase>2*PI) phase-=2*PI; //@shift_math_cc: normalize phase
         while(phase<0) phase+=2*PI;
@@ -499,8 +521,8 @@ void shift_limited_unroll_inp_c(complexf* in_out, int N_cplx, shift_limited_unro
         cos_start = cos_val;
         sin_start = sin_val;
 
-        in_out += PF_SHIFT_LIMITED_UNROLL_SIZE;
-        N_cplx -= PF_SHIFT_LIMITED_UNROLL_SIZE;
+        in_out += N;
+        N_cplx -= N;
     }
     // "phase_state := starts"
     d->complex_phase.i = cos_start;
@@ -1146,3 +1168,797 @@ void shift_recursive_osc_sse_inp_c(complexf* in_out,
 
 #endif
 
+
+/*********************************************************************/
+
+#ifdef HAVE_AVX_INTRINSICS
+
+/* the CPU - and the OS, saving the ymm registers - support AVX and FMA?
+ * PFFFT_ARCH=sse2 switches to the SSE variants - as in pffft_dispatch_impl.h */
+static int detect_avx_fma()
+{
+    unsigned ecx, xcr0;
+    const char *env = getenv("PFFFT_ARCH");
+    if (env && !strcmp(env, "sse2"))
+        return 0;
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    ecx = (unsigned)regs[2];
+    if ( (ecx & (1U << 27)) == 0 )  /* OSXSAVE */
+        return 0;
+    xcr0 = (unsigned)_xgetbv(0);
+#else
+    unsigned eax, ebx, edx;
+    __cpuid_count(1, 0, eax, ebx, ecx, edx);
+    if ( (ecx & (1U << 27)) == 0 )  /* OSXSAVE */
+        return 0;
+    __asm__ __volatile__ ("xgetbv" : "=a"(xcr0), "=d"(edx) : "c"(0));
+#endif
+    if ( (ecx & (1U << 28)) == 0 || (xcr0 & 0x06) != 0x06 )  /* AVX, XMM+YMM state */
+        return 0;
+    return (ecx & (1U << 12)) ? 1 : 0;  /* FMA */
+}
+
+int have_avx_shift_mixer_impl()
+{
+    static int avx = -1;
+    if (avx < 0)
+        avx = detect_avx_fma();
+    return avx;
+}
+
+/* a pair of __m256 from UNINTERLEAVE2_AVX() holds the complex values 0..7
+ * in the order 0, 1, 4, 5, 2, 3, 6, 7: the lane-wise shuffles avoid any cross-lane permutation.
+ * INTERLEAVE2_AVX() restores the original order.
+ */
+#define UNINTERLEAVE2_AVX(in1, in2, out1, out2) { __m256 tmp__ = _mm256_shuffle_ps(in1, in2, _MM_SHUFFLE(2,0,2,0)); out2 = _mm256_shuffle_ps(in1, in2, _MM_SHUFFLE(3,1,3,1)); out1 = tmp__; }
+#define INTERLEAVE2_AVX(in1, in2, out1, out2) { __m256 tmp__ = _mm256_unpacklo_ps(in1, in2); out2 = _mm256_unpackhi_ps(in1, in2); out1 = tmp__; }
+
+/* load/store 8 floats of the natural order - in the lane order of UNINTERLEAVE2_AVX() */
+#define LOAD_AVX_ORDER(p)  _mm256_setr_ps((p)[0], (p)[1], (p)[4], (p)[5], (p)[2], (p)[3], (p)[6], (p)[7])
+
+PF_TARGET_AVX_FMA
+static void store_avx_order(float *p, __m256 v)
+{
+    float t[8];
+    _mm256_storeu_ps(t, v);
+    p[0] = t[0];  p[1] = t[1];  p[4] = t[2];  p[5] = t[3];
+    p[2] = t[4];  p[3] = t[5];  p[6] = t[6];  p[7] = t[7];
+}
+
+
+/**************/
+/*** ALGO K ***/
+/**************/
+
+shift_limited_unroll_avx_data_t shift_limited_unroll_avx_init(float relative_freq, float phase_start_rad)
+{
+    shift_limited_unroll_avx_data_t output;
+    float myphase;
+
+    output.phase_increment = 2*relative_freq*PI;
+
+    myphase = 0.0F;
+    for (int i = 0; i < PF_SHIFT_LIMITED_UNROLL_SIZE + PF_SHIFT_LIMITED_SIMD_AVX_SZ; i += PF_SHIFT_LIMITED_SIMD_AVX_SZ)
+    {
+        for (int k = 0; k < PF_SHIFT_LIMITED_SIMD_AVX_SZ; k++)
+        {
+            myphase += output.phase_increment;
+            while(myphase>PI) myphase-=2*PI;
+            while(myphase<-PI) myphase+=2*PI;
+        }
+        for (int k = 0; k < PF_SHIFT_LIMITED_SIMD_AVX_SZ; k++)
+        {
+            output.dinterl_trig[2*i+k] = cosf(myphase);
+            output.dinterl_trig[2*i+k+PF_SHIFT_LIMITED_SIMD_AVX_SZ] = sinf(myphase);
+        }
+    }
+
+    myphase = phase_start_rad;
+    for (int i = 0; i < PF_SHIFT_LIMITED_SIMD_AVX_SZ; i++)
+    {
+        output.phase_state_i[i] = cosf(myphase);
+        output.phase_state_q[i] = sinf(myphase);
+        myphase += output.phase_increment;
+        while(myphase>PI) myphase-=2*PI;
+        while(myphase<-PI) myphase+=2*PI;
+    }
+    return output;
+}
+
+
+PF_TARGET_AVX_FMA
+void shift_limited_unroll_avx_inp_c(complexf* in_out, int N_cplx, shift_limited_unroll_avx_data_t* d)
+{
+    // "vals := starts := phase_state"
+    __m256 cos_starts = LOAD_AVX_ORDER( &d->phase_state_i[0] );
+    __m256 sin_starts = LOAD_AVX_ORDER( &d->phase_state_q[0] );
+    __m256 cos_vals = cos_starts;
+    __m256 sin_vals = sin_starts;
+    __m256 inp_re, inp_im;
+    __m256 product_re, product_im;
+    __m256 interl_prod_a, interl_prod_b;
+    const float * RESTRICT p_trig_tab;
+    float * RESTRICT u = (float*)in_out;
+
+    while (N_cplx)
+    {
+        const int NB = (N_cplx >= PF_SHIFT_LIMITED_UNROLL_SIZE) ? PF_SHIFT_LIMITED_UNROLL_SIZE : N_cplx;
+        int B = NB;
+        p_trig_tab = &d->dinterl_trig[0];
+        while (B)
+        {
+            // complex multiplication of 8 complex values from/to in_out[]: "out[] = inp[] * vals"
+            UNINTERLEAVE2_AVX(_mm256_loadu_ps(u), _mm256_loadu_ps(u+8), inp_re, inp_im);
+            product_re = _mm256_fmsub_ps( inp_re, cos_vals, _mm256_mul_ps(inp_im, sin_vals) );
+            product_im = _mm256_fmadd_ps( inp_im, cos_vals, _mm256_mul_ps(inp_re, sin_vals) );
+            INTERLEAVE2_AVX( product_re, product_im, interl_prod_a, interl_prod_b);
+            _mm256_storeu_ps(u, interl_prod_a);
+            _mm256_storeu_ps(u+8, interl_prod_b);
+            u += 16;
+            // "vals :=  d[] * starts"
+            inp_re = _mm256_loadu_ps(p_trig_tab);
+            inp_im = _mm256_loadu_ps(p_trig_tab+8);
+            cos_vals = _mm256_fmsub_ps( inp_re, cos_starts, _mm256_mul_ps(inp_im, sin_starts) );
+            sin_vals = _mm256_fmadd_ps( inp_im, cos_starts, _mm256_mul_ps(inp_re, sin_starts) );
+            p_trig_tab += 16;
+            B -= 8;
+        }
+        N_cplx -= NB;
+        // "starts := vals := vals / |vals|"
+        product_re = _mm256_fmadd_ps( cos_vals, cos_vals, _mm256_mul_ps(sin_vals, sin_vals) );
+        product_im = _mm256_sqrt_ps(product_re);
+        cos_starts = cos_vals = _mm256_div_ps(cos_vals, product_im);
+        sin_starts = sin_vals = _mm256_div_ps(sin_vals, product_im);
+    }
+    // "phase_state := starts"
+    store_avx_order( &d->phase_state_i[0], cos_starts );
+    store_avx_order( &d->phase_state_q[0], sin_starts );
+}
+
+
+/**************/
+/*** ALGO L ***/
+/**************/
+
+PF_TARGET_AVX_FMA
+void shift_recursive_osc_avx_inp_c(complexf* in_out,
+    int N_cplx, const shift_recursive_osc_conf_t *conf, shift_recursive_osc_t* state_ext)
+{
+    const __m256 k1 = _mm256_set1_ps( conf->k1 );
+    const __m256 k2 = _mm256_set1_ps( conf->k2 );
+    __m256 u_cos = LOAD_AVX_ORDER( &state_ext->u_cos[0] );
+    __m256 v_sin = LOAD_AVX_ORDER( &state_ext->v_sin[0] );
+    __m256 inp_re, inp_im;
+    __m256 product_re, product_im;
+    __m256 interl_prod_a, interl_prod_b;
+    float * RESTRICT u = (float*)in_out;
+
+    while (N_cplx)
+    {
+        UNINTERLEAVE2_AVX(_mm256_loadu_ps(u), _mm256_loadu_ps(u+8), inp_re, inp_im);
+        product_re = _mm256_fmsub_ps( inp_re, u_cos, _mm256_mul_ps(inp_im, v_sin) );
+        product_im = _mm256_fmadd_ps( inp_im, u_cos, _mm256_mul_ps(inp_re, v_sin) );
+        INTERLEAVE2_AVX( product_re, product_im, interl_prod_a, interl_prod_b);
+        _mm256_storeu_ps(u, interl_prod_a);
+        _mm256_storeu_ps(u+8, interl_prod_b);
+        u += 16;
+
+        // update complex phasor - like incrementing phase
+        // tmp[j] = state.u_cos[j] - k1 * state.v_sin[j];
+        product_re = _mm256_fnmadd_ps( k1, v_sin, u_cos );
+        // state.v_sin[j] += k2 * tmp[j];
+        v_sin = _mm256_fmadd_ps( k2, product_re, v_sin );
+        // state.u_cos[j] = tmp[j] - k1 * state.v_sin[j];
+        u_cos = _mm256_fnmadd_ps( k1, v_sin, product_re );
+
+        N_cplx -= 8;
+    }
+    store_avx_order( &state_ext->u_cos[0], u_cos );
+    store_avx_order( &state_ext->v_sin[0], v_sin );
+}
+
+#else
+
+int have_avx_shift_mixer_impl()
+{
+    return 0;
+}
+
+shift_limited_unroll_avx_data_t shift_limited_unroll_avx_init(float relative_freq, float phase_start_rad) {
+    (void)relative_freq; (void)phase_start_rad;
+    assert(0);
+    shift_limited_unroll_avx_data_t r;
+    return r;
+}
+
+void shift_limited_unroll_avx_inp_c(complexf* in_out, int N_cplx, shift_limited_unroll_avx_data_t* d) {
+    (void)in_out; (void)N_cplx; (void)d;
+    assert(0);
+}
+
+void shift_recursive_osc_avx_inp_c(complexf* in_out,
+    int N_cplx, const shift_recursive_osc_conf_t *conf, shift_recursive_osc_t* state_ext)
+{
+    (void)in_out; (void)N_cplx; (void)conf; (void)state_ext;
+    assert(0);
+}
+
+#endif
+
+
+/*********************************************************************/
+
+#ifdef HAVE_NEON_INTRINSICS
+
+int have_neon_shift_mixer_impl()
+{
+    return 1;
+}
+
+#if defined(__aarch64__)
+#  define VMADD_NEON(a, b, c)   vfmaq_f32(a, b, c)  /* a + b * c */
+#  define VMSUB_NEON(a, b, c)   vfmsq_f32(a, b, c)  /* a - b * c */
+#else
+#  define VMADD_NEON(a, b, c)   vmlaq_f32(a, b, c)
+#  define VMSUB_NEON(a, b, c)   vmlsq_f32(a, b, c)
+#endif
+
+/**************/
+/*** ALGO M ***/
+/**************/
+
+void shift_limited_unroll_C_neon_inp_c(complexf* in_out, int N_cplx, shift_limited_unroll_C_sse_data_t* d)
+{
+    // "vals := starts := phase_state"
+    float32x4_t cos_starts = vld1q_f32( &d->phase_state_i[0] );
+    float32x4_t sin_starts = vld1q_f32( &d->phase_state_q[0] );
+    float32x4_t cos_vals = cos_starts;
+    float32x4_t sin_vals = sin_starts;
+    float32x4_t trig_cos, trig_sin, mag, rsq;
+    float32x4x2_t inp, prod;
+    const float * RESTRICT p_trig_tab;
+    float * RESTRICT u = (float*)in_out;
+
+    while (N_cplx)
+    {
+        const int NB = (N_cplx >= PF_SHIFT_LIMITED_UNROLL_SIZE) ? PF_SHIFT_LIMITED_UNROLL_SIZE : N_cplx;
+        int B = NB;
+        p_trig_tab = &d->dinterl_trig[0];
+        while (B)
+        {
+            // vld2q/vst2q (un)interleave real and imag parts
+            inp = vld2q_f32(u);
+            prod.val[0] = VMSUB_NEON( vmulq_f32(inp.val[0], cos_vals), inp.val[1], sin_vals );
+            prod.val[1] = VMADD_NEON( vmulq_f32(inp.val[1], cos_vals), inp.val[0], sin_vals );
+            vst2q_f32(u, prod);
+            u += 8;
+            // "vals :=  d[] * starts"
+            trig_cos = vld1q_f32(p_trig_tab);
+            trig_sin = vld1q_f32(p_trig_tab+4);
+            cos_vals = VMSUB_NEON( vmulq_f32(trig_cos, cos_starts), trig_sin, sin_starts );
+            sin_vals = VMADD_NEON( vmulq_f32(trig_sin, cos_starts), trig_cos, sin_starts );
+            p_trig_tab += 8;
+            B -= 4;
+        }
+        N_cplx -= NB;
+        // "starts := vals := vals / |vals|": reciprocal square root estimate with 2 Newton-Raphson steps
+        mag = VMADD_NEON( vmulq_f32(cos_vals, cos_vals), sin_vals, sin_vals );
+        rsq = vrsqrteq_f32(mag);
+        rsq = vmulq_f32( rsq, vrsqrtsq_f32(vmulq_f32(mag, rsq), rsq) );
+        rsq = vmulq_f32( rsq, vrsqrtsq_f32(vmulq_f32(mag, rsq), rsq) );
+        cos_starts = cos_vals = vmulq_f32(cos_vals, rsq);
+        sin_starts = sin_vals = vmulq_f32(sin_vals, rsq);
+    }
+    // "phase_state := starts"
+    vst1q_f32( &d->phase_state_i[0], cos_starts );
+    vst1q_f32( &d->phase_state_q[0], sin_starts );
+}
+
+
+/**************/
+/*** ALGO N ***/
+/**************/
+
+void shift_recursive_osc_neon_inp_c(complexf* in_out,
+    int N_cplx, const shift_recursive_osc_sse_conf_t *conf, shift_recursive_osc_sse_t* state_ext)
+{
+    const float32x4_t k1 = vdupq_n_f32( conf->k1 );
+    const float32x4_t k2 = vdupq_n_f32( conf->k2 );
+    float32x4_t u_cos = vld1q_f32( &state_ext->u_cos[0] );
+    float32x4_t v_sin = vld1q_f32( &state_ext->v_sin[0] );
+    float32x4_t tmp;
+    float32x4x2_t inp, prod;
+    float * RESTRICT u = (float*)in_out;
+
+    while (N_cplx)
+    {
+        inp = vld2q_f32(u);
+        prod.val[0] = VMSUB_NEON( vmulq_f32(inp.val[0], u_cos), inp.val[1], v_sin );
+        prod.val[1] = VMADD_NEON( vmulq_f32(inp.val[1], u_cos), inp.val[0], v_sin );
+        vst2q_f32(u, prod);
+        u += 8;
+
+        // update complex phasor - like incrementing phase
+        tmp = VMSUB_NEON( u_cos, k1, v_sin );
+        v_sin = VMADD_NEON( v_sin, k2, tmp );
+        u_cos = VMSUB_NEON( tmp, k1, v_sin );
+
+        N_cplx -= 4;
+    }
+    vst1q_f32( &state_ext->u_cos[0], u_cos );
+    vst1q_f32( &state_ext->v_sin[0], v_sin );
+}
+
+#else
+
+int have_neon_shift_mixer_impl()
+{
+    return 0;
+}
+
+void shift_limited_unroll_C_neon_inp_c(complexf* in_out, int N_cplx, shift_limited_unroll_C_sse_data_t* d) {
+    (void)in_out; (void)N_cplx; (void)d;
+    assert(0);
+}
+
+void shift_recursive_osc_neon_inp_c(complexf* in_out,
+    int N_cplx, const shift_recursive_osc_sse_conf_t *conf, shift_recursive_osc_sse_t* state_ext)
+{
+    (void)in_out; (void)N_cplx; (void)conf; (void)state_ext;
+    assert(0);
+}
+
+#endif
+
+
+/*********************************************************************/
+
+/**************/
+/*** ALGO O ***/
+/**************/
+
+#define NCO_TABLE_SIZE   (1 << PF_SHIFT_NCO_TABLE_BITS)
+#define NCO_FRAC_BITS    (32 - PF_SHIFT_NCO_TABLE_BITS)
+#define NCO_FRAC_MASK    ((1 << NCO_FRAC_BITS) - 1)
+#define NCO_FRAC_SCALE   (1.0F / (float)(1 << NCO_FRAC_BITS))
+
+/* entry k: cos, sin - and the slopes to entry k+1. the chords between the
+ * entries lie inside the unit circle: all values are scaled by half of the
+ * maximum deviation, which halves the amplitude error.
+ */
+struct shift_nco_table
+{
+    alignas(16) float e[NCO_TABLE_SIZE][4];
+
+    shift_nco_table()
+    {
+        const double w = 2.0 * 3.14159265358979323846 / NCO_TABLE_SIZE;
+        const double amp = 1.0 + 0.5 * (1.0 - cos(0.5 * w));
+        for (int k = 0; k < NCO_TABLE_SIZE; ++k)
+        {
+            e[k][0] = (float)(amp * cos(w * k));
+            e[k][1] = (float)(amp * sin(w * k));
+            e[k][2] = (float)(amp * (cos(w * (k + 1)) - cos(w * k)));
+            e[k][3] = (float)(amp * (sin(w * (k + 1)) - sin(w * k)));
+        }
+    }
+};
+
+static const shift_nco_table & nco_table()
+{
+    static const shift_nco_table t;   // thread-safe initialization
+    return t;
+}
+
+/* full cycles, modulo 1, to the 64 bit phase */
+static uint64_t nco_cycles_to_phase(double cycles)
+{
+    const double f = ldexp(cycles - floor(cycles), 64);
+    return (f >= 18446744073709551616.0) ? 0 : (uint64_t)f;
+}
+
+uint64_t shift_nco_phase_inc(double relative_freq)
+{
+    return nco_cycles_to_phase(relative_freq);
+}
+
+shift_nco_t shift_nco_init(double relative_freq, double phase_start_rad)
+{
+    shift_nco_t d;
+    d.phase = nco_cycles_to_phase(phase_start_rad / (2.0 * 3.14159265358979323846));
+    d.phase_inc = nco_cycles_to_phase(relative_freq);
+    return d;
+}
+
+void shift_nco_update_freq(shift_nco_t *d, double relative_freq)
+{
+    d->phase_inc = nco_cycles_to_phase(relative_freq);
+}
+
+static ALWAYS_INLINE(void) nco_trig(const shift_nco_table & t, uint64_t phase, float gain, float &c, float &s)
+{
+    const uint32_t hi = (uint32_t)(phase >> 32);
+    const float * e = t.e[hi >> NCO_FRAC_BITS];
+    const float frac = (float)(hi & NCO_FRAC_MASK) * NCO_FRAC_SCALE;
+    c = gain * (e[0] + frac * e[2]);
+    s = gain * (e[1] + frac * e[3]);
+}
+
+#ifdef HAVE_SSE_INTRINSICS
+
+/* the phases of 4 successive samples: 64 bit lanes, exactly as the scalar phase */
+struct nco_sse_phases
+{
+    __m128i ph01, ph23, step;
+
+    explicit nco_sse_phases(const shift_nco_t *d)
+    {
+        const uint64_t p[4] = { d->phase, d->phase + d->phase_inc,
+                                d->phase + 2 * d->phase_inc, d->phase + 3 * d->phase_inc };
+        const uint64_t inc4[2] = { 4 * d->phase_inc, 4 * d->phase_inc };
+        ph01 = _mm_loadu_si128((const __m128i*)&p[0]);
+        ph23 = _mm_loadu_si128((const __m128i*)&p[2]);
+        step = _mm_loadu_si128((const __m128i*)&inc4[0]);
+    }
+
+    void next()
+    {
+        ph01 = _mm_add_epi64(ph01, step);
+        ph23 = _mm_add_epi64(ph23, step);
+    }
+};
+
+/* cos/sin of 4 samples: the upper 32 bits of each phase index the table,
+ * the 4 entries are transposed into cos, sin and the slopes - no gather needed */
+static ALWAYS_INLINE(void) nco_trig_sse(const shift_nco_table & t, const nco_sse_phases & p, __m128 gain, __m128 &c, __m128 &s)
+{
+    const __m128i hi = _mm_castps_si128( _mm_shuffle_ps(_mm_castsi128_ps(p.ph01), _mm_castsi128_ps(p.ph23), _MM_SHUFFLE(3,1,3,1)) );
+    const __m128 frac = _mm_mul_ps( _mm_cvtepi32_ps( _mm_and_si128(hi, _mm_set1_epi32(NCO_FRAC_MASK)) ), _mm_set1_ps(NCO_FRAC_SCALE) );
+    union { __m128i v; int32_t i[4]; } idx;
+    idx.v = _mm_srli_epi32(hi, NCO_FRAC_BITS);
+    __m128 e0 = _mm_load_ps(t.e[idx.i[0]]);
+    __m128 e1 = _mm_load_ps(t.e[idx.i[1]]);
+    __m128 e2 = _mm_load_ps(t.e[idx.i[2]]);
+    __m128 e3 = _mm_load_ps(t.e[idx.i[3]]);
+    _MM_TRANSPOSE4_PS(e0, e1, e2, e3);
+    c = _mm_mul_ps( gain, _mm_add_ps(e0, _mm_mul_ps(frac, e2)) );
+    s = _mm_mul_ps( gain, _mm_add_ps(e1, _mm_mul_ps(frac, e3)) );
+}
+
+#endif
+
+void shift_nco_cc(const complexf *input, complexf* output, int N_cplx, shift_nco_t *d)
+{
+    const shift_nco_table & t = nco_table();
+    const float * in = (const float*)input;
+    float * out = (float*)output;
+    uint64_t phase;
+    int k = 0;
+
+#ifdef HAVE_SSE_INTRINSICS
+    nco_sse_phases p(d);
+    const __m128 one = _mm_set1_ps(1.0F);
+    for (; k + 4 <= N_cplx; k += 4)
+    {
+        __m128 c, s, re, im, a, b;
+        nco_trig_sse(t, p, one, c, s);
+        UNINTERLEAVE2(VLOAD(in + 2 * k), VLOAD(in + 2 * k + 4), re, im);
+        a = VSUB(VMUL(re, c), VMUL(im, s));
+        b = VADD(VMUL(re, s), VMUL(im, c));
+        INTERLEAVE2(a, b, re, im);
+        VSTORE(out + 2 * k, re);
+        VSTORE(out + 2 * k + 4, im);
+        p.next();
+    }
+#endif
+    phase = d->phase + (uint64_t)k * d->phase_inc;
+    for (; k < N_cplx; ++k)
+    {
+        float c, s;
+        const float re = in[2 * k], im = in[2 * k + 1];
+        nco_trig(t, phase, 1.0F, c, s);
+        out[2 * k] = re * c - im * s;
+        out[2 * k + 1] = re * s + im * c;
+        phase += d->phase_inc;
+    }
+    d->phase = phase;
+}
+
+void shift_nco_inp_c(complexf* in_out, int N_cplx, shift_nco_t *d)
+{
+    shift_nco_cc(in_out, in_out, N_cplx, d);
+}
+
+void shift_nco_cs16_c(const int16_t *input, complexf* output, int N_cplx, float gain, shift_nco_t *d)
+{
+    const shift_nco_table & t = nco_table();
+    float * out = (float*)output;
+    uint64_t phase;
+    int k = 0;
+
+#ifdef HAVE_SSE_INTRINSICS
+    nco_sse_phases p(d);
+    const __m128 vgain = _mm_set1_ps(gain);
+    for (; k + 4 <= N_cplx; k += 4)
+    {
+        __m128 c, s, re, im, a, b;
+        // sign extend the 4 I/Q pairs to 32 bit
+        const __m128i x = _mm_loadu_si128((const __m128i*)(input + 2 * k));
+        const __m128 lo = _mm_cvtepi32_ps( _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16) );
+        const __m128 hi = _mm_cvtepi32_ps( _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16) );
+        nco_trig_sse(t, p, vgain, c, s);
+        UNINTERLEAVE2(lo, hi, re, im);
+        a = VSUB(VMUL(re, c), VMUL(im, s));
+        b = VADD(VMUL(re, s), VMUL(im, c));
+        INTERLEAVE2(a, b, re, im);
+        VSTORE(out + 2 * k, re);
+        VSTORE(out + 2 * k + 4, im);
+        p.next();
+    }
+#endif
+    phase = d->phase + (uint64_t)k * d->phase_inc;
+    for (; k < N_cplx; ++k)
+    {
+        float c, s;
+        const float re = (float)input[2 * k], im = (float)input[2 * k + 1];
+        nco_trig(t, phase, gain, c, s);
+        out[2 * k] = re * c - im * s;
+        out[2 * k + 1] = re * s + im * c;
+        phase += d->phase_inc;
+    }
+    d->phase = phase;
+}
+
+
+/*********************************************************************/
+
+/*****************************/
+/*** runtime selected mixer ***/
+/*****************************/
+
+static const char * const shift_mixer_names[PF_MIXER_NUM_ALGOS] = {
+    "math", "addfast", "limited_unroll",
+    "limited_unroll_A_sse", "limited_unroll_B_sse", "limited_unroll_C_sse",
+    "recursive_osc", "recursive_osc_sse",
+    "limited_unroll_avx", "recursive_osc_avx",
+    "limited_unroll_C_neon", "recursive_osc_neon",
+    "nco"
+};
+
+static const int shift_mixer_simd_sizes[PF_MIXER_NUM_ALGOS] = {
+    1, 4, PF_SHIFT_LIMITED_SIMD_SZ,
+    PF_SHIFT_LIMITED_SIMD_SZ, PF_SHIFT_LIMITED_SIMD_SZ, PF_SHIFT_LIMITED_SIMD_SZ,
+    PF_SHIFT_RECURSIVE_SIMD_SZ, PF_SHIFT_RECURSIVE_SIMD_SSE_SZ,
+    PF_SHIFT_LIMITED_SIMD_AVX_SZ, PF_SHIFT_RECURSIVE_SIMD_SZ,
+    PF_SHIFT_LIMITED_SIMD_SZ, PF_SHIFT_RECURSIVE_SIMD_SSE_SZ,
+    1
+};
+
+const char * shift_mixer_name(int algo)
+{
+    if (algo < 0 || algo >= PF_MIXER_NUM_ALGOS)
+        return "invalid";
+    return shift_mixer_names[algo];
+}
+
+int shift_mixer_available(int algo, int block_len)
+{
+    int compiled;
+    switch (algo)
+    {
+    case PF_MIXER_MATH:
+    case PF_MIXER_ADDFAST:
+    case PF_MIXER_LIMITED_UNROLL:
+    case PF_MIXER_RECURSIVE_OSC:
+    case PF_MIXER_NCO:
+        compiled = 1;
+        break;
+    case PF_MIXER_LIMITED_UNROLL_A_SSE:
+    case PF_MIXER_LIMITED_UNROLL_B_SSE:
+    case PF_MIXER_LIMITED_UNROLL_C_SSE:
+    case PF_MIXER_RECURSIVE_OSC_SSE:
+        compiled = have_sse_shift_mixer_impl();
+        break;
+    case PF_MIXER_LIMITED_UNROLL_AVX:
+    case PF_MIXER_RECURSIVE_OSC_AVX:
+        compiled = have_avx_shift_mixer_impl();
+        break;
+    case PF_MIXER_LIMITED_UNROLL_C_NEON:
+    case PF_MIXER_RECURSIVE_OSC_NEON:
+        compiled = have_neon_shift_mixer_impl();
+        break;
+    default:
+        return 0;
+    }
+    return ( compiled && block_len > 0 && (block_len % shift_mixer_simd_sizes[algo]) == 0 ) ? 1 : 0;
+}
+
+
+/* prepare the state of algo - without any check or measurement */
+static void shift_mixer_setup(shift_mixer_t *m, int algo, float relative_freq, float phase_start_rad)
+{
+    m->algo = algo;
+    m->simd_size = shift_mixer_simd_sizes[algo];
+    m->relative_freq = relative_freq;
+    m->phase = phase_start_rad;
+    m->phase_error = -1.0F;
+    m->samples_per_sec = 0.0;
+    switch (algo)
+    {
+    case PF_MIXER_MATH:
+        break;
+    case PF_MIXER_ADDFAST:
+        m->d.addfast = shift_addfast_init(relative_freq);
+        // shift_addfast_*() applies starting_phase + increment to the first sample
+        m->phase = phase_start_rad - m->d.addfast.phase_increment;
+        break;
+    case PF_MIXER_LIMITED_UNROLL:
+        m->d.limited = shift_limited_unroll_init(relative_freq);
+        m->d.limited.complex_phase.i = cosf(phase_start_rad);
+        m->d.limited.complex_phase.q = sinf(phase_start_rad);
+        break;
+    case PF_MIXER_LIMITED_UNROLL_A_SSE:
+        m->d.limited_A_sse = shift_limited_unroll_A_sse_init(relative_freq, phase_start_rad);
+        break;
+    case PF_MIXER_LIMITED_UNROLL_B_SSE:
+        m->d.limited_B_sse = shift_limited_unroll_B_sse_init(relative_freq, phase_start_rad);
+        break;
+    case PF_MIXER_LIMITED_UNROLL_C_SSE:
+    case PF_MIXER_LIMITED_UNROLL_C_NEON:
+        m->d.limited_C_sse = shift_limited_unroll_C_sse_init(relative_freq, phase_start_rad);
+        break;
+    case PF_MIXER_RECURSIVE_OSC:
+    case PF_MIXER_RECURSIVE_OSC_AVX:
+        // the recursive_osc 'rate' is relative to samplerate/2
+        shift_recursive_osc_init(2.0F * relative_freq, phase_start_rad, &m->d.rec.conf, &m->d.rec.state);
+        break;
+    case PF_MIXER_RECURSIVE_OSC_SSE:
+    case PF_MIXER_RECURSIVE_OSC_NEON:
+        shift_recursive_osc_sse_init(2.0F * relative_freq, phase_start_rad, &m->d.rec_sse.conf, &m->d.rec_sse.state);
+        break;
+    case PF_MIXER_LIMITED_UNROLL_AVX:
+        m->d.limited_avx = shift_limited_unroll_avx_init(relative_freq, phase_start_rad);
+        break;
+    case PF_MIXER_NCO:
+        m->d.nco = shift_nco_init(relative_freq, phase_start_rad);
+        break;
+    }
+}
+
+
+void shift_mixer_inp_c(shift_mixer_t *m, complexf* in_out, int N_cplx)
+{
+    assert( (N_cplx % m->simd_size) == 0 );
+    switch (m->algo)
+    {
+    case PF_MIXER_MATH:
+        m->phase = shift_math_cc(in_out, in_out, N_cplx, m->relative_freq, m->phase);
+        break;
+    case PF_MIXER_ADDFAST:
+        m->phase = shift_addfast_inp_c(in_out, N_cplx, &m->d.addfast, m->phase);
+        break;
+    case PF_MIXER_LIMITED_UNROLL:
+        shift_limited_unroll_inp_c(in_out, N_cplx, &m->d.limited);
+        break;
+    case PF_MIXER_LIMITED_UNROLL_A_SSE:
+        shift_limited_unroll_A_sse_inp_c(in_out, N_cplx, &m->d.limited_A_sse);
+        break;
+    case PF_MIXER_LIMITED_UNROLL_B_SSE:
+        shift_limited_unroll_B_sse_inp_c(in_out, N_cplx, &m->d.limited_B_sse);
+        break;
+    case PF_MIXER_LIMITED_UNROLL_C_SSE:
+        shift_limited_unroll_C_sse_inp_c(in_out, N_cplx, &m->d.limited_C_sse);
+        break;
+    case PF_MIXER_RECURSIVE_OSC:
+        shift_recursive_osc_inp_c(in_out, N_cplx, &m->d.rec.conf, &m->d.rec.state);
+        break;
+    case PF_MIXER_RECURSIVE_OSC_SSE:
+        shift_recursive_osc_sse_inp_c(in_out, N_cplx, &m->d.rec_sse.conf, &m->d.rec_sse.state);
+        break;
+    case PF_MIXER_LIMITED_UNROLL_AVX:
+        shift_limited_unroll_avx_inp_c(in_out, N_cplx, &m->d.limited_avx);
+        break;
+    case PF_MIXER_RECURSIVE_OSC_AVX:
+        shift_recursive_osc_avx_inp_c(in_out, N_cplx, &m->d.rec.conf, &m->d.rec.state);
+        break;
+    case PF_MIXER_LIMITED_UNROLL_C_NEON:
+        shift_limited_unroll_C_neon_inp_c(in_out, N_cplx, &m->d.limited_C_sse);
+        break;
+    case PF_MIXER_RECURSIVE_OSC_NEON:
+        shift_recursive_osc_neon_inp_c(in_out, N_cplx, &m->d.rec_sse.conf, &m->d.rec_sse.state);
+        break;
+    case PF_MIXER_NCO:
+        shift_nco_inp_c(in_out, N_cplx, &m->d.nco);
+        break;
+    }
+}
+
+
+int shift_mixer_measure(int algo, float relative_freq, int block_len, float *phase_error, double *samples_per_sec)
+{
+    typedef std::chrono::steady_clock clock;
+    const int num_blocks = (PF_MIXER_TUNE_LEN > block_len) ? (PF_MIXER_TUNE_LEN / block_len) : 1;
+    const int len = num_blocks * block_len;
+    std::vector<complexf> buf;
+    shift_mixer_t *m;
+    double max_err = 0.0, best_sec = 0.0;
+    int k, run;
+
+    if (!shift_mixer_available(algo, block_len))
+        return 0;
+    m = (shift_mixer_t*)malloc(sizeof(shift_mixer_t));
+    buf.resize(len);
+
+    // phase error: mixing ones delivers the oscillator itself
+    shift_mixer_setup(m, algo, relative_freq, 0.0F);
+    for (k = 0; k < len; ++k)
+    {
+        buf[k].i = 1.0F;
+        buf[k].q = 0.0F;
+    }
+    for (k = 0; k < num_blocks; ++k)
+        shift_mixer_inp_c(m, &buf[k * block_len], block_len);
+    for (k = 0; k < len; ++k)
+    {
+        const double phi = 2.0 * 3.14159265358979323846 * fmod((double)relative_freq * k, 1.0);
+        const double di = buf[k].i - cos(phi);
+        const double dq = buf[k].q - sin(phi);
+        const double err = sqrt(di * di + dq * dq);
+        if (err > max_err)
+            max_err = err;
+    }
+
+    // speed: best of 3 runs - the content of buf stays at unit magnitude
+    for (run = 0; run < 3; ++run)
+    {
+        const clock::time_point t0 = clock::now();
+        for (k = 0; k < num_blocks; ++k)
+            shift_mixer_inp_c(m, &buf[k * block_len], block_len);
+        const double sec = std::chrono::duration<double>(clock::now() - t0).count();
+        if (run == 0 || sec < best_sec)
+            best_sec = sec;
+    }
+    free(m);
+
+    if (phase_error)
+        *phase_error = (float)max_err;
+    if (samples_per_sec)
+        *samples_per_sec = (best_sec > 0.0) ? (len / best_sec) : 1E30;
+    return 1;
+}
+
+
+int shift_mixer_init(shift_mixer_t *m, float relative_freq, float phase_start_rad, int block_len, float max_phase_error, int algo)
+{
+    float err, best_err = -1.0F;
+    double speed, best_speed = 0.0;
+    int a, best = -1;
+
+    if (algo != PF_MIXER_AUTO)
+    {
+        if (!shift_mixer_available(algo, block_len))
+            return -1;
+        shift_mixer_setup(m, algo, relative_freq, phase_start_rad);
+        return algo;
+    }
+
+    for (a = 0; a < PF_MIXER_NUM_ALGOS; ++a)
+    {
+        if (!shift_mixer_measure(a, relative_freq, block_len, &err, &speed))
+            continue;
+        if (err <= max_phase_error && (best < 0 || speed > best_speed))
+        {
+            best = a;
+            best_err = err;
+            best_speed = speed;
+        }
+    }
+    if (best < 0)
+        return -1;
+    shift_mixer_setup(m, best, relative_freq, phase_start_rad);
+    m->phase_error = best_err;
+    m->samples_per_sec = best_speed;
+    return best;
+}
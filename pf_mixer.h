@@ -44,6 +44,13 @@ extern "C" {
 
 int have_sse_shift_mixer_impl();
 
+/* AVX/FMA variants (ALGO K, L): compiled for x86/x64 - and the CPU supports AVX and FMA.
+ * the environment variable PFFFT_ARCH=sse2 disables them, as for pffft */
+int have_avx_shift_mixer_impl();
+
+/* native NEON variants (ALGO M, N): compiled for ARM with NEON */
+int have_neon_shift_mixer_impl();
+
 
 /*********************************************************************/
 
@@ -264,6 +271,178 @@ void shift_recursive_osc_sse_update_rate(float rate, shift_recursive_osc_sse_con
 void shift_recursive_osc_sse_inp_c(complexf* in_out, int N_cplx, const shift_recursive_osc_sse_conf_t *conf, shift_recursive_osc_sse_t* state_ext);
 
 
+/*********************************************************************/
+
+/**************/
+/*** ALGO K ***/
+/**************/
+
+/* AVX/FMA variant of ALGO H: 8 complex values per vector */
+#define PF_SHIFT_LIMITED_SIMD_AVX_SZ  8
+
+typedef struct shift_limited_unroll_avx_data_s
+{
+    /* small/limited trig table - interleaved: 8 cos, 8 sin, 8 cos, .. */
+    float dinterl_trig[2*(PF_SHIFT_LIMITED_UNROLL_SIZE+PF_SHIFT_LIMITED_SIMD_AVX_SZ)];
+    /* 8 times complex phase */
+    float phase_state_i[PF_SHIFT_LIMITED_SIMD_AVX_SZ];
+    float phase_state_q[PF_SHIFT_LIMITED_SIMD_AVX_SZ];
+    float phase_increment;
+} shift_limited_unroll_avx_data_t;
+
+shift_limited_unroll_avx_data_t shift_limited_unroll_avx_init(float relative_freq, float phase_start_rad);
+/* N_cplx must be multiple of PF_SHIFT_LIMITED_SIMD_AVX_SZ */
+void shift_limited_unroll_avx_inp_c(complexf* in_out, int N_cplx, shift_limited_unroll_avx_data_t* d);
+
+
+/*********************************************************************/
+
+/**************/
+/*** ALGO L ***/
+/**************/
+
+/* AVX/FMA variant of ALGO I: with the same conf/state from shift_recursive_osc_init().
+ * both can be used alternately on the same state.
+ * size must be multiple of PF_SHIFT_RECURSIVE_SIMD_SZ (= 8)
+ */
+void shift_recursive_osc_avx_inp_c(complexf* in_out, int N_cplx, const shift_recursive_osc_conf_t *conf, shift_recursive_osc_t* state);
+
+
+/*********************************************************************/
+
+/**************/
+/*** ALGO M ***/
+/**************/
+
+/* native NEON variant of ALGO H: with the data from shift_limited_unroll_C_sse_init().
+ * N_cplx must be multiple of PF_SHIFT_LIMITED_SIMD_SZ (= 4)
+ */
+void shift_limited_unroll_C_neon_inp_c(complexf* in_out, int N_cplx, shift_limited_unroll_C_sse_data_t* d);
+
+
+/*********************************************************************/
+
+/**************/
+/*** ALGO N ***/
+/**************/
+
+/* native NEON variant of ALGO J: with the conf/state from shift_recursive_osc_sse_init().
+ * N_cplx must be multiple of PF_SHIFT_RECURSIVE_SIMD_SSE_SZ (= 4)
+ */
+void shift_recursive_osc_neon_inp_c(complexf* in_out, int N_cplx, const shift_recursive_osc_sse_conf_t *conf, shift_recursive_osc_sse_t* state_ext);
+
+
+/*********************************************************************/
+
+/**************/
+/*** ALGO O ***/
+/**************/
+
+/* integer NCO: the exact 64 bit phase accumulator of cicddc_*() in pf_cic.h.
+ * after n samples, the phase is exactly phase_start + n * phase_inc (modulo 2^64):
+ * it doesn't drift - not even over days. cos/sin are interpolated linearly
+ * in a table of 2^PF_SHIFT_NCO_TABLE_BITS entries, shared by all NCOs. an entry
+ * holds cos, sin and both slopes: a single 16 byte load per sample.
+ * the SSE/NEON variant mixes 4 samples per step; N_cplx is arbitrary.
+ * changing the frequency only sets phase_inc: free at each block.
+ */
+#define PF_SHIFT_NCO_TABLE_BITS  10
+
+typedef struct shift_nco_s
+{
+    uint64_t phase;         /* 2^64 is a full cycle */
+    uint64_t phase_inc;
+} shift_nco_t;
+
+/* relative_freq (= frequency / samplerate) as phase increment - modulo 1 */
+uint64_t shift_nco_phase_inc(double relative_freq);
+shift_nco_t shift_nco_init(double relative_freq, double phase_start_rad);
+/* the next samples are mixed with relative_freq: the phase continues */
+void shift_nco_update_freq(shift_nco_t *d, double relative_freq);
+
+void shift_nco_cc(const complexf *input, complexf* output, int N_cplx, shift_nco_t *d);
+void shift_nco_inp_c(complexf* in_out, int N_cplx, shift_nco_t *d);
+/* interleaved int16 I/Q in: output = gain * input * exp(j*phase) */
+void shift_nco_cs16_c(const int16_t *input, complexf* output, int N_cplx, float gain, shift_nco_t *d);
+
+
+/*********************************************************************/
+
+/*****************************/
+/*** runtime selected mixer ***/
+/*****************************/
+
+/* the in-place algorithms above - selectable in shift_mixer_init() */
+typedef enum
+{
+    PF_MIXER_AUTO = -1,
+    PF_MIXER_MATH = 0,                  /* ALGO A: shift_math_cc() */
+    PF_MIXER_ADDFAST,                   /* ALGO C */
+    PF_MIXER_LIMITED_UNROLL,            /* ALGO E */
+    PF_MIXER_LIMITED_UNROLL_A_SSE,      /* ALGO F */
+    PF_MIXER_LIMITED_UNROLL_B_SSE,      /* ALGO G */
+    PF_MIXER_LIMITED_UNROLL_C_SSE,      /* ALGO H */
+    PF_MIXER_RECURSIVE_OSC,             /* ALGO I */
+    PF_MIXER_RECURSIVE_OSC_SSE,         /* ALGO J */
+    PF_MIXER_LIMITED_UNROLL_AVX,        /* ALGO K */
+    PF_MIXER_RECURSIVE_OSC_AVX,         /* ALGO L */
+    PF_MIXER_LIMITED_UNROLL_C_NEON,     /* ALGO M */
+    PF_MIXER_RECURSIVE_OSC_NEON,        /* ALGO N */
+    PF_MIXER_NCO,                       /* ALGO O */
+    PF_MIXER_NUM_ALGOS
+} shift_mixer_algo_t;
+
+/* number of samples for the measurement of speed and phase error in shift_mixer_init() */
+#define PF_MIXER_TUNE_LEN  65536
+
+typedef struct shift_mixer_s
+{
+    int algo;               /* selected shift_mixer_algo_t */
+    int simd_size;          /* N_cplx of shift_mixer_inp_c() must be a multiple of this */
+    float relative_freq;
+    float phase;            /* ALGO A and C: phase for the next call */
+    float phase_error;      /* measured by shift_mixer_init(): -1 when not measured */
+    double samples_per_sec; /* measured by shift_mixer_init(): 0 when not measured */
+    union
+    {
+        shift_addfast_data_t addfast;
+        shift_limited_unroll_data_t limited;
+        shift_limited_unroll_A_sse_data_t limited_A_sse;
+        shift_limited_unroll_B_sse_data_t limited_B_sse;
+        shift_limited_unroll_C_sse_data_t limited_C_sse;
+        shift_limited_unroll_avx_data_t limited_avx;
+        struct { shift_recursive_osc_conf_t conf; shift_recursive_osc_t state; } rec;
+        struct { shift_recursive_osc_sse_conf_t conf; shift_recursive_osc_sse_t state; } rec_sse;
+        shift_nco_t nco;
+    } d;
+} shift_mixer_t;
+
+/* name of the algorithm, e.g. "recursive_osc_avx" */
+const char * shift_mixer_name(int algo);
+
+/* the algorithm is compiled in, supported by the CPU - and usable with block_len */
+int shift_mixer_available(int algo, int block_len);
+
+/* measure one algorithm, processing PF_MIXER_TUNE_LEN samples in blocks of block_len:
+ * phase_error is the maximum deviation |y[n] - exp(j*2*pi*relative_freq*n)| for an input
+ * of ones - for small values, this is the phase error in radians, including the amplitude error.
+ * returns 0 when the algorithm is not available.
+ */
+int shift_mixer_measure(int algo, float relative_freq, int block_len, float *phase_error, double *samples_per_sec);
+
+/* prepare mixing with exp(j * (2*pi*relative_freq*n + phase_start_rad)).
+ * with algo = PF_MIXER_AUTO, the available algorithms are benchmarked with block_len
+ * on this CPU: the fastest one with a phase error <= max_phase_error is selected.
+ * otherwise, algo is used - if it is available.
+ * returns the selected algorithm - or -1, when none is suitable.
+ * the benchmark takes a few milliseconds.
+ */
+int shift_mixer_init(shift_mixer_t *m, float relative_freq, float phase_start_rad, int block_len, float max_phase_error, int algo);
+
+/* mix in-place with the selected algorithm: N_cplx must be a multiple of m->simd_size */
+void shift_mixer_inp_c(shift_mixer_t *m, complexf* in_out, int N_cplx);
+
+
 #ifdef __cplusplus
 }
 #endif
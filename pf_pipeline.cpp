@@ -0,0 +1,522 @@
+
+/* for pthread_setaffinity_np() */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "pf_pipeline.h"
+
+#include <string.h>
+#include <assert.h>
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <vector>
+
+#ifndef PF_PIPELINE_NO_THREADS
+#include <thread>
+#include <chrono>
+#  if defined(__linux__)
+#    include <pthread.h>
+#    include <sched.h>
+#  elif defined(_WIN32)
+#    include <windows.h>
+#  endif
+#endif
+
+#define PF_CACHE_LINE           64
+#define PIPELINE_DEFAULT_BLOCKS 4
+#define PIPELINE_SPINS          64      // busy polls before yielding
+#define PIPELINE_YIELDS         256     // yields before sleeping
+
+
+/*****************************************************************************/
+/* the ring: head counts the committed blocks, tail the released ones.
+ * each index is written by one side only - on its own cache line */
+
+struct pf_ring
+{
+    alignas(PF_CACHE_LINE) std::atomic<unsigned> head;
+    alignas(PF_CACHE_LINE) std::atomic<unsigned> tail;
+    alignas(PF_CACHE_LINE) std::atomic<int> closed;
+    unsigned mask;          // numBlocks - 1
+    int blockBytes;
+    size_t stride;          // blockBytes, rounded up to the cache line
+    char * mem;
+    int * used;             // usedBytes of each block
+};
+
+
+pf_ring * pf_ring_new(int numBlocks, int blockBytes)
+{
+    pf_ring * r;
+    unsigned n = 1;
+
+    if (numBlocks <= 0 || blockBytes <= 0 || numBlocks > (1 << 24))
+        return nullptr;
+    while (n < (unsigned)numBlocks)
+        n *= 2;
+    r = new (std::nothrow) pf_ring();
+    if (!r)
+        return nullptr;
+    r->head.store(0, std::memory_order_relaxed);
+    r->tail.store(0, std::memory_order_relaxed);
+    r->closed.store(0, std::memory_order_relaxed);
+    r->mask = n - 1;
+    r->blockBytes = blockBytes;
+    r->stride = ((size_t)blockBytes + PF_CACHE_LINE - 1) / PF_CACHE_LINE * PF_CACHE_LINE;
+    // pffft_aligned_malloc() aligns to the SIMD width: the cache line is found inside
+    r->mem = (char*)pffft_aligned_malloc(n * r->stride + PF_CACHE_LINE);
+    r->used = new (std::nothrow) int[n]();
+    if (!r->mem || !r->used)
+    {
+        pf_ring_destroy(r);
+        return nullptr;
+    }
+    return r;
+}
+
+
+void pf_ring_destroy(pf_ring * r)
+{
+    if (!r)
+        return;
+    pffft_aligned_free(r->mem);
+    delete [] r->used;
+    delete r;
+}
+
+
+int pf_ring_num_blocks(const pf_ring * r)
+{
+    return (int)(r->mask + 1);
+}
+
+
+int pf_ring_block_bytes(const pf_ring * r)
+{
+    return r->blockBytes;
+}
+
+
+static inline char * ring_block(const pf_ring * r, unsigned idx)
+{
+    const size_t mis = (size_t)r->mem % PF_CACHE_LINE;
+    char * base = r->mem + (mis ? PF_CACHE_LINE - mis : 0);
+    return base + (size_t)(idx & r->mask) * r->stride;
+}
+
+
+void * pf_ring_write_acquire(pf_ring * r)
+{
+    const unsigned h = r->head.load(std::memory_order_relaxed);
+    const unsigned t = r->tail.load(std::memory_order_acquire);
+    if (h - t > r->mask)
+        return nullptr;
+    return ring_block(r, h);
+}
+
+
+void pf_ring_write_commit(pf_ring * r, int usedBytes)
+{
+    const unsigned h = r->head.load(std::memory_order_relaxed);
+    assert(usedBytes >= 0 && usedBytes <= r->blockBytes);
+    r->used[h & r->mask] = usedBytes;
+    r->head.store(h + 1, std::memory_order_release);
+}
+
+
+void pf_ring_close(pf_ring * r)
+{
+    r->closed.store(1, std::memory_order_release);
+}
+
+
+const void * pf_ring_read_acquire(pf_ring * r, int * usedBytes)
+{
+    const unsigned t = r->tail.load(std::memory_order_relaxed);
+    const unsigned h = r->head.load(std::memory_order_acquire);
+    if (t == h)
+        return nullptr;
+    if (usedBytes)
+        *usedBytes = r->used[t & r->mask];
+    return ring_block(r, t);
+}
+
+
+void pf_ring_read_release(pf_ring * r)
+{
+    const unsigned t = r->tail.load(std::memory_order_relaxed);
+    r->tail.store(t + 1, std::memory_order_release);
+}
+
+
+int pf_ring_drained(pf_ring * r)
+{
+    // the last commit happened before the close: check in this order
+    if (!r->closed.load(std::memory_order_acquire))
+        return 0;
+    return (r->tail.load(std::memory_order_relaxed) == r->head.load(std::memory_order_acquire)) ? 1 : 0;
+}
+
+
+/*****************************************************************************/
+/* the pipeline */
+
+enum { STEP_DONE, STEP_PROGRESS, STEP_WAIT_IN, STEP_WAIT_OUT, STEP_ABORT };
+
+struct pf_stage
+{
+    pf_stage_fn fn;
+    void * user;
+    int outBlockBytes;
+    int cpu;
+    pf_ring * in;       // owned by the previous stage
+    pf_ring * out;
+    int done;
+    int lastStep;
+    pf_stage_stats_t stats;
+};
+
+
+struct pf_pipeline
+{
+    int ringBlocks;
+    std::vector<pf_stage> stages;
+    std::atomic<int> abort;
+};
+
+
+pf_pipeline * pf_pipeline_new(int ringBlocks)
+{
+    pf_pipeline * p = new (std::nothrow) pf_pipeline();
+    if (!p)
+        return nullptr;
+    p->ringBlocks = (ringBlocks > 0) ? ringBlocks : PIPELINE_DEFAULT_BLOCKS;
+    p->abort.store(0);
+    return p;
+}
+
+
+void pf_pipeline_destroy(pf_pipeline * p)
+{
+    if (!p)
+        return;
+    for (size_t k = 0; k < p->stages.size(); ++k)
+        pf_ring_destroy(p->stages[k].out);
+    delete p;
+}
+
+
+int pf_pipeline_add_stage(pf_pipeline * p, pf_stage_fn fn, void * user, int outBlockBytes, int cpu)
+{
+    pf_stage st;
+    if (!fn || outBlockBytes < 0)
+        return -1;
+    if (!p->stages.empty() && !p->stages.back().out)
+        return -1;      // behind the sink
+    memset(&st, 0, sizeof(st));
+    st.fn = fn;
+    st.user = user;
+    st.outBlockBytes = outBlockBytes;
+    st.cpu = cpu;
+    st.in = p->stages.empty() ? nullptr : p->stages.back().out;
+    if (outBlockBytes > 0)
+    {
+        st.out = pf_ring_new(p->ringBlocks, outBlockBytes);
+        if (!st.out)
+            return -1;
+    }
+    p->stages.push_back(st);
+    return (int)p->stages.size() - 1;
+}
+
+
+/* one non-blocking step of a stage */
+static int stage_step(pf_stage * st)
+{
+    void * out = nullptr;
+    const void * in = nullptr;
+    int inBytes = 0, n;
+
+    if (st->done)
+        return STEP_DONE;
+    if (st->out)
+    {
+        out = pf_ring_write_acquire(st->out);
+        if (!out)
+            return STEP_WAIT_OUT;
+    }
+    if (st->in)
+    {
+        in = pf_ring_read_acquire(st->in, &inBytes);
+        if (!in && !pf_ring_drained(st->in))
+            return STEP_WAIT_IN;
+    }
+
+    ++st->stats.blocks;
+    n = st->fn(st->user, in, inBytes, out, st->outBlockBytes);
+    if (in)
+        pf_ring_read_release(st->in);
+    if (n < 0 && st->in)
+        return STEP_ABORT;
+    if (out && n > 0)
+        pf_ring_write_commit(st->out, std::min(n, st->outBlockBytes));
+
+    // end of the source - or the flush call after the end of the input
+    if ((n < 0 && !st->in) || (st->in && !in))
+    {
+        if (st->out)
+            pf_ring_close(st->out);
+        st->done = 1;
+        return STEP_DONE;
+    }
+    return STEP_PROGRESS;
+}
+
+
+static void count_wait(pf_stage * st, int step)
+{
+    // count episodes, not polls
+    if (step != st->lastStep)
+    {
+        if (step == STEP_WAIT_IN)
+            ++st->stats.waits_in;
+        else if (step == STEP_WAIT_OUT)
+            ++st->stats.waits_out;
+    }
+    st->lastStep = step;
+}
+
+
+static void reset_run(pf_pipeline * p)
+{
+    p->abort.store(0);
+    for (size_t k = 0; k < p->stages.size(); ++k)
+    {
+        pf_stage * st = &p->stages[k];
+        st->done = 0;
+        st->lastStep = STEP_PROGRESS;
+        memset(&st->stats, 0, sizeof(st->stats));
+        if (st->out)
+        {
+            st->out->head.store(0);
+            st->out->tail.store(0);
+            st->out->closed.store(0);
+        }
+    }
+}
+
+
+#ifndef PF_PIPELINE_NO_THREADS
+
+static int pin_thread(std::thread & t, int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(t.native_handle(), sizeof(set), &set) ? 0 : 1;
+#elif defined(_WIN32)
+    return SetThreadAffinityMask((HANDLE)t.native_handle(), ((DWORD_PTR)1) << cpu) ? 1 : 0;
+#else
+    (void)t;
+    (void)cpu;
+    return 0;
+#endif
+}
+
+
+static void stage_worker(pf_pipeline * p, pf_stage * st)
+{
+    int idle = 0;
+    for (;;)
+    {
+        const int step = stage_step(st);
+        if (step == STEP_DONE)
+            return;
+        if (step == STEP_ABORT)
+        {
+            p->abort.store(1);
+            return;
+        }
+        count_wait(st, step);
+        if (step == STEP_PROGRESS)
+        {
+            idle = 0;
+            continue;
+        }
+        if (p->abort.load(std::memory_order_relaxed))
+            return;
+        // the other side needs some time: spin, yield, then sleep
+        ++idle;
+        if (idle < PIPELINE_SPINS)
+            continue;
+        else if (idle < PIPELINE_SPINS + PIPELINE_YIELDS)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+
+int pf_pipeline_run(pf_pipeline * p)
+{
+    std::vector<std::thread> workers;
+    size_t k;
+    int ret = 0;
+
+    if (p->stages.empty() || p->stages.back().out)
+        return -1;      // no sink
+    reset_run(p);
+    workers.reserve(p->stages.size());
+    try
+    {
+        for (k = 0; k < p->stages.size(); ++k)
+        {
+            workers.push_back(std::thread(stage_worker, p, &p->stages[k]));
+            if (p->stages[k].cpu >= 0)
+                p->stages[k].stats.pinned = pin_thread(workers.back(), p->stages[k].cpu);
+        }
+    }
+    catch (...)
+    {
+        p->abort.store(1);
+        ret = -1;
+    }
+    for (k = 0; k < workers.size(); ++k)
+        workers[k].join();
+    return (ret || p->abort.load()) ? -1 : 0;
+}
+
+#else
+
+int pf_pipeline_run(pf_pipeline * p)
+{
+    size_t k;
+    int active;
+
+    if (p->stages.empty() || p->stages.back().out)
+        return -1;      // no sink
+    reset_run(p);
+    // round-robin: each stage runs, until it has to wait
+    do
+    {
+        active = 0;
+        for (k = 0; k < p->stages.size(); ++k)
+        {
+            pf_stage * st = &p->stages[k];
+            int step;
+            while ((step = stage_step(st)) == STEP_PROGRESS)
+                ;
+            if (step == STEP_ABORT)
+                return -1;
+            count_wait(st, step);
+            active |= (step != STEP_DONE);
+        }
+    } while (active);
+    return 0;
+}
+
+#endif
+
+
+int pf_pipeline_stage_stats(const pf_pipeline * p, int stage, pf_stage_stats_t * stats)
+{
+    if (stage < 0 || stage >= (int)p->stages.size())
+        return -1;
+    *stats = p->stages[stage].stats;
+    return 0;
+}
+
+
+/*****************************************************************************/
+/* stage functions for the pfdsp blocks */
+
+int pf_stage_mixer(void * user, const void * in, int inBytes, void * out, int outCapacity)
+{
+    shift_mixer_t * m = (shift_mixer_t*)user;
+    const int n = inBytes / (int)sizeof(complexf);
+    if (!in)
+        return 0;
+    assert(inBytes <= outCapacity);
+    (void)outCapacity;
+    memcpy(out, in, (size_t)n * sizeof(complexf));
+    shift_mixer_inp_c(m, (complexf*)out, n);
+    return n * (int)sizeof(complexf);
+}
+
+
+int pf_stage_cic_s16(void * user, const void * in, int inBytes, void * out, int outCapacity)
+{
+    pf_stage_cic_t * c = (pf_stage_cic_t*)user;
+    const int frames = inBytes / (int)(c->numChannels * sizeof(int16_t));
+    if (!in)
+        return 0;
+    assert(cic_decim_max_output_len(c->setup, frames) * c->numChannels * (int)sizeof(float) <= outCapacity);
+    (void)outCapacity;
+    return cic_decim_s16(c->setup, (const int16_t*)in, frames, (float*)out) * c->numChannels * (int)sizeof(float);
+}
+
+
+int pf_stage_fastconv(void * user, const void * in, int inBytes, void * out, int outCapacity)
+{
+    pf_stage_fastconv_t * f = (pf_stage_fastconv_t*)user;
+    const int sampleBytes = (f->cplx ? 2 : 1) * (int)sizeof(float);
+    if (!in)
+        return 0;
+    (void)outCapacity;
+    return pffastconv_stream(f->setup, (const float*)in, inBytes / sampleBytes, (float*)out) * sampleBytes;
+}
+
+
+int pf_stage_fft(void * user, const void * in, int inBytes, void * out, int outCapacity)
+{
+    pf_stage_fft_t * f = (pf_stage_fft_t*)user;
+    const int nf = (f->cplx ? 2 : 1) * f->N;
+    const float * x = (const float*)in;
+    float * y = (float*)out;
+    int n = inBytes / (int)sizeof(float), written = 0;
+
+    if (!in)
+        return 0;
+    if (!f->buf)
+    {
+        f->buf = (float*)pffft_aligned_malloc((size_t)nf * sizeof(float));
+        f->work = (float*)pffft_aligned_malloc((size_t)nf * sizeof(float));
+        f->fill = 0;
+        if (!f->buf || !f->work)
+            return -1;
+    }
+    while (n > 0)
+    {
+        const int c = std::min(n, nf - f->fill);
+        memcpy(f->buf + f->fill, x, (size_t)c * sizeof(float));
+        f->fill += c;
+        x += c;
+        n -= c;
+        if (f->fill < nf)
+            break;
+        if ((written + nf) * (int)sizeof(float) > outCapacity)
+            return -1;
+        // the output block isn't necessarily aligned: transform in buf
+        if (f->ordered)
+            pffft_transform_ordered(f->setup, f->buf, f->buf, f->work, f->direction);
+        else
+            pffft_transform(f->setup, f->buf, f->buf, f->work, f->direction);
+        memcpy(y + written, f->buf, (size_t)nf * sizeof(float));
+        written += nf;
+        f->fill = 0;
+    }
+    return written * (int)sizeof(float);
+}
+
+
+void pf_stage_fft_free(pf_stage_fft_t * f)
+{
+    pffft_aligned_free(f->buf);
+    pffft_aligned_free(f->work);
+    f->buf = f->work = nullptr;
+    f->fill = 0;
+}
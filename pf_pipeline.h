@@ -0,0 +1,163 @@
+#pragma once
+
+/* pf_pipeline.h/.cpp implements a small runtime for chains of DSP blocks,
+ * e.g. CIC -> mixer -> pffastconv -> pffft, each stage on its own thread:
+ *
+ * - neighbouring stages are linked by a lock-free single-producer /
+ *   single-consumer ring of aligned blocks (pf_ring). a stage writes
+ *   straight into the next free block of its output ring, the next stage
+ *   reads it in place: the handoff is zero-copy - only two atomic indices
+ *   are exchanged.
+ * - all memory is allocated before the start. when the output ring of a
+ *   stage is full, the stage waits for its consumer (backpressure) -
+ *   when its input ring is empty, it waits for its producer. the wait
+ *   spins shortly, then yields - no locks, no allocation.
+ * - each stage worker can be pinned to a CPU (Linux and Windows).
+ * - the first stage is the source, the last one the sink. when the source
+ *   ends, each following stage is called once more to flush, then the end
+ *   is passed on to its consumer.
+ *
+ * without threads (compiled with PF_PIPELINE_NO_THREADS), pf_pipeline_run()
+ * processes the stages round-robin in the calling thread.
+ *
+ * stage functions for the pfdsp blocks are at the end of this header.
+ */
+
+#include "pf_cplx.h"
+#include "pf_mixer.h"
+#include "pf_cic.h"
+#include "pffastconv.h"
+#include "pffft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************/
+/* the lock-free ring: one producer thread, one consumer thread */
+
+typedef struct pf_ring pf_ring;
+
+/* numBlocks is rounded up to a power of two. each block has blockBytes,
+ * aligned for SIMD (see pffft_aligned_malloc()) - and to the cache line.
+ * returns NULL for unsuitable parameters.
+ */
+pf_ring * pf_ring_new(int numBlocks, int blockBytes);
+void pf_ring_destroy(pf_ring * r);
+
+int pf_ring_num_blocks(const pf_ring * r);
+int pf_ring_block_bytes(const pf_ring * r);
+
+/* producer: the next free block - NULL when the ring is full.
+ * the same block is returned until it is committed.
+ */
+void * pf_ring_write_acquire(pf_ring * r);
+/* producer: pass the acquired block with usedBytes to the consumer */
+void pf_ring_write_commit(pf_ring * r, int usedBytes);
+/* producer: no more blocks will follow */
+void pf_ring_close(pf_ring * r);
+
+/* consumer: the oldest committed block and its usedBytes - NULL when empty.
+ * the same block is returned until it is released.
+ */
+const void * pf_ring_read_acquire(pf_ring * r, int * usedBytes);
+/* consumer: give the acquired block back to the producer */
+void pf_ring_read_release(pf_ring * r);
+/* consumer: the ring is closed - and all blocks are read */
+int pf_ring_drained(pf_ring * r);
+
+
+/*****************************************************************************/
+/* the pipeline */
+
+typedef struct pf_pipeline pf_pipeline;
+
+/* a stage processes one block of its input ring into one block of its output ring:
+ *   in, inBytes: the input block. NULL for the source - and for the flush call
+ *                after the end of the input
+ *   out, outCapacity: the output block. NULL for the sink
+ * returns the number of bytes written to out: 0 keeps the output block for the next call.
+ * a negative value ends the source - for any other stage, it aborts the pipeline.
+ */
+typedef int (*pf_stage_fn)(void * user, const void * in, int inBytes, void * out, int outCapacity);
+
+/* each ring between two stages gets ringBlocks blocks: <= 0 selects 4 */
+pf_pipeline * pf_pipeline_new(int ringBlocks);
+
+/* all stages and their rings are destroyed - not the user data */
+void pf_pipeline_destroy(pf_pipeline * p);
+
+/* append a stage: outBlockBytes is the block size of its output ring - 0 for the sink.
+ * cpu >= 0 pins the worker thread to this CPU: a failure is only reported
+ * by pf_pipeline_stage_stats(). returns the index of the stage - or -1
+ */
+int pf_pipeline_add_stage(pf_pipeline * p, pf_stage_fn fn, void * user, int outBlockBytes, int cpu);
+
+/* start a worker per stage - and wait until the end of the stream has passed
+ * through the sink. returns 0 - or -1 when a stage aborted or a thread couldn't
+ * be started. the pipeline can be run again, e.g. after resetting the blocks.
+ */
+int pf_pipeline_run(pf_pipeline * p);
+
+typedef struct pf_stage_stats_s
+{
+    long long blocks;       /* calls of the stage function */
+    long long waits_in;     /* episodes waiting for input: the producer is slower */
+    long long waits_out;    /* episodes waiting for a free output block: backpressure */
+    int pinned;             /* 1 when pinned to the requested cpu */
+} pf_stage_stats_t;
+
+/* statistics of the last pf_pipeline_run(). returns -1 for an invalid stage */
+int pf_pipeline_stage_stats(const pf_pipeline * p, int stage, pf_stage_stats_t * stats);
+
+
+/*****************************************************************************/
+/* stage functions for the pfdsp blocks: 'user' is given in the comment.
+ * the output capacities are the caller's responsibility - see the max_output_len
+ * functions of the blocks.
+ */
+
+/* user = shift_mixer_t *: complexf in and out. the number of samples
+ * has to be a multiple of the mixer's simd_size */
+int pf_stage_mixer(void * user, const void * in, int inBytes, void * out, int outCapacity);
+
+typedef struct pf_stage_cic_s
+{
+    cic_decim_setup * setup;
+    int numChannels;        /* as for cic_decim_new_setup() */
+} pf_stage_cic_t;
+
+/* user = pf_stage_cic_t *: int16_t frames in, float frames out - see cic_decim_s16() */
+int pf_stage_cic_s16(void * user, const void * in, int inBytes, void * out, int outCapacity);
+
+typedef struct pf_stage_fastconv_s
+{
+    PFFASTCONV_Setup * setup;
+    int cplx;               /* 1 for a PFFASTCONV_CPLX_INP_OUT setup */
+} pf_stage_fastconv_t;
+
+/* user = pf_stage_fastconv_t *: pffastconv_stream() - outCapacity needs
+ * room for the input and blockLen samples */
+int pf_stage_fastconv(void * user, const void * in, int inBytes, void * out, int outCapacity);
+
+typedef struct pf_stage_fft_s
+{
+    PFFFT_Setup * setup;
+    int N;                  /* transform size */
+    int cplx;               /* 1 for a PFFFT_COMPLEX setup */
+    pffft_direction_t direction;
+    int ordered;            /* 1: pffft_transform_ordered(), 0: pffft_transform() */
+    /* internal, zero initialized - freed by pf_stage_fft_free() */
+    float * buf;            /* collects the samples of one transform */
+    float * work;
+    int fill;
+} pf_stage_fft_t;
+
+/* user = pf_stage_fft_t *: input of any length, the output are whole
+ * transforms of N (complex) samples - as many as are complete */
+int pf_stage_fft(void * user, const void * in, int inBytes, void * out, int outCapacity);
+void pf_stage_fft_free(pf_stage_fft_t * f);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,462 @@
+
+#include "pf_resample.h"
+#include "pf_conv.h"
+#include "pf_conv_dispatcher.h"
+#include "pf_mixer.h"
+#include "pf_kaiser_impl.h"
+#include "pffft.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include <algorithm>
+#include <new>
+
+#if defined(_MSC_VER)
+#  define RESTRICT __restrict
+#elif defined(__GNUC__)
+#  define RESTRICT __restrict
+#else
+#  define RESTRICT
+#endif
+
+#define RESAMP_TILE_LEN         2048    // input samples per tile
+#define RESAMP_TILE_OUT         8192    // limits the tile for large interpolations
+#define RESAMP_MIXER_SIMD_SZ    PF_SHIFT_RECURSIVE_SIMD_SZ
+#define RESAMP_ARB_PHASE_BITS   8       // RESAMP_ARB_PHASES == 1 << RESAMP_ARB_PHASE_BITS
+
+// variants of the recursive oscillator from pf_mixer.h - as in pf_ddc.cpp
+enum { RESAMP_MIXER_NONE, RESAMP_MIXER_GENERIC, RESAMP_MIXER_SSE, RESAMP_MIXER_AVX, RESAMP_MIXER_NEON };
+
+
+struct resamp_setup
+{
+    const conv_f_ptrs * conv_arch;
+    int L;              // phases: interpolation of the rational ratio - or RESAMP_ARB_PHASES
+    int M;              // decimation of the rational ratio
+    int arbitrary;      // interpolate between the phases
+    uint64_t step;      // arbitrary ratio: input samples per output, in units of 2^-32
+    int K;              // taps per phase
+    int Kp;             // taps per phase, padded to a multiple of the conv simd size
+    int protoLen;       // L * K
+    float * proto;      // low-pass prototype at the rate L * input_rate
+    float * bank;       // (L+1) phases of Kp taps, reversed for the kernels - zeros in front
+    int tileLen;
+
+    int mixer;          // one of the RESAMP_MIXER_* variants
+    float mixRate;
+    shift_recursive_osc_conf_t osc_conf;
+    shift_recursive_osc_t osc;
+    shift_recursive_osc_sse_conf_t osc_sse_conf;
+    shift_recursive_osc_sse_t osc_sse;
+
+    complexf * buf;     // input history: Kp-1 + tileLen samples - used as float[] for real input
+    conv_buffer_state state;    // offset: start of the window of the next output
+    int phase;          // rational: phase of the next output, 0 .. L-1
+    uint32_t frac;      // arbitrary: fraction of an input sample of the next output
+    int skip;           // input samples to skip, when the window jumped beyond the buffer
+    complexf * tmp;     // rational: outputs of a tile, sorted by phase
+    int tmpStride;      // maximum outputs of one phase per tile
+};
+
+
+/*****************************************************************************/
+/* filter design - with the Kaiser window of pf_kaiser_impl.h */
+
+static int gcd(int a, int b)
+{
+    while (b)
+    {
+        const int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* low-pass at the rate L * input_rate: the cutoff halfway between passband and
+ * stopband of the lower rate - minRate relative to the input rate. DC gain L */
+static void design_prototype(resamp_setup * s, double minRate, double A)
+{
+    const int L = s->L, N = s->protoLen;
+    const double fc = 0.5 * minRate / L;
+    const double beta = kaiser_beta(A);
+    const double c = 0.5 * (N - 1);
+    double sum = 0.0;
+    int m;
+    for (m = 0; m < N; ++m)
+    {
+        const double t = m - c;
+        const double si = (fabs(t) < 1E-9) ? 2.0 * fc : sin(2.0 * M_PI * fc * t) / (M_PI * t);
+        const double h = si * kaiser_window(m, N, beta);
+        s->proto[m] = (float)h;
+        sum += h;
+    }
+    for (m = 0; m < N; ++m)
+        s->proto[m] = (float)(s->proto[m] * (L / sum));
+}
+
+/* phase q: g_q[j] = h[q + j*L], reversed for the kernels:
+ * bank[q*Kp + Kp-1-j] = g_q[j]. phase L is phase 0 of the next input sample */
+static void fill_bank(resamp_setup * s)
+{
+    const int L = s->L, K = s->K, Kp = s->Kp;
+    int q, j;
+    memset(s->bank, 0, (size_t)(L + 1) * Kp * sizeof(float));
+    for (q = 0; q <= L; ++q)
+        for (j = 0; j < K; ++j)
+            if (q + j * L < s->protoLen)
+                s->bank[q * Kp + Kp - 1 - j] = s->proto[q + j * L];
+}
+
+
+/*****************************************************************************/
+
+resamp_setup * resamp_new_setup(const resamp_spec_t * spec)
+{
+    resamp_setup * s;
+    double minRate, passband, A, dw;
+    int L, M, simd, nmax;
+
+    if (!spec)
+        return nullptr;
+    passband = (spec->passband > 0.0) ? spec->passband : 0.4;
+    A = (spec->stopband_atten_db > 0.0) ? spec->stopband_atten_db : 80.0;
+    if (passband >= 0.5)
+        return nullptr;
+    if (spec->interpolation > 0)
+    {
+        if (spec->decimation <= 0)
+            return nullptr;
+        const int g = gcd(spec->interpolation, spec->decimation);
+        L = spec->interpolation / g;
+        M = spec->decimation / g;
+        if (L > RESAMP_MAX_PHASES)
+            return nullptr;
+        minRate = std::min(1.0, (double)L / M);
+    }
+    else
+    {
+        // the step has to fit into 32 bits of integer input samples
+        if (!(spec->ratio > 1E-6 && spec->ratio < 1E6))
+            return nullptr;
+        L = RESAMP_ARB_PHASES;
+        M = 0;
+        minRate = std::min(1.0, spec->ratio);
+    }
+
+    s = new (std::nothrow) resamp_setup();
+    if (!s)
+        return nullptr;
+    s->conv_arch = get_best_conv_arch_ptrs(CONV_ARCH_SELECT_BY_ORDER);
+    s->L = L;
+    s->M = M;
+    s->arbitrary = (M == 0) ? 1 : 0;
+    if (s->arbitrary)
+        s->step = (uint64_t)llround(4294967296.0 / spec->ratio);
+
+    // transition from passband to 1 - passband of the lower rate
+    dw = (1.0 - 2.0 * passband) * minRate / L;
+    s->K = std::max(1, (kaiser_len(A, dw) + L - 1) / L);
+    simd = s->conv_arch->fp_conv_float_simd_size();
+    s->Kp = ((s->K + simd - 1) / simd) * simd;
+    s->protoLen = L * s->K;
+
+    // a tile delivers at most RESAMP_TILE_OUT outputs
+    if (s->arbitrary)
+        s->tileLen = RESAMP_TILE_LEN;
+    else
+        s->tileLen = (int)std::min<long long>(RESAMP_TILE_LEN, (long long)RESAMP_TILE_OUT * M / L);
+    s->tileLen = std::max(RESAMP_MIXER_SIMD_SZ, s->tileLen - s->tileLen % RESAMP_MIXER_SIMD_SZ);
+    nmax = (int)(((long long)s->tileLen * L + (M ? M : 1) - 1) / (M ? M : 1)) + 1;
+    s->tmpStride = nmax / L + 1;
+
+    s->proto = (float*)pffft_aligned_malloc((size_t)s->protoLen * sizeof(float));
+    s->bank = (float*)pffft_aligned_malloc((size_t)(L + 1) * s->Kp * sizeof(float));
+    s->buf = (complexf*)pffft_aligned_malloc((size_t)(s->Kp - 1 + s->tileLen) * sizeof(complexf));
+    s->tmp = s->arbitrary ? nullptr : (complexf*)pffft_aligned_malloc((size_t)L * s->tmpStride * sizeof(complexf));
+    if (!s->proto || !s->bank || !s->buf || (!s->arbitrary && !s->tmp))
+    {
+        resamp_destroy_setup(s);
+        return nullptr;
+    }
+    design_prototype(s, minRate, A);
+    fill_bank(s);
+
+    s->mixRate = 2.0F * spec->shift_freq;
+    if (spec->shift_freq == 0.0F)
+        s->mixer = RESAMP_MIXER_NONE;
+    else if (have_avx_shift_mixer_impl())
+        s->mixer = RESAMP_MIXER_AVX;
+    else if (have_neon_shift_mixer_impl())
+        s->mixer = RESAMP_MIXER_NEON;
+    else if (have_sse_shift_mixer_impl())
+        s->mixer = RESAMP_MIXER_SSE;
+    else
+        s->mixer = RESAMP_MIXER_GENERIC;
+
+    resamp_reset(s);
+    return s;
+}
+
+
+void resamp_destroy_setup(resamp_setup * s)
+{
+    if (!s)
+        return;
+    pffft_aligned_free(s->proto);
+    pffft_aligned_free(s->bank);
+    pffft_aligned_free(s->buf);
+    pffft_aligned_free(s->tmp);
+    delete s;
+}
+
+
+void resamp_reset(resamp_setup * s)
+{
+    if (s->mixer == RESAMP_MIXER_SSE || s->mixer == RESAMP_MIXER_NEON)
+        shift_recursive_osc_sse_init(s->mixRate, 0.0F, &s->osc_sse_conf, &s->osc_sse);
+    else if (s->mixer != RESAMP_MIXER_NONE)
+        shift_recursive_osc_init(s->mixRate, 0.0F, &s->osc_conf, &s->osc);
+    // Kp-1 zeros before the first input sample: the window of the first output
+    memset(s->buf, 0, (size_t)(s->Kp - 1) * sizeof(complexf));
+    s->state.offset = 0;
+    s->state.size = s->Kp - 1;
+    s->phase = 0;
+    s->frac = 0;
+    s->skip = 0;
+}
+
+
+const float * resamp_prototype(const resamp_setup * s, int * len, int * phases)
+{
+    if (len)
+        *len = s->protoLen;
+    if (phases)
+        *phases = s->L;
+    return s->proto;
+}
+
+
+int resamp_max_output_len(const resamp_setup * s, int inputLen)
+{
+    if (s->arbitrary)
+        return (int)ceil(inputLen * (4294967296.0 / (double)s->step)) + 1;
+    return (int)(((long long)inputLen * s->L + s->M - 1) / s->M);
+}
+
+
+/*****************************************************************************/
+
+/* the window of an output may start beyond the buffered input:
+ * drop these samples from the next input */
+static void apply_skip(resamp_setup * s)
+{
+    const int n = std::min(s->skip, s->state.size - s->state.offset);
+    s->state.offset += n;
+    s->skip -= n;
+}
+
+static void keep_rest(resamp_setup * s, int cplx)
+{
+    if (s->state.offset > s->state.size)
+    {
+        s->skip = s->state.offset - s->state.size;
+        s->state.offset = s->state.size;
+    }
+    if (cplx)
+        s->conv_arch->fp_conv_cplx_move_rest(s->buf, &s->state);
+    else
+        s->conv_arch->fp_conv_float_move_rest((float*)s->buf, &s->state);
+}
+
+/* rational ratio: the number of outputs, whose window fits into the buffer */
+static int num_rational_outputs(const resamp_setup * s)
+{
+    const int avail = s->state.size - s->state.offset - s->Kp + 1;
+    if (avail <= 0)
+        return 0;
+    // output n starts at offset + (phase + n*M) / L: n*M < avail*L - phase
+    return (int)(((long long)avail * s->L - s->phase + s->M - 1) / s->M);
+}
+
+static void advance_rational(resamp_setup * s, int n)
+{
+    const long long t = s->phase + (long long)n * s->M;
+    s->state.offset += (int)(t / s->L);
+    s->phase = (int)(t % s->L);
+}
+
+/* the outputs of phase r, r+L, r+2L, .. are M inputs apart:
+ * one decimating kernel call per phase - then they are interleaved */
+static int tile_rational_c(resamp_setup * s, complexf * RESTRICT y)
+{
+    const int L = s->L, M = s->M, Kp = s->Kp;
+    const int n = num_rational_outputs(s);
+    int r, j;
+
+    for (r = 0; r < std::min(L, n); ++r)
+    {
+        const long long t = s->phase + (long long)r * M;
+        const int J = (n - r + L - 1) / L;
+        conv_buffer_state st = { 0, (J - 1) * M + Kp };
+        complexf * out = (L == 1) ? y : (s->tmp + (size_t)r * s->tmpStride);
+        s->conv_arch->fp_conv_cplx_float_decim_oop(s->buf + s->state.offset + t / L, &st,
+                                                   s->bank + (int)(t % L) * Kp, Kp, M, out);
+    }
+    if (L > 1)
+    {
+        for (r = 0; r < std::min(L, n); ++r)
+        {
+            const complexf * RESTRICT t = s->tmp + (size_t)r * s->tmpStride;
+            for (j = 0; r + j * L < n; ++j)
+                y[r + j * L] = t[j];
+        }
+    }
+    advance_rational(s, n);
+    return n;
+}
+
+static int tile_rational_f(resamp_setup * s, float * RESTRICT y)
+{
+    const int L = s->L, M = s->M, Kp = s->Kp;
+    const float * buf = (const float*)s->buf;
+    float * tmp = (float*)s->tmp;
+    const int n = num_rational_outputs(s);
+    int r, j;
+
+    for (r = 0; r < std::min(L, n); ++r)
+    {
+        const long long t = s->phase + (long long)r * M;
+        const int J = (n - r + L - 1) / L;
+        conv_buffer_state st = { 0, (J - 1) * M + Kp };
+        float * out = (L == 1) ? y : (tmp + (size_t)r * s->tmpStride);
+        s->conv_arch->fp_conv_float_decim_oop(buf + s->state.offset + t / L, &st,
+                                              s->bank + (int)(t % L) * Kp, Kp, M, out);
+    }
+    if (L > 1)
+    {
+        for (r = 0; r < std::min(L, n); ++r)
+        {
+            const float * RESTRICT t = tmp + (size_t)r * s->tmpStride;
+            for (j = 0; r + j * L < n; ++j)
+                y[r + j * L] = t[j];
+        }
+    }
+    advance_rational(s, n);
+    return n;
+}
+
+/* arbitrary ratio: two inner products - of the neighbouring phases - per output */
+static inline void advance_arbitrary(resamp_setup * s)
+{
+    const uint64_t t = (uint64_t)s->frac + s->step;
+    s->state.offset += (int)(t >> 32);
+    s->frac = (uint32_t)t;
+}
+
+static int tile_arbitrary_c(resamp_setup * s, complexf * RESTRICT y)
+{
+    const int Kp = s->Kp;
+    int n = 0;
+    while (s->state.offset + Kp <= s->state.size)
+    {
+        const int q = (int)(s->frac >> (32 - RESAMP_ARB_PHASE_BITS));
+        const float a = (float)(s->frac & ((1u << (32 - RESAMP_ARB_PHASE_BITS)) - 1)) * (1.0F / (1u << (32 - RESAMP_ARB_PHASE_BITS)));
+        conv_buffer_state st0 = { 0, Kp }, st1 = { 0, Kp };
+        complexf y0, y1;
+        s->conv_arch->fp_conv_cplx_float_oop(s->buf + s->state.offset, &st0, s->bank + q * Kp, Kp, &y0);
+        s->conv_arch->fp_conv_cplx_float_oop(s->buf + s->state.offset, &st1, s->bank + (q + 1) * Kp, Kp, &y1);
+        y[n].i = y0.i + a * (y1.i - y0.i);
+        y[n].q = y0.q + a * (y1.q - y0.q);
+        ++n;
+        advance_arbitrary(s);
+    }
+    return n;
+}
+
+static int tile_arbitrary_f(resamp_setup * s, float * RESTRICT y)
+{
+    const int Kp = s->Kp;
+    const float * buf = (const float*)s->buf;
+    int n = 0;
+    while (s->state.offset + Kp <= s->state.size)
+    {
+        const int q = (int)(s->frac >> (32 - RESAMP_ARB_PHASE_BITS));
+        const float a = (float)(s->frac & ((1u << (32 - RESAMP_ARB_PHASE_BITS)) - 1)) * (1.0F / (1u << (32 - RESAMP_ARB_PHASE_BITS)));
+        conv_buffer_state st0 = { 0, Kp }, st1 = { 0, Kp };
+        float y0, y1;
+        s->conv_arch->fp_conv_float_oop(buf + s->state.offset, &st0, s->bank + q * Kp, Kp, &y0);
+        s->conv_arch->fp_conv_float_oop(buf + s->state.offset, &st1, s->bank + (q + 1) * Kp, Kp, &y1);
+        y[n] = y0 + a * (y1 - y0);
+        ++n;
+        advance_arbitrary(s);
+    }
+    return n;
+}
+
+
+int resamp_process_c(resamp_setup * s, const complexf * input, int inputLen, complexf * output, int * outLen)
+{
+    int off, m = 0;
+
+    if (s->mixer != RESAMP_MIXER_NONE)
+        inputLen -= inputLen % RESAMP_MIXER_SIMD_SZ;
+
+    for (off = 0; off < inputLen; off += s->tileLen)
+    {
+        const int n = std::min(s->tileLen, inputLen - off);
+        complexf * dst = s->buf + s->state.size;
+
+        // the mixer writes straight behind the buffered input
+        switch (s->mixer)
+        {
+        case RESAMP_MIXER_AVX:
+            memcpy(dst, input + off, (size_t)n * sizeof(complexf));
+            shift_recursive_osc_avx_inp_c(dst, n, &s->osc_conf, &s->osc);
+            break;
+        case RESAMP_MIXER_NEON:
+            memcpy(dst, input + off, (size_t)n * sizeof(complexf));
+            shift_recursive_osc_neon_inp_c(dst, n, &s->osc_sse_conf, &s->osc_sse);
+            break;
+        case RESAMP_MIXER_SSE:
+            memcpy(dst, input + off, (size_t)n * sizeof(complexf));
+            shift_recursive_osc_sse_inp_c(dst, n, &s->osc_sse_conf, &s->osc_sse);
+            break;
+        case RESAMP_MIXER_GENERIC:
+            shift_recursive_osc_cc(input + off, dst, n, &s->osc_conf, &s->osc);
+            break;
+        default:
+            memcpy(dst, input + off, (size_t)n * sizeof(complexf));
+        }
+        s->state.size += n;
+        apply_skip(s);
+
+        m += s->arbitrary ? tile_arbitrary_c(s, output + m) : tile_rational_c(s, output + m);
+        keep_rest(s, 1);
+    }
+    *outLen = m;
+    return inputLen;
+}
+
+
+int resamp_process_f(resamp_setup * s, const float * input, int inputLen, float * output, int * outLen)
+{
+    float * buf = (float*)s->buf;
+    int off, m = 0;
+
+    for (off = 0; off < inputLen; off += s->tileLen)
+    {
+        const int n = std::min(s->tileLen, inputLen - off);
+        memcpy(buf + s->state.size, input + off, (size_t)n * sizeof(float));
+        s->state.size += n;
+        apply_skip(s);
+
+        m += s->arbitrary ? tile_arbitrary_f(s, output + m) : tile_rational_f(s, output + m);
+        keep_rest(s, 0);
+    }
+    *outLen = m;
+    return inputLen;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+/* pf_resample.h/.cpp implements a polyphase resampler for real or complex
+ * float samples - between two sample rates with a rational ratio L/M,
+ * e.g. 48 kHz to 44.1 kHz with 147/160, or with an arbitrary ratio:
+ *
+ * - one Kaiser windowed low-pass prototype at the rate L * input_rate
+ *   is split into L phases of K taps - only the phase of an output is computed
+ * - the inner products are the dispatched kernels from pf_conv.h:
+ *   for a rational ratio, the outputs of one phase are L outputs and M inputs
+ *   apart, which is one call of fp_conv_float_decim_oop() (or the complex variant)
+ *   with decimation M per phase and block
+ * - an arbitrary ratio uses RESAMP_ARB_PHASES phases and interpolates linearly
+ *   between the two neighbouring phases of each output's time
+ * - complex input can be shifted in frequency before the filter, with the
+ *   recursive oscillator from pf_mixer.h: the mixer writes straight into the
+ *   input buffer of the kernels - there is no separate pass
+ *
+ * the input history is kept as in pf_conv.h with a conv_buffer_state:
+ * input of any length per call is appended, the unprocessed rest is moved
+ * to the buffer's start with fp_conv_*_move_rest().
+ *
+ * the output is continuous (causal): with zero input samples before the first call,
+ * output n is the prototype h[] at the rate L * input_rate, evaluated at t = n * M:
+ *   y[n] = sum_j ( h[t % L + j * L] * x[t / L - j] )
+ * for the arbitrary ratio, t = n * L / ratio is rounded to 1/2^32 of an input sample.
+ * the delay is (len - 1) / 2 samples of resamp_prototype() at the rate L * input_rate.
+ */
+
+#include "pf_cplx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct resamp_setup resamp_setup;
+
+#define RESAMP_ARB_PHASES   256     /* L for the arbitrary ratio */
+#define RESAMP_MAX_PHASES   4096    /* maximum L of a rational ratio, after reduction */
+
+typedef struct resamp_spec_s
+{
+    int interpolation;          /* L: output_rate = input_rate * L / M. <= 0 for the arbitrary ratio */
+    int decimation;             /* M */
+    double ratio;               /* output_rate / input_rate - only for the arbitrary ratio */
+    double passband;            /* edge of the passband, relative to the lower of both rates: < 0.5.
+                                 * the stopband starts at 1 - passband, so that nothing aliases
+                                 * into the passband. <= 0 selects 0.4 */
+    double stopband_atten_db;   /* <= 0 selects 80 */
+    float shift_freq;           /* complex input is mixed with exp(j*2*pi*shift_freq*n) before
+                                 * the filter: shift / input_rate. 0 for no shift.
+                                 * avoid +/- 1/8 and +/- 1/16, see pf_ddc.h */
+} resamp_spec_t;
+
+/* prepare the resampler. the rational ratio L/M is reduced.
+ * returns NULL for an unsuitable spec - e.g. L > RESAMP_MAX_PHASES after reduction
+ */
+resamp_setup * resamp_new_setup(const resamp_spec_t * spec);
+
+void resamp_destroy_setup(resamp_setup * s);
+
+/* forget the input history and restart the mixer: as if a new setup was just created */
+void resamp_reset(resamp_setup * s);
+
+/* the low-pass prototype at the rate L * input_rate, with DC gain L:
+ * its length is L * K - and phases receives L */
+const float * resamp_prototype(const resamp_setup * s, int * len, int * phases);
+
+/* required size of output for a call with inputLen samples */
+int resamp_max_output_len(const resamp_setup * s, int inputLen);
+
+/* resample inputLen samples - of any length per call. *outLen receives the
+ * number of output samples. with a frequency shift, the complex variant requires
+ * inputLen to be a multiple of 8, see pf_ddc.h: the return value is the number
+ * of consumed input samples, inputLen rounded down. without, all input is consumed.
+ * input and output don't need to be aligned.
+ */
+int resamp_process_c(resamp_setup * s, const complexf * input, int inputLen, complexf * output, int * outLen);
+
+/* the same for real input: the frequency shift is ignored */
+int resamp_process_f(resamp_setup * s, const float * input, int inputLen, float * output, int * outLen);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,417 @@
+
+#include "pf_zlconv.h"
+#include "pf_conv.h"
+#include "pf_conv_dispatcher.h"
+#include "pffft.h"
+
+#include <string.h>
+#include <assert.h>
+
+#include <algorithm>
+#include <new>
+
+#ifndef PF_ZLCONV_NO_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+
+/* one uniformly partitioned overlap-save with partition size S = Nfft/2:
+ * every S samples, the spectrum of the input window x[T-2S .. T) is put
+ * into the delay line and the sum over all partitions P delivers
+ *   u[t] = sum_{j < P*S} ( h[offset + j] * x[t - j] )  for t in [T-S, T),
+ * which is y[t + offset] for the output.
+ */
+struct zlconv_stage
+{
+    PFFFT_Setup * fft;
+    int S;          // partition size
+    int P;          // number of partitions
+    int offset;     // first tap of this stage
+    int fdlPos;     // ring position of the newest input spectrum
+    float * Hf;     // P filter spectra
+    float * Xf;     // P input spectra: the delay line
+    float * Xt;     // input window - copied before each job
+    float * Mf;     // accumulated products
+    float * Yt;     // time domain result: output[offset + T - S .. offset + T)
+    float * work;
+    int background;
+
+#ifndef PF_ZLCONV_NO_THREADS
+    std::thread worker;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool pending;   // job is waiting or running
+    bool quit;
+#endif
+};
+
+
+struct zlconv_setup
+{
+    const conv_f_ptrs * conv_arch;
+    int B;          // blockLen
+    int headLen;    // length of hrev[]: head filter is padded to a multiple of the simd size
+    float * hrev;   // head of the filter, reversed for fp_conv_float_oop()
+    float * headBuf;
+    conv_buffer_state headState;
+
+    int numStages;
+    zlconv_stage * stages;
+
+    int maxS;       // largest partition size
+    long long T;    // number of processed samples
+    float * xring;  // input history of 2 * maxS samples
+    float * acc;    // output accumulator for times [T, T + maxS)
+};
+
+
+static void stage_job(zlconv_stage * st)
+{
+    const int Nfft = 2 * st->S;
+    const float scale = 1.0F / Nfft;
+    int p;
+
+    st->fdlPos = (st->fdlPos + 1) % st->P;
+    pffft_transform(st->fft, st->Xt, st->Xf + (size_t)st->fdlPos * Nfft, st->work, PFFFT_FORWARD);
+    pffft_zconvolve_no_accu(st->fft, st->Xf + (size_t)st->fdlPos * Nfft, st->Hf, st->Mf, scale);
+    for (p = 1; p < st->P; ++p)
+    {
+        const int pos = (st->fdlPos + st->P - p) % st->P;   // window of p partitions before
+        pffft_zconvolve_accumulate(st->fft, st->Xf + (size_t)pos * Nfft, st->Hf + (size_t)p * Nfft, st->Mf, scale);
+    }
+    pffft_transform(st->fft, st->Mf, st->Xt, st->work, PFFFT_BACKWARD);
+    // the second half has no circular wrap
+    memcpy(st->Yt, st->Xt + st->S, (size_t)st->S * sizeof(float));
+}
+
+
+#ifndef PF_ZLCONV_NO_THREADS
+
+static void stage_worker(zlconv_stage * st)
+{
+    std::unique_lock<std::mutex> lock(st->mtx);
+    for (;;)
+    {
+        st->cv.wait(lock, [st]{ return st->pending || st->quit; });
+        if (st->quit)
+            return;
+        lock.unlock();
+        stage_job(st);
+        lock.lock();
+        st->pending = false;
+        st->cv.notify_all();
+    }
+}
+
+static void stage_wait(zlconv_stage * st)
+{
+    if (!st->background)
+        return;
+    std::unique_lock<std::mutex> lock(st->mtx);
+    st->cv.wait(lock, [st]{ return !st->pending; });
+}
+
+static void stage_start(zlconv_stage * st)
+{
+    if (!st->background)
+    {
+        stage_job(st);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(st->mtx);
+        st->pending = true;
+    }
+    st->cv.notify_all();
+}
+
+#else
+
+static void stage_wait(zlconv_stage *) { }
+static void stage_start(zlconv_stage * st) { stage_job(st); }
+
+#endif
+
+
+static void stage_free(zlconv_stage * st)
+{
+#ifndef PF_ZLCONV_NO_THREADS
+    if (st->worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(st->mtx);
+            st->quit = true;
+        }
+        st->cv.notify_all();
+        st->worker.join();
+    }
+#endif
+    pffft_aligned_free(st->Hf);
+    pffft_aligned_free(st->Xf);
+    pffft_aligned_free(st->Xt);
+    pffft_aligned_free(st->Mf);
+    pffft_aligned_free(st->Yt);
+    pffft_aligned_free(st->work);
+    pffft_destroy_setup(st->fft);
+}
+
+
+static bool stage_init(zlconv_stage * st, const float * filter, int filterLen, int offset, int S, int P, int background)
+{
+    const int Nfft = 2 * S;
+    int p, k;
+
+    st->S = S;
+    st->P = P;
+    st->offset = offset;
+    st->fdlPos = 0;
+    st->background = background;
+    st->fft = pffft_new_setup(Nfft, PFFFT_REAL);
+    st->Hf = (float*)pffft_aligned_malloc((size_t)P * Nfft * sizeof(float));
+    st->Xf = (float*)pffft_aligned_malloc((size_t)P * Nfft * sizeof(float));
+    st->Xt = (float*)pffft_aligned_malloc((size_t)Nfft * sizeof(float));
+    st->Mf = (float*)pffft_aligned_malloc((size_t)Nfft * sizeof(float));
+    st->Yt = (float*)pffft_aligned_malloc((size_t)S * sizeof(float));
+    st->work = (float*)pffft_aligned_malloc((size_t)Nfft * sizeof(float));
+    if (!st->fft || !st->Hf || !st->Xf || !st->Xt || !st->Mf || !st->Yt || !st->work)
+        return false;
+
+    for (p = 0; p < P; ++p)
+    {
+        // partition p - zero padded to Nfft
+        memset(st->Xt, 0, (size_t)Nfft * sizeof(float));
+        for (k = 0; k < S && offset + p * S + k < filterLen; ++k)
+            st->Xt[k] = filter[offset + p * S + k];
+        pffft_transform(st->fft, st->Xt, st->Hf + (size_t)p * Nfft, st->work, PFFFT_FORWARD);
+    }
+    memset(st->Xf, 0, (size_t)P * Nfft * sizeof(float));
+    memset(st->Yt, 0, (size_t)S * sizeof(float));
+
+#ifndef PF_ZLCONV_NO_THREADS
+    st->pending = false;
+    st->quit = false;
+    if (background)
+        st->worker = std::thread(stage_worker, st);
+#endif
+    return true;
+}
+
+
+/* the widest kernel, the CPU supports - with fallback to the portable one */
+static const conv_f_ptrs * zlconv_conv_arch()
+{
+    return get_best_conv_arch_ptrs(CONV_ARCH_SELECT_BY_ORDER);
+}
+
+
+zlconv_setup * zlconv_new_setup(const float * filter, int filterLen, int blockLen, int maxPartLen, int flags)
+{
+    const int B = blockLen;
+    zlconv_setup * s;
+    int simd, headTaps, k, S, offset, numStages;
+
+    if (!filter || filterLen <= 0 || B <= 0 || !pffft_is_valid_size(2 * B, PFFFT_REAL))
+        return nullptr;
+    if (maxPartLen <= 0)
+        maxPartLen = 16 * B;
+
+    s = new (std::nothrow) zlconv_setup();
+    if (!s)
+        return nullptr;
+    s->conv_arch = zlconv_conv_arch();
+    s->B = B;
+
+    // head: direct convolution of the first B taps
+    headTaps = std::min(filterLen, B);
+    simd = s->conv_arch->fp_conv_float_simd_size();
+    s->headLen = ((headTaps + simd - 1) / simd) * simd;
+    s->hrev = (float*)pffft_aligned_malloc((size_t)s->headLen * sizeof(float));
+    s->headBuf = (float*)pffft_aligned_malloc((size_t)(s->headLen - 1 + B) * sizeof(float));
+
+    // count the stages: sizes B, 2B, 4B, .. - each one up to tap 4*S
+    numStages = 0;
+    for (S = B, offset = B; offset < filterLen; )
+    {
+        const int end = (2 * S <= maxPartLen) ? std::min(4 * S, filterLen) : filterLen;
+        offset += ((end - offset + S - 1) / S) * S;
+        ++numStages;
+        if (2 * S <= maxPartLen)
+            S *= 2;
+    }
+    s->numStages = numStages;
+    s->stages = numStages ? new (std::nothrow) zlconv_stage[numStages]() : nullptr;
+    if (!s->hrev || !s->headBuf || (numStages && !s->stages))
+    {
+        zlconv_destroy_setup(s);
+        return nullptr;
+    }
+
+    for (k = 0; k < s->headLen; ++k)
+        s->hrev[k] = (s->headLen - 1 - k < headTaps) ? filter[s->headLen - 1 - k] : 0.0F;
+
+    s->maxS = B;
+    for (k = 0, S = B, offset = B; k < numStages; ++k)
+    {
+        const int end = (2 * S <= maxPartLen) ? std::min(4 * S, filterLen) : filterLen;
+        const int P = (end - offset + S - 1) / S;
+#ifndef PF_ZLCONV_NO_THREADS
+        const int background = (S > B && (flags & ZLCONV_BACKGROUND)) ? 1 : 0;
+#else
+        const int background = 0;
+#endif
+        if (!stage_init(&s->stages[k], filter, filterLen, offset, S, P, background))
+        {
+            s->numStages = k + 1;
+            zlconv_destroy_setup(s);
+            return nullptr;
+        }
+        s->maxS = S;
+        offset += P * S;
+        if (2 * S <= maxPartLen)
+            S *= 2;
+    }
+
+    s->xring = (float*)pffft_aligned_malloc((size_t)(2 * s->maxS) * sizeof(float));
+    s->acc = (float*)pffft_aligned_malloc((size_t)s->maxS * sizeof(float));
+    if (!s->xring || !s->acc)
+    {
+        zlconv_destroy_setup(s);
+        return nullptr;
+    }
+    zlconv_reset(s);
+    return s;
+}
+
+
+void zlconv_destroy_setup(zlconv_setup * s)
+{
+    int k;
+    if (!s)
+        return;
+    for (k = 0; k < s->numStages && s->stages; ++k)
+        stage_free(&s->stages[k]);
+    delete [] s->stages;
+    pffft_aligned_free(s->hrev);
+    pffft_aligned_free(s->headBuf);
+    pffft_aligned_free(s->xring);
+    pffft_aligned_free(s->acc);
+    delete s;
+}
+
+
+void zlconv_reset(zlconv_setup * s)
+{
+    int k;
+    for (k = 0; k < s->numStages; ++k)
+    {
+        zlconv_stage * st = &s->stages[k];
+        stage_wait(st);
+        memset(st->Xf, 0, (size_t)st->P * 2 * st->S * sizeof(float));
+        memset(st->Yt, 0, (size_t)st->S * sizeof(float));
+        st->fdlPos = 0;
+    }
+    memset(s->headBuf, 0, (size_t)(s->headLen - 1) * sizeof(float));
+    s->headState.offset = 0;
+    s->headState.size = s->headLen - 1;
+    memset(s->xring, 0, (size_t)(2 * s->maxS) * sizeof(float));
+    memset(s->acc, 0, (size_t)s->maxS * sizeof(float));
+    s->T = 0;
+}
+
+
+int zlconv_num_stages(const zlconv_setup * s)
+{
+    return s->numStages;
+}
+
+
+void zlconv_stage_info(const zlconv_setup * s, int stage, int * partLen, int * numParts, int * background)
+{
+    assert(stage >= 0 && stage < s->numStages);
+    if (partLen)
+        *partLen = s->stages[stage].S;
+    if (numParts)
+        *numParts = s->stages[stage].P;
+    if (background)
+        *background = s->stages[stage].background;
+}
+
+
+static void add_to_acc(zlconv_setup * s, long long t0, const float * y, int n)
+{
+    float * a = s->acc + (t0 % s->maxS);
+    int j;
+    assert(t0 >= s->T && t0 + n <= s->T + s->maxS);
+    for (j = 0; j < n; ++j)
+        a[j] += y[j];
+}
+
+
+/* process one block of B samples: time T advanced by B */
+static void zlconv_process_block(zlconv_setup * s, const float * input, float * output)
+{
+    const int B = s->B;
+    const int R = 2 * s->maxS;
+    int k, j;
+
+    // head: direct convolution, the zero-latency part
+    memcpy(s->headBuf + s->headState.size, input, (size_t)B * sizeof(float));
+    s->headState.size += B;
+    s->conv_arch->fp_conv_float_oop(s->headBuf, &s->headState, s->hrev, s->headLen, output);
+    s->conv_arch->fp_conv_float_move_rest(s->headBuf, &s->headState);
+
+    memcpy(s->xring + (s->T % R), input, (size_t)B * sizeof(float));
+    s->T += B;
+
+    // results of the stages for [T-B, T) are already in the accumulator
+    {
+        float * a = s->acc + ((s->T - B) % s->maxS);
+        for (j = 0; j < B; ++j)
+            output[j] += a[j];
+        memset(a, 0, (size_t)B * sizeof(float));
+    }
+
+    // every S samples: collect the previous result of a stage - and start the next
+    for (k = 0; k < s->numStages; ++k)
+    {
+        zlconv_stage * st = &s->stages[k];
+        const int S = st->S;
+        if (s->T % S)
+            continue;
+
+        stage_wait(st);
+
+        // copy the input window x[T-2S .. T) - it might wrap in the ring
+        {
+            const int w0 = (int)(((s->T - 2 * S) % R + R) % R);  // the first windows start before 0
+            const int n0 = std::min(2 * S, R - w0);
+            memcpy(st->Xt, s->xring + w0, (size_t)n0 * sizeof(float));
+            memcpy(st->Xt + n0, s->xring, (size_t)(2 * S - n0) * sizeof(float));
+        }
+
+        if (S == B)
+        {
+            // u[T-S .. T) is y[T-S+offset ..): with offset == S, that's [T, T+S)
+            stage_job(st);
+            add_to_acc(s, s->T - S + st->offset, st->Yt, S);
+        }
+        else
+        {
+            // the previous job - started at T-S - delivered y[T-2S+offset .. T-S+offset):
+            // with offset == 2S, that's [T, T+S). the next job has S samples time
+            add_to_acc(s, s->T - 2 * S + st->offset, st->Yt, S);
+            stage_start(st);
+        }
+    }
+}
+
+
+int zlconv_process(zlconv_setup * s, const float * input, float * output, int len)
+{
+    int off;
+    for (off = 0; off + s->B <= len; off += s->B)
+        zlconv_process_block(s, input + off, output + off);
+    return off;
+}
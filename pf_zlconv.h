@@ -0,0 +1,64 @@
+#pragma once
+
+/* pf_zlconv.h/.cpp implements a zero-latency convolution engine for
+ * long filters (e.g. impulse responses of several seconds),
+ * with a non-uniform partitioning of the filter:
+ *
+ * - the head of the filter, the first 'blockLen' taps, is convolved
+ *   directly in time domain - with the fp_conv_float_oop() kernel from
+ *   pf_conv.h
+ * - the following taps are split into stages with partition sizes
+ *   blockLen, 2*blockLen, 4*blockLen, .. up to 'maxPartLen'. each stage
+ *   is an uniformly partitioned overlap-save with pffft - and a
+ *   frequency-domain delay line of its partitions.
+ *
+ * a stage of partition size S starts at tap 2*S (blockLen for the first):
+ * its FFTs can be computed in the background, while S samples are processed.
+ * with ZLCONV_BACKGROUND, each of these stages gets an own thread.
+ * the worst-case time per block then stays flat - instead of
+ * spiking every time a large partition completes.
+ *
+ * the output is the plain (causal) convolution: there is no delay at all
+ *   output[t] = sum_k ( filter[k] * input[t - k] )
+ * with zero input samples before the first call.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct zlconv_setup zlconv_setup;
+
+typedef enum {
+    ZLCONV_BACKGROUND = 1
+    /* compute the stages with the larger partitions (2*blockLen, ..)
+     * in background threads. ignored, when compiled without threads */
+} zlconv_flags_t;
+
+/* prepare the convolution with filter[0 .. filterLen-1].
+ * 2*blockLen has to be a valid size for the real pffft transform,
+ * see pffft_is_valid_size(). maxPartLen limits the partition size:
+ * it is rounded to blockLen * 2^k. maxPartLen <= 0 selects 16 * blockLen.
+ * returns NULL for unsuitable parameters.
+ */
+zlconv_setup * zlconv_new_setup(const float * filter, int filterLen, int blockLen, int maxPartLen, int flags);
+
+void zlconv_destroy_setup(zlconv_setup * s);
+
+/* process 'len' input samples into 'len' output samples.
+ * input and output don't need to be aligned - but they must not overlap.
+ * len has to be a multiple of blockLen: the return value is the number
+ * of processed samples, that is len rounded down to a multiple of blockLen.
+ */
+int zlconv_process(zlconv_setup * s, const float * input, float * output, int len);
+
+/* forget the input history: as if a new setup was just created */
+void zlconv_reset(zlconv_setup * s);
+
+/* number of stages with FFT partitions - and their partition size/count */
+int zlconv_num_stages(const zlconv_setup * s);
+void zlconv_stage_info(const zlconv_setup * s, int stage, int * partLen, int * numParts, int * background);
+
+#ifdef __cplusplus
+}
+#endif
@@ -36,6 +36,7 @@
    Restrictions: 
 
    - 1D transforms only, with 32-bit single precision.
+     see pffastconv_double.h for 64-bit double precision.
 
    - all (float*) pointers in the functions below are expected to
    have an "simd-compatible" alignment, that is 16 bytes on x86 and
@@ -78,7 +79,11 @@ extern "C" {
      * with real and imag part interleaved.
      * filterCoeffs[] has filterLen complex values: 2 * filterLen floats
      * without this flag, the filter is interpreted as real vector
-     * ATTENTION: this is not implemented yet!
+     * the convolution is done with one complex FFT per block.
+     * output[] is always complex - input[] is complex with
+     * PFFASTCONV_CPLX_INP_OUT, otherwise real.
+     * PFFASTCONV_DIRECT_INP, PFFASTCONV_DIRECT_OUT and
+     * PFFASTCONV_CPLX_SINGLE_FFT are ignored with this option
      */
 
     PFFASTCONV_DIRECT_INP = 4,
@@ -108,18 +113,39 @@ extern "C" {
 
 
     PFFASTCONV_SYMMETRIC = 32,
-    /* just informal, that filter is symmetric .. and filterLen is multiple of 8 */
+    /* the (real) filter is symmetric: filterCoeffs[k] == filterCoeffs[filterLen-1-k].
+     * for odd filterLen - or any filterLen with PFFASTCONV_CPLX_SINGLE_FFT -
+     * the filter is centered: its spectrum is real valued and kept packed,
+     * see pffft_zreal_pack(). this halves the memory of the spectrum and saves
+     * most of the multiplications, see pffft_zconvolve_real_no_accu().
+     * otherwise - and with PFFASTCONV_CPLX_FILTER or PFFASTCONV_PARTITIONED -
+     * this flag is just informal.
+     * for the direct convolution, see fp_conv_float_sym_oop in pf_conv.h
+     */
 
     PFFASTCONV_CORRELATION = 64,
     /* filterCoeffs[] of pffastconv_new_setup are for correlation;
      * thus, do not flip them for the internal fft calculation
      * - as necessary for the fast convolution */
 
+    PFFASTCONV_PARTITIONED = 128,
+    /* uniformly partitioned convolution, for long filters:
+     * the requested 'blockLen' is the partition size - independent of
+     * filterLen - and the FFT length is 2 * blockLen.
+     * the filter is kept as ceil(filterLen / blockLen) spectra and the
+     * spectra of the input blocks are kept in a frequency-domain
+     * delay line, which pffastconv_apply() reuses with the next call.
+     * the output is produced in blocks of 'blockLen' samples.
+     * PFFASTCONV_DIRECT_INP, PFFASTCONV_DIRECT_OUT and
+     * PFFASTCONV_CPLX_SINGLE_FFT are ignored with this option */
+
   } pffastconv_flags_t;
 
   /*
     prepare for performing fast convolution(s) of 'filterLen' with input 'blockLen'.
     The output 'blockLen' might be bigger to allow the fast convolution.
+    with PFFASTCONV_PARTITIONED, the output 'blockLen' is the partition
+    size: the number of output samples per FFT - which fixes the latency.
     
     'flags' are bitmask over the 'pffastconv_flags_t' enum.
 
@@ -128,8 +154,45 @@ extern "C" {
   */
   PFFASTCONV_Setup * pffastconv_new_setup( const float * filterCoeffs, int filterLen, int * blockLen, int flags );
 
+  /*
+    prepare for 'numFilters' filters, all with the same 'filterLen' and 'flags',
+    which are applied to the same input: e.g. a filter bank or multiple beams.
+    the filters follow each other in filterCoeffs[]: filter f starts at
+    filterCoeffs[f * filterLen] - or at [2 * f * filterLen] with PFFASTCONV_CPLX_FILTER.
+    the spectrum of each input block is computed once, then each filter
+    costs one spectral multiplication and one backward FFT.
+    use pffastconv_apply_multi() with these setups.
+    returns NULL for numFilters < 1.
+  */
+  PFFASTCONV_Setup * pffastconv_new_setup_multi( const float * filterCoeffs, int numFilters, int filterLen, int * blockLen, int flags );
+
   void pffastconv_destroy_setup(PFFASTCONV_Setup *);
 
+  /*
+    prepare the setup - as pffastconv_new_setup() - in caller provided
+    memory, without any allocation. pffastconv_setup_size() delivers the
+    required number of bytes - and the resulting 'blockLen' - or 0 for
+    unsupported parameters. 'mem' has to be 64-byte aligned.
+    pffastconv_destroy_setup() frees nothing for these setups.
+    these are always single filter setups.
+  */
+  size_t pffastconv_setup_size( int filterLen, int * blockLen, int flags );
+  PFFASTCONV_Setup * pffastconv_init_setup_inplace( void * mem, const float * filterCoeffs, int filterLen, int * blockLen, int flags );
+
+  /*
+    serialize a setup - with the precomputed filter spectrum - into a flat
+    blob, which can be saved and reopened later, e.g. at startup.
+    this works as pffft_serialize_setup() / pffft_deserialize_setup()
+    in pffft.h, also with the zero_copy option: the blob needs to be
+    64-byte aligned and stay valid until the setup is destroyed.
+    pffastconv_serialize_setup() returns the number of bytes written,
+    or 0 when blob_size is too small.
+    pffastconv_deserialize_setup() returns NULL for unsuitable blobs.
+  */
+  size_t pffastconv_serialized_size( const PFFASTCONV_Setup * s );
+  size_t pffastconv_serialize_setup( const PFFASTCONV_Setup * s, void * blob, size_t blob_size );
+  PFFASTCONV_Setup * pffastconv_deserialize_setup( const void * blob, size_t blob_size, int zero_copy );
+
   /* 
      Perform the fast convolution.
 
@@ -154,9 +217,64 @@ extern "C" {
      processing, the caller must save/move the remaining samples of
      input[].
 
+     with PFFASTCONV_PARTITIONED, the spectra of the remaining input
+     blocks are kept in the setup: the next call has to continue with
+     exactly these remaining samples - or pffastconv_reset() has to be
+     called before. 'applyFlush' also resets the setup.
+
   */
   int pffastconv_apply(PFFASTCONV_Setup * s, const float *input, int inputLen, float *output, int applyFlush);
 
+  /*
+    the same as pffastconv_apply() - for a setup from pffastconv_new_setup_multi():
+    outputs[f] receives the output of filter f, with the conditions and
+    size as 'output' of pffastconv_apply(). pffastconv_apply() may only
+    be used for single filter setups.
+  */
+  int pffastconv_apply_multi(PFFASTCONV_Setup * s, const float *input, int inputLen, float * const * outputs, int applyFlush);
+
+  /*
+    streaming fast convolution: the setup keeps the overlap - the last
+    filterLen-1 input samples - and the unprocessed samples internally.
+    input[] can be pushed in chunks of any length, also single samples.
+    the output is the plain continuous FIR filter output: output sample n
+    corresponds to input sample n - with zero samples before the first call:
+      output[n] = sum_k ( filterCoeffs[k] * input[n - k] )
+    - or with PFFASTCONV_CORRELATION: sum_k ( filterCoeffs[filterLen-1-k] * input[n - k] )
+
+    output is produced in blocks, whenever an FFT block is complete:
+    the return value is the number of (complex) samples written to output[],
+    which needs room for inputLen + 'blockLen' (from pffastconv_new_setup()) samples.
+
+    long chunks are processed directly from input[] - and the backward FFT
+    writes directly into output[], when that is aligned: the FFTs do without
+    any extra copy, but the one of the few unprocessed samples at the end.
+    the internal buffer is allocated with the first call.
+
+    not for in-place or multi filter setups - and not with PFFASTCONV_DIRECT_INP/OUT.
+    don't mix with pffastconv_apply() on the same setup.
+    pffastconv_reset() restarts the stream.
+  */
+  int pffastconv_stream(PFFASTCONV_Setup * s, const float *input, int inputLen, float *output);
+
+  /*
+    forget the input spectra kept in a PFFASTCONV_PARTITIONED setup - and the
+    state of pffastconv_stream(), e.g. before starting with a new input.
+    no-op for other setups.
+  */
+  void pffastconv_reset(PFFASTCONV_Setup * s);
+
+  /*
+    optional instrumentation, see pffft_get_instr_snapshot() in pffft.h:
+    'apply' receives the counters of pffastconv_apply(), pffastconv_apply_multi()
+    and pffastconv_stream() - samples are the produced output samples per filter.
+    'fft' receives the counters of the internal pffft setup: the split into
+    transforms and spectral multiplications. either pointer may be NULL.
+    returns 0 and zeros both, when the instrumentation is not compiled in.
+  */
+  int pffastconv_get_instr_snapshot(const PFFASTCONV_Setup * s, pffft_instr_counter_t * apply, pffft_instr_snapshot_t * fft);
+  void pffastconv_reset_instr(PFFASTCONV_Setup * s);
+
   void *pffastconv_malloc(size_t nb_bytes);
   void pffastconv_free(void *);
 
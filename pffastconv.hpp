@@ -0,0 +1,273 @@
+/* Copyright (c) 2019  Hayati Ayguen ( h_ayguen@web.de )
+
+   Redistribution and use of the Software in source and binary forms,
+   with or without modification, is permitted provided that the
+   following conditions are met:
+
+   - Neither the names of PFFFT, PFFASTCONV, nor the names of its
+   sponsors or contributors may be used to endorse or promote products
+   derived from this Software without specific prior written permission.
+
+   - Redistributions of source code must retain the above copyright
+   notices, this list of conditions, and the disclaimer below.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions, and the disclaimer below in the
+   documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+   SOFTWARE.
+*/
+
+#pragma once
+
+#include "pffft.hpp"
+
+namespace pffft {
+namespace detail {
+#include "pffastconv.h"
+#if defined(PFFFT_ENABLE_DOUBLE)
+#include "pffastconv_double.h"
+#endif
+}
+}
+
+namespace pffft {
+
+// the flags of pffastconv.h: PFFASTCONV_CPLX_INP_OUT, .., PFFASTCONV_PARTITIONED
+typedef detail::pffastconv_flags_t FastConvFlags;
+
+namespace detail {
+  template<typename T> class ConvSetup;
+}
+
+
+// T can be float or double - for the scalar type of filter, input and output.
+//   define PFFFT_ENABLE_DOUBLE before include this file for double
+// complex data is interleaved, as in pffastconv.h: selected with the flags
+// PFFASTCONV_CPLX_INP_OUT and PFFASTCONV_CPLX_FILTER.
+// all functions work as their counterparts pffastconv_*() in pffastconv.h:
+// the input and output sizes are in (complex) samples.
+template<typename T>
+class FastConvolution
+{
+public:
+  typedef T value_type;
+  typedef T Scalar;
+
+  /*
+   * prepare the convolution with filter[0 .. filterLen-1]
+   * - or numFilters filters, one after the other, see pffastconv_new_setup_multi().
+   * blockLen is the requested input block length, see getBlockLen()
+   */
+  FastConvolution( const T * filter, int filterLen, int blockLen, int flags = 0 );
+  FastConvolution( const T * filter, int numFilters, int filterLen, int blockLen, int flags );
+
+  ~FastConvolution();
+
+  // constructor produced a valid instance?
+  bool isValid() const { return setup.isValid(); }
+
+  // output block length - from pffastconv_new_setup()
+  int getBlockLen() const { return blockLen; }
+  int getFilterLen() const { return filterLen; }
+  int getNumFilters() const { return numFilters; }
+  int getFlags() const { return flags; }
+
+  // number of Scalar values per (complex) input / output sample
+  int inputFactor() const { return (flags & detail::PFFASTCONV_CPLX_INP_OUT) ? 2 : 1; }
+  int outputFactor() const { return (flags & (detail::PFFASTCONV_CPLX_INP_OUT | detail::PFFASTCONV_CPLX_FILTER)) ? 2 : 1; }
+
+  // see pffastconv_apply(): returns the number of output samples
+  int apply(const T * input, int inputLen, T * output, bool flush = false)
+  {
+    return setup.apply(input, inputLen, output, flush ? 1 : 0);
+  }
+
+  // see pffastconv_apply_multi(): outputs[f] for filter f
+  int applyMulti(const T * input, int inputLen, T * const * outputs, bool flush = false)
+  {
+    return setup.applyMulti(input, inputLen, outputs, flush ? 1 : 0);
+  }
+
+  // see pffastconv_stream(): output needs room for inputLen + getBlockLen() samples
+  int stream(const T * input, int inputLen, T * output)
+  {
+    return setup.stream(input, inputLen, output);
+  }
+
+  // see pffastconv_reset()
+  void reset() { setup.reset(); }
+
+  /*
+   * vector variants: the size of input is in Scalar values, output is
+   * resized to the produced samples. AlignedVector fulfills the alignment
+   * for PFFASTCONV_DIRECT_INP / PFFASTCONV_DIRECT_OUT.
+   */
+  AlignedVector<T> & apply(const AlignedVector<T> & input, AlignedVector<T> & output, bool flush = false);
+  AlignedVector<T> & stream(const AlignedVector<T> & input, AlignedVector<T> & output);
+
+private:
+  // non-copyable: the setup keeps state
+  FastConvolution(const FastConvolution &);
+  FastConvolution & operator=(const FastConvolution &);
+
+  detail::ConvSetup<T> setup;
+  int blockLen;
+  int filterLen;
+  int numFilters;
+  int flags;
+};
+
+
+////////////////////////////////////////////////////////////////////
+
+// implementation
+
+namespace detail {
+
+template<typename T>
+class ConvSetup
+{};
+
+#if defined(PFFFT_ENABLE_FLOAT) || ( !defined(PFFFT_ENABLE_FLOAT) && !defined(PFFFT_ENABLE_DOUBLE) )
+
+template<>
+class ConvSetup<float>
+{
+  PFFASTCONV_Setup* self;
+
+public:
+  ConvSetup() : self(NULL) {}
+  ~ConvSetup() { pffastconv_destroy_setup(self); }
+
+  void prepare(const float * filter, int numFilters, int filterLen, int * blockLen, int flags)
+  {
+    pffastconv_destroy_setup(self);
+    self = pffastconv_new_setup_multi(filter, numFilters, filterLen, blockLen, flags);
+  }
+
+  bool isValid() const { return (self); }
+
+  int apply(const float * input, int inputLen, float * output, int flush)
+  {
+    return pffastconv_apply(self, input, inputLen, output, flush);
+  }
+
+  int applyMulti(const float * input, int inputLen, float * const * outputs, int flush)
+  {
+    return pffastconv_apply_multi(self, input, inputLen, outputs, flush);
+  }
+
+  int stream(const float * input, int inputLen, float * output)
+  {
+    return pffastconv_stream(self, input, inputLen, output);
+  }
+
+  void reset() { pffastconv_reset(self); }
+};
+
+#endif
+
+#if defined(PFFFT_ENABLE_DOUBLE)
+
+template<>
+class ConvSetup<double>
+{
+  PFFASTCONVD_Setup* self;
+
+public:
+  ConvSetup() : self(NULL) {}
+  ~ConvSetup() { pffastconvd_destroy_setup(self); }
+
+  void prepare(const double * filter, int numFilters, int filterLen, int * blockLen, int flags)
+  {
+    pffastconvd_destroy_setup(self);
+    self = pffastconvd_new_setup_multi(filter, numFilters, filterLen, blockLen, flags);
+  }
+
+  bool isValid() const { return (self); }
+
+  int apply(const double * input, int inputLen, double * output, int flush)
+  {
+    return pffastconvd_apply(self, input, inputLen, output, flush);
+  }
+
+  int applyMulti(const double * input, int inputLen, double * const * outputs, int flush)
+  {
+    return pffastconvd_apply_multi(self, input, inputLen, outputs, flush);
+  }
+
+  int stream(const double * input, int inputLen, double * output)
+  {
+    return pffastconvd_stream(self, input, inputLen, output);
+  }
+
+  void reset() { pffastconvd_reset(self); }
+};
+
+#endif
+
+} // end of namespace detail for ConvSetup<>
+
+
+template<typename T>
+inline FastConvolution<T>::FastConvolution( const T * filter, int filterLen, int blockLen, int flags )
+  : blockLen(blockLen)
+  , filterLen(filterLen)
+  , numFilters(1)
+  , flags(flags)
+{
+  setup.prepare(filter, 1, filterLen, &this->blockLen, flags);
+}
+
+template<typename T>
+inline FastConvolution<T>::FastConvolution( const T * filter, int numFilters, int filterLen, int blockLen, int flags )
+  : blockLen(blockLen)
+  , filterLen(filterLen)
+  , numFilters(numFilters)
+  , flags(flags)
+{
+  setup.prepare(filter, numFilters, filterLen, &this->blockLen, flags);
+}
+
+template<typename T>
+inline FastConvolution<T>::~FastConvolution()
+{
+}
+
+template<typename T>
+inline AlignedVector<T> &
+FastConvolution<T>::apply(const AlignedVector<T> & input, AlignedVector<T> & output, bool flush)
+{
+  const int inputLen = int(input.size()) / inputFactor();
+  int outLen = (inputLen > filterLen) ? inputLen - filterLen + 1 : 1;
+  // PFFASTCONV_DIRECT_OUT: the backward FFT writes a complete block into output
+  if ( (flags & detail::PFFASTCONV_DIRECT_OUT) && outLen < blockLen )
+    outLen = blockLen;
+  output.resize( outputFactor() * outLen );
+  const int n = apply(input.data(), inputLen, output.data(), flush);
+  output.resize( outputFactor() * n );
+  return output;
+}
+
+template<typename T>
+inline AlignedVector<T> &
+FastConvolution<T>::stream(const AlignedVector<T> & input, AlignedVector<T> & output)
+{
+  const int inputLen = int(input.size()) / inputFactor();
+  output.resize( outputFactor() * (inputLen + blockLen) );
+  const int n = stream(input.data(), inputLen, output.data());
+  output.resize( outputFactor() * n );
+  return output;
+}
+
+} // namespace pffft
@@ -0,0 +1,60 @@
+/*
+  Copyright (c) 2019  Hayati Ayguen ( h_ayguen@web.de )
+ */
+
+#include "pffastconv_double.h"
+#include "pffft_double.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+#include <assert.h>
+#include <string.h>
+
+/* have code comparable with this definition */
+#define float double
+
+#define SETUP_STRUCT                 PFFASTCONVD_Setup
+#define FFT_SETUP                    PFFFTD_Setup
+#define FASTCONV_BLOB_MAGIC          0x50464344u  /* "PFCD" */
+
+#define FUNC_MALLOC                  pffastconvd_malloc
+#define FUNC_FREE                    pffastconvd_free
+#define FUNC_SIMD_SIZE               pffastconvd_simd_size
+#define FUNC_NEW_SETUP               pffastconvd_new_setup
+#define FUNC_NEW_SETUP_MULTI         pffastconvd_new_setup_multi
+#define FUNC_DESTROY_SETUP           pffastconvd_destroy_setup
+#define FUNC_SETUP_SIZE              pffastconvd_setup_size
+#define FUNC_INIT_SETUP_INPLACE      pffastconvd_init_setup_inplace
+#define FUNC_SERIALIZED_SIZE         pffastconvd_serialized_size
+#define FUNC_SERIALIZE_SETUP         pffastconvd_serialize_setup
+#define FUNC_DESERIALIZE_SETUP       pffastconvd_deserialize_setup
+#define FUNC_APPLY                   pffastconvd_apply
+#define FUNC_APPLY_MULTI             pffastconvd_apply_multi
+#define FUNC_STREAM                  pffastconvd_stream
+#define FUNC_RESET                   pffastconvd_reset
+#define FUNC_GET_INSTR               pffastconvd_get_instr_snapshot
+#define FUNC_RESET_INSTR             pffastconvd_reset_instr
+
+#define FFT_ALIGNED_MALLOC           pffftd_aligned_malloc
+#define FFT_ALIGNED_FREE             pffftd_aligned_free
+#define FFT_SIMD_SIZE                pffftd_simd_size
+#define FFT_NEXT_POWER_OF_TWO        pffftd_next_power_of_two
+#define FFT_NEW_SETUP                pffftd_new_setup
+#define FFT_DESTROY_SETUP            pffftd_destroy_setup
+#define FFT_SETUP_SIZE               pffftd_setup_size
+#define FFT_INIT_SETUP_INPLACE       pffftd_init_setup_inplace
+#define FFT_SERIALIZED_SIZE          pffftd_serialized_size
+#define FFT_SERIALIZE_SETUP          pffftd_serialize_setup
+#define FFT_DESERIALIZE_SETUP        pffftd_deserialize_setup
+#define FFT_TRANSFORM                pffftd_transform
+#define FFT_ZCONVOLVE_ACCUMULATE     pffftd_zconvolve_accumulate
+#define FFT_ZCONVOLVE_NO_ACCU        pffftd_zconvolve_no_accu
+#define FFT_ZCONVOLVE_REAL_NO_ACCU   pffftd_zconvolve_real_no_accu
+#define FFT_ZCONVOLVE_TRANSFORM_BW   pffftd_zconvolve_transform_backward
+#define FFT_ZREAL_PACK               pffftd_zreal_pack
+#define FFT_GET_INSTR                pffftd_get_instr_snapshot
+#define FFT_RESET_INSTR              pffftd_reset_instr
+
+#include "pffastconv_priv_impl.h"
@@ -0,0 +1,97 @@
+/* Copyright (c) 2019  Hayati Ayguen ( h_ayguen@web.de )
+
+   Redistribution and use of the Software in source and binary forms,
+   with or without modification, is permitted provided that the
+   following conditions are met:
+
+   - Neither the names of PFFFT, PFFASTCONV, nor the names of its
+   sponsors or contributors may be used to endorse or promote products
+   derived from this Software without specific prior written permission.  
+
+   - Redistributions of source code must retain the above copyright
+   notices, this list of conditions, and the disclaimer below.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions, and the disclaimer below in the
+   documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+   SOFTWARE.
+*/
+
+/*
+   PFFASTCONVD : the double precision variant of PFFASTCONV
+
+   the same fast convolution as in pffastconv.h - with 64-bit double
+   precision, utilizing pffftd from pffft_double.h, e.g. for long
+   matched filters, where the float accuracy doesn't suffice.
+
+   all functions, flags and conditions are the same as their float
+   counterparts pffastconv_*() - with double instead of float:
+   the flags are the pffastconv_flags_t from pffastconv.h.
+   the (double*) pointers are expected to have the alignment of
+   pffftd_aligned_malloc(), e.g. 32 bytes with AVX.
+*/
+
+#ifndef PFFASTCONV_DOUBLE_H
+#define PFFASTCONV_DOUBLE_H
+
+#include <stddef.h> /* for size_t */
+#include "pffastconv.h"
+#include "pffft_double.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /* opaque struct - as PFFASTCONV_Setup: can't be shared by concurrent threads */
+  typedef struct PFFASTCONVD_Setup PFFASTCONVD_Setup;
+
+  /* see pffastconv_new_setup() and pffastconv_new_setup_multi() */
+  PFFASTCONVD_Setup * pffastconvd_new_setup( const double * filterCoeffs, int filterLen, int * blockLen, int flags );
+  PFFASTCONVD_Setup * pffastconvd_new_setup_multi( const double * filterCoeffs, int numFilters, int filterLen, int * blockLen, int flags );
+
+  void pffastconvd_destroy_setup(PFFASTCONVD_Setup *);
+
+  /* see pffastconv_setup_size() and pffastconv_init_setup_inplace() */
+  size_t pffastconvd_setup_size( int filterLen, int * blockLen, int flags );
+  PFFASTCONVD_Setup * pffastconvd_init_setup_inplace( void * mem, const double * filterCoeffs, int filterLen, int * blockLen, int flags );
+
+  /* see pffastconv_serialize_setup(): blobs of float setups are not accepted - and vice versa */
+  size_t pffastconvd_serialized_size( const PFFASTCONVD_Setup * s );
+  size_t pffastconvd_serialize_setup( const PFFASTCONVD_Setup * s, void * blob, size_t blob_size );
+  PFFASTCONVD_Setup * pffastconvd_deserialize_setup( const void * blob, size_t blob_size, int zero_copy );
+
+  /* see pffastconv_apply(), pffastconv_apply_multi() and pffastconv_stream() */
+  int pffastconvd_apply(PFFASTCONVD_Setup * s, const double *input, int inputLen, double *output, int applyFlush);
+  int pffastconvd_apply_multi(PFFASTCONVD_Setup * s, const double *input, int inputLen, double * const * outputs, int applyFlush);
+  int pffastconvd_stream(PFFASTCONVD_Setup * s, const double *input, int inputLen, double *output);
+
+  /* see pffastconv_reset() */
+  void pffastconvd_reset(PFFASTCONVD_Setup * s);
+
+  /* see pffastconv_get_instr_snapshot() and pffastconv_reset_instr() */
+  int pffastconvd_get_instr_snapshot(const PFFASTCONVD_Setup * s, pffft_instr_counter_t * apply, pffft_instr_snapshot_t * fft);
+  void pffastconvd_reset_instr(PFFASTCONVD_Setup * s);
+
+  void *pffastconvd_malloc(size_t nb_bytes);
+  void pffastconvd_free(void *);
+
+  /* return the SIMD width of pffft_double.c: e.g. 4 with AVX - or 1 without SIMD */
+  int pffastconvd_simd_size();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PFFASTCONV_DOUBLE_H */
@@ -0,0 +1,913 @@
+/*
+  Copyright (c) 2019  Hayati Ayguen ( h_ayguen@web.de )
+ */
+
+/* implementation of pffastconv.c and pffastconv_double.c:
+ * the including file defines the public names - and 'float' for the double precision,
+ * comparable to pffft_priv_impl.h:
+ *
+ *  SETUP_STRUCT      PFFASTCONV_Setup / PFFASTCONVD_Setup
+ *  FUNC_*            pffastconv_* / pffastconvd_* - the public API
+ *  FFT_SETUP, FFT_*  PFFFT_Setup / PFFFTD_Setup and the pffft_* / pffftd_* functions
+ *  FASTCONV_BLOB_MAGIC  of the serialized setup: a float blob can't be loaded as double
+ */
+
+#define FASTCONV_DBG_OUT  0
+
+
+/* detect compiler flavour */
+#if defined(_MSC_VER)
+#  define RESTRICT __restrict
+#pragma warning( disable : 4244 4305 4204 4456 )
+#elif defined(__GNUC__)
+#  define RESTRICT __restrict
+#endif
+
+#include "pffft_instr_impl.h"
+
+
+void *FUNC_MALLOC(size_t nb_bytes)
+{
+  return FFT_ALIGNED_MALLOC(nb_bytes);
+}
+
+void FUNC_FREE(void *p)
+{
+  FFT_ALIGNED_FREE(p);
+}
+
+int FUNC_SIMD_SIZE()
+{
+  return FFT_SIMD_SIZE();
+}
+
+
+
+struct SETUP_STRUCT
+{
+  float * Xt;      /* input == x in time domain - copy for alignment */
+  float * Xf;      /* input == X in freq domain - the delay line with PFFASTCONV_PARTITIONED */
+  float * Hf;      /* filterCoeffs == H in freq domain - one spectrum per partition */
+  float * Mf;      /* input * filterCoeffs in freq domain */
+  FFT_SETUP *st;
+  int filterLen;   /* convolution length */
+  int Nfft;        /* FFT/block length */
+  int flags;
+  float scale;
+  int extHf;       /* Hf references the blob of FUNC_DESERIALIZE_SETUP() */
+  int inplace;     /* all in caller's memory, see FUNC_INIT_SETUP_INPLACE() */
+  int numPartitions; /* number of filter spectra in Hf - per filter */
+  int numFilters;  /* number of filters sharing the input spectrum, see FUNC_NEW_SETUP_MULTI() */
+  int symDelay;    /* PFFASTCONV_SYMMETRIC: Hf is the packed real spectrum of the filter - centered by this delay. else -1 */
+  int fdlPos;      /* delay line: ring position of the oldest input spectrum */
+  int fdlCount;    /* delay line: number of valid input spectra */
+  float * Xs;      /* FUNC_STREAM(): pending input samples - preceded by the history. allocated with the first call */
+  int xsLen;       /* FUNC_STREAM(): number of (complex) samples in Xs */
+#if defined(PFFFT_ENABLE_INSTRUMENTATION)
+  pffft_instr_counter_t instr;  /* FUNC_APPLY(), FUNC_APPLY_MULTI() and FUNC_STREAM(), see FUNC_GET_INSTR() */
+#endif
+};
+
+
+static int fastconv_cplx_factor( int flags )
+{
+  return ( (flags & PFFASTCONV_CPLX_INP_OUT) && (flags & PFFASTCONV_CPLX_SINGLE_FFT)
+      && !(flags & (PFFASTCONV_PARTITIONED | PFFASTCONV_CPLX_FILTER)) ) ? 2 : 1;
+}
+
+/* a complex filter is processed with a complex FFT of Nfft points: each buffer has 2 * Nfft floats */
+static int fastconv_spec_len( int Nfft, int flags )
+{
+  return ( flags & PFFASTCONV_CPLX_FILTER ) ? 2 * Nfft : Nfft;
+}
+
+static pffft_transform_t fastconv_fft_type( int flags )
+{
+  return ( flags & PFFASTCONV_CPLX_FILTER ) ? PFFFT_COMPLEX : PFFFT_REAL;
+}
+
+/* number of FFTs per input block: real and imag part of complex input are filtered separately with a real filter */
+static int fastconv_num_parts( int flags )
+{
+  return ( (flags & PFFASTCONV_CPLX_INP_OUT) && !(flags & PFFASTCONV_CPLX_FILTER) ) ? 2 : 1;
+}
+
+/* convolution length: the single FFT for complex data has two samples per tap */
+static int fastconv_conv_len( int filterLen, int flags )
+{
+  return ( fastconv_cplx_factor( flags ) == 2 ) ? 2 * filterLen - 1 : filterLen;
+}
+
+/* a symmetric filter of odd convolution length gets a real valued spectrum, when centered
+ * around the 0th sample: delay by (convLen-1)/2 - the output is read from there.
+ * returns -1, when the complete spectrum is used */
+static int fastconv_sym_delay( int convLen, int flags )
+{
+  if ( !(flags & PFFASTCONV_SYMMETRIC) || (flags & (PFFASTCONV_PARTITIONED | PFFASTCONV_CPLX_FILTER)) || !(convLen & 1) )
+    return -1;
+  return ( convLen - 1 ) / 2;
+}
+
+/* number of filter spectra: the partitions have a length of Nfft/2 */
+static int fastconv_num_partitions( int filterLen, int Nfft, int flags )
+{
+  if ( !(flags & PFFASTCONV_PARTITIONED) )
+    return 1;
+  return ( filterLen + Nfft / 2 - 1 ) / ( Nfft / 2 );
+}
+
+/* number of input spectra in Xf: the delay line keeps one per partition and real/imag part */
+static int fastconv_num_inp_spectra( int filterLen, int Nfft, int flags )
+{
+  if ( !(flags & PFFASTCONV_PARTITIONED) )
+    return 1;
+  return fastconv_num_partitions( filterLen, Nfft, flags ) * fastconv_num_parts( flags );
+}
+
+
+/* number of floats of one filter spectrum - or partition - in Hf, see FFT_ZREAL_PACK() */
+static int fastconv_hf_len( int convLen, int Nfft, int flags )
+{
+  if ( fastconv_sym_delay( convLen, flags ) >= 0 )
+    return Nfft / 2 + FFT_SIMD_SIZE();
+  return fastconv_spec_len( Nfft, flags );
+}
+
+
+/* FFT length for the filter and (requested) block length - also fixes blockLen */
+static int fastconv_fft_len( int filterLen, int * blockLen, int flags )
+{
+  const int cplxFactor = fastconv_cplx_factor( flags );
+  const int minFftLen = 2*FFT_SIMD_SIZE()*FFT_SIMD_SIZE();
+  int Nfft = 2 * FFT_NEXT_POWER_OF_TWO(filterLen -1);
+
+  if ( flags & PFFASTCONV_PARTITIONED ) {
+    /* FFT length 2 * partition size: independent of filterLen */
+    Nfft = 2 * FFT_NEXT_POWER_OF_TWO( *blockLen > 1 ? *blockLen : 1 );
+    if ( Nfft < minFftLen )
+      Nfft = minFftLen;
+    *blockLen = Nfft / 2;
+    return Nfft;
+  }
+
+  if ( Nfft < minFftLen )
+    Nfft = minFftLen;
+
+  if ( *blockLen > Nfft ) {
+    Nfft = *blockLen;
+    Nfft = FFT_NEXT_POWER_OF_TWO(Nfft);
+  }
+  *blockLen = Nfft;  /* this is in (complex) samples */
+
+  return Nfft * cplxFactor;
+}
+
+/* compute the spectrum - or the spectra of all partitions - of one filter into Hf */
+static void fastconv_init_filter( SETUP_STRUCT * s, const float * filterCoeffs, int filterLen, float * Hf )
+{
+  const int Nfft = s->Nfft;
+  const int flags = s->flags;
+  const int cplxFactor = fastconv_cplx_factor( flags );
+  const int specLen = fastconv_spec_len( Nfft, flags );
+  const int cplxFilter = ( flags & PFFASTCONV_CPLX_FILTER ) ? 1 : 0;
+  float * Ht = s->Xt ? s->Xt : s->Xf;  /* temporary buffer for the flipped filter */
+  int i, p, k;
+
+  if ( flags & PFFASTCONV_PARTITIONED ) {
+    /* the flipped filter is zero padded at the front to numPartitions * B taps:
+     * partition p has the taps p*B .. p*B + B-1. the padding meets the samples
+     * before each output block, which are never required - see fastconv_apply_partitioned() */
+    const int B = Nfft / 2;
+    const int pad = s->numPartitions * B - filterLen;
+    for ( p = 0; p < s->numPartitions; ++p ) {
+      memset( Ht, 0, (unsigned)specLen * sizeof(float) );
+      for ( i = 0; i < B; ++i ) {
+        k = p * B + i - pad;  /* index into the flipped filter */
+        if ( k < 0 || k >= filterLen )
+          continue;
+        if ( !(flags & PFFASTCONV_CORRELATION) )
+          k = filterLen - 1 - k;
+        if ( cplxFilter ) {
+          Ht[ 2 * ( ( Nfft - i ) & (Nfft -1) )     ] = filterCoeffs[ 2 * k ];
+          Ht[ 2 * ( ( Nfft - i ) & (Nfft -1) ) + 1 ] = filterCoeffs[ 2 * k + 1 ];
+        } else
+          Ht[ ( Nfft - i ) & (Nfft -1) ] = filterCoeffs[ k ];
+      }
+      FFT_TRANSFORM(s->st, Ht, Hf + (size_t)p * specLen, /* tmp = */ s->Mf, PFFFT_FORWARD);
+    }
+    return;
+  }
+
+  memset( Ht, 0, (unsigned)specLen * sizeof(float) );
+  if ( s->symDelay >= 0 ) {
+    /* symmetric: flipping doesn't matter. centered, the spectrum is real */
+    for ( i = 0; i < filterLen; ++i )
+      Ht[ ( Nfft - cplxFactor * i + s->symDelay ) & (Nfft -1) ] = filterCoeffs[ i ];
+    FFT_TRANSFORM(s->st, Ht, Ht, /* tmp = */ s->Mf, PFFFT_FORWARD);
+    FFT_ZREAL_PACK(s->st, Ht, Hf);
+    return;
+  }
+  if ( cplxFilter ) {
+    for ( i = 0; i < filterLen; ++i ) {
+      k = ( flags & PFFASTCONV_CORRELATION ) ? i : (filterLen - 1 - i);
+      Ht[ 2 * ( ( Nfft - i ) & (Nfft -1) )     ] = filterCoeffs[ 2 * k ];
+      Ht[ 2 * ( ( Nfft - i ) & (Nfft -1) ) + 1 ] = filterCoeffs[ 2 * k + 1 ];
+    }
+  } else if ( flags & PFFASTCONV_CORRELATION ) {
+    for ( i = 0; i < filterLen; ++i )
+      Ht[ ( Nfft - cplxFactor * i ) & (Nfft -1) ] = filterCoeffs[ i ];
+  } else {
+    for ( i = 0; i < filterLen; ++i )
+      Ht[ ( Nfft - cplxFactor * i ) & (Nfft -1) ] = filterCoeffs[ filterLen - 1 - i ];
+  }
+
+  FFT_TRANSFORM(s->st, Ht, Hf, /* tmp = */ s->Mf, PFFFT_FORWARD);
+}
+
+/* fill the setup with its buffers allocated: computes the filter spectra.
+ * the filters follow each other in filterCoeffs - and in Hf */
+static void fastconv_init( SETUP_STRUCT * s, const float * filterCoeffs, int numFilters, int filterLen, int Nfft, int flags )
+{
+  const int coeffStride = ( flags & PFFASTCONV_CPLX_FILTER ) ? 2 * filterLen : filterLen;
+  const int convLen = fastconv_conv_len( filterLen, flags );
+  const int hfLen = fastconv_hf_len( convLen, Nfft, flags );
+  int f;
+
+  s->filterLen = convLen;        /* filterLen == convolution length == length of impulse response */
+  s->Nfft = Nfft;  /* FFT/block length */
+  s->flags = flags;
+  s->scale = (float)( 1.0 / Nfft );
+  s->extHf = 0;
+  s->inplace = 0;
+  s->Xs = NULL;
+  s->xsLen = 0;
+  s->numPartitions = fastconv_num_partitions( filterLen, Nfft, flags );
+  s->numFilters = numFilters;
+  s->symDelay = fastconv_sym_delay( convLen, flags );
+  s->fdlPos = 0;
+  s->fdlCount = 0;
+#if defined(PFFFT_ENABLE_INSTRUMENTATION)
+  memset( &s->instr, 0, sizeof(s->instr) );
+#endif
+
+  for ( f = 0; f < numFilters; ++f )
+    fastconv_init_filter( s, filterCoeffs + (size_t)f * coeffStride, filterLen,
+                          s->Hf + (size_t)f * s->numPartitions * hfLen );
+}
+
+/* multiple filters need Xt as work buffer: Xf has to survive the backward FFTs */
+static int fastconv_has_xt( int flags, int numFilters )
+{
+  return numFilters > 1 || !( (flags & PFFASTCONV_DIRECT_INP) && !(flags & PFFASTCONV_CPLX_INP_OUT)
+      && !(flags & (PFFASTCONV_PARTITIONED | PFFASTCONV_CPLX_FILTER)) );
+}
+
+
+SETUP_STRUCT * FUNC_NEW_SETUP( const float * filterCoeffs, int filterLen, int * blockLen, int flags )
+{
+  return FUNC_NEW_SETUP_MULTI( filterCoeffs, 1, filterLen, blockLen, flags );
+}
+
+
+SETUP_STRUCT * FUNC_NEW_SETUP_MULTI( const float * filterCoeffs, int numFilters, int filterLen, int * blockLen, int flags )
+{
+  SETUP_STRUCT * s = NULL;
+  int Nfft, specLen;
+#if FASTCONV_DBG_OUT
+  const int iOldBlkLen = *blockLen;
+#endif
+
+  if ( numFilters < 1 )
+    return NULL;
+  Nfft = fastconv_fft_len( filterLen, blockLen, flags );
+  specLen = fastconv_spec_len( Nfft, flags );
+
+  s = FUNC_MALLOC( sizeof(struct SETUP_STRUCT) );
+
+  if ( !fastconv_has_xt(flags, numFilters) )
+    s->Xt = NULL;
+  else
+    s->Xt = FUNC_MALLOC((unsigned)specLen * sizeof(float));
+  s->Xf = FUNC_MALLOC((size_t)fastconv_num_inp_spectra(filterLen, Nfft, flags) * specLen * sizeof(float));
+  s->Hf = FUNC_MALLOC((size_t)numFilters * fastconv_num_partitions(filterLen, Nfft, flags)
+                            * fastconv_hf_len(fastconv_conv_len(filterLen, flags), Nfft, flags) * sizeof(float));
+  s->Mf = FUNC_MALLOC((unsigned)specLen * sizeof(float));
+  /* real filter with complex data: we do 2 x fft() */
+  s->st = FFT_NEW_SETUP(Nfft, fastconv_fft_type(flags));
+  fastconv_init( s, filterCoeffs, numFilters, filterLen, Nfft, flags );
+
+#if FASTCONV_DBG_OUT
+  printf("\n  fastConvSetup(filterLen = %d, blockLen %d) --> blockLen %d, OutLen = %d\n"
+    , filterLen, iOldBlkLen, *blockLen, Nfft - filterLen +1 );
+#endif
+
+  return s;
+}
+
+
+/* in-place layout: the struct, Xt, Xf, Hf, Mf and the pffft setup - each 64-byte aligned.
+ * with PFFASTCONV_PARTITIONED, Xf and Hf have multiple spectra */
+#define FASTCONV_MEM_PAD(n)   ( ((n) + 63) & ~(size_t)63 )
+#define FASTCONV_IS_ALIGNED(p)  ( ((uintptr_t)(p) % 64) == 0 )
+
+size_t FUNC_SETUP_SIZE( int filterLen, int * blockLen, int flags )
+{
+  size_t fftBytes;
+  int Nfft;
+  Nfft = fastconv_fft_len( filterLen, blockLen, flags );
+  fftBytes = FFT_SETUP_SIZE(Nfft, fastconv_fft_type(flags));
+  if ( !fftBytes )
+    return 0;
+  return FASTCONV_MEM_PAD(sizeof(struct SETUP_STRUCT))
+    + (size_t)( 2 + fastconv_num_inp_spectra(filterLen, Nfft, flags) + fastconv_num_partitions(filterLen, Nfft, flags) )
+      * FASTCONV_MEM_PAD((size_t)fastconv_spec_len(Nfft, flags) * sizeof(float)) + fftBytes;
+}
+
+
+SETUP_STRUCT * FUNC_INIT_SETUP_INPLACE( void * mem, const float * filterCoeffs, int filterLen, int * blockLen, int flags )
+{
+  SETUP_STRUCT * s = (SETUP_STRUCT*)mem;
+  char * p = (char*)mem;
+  size_t bufBytes;
+  int Nfft, numXf, numHf;
+
+  if ( !mem || ((uintptr_t)mem % 64) || !FUNC_SETUP_SIZE( filterLen, blockLen, flags ) )
+    return NULL;
+  Nfft = fastconv_fft_len( filterLen, blockLen, flags );
+  bufBytes = FASTCONV_MEM_PAD((size_t)fastconv_spec_len(Nfft, flags) * sizeof(float));
+  numXf = fastconv_num_inp_spectra( filterLen, Nfft, flags );
+  numHf = fastconv_num_partitions( filterLen, Nfft, flags );
+
+  p += FASTCONV_MEM_PAD(sizeof(struct SETUP_STRUCT));
+  s->Xt = fastconv_has_xt(flags, 1) ? (float*)p : NULL;
+  s->Xf = (float*)(p + bufBytes);
+  s->Hf = (float*)(p + (size_t)(1 + numXf) * bufBytes);
+  s->Mf = (float*)(p + (size_t)(1 + numXf + numHf) * bufBytes);
+  s->st = FFT_INIT_SETUP_INPLACE( p + (size_t)(2 + numXf + numHf) * bufBytes, Nfft, fastconv_fft_type(flags) );
+  if ( !s->st )
+    return NULL;
+  fastconv_init( s, filterCoeffs, 1, filterLen, Nfft, flags );
+  s->inplace = 1;
+  return s;
+}
+
+
+void FUNC_DESTROY_SETUP( SETUP_STRUCT * s )
+{
+  if (!s)
+    return;
+  FFT_DESTROY_SETUP(s->st);
+  if ( s->inplace )
+    return;
+  if ( s->Xs )
+    FUNC_FREE(s->Xs);
+  FUNC_FREE(s->Mf);
+  if ( !s->extHf )
+    FUNC_FREE(s->Hf);
+  FUNC_FREE(s->Xf);
+  if ( s->Xt )
+    FUNC_FREE(s->Xt);
+  FUNC_FREE(s);
+}
+
+
+/* serialized setup: header, the filter spectrum Hf - or the spectra of all
+ * partitions and filters - and the blob of the pffft setup. all parts are padded to keep the alignment.
+ * version 1 blobs, without numFilters, have a single filter */
+#define FASTCONV_BLOB_VERSION  2
+#define FASTCONV_BLOB_ALIGN    64
+#define FASTCONV_BLOB_PAD(n)   ( ((n) + FASTCONV_BLOB_ALIGN - 1) & ~(size_t)(FASTCONV_BLOB_ALIGN - 1) )
+
+typedef struct {
+  unsigned magic;
+  int version;
+  int filterLen;
+  int Nfft;
+  int flags;
+  float scale;
+  int numFilters;  /* since version 2 */
+} fastconv_blob_header;
+
+
+size_t FUNC_SERIALIZED_SIZE( const SETUP_STRUCT * s )
+{
+  return FASTCONV_BLOB_PAD(sizeof(fastconv_blob_header))
+    + FASTCONV_BLOB_PAD((size_t)s->numFilters * s->numPartitions * fastconv_hf_len(s->filterLen, s->Nfft, s->flags) * sizeof(float))
+    + FFT_SERIALIZED_SIZE(s->st);
+}
+
+
+size_t FUNC_SERIALIZE_SETUP( const SETUP_STRUCT * s, void * blob, size_t blob_size )
+{
+  const size_t total = FUNC_SERIALIZED_SIZE(s);
+  char * p = (char*)blob;
+  fastconv_blob_header h;
+  if ( blob_size < total )
+    return 0;
+  memset( &h, 0, sizeof(h) );
+  h.magic = FASTCONV_BLOB_MAGIC;
+  h.version = FASTCONV_BLOB_VERSION;
+  h.filterLen = s->filterLen;
+  h.Nfft = s->Nfft;
+  h.flags = s->flags;
+  h.scale = s->scale;
+  h.numFilters = s->numFilters;
+  memset( p, 0, FASTCONV_BLOB_PAD(sizeof(h)) );
+  memcpy( p, &h, sizeof(h) );
+  p += FASTCONV_BLOB_PAD(sizeof(h));
+  memcpy( p, s->Hf, (size_t)s->numFilters * s->numPartitions * fastconv_hf_len(s->filterLen, s->Nfft, s->flags) * sizeof(float) );
+  p += FASTCONV_BLOB_PAD((size_t)s->numFilters * s->numPartitions * fastconv_hf_len(s->filterLen, s->Nfft, s->flags) * sizeof(float));
+  if ( !FFT_SERIALIZE_SETUP(s->st, p, blob_size - (size_t)(p - (char*)blob)) )
+    return 0;
+  return total;
+}
+
+
+SETUP_STRUCT * FUNC_DESERIALIZE_SETUP( const void * blob, size_t blob_size, int zero_copy )
+{
+  const char * p = (const char*)blob;
+  SETUP_STRUCT * s = NULL;
+  FFT_SETUP * st;
+  fastconv_blob_header h;
+  size_t off, hfBytes;
+  int numXf, specLen;
+
+  if ( blob_size < sizeof(h) )
+    return NULL;
+  memcpy( &h, p, sizeof(h) );
+  if ( h.version == 1 )
+    h.numFilters = 1;
+  if ( h.magic != FASTCONV_BLOB_MAGIC || h.version < 1 || h.version > FASTCONV_BLOB_VERSION || h.numFilters < 1
+      || h.Nfft <= 0 || h.filterLen <= 0 || ( h.filterLen > h.Nfft && !(h.flags & PFFASTCONV_PARTITIONED) ) )
+    return NULL;
+  specLen = fastconv_spec_len( h.Nfft, h.flags );
+  hfBytes = (size_t)h.numFilters * fastconv_num_partitions(h.filterLen, h.Nfft, h.flags)
+            * fastconv_hf_len(h.filterLen, h.Nfft, h.flags) * sizeof(float);
+  numXf = fastconv_num_inp_spectra( h.filterLen, h.Nfft, h.flags );
+  off = FASTCONV_BLOB_PAD(sizeof(h)) + FASTCONV_BLOB_PAD(hfBytes);
+  if ( blob_size <= off )
+    return NULL;
+  st = FFT_DESERIALIZE_SETUP( p + off, blob_size - off, zero_copy );
+  if ( !st )
+    return NULL;
+
+  s = FUNC_MALLOC( sizeof(struct SETUP_STRUCT) );
+  s->st = st;
+  s->filterLen = h.filterLen;
+  s->Nfft = h.Nfft;
+  s->flags = h.flags;
+  s->scale = h.scale;
+  s->extHf = zero_copy;
+  s->inplace = 0;
+  s->Xs = NULL;
+  s->xsLen = 0;
+  s->numPartitions = fastconv_num_partitions( h.filterLen, h.Nfft, h.flags );
+  s->numFilters = h.numFilters;
+  s->symDelay = fastconv_sym_delay( h.filterLen, h.flags );
+  s->fdlPos = 0;
+  s->fdlCount = 0;
+#if defined(PFFFT_ENABLE_INSTRUMENTATION)
+  memset( &s->instr, 0, sizeof(s->instr) );
+#endif
+  if ( zero_copy ) {
+    s->Hf = (float*)( p + FASTCONV_BLOB_PAD(sizeof(h)) );
+  } else {
+    s->Hf = FUNC_MALLOC(hfBytes);
+    memcpy( s->Hf, p + FASTCONV_BLOB_PAD(sizeof(h)), hfBytes );
+  }
+  if ( !fastconv_has_xt(h.flags, h.numFilters) )
+    s->Xt = NULL;
+  else
+    s->Xt = FUNC_MALLOC((unsigned)specLen * sizeof(float));
+  s->Xf = FUNC_MALLOC((size_t)numXf * specLen * sizeof(float));
+  s->Mf = FUNC_MALLOC((unsigned)specLen * sizeof(float));
+  return s;
+}
+
+
+/* FUNC_STREAM(): number of the history samples - and the capacity of Xs, in (complex) samples */
+static int fastconv_stream_hist_len( const SETUP_STRUCT * s )
+{
+  return ( fastconv_cplx_factor( s->flags ) == 2 ) ? (s->filterLen + 1) / 2 - 1 : s->filterLen - 1;
+}
+
+static int fastconv_stream_cap( const SETUP_STRUCT * s )
+{
+  const int blockLen = ( s->flags & PFFASTCONV_PARTITIONED ) ? s->Nfft / 2 : s->Nfft / fastconv_cplx_factor( s->flags );
+  return fastconv_stream_hist_len( s ) + 2 * blockLen;
+}
+
+static void fastconv_stream_reset( SETUP_STRUCT * s )
+{
+  const int inpFactor = ( s->flags & PFFASTCONV_CPLX_INP_OUT ) ? 2 : 1;
+  s->xsLen = fastconv_stream_hist_len( s );
+  memset( s->Xs, 0, (unsigned)(inpFactor * s->xsLen) * sizeof(float) );
+}
+
+
+void FUNC_RESET(SETUP_STRUCT * s)
+{
+  s->fdlPos = 0;
+  s->fdlCount = 0;
+  if ( s->Xs )
+    fastconv_stream_reset( s );
+}
+
+
+/* copy the input window X[winOff .. winOff + Nfft) - or its real/imag part - into Xt.
+ * samples outside of 0 .. inputLen-1 are zero. with a complex filter, Xt is complex:
+ * real input gets a zero imag part */
+static void fastconv_load_window(SETUP_STRUCT * s, const float * RESTRICT X, int inputLen, int winOff, int part)
+{
+  const int Nfft = s->Nfft;
+  const int cplxInp = ( s->flags & PFFASTCONV_CPLX_INP_OUT ) ? 1 : 0;
+  int first = ( winOff < 0 ) ? -winOff : 0;
+  int last = ( inputLen - winOff < Nfft ) ? (inputLen - winOff) : Nfft;
+  int j;
+
+  if ( last < first )
+    last = first;
+  memset( s->Xt, 0, (unsigned)fastconv_spec_len(Nfft, s->flags) * sizeof(float) );
+  if ( s->flags & PFFASTCONV_CPLX_FILTER ) {
+    if ( cplxInp )
+      memcpy( s->Xt + 2 * first, X + 2 * (winOff + first), (unsigned)(2 * (last - first)) * sizeof(float) );
+    else
+      for ( j = first; j < last; ++j )
+        s->Xt[2 * j] = X[winOff + j];
+  }
+  else if ( cplxInp ) {
+    for ( j = first; j < last; ++j )
+      s->Xt[j] = X[ 2 * (winOff + j) + part ];
+  }
+  else
+    memcpy( s->Xt + first, X + winOff + first, (unsigned)(last - first) * sizeof(float) );
+}
+
+/* copy numOut samples from src to Y[outOff ..] - or into its real/imag part */
+static void fastconv_store_output(const SETUP_STRUCT * s, const float * src, float * RESTRICT Y, int outOff, int numOut, int part)
+{
+  int j;
+  if ( s->flags & PFFASTCONV_CPLX_FILTER )
+    memcpy( Y + 2 * outOff, src, (unsigned)(2 * numOut) * sizeof(float) );
+  else if ( s->flags & PFFASTCONV_CPLX_INP_OUT ) {
+    for ( j = 0; j < numOut; ++j )
+      Y[ 2 * (outOff + j) + part ] = src[j];
+  }
+  else
+    memcpy( Y + outOff, src, (unsigned)numOut * sizeof(float) );
+}
+
+
+/* uniformly partitioned overlap-save with partition size B = Nfft/2:
+ * the spectrum of the input window j - starting at j*B - pad - is shared by
+ * the output blocks j-numPartitions+1 .. j, thus one forward FFT per block.
+ * output block i is the backward FFT of the sum of the products of the
+ * windows i+p with the filter partitions p. windows beyond the input are
+ * zero filled: the affected samples (the last one of each window and the
+ * ones before the input start) only meet zero taps, as far as the kept outputs
+ * are concerned. the windows not consumed stay in the delay line */
+static int fastconv_apply_partitioned(SETUP_STRUCT * s, const float * RESTRICT X, int inputLen, float * const * outputs, int applyFlush)
+{
+  const int Nfft = s->Nfft;
+  const int specLen = fastconv_spec_len( Nfft, s->flags );
+  const int B = Nfft / 2;
+  const int P = s->numPartitions;
+  const int pad = P * B - s->filterLen;
+  const int numParts = fastconv_num_parts( s->flags );
+  const int maxOut = inputLen - s->filterLen + 1;
+  int outOff, numOut, part, p, f;
+
+  for ( outOff = 0; outOff < maxOut; outOff += numOut )
+  {
+    numOut = ( maxOut - outOff >= B ) ? B : (maxOut - outOff);
+    if ( numOut < B && !applyFlush )
+      break;
+
+    for ( ; s->fdlCount < P; ++s->fdlCount )
+    {
+      const int slot = ( s->fdlPos + s->fdlCount ) % P;
+      for ( part = 0; part < numParts; ++part )
+      {
+        fastconv_load_window( s, X, inputLen, outOff + s->fdlCount * B - pad, part );
+        FFT_TRANSFORM(s->st, s->Xt, s->Xf + (size_t)(part * P + slot) * specLen, /* tmp = */ s->Mf, PFFFT_FORWARD);
+      }
+    }
+
+    for ( part = 0; part < numParts; ++part )
+    {
+      const float * Xf = s->Xf + (size_t)part * P * specLen;
+      for ( f = 0; f < s->numFilters; ++f )
+      {
+        const float * Hf = s->Hf + (size_t)f * P * specLen;
+        FFT_ZCONVOLVE_NO_ACCU(s->st, Xf + (size_t)s->fdlPos * specLen, Hf, /* tmp = */ s->Mf, s->scale);
+        for ( p = 1; p < P; ++p )
+          FFT_ZCONVOLVE_ACCUMULATE(s->st, Xf + (size_t)((s->fdlPos + p) % P) * specLen, Hf + (size_t)p * specLen, s->Mf, s->scale);
+
+        FFT_TRANSFORM(s->st, s->Mf, s->Mf, /* tmp = */ s->Xt, PFFFT_BACKWARD);
+        fastconv_store_output( s, s->Mf, outputs[f], outOff, numOut, part );
+      }
+    }
+    s->fdlPos = ( s->fdlPos + 1 ) % P;
+    --s->fdlCount;
+  }
+
+  if ( applyFlush )
+    FUNC_RESET(s);
+  return outOff;
+}
+
+
+/* complex filter: one complex FFT per block - for real or complex input */
+static int fastconv_apply_cplx_filter(SETUP_STRUCT * s, const float * RESTRICT X, int inputLen, float * const * outputs, int applyFlush)
+{
+  const int Nfft = s->Nfft;
+  const int filterLen = s->filterLen;
+  const int maxOff = applyFlush ? (inputLen - filterLen + 1) : (inputLen - Nfft + 1);
+  int inpOff, procLen, numOut = 0, f;
+
+  for ( inpOff = 0; inpOff < maxOff; inpOff += numOut )
+  {
+    procLen = ( (inputLen - inpOff) >= Nfft ) ? Nfft : (inputLen - inpOff);
+    numOut = procLen - filterLen + 1;
+
+    fastconv_load_window( s, X, inpOff + procLen, inpOff, 0 );
+    FFT_TRANSFORM(s->st, s->Xt, s->Xf, /* tmp = */ s->Mf, PFFFT_FORWARD);
+    for ( f = 0; f < s->numFilters; ++f )
+    {
+      FFT_ZCONVOLVE_TRANSFORM_BW(s->st, s->Xf, s->Hf + (size_t)f * 2 * Nfft, s->Mf, /* tmp = */ s->Xt, s->scale);
+      fastconv_store_output( s, s->Mf, outputs[f], inpOff, numOut, 0 );
+    }
+  }
+  return inpOff;
+}
+
+
+/* backward FFT of Xf * spectrum of filter f into Y, which may be Xf or Mf.
+ * the complete spectrum is multiplied within the backward FFT, see FFT_ZCONVOLVE_TRANSFORM_BW():
+ * Mf isn't needed for the product - and is the work buffer, unless it is the destination.
+ * the packed real spectrum of symmetric filters goes through Mf - with the work buffer 'work' */
+static void fastconv_zmul_backward(SETUP_STRUCT * s, int f, float * Y, float * work)
+{
+  const float * Hf = s->Hf + (size_t)f * fastconv_hf_len( fastconv_conv_len( s->filterLen, s->flags ), s->Nfft, s->flags );
+  if ( s->symDelay >= 0 )
+  {
+    FFT_ZCONVOLVE_REAL_NO_ACCU(s->st, s->Xf, Hf, /* tmp = */ s->Mf, s->scale);
+    FFT_TRANSFORM(s->st, s->Mf, Y, work, PFFFT_BACKWARD);
+  }
+  else
+    FFT_ZCONVOLVE_TRANSFORM_BW(s->st, s->Xf, Hf, Y, ( Y == s->Mf ) ? s->Xt : s->Mf, s->scale);
+}
+
+
+/* directIO: transform straight from/into aligned input/output - also without PFFASTCONV_DIRECT_INP/OUT.
+ * for FUNC_STREAM(), where the output has room for the complete backward FFT */
+static int fastconv_apply(SETUP_STRUCT * s, const float *input_, int cplxInputLen, float * const * outputs, int applyFlush, int directIO)
+{
+  const float * RESTRICT X = input_;
+  float * RESTRICT Y;
+  const int Nfft = s->Nfft;
+  const int filterLen = s->filterLen;
+  const int flags = s->flags;
+  const int cplxFactor = fastconv_cplx_factor( flags );
+  const int inputLen = cplxFactor * cplxInputLen;
+  /* with multiple filters, Xf is required for the next filter: Xt is the work buffer */
+  float * const bwdOut = ( s->numFilters > 1 ) ? s->Mf : s->Xf;
+  float * const bwdWork = ( s->numFilters > 1 ) ? s->Xt : s->Xf;
+  /* symmetric filters: the output starts behind the centering delay */
+  const int symOff = ( s->symDelay > 0 ) ? s->symDelay : 0;
+  const float * const bwdRes = bwdOut + symOff;
+  int inpOff, procLen, numOut = 0, j, part, cplxOff, f;
+
+  if ( flags & PFFASTCONV_PARTITIONED )
+    return fastconv_apply_partitioned( s, X, cplxInputLen, outputs, applyFlush );
+  if ( flags & PFFASTCONV_CPLX_FILTER )
+    return fastconv_apply_cplx_filter( s, X, cplxInputLen, outputs, applyFlush );
+
+  /* applyFlush != 0:
+   *     inputLen - inpOff -filterLen + 1 > 0
+   * <=> inputLen -filterLen + 1 > inpOff
+   * <=> inpOff < inputLen -filterLen + 1
+   * 
+   * applyFlush == 0:
+   *     inputLen - inpOff >= Nfft
+   * <=> inputLen - Nfft >= inpOff
+   * <=> inpOff <= inputLen - Nfft
+   * <=> inpOff < inputLen - Nfft + 1
+   */
+
+  if ( cplxFactor == 2 )
+  {
+    const int maxOff = applyFlush ? (inputLen -filterLen + 1) : (inputLen - Nfft + 1);
+#if 0
+    printf( "*** inputLen %d, filterLen %d, Nfft %d => maxOff %d\n", inputLen, filterLen, Nfft, maxOff);
+#endif
+    for ( inpOff = 0; inpOff < maxOff; inpOff += numOut )
+    {
+      procLen = ( (inputLen - inpOff) >= Nfft ) ? Nfft : (inputLen - inpOff);
+      numOut = ( procLen - filterLen + 1 ) & ( ~1 );
+      if (!numOut)
+        break;
+#if 0
+      if (!inpOff)
+        printf("*** inpOff = %d, numOut = %d\n", inpOff, numOut);
+      if (inpOff + filterLen + 2 >= maxOff )
+        printf("*** inpOff = %d, inpOff + numOut = %d\n", inpOff, inpOff + numOut);
+#endif
+
+      if ( flags & PFFASTCONV_DIRECT_INP )
+      {
+        FFT_TRANSFORM(s->st, X + inpOff, s->Xf, /* tmp = */ s->Mf, PFFFT_FORWARD);
+      }
+      else
+      {
+        memcpy( s->Xt, X + inpOff, (unsigned)procLen * sizeof(float) );
+        if ( procLen < Nfft )
+          memset( s->Xt + procLen, 0, (unsigned)(Nfft - procLen) * sizeof(float) );
+    
+        FFT_TRANSFORM(s->st, s->Xt, s->Xf, /* tmp = */ s->Mf, PFFFT_FORWARD);
+      }
+
+      for ( f = 0; f < s->numFilters; ++f )
+      {
+        Y = outputs[f];
+
+        if ( flags & PFFASTCONV_DIRECT_OUT )
+        {
+          fastconv_zmul_backward( s, f, Y + inpOff, bwdWork );
+          if ( symOff )
+            memmove( Y + inpOff, Y + inpOff + symOff, (unsigned)numOut * sizeof(float) );
+        }
+        else
+        {
+          fastconv_zmul_backward( s, f, bwdOut, /* tmp = */ s->Xt );
+          memcpy( Y + inpOff, bwdRes, (unsigned)numOut * sizeof(float) );
+        }
+      }
+    }
+    return inpOff / cplxFactor;
+  }
+  else
+  {
+    const int maxOff = applyFlush ? (inputLen -filterLen + 1) : (inputLen - Nfft + 1);
+    const int numParts = (flags & PFFASTCONV_CPLX_INP_OUT) ? 2 : 1;
+
+    for ( inpOff = 0; inpOff < maxOff; inpOff += numOut )
+    {
+      procLen = ( (inputLen - inpOff) >= Nfft ) ? Nfft : (inputLen - inpOff);
+      numOut = procLen - filterLen + 1;
+
+      for ( part = 0; part < numParts; ++part )  /* iterate per real/imag component */
+      {
+
+        if ( flags & PFFASTCONV_CPLX_INP_OUT )
+        {
+          cplxOff = 2 * inpOff + part;
+          for ( j = 0; j < procLen; ++j )
+            s->Xt[j] = X[cplxOff + 2 * j];
+          if ( procLen < Nfft )
+            memset( s->Xt + procLen, 0, (unsigned)(Nfft - procLen) * sizeof(float) );
+
+          FFT_TRANSFORM(s->st, s->Xt, s->Xf, /* tmp = */ s->Mf, PFFFT_FORWARD);
+        }
+        else if ( (flags & PFFASTCONV_DIRECT_INP) || (directIO && procLen == Nfft && FASTCONV_IS_ALIGNED(X + inpOff)) )
+        {
+          FFT_TRANSFORM(s->st, X + inpOff, s->Xf, /* tmp = */ s->Mf, PFFFT_FORWARD);
+        }
+        else
+        {
+          memcpy( s->Xt, X + inpOff, (unsigned)procLen * sizeof(float) );
+          if ( procLen < Nfft )
+            memset( s->Xt + procLen, 0, (unsigned)(Nfft - procLen) * sizeof(float) );
+    
+          FFT_TRANSFORM(s->st, s->Xt, s->Xf, /* tmp = */ s->Mf, PFFFT_FORWARD);
+        }
+
+        for ( f = 0; f < s->numFilters; ++f )
+        {
+          Y = outputs[f];
+
+          if ( flags & PFFASTCONV_CPLX_INP_OUT )
+          {
+            fastconv_zmul_backward( s, f, bwdOut, /* tmp = */ s->Xt );
+
+            cplxOff = 2 * inpOff + part;
+            for ( j = 0; j < numOut; ++j )
+              Y[ cplxOff + 2 * j ] = bwdRes[j];
+          }
+          else if ( (flags & PFFASTCONV_DIRECT_OUT) || (directIO && !symOff && FASTCONV_IS_ALIGNED(Y + inpOff)) )
+          {
+            fastconv_zmul_backward( s, f, Y + inpOff, bwdWork );
+            if ( symOff )
+              memmove( Y + inpOff, Y + inpOff + symOff, (unsigned)numOut * sizeof(float) );
+          }
+          else
+          {
+            fastconv_zmul_backward( s, f, bwdOut, /* tmp = */ s->Xt );
+            memcpy( Y + inpOff, bwdRes, (unsigned)numOut * sizeof(float) );
+          }
+        }
+
+      }
+    }
+
+    return inpOff;
+  }
+}
+
+
+int FUNC_APPLY(SETUP_STRUCT * s, const float *input, int inputLen, float *output, int applyFlush)
+{
+  int numOut;
+  INSTR_BEGIN();
+  assert( s->numFilters == 1 );  /* use FUNC_APPLY_MULTI() */
+  numOut = fastconv_apply( s, input, inputLen, &output, applyFlush, 0 );
+  INSTR_END( &s->instr, numOut );
+  return numOut;
+}
+
+
+int FUNC_APPLY_MULTI(SETUP_STRUCT * s, const float *input, int inputLen, float * const * outputs, int applyFlush)
+{
+  int numOut;
+  INSTR_BEGIN();
+  numOut = fastconv_apply( s, input, inputLen, outputs, applyFlush, 0 );
+  INSTR_END( &s->instr, numOut );
+  return numOut;
+}
+
+
+int FUNC_STREAM(SETUP_STRUCT * s, const float *input, int inputLen, float *output)
+{
+  const int inpFactor = ( s->flags & PFFASTCONV_CPLX_INP_OUT ) ? 2 : 1;
+  const int outFactor = ( s->flags & (PFFASTCONV_CPLX_INP_OUT | PFFASTCONV_CPLX_FILTER) ) ? 2 : 1;
+  const int cap = fastconv_stream_cap( s );
+  float * outputs[1];
+  int numOut = 0, n, take, len;
+  INSTR_BEGIN();
+
+  assert( s->numFilters == 1 && !s->inplace );
+  assert( !(s->flags & (PFFASTCONV_DIRECT_INP | PFFASTCONV_DIRECT_OUT)) );
+  if ( !s->Xs ) {
+    s->Xs = FUNC_MALLOC( (size_t)(inpFactor * cap) * sizeof(float) );
+    fastconv_stream_reset( s );
+  }
+
+  while ( inputLen > 0 )
+  {
+    /* append to the pending samples - just enough for the next FFT(s) */
+    take = ( inputLen < cap - s->xsLen ) ? inputLen : (cap - s->xsLen);
+    memcpy( s->Xs + inpFactor * s->xsLen, input, (unsigned)(inpFactor * take) * sizeof(float) );
+    s->xsLen += take;
+    input += inpFactor * take;
+    inputLen -= take;
+
+    outputs[0] = output + outFactor * numOut;
+    n = fastconv_apply( s, s->Xs, s->xsLen, outputs, 0, 1 );
+    numOut += n;
+    s->xsLen -= n;
+
+    if ( inputLen > 0 && s->xsLen <= take )
+    {
+      /* the pending samples are the last ones of input[]: continue in the caller's buffer,
+       * without copying. just the unprocessed rest goes into Xs */
+      const float * X = input - inpFactor * s->xsLen;
+      len = s->xsLen + inputLen;
+      outputs[0] = output + outFactor * numOut;
+      n = fastconv_apply( s, X, len, outputs, 0, 1 );
+      numOut += n;
+      s->xsLen = len - n;
+      memcpy( s->Xs, X + inpFactor * n, (unsigned)(inpFactor * s->xsLen) * sizeof(float) );
+      break;
+    }
+    memmove( s->Xs, s->Xs + inpFactor * n, (unsigned)(inpFactor * s->xsLen) * sizeof(float) );
+  }
+  INSTR_END( &s->instr, numOut );
+  return numOut;
+}
+
+
+int FUNC_GET_INSTR(const SETUP_STRUCT * s, pffft_instr_counter_t * apply, pffft_instr_snapshot_t * fft)
+{
+#if defined(PFFFT_ENABLE_INSTRUMENTATION)
+  if ( apply )
+    instr_read( &s->instr, apply );
+  if ( fft )
+    FFT_GET_INSTR( s->st, fft );
+  return 1;
+#else
+  if ( apply )
+    memset( apply, 0, sizeof(*apply) );
+  if ( fft )
+    FFT_GET_INSTR( s->st, fft );
+  return 0;
+#endif
+}
+
+
+void FUNC_RESET_INSTR(SETUP_STRUCT * s)
+{
+#if defined(PFFFT_ENABLE_INSTRUMENTATION)
+  instr_clear( &s->instr );
+#endif
+  FFT_RESET_INSTR( s->st );
+}
@@ -0,0 +1,186 @@
+/*
+   PFFASTCONV_XCORR : batched cross-correlation peaks - see pffastconv_xcorr.h
+
+   the reference is kept as spectrum R of rr[k] = conj(r[(N-k) % N]), which
+   is zero but for k = 0 and k = N-M+1 .. N-1. the circular convolution
+   of the zero padded stream with rr is
+
+     cc[j] = sum_n x[(j + n) % N] * conj(r[n])
+
+   which is c[lag] at j = lag mod N, as long as no other lag of the
+   linear correlation, lag + N or lag - N, falls on the same j: that's
+   the condition N >= max(L - minLag, maxLag + M).
+*/
+
+#include "pffastconv_xcorr.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+struct PFFASTCONV_XCorr
+{
+  int N;
+  int ns;               /* floats per sample: 1 (real) or 2 (complex) */
+  int refLen;
+  int streamLen;
+  int minLag;
+  int maxLag;
+  PFFFT_Setup *fft;
+  float *R;             /* aligned: spectrum of the conjugated, time reversed reference */
+  float *buf;           /* aligned: padded stream, its spectrum - then the correlation */
+  float *work;          /* aligned: work of the transforms */
+};
+
+
+PFFASTCONV_XCorr *pffastconv_xcorr_new(const float *reference, int refLen, int streamLen,
+                                       int minLag, int maxLag, pffft_transform_t transform)
+{
+  PFFASTCONV_XCorr *xc;
+  int ns, N, k;
+
+  if (!reference || refLen < 1 || streamLen < 1)
+    return NULL;
+  minLag = (minLag < -(refLen - 1)) ? -(refLen - 1) : minLag;
+  maxLag = (maxLag > streamLen - 1) ? (streamLen - 1) : maxLag;
+  if (minLag > maxLag)
+    return NULL;
+
+  N = (streamLen - minLag > maxLag + refLen) ? (streamLen - minLag) : (maxLag + refLen);
+  N = (N > refLen) ? N : refLen;
+  N = (N > streamLen) ? N : streamLen;
+  N = (N > pffft_min_fft_size(transform)) ? N : pffft_min_fft_size(transform);
+  N = pffft_nearest_transform_size(N, transform, 1);
+  if (N <= 0)
+    return NULL;
+
+  xc = (PFFASTCONV_XCorr*)calloc(1, sizeof(PFFASTCONV_XCorr));
+  if (!xc)
+    return NULL;
+  ns = (transform == PFFFT_COMPLEX) ? 2 : 1;
+  xc->N = N;
+  xc->ns = ns;
+  xc->refLen = refLen;
+  xc->streamLen = streamLen;
+  xc->minLag = minLag;
+  xc->maxLag = maxLag;
+  xc->fft = pffft_new_setup(N, transform);
+  xc->R = (float*)pffft_aligned_malloc((size_t)ns * N * sizeof(float));
+  xc->buf = (float*)pffft_aligned_malloc((size_t)ns * N * sizeof(float));
+  xc->work = (float*)pffft_aligned_malloc((size_t)ns * N * sizeof(float));
+  if (!xc->fft || !xc->R || !xc->buf || !xc->work) {
+    pffastconv_xcorr_destroy(xc);
+    return NULL;
+  }
+
+  memset(xc->buf, 0, (size_t)ns * N * sizeof(float));
+  for (k = 0; k < refLen; ++k) {
+    const int j = (k == 0) ? 0 : (N - k);
+    xc->buf[ns * j] = reference[ns * k];
+    if (ns == 2)
+      xc->buf[2 * j + 1] = -reference[2 * k + 1];
+  }
+  pffft_transform(xc->fft, xc->buf, xc->R, xc->work, PFFFT_FORWARD);
+  return xc;
+}
+
+
+void pffastconv_xcorr_destroy(PFFASTCONV_XCorr *xc)
+{
+  if (!xc)
+    return;
+  if (xc->fft)
+    pffft_destroy_setup(xc->fft);
+  pffft_aligned_free(xc->R);
+  pffft_aligned_free(xc->buf);
+  pffft_aligned_free(xc->work);
+  free(xc);
+}
+
+
+int pffastconv_xcorr_fft_size(const PFFASTCONV_XCorr *xc)
+{
+  return xc->N;
+}
+
+
+/* |cc[j]|, with j = lag mod N */
+static float xcorr_abs(const PFFASTCONV_XCorr *xc, int lag)
+{
+  const int j = (lag < 0) ? (lag + xc->N) : lag;
+  if (xc->ns == 1)
+    return fabsf(xc->buf[j]);
+  return sqrtf(xc->buf[2*j] * xc->buf[2*j] + xc->buf[2*j+1] * xc->buf[2*j+1]);
+}
+
+
+/* scan the correlation in 'buf' for the maximum in minLag .. maxLag.
+   the lags are contiguous in buf: the negative ones at the end, the
+   others from the start - each part is one plain loop over the squares */
+static void xcorr_find_peak(const PFFASTCONV_XCorr *xc, pffastconv_xcorr_peak_t *peak)
+{
+  const float *c = xc->buf;
+  const int N = xc->N;
+  float best = -1.0f;
+  int bestLag = xc->minLag;
+  int part, lag;
+
+  for (part = 0; part < 2; ++part) {
+    const int lo = (part == 0) ? xc->minLag : ((xc->minLag > 0) ? xc->minLag : 0);
+    const int hi = (part == 0) ? ((xc->maxLag < 0) ? xc->maxLag : -1) : xc->maxLag;
+    const int off = (part == 0) ? N : 0;
+    if (xc->ns == 1) {
+      for (lag = lo; lag <= hi; ++lag) {
+        const float v = c[lag + off] * c[lag + off];
+        if (v > best) { best = v; bestLag = lag; }
+      }
+    }
+    else {
+      for (lag = lo; lag <= hi; ++lag) {
+        const float *z = c + 2 * (lag + off);
+        const float v = z[0] * z[0] + z[1] * z[1];
+        if (v > best) { best = v; bestLag = lag; }
+      }
+    }
+  }
+
+  {
+    const int j = (bestLag < 0) ? (bestLag + N) : bestLag;
+    const float y0 = xcorr_abs(xc, bestLag);
+    peak->lag = bestLag;
+    peak->frac = 0.0f;
+    peak->value = y0;
+    peak->re = c[xc->ns * j];
+    peak->im = (xc->ns == 2) ? c[2 * j + 1] : 0.0f;
+    if (bestLag > xc->minLag && bestLag < xc->maxLag) {
+      /* parabola through |c| at lag-1, lag, lag+1 */
+      const float ym = xcorr_abs(xc, bestLag - 1);
+      const float yp = xcorr_abs(xc, bestLag + 1);
+      const float d = ym - 2.0f * y0 + yp;
+      if (d < 0.0f) {
+        float f = 0.5f * (ym - yp) / d;
+        f = (f < -0.5f) ? -0.5f : ((f > 0.5f) ? 0.5f : f);
+        peak->frac = f;
+        peak->value = y0 - 0.25f * (ym - yp) * f;
+      }
+    }
+  }
+}
+
+
+void pffastconv_xcorr_peaks(PFFASTCONV_XCorr *xc, const float *streams, int numStreams, int streamStride,
+                            pffastconv_xcorr_peak_t *peaks)
+{
+  const int ns = xc->ns, N = xc->N;
+  const size_t sb = (size_t)ns * xc->streamLen * sizeof(float);
+  int s;
+
+  for (s = 0; s < numStreams; ++s) {
+    memcpy(xc->buf, streams + (size_t)s * streamStride, sb);
+    memset(xc->buf + ns * xc->streamLen, 0, (size_t)ns * N * sizeof(float) - sb);
+    pffft_transform(xc->fft, xc->buf, xc->buf, xc->work, PFFFT_FORWARD);
+    pffft_zconvolve_transform_backward(xc->fft, xc->buf, xc->R, xc->buf, xc->work, 1.0f / N);
+    xcorr_find_peak(xc, peaks + s);
+  }
+}
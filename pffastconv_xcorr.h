@@ -0,0 +1,92 @@
+/*
+   PFFASTCONV_XCORR : batched cross-correlation of many streams against
+   one reference - reporting only the correlation peak, e.g. for time
+   difference of arrival (TDOA) estimation.
+
+   The spectrum of the (conjugated and time reversed) reference is
+   computed once. Each stream costs one forward transform, and the
+   spectral product fused with the backward transform, see
+   pffft_zconvolve_transform_backward(). The backward transform writes
+   into an internal buffer of one FFT length, which is still in the cache
+   when the peak is searched - the correlation is never written to the
+   caller.
+
+   Definition: for a stream x of length L and the reference r of length M
+
+     c[lag] = sum_n x[n + lag] * conj(r[n])
+
+   summed over n with 0 <= n < M and 0 <= n + lag < L: the linear - not
+   circular - cross-correlation, for lags -(M-1) .. L-1. For real signals,
+   c[lag] is the output n = lag + M - 1 of pffastconv_stream() with a
+   PFFASTCONV_CORRELATION setup of the reference, fed with the stream and
+   M-1 zeros.
+
+   The FFT length depends on the searched lags: a window of
+   minLag .. maxLag needs N >= max(L - minLag, maxLag + M) - instead of
+   L + M - 1 for all lags. e.g. a sensor stream against a reference of
+   the same length, searching +/- D lags: N >= L + D instead of 2L - 1.
+
+   Restrictions:
+
+   - 32-bit single precision.
+
+   - all streams of an engine have the same length.
+
+   - the peak is the maximum of |c[lag]|: the first one on ties.
+*/
+
+#ifndef PFFASTCONV_XCORR_H
+#define PFFASTCONV_XCORR_H
+
+#include "pffft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /* opaque struct holding the reference spectrum and the buffers of one stream.
+     this struct can't be shared by many threads: use one engine per thread.
+  */
+  typedef struct PFFASTCONV_XCorr PFFASTCONV_XCorr;
+
+  typedef struct {
+    int   lag;    /* integer lag of the maximum of |c[lag]| */
+    float frac;   /* sub-sample correction in -0.5 .. 0.5: the peak is at lag + frac */
+    float value;  /* |c| at lag + frac - from a parabola through |c| at lag-1, lag, lag+1 */
+    float re;     /* c[lag] itself */
+    float im;     /* 0 for real signals */
+  } pffastconv_xcorr_peak_t;
+
+  /*
+    prepare the correlation of streams of streamLen samples against the
+    refLen samples of reference[] - which is copied. with PFFFT_REAL, the
+    samples are real; with PFFFT_COMPLEX, they are interleaved complex
+    samples: 2 * refLen and 2 * streamLen floats.
+
+    only lags minLag .. maxLag are searched, which are clipped to
+    -(refLen-1) .. streamLen-1. the peak's neighbours at the ends of the
+    window are not interpolated: frac is 0 there.
+
+    returns NULL if a parameter is not supported.
+  */
+  PFFASTCONV_XCorr *pffastconv_xcorr_new(const float *reference, int refLen, int streamLen,
+                                         int minLag, int maxLag, pffft_transform_t transform);
+
+  void pffastconv_xcorr_destroy(PFFASTCONV_XCorr *xc);
+
+  /* the internal FFT length */
+  int pffastconv_xcorr_fft_size(const PFFASTCONV_XCorr *xc);
+
+  /*
+    correlate numStreams streams - stream s starts at streams + s * streamStride
+    (in floats) - and write their peaks to peaks[s].
+    streams don't need to be aligned.
+  */
+  void pffastconv_xcorr_peaks(PFFASTCONV_XCorr *xc, const float *streams, int numStreams, int streamStride,
+                              pffastconv_xcorr_peak_t *peaks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PFFASTCONV_XCORR_H */
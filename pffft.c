@@ -72,6 +72,17 @@
 #include <stdio.h>
 #include <math.h>
 #include <assert.h>
+#include <string.h>
+
+#if !defined(PFFFT_ARCH_POST)
+/* for the lock of the setup cache */
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#elif !defined(PFFFT_NO_THREADS)
+#  include <pthread.h>
+#endif
+#endif
 
 #if defined(COMPILER_GCC)
 #  define ALWAYS_INLINE(return_type) inline return_type __attribute__ ((always_inline))
@@ -95,40 +106,110 @@
    SSE/Altivec/NEON -- adding support for other platforms with 4-element
    vectors should be limited to these macros 
 */
+#if !defined(PFFFT_DISPATCH)
 #include "simd/pf_float.h"
+#endif
 
-/* have code comparable with this definition */
+#if defined(PFFFT_DISPATCH) || defined(PFFFT_ARCH_POST)
+/* the public functions are provided by the runtime dispatcher,
+   which forwards to one of the architecture specific builds */
+typedef struct PFFFT_Arch_Setup PFFFT_Arch_Setup;
+#define ARCH_SETUP_STRUCT          PFFFT_Arch_Setup
+#define ARCH_PTRS_STRUCT           pffft_arch_ptrs_t
+#define PFFFT_CONCAT_IMPL(x, y)    x##y
+#define PFFFT_CONCAT(x, y)         PFFFT_CONCAT_IMPL(x, y)
+#endif
+
+#if defined(PFFFT_ARCH_POST)
+/* architecture specific build: append the architecture to all names */
+#define FUNC_ARCH(X)               PFFFT_CONCAT(X##_, PFFFT_ARCH_POST)
+#define SETUP_STRUCT               PFFFT_Arch_Setup
+#else
+#define FUNC_ARCH(X)               X
 #define SETUP_STRUCT               PFFFT_Setup
-#define FUNC_NEW_SETUP             pffft_new_setup
-#define FUNC_DESTROY               pffft_destroy_setup
-#define FUNC_TRANSFORM_UNORDRD     pffft_transform
-#define FUNC_TRANSFORM_ORDERED     pffft_transform_ordered
-#define FUNC_ZREORDER              pffft_zreorder
-#define FUNC_ZCONVOLVE_ACCUMULATE  pffft_zconvolve_accumulate
-#define FUNC_ZCONVOLVE_NO_ACCU     pffft_zconvolve_no_accu
+#endif
+
+/* have code comparable with this definition */
+#define FUNC_NEW_SETUP             FUNC_ARCH(pffft_new_setup)
+#define FUNC_NEW_SETUP_2D          FUNC_ARCH(pffft_new_setup_2d)
+#define FUNC_SETUP_SIZE            FUNC_ARCH(pffft_setup_size)
+#define FUNC_INIT_SETUP_INPLACE    FUNC_ARCH(pffft_init_setup_inplace)
+#define FUNC_DESTROY               FUNC_ARCH(pffft_destroy_setup)
+#define FUNC_WORK_SIZE             FUNC_ARCH(pffft_work_size)
+#define FUNC_TRANSFORM_UNORDRD     FUNC_ARCH(pffft_transform)
+#define FUNC_TRANSFORM_ORDERED     FUNC_ARCH(pffft_transform_ordered)
+#define FUNC_TRANSFORM_BATCH       FUNC_ARCH(pffft_transform_batch)
+#define FUNC_TRANSFORM_ORD_BATCH   FUNC_ARCH(pffft_transform_ordered_batch)
+#define FUNC_TRANSFORM_PAIR        FUNC_ARCH(pffft_transform_pair)
+#define FUNC_TRANSFORM_ORD_PAIR    FUNC_ARCH(pffft_transform_ordered_pair)
+#define FUNC_TRANSFORM_HALF        FUNC_ARCH(pffft_transform_half)
+#define FUNC_TRANSFORM_ORD_HALF    FUNC_ARCH(pffft_transform_ordered_half)
+#define FUNC_HALF_TO_FLOAT         FUNC_ARCH(pffft_half_to_float)
+#define FUNC_FLOAT_TO_HALF         FUNC_ARCH(pffft_float_to_half)
+#define FUNC_ZREORDER              FUNC_ARCH(pffft_zreorder)
+#define FUNC_ZPOWER                FUNC_ARCH(pffft_zpower)
+#define FUNC_ZPOWER_ACCUMULATE     FUNC_ARCH(pffft_zpower_accumulate)
+#define FUNC_ZPOWER_UNPACK         FUNC_ARCH(pffft_zpower_unpack)
+#define FUNC_ZCONVOLVE_ACCUMULATE  FUNC_ARCH(pffft_zconvolve_accumulate)
+#define FUNC_ZCONVOLVE_NO_ACCU     FUNC_ARCH(pffft_zconvolve_no_accu)
+#define FUNC_ZCONVOLVE_TRANSFORM_BW  FUNC_ARCH(pffft_zconvolve_transform_backward)
+#define FUNC_ZREAL_PACK            FUNC_ARCH(pffft_zreal_pack)
+#define FUNC_ZCONVOLVE_REAL_ACCUMULATE  FUNC_ARCH(pffft_zconvolve_real_accumulate)
+#define FUNC_ZCONVOLVE_REAL_NO_ACCU     FUNC_ARCH(pffft_zconvolve_real_no_accu)
+#define FUNC_ZBIN_INDEX            FUNC_ARCH(pffft_zbin_index)
+#define FUNC_ZMAGNITUDE            FUNC_ARCH(pffft_zmagnitude)
+#define FUNC_ZPHASE                FUNC_ARCH(pffft_zphase)
+#define FUNC_ZCONJ_MULTIPLY        FUNC_ARCH(pffft_zconj_multiply)
+#define FUNC_ZDIVIDE               FUNC_ARCH(pffft_zdivide)
+#define FUNC_ZDELAY                FUNC_ARCH(pffft_zdelay)
+#define FUNC_SERIALIZED_SIZE       FUNC_ARCH(pffft_serialized_size)
+#define FUNC_SERIALIZE             FUNC_ARCH(pffft_serialize_setup)
+#define FUNC_DESERIALIZE           FUNC_ARCH(pffft_deserialize_setup)
+#define FUNC_GET_INSTR             FUNC_ARCH(pffft_get_instr_snapshot)
+#define FUNC_RESET_INSTR           FUNC_ARCH(pffft_reset_instr)
+#define FUNC_ACQUIRE_SETUP         pffft_acquire_setup
+#define FUNC_RELEASE_SETUP         pffft_release_setup
+#define FUNC_SET_CACHE_LIMIT       pffft_set_setup_cache_limit
+#define FUNC_CACHE_BYTES           pffft_setup_cache_bytes
+#define FUNC_CLEAR_CACHE           pffft_clear_setup_cache
 
 #define FUNC_ALIGNED_MALLOC        pffft_aligned_malloc
 #define FUNC_ALIGNED_FREE          pffft_aligned_free
-#define FUNC_SIMD_SIZE             pffft_simd_size
-#define FUNC_MIN_FFT_SIZE          pffft_min_fft_size
-#define FUNC_IS_VALID_SIZE         pffft_is_valid_size
-#define FUNC_NEAREST_SIZE          pffft_nearest_transform_size
-#define FUNC_SIMD_ARCH             pffft_simd_arch
-#define FUNC_VALIDATE_SIMD_A       validate_pffft_simd
-#define FUNC_VALIDATE_SIMD_EX      validate_pffft_simd_ex
-
-#define FUNC_CPLX_FINALIZE         pffft_cplx_finalize
-#define FUNC_CPLX_PREPROCESS       pffft_cplx_preprocess
-#define FUNC_REAL_PREPROCESS_4X4   pffft_real_preprocess_4x4
-#define FUNC_REAL_PREPROCESS       pffft_real_preprocess
-#define FUNC_REAL_FINALIZE_4X4     pffft_real_finalize_4x4
-#define FUNC_REAL_FINALIZE         pffft_real_finalize
-#define FUNC_TRANSFORM_INTERNAL    pffft_transform_internal
+#define FUNC_SIMD_SIZE             FUNC_ARCH(pffft_simd_size)
+#define FUNC_MIN_FFT_SIZE          FUNC_ARCH(pffft_min_fft_size)
+#define FUNC_IS_VALID_SIZE         FUNC_ARCH(pffft_is_valid_size)
+#define FUNC_NEAREST_SIZE          FUNC_ARCH(pffft_nearest_transform_size)
+#define FUNC_SIMD_ARCH             FUNC_ARCH(pffft_simd_arch)
+#define FUNC_VALIDATE_SIMD_A       FUNC_ARCH(validate_pffft_simd)
+#define FUNC_VALIDATE_SIMD_EX      FUNC_ARCH(validate_pffft_simd_ex)
+#define FUNC_ARCH_PTRS             FUNC_ARCH(pffft_arch_ptrs)
+
+#define FUNC_CPLX_FINALIZE         FUNC_ARCH(pffft_cplx_finalize)
+#define FUNC_CPLX_PREPROCESS       FUNC_ARCH(pffft_cplx_preprocess)
+#define FUNC_REAL_PREPROCESS_4X4   FUNC_ARCH(pffft_real_preprocess_4x4)
+#define FUNC_REAL_PREPROCESS       FUNC_ARCH(pffft_real_preprocess)
+#define FUNC_REAL_FINALIZE_4X4     FUNC_ARCH(pffft_real_finalize_4x4)
+#define FUNC_REAL_FINALIZE         FUNC_ARCH(pffft_real_finalize)
+#define FUNC_TRANSFORM_INTERNAL    FUNC_ARCH(pffft_transform_internal)
+#define FUNC_TRANSFORM_BATCH_INTERNAL FUNC_ARCH(pffft_transform_batch_internal)
 
 #define FUNC_COS  cosf
 #define FUNC_SIN  sinf
+#define FUNC_SQRT  sqrtf
+#define FUNC_ATAN2 atan2f
 
 
+#if defined(PFFFT_DISPATCH)
+#include "pffft_dispatch_impl.h"
+#else
 #include "pffft_priv_impl.h"
+#if defined(PFFFT_ARCH_POST)
+#include "pffft_dispatch_impl.h"
+#endif
+#endif
+
+#if !defined(PFFFT_ARCH_POST)
+#include "pffft_cache_impl.h"
+#endif
 
 
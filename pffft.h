@@ -50,7 +50,7 @@
 
    This is basically an adaptation of the single precision fftpack
    (v4) as found on netlib taking advantage of SIMD instruction found
-   on cpus such as intel x86 (SSE1), powerpc (Altivec), and arm (NEON).
+   on cpus such as intel x86 (SSE1, AVX), powerpc (Altivec), and arm (NEON).
    
    For architectures where no SIMD instruction is available, the code
    falls back to a scalar version.  
@@ -59,14 +59,30 @@
 
    - 1D transforms only, with 32-bit single precision.
 
-   - supports only transforms for inputs of length N of the form
-   N=(2^a)*(3^b)*(5^c), a >= 5, b >=0, c >= 0 (32, 48, 64, 96, 128,
-   144, 160, etc are all acceptable lengths). Performance is best for
-   128<=N<=8192.
+   - supports native transforms for inputs of length N of the form
+   N=(2^a)*(3^b)*(5^c)*(7^d)*(11^e)*(13^f), a >= 5, b, c, d, e, f >= 0
+   (32, 48, 64, 96, 128, 144, 160, 224, etc are all acceptable lengths).
+   Performance is best for 128<=N<=8192. With the 8-wide AVX vectors, the minimum sizes are
+   4 times larger: use pffft_min_fft_size() / pffft_is_valid_size().
+   With the runtime dispatch on x86_64 (cmake option PFFFT_USE_DISPATCH),
+   the widest SIMD architecture supported by the CPU is selected with
+   each pffft_new_setup(), falling back to narrower vectors for the
+   smaller sizes. The environment variable PFFFT_ARCH ("sse2", "avx",
+   "avx2" or "avx512") limits the selection.
+
+   - other sizes N - complex, or even for real transforms - use
+   Bluestein's algorithm: a convolution with the native complex
+   transform of the next valid size >= 2*N-1 (complex) or N-1 (real).
+   Their spectra are always in the ordered layout - also with
+   pffft_transform(). Their 'work' needs room for pffft_work_size()
+   values - more than for native sizes. With work == NULL, they allocate
+   it on the heap for each call and leave the output unchanged, when
+   that fails. Bluestein setups can't be used for 2D transforms, in
+   caller provided memory or for serialization.
 
    - all (float*) pointers in the functions below are expected to
    have an "simd-compatible" alignment, that is 16 bytes on x86 and
-   powerpc CPUs.
+   powerpc CPUs - 32 bytes with AVX and 64 bytes with AVX-512.
   
    You can allocate such buffers with the functions
    pffft_aligned_malloc / pffft_aligned_free (or with stuff like
@@ -98,6 +114,30 @@ extern "C" {
   /* type of transform */
   typedef enum { PFFFT_REAL, PFFFT_COMPLEX } pffft_transform_t;
 
+#endif
+
+#ifndef PFFFT_COMMON_INSTR
+#define PFFFT_COMMON_INSTR
+
+  /* functions of the optional instrumentation, see pffft_get_instr_snapshot() */
+  typedef enum {
+    PFFFT_INSTR_TRANSFORM = 0,      /* all transforms: samples are count * Nrows * N */
+    PFFFT_INSTR_ZREORDER,           /* zreorder and zpower: samples are Nrows * N */
+    PFFFT_INSTR_ZCONVOLVE,          /* all zconvolve functions: samples are Nrows * N */
+    PFFFT_INSTR_ZCONVOLVE_TRANSFORM_BW, /* fused zconvolve and backward transform: N */
+    PFFFT_INSTR_NUM
+  } pffft_instr_func_t;
+
+  typedef struct {
+    unsigned long long calls;
+    unsigned long long samples;
+    unsigned long long cycles;      /* time stamp counter on x86 - else a timer, see pffft_instr_impl.h */
+  } pffft_instr_counter_t;
+
+  typedef struct {
+    pffft_instr_counter_t func[PFFFT_INSTR_NUM];  /* indexed with pffft_instr_func_t */
+  } pffft_instr_snapshot_t;
+
 #endif
 
   /*
@@ -107,6 +147,110 @@ extern "C" {
   */
   PFFFT_Setup *pffft_new_setup(int N, pffft_transform_t transform);
   void pffft_destroy_setup(PFFFT_Setup *);
+
+  /*
+    prepare a setup - as pffft_new_setup() - in caller provided memory,
+    without any allocation, e.g. in real-time threads or in an arena.
+    pffft_setup_size() delivers the required number of bytes, or 0 for an
+    invalid size N - see pffft_is_valid_size(). 'mem' has to be 64-byte
+    aligned (a cache line).
+    pffft_init_setup_inplace() returns the setup, which points to 'mem',
+    or NULL when N or the alignment is not suitable. Just release 'mem'
+    after use: pffft_destroy_setup() frees nothing for these setups.
+  */
+  size_t pffft_setup_size(int N, pffft_transform_t transform);
+  PFFFT_Setup *pffft_init_setup_inplace(void *mem, int N, pffft_transform_t transform);
+
+  /*
+    prepare for performing 2D transforms of Nrows x N values: Nrows rows
+    of N values each, one row after the other. The same functions as for
+    1D transforms are used with this setup: pffft_transform(),
+    pffft_transform_ordered(), pffft_zreorder() and pffft_zconvolve_*(),
+    which allows fast 2D convolution.
+
+    The rows are transformed with the 1D transform; N has the same
+    restrictions as for pffft_new_setup(). Then the columns are transformed
+    with a complex transform of length Nrows, which needs to be a product
+    of 2, 3, 5, 7, 11 and 13 - and even for real transforms. N needs to be
+    a valid size, see pffft_is_valid_size(): there are no 2D transforms with
+    Bluestein's algorithm. Without SIMD, where the minimum sizes are 1 and
+    2, N needs to be at least 2.
+
+    The ordered output of a real transform has Nrows rows with N/2 complex
+    values, as the 1D spectrum of each row. Entry k of row r is the
+    frequency (r, k) for k >= 1. The first entry of a row (r, 0) holds
+    - the real (0, 0) and (0, N/2) frequencies in row 0, and the real
+      (Nrows/2, 0) and (Nrows/2, N/2) in row Nrows/2,
+    - frequency (r, 0) for 0 < r < Nrows/2,
+    - frequency (r, N/2) for Nrows/2 < r.
+    The other frequencies follow from the symmetry of real input.
+
+    'work' needs room for 2 * Nrows * N floats, for both, real
+    and complex transforms.
+  */
+  PFFFT_Setup *pffft_new_setup_2d(int Nrows, int N, pffft_transform_t transform);
+
+  /*
+    cache of shared setups: pffft_acquire_setup() delivers the same
+    setup for repeated requests of (N, transform), without computing the
+    twiddle factors again. Each call increments a reference count and
+    needs a matching pffft_release_setup() - never use pffft_destroy_setup()
+    on these setups. Returns NULL, like pffft_new_setup(), for invalid sizes.
+
+    The cache is thread-safe, and the setups are read-only: one setup can
+    be used by multiple threads at the same time.
+
+    Released setups stay in the cache, until the (approximate) memory of
+    all cached setups exceeds the limit, which is unlimited by default.
+    Then the least recently used unreferenced setups are destroyed.
+    pffft_clear_setup_cache() destroys all unreferenced setups.
+    pffft_setup_cache_bytes() retrieves the current memory usage.
+  */
+  PFFFT_Setup *pffft_acquire_setup(int N, pffft_transform_t transform);
+  void pffft_release_setup(PFFFT_Setup *setup);
+  void pffft_set_setup_cache_limit(size_t max_bytes);
+  size_t pffft_setup_cache_bytes(void);
+  void pffft_clear_setup_cache(void);
+
+  /*
+    serialize a (1D or 2D) setup into a flat blob, which allows to skip
+    the computation of the twiddle factors, e.g. at startup, by loading
+    precomputed setups from a file.
+
+    pffft_serialized_size() delivers the size of the blob in bytes - or 0
+    for setups with Bluestein's algorithm, which can't be serialized.
+    pffft_serialize_setup() writes the blob - returning the number of bytes
+    written, or 0 when blob_size is too small.
+
+    pffft_deserialize_setup() creates a setup from the blob. It returns NULL
+    for blobs of another version, another precision, another SIMD width
+    (see pffft_simd_size()) or another byte order - or when blob_size is too
+    small. A deserialized setup is destroyed with pffft_destroy_setup().
+
+    With zero_copy != 0, the setup references the twiddle factors in the blob:
+    this blob needs to be "simd-compatible" aligned (64 bytes, e.g. from
+    pffft_aligned_malloc() or a memory mapped file), must not be modified
+    and has to stay valid until the setup is destroyed. This way, multiple
+    processes can share one read-only mapping of a file with setups.
+  */
+  size_t pffft_serialized_size(const PFFFT_Setup *setup);
+  size_t pffft_serialize_setup(const PFFFT_Setup *setup, void *blob, size_t blob_size);
+  PFFFT_Setup *pffft_deserialize_setup(const void *blob, size_t blob_size, int zero_copy);
+
+  /*
+    optional instrumentation of the hot paths - compiled in with
+    PFFFT_ENABLE_INSTRUMENTATION (CMake option PFFFT_USE_INSTRUMENTATION).
+    each setup counts calls, processed samples and cycles of the transforms,
+    pffft_zreorder() and the pffft_zconvolve_*() functions with atomic
+    additions. without the option, the hot paths are unchanged.
+
+    pffft_get_instr_snapshot() copies the counters of the setup - for export
+    into a metrics system. it returns 0 and zeros the snapshot, when the
+    instrumentation is not compiled in. pffft_reset_instr() clears the counters.
+    a Bluestein setup counts the calls to itself, not to its internal transforms.
+  */
+  int pffft_get_instr_snapshot(const PFFFT_Setup *setup, pffft_instr_snapshot_t *snapshot);
+  void pffft_reset_instr(PFFFT_Setup *setup);
   /* 
      Perform a Fourier transform , The z-domain data is stored in the
      most efficient order for transforming it back, or using it for
@@ -119,11 +263,12 @@ extern "C" {
      Typically you will want to scale the backward transform by 1/N.
 
      The 'work' pointer should point to an area of N (2*N for complex
-     fft) floats, properly aligned. If 'work' is NULL, then stack will
+     fft) floats, properly aligned - more for Bluestein's sizes, see above. If 'work' is NULL, then stack will
      be used instead (this is probably the best strategy for small
      FFTs, say for N < 16384). Threads usually have a small stack, that
      there's no sufficient amount of memory, usually leading to a crash!
      Use the heap with pffft_aligned_malloc() in this case.
+     pffft_work_size() delivers the required size.
 
      For a real forward transform (PFFFT_REAL | PFFFT_FORWARD) with real
      input with input(=transformation) length N, the output array is
@@ -151,6 +296,101 @@ extern "C" {
   */
   void pffft_transform_ordered(PFFFT_Setup *setup, const float *input, float *output, float *work, pffft_direction_t direction);
 
+  /*
+     number of floats, which 'work' of pffft_transform() and
+     pffft_transform_ordered() needs for this setup: N (2*N for complex
+     transforms) - or 2 * Nrows * N for 2D transforms. setups with
+     Bluestein's algorithm need more: 6 * M + 2 * L, with the length L of
+     their chirp-z transform and the native size M of its convolution.
+     this is also enough for the batch functions and
+     pffft_zconvolve_transform_backward().
+     allows to size pooled scratch memory for many concurrent transforms.
+     for very large N, see pffft_fourstep_transform_inplace() in
+     pffft_fourstep.h, which needs no 'work' at all.
+  */
+  int pffft_work_size(const PFFFT_Setup *setup);
+
+  /*
+     Perform 'count' transforms of the same setup with one call, e.g. for
+     multiple channels. Transform c reads input + c*input_stride and writes
+     output + c*output_stride; the strides are given in number of floats and
+     have to keep the "simd-compatible" alignment of each transform.
+     The passes of small transforms are interleaved, that the twiddle
+     factors of each pass are loaded once for a group of transforms.
+
+     'work' is used as in pffft_transform(), needing room for one single
+     transform, and may be NULL. For the interleaved groups a small amount
+     of stack memory is used in any case.
+
+     input and output may alias - if input_stride == output_stride.
+  */
+  void pffft_transform_batch(PFFFT_Setup *setup, int count, const float *input, int input_stride,
+                             float *output, int output_stride, float *work, pffft_direction_t direction);
+
+  /*
+     Similar to pffft_transform_batch, but with ordered output,
+     see pffft_transform_ordered()
+  */
+  void pffft_transform_ordered_batch(PFFFT_Setup *setup, int count, const float *input, int input_stride,
+                                     float *output, int output_stride, float *work, pffft_direction_t direction);
+
+  /*
+     Transform two signals of the same setup with one call, e.g. the left
+     and right channel of a stereo signal - or I and Q: transform a reads
+     input_a and writes output_a, transform b likewise. The spectra have
+     the layout of pffft_transform() (pffft_transform_ordered()), that
+     pffft_zreorder() and pffft_zconvolve_*() work on each of them.
+
+     This is pffft_transform_batch() with count = 2, where the signals
+     don't need a common stride. Packing two real signals into one complex
+     transform of length N ("two for one") is not used: a real transform
+     already costs about half of a complex transform of the same length,
+     and a complex transform of length N with the separation of the
+     spectra measured 1.2 to 2.5 times slower than two real transforms.
+
+     'work' is used as in pffft_transform(). input_a and output_a may alias,
+     input_b and output_b as well.
+  */
+  void pffft_transform_pair(PFFFT_Setup *setup, const float *input_a, const float *input_b,
+                            float *output_a, float *output_b, float *work, pffft_direction_t direction);
+
+  /* same as pffft_transform_pair(), with the ordered spectra of pffft_transform_ordered() */
+  void pffft_transform_ordered_pair(PFFFT_Setup *setup, const float *input_a, const float *input_b,
+                                    float *output_a, float *output_b, float *work, pffft_direction_t direction);
+
+  /* 16-bit storage formats for pffft_transform_half() */
+  typedef enum { PFFFT_HALF_FP16, PFFFT_HALF_BF16 } pffft_half_t;
+
+  /*
+     Similar to pffft_transform_batch, but input and output are stored
+     in 16 bits: IEEE half precision (FP16) or bfloat16 (BF16), given as
+     'unsigned short' bit patterns. The values are converted at load and
+     store - with F16C or NEON, where available - the computation is in
+     float. For large batches, this halves the memory traffic.
+
+     The strides are given in number of 16-bit values; there is no
+     alignment requirement. 'work' may be NULL, else it needs room for
+     two transforms. input and output may alias - if
+     input_stride == output_stride.
+
+     Note the limited range of FP16 (max 65504): the unscaled result of
+     the forward transform grows with N - scale the input accordingly.
+  */
+  void pffft_transform_half(PFFFT_Setup *setup, pffft_half_t format, int count,
+                            const unsigned short *input, int input_stride,
+                            unsigned short *output, int output_stride,
+                            float *work, pffft_direction_t direction);
+
+  /* same as pffft_transform_half, with ordered output, see pffft_transform_ordered() */
+  void pffft_transform_ordered_half(PFFFT_Setup *setup, pffft_half_t format, int count,
+                                    const unsigned short *input, int input_stride,
+                                    unsigned short *output, int output_stride,
+                                    float *work, pffft_direction_t direction);
+
+  /* conversion of 'count' values between float and FP16/BF16, rounding to nearest even */
+  void pffft_half_to_float(pffft_half_t format, const unsigned short *input, float *output, int count);
+  void pffft_float_to_half(pffft_half_t format, const float *input, unsigned short *output, int count);
+
   /* 
      call pffft_zreorder(.., PFFFT_FORWARD) after pffft_transform(...,
      PFFFT_FORWARD) if you want to have the frequency components in
@@ -165,6 +405,34 @@ extern "C" {
   */
   void pffft_zreorder(PFFFT_Setup *setup, const float *input, float *output, pffft_direction_t direction);
 
+  /*
+     power spectrum |X[k]|^2 of the unordered output of pffft_transform(..,
+     PFFFT_FORWARD), in the natural order of the bins: k = 0 .. N/2 (N/2+1
+     values) for real transforms, k = 0 .. N-1 for complex ones.
+     this replaces pffft_zreorder() and a separate pass for the magnitudes:
+     the squares are summed in the SIMD layout of the spectrum.
+
+     'power' doesn't need to be aligned. not for 2D setups.
+  */
+  void pffft_zpower(PFFFT_Setup *setup, const float *dft, float *power);
+
+  /*
+     averaged power spectra: pffft_zpower_accumulate() adds |X|^2 * scaling
+     of an unordered spectrum dft - from pffft_transform(.., PFFFT_FORWARD) -
+     to the power accumulator acc[], in an internal layout: like the packed
+     real spectrum of pffft_zreal_pack(), acc[] needs N/2 + pffft_simd_size()
+     floats for real transforms - or N + pffft_simd_size() for complex ones.
+     acc[] has to be aligned and zeroed before the first call; accumulators
+     of the same setup may simply be added up, e.g. per-thread partial sums.
+
+     pffft_zpower_unpack() writes the accumulated powers in the natural
+     order of the bins - as pffft_zpower(): N/2+1 or N values. so the
+     reordering is done once, when the result is read - not per spectrum.
+     'power' doesn't need to be aligned. not for 2D setups.
+  */
+  void pffft_zpower_accumulate(PFFFT_Setup *setup, const float *dft, float *acc, float scaling);
+  void pffft_zpower_unpack(PFFFT_Setup *setup, const float *acc, float *power);
+
   /* 
      Perform a multiplication of the frequency components of dft_a and
      dft_b and accumulate them into dft_ab. The arrays should have
@@ -193,7 +461,83 @@ extern "C" {
   */
   void pffft_zconvolve_no_accu(PFFFT_Setup *setup, const float *dft_a, const float *dft_b, float *dft_ab, float scaling);
 
-  /* return 4 or 1 wether support SSE/NEON/Altivec instructions was enabled when building pffft.c */
+  /*
+     the backward transform of the product of dft_a and dft_b - the
+     same as pffft_zconvolve_no_accu() into output[], followed by
+     pffft_transform(setup, output, output, work, PFFFT_BACKWARD).
+     but the product is formed tile by tile, while the first step of the
+     backward transform reads the spectra: the pass writing and re-reading
+     the product is saved - which counts, when the spectra exceed the L1 cache.
+
+     output may alias dft_a, but not dft_b. work has the role of
+     pffft_transform()'s work.
+  */
+  void pffft_zconvolve_transform_backward(PFFFT_Setup *setup, const float *dft_a, const float *dft_b, float *output, float *work, float scaling);
+
+  /*
+     for a spectrum dft_b, which is known to be real valued - e.g. the one
+     of a symmetric (zero-phase) filter: pffft_zreal_pack() keeps only the
+     real parts in real_b[], which then needs N/2 + pffft_simd_size() floats
+     for real transforms - or N + pffft_simd_size() for complex ones.
+     real_b[] has to be aligned, as the spectra.
+
+     pffft_zconvolve_real_accumulate() and pffft_zconvolve_real_no_accu()
+     are pffft_zconvolve_accumulate() and pffft_zconvolve_no_accu()
+     with such a packed real_b[]: these save half of the memory for b and
+     most of the multiplications. dft_a and dft_ab may alias.
+
+     not for 2D setups - and not for the sizes transformed with Bluestein's
+     algorithm, see pffft_is_valid_size().
+  */
+  void pffft_zreal_pack(PFFFT_Setup *setup, const float *dft_b, float *real_b);
+  void pffft_zconvolve_real_accumulate(PFFFT_Setup *setup, const float *dft_a, const float *real_b, float *dft_ab, float scaling);
+  void pffft_zconvolve_real_no_accu(PFFFT_Setup *setup, const float *dft_a, const float *real_b, float *dft_ab, float scaling);
+
+  /*
+     spectral operations on the unordered output of pffft_transform(..,
+     PFFFT_FORWARD): these work in the internal layout, so that a chain
+     forward transform -> operations -> backward pffft_transform() needs
+     no pffft_zreorder() - which would be an extra pass over the spectrum.
+     the same restrictions as for pffft_zreal_pack() apply: not for 2D
+     setups and not for the sizes transformed with Bluestein's algorithm.
+     all arrays have to be aligned; in- and outputs may alias.
+
+     pffft_zbin_index() maps bin k (k = 0 .. N/2 for real transforms,
+     0 .. N-1 for complex ones) to the positions in the arrays:
+       re_offset[k], im_offset[k]: real and imaginary part of X[k] in the
+         spectrum. im_offset[] is -1 for the real X[0] and X[N/2] of real
+         transforms.
+       packed_offset[k]: the value of bin k in a packed real spectrum, see
+         pffft_zreal_pack() - e.g. a gain, to be set per bin.
+     each of the arrays may be NULL.
+  */
+  void pffft_zbin_index(PFFFT_Setup *setup, int *re_offset, int *im_offset, int *packed_offset);
+
+  /* |X[k]| - or arg(X[k]) in radians - into the packed real layout of
+     pffft_zreal_pack(): N/2 + pffft_simd_size() floats for real transforms,
+     N + pffft_simd_size() for complex ones. as all values are real, the
+     output can directly be used (after modification) as a gain with
+     pffft_zconvolve_real_no_accu(): a mask or a spectral gain needs no
+     separate function. */
+  void pffft_zmagnitude(PFFFT_Setup *setup, const float *dft, float *mag);
+  void pffft_zphase(PFFFT_Setup *setup, const float *dft, float *phase);
+
+  /* dft_ab = dft_a * conj(dft_b) * scaling: the cross spectrum - its
+     backward transform is the circular cross-correlation of a and b */
+  void pffft_zconj_multiply(PFFFT_Setup *setup, const float *dft_a, const float *dft_b, float *dft_ab, float scaling);
+
+  /* regularized spectral division: dft_ab = dft_a * conj(dft_b) / (|dft_b|^2 + eps).
+     with eps = 0 this is dft_a / dft_b - zero bins of dft_b then give inf/nan */
+  void pffft_zdivide(PFFFT_Setup *setup, const float *dft_a, const float *dft_b, float *dft_ab, float eps);
+
+  /* a time shift in the frequency domain: output = dft * exp(-j*2*pi*delay*k/N),
+     a circular delay of the signal by 'delay' samples - also fractional.
+     bins k >= N/2 of complex transforms are the negative frequencies k - N,
+     X[N/2] of real transforms is multiplied by cos(pi*delay). */
+  void pffft_zdelay(PFFFT_Setup *setup, const float *dft, float *output, float delay);
+
+  /* return 16, 8, 4 or 1 wether support AVX-512/AVX/SSE/NEON/Altivec instructions was enabled when building pffft.c
+     - with the runtime dispatch, this is for the widest selectable architecture */
   int pffft_simd_size();
 
   /* return string identifier of used architecture (SSE/NEON/Altivec/..) */
@@ -214,13 +558,15 @@ extern "C" {
   int pffft_is_power_of_two(int N);
 
   /* simple helper to determine size N is valid
-     - factorizable to pffft_min_fft_size() with factors 2, 3, 5
+     - factorizable to pffft_min_fft_size() with factors 2, 3, 5, 7, 11, 13:
+       the sizes with native transforms, others use Bluestein's algorithm.
+       N = 1 is never native - also not without SIMD, where the minimum is 1
      returns bool
   */
   int pffft_is_valid_size(int N, pffft_transform_t cplx);
 
   /* determine nearest valid transform size  (by brute-force testing)
-     - factorizable to pffft_min_fft_size() with factors 2, 3, 5.
+     - factorizable to pffft_min_fft_size() with factors 2, 3, 5, 7, 11, 13.
      higher: bool-flag to find nearest higher value; else lower.
   */
   int pffft_nearest_transform_size(int N, pffft_transform_t cplx, int higher);
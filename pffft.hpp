@@ -120,6 +120,89 @@ struct AlignedVector : public std::vector< T, PFAlloc<T> > {
 #endif
 
 
+// alignment of AlignedArray<>: sufficient for all SIMD architectures, incl. AVX-512
+#define PFFFT_HPP_ARRAY_ALIGNMENT 64
+
+#if (__cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900))
+#  define PFFFT_HPP_ALIGNED_PREFIX  alignas(PFFFT_HPP_ARRAY_ALIGNMENT)
+#  define PFFFT_HPP_ALIGNED_SUFFIX
+#elif defined(_MSC_VER)
+#  define PFFFT_HPP_ALIGNED_PREFIX  __declspec(align(64))
+#  define PFFFT_HPP_ALIGNED_SUFFIX
+#else
+#  define PFFFT_HPP_ALIGNED_PREFIX
+#  define PFFFT_HPP_ALIGNED_SUFFIX  __attribute__((aligned(PFFFT_HPP_ARRAY_ALIGNMENT)))
+#endif
+
+// fixed size array with SIMD alignment - without any heap allocation:
+// its alignment (and size) is known at compile time.
+// the alignment is kept on the stack and in static memory - on the heap
+// only with C++17's aligned new, else use Fft<T>::alignedAllocType() and Span<T>.
+template<typename T, int N>
+struct AlignedArray
+{
+  typedef T value_type;
+  enum { Size = N };
+
+  PFFFT_HPP_ALIGNED_PREFIX T values[N] PFFFT_HPP_ALIGNED_SUFFIX;
+
+  static int size() { return N; }
+  T * data() { return values; }
+  const T * data() const { return values; }
+  T & operator[](int k) { return values[k]; }
+  const T & operator[](int k) const { return values[k]; }
+};
+
+
+namespace detail {
+  template<typename T> struct RemoveConst { typedef T type; };
+  template<typename T> struct RemoveConst<const T> { typedef T type; };
+}
+
+// non-owning view of 'size' consecutive values: a pointer and a length.
+// it's cheap to pass and to return by value - no allocation is involved.
+// use Span<const T> for read-only data. Span<> is constructible from
+// AlignedVector<> and AlignedArray<>, which are aligned by construction,
+// or from raw pointers, which need the SIMD alignment - see Fft<T>::isSimdAligned().
+template<typename T>
+class Span
+{
+public:
+  typedef T value_type;
+  typedef typename detail::RemoveConst<T>::type NonConstType;
+
+  Span() : ptr(NULL), len(0) { }
+  Span(T * data, int size) : ptr(data), len(size) { }
+
+  // Span<T> to Span<const T>
+  Span(const Span<NonConstType> & other) : ptr(other.data()), len(other.size()) { }
+
+  Span(std::vector< NonConstType, PFAlloc<NonConstType> > & v)
+    : ptr(v.empty() ? NULL : &v[0]), len(int(v.size())) { }
+  Span(const std::vector< NonConstType, PFAlloc<NonConstType> > & v)
+    : ptr(v.empty() ? NULL : &v[0]), len(int(v.size())) { }
+
+  template<int N> Span(AlignedArray<NonConstType, N> & a) : ptr(a.data()), len(N) { }
+  template<int N> Span(const AlignedArray<NonConstType, N> & a) : ptr(a.data()), len(N) { }
+
+  T * data() const { return ptr; }
+  int size() const { return len; }
+  bool empty() const { return len == 0; }
+  T & operator[](int k) const { return ptr[k]; }
+  T * begin() const { return ptr; }
+  T * end() const { return ptr + len; }
+
+  // the first 'count' values
+  Span first(int count) const { assert(count <= len); return Span(ptr, count); }
+  // 'count' values, starting at 'offset'
+  Span subspan(int offset, int count) const { assert(offset + count <= len); return Span(ptr + offset, count); }
+
+private:
+  T * ptr;
+  int len;
+};
+
+
 // T can be float, double, std::complex<float> or std::complex<double>
 //   define PFFFT_ENABLE_DOUBLE before include this file for double and std::complex<double>
 template<typename T>
@@ -148,7 +231,7 @@ public:
   // simple helper to get minimum possible fft length
   static int minFFtsize() { return Types<T>::minFFtsize(); }
 
-  // helper to determine nearest transform size - factorizable to minFFtsize() with factors 2, 3, 5
+  // helper to determine nearest transform size - factorizable to minFFtsize() with factors 2, 3, 5, 7, 11, 13
   static bool isValidSize(int N) { return Types<T>::isValidSize(N); }
   static int nearestTransformSize(int N, bool higher=true) { return Types<T>::nearestTransformSize(N, higher); }
 
@@ -181,7 +264,8 @@ public:
    * prepare for transformation length 'newLength'.
    * length is identical to forward()'s input vector's size,
    * and also equals inverse()'s output vector size.
-   * this function is no simple setter. it pre-calculates twiddle factors.
+   * this function is no simple setter. it pre-calculates twiddle factors -
+   * or takes them from the setup cache, see pffft_acquire_setup() in pffft.h.
    * returns true if newLength is >= minFFtsize, false otherwise
    */
   bool prepareLength(int newLength);
@@ -260,6 +344,21 @@ public:
    */
   AlignedVector<T> & inverse(const AlignedVector<Complex> & spectrum, AlignedVector<T> & output);
 
+  /*
+   * Perform forward() for 'count' signals with one call, e.g. for
+   * multiple channels. 'input' holds count * getLength() values,
+   * 'spectrum' holds count * getSpectrumSize() values - one after the other.
+   * The passes of small transforms are interleaved across the signals.
+   * return is just the given output parameter 'spectrum'.
+   */
+  AlignedVector<Complex> & forwardBatch(int count, const AlignedVector<T> & input, AlignedVector<Complex> & spectrum);
+
+  /*
+   * Perform inverse() for 'count' spectra with one call, see forwardBatch().
+   * return is just the given output parameter 'output'.
+   */
+  AlignedVector<T> & inverseBatch(int count, const AlignedVector<Complex> & spectrum, AlignedVector<T> & output);
+
 
   // provide additional functions with spectrum in some internal Layout.
   // these are faster, cause the implementation omits the reordering.
@@ -363,6 +462,15 @@ public:
 
   T* inverse(const Complex* spectrum, T* output);
 
+  // batch variants: strides are given in number of T resp. Complex elements
+  // and have to keep the alignment, e.g. by multiples of the SIMD size
+
+  Complex* forwardBatch(int count, const T* input, int inputStride,
+                        Complex* spectrum, int spectrumStride);
+
+  T* inverseBatch(int count, const Complex* spectrum, int spectrumStride,
+                  T* output, int outputStride);
+
 
   // provide additional functions with spectrum in some internal Layout.
   // these are faster, cause the implementation omits the reordering.
@@ -386,6 +494,50 @@ public:
                              Scalar* spectrum_internal_ab,
                              const Scalar scaling);
 
+
+  ////////////////////////////////////////////
+  ////
+  //// API 3, with Span<> views on caller provided memory:
+  ////   from AlignedVector<>, AlignedArray<> or raw pointers.
+  ////
+  //// nothing is allocated per call - neither here, nor in pffft
+  //// for the native transform sizes, see isValidSize() in pffft.h.
+  //// the returned Span<> is the output with the exact size of the result.
+  //// the sizes and the alignment are checked with assert().
+  ////
+  //// Method descriptions are equal to API 1.
+  ////
+  ////////////////////////////////////////////
+
+  // pointer has the alignment required by the (widest) SIMD architecture
+  static bool isSimdAligned(const void* ptr);
+
+  Span<Complex> forward(Span<const T> input, Span<Complex> spectrum);
+
+  Span<T> inverse(Span<const Complex> spectrum, Span<T> output);
+
+  Span<Complex> forwardBatch(int count, Span<const T> input, Span<Complex> spectrum);
+
+  Span<T> inverseBatch(int count, Span<const Complex> spectrum, Span<T> output);
+
+  Span<Scalar> forwardToInternalLayout(Span<const T> input,
+                                       Span<Scalar> spectrum_internal_layout);
+
+  Span<T> inverseFromInternalLayout(Span<const Scalar> spectrum_internal_layout,
+                                    Span<T> output);
+
+  Span<Complex> reorderSpectrum(Span<const Scalar> input, Span<Complex> output);
+
+  Span<Scalar> convolve(Span<const Scalar> spectrum_internal_a,
+                        Span<const Scalar> spectrum_internal_b,
+                        Span<Scalar> spectrum_internal_ab,
+                        const Scalar scaling);
+
+  Span<Scalar> convolveAccumulate(Span<const Scalar> spectrum_internal_a,
+                                  Span<const Scalar> spectrum_internal_b,
+                                  Span<Scalar> spectrum_internal_ab,
+                                  const Scalar scaling);
+
 private:
   detail::Setup<T> setup;
   Scalar* work;
@@ -394,6 +546,219 @@ private:
 };
 
 
+namespace detail {
+  // N without all its factors F
+  template<int N, int F, bool divisible = (N > 0 && N % F == 0)>
+  struct StripFactor { enum { value = N }; };
+  template<int N, int F>
+  struct StripFactor<N, F, true> { enum { value = StripFactor<N / F, F>::value }; };
+
+  // compile time variant of isValidSize() for 4-wide SIMD vectors:
+  // N = (2^a)*(3^b)*(5^c)*(7^d)*(11^e)*(13^f) and a multiple of 32 (real) or 16 (complex)
+  template<int N, bool isComplex>
+  struct IsNativeSize {
+    enum { value = ( N % (isComplex ? 16 : 32) == 0 )
+      && ( StripFactor<StripFactor<StripFactor<StripFactor<StripFactor<StripFactor<
+             N, 2>::value, 3>::value, 5>::value, 7>::value, 11>::value, 13>::value == 1 ) };
+  };
+}
+
+// Fft<T> with the transformation length N fixed at compile time.
+// N has to be a native transform size - that is checked by the compiler
+// for 4-wide SIMD vectors: the minimum sizes of wider vectors are checked
+// at runtime, see isValid(). Bluestein's algorithm, which allocates memory
+// with each transform, is never used.
+// with the AlignedArray<> typedefs below, sizes and alignment of the
+// arrays are checked at compile time, too. nothing is allocated per call:
+// like for Fft<T>, the work memory is either on the stack or allocated once.
+template<typename T, int N>
+class FixedFft : public Fft<T>
+{
+public:
+  typedef typename Fft<T>::Scalar  Scalar;
+  typedef typename Fft<T>::Complex Complex;
+
+  enum {
+    IsComplex = ( sizeof(T) == sizeof(Complex) ),
+    Length = N,
+    SpectrumSize = IsComplex ? N : ( N / 2 ),
+    InternalLayoutSize = IsComplex ? ( 2 * N ) : N
+  };
+
+  typedef AlignedArray<T, Length>                   ValueArray;
+  typedef AlignedArray<Complex, SpectrumSize>       SpectrumArray;
+  typedef AlignedArray<Scalar, InternalLayoutSize>  InternalLayoutArray;
+
+  explicit FixedFft( int stackThresholdLen = 4096 );
+
+  // the AlignedVector<>, raw pointer and Span<> variants stay available
+  using Fft<T>::forward;
+  using Fft<T>::inverse;
+  using Fft<T>::forwardToInternalLayout;
+  using Fft<T>::inverseFromInternalLayout;
+  using Fft<T>::reorderSpectrum;
+  using Fft<T>::convolve;
+  using Fft<T>::convolveAccumulate;
+
+  SpectrumArray & forward(const ValueArray & input, SpectrumArray & spectrum);
+
+  ValueArray & inverse(const SpectrumArray & spectrum, ValueArray & output);
+
+  InternalLayoutArray & forwardToInternalLayout(
+          const ValueArray & input,
+          InternalLayoutArray & spectrum_internal_layout );
+
+  ValueArray & inverseFromInternalLayout(
+          const InternalLayoutArray & spectrum_internal_layout,
+          ValueArray & output );
+
+  SpectrumArray & reorderSpectrum(
+          const InternalLayoutArray & input,
+          SpectrumArray & output );
+
+  InternalLayoutArray & convolve(
+          const InternalLayoutArray & spectrum_internal_a,
+          const InternalLayoutArray & spectrum_internal_b,
+          InternalLayoutArray & spectrum_internal_ab,
+          const Scalar scaling );
+
+  InternalLayoutArray & convolveAccumulate(
+          const InternalLayoutArray & spectrum_internal_a,
+          const InternalLayoutArray & spectrum_internal_b,
+          InternalLayoutArray & spectrum_internal_ab,
+          const Scalar scaling );
+
+private:
+  // the length is fixed
+  bool prepareLength(int newLength);
+};
+
+
+// 2D transform of 'rows' x 'cols' values, stored row after row.
+// T can be float, double, std::complex<float> or std::complex<double>
+//   - as with Fft<T>. cols has to be a valid length for Fft<T>,
+//   rows can be any number for complex transforms, but has to be
+//   1, or even, for real ones.
+template<typename T>
+class Fft2D
+{
+public:
+
+  typedef T value_type;
+  typedef typename Types<T>::Scalar  Scalar;
+  typedef typename Types<T>::Complex Complex;
+
+  static bool isComplexTransform()  { return sizeof(T) == sizeof(Complex); }
+
+  Fft2D( int rows, int cols );
+
+  ~Fft2D();
+
+  /*
+   * constructor or prepareSize() produced a valid FFT instance?
+   */
+  bool isValid() const { return setup.isValid(); }
+
+  /*
+   * prepare for a transformation of 'newRows' x 'newCols'.
+   * returns false, if the size is not supported.
+   */
+  bool prepareSize(int newRows, int newCols);
+
+  int getRows() const { return rows; }
+  int getCols() const { return cols; }
+
+  /*
+   * retrieve size of the complex spectrum, the output of forward():
+   * rows * Fft<T>::getSpectrumSize()
+   */
+  int getSpectrumSize() const { return rows * ( isComplexTransform() ? cols : ( cols / 2 ) ); }
+
+  /*
+   * retrieve size of spectrum - in internal layout;
+   * the output of forwardToInternalLayout()
+   */
+  int getInternalLayoutSize() const { return rows * ( isComplexTransform() ? ( 2 * cols ) : cols ); }
+
+  AlignedVector<T>       valueVector() const { return AlignedVector<T>( rows * cols ); }
+  AlignedVector<Complex> spectrumVector() const { return AlignedVector<Complex>( getSpectrumSize() ); }
+  AlignedVector<Scalar>  internalLayoutVector() const { return AlignedVector<Scalar>( getInternalLayoutSize() ); }
+
+  /*
+   * Perform the forward 2D Fourier transform, not scaled.
+   *
+   * The output is canonically ordered, row after row: entry k of row r
+   * holds the frequency (r, k). For real input, the rows hold the
+   * frequencies 0 .. cols/2 - 1, and entry 0 of each row is a special case:
+   * rows 0 and rows/2 contain F(r, 0) + i*F(r, cols/2), as in Fft<T>::forward(),
+   * rows r < rows/2 contain F(r, 0) and rows r > rows/2 contain F(r, cols/2).
+   * The other values follow from the symmetry F(r, k) = conj(F(rows-r, cols-k)).
+   *
+   * input and output may alias.
+   */
+  AlignedVector<Complex> & forward(const AlignedVector<T> & input, AlignedVector<Complex> & spectrum);
+
+  AlignedVector<T> & inverse(const AlignedVector<Complex> & spectrum, AlignedVector<T> & output);
+
+  /*
+   * Perform the forward 2D transform - with the spectrum in an internal
+   * layout, which can be used directly with convolve() / convolveAccumulate()
+   * and inverseFromInternalLayout(), for a fast circular 2D convolution.
+   */
+  AlignedVector<Scalar> & forwardToInternalLayout(
+          const AlignedVector<T> & input,
+          AlignedVector<Scalar> & spectrum_internal_layout );
+
+  AlignedVector<T> & inverseFromInternalLayout(
+          const AlignedVector<Scalar> & spectrum_internal_layout,
+          AlignedVector<T> & output );
+
+  void reorderSpectrum(
+          const AlignedVector<Scalar> & input,
+          AlignedVector<Complex> & output );
+
+  AlignedVector<Scalar> & convolve(
+          const AlignedVector<Scalar> & spectrum_internal_a,
+          const AlignedVector<Scalar> & spectrum_internal_b,
+          AlignedVector<Scalar> & spectrum_internal_ab,
+          const Scalar scaling );
+
+  AlignedVector<Scalar> & convolveAccumulate(
+          const AlignedVector<Scalar> & spectrum_internal_a,
+          const AlignedVector<Scalar> & spectrum_internal_b,
+          AlignedVector<Scalar> & spectrum_internal_ab,
+          const Scalar scaling );
+
+  // raw pointer API, see Fft<T>
+
+  Complex* forward(const T* input, Complex* spectrum);
+
+  T* inverse(const Complex* spectrum, T* output);
+
+  Scalar* forwardToInternalLayout(const T* input, Scalar* spectrum_internal_layout);
+
+  T* inverseFromInternalLayout(const Scalar* spectrum_internal_layout, T* output);
+
+  void reorderSpectrum(const Scalar* input, Complex* output);
+
+  Scalar* convolve(const Scalar* spectrum_internal_a,
+                   const Scalar* spectrum_internal_b,
+                   Scalar* spectrum_internal_ab,
+                   const Scalar scaling);
+
+  Scalar* convolveAccumulate(const Scalar* spectrum_internal_a,
+                             const Scalar* spectrum_internal_b,
+                             Scalar* spectrum_internal_ab,
+                             const Scalar scaling);
+
+private:
+  detail::Setup<T> setup;
+  Scalar* work;
+  int rows;
+  int cols;
+};
+
+
 template<typename T>
 inline T* alignedAlloc(int length) {
   return (T*)detail::pffft_aligned_malloc( length * sizeof(T) );
@@ -431,6 +796,18 @@ template<>
 class Setup<float>
 {
   PFFFT_Setup* self;
+  bool cached;
+
+  void release()
+  {
+    if (self) {
+      if (cached)
+        pffft_release_setup(self);
+      else
+        pffft_destroy_setup(self);
+      self = NULL;
+    }
+  }
 
 public:
   typedef float value_type;
@@ -438,19 +815,30 @@ public:
 
   Setup()
     : self(NULL)
+    , cached(false)
   {}
 
-  ~Setup() { pffft_destroy_setup(self); }
+  ~Setup() { release(); }
 
+  // 1D setups are shared through the setup cache
   void prepareLength(int length)
   {
-    if (self) {
-      pffft_destroy_setup(self);
+    release();
+    if (length > 0) {
+      self = pffft_acquire_setup(length, PFFFT_REAL);
+      cached = true;
     }
-    self = pffft_new_setup(length, PFFFT_REAL);
+  }
+
+  void prepareLength2D(int rows, int cols)
+  {
+    release();
+    self = pffft_new_setup_2d(rows, cols, PFFFT_REAL);
+    cached = false;
   }
 
   bool isValid() const { return (self); }
+  int workSize() const { return pffft_work_size(self); }
 
   void transform_ordered(const Scalar* input,
                          Scalar* output,
@@ -468,6 +856,15 @@ public:
     pffft_transform(self, input, output, work, direction);
   }
 
+  void transform_ordered_batch(int count,
+                               const Scalar* input, int input_stride,
+                               Scalar* output, int output_stride,
+                               Scalar* work,
+                               pffft_direction_t direction)
+  {
+    pffft_transform_ordered_batch(self, count, input, input_stride, output, output_stride, work, direction);
+  }
+
   void reorder(const Scalar* input, Scalar* output, pffft_direction_t direction)
   {
     pffft_zreorder(self, input, output, direction);
@@ -495,6 +892,18 @@ template<>
 class Setup< std::complex<float> >
 {
   PFFFT_Setup* self;
+  bool cached;
+
+  void release()
+  {
+    if (self) {
+      if (cached)
+        pffft_release_setup(self);
+      else
+        pffft_destroy_setup(self);
+      self = NULL;
+    }
+  }
 
 public:
   typedef std::complex<float> value_type;
@@ -502,19 +911,30 @@ public:
 
   Setup()
     : self(NULL)
+    , cached(false)
   {}
 
-  ~Setup() { pffft_destroy_setup(self); }
+  ~Setup() { release(); }
 
+  // 1D setups are shared through the setup cache
   void prepareLength(int length)
   {
-    if (self) {
-      pffft_destroy_setup(self);
+    release();
+    if (length > 0) {
+      self = pffft_acquire_setup(length, PFFFT_COMPLEX);
+      cached = true;
     }
-    self = pffft_new_setup(length, PFFFT_COMPLEX);
+  }
+
+  void prepareLength2D(int rows, int cols)
+  {
+    release();
+    self = pffft_new_setup_2d(rows, cols, PFFFT_COMPLEX);
+    cached = false;
   }
 
   bool isValid() const { return (self); }
+  int workSize() const { return pffft_work_size(self); }
 
   void transform_ordered(const Scalar* input,
                          Scalar* output,
@@ -532,11 +952,28 @@ public:
     pffft_transform(self, input, output, work, direction);
   }
 
+  void transform_ordered_batch(int count,
+                               const Scalar* input, int input_stride,
+                               Scalar* output, int output_stride,
+                               Scalar* work,
+                               pffft_direction_t direction)
+  {
+    pffft_transform_ordered_batch(self, count, input, input_stride, output, output_stride, work, direction);
+  }
+
   void reorder(const Scalar* input, Scalar* output, pffft_direction_t direction)
   {
     pffft_zreorder(self, input, output, direction);
   }
 
+  void convolveAccumulate(const Scalar* dft_a,
+                          const Scalar* dft_b,
+                          Scalar* dft_ab,
+                          const Scalar scaling)
+  {
+    pffft_zconvolve_accumulate(self, dft_a, dft_b, dft_ab, scaling);
+  }
+
   void convolve(const Scalar* dft_a,
                 const Scalar* dft_b,
                 Scalar* dft_ab,
@@ -555,6 +992,18 @@ template<>
 class Setup<double>
 {
   PFFFTD_Setup* self;
+  bool cached;
+
+  void release()
+  {
+    if (self) {
+      if (cached)
+        pffftd_release_setup(self);
+      else
+        pffftd_destroy_setup(self);
+      self = NULL;
+    }
+  }
 
 public:
   typedef double value_type;
@@ -562,22 +1011,30 @@ public:
 
   Setup()
     : self(NULL)
+    , cached(false)
   {}
 
-  ~Setup() { pffftd_destroy_setup(self); }
+  ~Setup() { release(); }
 
+  // 1D setups are shared through the setup cache
   void prepareLength(int length)
   {
-    if (self) {
-      pffftd_destroy_setup(self);
-      self = NULL;
-    }
+    release();
     if (length > 0) {
-      self = pffftd_new_setup(length, PFFFT_REAL);
+      self = pffftd_acquire_setup(length, PFFFT_REAL);
+      cached = true;
     }
   }
 
+  void prepareLength2D(int rows, int cols)
+  {
+    release();
+    self = pffftd_new_setup_2d(rows, cols, PFFFT_REAL);
+    cached = false;
+  }
+
   bool isValid() const { return (self); }
+  int workSize() const { return pffftd_work_size(self); }
 
   void transform_ordered(const Scalar* input,
                          Scalar* output,
@@ -595,6 +1052,15 @@ public:
     pffftd_transform(self, input, output, work, direction);
   }
 
+  void transform_ordered_batch(int count,
+                               const Scalar* input, int input_stride,
+                               Scalar* output, int output_stride,
+                               Scalar* work,
+                               pffft_direction_t direction)
+  {
+    pffftd_transform_ordered_batch(self, count, input, input_stride, output, output_stride, work, direction);
+  }
+
   void reorder(const Scalar* input, Scalar* output, pffft_direction_t direction)
   {
     pffftd_zreorder(self, input, output, direction);
@@ -621,6 +1087,18 @@ template<>
 class Setup< std::complex<double> >
 {
   PFFFTD_Setup* self;
+  bool cached;
+
+  void release()
+  {
+    if (self) {
+      if (cached)
+        pffftd_release_setup(self);
+      else
+        pffftd_destroy_setup(self);
+      self = NULL;
+    }
+  }
 
 public:
   typedef std::complex<double> value_type;
@@ -628,19 +1106,30 @@ public:
 
   Setup()
     : self(NULL)
+    , cached(false)
   {}
 
-  ~Setup() { pffftd_destroy_setup(self); }
+  ~Setup() { release(); }
 
+  // 1D setups are shared through the setup cache
   void prepareLength(int length)
   {
-    if (self) {
-      pffftd_destroy_setup(self);
+    release();
+    if (length > 0) {
+      self = pffftd_acquire_setup(length, PFFFT_COMPLEX);
+      cached = true;
     }
-    self = pffftd_new_setup(length, PFFFT_COMPLEX);
+  }
+
+  void prepareLength2D(int rows, int cols)
+  {
+    release();
+    self = pffftd_new_setup_2d(rows, cols, PFFFT_COMPLEX);
+    cached = false;
   }
 
   bool isValid() const { return (self); }
+  int workSize() const { return pffftd_work_size(self); }
 
   void transform_ordered(const Scalar* input,
                          Scalar* output,
@@ -658,6 +1147,15 @@ public:
     pffftd_transform(self, input, output, work, direction);
   }
 
+  void transform_ordered_batch(int count,
+                               const Scalar* input, int input_stride,
+                               Scalar* output, int output_stride,
+                               Scalar* work,
+                               pffft_direction_t direction)
+  {
+    pffftd_transform_ordered_batch(self, count, input, input_stride, output, output_stride, work, direction);
+  }
+
   void reorder(const Scalar* input, Scalar* output, pffft_direction_t direction)
   {
     pffftd_zreorder(self, input, output, direction);
@@ -741,7 +1239,8 @@ Fft<T>::prepareLength(int newLength)
   }
 
   if (useHeap) {
-    work = reinterpret_cast<Scalar*>( alignedAllocType(length) );
+    // Bluestein's sizes need more than the length
+    work = alignedAlloc<Scalar>( setup.workSize() );
   }
 
   return true;
@@ -787,6 +1286,22 @@ Fft<T>::inverse(const AlignedVector<Complex> & spectrum, AlignedVector<T> & outp
 }
 
 
+template<typename T>
+inline AlignedVector< typename Fft<T>::Complex > &
+Fft<T>::forwardBatch(int count, const AlignedVector<T> & input, AlignedVector<Complex> & spectrum)
+{
+  forwardBatch( count, input.data(), length, spectrum.data(), getSpectrumSize() );
+  return spectrum;
+}
+
+template<typename T>
+inline AlignedVector<T> &
+Fft<T>::inverseBatch(int count, const AlignedVector<Complex> & spectrum, AlignedVector<T> & output)
+{
+  inverseBatch( count, spectrum.data(), getSpectrumSize(), output.data(), length );
+  return output;
+}
+
 template<typename T>
 inline AlignedVector< typename Fft<T>::Scalar > &
 Fft<T>::forwardToInternalLayout(
@@ -867,6 +1382,38 @@ Fft<T>::inverse(Complex const* spectrum, T* output)
   return output;
 }
 
+template<typename T>
+inline typename Fft<T>::Complex *
+Fft<T>::forwardBatch(int count, const T* input, int inputStride,
+                     Complex* spectrum, int spectrumStride)
+{
+  assert(isValid());
+  setup.transform_ordered_batch(count,
+                                reinterpret_cast<const Scalar*>(input),
+                                inputStride * int(sizeof(T) / sizeof(Scalar)),
+                                reinterpret_cast<Scalar*>(spectrum),
+                                spectrumStride * 2,
+                                work,
+                                detail::PFFFT_FORWARD);
+  return spectrum;
+}
+
+template<typename T>
+inline T*
+Fft<T>::inverseBatch(int count, const Complex* spectrum, int spectrumStride,
+                     T* output, int outputStride)
+{
+  assert(isValid());
+  setup.transform_ordered_batch(count,
+                                reinterpret_cast<const Scalar*>(spectrum),
+                                spectrumStride * 2,
+                                reinterpret_cast<Scalar*>(output),
+                                outputStride * int(sizeof(T) / sizeof(Scalar)),
+                                work,
+                                detail::PFFFT_BACKWARD);
+  return output;
+}
+
 template<typename T>
 inline typename pffft::Fft<T>::Scalar*
 Fft<T>::forwardToInternalLayout(const T* input, Scalar* spectrum_internal_layout)
@@ -953,6 +1500,395 @@ Fft<T>::alignedAllocComplex(int length)
 }
 
 
+template<typename T>
+inline bool
+Fft<T>::isSimdAligned(const void* ptr)
+{
+  const std::size_t mask = std::size_t( simd_size() ) * sizeof(Scalar) - 1;
+  return ( reinterpret_cast<std::size_t>(ptr) & mask ) == 0;
+}
+
+template<typename T>
+inline Span< typename Fft<T>::Complex >
+Fft<T>::forward(Span<const T> input, Span<Complex> spectrum)
+{
+  assert( input.size() >= length && spectrum.size() >= getSpectrumSize() );
+  assert( isSimdAligned(input.data()) && isSimdAligned(spectrum.data()) );
+  forward( input.data(), spectrum.data() );
+  return spectrum.first( getSpectrumSize() );
+}
+
+template<typename T>
+inline Span<T>
+Fft<T>::inverse(Span<const Complex> spectrum, Span<T> output)
+{
+  assert( spectrum.size() >= getSpectrumSize() && output.size() >= length );
+  assert( isSimdAligned(spectrum.data()) && isSimdAligned(output.data()) );
+  inverse( spectrum.data(), output.data() );
+  return output.first( length );
+}
+
+template<typename T>
+inline Span< typename Fft<T>::Complex >
+Fft<T>::forwardBatch(int count, Span<const T> input, Span<Complex> spectrum)
+{
+  assert( input.size() >= count * length && spectrum.size() >= count * getSpectrumSize() );
+  assert( isSimdAligned(input.data()) && isSimdAligned(spectrum.data()) );
+  forwardBatch( count, input.data(), length, spectrum.data(), getSpectrumSize() );
+  return spectrum.first( count * getSpectrumSize() );
+}
+
+template<typename T>
+inline Span<T>
+Fft<T>::inverseBatch(int count, Span<const Complex> spectrum, Span<T> output)
+{
+  assert( spectrum.size() >= count * getSpectrumSize() && output.size() >= count * length );
+  assert( isSimdAligned(spectrum.data()) && isSimdAligned(output.data()) );
+  inverseBatch( count, spectrum.data(), getSpectrumSize(), output.data(), length );
+  return output.first( count * length );
+}
+
+template<typename T>
+inline Span< typename Fft<T>::Scalar >
+Fft<T>::forwardToInternalLayout(Span<const T> input, Span<Scalar> spectrum_internal_layout)
+{
+  assert( input.size() >= length && spectrum_internal_layout.size() >= getInternalLayoutSize() );
+  assert( isSimdAligned(input.data()) && isSimdAligned(spectrum_internal_layout.data()) );
+  forwardToInternalLayout( input.data(), spectrum_internal_layout.data() );
+  return spectrum_internal_layout.first( getInternalLayoutSize() );
+}
+
+template<typename T>
+inline Span<T>
+Fft<T>::inverseFromInternalLayout(Span<const Scalar> spectrum_internal_layout, Span<T> output)
+{
+  assert( spectrum_internal_layout.size() >= getInternalLayoutSize() && output.size() >= length );
+  assert( isSimdAligned(spectrum_internal_layout.data()) && isSimdAligned(output.data()) );
+  inverseFromInternalLayout( spectrum_internal_layout.data(), output.data() );
+  return output.first( length );
+}
+
+template<typename T>
+inline Span< typename Fft<T>::Complex >
+Fft<T>::reorderSpectrum(Span<const Scalar> input, Span<Complex> output)
+{
+  assert( input.size() >= getInternalLayoutSize() && output.size() >= getSpectrumSize() );
+  assert( isSimdAligned(input.data()) && isSimdAligned(output.data()) );
+  reorderSpectrum( input.data(), output.data() );
+  return output.first( getSpectrumSize() );
+}
+
+template<typename T>
+inline Span< typename Fft<T>::Scalar >
+Fft<T>::convolve(Span<const Scalar> spectrum_internal_a,
+                 Span<const Scalar> spectrum_internal_b,
+                 Span<Scalar> spectrum_internal_ab,
+                 const Scalar scaling)
+{
+  const int n = getInternalLayoutSize();
+  assert( spectrum_internal_a.size() >= n && spectrum_internal_b.size() >= n
+          && spectrum_internal_ab.size() >= n );
+  assert( isSimdAligned(spectrum_internal_a.data()) && isSimdAligned(spectrum_internal_b.data())
+          && isSimdAligned(spectrum_internal_ab.data()) );
+  convolve( spectrum_internal_a.data(), spectrum_internal_b.data(),
+            spectrum_internal_ab.data(), scaling );
+  return spectrum_internal_ab.first( n );
+}
+
+template<typename T>
+inline Span< typename Fft<T>::Scalar >
+Fft<T>::convolveAccumulate(Span<const Scalar> spectrum_internal_a,
+                           Span<const Scalar> spectrum_internal_b,
+                           Span<Scalar> spectrum_internal_ab,
+                           const Scalar scaling)
+{
+  const int n = getInternalLayoutSize();
+  assert( spectrum_internal_a.size() >= n && spectrum_internal_b.size() >= n
+          && spectrum_internal_ab.size() >= n );
+  assert( isSimdAligned(spectrum_internal_a.data()) && isSimdAligned(spectrum_internal_b.data())
+          && isSimdAligned(spectrum_internal_ab.data()) );
+  convolveAccumulate( spectrum_internal_a.data(), spectrum_internal_b.data(),
+                      spectrum_internal_ab.data(), scaling );
+  return spectrum_internal_ab.first( n );
+}
+
+
+
+template<typename T, int N>
+inline FixedFft<T, N>::FixedFft(int stackThresholdLen)
+  : Fft<T>(N, stackThresholdLen)
+{
+#if (__cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900))
+  static_assert( detail::IsNativeSize<N, IsComplex != 0>::value, "FixedFft<T, N> requires a native transform size N" );
+#elif defined(__GNUC__)
+  char static_assert_like[ detail::IsNativeSize<N, IsComplex != 0>::value ? 1 : -1 ]; // FixedFft<T, N> requires a native transform size N
+  (void)static_assert_like;
+#endif
+}
+
+template<typename T, int N>
+inline typename FixedFft<T, N>::SpectrumArray &
+FixedFft<T, N>::forward(const ValueArray & input, SpectrumArray & spectrum)
+{
+  Fft<T>::forward( input.data(), spectrum.data() );
+  return spectrum;
+}
+
+template<typename T, int N>
+inline typename FixedFft<T, N>::ValueArray &
+FixedFft<T, N>::inverse(const SpectrumArray & spectrum, ValueArray & output)
+{
+  Fft<T>::inverse( spectrum.data(), output.data() );
+  return output;
+}
+
+template<typename T, int N>
+inline typename FixedFft<T, N>::InternalLayoutArray &
+FixedFft<T, N>::forwardToInternalLayout(
+    const ValueArray & input,
+    InternalLayoutArray & spectrum_internal_layout )
+{
+  Fft<T>::forwardToInternalLayout( input.data(), spectrum_internal_layout.data() );
+  return spectrum_internal_layout;
+}
+
+template<typename T, int N>
+inline typename FixedFft<T, N>::ValueArray &
+FixedFft<T, N>::inverseFromInternalLayout(
+    const InternalLayoutArray & spectrum_internal_layout,
+    ValueArray & output )
+{
+  Fft<T>::inverseFromInternalLayout( spectrum_internal_layout.data(), output.data() );
+  return output;
+}
+
+template<typename T, int N>
+inline typename FixedFft<T, N>::SpectrumArray &
+FixedFft<T, N>::reorderSpectrum(
+    const InternalLayoutArray & input,
+    SpectrumArray & output )
+{
+  Fft<T>::reorderSpectrum( input.data(), output.data() );
+  return output;
+}
+
+template<typename T, int N>
+inline typename FixedFft<T, N>::InternalLayoutArray &
+FixedFft<T, N>::convolve(
+    const InternalLayoutArray & spectrum_internal_a,
+    const InternalLayoutArray & spectrum_internal_b,
+    InternalLayoutArray & spectrum_internal_ab,
+    const Scalar scaling )
+{
+  Fft<T>::convolve( spectrum_internal_a.data(), spectrum_internal_b.data(),
+                    spectrum_internal_ab.data(), scaling );
+  return spectrum_internal_ab;
+}
+
+template<typename T, int N>
+inline typename FixedFft<T, N>::InternalLayoutArray &
+FixedFft<T, N>::convolveAccumulate(
+    const InternalLayoutArray & spectrum_internal_a,
+    const InternalLayoutArray & spectrum_internal_b,
+    InternalLayoutArray & spectrum_internal_ab,
+    const Scalar scaling )
+{
+  Fft<T>::convolveAccumulate( spectrum_internal_a.data(), spectrum_internal_b.data(),
+                              spectrum_internal_ab.data(), scaling );
+  return spectrum_internal_ab;
+}
+
+
+
+template<typename T>
+inline Fft2D<T>::Fft2D(int rows, int cols)
+  : work(NULL)
+  , rows(0)
+  , cols(0)
+{
+  prepareSize(rows, cols);
+}
+
+template<typename T>
+inline Fft2D<T>::~Fft2D()
+{
+  alignedFree(work);
+}
+
+template<typename T>
+inline bool
+Fft2D<T>::prepareSize(int newRows, int newCols)
+{
+  if (newRows == rows && newCols == cols && isValid())
+    return true;
+
+  rows = cols = 0;
+  alignedFree(work);
+  work = NULL;
+
+  setup.prepareLength2D(newRows, newCols);
+  if (!setup.isValid())
+    return false;
+
+  rows = newRows;
+  cols = newCols;
+  // the stack is no option for the 2D work memory
+  work = alignedAlloc<Scalar>( 2 * rows * cols );
+  return true;
+}
+
+template<typename T>
+inline AlignedVector< typename Fft2D<T>::Complex > &
+Fft2D<T>::forward(const AlignedVector<T> & input, AlignedVector<Complex> & spectrum)
+{
+  forward( input.data(), spectrum.data() );
+  return spectrum;
+}
+
+template<typename T>
+inline AlignedVector<T> &
+Fft2D<T>::inverse(const AlignedVector<Complex> & spectrum, AlignedVector<T> & output)
+{
+  inverse( spectrum.data(), output.data() );
+  return output;
+}
+
+template<typename T>
+inline AlignedVector< typename Fft2D<T>::Scalar > &
+Fft2D<T>::forwardToInternalLayout(
+    const AlignedVector<T> & input,
+    AlignedVector<Scalar> & spectrum_internal_layout )
+{
+  forwardToInternalLayout( input.data(), spectrum_internal_layout.data() );
+  return spectrum_internal_layout;
+}
+
+template<typename T>
+inline AlignedVector<T> &
+Fft2D<T>::inverseFromInternalLayout(
+    const AlignedVector<Scalar> & spectrum_internal_layout,
+    AlignedVector<T> & output )
+{
+  inverseFromInternalLayout( spectrum_internal_layout.data(), output.data() );
+  return output;
+}
+
+template<typename T>
+inline void
+Fft2D<T>::reorderSpectrum(
+    const AlignedVector<Scalar> & input,
+    AlignedVector<Complex> & output )
+{
+  reorderSpectrum( input.data(), output.data() );
+}
+
+template<typename T>
+inline AlignedVector< typename Fft2D<T>::Scalar > &
+Fft2D<T>::convolve(
+    const AlignedVector<Scalar> & spectrum_internal_a,
+    const AlignedVector<Scalar> & spectrum_internal_b,
+    AlignedVector<Scalar> & spectrum_internal_ab,
+    const Scalar scaling )
+{
+  convolve( spectrum_internal_a.data(), spectrum_internal_b.data(),
+            spectrum_internal_ab.data(), scaling );
+  return spectrum_internal_ab;
+}
+
+template<typename T>
+inline AlignedVector< typename Fft2D<T>::Scalar > &
+Fft2D<T>::convolveAccumulate(
+    const AlignedVector<Scalar> & spectrum_internal_a,
+    const AlignedVector<Scalar> & spectrum_internal_b,
+    AlignedVector<Scalar> & spectrum_internal_ab,
+    const Scalar scaling )
+{
+  convolveAccumulate( spectrum_internal_a.data(), spectrum_internal_b.data(),
+                      spectrum_internal_ab.data(), scaling );
+  return spectrum_internal_ab;
+}
+
+template<typename T>
+inline typename Fft2D<T>::Complex *
+Fft2D<T>::forward(const T* input, Complex * spectrum)
+{
+  assert(isValid());
+  setup.transform_ordered(reinterpret_cast<const Scalar*>(input),
+                          reinterpret_cast<Scalar*>(spectrum),
+                          work,
+                          detail::PFFFT_FORWARD);
+  return spectrum;
+}
+
+template<typename T>
+inline T*
+Fft2D<T>::inverse(Complex const* spectrum, T* output)
+{
+  assert(isValid());
+  setup.transform_ordered(reinterpret_cast<const Scalar*>(spectrum),
+                          reinterpret_cast<Scalar*>(output),
+                          work,
+                          detail::PFFFT_BACKWARD);
+  return output;
+}
+
+template<typename T>
+inline typename Fft2D<T>::Scalar*
+Fft2D<T>::forwardToInternalLayout(const T* input, Scalar* spectrum_internal_layout)
+{
+  assert(isValid());
+  setup.transform(reinterpret_cast<const Scalar*>(input),
+                  spectrum_internal_layout,
+                  work,
+                  detail::PFFFT_FORWARD);
+  return spectrum_internal_layout;
+}
+
+template<typename T>
+inline T*
+Fft2D<T>::inverseFromInternalLayout(const Scalar* spectrum_internal_layout, T* output)
+{
+  assert(isValid());
+  setup.transform(spectrum_internal_layout,
+                  reinterpret_cast<Scalar*>(output),
+                  work,
+                  detail::PFFFT_BACKWARD);
+  return output;
+}
+
+template<typename T>
+inline void
+Fft2D<T>::reorderSpectrum( const Scalar* input, Complex* output )
+{
+  assert(isValid());
+  setup.reorder(input, reinterpret_cast<Scalar*>(output), detail::PFFFT_FORWARD);
+}
+
+template<typename T>
+inline typename Fft2D<T>::Scalar*
+Fft2D<T>::convolveAccumulate(const Scalar* dft_a,
+                             const Scalar* dft_b,
+                             Scalar* dft_ab,
+                             const Scalar scaling)
+{
+  assert(isValid());
+  setup.convolveAccumulate(dft_a, dft_b, dft_ab, scaling);
+  return dft_ab;
+}
+
+template<typename T>
+inline typename Fft2D<T>::Scalar*
+Fft2D<T>::convolve(const Scalar* dft_a,
+                   const Scalar* dft_b,
+                   Scalar* dft_ab,
+                   const Scalar scaling)
+{
+  assert(isValid());
+  setup.convolve(dft_a, dft_b, dft_ab, scaling);
+  return dft_ab;
+}
+
+
 
 ////////////////////////////////////////////////////////////////////
 
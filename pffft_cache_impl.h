@@ -0,0 +1,144 @@
+
+/* cache of shared, reference counted setups, see pffft_acquire_setup()
+ * in pffft.h. each precision (pffft.c and pffft_double.c) has its own
+ * cache. setups are never modified by the transforms: one instance can
+ * be used from many threads at the same time.
+ *
+ * this file requires the FUNC_* / SETUP_STRUCT definitions from
+ * pffft.c or pffft_double.c - and the threading headers included there:
+ * it's only for library internal use
+ */
+
+#if defined(_WIN32)
+static SRWLOCK setup_cache_lock = SRWLOCK_INIT;
+#  define SETUP_CACHE_LOCK()    AcquireSRWLockExclusive(&setup_cache_lock)
+#  define SETUP_CACHE_UNLOCK()  ReleaseSRWLockExclusive(&setup_cache_lock)
+#elif !defined(PFFFT_NO_THREADS)
+static pthread_mutex_t setup_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+#  define SETUP_CACHE_LOCK()    pthread_mutex_lock(&setup_cache_lock)
+#  define SETUP_CACHE_UNLOCK()  pthread_mutex_unlock(&setup_cache_lock)
+#else
+#  define SETUP_CACHE_LOCK()
+#  define SETUP_CACHE_UNLOCK()
+#endif
+
+typedef struct setup_cache_entry {
+  struct setup_cache_entry *next;   /* list is ordered by last use: most recent first */
+  SETUP_STRUCT *setup;
+  size_t bytes;
+  int N;
+  pffft_transform_t transform;
+  int refcount;
+} setup_cache_entry;
+
+static setup_cache_entry *setup_cache_list = 0;
+static size_t setup_cache_bytes = 0;
+static size_t setup_cache_limit = (size_t)-1;
+
+/* approximate memory of a setup: twiddle factors of the SIMD and scalar passes */
+static size_t setup_cache_entry_bytes(int N, pffft_transform_t transform) {
+  const size_t Nfloat = (transform == PFFFT_COMPLEX ? 2 * (size_t)N : (size_t)N);
+  return sizeof(setup_cache_entry) + 128 + Nfloat * sizeof(float);
+}
+
+/* evict unreferenced entries, least recently used first, until the
+   cache fits into its limit. requires the lock */
+static void setup_cache_evict(void) {
+  while (setup_cache_bytes > setup_cache_limit) {
+    setup_cache_entry **pp, **victim = 0;
+    for (pp = &setup_cache_list; *pp; pp = &(*pp)->next) {
+      if ((*pp)->refcount == 0)
+        victim = pp;
+    }
+    if (!victim)
+      break;
+    {
+      setup_cache_entry *e = *victim;
+      *victim = e->next;
+      setup_cache_bytes -= e->bytes;
+      FUNC_DESTROY(e->setup);
+      free(e);
+    }
+  }
+}
+
+SETUP_STRUCT *FUNC_ACQUIRE_SETUP(int N, pffft_transform_t transform) {
+  setup_cache_entry **pp, *e = 0;
+  SETUP_STRUCT *s;
+
+  SETUP_CACHE_LOCK();
+  for (pp = &setup_cache_list; *pp; pp = &(*pp)->next) {
+    if ((*pp)->N == N && (*pp)->transform == transform) {
+      e = *pp;
+      *pp = e->next;   /* unlink - for moving to the front */
+      break;
+    }
+  }
+  if (!e) {
+    /* the setup is computed under the lock: concurrent requests
+       for the same size don't compute the twiddles twice */
+    s = FUNC_NEW_SETUP(N, transform);
+    if (s)
+      e = (setup_cache_entry*)malloc(sizeof(setup_cache_entry));
+    if (!e) {
+      FUNC_DESTROY(s);
+      SETUP_CACHE_UNLOCK();
+      return 0;
+    }
+    e->setup = s;
+    e->bytes = setup_cache_entry_bytes(N, transform);
+    e->N = N;
+    e->transform = transform;
+    e->refcount = 0;
+    setup_cache_bytes += e->bytes;
+  }
+  ++e->refcount;
+  e->next = setup_cache_list;
+  setup_cache_list = e;
+  s = e->setup;
+  setup_cache_evict();
+  SETUP_CACHE_UNLOCK();
+  return s;
+}
+
+void FUNC_RELEASE_SETUP(SETUP_STRUCT *setup) {
+  setup_cache_entry *e;
+  if (!setup)
+    return;
+  SETUP_CACHE_LOCK();
+  for (e = setup_cache_list; e; e = e->next) {
+    if (e->setup == setup) {
+      assert(e->refcount > 0);
+      --e->refcount;
+      break;
+    }
+  }
+  assert(e != 0);  /* setup is not from FUNC_ACQUIRE_SETUP() */
+  setup_cache_evict();
+  SETUP_CACHE_UNLOCK();
+}
+
+void FUNC_SET_CACHE_LIMIT(size_t max_bytes) {
+  SETUP_CACHE_LOCK();
+  setup_cache_limit = max_bytes;
+  setup_cache_evict();
+  SETUP_CACHE_UNLOCK();
+}
+
+size_t FUNC_CACHE_BYTES(void) {
+  size_t bytes;
+  SETUP_CACHE_LOCK();
+  bytes = setup_cache_bytes;
+  SETUP_CACHE_UNLOCK();
+  return bytes;
+}
+
+void FUNC_CLEAR_CACHE(void) {
+  size_t limit;
+  SETUP_CACHE_LOCK();
+  limit = setup_cache_limit;
+  setup_cache_limit = 0;
+  setup_cache_evict();
+  setup_cache_limit = limit;
+  SETUP_CACHE_UNLOCK();
+}
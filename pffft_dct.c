@@ -0,0 +1,469 @@
+/*
+   PFFFT_DCT : DCT/DST of types II, III, IV and MDCT - see pffft_dct.h
+
+   type II (Makhoul): the even samples in ascending order, followed by
+   the odd samples in descending order, v[n] = x[2n], v[N-1-n] = x[2n+1],
+   are transformed with an ordered real FFT of length N. the DCT follows
+   from one complex multiplication per bin:
+
+     X[k] = Re(V[k] * exp(-i pi k / (2N))),  X[N-k] = -Im(V[k] * exp(-i pi k / (2N)))
+
+   type III runs these steps backwards, with the inverse FFT.
+
+   type IV: the complex sequence u[n] = (x[2n] + i x[N-1-2n]) * exp(-i pi (4n+1) / (4N))
+   is transformed with an ordered complex FFT of length N/2, then
+
+     C[k] = U[k] * exp(-i pi k / N),  X[2k] = Re(C[k]),  X[N-1-2k] = -Im(C[k])
+
+   the sine transforms are cosine transforms with reversed input or
+   output and alternating signs:
+
+     DST-II(x)[k]  = DCT-II((-1)^n x[n])[N-1-k]
+     DST-III(X)[n] = (-1)^n DCT-III(X[N-1-k])[n]
+     DST-IV(x)[k]  = (-1)^k DCT-IV(x[N-1-n])[k]
+
+   all of these are folded into the pre- and post-processing, which
+   exists twice: scalar - for any even N - and with the simd macros, if
+   N is a multiple of 2*SIMD_SZ.
+*/
+
+#include "pffft_dct.h"
+
+#include "simd/pf_float.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+struct PFFFT_DCT_Setup
+{
+  int N;
+  pffft_dct_t type;
+  int dst;              /* 1: sine transform */
+  int simd;             /* 1: vectorized pre- and post-processing */
+  PFFFT_Setup *fft;     /* real of length N, or complex of length N/2 for type IV */
+  float *twr;           /* aligned twiddles. type II/III: N/2+1 of exp(-i pi k / (2N)), halved for type III */
+  float *twi;           /*   type IV: N/2 of exp(-i pi (4n+1) / (4N)) */
+  float *tw2r;          /* type IV: N/2 of exp(-i pi k / N) */
+  float *tw2i;
+};
+
+
+PFFFT_DCT_Setup *pffft_dct_new_setup(int N, pffft_dct_t type)
+{
+  const int type4 = (type == PFFFT_DCT_IV || type == PFFFT_DST_IV);
+  const int ntw = N/2 + SIMD_SZ;
+  PFFFT_DCT_Setup *s;
+  int k;
+
+  if (N < 2 || (N & 1))
+    return NULL;
+  s = (PFFFT_DCT_Setup*)calloc(1, sizeof(PFFFT_DCT_Setup));
+  if (!s)
+    return NULL;
+  s->N = N;
+  s->type = type;
+  s->dst = (type == PFFFT_DST_II || type == PFFFT_DST_III || type == PFFFT_DST_IV);
+#if SIMD_SZ > 1
+  s->simd = (N % (2 * SIMD_SZ) == 0);
+#endif
+  s->fft = type4 ? pffft_new_setup(N/2, PFFFT_COMPLEX) : pffft_new_setup(N, PFFFT_REAL);
+  s->twr = (float*)pffft_aligned_malloc((size_t)ntw * sizeof(float));
+  s->twi = (float*)pffft_aligned_malloc((size_t)ntw * sizeof(float));
+  if (type4) {
+    s->tw2r = (float*)pffft_aligned_malloc((size_t)ntw * sizeof(float));
+    s->tw2i = (float*)pffft_aligned_malloc((size_t)ntw * sizeof(float));
+  }
+  if (!s->fft || !s->twr || !s->twi || (type4 && (!s->tw2r || !s->tw2i))) {
+    pffft_dct_destroy_setup(s);
+    return NULL;
+  }
+
+  if (type4) {
+    for (k = 0; k < N/2; ++k) {
+      s->twr[k] = (float)cos(M_PI * (4 * k + 1) / (4.0 * N));
+      s->twi[k] = (float)-sin(M_PI * (4 * k + 1) / (4.0 * N));
+      s->tw2r[k] = (float)cos(M_PI * k / N);
+      s->tw2i[k] = (float)-sin(M_PI * k / N);
+    }
+  } else {
+    /* type III: the factor 1/2 of its definition goes into the twiddles */
+    const double scale = (type == PFFFT_DCT_III || type == PFFFT_DST_III) ? 0.5 : 1.0;
+    for (k = 0; k <= N/2; ++k) {
+      s->twr[k] = (float)(scale * cos(M_PI * k / (2.0 * N)));
+      s->twi[k] = (float)(scale * sin(M_PI * k / (2.0 * N)));
+    }
+  }
+  return s;
+}
+
+
+void pffft_dct_destroy_setup(PFFFT_DCT_Setup *s)
+{
+  if (!s)
+    return;
+  if (s->fft)
+    pffft_destroy_setup(s->fft);
+  pffft_aligned_free(s->twr);
+  pffft_aligned_free(s->twi);
+  pffft_aligned_free(s->tw2r);
+  pffft_aligned_free(s->tw2i);
+  free(s);
+}
+
+
+/* type II: permutation x -> v. the sine transform negates the odd samples */
+static void dct2_pre(const PFFFT_DCT_Setup *s, const float *x, float *v)
+{
+  const int N = s->N;
+  const float sgn = s->dst ? -1.0f : 1.0f;
+  int n = 0;
+#if SIMD_SZ > 1
+  if (s->simd) {
+    for (; n < N/2; n += SIMD_SZ) {
+      v4sf e, o;
+      UNINTERLEAVE2(*(const v4sf*)(x + 2*n), *(const v4sf*)(x + 2*n + SIMD_SZ), e, o);
+      o = VREV_S(o);
+      *(v4sf*)(v + n) = e;
+      *(v4sf*)(v + N - n - SIMD_SZ) = s->dst ? VSUB(VZERO(), o) : o;
+    }
+  }
+#endif
+  for (; n < N/2; ++n) {
+    v[n] = x[2*n];
+    v[N-1-n] = sgn * x[2*n+1];
+  }
+}
+
+
+#if SIMD_SZ > 1
+static void store_unaligned(float *p, v4sf v)
+{
+  v4sf_union u;
+  u.v = v;
+  memcpy(p, u.f, sizeof(u.f));
+}
+#endif
+
+
+/* type II: ordered spectrum Y -> X. the sine transform writes X[k] to out[N-1-k] */
+static void dct2_post(const PFFFT_DCT_Setup *s, const float *Y, float *out)
+{
+  const int N = s->N;
+  const int rev = s->dst ? (N - 1) : 0;    /* output index of X[k]: |rev - k| */
+  const float *c = s->twr, *sn = s->twi;
+  int k = 1, kend = N/2;
+
+  out[rev] = Y[0];
+  out[rev ? (rev - N/2) : N/2] = Y[1] * c[N/2];
+#if SIMD_SZ > 1
+  if (s->simd && N/2 >= 2 * SIMD_SZ) {
+    int kb;
+    kend = SIMD_SZ;
+    for (kb = SIMD_SZ; kb < N/2; kb += SIMD_SZ) {
+      v4sf re, im, a, b;
+      const v4sf vc = *(const v4sf*)(c + kb), vs = *(const v4sf*)(sn + kb);
+      UNINTERLEAVE2(*(const v4sf*)(Y + 2*kb), *(const v4sf*)(Y + 2*kb + SIMD_SZ), re, im);
+      a = VADD(VMUL(re, vc), VMUL(im, vs));    /* X[k], k = kb .. kb+SIMD_SZ-1 */
+      b = VSUB(VMUL(re, vs), VMUL(im, vc));    /* X[N-k] */
+      if (!s->dst) {
+        *(v4sf*)(out + kb) = a;
+        store_unaligned(out + N - kb - SIMD_SZ + 1, VREV_S(b));
+      } else {
+        *(v4sf*)(out + N - kb - SIMD_SZ) = VREV_S(a);
+        store_unaligned(out + kb - 1, b);
+      }
+    }
+  }
+#endif
+  for (; k < kend; ++k) {
+    const float re = Y[2*k], im = Y[2*k+1];
+    const float a = re * c[k] + im * sn[k];
+    const float b = re * sn[k] - im * c[k];
+    if (!s->dst) {
+      out[k] = a;
+      out[N-k] = b;
+    } else {
+      out[N-1-k] = a;
+      out[k-1] = b;
+    }
+  }
+}
+
+
+/* type III: coefficients X -> ordered spectrum Y. the sine transform reads X[k] from in[N-1-k] */
+static void dct3_pre(const PFFFT_DCT_Setup *s, const float *in, float *Y)
+{
+  const int N = s->N;
+  const float *c = s->twr, *sn = s->twi;
+  int k = 1, kend = N/2;
+
+  /* X[N] = 0 */
+  Y[0] = c[0] * (s->dst ? in[N-1] : in[0]);
+  Y[1] = (c[N/2] + sn[N/2]) * in[N/2 - (s->dst ? 1 : 0)];
+#if SIMD_SZ > 1
+  if (s->simd && N/2 >= 2 * SIMD_SZ) {
+    int kb;
+    kend = SIMD_SZ;
+    for (kb = SIMD_SZ; kb < N/2; kb += SIMD_SZ) {
+      const v4sf vc = *(const v4sf*)(c + kb), vs = *(const v4sf*)(sn + kb);
+      v4sf a, b, re, im;
+      if (!s->dst) {
+        a = *(const v4sf*)(in + kb);                                  /* X[k] */
+        b = VREV_S(VLOAD_UNALIGNED(in + N - kb - SIMD_SZ + 1));        /* X[N-k] */
+      } else {
+        a = VREV_S(*(const v4sf*)(in + N - kb - SIMD_SZ));
+        b = VLOAD_UNALIGNED(in + kb - 1);
+      }
+      re = VADD(VMUL(a, vc), VMUL(b, vs));
+      im = VSUB(VMUL(a, vs), VMUL(b, vc));
+      INTERLEAVE2(re, im, *(v4sf*)(Y + 2*kb), *(v4sf*)(Y + 2*kb + SIMD_SZ));
+    }
+  }
+#endif
+  for (; k < kend; ++k) {
+    const float a = s->dst ? in[N-1-k] : in[k];
+    const float b = s->dst ? in[k-1] : in[N-k];
+    Y[2*k] = a * c[k] + b * sn[k];
+    Y[2*k+1] = a * sn[k] - b * c[k];
+  }
+}
+
+
+/* type III: inverse permutation v -> x. the sine transform negates the odd samples */
+static void dct3_post(const PFFFT_DCT_Setup *s, const float *v, float *x)
+{
+  const int N = s->N;
+  const float sgn = s->dst ? -1.0f : 1.0f;
+  int n = 0;
+#if SIMD_SZ > 1
+  if (s->simd) {
+    for (; n < N/2; n += SIMD_SZ) {
+      const v4sf e = *(const v4sf*)(v + n);
+      v4sf o = VREV_S(*(const v4sf*)(v + N - n - SIMD_SZ));
+      if (s->dst)
+        o = VSUB(VZERO(), o);
+      INTERLEAVE2(e, o, *(v4sf*)(x + 2*n), *(v4sf*)(x + 2*n + SIMD_SZ));
+    }
+  }
+#endif
+  for (; n < N/2; ++n) {
+    x[2*n] = v[n];
+    x[2*n+1] = sgn * v[N-1-n];
+  }
+}
+
+
+/* type IV: x -> u, of N/2 complex values. the sine transform reverses x */
+static void dct4_pre(const PFFFT_DCT_Setup *s, const float *x, float *u)
+{
+  const int N = s->N;
+  const float *tr = s->twr, *ti = s->twi;
+  int n = 0;
+#if SIMD_SZ > 1
+  if (s->simd) {
+    for (; n < N/2; n += SIMD_SZ) {
+      v4sf e, o, lo, hi, xr, xi;
+      UNINTERLEAVE2(*(const v4sf*)(x + 2*n), *(const v4sf*)(x + 2*n + SIMD_SZ), e, o);
+      UNINTERLEAVE2(*(const v4sf*)(x + N - 2*n - 2*SIMD_SZ), *(const v4sf*)(x + N - 2*n - SIMD_SZ), lo, hi);
+      (void)o;
+      (void)lo;
+      hi = VREV_S(hi);      /* x[N-1-2n] */
+      xr = s->dst ? hi : e;
+      xi = s->dst ? e : hi;
+      VCPLXMUL(xr, xi, *(const v4sf*)(tr + n), *(const v4sf*)(ti + n));
+      INTERLEAVE2(xr, xi, *(v4sf*)(u + 2*n), *(v4sf*)(u + 2*n + SIMD_SZ));
+    }
+  }
+#endif
+  for (; n < N/2; ++n) {
+    const float xr = s->dst ? x[N-1-2*n] : x[2*n];
+    const float xi = s->dst ? x[2*n] : x[N-1-2*n];
+    u[2*n] = xr * tr[n] - xi * ti[n];
+    u[2*n+1] = xr * ti[n] + xi * tr[n];
+  }
+}
+
+
+/* type IV: ordered spectrum U -> X. the sine transform alternates the signs */
+static void dct4_post(const PFFFT_DCT_Setup *s, const float *U, float *out)
+{
+  const int N = s->N, M = N/2;
+  const float *tr = s->tw2r, *ti = s->tw2i;
+  int k;
+#if SIMD_SZ > 1
+  if (s->simd) {
+    int ka, kb;
+    /* out[2k+1] = -Im(C[M-1-k]): pairs of blocks ka and kb = M - ka - SIMD_SZ */
+    for (ka = 0, kb = M - SIMD_SZ; ka <= kb; ka += SIMD_SZ, kb -= SIMD_SZ) {
+      v4sf ar, ai, br, bi;
+      UNINTERLEAVE2(*(const v4sf*)(U + 2*ka), *(const v4sf*)(U + 2*ka + SIMD_SZ), ar, ai);
+      UNINTERLEAVE2(*(const v4sf*)(U + 2*kb), *(const v4sf*)(U + 2*kb + SIMD_SZ), br, bi);
+      VCPLXMUL(ar, ai, *(const v4sf*)(tr + ka), *(const v4sf*)(ti + ka));
+      VCPLXMUL(br, bi, *(const v4sf*)(tr + kb), *(const v4sf*)(ti + kb));
+      ai = VREV_S(ai);
+      bi = VREV_S(bi);
+      if (!s->dst) {
+        ai = VSUB(VZERO(), ai);
+        bi = VSUB(VZERO(), bi);
+      }
+      INTERLEAVE2(ar, bi, *(v4sf*)(out + 2*ka), *(v4sf*)(out + 2*ka + SIMD_SZ));
+      INTERLEAVE2(br, ai, *(v4sf*)(out + 2*kb), *(v4sf*)(out + 2*kb + SIMD_SZ));
+    }
+    return;
+  }
+#endif
+  for (k = 0; k < M; ++k) {
+    const float re = U[2*k] * tr[k] - U[2*k+1] * ti[k];
+    const float im = U[2*k] * ti[k] + U[2*k+1] * tr[k];
+    out[2*k] = re;
+    out[N-1-2*k] = s->dst ? im : -im;
+  }
+}
+
+
+void pffft_dct_transform(PFFFT_DCT_Setup *s, const float *input, float *output, float *work)
+{
+  /* the pre-processing consumes the input: output is free as work of the FFT -
+     unless that's one of Bluestein's sizes, needing more */
+  float *fwork = (pffft_work_size(s->fft) <= s->N) ? output : NULL;
+  switch (s->type) {
+  case PFFFT_DCT_II:
+  case PFFFT_DST_II:
+    dct2_pre(s, input, work);
+    pffft_transform_ordered(s->fft, work, work, fwork, PFFFT_FORWARD);
+    dct2_post(s, work, output);
+    break;
+  case PFFFT_DCT_III:
+  case PFFFT_DST_III:
+    dct3_pre(s, input, work);
+    pffft_transform_ordered(s->fft, work, work, fwork, PFFFT_BACKWARD);
+    dct3_post(s, work, output);
+    break;
+  default:
+    dct4_pre(s, input, work);
+    pffft_transform_ordered(s->fft, work, work, fwork, PFFFT_FORWARD);
+    dct4_post(s, work, output);
+    break;
+  }
+}
+
+
+/* ===== MDCT ===== */
+
+struct PFFFT_MDCT
+{
+  int M;
+  PFFFT_DCT_Setup *dct4;
+  float *window;        /* 2M */
+  float *hist;          /* the last M input samples */
+  float *overlap;       /* windowed second half of the last inverse block, scaled */
+  float *z;             /* aligned: 2M, windowed block */
+  float *u;             /* aligned: M, folded block / coefficients */
+  float *work;          /* aligned: M */
+};
+
+
+PFFFT_MDCT *pffft_mdct_new(int M, const float *window)
+{
+  PFFFT_MDCT *m;
+  int k;
+
+  if (M < 2 || (M & 1))
+    return NULL;
+  m = (PFFFT_MDCT*)calloc(1, sizeof(PFFFT_MDCT));
+  if (!m)
+    return NULL;
+  m->M = M;
+  m->dct4 = pffft_dct_new_setup(M, PFFFT_DCT_IV);
+  m->window = (float*)malloc(2 * (size_t)M * sizeof(float));
+  m->hist = (float*)malloc((size_t)M * sizeof(float));
+  m->overlap = (float*)malloc((size_t)M * sizeof(float));
+  m->z = (float*)pffft_aligned_malloc(2 * (size_t)M * sizeof(float));
+  m->u = (float*)pffft_aligned_malloc((size_t)M * sizeof(float));
+  m->work = (float*)pffft_aligned_malloc((size_t)M * sizeof(float));
+  if (!m->dct4 || !m->window || !m->hist || !m->overlap || !m->z || !m->u || !m->work) {
+    pffft_mdct_destroy(m);
+    return NULL;
+  }
+  for (k = 0; k < 2 * M; ++k)
+    m->window[k] = window ? window[k] : (float)sin(M_PI * (k + 0.5) / (2.0 * M));
+  pffft_mdct_reset(m);
+  return m;
+}
+
+
+void pffft_mdct_destroy(PFFFT_MDCT *m)
+{
+  if (!m)
+    return;
+  pffft_dct_destroy_setup(m->dct4);
+  free(m->window);
+  free(m->hist);
+  free(m->overlap);
+  pffft_aligned_free(m->z);
+  pffft_aligned_free(m->u);
+  pffft_aligned_free(m->work);
+  free(m);
+}
+
+
+void pffft_mdct_reset(PFFFT_MDCT *m)
+{
+  memset(m->hist, 0, (size_t)m->M * sizeof(float));
+  memset(m->overlap, 0, (size_t)m->M * sizeof(float));
+}
+
+
+/*
+  with the quarters (a, b, c, d) of the windowed block, the MDCT is the
+  DCT-IV of (-c_r - d, a - b_r) - where _r denotes reversal. the IMDCT
+  is the transposed: the DCT-IV (p, q) of the coefficients unfolds to
+  (q, -q_r, -p_r, -p).
+*/
+void pffft_mdct_forward(PFFFT_MDCT *m, const float *input, float *coeffs)
+{
+  const int M = m->M, h = M/2;
+  const float *w = m->window;
+  float *z = m->z, *u = m->u;
+  int n;
+
+  for (n = 0; n < M; ++n) {
+    z[n] = w[n] * m->hist[n];
+    z[M + n] = w[M + n] * input[n];
+  }
+  memcpy(m->hist, input, (size_t)M * sizeof(float));
+  for (n = 0; n < h; ++n) {
+    u[n] = -z[3*h - 1 - n] - z[3*h + n];
+    u[h + n] = z[n] - z[M - 1 - n];
+  }
+  pffft_dct_transform(m->dct4, u, u, m->work);
+  memcpy(coeffs, u, (size_t)M * sizeof(float));
+}
+
+
+void pffft_mdct_inverse(PFFFT_MDCT *m, const float *coeffs, float *output)
+{
+  const int M = m->M, h = M/2;
+  /* DCT-IV twice is M/2 - the windowed overlap-add cancels the aliases */
+  const float scale = 2.0f / M;
+  const float *w = m->window;
+  const float *y = m->u;
+  float *ov = m->overlap;
+  int n;
+
+  memcpy(m->u, coeffs, (size_t)M * sizeof(float));
+  pffft_dct_transform(m->dct4, m->u, m->u, m->work);
+  for (n = 0; n < h; ++n) {
+    output[n] = ov[n] + scale * w[n] * y[h + n];
+    output[h + n] = ov[h + n] - scale * w[h + n] * y[M - 1 - n];
+    ov[n] = -scale * w[M + n] * y[h - 1 - n];
+    ov[h + n] = -scale * w[M + h + n] * y[n];
+  }
+}
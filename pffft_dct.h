@@ -0,0 +1,115 @@
+/*
+   PFFFT_DCT : discrete cosine and sine transforms of types II, III and IV
+   - and a MDCT/IMDCT with windowed overlap-add - on top of pffft.
+
+   DCT-II/III and DST-II/III of length N use a real transform of length
+   N, DCT-IV and DST-IV a complex transform of length N/2. The
+   permutation and the twiddle stages before and after the transform are
+   SIMD-vectorized, similar to the pre/post-processing of the real
+   transforms in pffft.
+
+   Definitions (unnormalized, n, k = 0 .. N-1):
+
+     DCT-II  : X[k] = sum_n x[n] * cos(pi (2n+1) k / (2N))
+     DCT-III : x[n] = X[0]/2 + sum_{k>0} X[k] * cos(pi (2n+1) k / (2N))
+     DCT-IV  : X[k] = sum_n x[n] * cos(pi (2n+1) (2k+1) / (4N))
+     DST-II  : X[k] = sum_n x[n] * sin(pi (2n+1) (k+1) / (2N))
+     DST-III : x[n] = (-1)^n X[N-1]/2 + sum_{k<N-1} X[k] * sin(pi (2n+1) (k+1) / (2N))
+     DST-IV  : X[k] = sum_n x[n] * sin(pi (2n+1) (2k+1) / (4N))
+
+   type III is the inverse of type II, type IV is its own inverse -
+   each up to a factor N/2.
+
+   Restrictions:
+
+   - 32-bit single precision.
+
+   - N has to be even, and pffft_new_setup() has to support a real
+   transform of length N (types II/III) or a complex transform of length
+   N/2 (type IV).
+
+   - all (float*) pointers of pffft_dct_transform() have to be
+   "simd-compatible" aligned, see pffft.h. Allocate them with
+   pffft_aligned_malloc().
+*/
+
+#ifndef PFFFT_DCT_H
+#define PFFFT_DCT_H
+
+#include "pffft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /* opaque struct holding the pffft setup and the twiddle factors.
+     the setup can be shared by many threads, each with its own work memory.
+  */
+  typedef struct PFFFT_DCT_Setup PFFFT_DCT_Setup;
+
+  typedef enum {
+    PFFFT_DCT_II,
+    PFFFT_DCT_III,
+    PFFFT_DCT_IV,
+    PFFFT_DST_II,
+    PFFFT_DST_III,
+    PFFFT_DST_IV
+  } pffft_dct_t;
+
+  /* prepare a transform of the given type and length N.
+     returns NULL if N is not supported. */
+  PFFFT_DCT_Setup *pffft_dct_new_setup(int N, pffft_dct_t type);
+
+  void pffft_dct_destroy_setup(PFFFT_DCT_Setup *setup);
+
+  /*
+    transform N floats from input to output. 'work' needs room for N
+    floats. input and output may alias.
+  */
+  void pffft_dct_transform(PFFFT_DCT_Setup *setup, const float *input, float *output, float *work);
+
+
+  /* opaque struct for the MDCT of M coefficients from blocks of 2M
+     samples, with a hop of M samples. it holds the input history of the
+     forward and the overlap of the inverse transform: forward and
+     inverse transform may be used independently - but each one from
+     a single thread only.
+  */
+  typedef struct PFFFT_MDCT PFFFT_MDCT;
+
+  /*
+    prepare a MDCT with M coefficients: M has to be even and supported
+    by PFFFT_DCT_IV. 'window' has 2M values and is copied; it's used for
+    analysis and synthesis - and has to fulfill the Princen-Bradley
+    condition w[n]^2 + w[n+M]^2 = 1 and w[n] = w[2M-1-n] for perfect
+    reconstruction. NULL selects the sine window
+    w[n] = sin(pi (n + 1/2) / (2M)).
+  */
+  PFFFT_MDCT *pffft_mdct_new(int M, const float *window);
+
+  void pffft_mdct_destroy(PFFFT_MDCT *mdct);
+
+  /* clear the input history and the overlap */
+  void pffft_mdct_reset(PFFFT_MDCT *mdct);
+
+  /*
+    consume M new samples: window the last 2M samples and write their M
+    coefficients
+      X[k] = sum_{n<2M} w[n] x[n] * cos(pi/M (n + 1/2 + M/2) (k + 1/2))
+    input and coeffs don't need to be aligned.
+  */
+  void pffft_mdct_forward(PFFFT_MDCT *mdct, const float *input, float *coeffs);
+
+  /*
+    inverse transform of M coefficients, windowed and overlap-added to
+    the second half of the previous block: writes M output samples.
+    the inverse of the forward transform - with a delay of M samples:
+    there is no scaling to apply. coeffs and output don't need to be aligned.
+  */
+  void pffft_mdct_inverse(PFFFT_MDCT *mdct, const float *coeffs, float *output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PFFFT_DCT_H */
@@ -0,0 +1,498 @@
+
+/* runtime dispatcher for PFFFT: the library is compiled for several
+ * x86 architectures (SSE2, AVX, AVX2+FMA and AVX-512) with different
+ * PFFFT_ARCH_POST, see CMakeLists.txt. each architecture specific build
+ * exports a struct with function pointers. the dispatcher provides the
+ * public functions and selects the widest architecture, which the CPU
+ * supports - or which is given with the environment variable PFFFT_ARCH.
+ *
+ * this file requires the FUNC_* / SETUP_STRUCT definitions from
+ * pffft.c or pffft_double.c:  it's only for library internal use
+ */
+
+
+/* function pointers of one architecture specific build */
+typedef struct {
+  const char * id;
+  int  (*simd_size)(void);
+  const char * (*simd_arch)(void);
+  int  (*min_fft_size)(pffft_transform_t transform);
+  int  (*is_valid_size)(int N, pffft_transform_t cplx);
+  int  (*nearest_size)(int N, pffft_transform_t cplx, int higher);
+  ARCH_SETUP_STRUCT * (*new_setup)(int N, pffft_transform_t transform);
+  ARCH_SETUP_STRUCT * (*new_setup_2d)(int Nrows, int N, pffft_transform_t transform);
+  size_t (*setup_size)(int N, pffft_transform_t transform);
+  ARCH_SETUP_STRUCT * (*init_setup_inplace)(void *mem, int N, pffft_transform_t transform);
+  void (*destroy)(ARCH_SETUP_STRUCT *setup);
+  int  (*work_size)(const ARCH_SETUP_STRUCT *setup);
+  void (*transform)(ARCH_SETUP_STRUCT *setup, const float *input, float *output, float *work, pffft_direction_t direction);
+  void (*transform_ordered)(ARCH_SETUP_STRUCT *setup, const float *input, float *output, float *work, pffft_direction_t direction);
+  void (*transform_batch)(ARCH_SETUP_STRUCT *setup, int count, const float *input, int input_stride,
+                          float *output, int output_stride, float *work, pffft_direction_t direction);
+  void (*transform_ordered_batch)(ARCH_SETUP_STRUCT *setup, int count, const float *input, int input_stride,
+                                  float *output, int output_stride, float *work, pffft_direction_t direction);
+  void (*transform_pair)(ARCH_SETUP_STRUCT *setup, const float *input_a, const float *input_b,
+                         float *output_a, float *output_b, float *work, pffft_direction_t direction);
+  void (*transform_ordered_pair)(ARCH_SETUP_STRUCT *setup, const float *input_a, const float *input_b,
+                                 float *output_a, float *output_b, float *work, pffft_direction_t direction);
+#if defined(FUNC_TRANSFORM_HALF)
+  void (*transform_half)(ARCH_SETUP_STRUCT *setup, pffft_half_t format, int count, const unsigned short *input, int input_stride,
+                         unsigned short *output, int output_stride, float *work, pffft_direction_t direction);
+  void (*transform_ordered_half)(ARCH_SETUP_STRUCT *setup, pffft_half_t format, int count, const unsigned short *input, int input_stride,
+                                 unsigned short *output, int output_stride, float *work, pffft_direction_t direction);
+  void (*half_to_float)(pffft_half_t format, const unsigned short *input, float *output, int count);
+  void (*float_to_half)(pffft_half_t format, const float *input, unsigned short *output, int count);
+#endif
+  void (*zreorder)(ARCH_SETUP_STRUCT *setup, const float *input, float *output, pffft_direction_t direction);
+  void (*zpower)(ARCH_SETUP_STRUCT *setup, const float *dft, float *power);
+  void (*zpower_accumulate)(ARCH_SETUP_STRUCT *setup, const float *dft, float *acc, float scaling);
+  void (*zpower_unpack)(ARCH_SETUP_STRUCT *setup, const float *acc, float *power);
+  void (*zconvolve_accumulate)(ARCH_SETUP_STRUCT *setup, const float *dft_a, const float *dft_b, float *dft_ab, float scaling);
+  void (*zconvolve_no_accu)(ARCH_SETUP_STRUCT *setup, const float *dft_a, const float *dft_b, float *dft_ab, float scaling);
+  void (*zconvolve_transform_bw)(ARCH_SETUP_STRUCT *setup, const float *dft_a, const float *dft_b, float *output, float *work, float scaling);
+  void (*zreal_pack)(ARCH_SETUP_STRUCT *setup, const float *dft_b, float *real_b);
+  void (*zconvolve_real_accumulate)(ARCH_SETUP_STRUCT *setup, const float *dft_a, const float *real_b, float *dft_ab, float scaling);
+  void (*zconvolve_real_no_accu)(ARCH_SETUP_STRUCT *setup, const float *dft_a, const float *real_b, float *dft_ab, float scaling);
+  void (*zbin_index)(ARCH_SETUP_STRUCT *setup, int *re_offset, int *im_offset, int *packed_offset);
+  void (*zmagnitude)(ARCH_SETUP_STRUCT *setup, const float *dft, float *mag);
+  void (*zphase)(ARCH_SETUP_STRUCT *setup, const float *dft, float *phase);
+  void (*zconj_multiply)(ARCH_SETUP_STRUCT *setup, const float *dft_a, const float *dft_b, float *dft_ab, float scaling);
+  void (*zdivide)(ARCH_SETUP_STRUCT *setup, const float *dft_a, const float *dft_b, float *dft_ab, float eps);
+  void (*zdelay)(ARCH_SETUP_STRUCT *setup, const float *dft, float *output, float delay);
+  size_t (*serialized_size)(const ARCH_SETUP_STRUCT *setup);
+  size_t (*serialize)(const ARCH_SETUP_STRUCT *setup, void *blob, size_t blob_size);
+  ARCH_SETUP_STRUCT * (*deserialize)(const void *blob, size_t blob_size, int zero_copy);
+  int  (*get_instr)(const ARCH_SETUP_STRUCT *setup, pffft_instr_snapshot_t *snapshot);
+  void (*reset_instr)(ARCH_SETUP_STRUCT *setup);
+  void (*validate_simd)(void);
+  int  (*validate_simd_ex)(FILE *DbgOut);
+} ARCH_PTRS_STRUCT;
+
+
+#if defined(PFFFT_ARCH_POST)
+
+#define PFFFT_STRINGIFY(X) #X
+#define PFFFT_TOSTRING(X)  PFFFT_STRINGIFY(X)
+
+const ARCH_PTRS_STRUCT FUNC_ARCH_PTRS = {
+  PFFFT_TOSTRING(PFFFT_ARCH_POST),
+  FUNC_SIMD_SIZE,
+  FUNC_SIMD_ARCH,
+  FUNC_MIN_FFT_SIZE,
+  FUNC_IS_VALID_SIZE,
+  FUNC_NEAREST_SIZE,
+  FUNC_NEW_SETUP,
+  FUNC_NEW_SETUP_2D,
+  FUNC_SETUP_SIZE,
+  FUNC_INIT_SETUP_INPLACE,
+  FUNC_DESTROY,
+  FUNC_WORK_SIZE,
+  FUNC_TRANSFORM_UNORDRD,
+  FUNC_TRANSFORM_ORDERED,
+  FUNC_TRANSFORM_BATCH,
+  FUNC_TRANSFORM_ORD_BATCH,
+  FUNC_TRANSFORM_PAIR,
+  FUNC_TRANSFORM_ORD_PAIR,
+#if defined(FUNC_TRANSFORM_HALF)
+  FUNC_TRANSFORM_HALF,
+  FUNC_TRANSFORM_ORD_HALF,
+  FUNC_HALF_TO_FLOAT,
+  FUNC_FLOAT_TO_HALF,
+#endif
+  FUNC_ZREORDER,
+  FUNC_ZPOWER,
+  FUNC_ZPOWER_ACCUMULATE,
+  FUNC_ZPOWER_UNPACK,
+  FUNC_ZCONVOLVE_ACCUMULATE,
+  FUNC_ZCONVOLVE_NO_ACCU,
+  FUNC_ZCONVOLVE_TRANSFORM_BW,
+  FUNC_ZREAL_PACK,
+  FUNC_ZCONVOLVE_REAL_ACCUMULATE,
+  FUNC_ZCONVOLVE_REAL_NO_ACCU,
+  FUNC_ZBIN_INDEX,
+  FUNC_ZMAGNITUDE,
+  FUNC_ZPHASE,
+  FUNC_ZCONJ_MULTIPLY,
+  FUNC_ZDIVIDE,
+  FUNC_ZDELAY,
+  FUNC_SERIALIZED_SIZE,
+  FUNC_SERIALIZE,
+  FUNC_DESERIALIZE,
+  FUNC_GET_INSTR,
+  FUNC_RESET_INSTR,
+  FUNC_VALIDATE_SIMD_A,
+  FUNC_VALIDATE_SIMD_EX
+};
+
+#else  /* dispatcher */
+
+#include <string.h>
+
+#if defined(COMPILER_MSVC)
+#  include <intrin.h>
+#else
+#  include <cpuid.h>
+#endif
+
+extern const ARCH_PTRS_STRUCT PFFFT_CONCAT(FUNC_ARCH_PTRS, _sse2);
+extern const ARCH_PTRS_STRUCT PFFFT_CONCAT(FUNC_ARCH_PTRS, _avx);
+extern const ARCH_PTRS_STRUCT PFFFT_CONCAT(FUNC_ARCH_PTRS, _avx2);
+extern const ARCH_PTRS_STRUCT PFFFT_CONCAT(FUNC_ARCH_PTRS, _avx512);
+
+/* in order of required CPU features: each one includes the previous ones */
+#define N_DISPATCH_ARCHES  4
+static const ARCH_PTRS_STRUCT * const dispatch_arches[N_DISPATCH_ARCHES] = {
+  &PFFFT_CONCAT(FUNC_ARCH_PTRS, _sse2),
+  &PFFFT_CONCAT(FUNC_ARCH_PTRS, _avx),
+  &PFFFT_CONCAT(FUNC_ARCH_PTRS, _avx2),
+  &PFFFT_CONCAT(FUNC_ARCH_PTRS, _avx512)
+};
+
+struct SETUP_STRUCT {
+  const ARCH_PTRS_STRUCT *arch;
+  ARCH_SETUP_STRUCT *s;
+  int inplace;    /* from FUNC_INIT_SETUP_INPLACE(): nothing to free */
+};
+
+/* in-place setups: this struct, padded to 64 bytes, is followed by the architecture specific setup */
+#define DISPATCH_SETUP_HDR_BYTES  ( (sizeof(SETUP_STRUCT) + 63) & ~(size_t)63 )
+
+
+static void dispatch_cpuid(unsigned leaf, unsigned subleaf, unsigned r[4]) {
+#if defined(COMPILER_MSVC)
+  int regs[4];
+  __cpuidex(regs, (int)leaf, (int)subleaf);
+  r[0] = regs[0]; r[1] = regs[1]; r[2] = regs[2]; r[3] = regs[3];
+#else
+  __cpuid_count(leaf, subleaf, r[0], r[1], r[2], r[3]);
+#endif
+}
+
+static unsigned dispatch_xgetbv(void) {
+#if defined(COMPILER_MSVC)
+  return (unsigned)_xgetbv(0);
+#else
+  unsigned eax, edx;
+  __asm__ __volatile__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return eax;
+#endif
+}
+
+/* index into dispatch_arches[] of the widest architecture, the CPU
+   and the operating system (saving the wider registers) do support */
+static int dispatch_cpu_level(void) {
+  unsigned r[4], max_leaf, xcr0 = 0;
+  int level = 0;
+  dispatch_cpuid(0, 0, r);
+  max_leaf = r[0];
+  if (max_leaf < 1)
+    return level;
+  dispatch_cpuid(1, 0, r);
+  if ( (r[2] & (1U << 27)) == 0 )   /* OSXSAVE */
+    return level;
+  xcr0 = dispatch_xgetbv();
+  if ( (r[2] & (1U << 28)) == 0 || (xcr0 & 0x06) != 0x06 )  /* AVX, XMM+YMM state */
+    return level;
+  level = 1;
+  if ( (r[2] & (1U << 12)) == 0 || (r[2] & (1U << 29)) == 0 || max_leaf < 7 )  /* FMA, F16C */
+    return level;
+  dispatch_cpuid(7, 0, r);
+  if ( (r[1] & (1U << 5)) == 0 )    /* AVX2 */
+    return level;
+  level = 2;
+  if ( (r[1] & (1U << 16)) == 0 || (xcr0 & 0xE0) != 0xE0 )  /* AVX512F, opmask+ZMM state */
+    return level;
+  return 3;
+}
+
+/* level of architecture to use: limited by environment variable PFFFT_ARCH */
+static int dispatch_level(void) {
+  static int level = -1;
+  if (level < 0) {
+    int k, l = dispatch_cpu_level();
+    const char *env = getenv("PFFFT_ARCH");
+    if (env) {
+      for (k = 0; k < l; ++k) {
+        if (!strcmp(env, dispatch_arches[k]->id)) {
+          l = k;
+          break;
+        }
+      }
+    }
+    level = l;
+  }
+  return level;
+}
+
+
+SETUP_STRUCT *FUNC_NEW_SETUP(int N, pffft_transform_t transform) {
+  SETUP_STRUCT *s = 0;
+  ARCH_SETUP_STRUCT *as = 0;
+  int level;
+  /* wider SIMD vectors raise the minimum FFT size:
+     fall back to the narrower architectures, when N is too small.
+     only sizes, which no architecture supports natively, take
+     Bluestein's algorithm - on the widest architecture */
+  for (level = dispatch_level(); level >= 0; --level) {
+    if (dispatch_arches[level]->is_valid_size(N, transform))
+      as = dispatch_arches[level]->new_setup(N, transform);
+    if (as)
+      break;
+  }
+  if (!as) {
+    level = dispatch_level();
+    as = dispatch_arches[level]->new_setup(N, transform);
+  }
+  if (!as)
+    return s;
+  s = (SETUP_STRUCT*)malloc(sizeof(SETUP_STRUCT));
+  s->arch = dispatch_arches[level];
+  s->s = as;
+  s->inplace = 0;
+  return s;
+}
+
+SETUP_STRUCT *FUNC_NEW_SETUP_2D(int Nrows, int N, pffft_transform_t transform) {
+  SETUP_STRUCT *s = 0;
+  ARCH_SETUP_STRUCT *as = 0;
+  int level;
+  for (level = dispatch_level(); level >= 0; --level) {
+    as = dispatch_arches[level]->new_setup_2d(Nrows, N, transform);
+    if (as)
+      break;
+  }
+  if (!as)
+    return s;
+  s = (SETUP_STRUCT*)malloc(sizeof(SETUP_STRUCT));
+  s->arch = dispatch_arches[level];
+  s->s = as;
+  s->inplace = 0;
+  return s;
+}
+
+size_t FUNC_SETUP_SIZE(int N, pffft_transform_t transform) {
+  int level;
+  size_t bytes;
+  /* same architecture selection as in FUNC_NEW_SETUP() */
+  for (level = dispatch_level(); level >= 0; --level) {
+    bytes = dispatch_arches[level]->setup_size(N, transform);
+    if (bytes)
+      return DISPATCH_SETUP_HDR_BYTES + bytes;
+  }
+  return 0;
+}
+
+SETUP_STRUCT *FUNC_INIT_SETUP_INPLACE(void *mem, int N, pffft_transform_t transform) {
+  SETUP_STRUCT *s = (SETUP_STRUCT*)mem;
+  ARCH_SETUP_STRUCT *as = 0;
+  int level;
+  if (!mem)
+    return 0;
+  for (level = dispatch_level(); level >= 0; --level) {
+    as = dispatch_arches[level]->init_setup_inplace((char*)mem + DISPATCH_SETUP_HDR_BYTES, N, transform);
+    if (as)
+      break;
+  }
+  if (!as)
+    return 0;
+  s->arch = dispatch_arches[level];
+  s->s = as;
+  s->inplace = 1;
+  return s;
+}
+
+void FUNC_DESTROY(SETUP_STRUCT *s) {
+  if (!s)
+    return;
+  s->arch->destroy(s->s);
+  if (!s->inplace)
+    free(s);
+}
+
+int FUNC_WORK_SIZE(const SETUP_STRUCT *setup) {
+  return setup->arch->work_size(setup->s);
+}
+
+void FUNC_TRANSFORM_UNORDRD(SETUP_STRUCT *setup, const float *input, float *output, float *work, pffft_direction_t direction) {
+  setup->arch->transform(setup->s, input, output, work, direction);
+}
+
+void FUNC_TRANSFORM_ORDERED(SETUP_STRUCT *setup, const float *input, float *output, float *work, pffft_direction_t direction) {
+  setup->arch->transform_ordered(setup->s, input, output, work, direction);
+}
+
+void FUNC_TRANSFORM_BATCH(SETUP_STRUCT *setup, int count, const float *input, int input_stride,
+                          float *output, int output_stride, float *work, pffft_direction_t direction) {
+  setup->arch->transform_batch(setup->s, count, input, input_stride, output, output_stride, work, direction);
+}
+
+void FUNC_TRANSFORM_ORD_BATCH(SETUP_STRUCT *setup, int count, const float *input, int input_stride,
+                              float *output, int output_stride, float *work, pffft_direction_t direction) {
+  setup->arch->transform_ordered_batch(setup->s, count, input, input_stride, output, output_stride, work, direction);
+}
+
+void FUNC_TRANSFORM_PAIR(SETUP_STRUCT *setup, const float *input_a, const float *input_b,
+                         float *output_a, float *output_b, float *work, pffft_direction_t direction) {
+  setup->arch->transform_pair(setup->s, input_a, input_b, output_a, output_b, work, direction);
+}
+
+void FUNC_TRANSFORM_ORD_PAIR(SETUP_STRUCT *setup, const float *input_a, const float *input_b,
+                             float *output_a, float *output_b, float *work, pffft_direction_t direction) {
+  setup->arch->transform_ordered_pair(setup->s, input_a, input_b, output_a, output_b, work, direction);
+}
+
+#if defined(FUNC_TRANSFORM_HALF)
+void FUNC_TRANSFORM_HALF(SETUP_STRUCT *setup, pffft_half_t format, int count, const unsigned short *input, int input_stride,
+                         unsigned short *output, int output_stride, float *work, pffft_direction_t direction) {
+  setup->arch->transform_half(setup->s, format, count, input, input_stride, output, output_stride, work, direction);
+}
+
+void FUNC_TRANSFORM_ORD_HALF(SETUP_STRUCT *setup, pffft_half_t format, int count, const unsigned short *input, int input_stride,
+                             unsigned short *output, int output_stride, float *work, pffft_direction_t direction) {
+  setup->arch->transform_ordered_half(setup->s, format, count, input, input_stride, output, output_stride, work, direction);
+}
+
+/* the conversion of the widest selectable architecture: F16C comes with AVX2 */
+void FUNC_HALF_TO_FLOAT(pffft_half_t format, const unsigned short *input, float *output, int count) {
+  dispatch_arches[dispatch_level()]->half_to_float(format, input, output, count);
+}
+
+void FUNC_FLOAT_TO_HALF(pffft_half_t format, const float *input, unsigned short *output, int count) {
+  dispatch_arches[dispatch_level()]->float_to_half(format, input, output, count);
+}
+#endif
+
+void FUNC_ZREORDER(SETUP_STRUCT *setup, const float *input, float *output, pffft_direction_t direction) {
+  setup->arch->zreorder(setup->s, input, output, direction);
+}
+
+void FUNC_ZPOWER(SETUP_STRUCT *setup, const float *dft, float *power) {
+  setup->arch->zpower(setup->s, dft, power);
+}
+
+void FUNC_ZPOWER_ACCUMULATE(SETUP_STRUCT *setup, const float *dft, float *acc, float scaling) {
+  setup->arch->zpower_accumulate(setup->s, dft, acc, scaling);
+}
+
+void FUNC_ZPOWER_UNPACK(SETUP_STRUCT *setup, const float *acc, float *power) {
+  setup->arch->zpower_unpack(setup->s, acc, power);
+}
+
+void FUNC_ZCONVOLVE_ACCUMULATE(SETUP_STRUCT *setup, const float *dft_a, const float *dft_b, float *dft_ab, float scaling) {
+  setup->arch->zconvolve_accumulate(setup->s, dft_a, dft_b, dft_ab, scaling);
+}
+
+void FUNC_ZCONVOLVE_NO_ACCU(SETUP_STRUCT *setup, const float *dft_a, const float *dft_b, float *dft_ab, float scaling) {
+  setup->arch->zconvolve_no_accu(setup->s, dft_a, dft_b, dft_ab, scaling);
+}
+
+void FUNC_ZCONVOLVE_TRANSFORM_BW(SETUP_STRUCT *setup, const float *dft_a, const float *dft_b, float *output, float *work, float scaling) {
+  setup->arch->zconvolve_transform_bw(setup->s, dft_a, dft_b, output, work, scaling);
+}
+
+void FUNC_ZREAL_PACK(SETUP_STRUCT *setup, const float *dft_b, float *real_b) {
+  setup->arch->zreal_pack(setup->s, dft_b, real_b);
+}
+
+void FUNC_ZCONVOLVE_REAL_ACCUMULATE(SETUP_STRUCT *setup, const float *dft_a, const float *real_b, float *dft_ab, float scaling) {
+  setup->arch->zconvolve_real_accumulate(setup->s, dft_a, real_b, dft_ab, scaling);
+}
+
+void FUNC_ZCONVOLVE_REAL_NO_ACCU(SETUP_STRUCT *setup, const float *dft_a, const float *real_b, float *dft_ab, float scaling) {
+  setup->arch->zconvolve_real_no_accu(setup->s, dft_a, real_b, dft_ab, scaling);
+}
+
+void FUNC_ZBIN_INDEX(SETUP_STRUCT *setup, int *re_offset, int *im_offset, int *packed_offset) {
+  setup->arch->zbin_index(setup->s, re_offset, im_offset, packed_offset);
+}
+
+void FUNC_ZMAGNITUDE(SETUP_STRUCT *setup, const float *dft, float *mag) {
+  setup->arch->zmagnitude(setup->s, dft, mag);
+}
+
+void FUNC_ZPHASE(SETUP_STRUCT *setup, const float *dft, float *phase) {
+  setup->arch->zphase(setup->s, dft, phase);
+}
+
+void FUNC_ZCONJ_MULTIPLY(SETUP_STRUCT *setup, const float *dft_a, const float *dft_b, float *dft_ab, float scaling) {
+  setup->arch->zconj_multiply(setup->s, dft_a, dft_b, dft_ab, scaling);
+}
+
+void FUNC_ZDIVIDE(SETUP_STRUCT *setup, const float *dft_a, const float *dft_b, float *dft_ab, float eps) {
+  setup->arch->zdivide(setup->s, dft_a, dft_b, dft_ab, eps);
+}
+
+void FUNC_ZDELAY(SETUP_STRUCT *setup, const float *dft, float *output, float delay) {
+  setup->arch->zdelay(setup->s, dft, output, delay);
+}
+
+size_t FUNC_SERIALIZED_SIZE(const SETUP_STRUCT *setup) {
+  return setup->arch->serialized_size(setup->s);
+}
+
+size_t FUNC_SERIALIZE(const SETUP_STRUCT *setup, void *blob, size_t blob_size) {
+  return setup->arch->serialize(setup->s, blob, blob_size);
+}
+
+SETUP_STRUCT *FUNC_DESERIALIZE(const void *blob, size_t blob_size, int zero_copy) {
+  SETUP_STRUCT *s = 0;
+  ARCH_SETUP_STRUCT *as = 0;
+  int level;
+  /* the blob fits all architectures with the SIMD width it was created with */
+  for (level = dispatch_level(); level >= 0; --level) {
+    as = dispatch_arches[level]->deserialize(blob, blob_size, zero_copy);
+    if (as)
+      break;
+  }
+  if (!as)
+    return s;
+  s = (SETUP_STRUCT*)malloc(sizeof(SETUP_STRUCT));
+  s->arch = dispatch_arches[level];
+  s->s = as;
+  s->inplace = 0;
+  return s;
+}
+
+int FUNC_GET_INSTR(const SETUP_STRUCT *setup, pffft_instr_snapshot_t *snapshot) {
+  return setup->arch->get_instr(setup->s, snapshot);
+}
+
+void FUNC_RESET_INSTR(SETUP_STRUCT *setup) {
+  setup->arch->reset_instr(setup->s);
+}
+
+/* simd size and architecture of the widest selectable architecture */
+int FUNC_SIMD_SIZE() { return dispatch_arches[dispatch_level()]->simd_size(); }
+
+const char * FUNC_SIMD_ARCH() { return dispatch_arches[dispatch_level()]->simd_arch(); }
+
+/* with the fallback, the valid sizes are those of the narrowest architecture */
+int FUNC_MIN_FFT_SIZE(pffft_transform_t transform) {
+  return dispatch_arches[0]->min_fft_size(transform);
+}
+
+int FUNC_IS_VALID_SIZE(int N, pffft_transform_t cplx) {
+  return dispatch_arches[0]->is_valid_size(N, cplx);
+}
+
+int FUNC_NEAREST_SIZE(int N, pffft_transform_t cplx, int higher) {
+  return dispatch_arches[0]->nearest_size(N, cplx, higher);
+}
+
+void FUNC_VALIDATE_SIMD_A() {
+  int level;
+  for (level = 0; level <= dispatch_level(); ++level)
+    dispatch_arches[level]->validate_simd();
+}
+
+int FUNC_VALIDATE_SIMD_EX(FILE * DbgOut) {
+  int level, numErrs = 0;
+  for (level = 0; level <= dispatch_level(); ++level) {
+    if (DbgOut)
+      fprintf(DbgOut, "validating SIMD architecture '%s':\n", dispatch_arches[level]->id);
+    numErrs += dispatch_arches[level]->validate_simd_ex(DbgOut);
+  }
+  return numErrs;
+}
+
+#endif  /* PFFFT_ARCH_POST */
@@ -64,10 +64,20 @@
 
    - 1D transforms only, with 64-bit double precision.
 
-   - supports only transforms for inputs of length N of the form
-   N=(2^a)*(3^b)*(5^c), a >= 5, b >=0, c >= 0 (32, 48, 64, 96, 128,
-   144, 160, etc are all acceptable lengths). Performance is best for
-   128<=N<=8192.
+   - supports native transforms for inputs of length N of the form
+   N=(2^a)*(3^b)*(5^c)*(7^d)*(11^e)*(13^f), a >= 5, b, c, d, e, f >= 0
+   (32, 48, 64, 96, 128, 144, 160, 224, etc are all acceptable lengths).
+   Performance is best for 128<=N<=8192.
+
+   - other sizes N - complex, or even for real transforms - use
+   Bluestein's algorithm: a convolution with the native complex
+   transform of the next valid size >= 2*N-1 (complex) or N-1 (real).
+   Their spectra are always in the ordered layout - also with
+   pffftd_transform(). Their 'work' needs room for pffftd_work_size()
+   values - more than for native sizes. With work == NULL, they allocate
+   it on the heap for each call and leave the output unchanged, when
+   that fails. Bluestein setups can't be used for 2D transforms, in
+   caller provided memory or for serialization.
 
    - all (double*) pointers in the functions below are expected to
    have an "simd-compatible" alignment, that is 32 bytes on x86 and
@@ -103,6 +113,30 @@ extern "C" {
   /* type of transform */
   typedef enum { PFFFT_REAL, PFFFT_COMPLEX } pffft_transform_t;
 
+#endif
+
+#ifndef PFFFT_COMMON_INSTR
+#define PFFFT_COMMON_INSTR
+
+  /* functions of the optional instrumentation, see pffft_get_instr_snapshot() */
+  typedef enum {
+    PFFFT_INSTR_TRANSFORM = 0,      /* all transforms: samples are count * Nrows * N */
+    PFFFT_INSTR_ZREORDER,           /* zreorder and zpower: samples are Nrows * N */
+    PFFFT_INSTR_ZCONVOLVE,          /* all zconvolve functions: samples are Nrows * N */
+    PFFFT_INSTR_ZCONVOLVE_TRANSFORM_BW, /* fused zconvolve and backward transform: N */
+    PFFFT_INSTR_NUM
+  } pffft_instr_func_t;
+
+  typedef struct {
+    unsigned long long calls;
+    unsigned long long samples;
+    unsigned long long cycles;      /* time stamp counter on x86 - else a timer, see pffft_instr_impl.h */
+  } pffft_instr_counter_t;
+
+  typedef struct {
+    pffft_instr_counter_t func[PFFFT_INSTR_NUM];  /* indexed with pffft_instr_func_t */
+  } pffft_instr_snapshot_t;
+
 #endif
 
   /*
@@ -112,6 +146,110 @@ extern "C" {
   */
   PFFFTD_Setup *pffftd_new_setup(int N, pffft_transform_t transform);
   void pffftd_destroy_setup(PFFFTD_Setup *);
+
+  /*
+    prepare a setup - as pffftd_new_setup() - in caller provided memory,
+    without any allocation, e.g. in real-time threads or in an arena.
+    pffftd_setup_size() delivers the required number of bytes, or 0 for an
+    invalid size N - see pffftd_is_valid_size(). 'mem' has to be 64-byte
+    aligned (a cache line).
+    pffftd_init_setup_inplace() returns the setup, which points to 'mem',
+    or NULL when N or the alignment is not suitable. Just release 'mem'
+    after use: pffftd_destroy_setup() frees nothing for these setups.
+  */
+  size_t pffftd_setup_size(int N, pffft_transform_t transform);
+  PFFFTD_Setup *pffftd_init_setup_inplace(void *mem, int N, pffft_transform_t transform);
+
+  /*
+    prepare for performing 2D transforms of Nrows x N values: Nrows rows
+    of N values each, one row after the other. The same functions as for
+    1D transforms are used with this setup: pffft_transform(),
+    pffft_transform_ordered(), pffft_zreorder() and pffft_zconvolve_*(),
+    which allows fast 2D convolution.
+
+    The rows are transformed with the 1D transform; N has the same
+    restrictions as for pffft_new_setup(). Then the columns are transformed
+    with a complex transform of length Nrows, which needs to be a product
+    of 2, 3, 5, 7, 11 and 13 - and even for real transforms. N needs to be
+    a valid size, see pffftd_is_valid_size(): there are no 2D transforms with
+    Bluestein's algorithm. Without SIMD, where the minimum sizes are 1 and
+    2, N needs to be at least 2.
+
+    The ordered output of a real transform has Nrows rows with N/2 complex
+    values, as the 1D spectrum of each row. Entry k of row r is the
+    frequency (r, k) for k >= 1. The first entry of a row (r, 0) holds
+    - the real (0, 0) and (0, N/2) frequencies in row 0, and the real
+      (Nrows/2, 0) and (Nrows/2, N/2) in row Nrows/2,
+    - frequency (r, 0) for 0 < r < Nrows/2,
+    - frequency (r, N/2) for Nrows/2 < r.
+    The other frequencies follow from the symmetry of real input.
+
+    'work' needs room for 2 * Nrows * N doubles, for both, real
+    and complex transforms.
+  */
+  PFFFTD_Setup *pffftd_new_setup_2d(int Nrows, int N, pffft_transform_t transform);
+
+  /*
+    cache of shared setups: pffftd_acquire_setup() delivers the same
+    setup for repeated requests of (N, transform), without computing the
+    twiddle factors again. Each call increments a reference count and
+    needs a matching pffftd_release_setup() - never use pffftd_destroy_setup()
+    on these setups. Returns NULL, like pffftd_new_setup(), for invalid sizes.
+
+    The cache is thread-safe, and the setups are read-only: one setup can
+    be used by multiple threads at the same time.
+
+    Released setups stay in the cache, until the (approximate) memory of
+    all cached setups exceeds the limit, which is unlimited by default.
+    Then the least recently used unreferenced setups are destroyed.
+    pffftd_clear_setup_cache() destroys all unreferenced setups.
+    pffftd_setup_cache_bytes() retrieves the current memory usage.
+  */
+  PFFFTD_Setup *pffftd_acquire_setup(int N, pffft_transform_t transform);
+  void pffftd_release_setup(PFFFTD_Setup *setup);
+  void pffftd_set_setup_cache_limit(size_t max_bytes);
+  size_t pffftd_setup_cache_bytes(void);
+  void pffftd_clear_setup_cache(void);
+
+  /*
+    serialize a (1D or 2D) setup into a flat blob, which allows to skip
+    the computation of the twiddle factors, e.g. at startup, by loading
+    precomputed setups from a file.
+
+    pffftd_serialized_size() delivers the size of the blob in bytes - or 0
+    for setups with Bluestein's algorithm, which can't be serialized.
+    pffftd_serialize_setup() writes the blob - returning the number of bytes
+    written, or 0 when blob_size is too small.
+
+    pffftd_deserialize_setup() creates a setup from the blob. It returns NULL
+    for blobs of another version, another precision, another SIMD width
+    (see pffftd_simd_size()) or another byte order - or when blob_size is too
+    small. A deserialized setup is destroyed with pffftd_destroy_setup().
+
+    With zero_copy != 0, the setup references the twiddle factors in the blob:
+    this blob needs to be "simd-compatible" aligned (64 bytes, e.g. from
+    pffftd_aligned_malloc() or a memory mapped file), must not be modified
+    and has to stay valid until the setup is destroyed. This way, multiple
+    processes can share one read-only mapping of a file with setups.
+  */
+  size_t pffftd_serialized_size(const PFFFTD_Setup *setup);
+  size_t pffftd_serialize_setup(const PFFFTD_Setup *setup, void *blob, size_t blob_size);
+  PFFFTD_Setup *pffftd_deserialize_setup(const void *blob, size_t blob_size, int zero_copy);
+
+  /*
+    optional instrumentation of the hot paths - compiled in with
+    PFFFT_ENABLE_INSTRUMENTATION (CMake option PFFFT_USE_INSTRUMENTATION).
+    each setup counts calls, processed samples and cycles of the transforms,
+    pffft_zreorder() and the pffft_zconvolve_*() functions with atomic
+    additions. without the option, the hot paths are unchanged.
+
+    pffftd_get_instr_snapshot() copies the counters of the setup - for export
+    into a metrics system. it returns 0 and zeros the snapshot, when the
+    instrumentation is not compiled in. pffftd_reset_instr() clears the counters.
+    a Bluestein setup counts the calls to itself, not to its internal transforms.
+  */
+  int pffftd_get_instr_snapshot(const PFFFTD_Setup *setup, pffft_instr_snapshot_t *snapshot);
+  void pffftd_reset_instr(PFFFTD_Setup *setup);
   /* 
      Perform a Fourier transform , The z-domain data is stored in the
      most efficient order for transforming it back, or using it for
@@ -124,11 +262,12 @@ extern "C" {
      Typically you will want to scale the backward transform by 1/N.
      
      The 'work' pointer should point to an area of N (2*N for complex
-     fft) doubles, properly aligned. If 'work' is NULL, then stack will
+     fft) doubles, properly aligned - more for Bluestein's sizes, see above. If 'work' is NULL, then stack will
      be used instead (this is probably the best strategy for small
      FFTs, say for N < 16384). Threads usually have a small stack, that
      there's no sufficient amount of memory, usually leading to a crash!
      Use the heap with pffft_aligned_malloc() in this case.
+     pffftd_work_size() delivers the required size.
 
      input and output may alias.
   */
@@ -143,6 +282,66 @@ extern "C" {
   */
   void pffftd_transform_ordered(PFFFTD_Setup *setup, const double *input, double *output, double *work, pffft_direction_t direction);
 
+  /*
+     number of doubles, which 'work' of pffftd_transform() and
+     pffftd_transform_ordered() needs for this setup: N (2*N for complex
+     transforms) - or 2 * Nrows * N for 2D transforms. setups with
+     Bluestein's algorithm need more: 6 * M + 2 * L, with the length L of
+     their chirp-z transform and the native size M of its convolution.
+     this is also enough for the batch functions and
+     pffftd_zconvolve_transform_backward().
+     allows to size pooled scratch memory for many concurrent transforms.
+  */
+  int pffftd_work_size(const PFFFTD_Setup *setup);
+
+  /*
+     Perform 'count' transforms of the same setup with one call, e.g. for
+     multiple channels. Transform c reads input + c*input_stride and writes
+     output + c*output_stride; the strides are given in number of doubles and
+     have to keep the "simd-compatible" alignment of each transform.
+     The passes of small transforms are interleaved, that the twiddle
+     factors of each pass are loaded once for a group of transforms.
+
+     'work' is used as in pffftd_transform(), needing room for one single
+     transform, and may be NULL. For the interleaved groups a small amount
+     of stack memory is used in any case.
+
+     input and output may alias - if input_stride == output_stride.
+  */
+  void pffftd_transform_batch(PFFFTD_Setup *setup, int count, const double *input, int input_stride,
+                              double *output, int output_stride, double *work, pffft_direction_t direction);
+
+  /*
+     Similar to pffftd_transform_batch, but with ordered output,
+     see pffftd_transform_ordered()
+  */
+  void pffftd_transform_ordered_batch(PFFFTD_Setup *setup, int count, const double *input, int input_stride,
+                                      double *output, int output_stride, double *work, pffft_direction_t direction);
+
+  /*
+     Transform two signals of the same setup with one call, e.g. the left
+     and right channel of a stereo signal - or I and Q: transform a reads
+     input_a and writes output_a, transform b likewise. The spectra have
+     the layout of pffftd_transform() (pffftd_transform_ordered()), that
+     pffftd_zreorder() and pffftd_zconvolve_*() work on each of them.
+
+     This is pffftd_transform_batch() with count = 2, where the signals
+     don't need a common stride. Packing two real signals into one complex
+     transform of length N ("two for one") is not used: a real transform
+     already costs about half of a complex transform of the same length,
+     and a complex transform of length N with the separation of the
+     spectra measured 1.2 to 2.5 times slower than two real transforms.
+
+     'work' is used as in pffftd_transform(). input_a and output_a may alias,
+     input_b and output_b as well.
+  */
+  void pffftd_transform_pair(PFFFTD_Setup *setup, const double *input_a, const double *input_b,
+                             double *output_a, double *output_b, double *work, pffft_direction_t direction);
+
+  /* same as pffftd_transform_pair(), with the ordered spectra of pffftd_transform_ordered() */
+  void pffftd_transform_ordered_pair(PFFFTD_Setup *setup, const double *input_a, const double *input_b,
+                                     double *output_a, double *output_b, double *work, pffft_direction_t direction);
+
   /* 
      call pffft_zreorder(.., PFFFT_FORWARD) after pffft_transform(...,
      PFFFT_FORWARD) if you want to have the frequency components in
@@ -157,6 +356,13 @@ extern "C" {
   */
   void pffftd_zreorder(PFFFTD_Setup *setup, const double *input, double *output, pffft_direction_t direction);
 
+  /* power spectrum of the unordered forward transform, see pffft_zpower() in pffft.h */
+  void pffftd_zpower(PFFFTD_Setup *setup, const double *dft, double *power);
+
+  /* averaged power spectra in an internal layout, see pffft_zpower_accumulate() in pffft.h */
+  void pffftd_zpower_accumulate(PFFFTD_Setup *setup, const double *dft, double *acc, double scaling);
+  void pffftd_zpower_unpack(PFFFTD_Setup *setup, const double *acc, double *power);
+
   /* 
      Perform a multiplication of the frequency components of dft_a and
      dft_b and accumulate them into dft_ab. The arrays should have
@@ -185,7 +391,29 @@ extern "C" {
   */
   void pffftd_zconvolve_no_accu(PFFFTD_Setup *setup, const double *dft_a, const double *dft_b, double*dft_ab, double scaling);
 
-  /* return 4 or 1 wether support AVX instructions was enabled when building pffft-double.c */
+  /* pffftd_zconvolve_no_accu() and the backward pffftd_transform() in one pass
+     over the spectra, see pffft_zconvolve_transform_backward() in pffft.h */
+  void pffftd_zconvolve_transform_backward(PFFFTD_Setup *setup, const double *dft_a, const double *dft_b, double *output, double *work, double scaling);
+
+  /*
+     packed real valued spectra, see pffft_zreal_pack() in pffft.h:
+     real_b[] needs N/2 + pffftd_simd_size() doubles for real transforms
+     - or N + pffftd_simd_size() for complex ones.
+  */
+  void pffftd_zreal_pack(PFFFTD_Setup *setup, const double *dft_b, double *real_b);
+  void pffftd_zconvolve_real_accumulate(PFFFTD_Setup *setup, const double *dft_a, const double *real_b, double *dft_ab, double scaling);
+  void pffftd_zconvolve_real_no_accu(PFFFTD_Setup *setup, const double *dft_a, const double *real_b, double *dft_ab, double scaling);
+
+  /* spectral operations on the unordered layout, see pffft_zbin_index() .. pffft_zdelay() in pffft.h */
+  void pffftd_zbin_index(PFFFTD_Setup *setup, int *re_offset, int *im_offset, int *packed_offset);
+  void pffftd_zmagnitude(PFFFTD_Setup *setup, const double *dft, double *mag);
+  void pffftd_zphase(PFFFTD_Setup *setup, const double *dft, double *phase);
+  void pffftd_zconj_multiply(PFFFTD_Setup *setup, const double *dft_a, const double *dft_b, double *dft_ab, double scaling);
+  void pffftd_zdivide(PFFFTD_Setup *setup, const double *dft_a, const double *dft_b, double *dft_ab, double eps);
+  void pffftd_zdelay(PFFFTD_Setup *setup, const double *dft, double *output, double delay);
+
+  /* return 8, 4, 2 or 1 wether support AVX-512/AVX/SSE2/NEON instructions was enabled when building pffft-double.c
+     - with the runtime dispatch, this is for the widest selectable architecture */
   int pffftd_simd_size();
 
   /* return string identifier of used architecture (AVX/..) */
@@ -195,12 +423,14 @@ extern "C" {
   int pffftd_min_fft_size(pffft_transform_t transform);
 
   /* simple helper to determine size N is valid
-     - factorizable to pffft_min_fft_size() with factors 2, 3, 5
+     - factorizable to pffft_min_fft_size() with factors 2, 3, 5, 7, 11, 13:
+       the sizes with native transforms, others use Bluestein's algorithm.
+       N = 1 is never native - also not without SIMD, where the minimum is 1
   */
   int pffftd_is_valid_size(int N, pffft_transform_t cplx);
 
   /* determine nearest valid transform size  (by brute-force testing)
-     - factorizable to pffft_min_fft_size() with factors 2, 3, 5.
+     - factorizable to pffft_min_fft_size() with factors 2, 3, 5, 7, 11, 13.
      higher: bool-flag to find nearest higher value; else lower.
   */
   int pffftd_nearest_transform_size(int N, pffft_transform_t cplx, int higher);
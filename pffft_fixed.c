@@ -0,0 +1,286 @@
+/*
+   PFFFT_FIXED : block floating point FFT on 16-bit (Q15) and 32-bit (Q31)
+   integer samples - see pffft_fixed.h
+
+   the unordered layout is the bit reversed order of a radix-2 transform:
+   the forward transform decimates in frequency (natural order in, bit
+   reversed out), the backward transform decimates in time (bit reversed
+   in, natural order out). no reordering is needed in between, e.g. for
+   convolution. a real transform of length N is a complex transform of
+   the N/2 even/odd sample pairs, followed (or preceded) by a split step,
+   which works on the bit reversed positions.
+*/
+
+#include "pffft_fixed.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if !defined(PFFFT_SIMD_DISABLE) && ( defined(__ARM_NEON) || defined(__ARM_NEON__) )
+#  include <arm_neon.h>
+#  define FIXED_NEON  1
+#else
+#  define FIXED_NEON  0
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+struct PFFFT_Fixed_Setup
+{
+  int N;
+  pffft_transform_t transform;
+  int M;                /* length of the complex transform: N or N/2 */
+  int *rev;             /* bit reversal of 0 .. M-1 */
+
+  /* twiddle factors W_2h^i of the stage with butterfly distance h:
+     h real parts, then h imaginary parts - at offset 2 * (h - 1) */
+  int16_t *tw15;
+  int32_t *tw31;
+
+  /* (real only) bit reversed positions p, q of k and M-k, for 0 < k <= M/2,
+     and the interleaved twiddle factors W_N^k */
+  int num_split;
+  int *split_pos;
+  int16_t *split15;
+  int32_t *split31;
+};
+
+
+static int fixed_bitlen(uint64_t m)
+{
+  int b = 0;
+  while (m) {
+    ++b;
+    m >>= 1;
+  }
+  return b;
+}
+
+static int fixed_log2(int n)
+{
+  int b = 0;
+  while ( (1 << b) < n )
+    ++b;
+  return ( (1 << b) == n ) ? b : -1;
+}
+
+static int16_t fixed_q15(double v)
+{
+  return (int16_t)floor( v * 32767.0 + 0.5 );
+}
+
+static int32_t fixed_q31(double v)
+{
+  return (int32_t)floor( v * 2147483647.0 + 0.5 );
+}
+
+
+int pffft_fixed_is_valid_size(int N, pffft_transform_t transform)
+{
+  const int M = (transform == PFFFT_REAL) ? N / 2 : N;
+  return ( N > 0 && M >= 2 && fixed_log2(N) >= 0 ) ? 1 : 0;
+}
+
+
+PFFFT_Fixed_Setup *pffft_fixed_new_setup(int N, pffft_transform_t transform)
+{
+  PFFFT_Fixed_Setup *s;
+  int M, bits, p, h, i, k;
+
+  if (!pffft_fixed_is_valid_size(N, transform))
+    return NULL;
+  s = (PFFFT_Fixed_Setup*)calloc(1, sizeof(PFFFT_Fixed_Setup));
+  if (!s)
+    return NULL;
+  M = (transform == PFFFT_REAL) ? N / 2 : N;
+  bits = fixed_log2(M);
+  s->N = N;
+  s->transform = transform;
+  s->M = M;
+  s->rev = (int*)malloc((size_t)M * sizeof(int));
+  s->tw15 = (int16_t*)malloc(2 * (size_t)M * sizeof(int16_t));
+  s->tw31 = (int32_t*)malloc(2 * (size_t)M * sizeof(int32_t));
+  if (!s->rev || !s->tw15 || !s->tw31) {
+    pffft_fixed_destroy_setup(s);
+    return NULL;
+  }
+
+  for (p = 0; p < M; ++p) {
+    int r = 0;
+    for (i = 0; i < bits; ++i)
+      r |= ( (p >> i) & 1 ) << (bits - 1 - i);
+    s->rev[p] = r;
+  }
+
+  for (h = 1; h < M; h *= 2) {
+    for (i = 0; i < h; ++i) {
+      const double phi = -M_PI * i / h;
+      s->tw15[2 * (h - 1) + i] = fixed_q15(cos(phi));
+      s->tw15[2 * (h - 1) + h + i] = fixed_q15(sin(phi));
+      s->tw31[2 * (h - 1) + i] = fixed_q31(cos(phi));
+      s->tw31[2 * (h - 1) + h + i] = fixed_q31(sin(phi));
+    }
+  }
+
+  if (transform == PFFFT_REAL) {
+    s->split_pos = (int*)malloc((size_t)M * sizeof(int));
+    s->split15 = (int16_t*)malloc((size_t)M * sizeof(int16_t));
+    s->split31 = (int32_t*)malloc((size_t)M * sizeof(int32_t));
+    if (!s->split_pos || !s->split15 || !s->split31) {
+      pffft_fixed_destroy_setup(s);
+      return NULL;
+    }
+    /* in the order of the positions p - for the locality of the half of the accesses */
+    for (p = 1; p < M; ++p) {
+      k = s->rev[p];
+      if (k <= M / 2) {
+        const double phi = -2.0 * M_PI * k / N;
+        const int j = s->num_split++;
+        s->split_pos[2 * j] = p;
+        s->split_pos[2 * j + 1] = s->rev[M - k];
+        s->split15[2 * j] = fixed_q15(cos(phi));
+        s->split15[2 * j + 1] = fixed_q15(sin(phi));
+        s->split31[2 * j] = fixed_q31(cos(phi));
+        s->split31[2 * j + 1] = fixed_q31(sin(phi));
+      }
+    }
+  }
+  return s;
+}
+
+
+void pffft_fixed_destroy_setup(PFFFT_Fixed_Setup *s)
+{
+  if (!s)
+    return;
+  free(s->rev);
+  free(s->tw15);
+  free(s->tw31);
+  free(s->split_pos);
+  free(s->split15);
+  free(s->split31);
+  free(s);
+}
+
+
+const char *pffft_fixed_simd_arch(void)
+{
+  return FIXED_NEON ? "NEON" : "scalar";
+}
+
+
+/* Q15: 16-bit samples with 32-bit intermediates */
+#define SAMPLE        int16_t
+#define ACC           int32_t
+#define ACC_BITS      32
+#define FRAC          15
+#define FIXED_Q(f)    f##_q15
+#define TW(s)         ((s)->tw15)
+#define SPLIT_TW(s)   ((s)->split15)
+#if FIXED_NEON
+#  define V           int16x8_t
+#  define VX2         int16x8x2_t
+#  define VLANES      8
+#  define VLD1        vld1q_s16
+#  define VST1        vst1q_s16
+#  define VLD2        vld2q_s16
+#  define VST2        vst2q_s16
+#  define VDUP        vdupq_n_s16
+#  define VRSHL       vrshlq_s16
+#  define VQADD       vqaddq_s16
+#  define VQSUB       vqsubq_s16
+#  define VQRDMULH    vqrdmulhq_s16
+#  define VEOR        veorq_s16
+#  define VORR        vorrq_s16
+#  define VSHR_SIGN(v)  vshrq_n_s16((v), 15)
+#  define VACC        int32x4_t
+#  define VDUP_ACC    vdupq_n_s32
+#  define VGETLO      vget_low_s16
+#  define VGETHI      vget_high_s16
+#  define VMULL       vmull_s16
+#  define VMLAL       vmlal_s16
+#  define VMLSL       vmlsl_s16
+#  define VRSHL_ACC   vrshlq_s32
+#  define VQMOVN      vqmovn_s32
+#  define VCOMBINE    vcombine_s16
+#endif
+
+#include "pffft_fixed_priv_impl.h"
+
+#undef SAMPLE
+#undef ACC
+#undef ACC_BITS
+#undef FRAC
+#undef FIXED_Q
+#undef TW
+#undef SPLIT_TW
+#if FIXED_NEON
+#  undef V
+#  undef VX2
+#  undef VLANES
+#  undef VLD1
+#  undef VST1
+#  undef VLD2
+#  undef VST2
+#  undef VDUP
+#  undef VRSHL
+#  undef VQADD
+#  undef VQSUB
+#  undef VQRDMULH
+#  undef VEOR
+#  undef VORR
+#  undef VSHR_SIGN
+#  undef VACC
+#  undef VDUP_ACC
+#  undef VGETLO
+#  undef VGETHI
+#  undef VMULL
+#  undef VMLAL
+#  undef VMLSL
+#  undef VRSHL_ACC
+#  undef VQMOVN
+#  undef VCOMBINE
+#endif
+
+
+/* Q31: 32-bit samples with 64-bit intermediates */
+#define SAMPLE        int32_t
+#define ACC           int64_t
+#define ACC_BITS      64
+#define FRAC          31
+#define FIXED_Q(f)    f##_q31
+#define TW(s)         ((s)->tw31)
+#define SPLIT_TW(s)   ((s)->split31)
+#if FIXED_NEON
+#  define V           int32x4_t
+#  define VX2         int32x4x2_t
+#  define VLANES      4
+#  define VLD1        vld1q_s32
+#  define VST1        vst1q_s32
+#  define VLD2        vld2q_s32
+#  define VST2        vst2q_s32
+#  define VDUP        vdupq_n_s32
+#  define VRSHL       vrshlq_s32
+#  define VQADD       vqaddq_s32
+#  define VQSUB       vqsubq_s32
+#  define VQRDMULH    vqrdmulhq_s32
+#  define VEOR        veorq_s32
+#  define VORR        vorrq_s32
+#  define VSHR_SIGN(v)  vshrq_n_s32((v), 31)
+#  define VACC        int64x2_t
+#  define VDUP_ACC    vdupq_n_s64
+#  define VGETLO      vget_low_s32
+#  define VGETHI      vget_high_s32
+#  define VMULL       vmull_s32
+#  define VMLAL       vmlal_s32
+#  define VMLSL       vmlsl_s32
+#  define VRSHL_ACC   vrshlq_s64
+#  define VQMOVN      vqmovn_s64
+#  define VCOMBINE    vcombine_s32
+#endif
+
+#include "pffft_fixed_priv_impl.h"
@@ -0,0 +1,104 @@
+/*
+   PFFFT_FIXED : block floating point FFT on 16-bit (Q15) and 32-bit (Q31)
+   integer samples
+
+   For receivers, which work on integer ADC samples, and where the conversion
+   to float would double the memory bandwidth. The transforms are radix-2 with
+   block floating point: each stage checks the magnitude of its input block
+   and shifts all values by a common exponent, that the butterflies can't
+   overflow - and small signals are shifted up to keep the precision. All
+   transforms and zconvolve() return this exponent: the (unscaled) result of
+   pffft_transform() is 'output * 2^exponent'. Keep track of it, when chaining
+   several operations, e.g. forward transforms, zconvolve() and the backward
+   transform for a fast convolution:
+
+     ea = pffft_fixed_transform_q15(s, a, A, PFFFT_FORWARD);
+     eb = pffft_fixed_transform_q15(s, b, B, PFFFT_FORWARD);
+     e = pffft_fixed_zconvolve_q15(s, A, ea, B, eb, AB);
+     e += pffft_fixed_transform_q15(s, AB, ab, PFFFT_BACKWARD);
+     e -= log2(N);    => the circular convolution is 'ab * 2^e'
+
+   There's the same distinction of ordered and unordered ('internal') layout
+   as with pffft: pffft_fixed_transform_q15() leaves the frequency components
+   in bit reversed order, which pffft_fixed_zconvolve_q15() and the backward
+   transform can use directly. pffft_fixed_transform_ordered_q15() delivers
+   the same order and format as pffft_transform_ordered(), e.g. for a real
+   transform: X0, X[N/2], Re(X1), Im(X1), Re(X2), ..
+
+   With NEON, the stages use the saturating arithmetic - else it's portable C.
+
+   Restrictions:
+
+   - N has to be a power of 2: N >= 2 for complex, N >= 4 for real transforms.
+
+   - the precision is limited by the integer type and grows with log2(N):
+   for N = 4096, the relative (rms) error is around 1E-3 with Q15 and
+   2E-8 with Q31 - for small signals, too.
+
+   - interleaved complex samples (re, im), no alignment requirements. input
+   and output may alias, no work memory is needed.
+*/
+
+#ifndef PFFFT_FIXED_H
+#define PFFFT_FIXED_H
+
+#include <stdint.h>
+#include "pffft.h"  /* for pffft_direction_t and pffft_transform_t */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /* opaque struct holding the twiddle factors and the bit reversal.
+     this struct can be shared by many threads as it contains only
+     read-only data.
+  */
+  typedef struct PFFFT_Fixed_Setup PFFFT_Fixed_Setup;
+
+  /* check if N is a supported size: power of 2, N >= 2 (complex) or N >= 4 (real) */
+  int pffft_fixed_is_valid_size(int N, pffft_transform_t transform);
+
+  /* prepare a transform of length N. returns NULL if N is not supported */
+  PFFFT_Fixed_Setup *pffft_fixed_new_setup(int N, pffft_transform_t transform);
+
+  void pffft_fixed_destroy_setup(PFFFT_Fixed_Setup *setup);
+
+  /*
+     transform of N real or N complex (2*N interleaved integers) samples.
+     the forward transform delivers the frequency components in the
+     unordered layout, which the backward transform expects.
+     returns the exponent: 'output * 2^exponent' is the unscaled result,
+     as with pffft_transform(), forward and backward.
+  */
+  int pffft_fixed_transform_q15(PFFFT_Fixed_Setup *setup, const int16_t *input, int16_t *output, pffft_direction_t direction);
+  int pffft_fixed_transform_q31(PFFFT_Fixed_Setup *setup, const int32_t *input, int32_t *output, pffft_direction_t direction);
+
+  /* same as above, with the frequency components in the order of pffft_transform_ordered() */
+  int pffft_fixed_transform_ordered_q15(PFFFT_Fixed_Setup *setup, const int16_t *input, int16_t *output, pffft_direction_t direction);
+  int pffft_fixed_transform_ordered_q31(PFFFT_Fixed_Setup *setup, const int32_t *input, int32_t *output, pffft_direction_t direction);
+
+  /* reorder between unordered and ordered layout - in both directions. input and output may alias */
+  void pffft_fixed_zreorder_q15(PFFFT_Fixed_Setup *setup, const int16_t *input, int16_t *output, pffft_direction_t direction);
+  void pffft_fixed_zreorder_q31(PFFFT_Fixed_Setup *setup, const int32_t *input, int32_t *output, pffft_direction_t direction);
+
+  /*
+     multiply the unordered spectra of forward transforms - with their
+     exponents exp_a and exp_b. ab may alias a or b.
+     returns the exponent of ab: the block is shifted to use the full
+     range, with one bit headroom.
+     in contrast to pffft_zconvolve_accumulate(), there is no accumulation:
+     the exponents of ab and of the product could differ.
+  */
+  int pffft_fixed_zconvolve_q15(PFFFT_Fixed_Setup *setup, const int16_t *dft_a, int exp_a,
+                                const int16_t *dft_b, int exp_b, int16_t *dft_ab);
+  int pffft_fixed_zconvolve_q31(PFFFT_Fixed_Setup *setup, const int32_t *dft_a, int exp_a,
+                                const int32_t *dft_b, int exp_b, int32_t *dft_ab);
+
+  /* returns "NEON" or "scalar" */
+  const char *pffft_fixed_simd_arch(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PFFFT_FIXED_H */
@@ -0,0 +1,396 @@
+/*
+   template for pffft_fixed.c - compiled once for Q15 and once for Q31 with
+   the macros:
+
+   SAMPLE        int16_t / int32_t
+   ACC           int32_t / int64_t: intermediate values, products
+   ACC_BITS      32 / 64
+   FRAC          15 / 31: fractional bits of the twiddle factors
+   FIXED_Q(f)    appends the suffix _q15 / _q31
+   TW(s)         twiddle factors of the stages
+   SPLIT_TW(s)   twiddle factors of the real split step
+
+   and with FIXED_NEON, the vector types and intrinsics V*.
+
+   block floating point: each stage starts with a shift of its input by
+   2^-k, which brings the block's magnitude to at most 2^(FRAC-2). then
+   the radix-2 butterflies can't overflow: their outputs stay below
+   2.83 * 2^(FRAC-2). the exponents k of all stages add up to the exponent
+   of the transform. the stages return the ORed magnitudes of their output
+   to the next stage - no separate pass over the data.
+*/
+
+/* normalize x by 2^-k with nmul, nrnd and nsh from norm_params() */
+#define NORM(x)     ( ( (ACC)(x) * nmul + nrnd ) >> nsh )
+/* one's complement magnitude: |v| <= ONES(v) + 1 */
+#define ONES(v)     ( (v) ^ ( (v) >> (ACC_BITS - 1) ) )
+#define QRND        ( (ACC)1 << (FRAC - 1) )
+#define QONE        ( (ACC)1 << FRAC )
+
+#if FIXED_NEON
+#define VONES(v)    VEOR( (v), VSHR_SIGN(v) )
+#endif
+
+
+static void FIXED_Q(norm_params)(int k, ACC *mul, ACC *rnd, int *sh)
+{
+  *mul = (k < 0) ? ( (ACC)1 << -k ) : 1;
+  *rnd = (k > 0) ? ( (ACC)1 << (k - 1) ) : 0;
+  *sh = (k > 0) ? k : 0;
+}
+
+/* exponent k for a block with the ORed magnitudes m */
+static int FIXED_Q(mask_exp)(ACC m)
+{
+  return fixed_bitlen( (uint64_t)m ) - (FRAC - 2);
+}
+
+#if FIXED_NEON
+static ACC FIXED_Q(vmask_reduce)(V vm)
+{
+  SAMPLE t[VLANES];
+  ACC m = 0;
+  int j;
+  VST1(t, vm);
+  for (j = 0; j < VLANES; ++j)
+    m |= t[j];
+  return m;
+}
+#endif
+
+static ACC FIXED_Q(mask)(const SAMPLE *x, int n)
+{
+  ACC m = 0;
+  int i = 0;
+#if FIXED_NEON
+  V vm = VDUP(0);
+  for (; i + VLANES <= n; i += VLANES) {
+    const V v = VLD1(x + i);
+    vm = VORR(vm, VONES(v));
+  }
+  m = FIXED_Q(vmask_reduce)(vm);
+#endif
+  for (; i < n; ++i) {
+    const ACC v = x[i];
+    m |= ONES(v);
+  }
+  return m;
+}
+
+
+/* one stage of the forward transform (decimation in frequency) with the
+   butterfly distance h: natural order in, bit reversed order out */
+static ACC FIXED_Q(stage_fwd)(const SAMPLE *in, SAMPLE *out, int M, int h, const SAMPLE *tw, int k)
+{
+  const SAMPLE *twr = tw, *twi = tw + h;
+  ACC nmul, nrnd, omask = 0;
+  int nsh, j0, i;
+  FIXED_Q(norm_params)(k, &nmul, &nrnd, &nsh);
+
+#if FIXED_NEON
+  if (h >= VLANES) {
+    const V sh = VDUP( (SAMPLE)(-k) );
+    V vm = VDUP(0);
+    for (j0 = 0; j0 < M; j0 += 2 * h) {
+      for (i = 0; i < h; i += VLANES) {
+        VX2 a = VLD2(in + 2 * (j0 + i)), b = VLD2(in + 2 * (j0 + i + h)), u, t;
+        const V wr = VLD1(twr + i), wi = VLD1(twi + i);
+        V dr, di;
+        a.val[0] = VRSHL(a.val[0], sh);  a.val[1] = VRSHL(a.val[1], sh);
+        b.val[0] = VRSHL(b.val[0], sh);  b.val[1] = VRSHL(b.val[1], sh);
+        u.val[0] = VQADD(a.val[0], b.val[0]);
+        u.val[1] = VQADD(a.val[1], b.val[1]);
+        dr = VQSUB(a.val[0], b.val[0]);
+        di = VQSUB(a.val[1], b.val[1]);
+        t.val[0] = VQSUB( VQRDMULH(dr, wr), VQRDMULH(di, wi) );
+        t.val[1] = VQADD( VQRDMULH(dr, wi), VQRDMULH(di, wr) );
+        VST2(out + 2 * (j0 + i), u);
+        VST2(out + 2 * (j0 + i + h), t);
+        vm = VORR( vm, VORR( VORR(VONES(u.val[0]), VONES(u.val[1])), VORR(VONES(t.val[0]), VONES(t.val[1])) ) );
+      }
+    }
+    return FIXED_Q(vmask_reduce)(vm);
+  }
+#endif
+
+  for (j0 = 0; j0 < M; j0 += 2 * h) {
+    for (i = 0; i < h; ++i) {
+      const SAMPLE *pa = in + 2 * (j0 + i), *pb = pa + 2 * h;
+      SAMPLE *qa = out + 2 * (j0 + i), *qb = qa + 2 * h;
+      const ACC ar = NORM(pa[0]), ai = NORM(pa[1]), br = NORM(pb[0]), bi = NORM(pb[1]);
+      const ACC wr = twr[i], wi = twi[i];
+      const ACC dr = ar - br, di = ai - bi;
+      const ACC ur = ar + br, ui = ai + bi;
+      const ACC tr = ( dr * wr - di * wi + QRND ) >> FRAC;
+      const ACC ti = ( dr * wi + di * wr + QRND ) >> FRAC;
+      qa[0] = (SAMPLE)ur;  qa[1] = (SAMPLE)ui;
+      qb[0] = (SAMPLE)tr;  qb[1] = (SAMPLE)ti;
+      omask |= ONES(ur) | ONES(ui) | ONES(tr) | ONES(ti);
+    }
+  }
+  return omask;
+}
+
+
+/* one stage of the backward transform (decimation in time) with the
+   butterfly distance h: bit reversed order in, natural order out */
+static ACC FIXED_Q(stage_bwd)(const SAMPLE *in, SAMPLE *out, int M, int h, const SAMPLE *tw, int k)
+{
+  const SAMPLE *twr = tw, *twi = tw + h;
+  ACC nmul, nrnd, omask = 0;
+  int nsh, j0, i;
+  FIXED_Q(norm_params)(k, &nmul, &nrnd, &nsh);
+
+#if FIXED_NEON
+  if (h >= VLANES) {
+    const V sh = VDUP( (SAMPLE)(-k) );
+    V vm = VDUP(0);
+    for (j0 = 0; j0 < M; j0 += 2 * h) {
+      for (i = 0; i < h; i += VLANES) {
+        VX2 a = VLD2(in + 2 * (j0 + i)), b = VLD2(in + 2 * (j0 + i + h)), u, t;
+        const V wr = VLD1(twr + i), wi = VLD1(twi + i);
+        V cr, ci;
+        a.val[0] = VRSHL(a.val[0], sh);  a.val[1] = VRSHL(a.val[1], sh);
+        b.val[0] = VRSHL(b.val[0], sh);  b.val[1] = VRSHL(b.val[1], sh);
+        cr = VQADD( VQRDMULH(b.val[0], wr), VQRDMULH(b.val[1], wi) );
+        ci = VQSUB( VQRDMULH(b.val[1], wr), VQRDMULH(b.val[0], wi) );
+        u.val[0] = VQADD(a.val[0], cr);
+        u.val[1] = VQADD(a.val[1], ci);
+        t.val[0] = VQSUB(a.val[0], cr);
+        t.val[1] = VQSUB(a.val[1], ci);
+        VST2(out + 2 * (j0 + i), u);
+        VST2(out + 2 * (j0 + i + h), t);
+        vm = VORR( vm, VORR( VORR(VONES(u.val[0]), VONES(u.val[1])), VORR(VONES(t.val[0]), VONES(t.val[1])) ) );
+      }
+    }
+    return FIXED_Q(vmask_reduce)(vm);
+  }
+#endif
+
+  for (j0 = 0; j0 < M; j0 += 2 * h) {
+    for (i = 0; i < h; ++i) {
+      const SAMPLE *pa = in + 2 * (j0 + i), *pb = pa + 2 * h;
+      SAMPLE *qa = out + 2 * (j0 + i), *qb = qa + 2 * h;
+      const ACC ar = NORM(pa[0]), ai = NORM(pa[1]), br = NORM(pb[0]), bi = NORM(pb[1]);
+      const ACC wr = twr[i], wi = twi[i];
+      /* b * conj(w) */
+      const ACC cr = ( br * wr + bi * wi + QRND ) >> FRAC;
+      const ACC ci = ( bi * wr - br * wi + QRND ) >> FRAC;
+      const ACC ur = ar + cr, ui = ai + ci;
+      const ACC tr = ar - cr, ti = ai - ci;
+      qa[0] = (SAMPLE)ur;  qa[1] = (SAMPLE)ui;
+      qb[0] = (SAMPLE)tr;  qb[1] = (SAMPLE)ti;
+      omask |= ONES(ur) | ONES(ui) | ONES(tr) | ONES(ti);
+    }
+  }
+  return omask;
+}
+
+
+/* complex transforms of length M. return the exponent - and the mask of the output */
+static int FIXED_Q(cfft_fwd)(const PFFFT_Fixed_Setup *s, const SAMPLE *in, SAMPLE *out, ACC *mask)
+{
+  ACC m = FIXED_Q(mask)(in, 2 * s->M);
+  int h, k, e = 0;
+  for (h = s->M / 2; h >= 1; h /= 2) {
+    k = FIXED_Q(mask_exp)(m);
+    m = FIXED_Q(stage_fwd)(in, out, s->M, h, TW(s) + 2 * (h - 1), k);
+    e += k;
+    in = out;
+  }
+  *mask = m;
+  return e;
+}
+
+static int FIXED_Q(cfft_bwd)(const PFFFT_Fixed_Setup *s, const SAMPLE *in, SAMPLE *out, ACC m)
+{
+  int h, k, e = 0;
+  for (h = 1; h < s->M; h *= 2) {
+    k = FIXED_Q(mask_exp)(m);
+    m = FIXED_Q(stage_bwd)(in, out, s->M, h, TW(s) + 2 * (h - 1), k);
+    e += k;
+    in = out;
+  }
+  return e;
+}
+
+
+/* real forward split step: from the complex transform Z of the even/odd
+   samples to X[k] = (Z[k] + conj(Z[M-k])) / 2 - i W^k (Z[k] - conj(Z[M-k])) / 2
+   and X[M-k] - at the bit reversed positions p and q of k and M-k */
+static int FIXED_Q(split_fwd)(const PFFFT_Fixed_Setup *s, const SAMPLE *in, SAMPLE *out, ACC m)
+{
+  const int k = FIXED_Q(mask_exp)(m);
+  const int *pq = s->split_pos;
+  const SAMPLE *w = SPLIT_TW(s);
+  ACC nmul, nrnd;
+  int nsh, j;
+  FIXED_Q(norm_params)(k, &nmul, &nrnd, &nsh);
+
+  {
+    const ACC z0r = NORM(in[0]), z0i = NORM(in[1]);
+    out[0] = (SAMPLE)( z0r + z0i );   /* X[0] */
+    out[1] = (SAMPLE)( z0r - z0i );   /* X[M] */
+  }
+  for (j = 0; j < s->num_split; ++j) {
+    const SAMPLE *pk = in + 2 * pq[2 * j], *pm = in + 2 * pq[2 * j + 1];
+    SAMPLE *qk = out + 2 * pq[2 * j], *qm = out + 2 * pq[2 * j + 1];
+    const ACC kr = NORM(pk[0]), ki = NORM(pk[1]), mr = NORM(pm[0]), mi = NORM(pm[1]);
+    const ACC wr = w[2 * j], wi = w[2 * j + 1];
+    /* fe = Z[k] + conj(Z[M-k]),  fo = -i (Z[k] - conj(Z[M-k])) */
+    const ACC fer = ( kr + mr ) * QONE, fei = ( ki - mi ) * QONE;
+    const ACC for_ = ki + mi, foi = mr - kr;
+    const ACC tr = for_ * wr - foi * wi, ti = for_ * wi + foi * wr;
+    /* X[M-k] = conj(fe - W fo) / 2 - written first, as p == q for k == M/2 */
+    qm[0] = (SAMPLE)( ( fer - tr + QONE ) >> (FRAC + 1) );
+    qm[1] = (SAMPLE)( ( ti - fei + QONE ) >> (FRAC + 1) );
+    qk[0] = (SAMPLE)( ( fer + tr + QONE ) >> (FRAC + 1) );
+    qk[1] = (SAMPLE)( ( fei + ti + QONE ) >> (FRAC + 1) );
+  }
+  return k;
+}
+
+/* real backward split step: inverse of split_fwd(), but with Z[k] / 2 = (fe + i fo) / 2,
+   fe = X[k] + conj(X[M-k]), fo = conj(W^k) (X[k] - conj(X[M-k])). returns the exponent k + 1 */
+static int FIXED_Q(split_bwd)(const PFFFT_Fixed_Setup *s, const SAMPLE *in, SAMPLE *out, ACC m, ACC *mask)
+{
+  const int k = FIXED_Q(mask_exp)(m);
+  const int *pq = s->split_pos;
+  const SAMPLE *w = SPLIT_TW(s);
+  ACC nmul, nrnd, omask;
+  int nsh, j;
+  FIXED_Q(norm_params)(k, &nmul, &nrnd, &nsh);
+
+  {
+    const ACC x0 = NORM(in[0]), xm = NORM(in[1]);
+    const ACC zr = ( x0 + xm + 1 ) >> 1, zi = ( x0 - xm + 1 ) >> 1;
+    out[0] = (SAMPLE)zr;
+    out[1] = (SAMPLE)zi;
+    omask = ONES(zr) | ONES(zi);
+  }
+  for (j = 0; j < s->num_split; ++j) {
+    const SAMPLE *pk = in + 2 * pq[2 * j], *pm = in + 2 * pq[2 * j + 1];
+    SAMPLE *qk = out + 2 * pq[2 * j], *qm = out + 2 * pq[2 * j + 1];
+    const ACC kr = NORM(pk[0]), ki = NORM(pk[1]), mr = NORM(pm[0]), mi = NORM(pm[1]);
+    const ACC wr = w[2 * j], wi = w[2 * j + 1];
+    const ACC fer = ( kr + mr ) * QONE, fei = ( ki - mi ) * QONE;
+    const ACC dr = kr - mr, di = ki + mi;
+    const ACC for_ = dr * wr + di * wi, foi = di * wr - dr * wi;
+    /* Z[M-k] = conj(fe) + i conj(fo) - written first, as p == q for k == M/2 */
+    const ACC zmr = ( fer + foi + QONE ) >> (FRAC + 1), zmi = ( for_ - fei + QONE ) >> (FRAC + 1);
+    const ACC zkr = ( fer - foi + QONE ) >> (FRAC + 1), zki = ( fei + for_ + QONE ) >> (FRAC + 1);
+    qm[0] = (SAMPLE)zmr;  qm[1] = (SAMPLE)zmi;
+    qk[0] = (SAMPLE)zkr;  qk[1] = (SAMPLE)zki;
+    omask |= ONES(zmr) | ONES(zmi) | ONES(zkr) | ONES(zki);
+  }
+  *mask = omask;
+  return k + 1;
+}
+
+
+int FIXED_Q(pffft_fixed_transform)(PFFFT_Fixed_Setup *s, const SAMPLE *input, SAMPLE *output, pffft_direction_t direction)
+{
+  ACC m;
+  int e;
+  if (direction == PFFFT_FORWARD) {
+    e = FIXED_Q(cfft_fwd)(s, input, output, &m);
+    if (s->transform == PFFFT_REAL)
+      e += FIXED_Q(split_fwd)(s, output, output, m);
+  }
+  else if (s->transform == PFFFT_REAL) {
+    e = FIXED_Q(split_bwd)(s, input, output, FIXED_Q(mask)(input, 2 * s->M), &m);
+    e += FIXED_Q(cfft_bwd)(s, output, output, m);
+  }
+  else
+    e = FIXED_Q(cfft_bwd)(s, input, output, FIXED_Q(mask)(input, 2 * s->M));
+  return e;
+}
+
+
+void FIXED_Q(pffft_fixed_zreorder)(PFFFT_Fixed_Setup *s, const SAMPLE *input, SAMPLE *output, pffft_direction_t direction)
+{
+  const int *rev = s->rev;
+  int p;
+  (void)direction;  /* the bit reversal is its own inverse */
+  if (input != output) {
+    for (p = 0; p < s->M; ++p) {
+      output[2 * rev[p]] = input[2 * p];
+      output[2 * rev[p] + 1] = input[2 * p + 1];
+    }
+  }
+  else {
+    for (p = 0; p < s->M; ++p) {
+      if (rev[p] > p) {
+        const SAMPLE r = output[2 * p], i = output[2 * p + 1];
+        output[2 * p] = output[2 * rev[p]];
+        output[2 * p + 1] = output[2 * rev[p] + 1];
+        output[2 * rev[p]] = r;
+        output[2 * rev[p] + 1] = i;
+      }
+    }
+  }
+}
+
+
+int FIXED_Q(pffft_fixed_transform_ordered)(PFFFT_Fixed_Setup *s, const SAMPLE *input, SAMPLE *output, pffft_direction_t direction)
+{
+  int e;
+  if (direction == PFFFT_FORWARD) {
+    e = FIXED_Q(pffft_fixed_transform)(s, input, output, direction);
+    FIXED_Q(pffft_fixed_zreorder)(s, output, output, direction);
+  }
+  else {
+    FIXED_Q(pffft_fixed_zreorder)(s, input, output, direction);
+    e = FIXED_Q(pffft_fixed_transform)(s, output, output, direction);
+  }
+  return e;
+}
+
+
+int FIXED_Q(pffft_fixed_zconvolve)(PFFFT_Fixed_Setup *s, const SAMPLE *a, int exp_a,
+                                   const SAMPLE *b, int exp_b, SAMPLE *ab)
+{
+  /* |Re(a * b)| <= 2 * |a| * |b| < 2^(bits(a) + bits(b) + 1): shift to 2^(FRAC-1) */
+  const int k = fixed_bitlen( (uint64_t)FIXED_Q(mask)(a, 2 * s->M) )
+              + fixed_bitlen( (uint64_t)FIXED_Q(mask)(b, 2 * s->M) ) + 2 - FRAC;
+  const ACC a0 = a[0], a1 = a[1], b0 = b[0], b1 = b[1];
+  ACC nmul, nrnd;
+  int nsh, i = 0;
+  FIXED_Q(norm_params)(k, &nmul, &nrnd, &nsh);
+
+#if FIXED_NEON
+  {
+    const VACC sh = VDUP_ACC(-k);
+    for (; i + VLANES <= s->M; i += VLANES) {
+      const VX2 va = VLD2(a + 2 * i), vb = VLD2(b + 2 * i);
+      VX2 r;
+      const VACC rlo = VMLSL( VMULL(VGETLO(va.val[0]), VGETLO(vb.val[0])), VGETLO(va.val[1]), VGETLO(vb.val[1]) );
+      const VACC rhi = VMLSL( VMULL(VGETHI(va.val[0]), VGETHI(vb.val[0])), VGETHI(va.val[1]), VGETHI(vb.val[1]) );
+      const VACC ilo = VMLAL( VMULL(VGETLO(va.val[0]), VGETLO(vb.val[1])), VGETLO(va.val[1]), VGETLO(vb.val[0]) );
+      const VACC ihi = VMLAL( VMULL(VGETHI(va.val[0]), VGETHI(vb.val[1])), VGETHI(va.val[1]), VGETHI(vb.val[0]) );
+      r.val[0] = VCOMBINE( VQMOVN(VRSHL_ACC(rlo, sh)), VQMOVN(VRSHL_ACC(rhi, sh)) );
+      r.val[1] = VCOMBINE( VQMOVN(VRSHL_ACC(ilo, sh)), VQMOVN(VRSHL_ACC(ihi, sh)) );
+      VST2(ab + 2 * i, r);
+    }
+  }
+#endif
+  for (; i < s->M; ++i) {
+    const ACC ar = a[2 * i], ai = a[2 * i + 1], br = b[2 * i], bi = b[2 * i + 1];
+    ab[2 * i] = (SAMPLE)NORM( ar * br - ai * bi );
+    ab[2 * i + 1] = (SAMPLE)NORM( ar * bi + ai * br );
+  }
+  if (s->transform == PFFFT_REAL) {
+    /* X[0] and X[N/2] are real */
+    ab[0] = (SAMPLE)NORM( a0 * b0 );
+    ab[1] = (SAMPLE)NORM( a1 * b1 );
+  }
+  return exp_a + exp_b + k;
+}
+
+#undef NORM
+#undef ONES
+#undef QRND
+#undef QONE
+#if FIXED_NEON
+#undef VONES
+#endif
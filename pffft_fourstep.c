@@ -0,0 +1,614 @@
+
+#include "pffft_fourstep.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#elif !defined(PFFFT_FOURSTEP_NO_THREADS)
+#  include <pthread.h>
+#  include <unistd.h>
+#endif
+
+/* detect compiler flavour */
+#if defined(_MSC_VER)
+#  define RESTRICT __restrict
+#pragma warning( disable : 4244 4305 4204 4456 )
+#elif defined(__GNUC__)
+#  define RESTRICT __restrict
+#else
+#  define RESTRICT
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* number of columns/rows, which are gathered/scattered together:
+   16 complex floats = 2 cache lines */
+#define FOURSTEP_BLOCK  16
+
+
+struct PFFFT_FourStep_Setup
+{
+  int N;
+  pffft_transform_t transform;
+  int M;            /* length of complex four-step transform: M = N1 * N2 */
+  int N1, N2;
+  PFFFT_Setup *s1;  /* complex setup of length N1 */
+  PFFFT_Setup *s2;  /* complex setup of length N2 */
+
+  /* W_M^p = tw_hi[p / N1] * tw_lo[p % N1], for p < M; complex interleaved */
+  float *tw_lo, *tw_hi;
+
+  /* (real only) W_N^k = rtw_hi[k / Lr] * rtw_lo[k % Lr], for k <= N/4 */
+  int Lr;
+  float *rtw_lo, *rtw_hi;
+
+  int num_tasks;
+  pffft_parallel_for_t parallel_for;
+  void *pool;
+
+  /* per task: FOURSTEP_BLOCK sequences of max(N1, N2) complex
+     values and the work for pffft - each of task_stride floats */
+  int task_stride;
+  float *task_mem;
+};
+
+/* arguments of one transform for the tasks */
+typedef struct
+{
+  PFFFT_FourStep_Setup *s;
+  const float *input;
+  float *output;
+  float *work;
+  pffft_direction_t direction;
+} fourstep_call_t;
+
+
+/* fill 'n' complex values of exp(-2 pi i * k * step / N) for k = 0 .. n-1 */
+static float *fourstep_twiddles(int n, double step, double N)
+{
+  float *tw = (float*)pffft_aligned_malloc(2 * (size_t)n * sizeof(float));
+  int k;
+  for (k = 0; k < n; ++k) {
+    const double phi = -2.0 * M_PI * ((double)k * step) / N;
+    tw[2*k] = (float)cos(phi);
+    tw[2*k+1] = (float)sin(phi);
+  }
+  return tw;
+}
+
+static int fourstep_num_cpus(void)
+{
+#if defined(_WIN32)
+  SYSTEM_INFO si;
+  GetSystemInfo(&si);
+  return (int)si.dwNumberOfProcessors;
+#elif !defined(PFFFT_FOURSTEP_NO_THREADS) && defined(_SC_NPROCESSORS_ONLN)
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return (n > 0) ? (int)n : 1;
+#else
+  return 1;
+#endif
+}
+
+
+/* internal "thread pool": one thread per task - for each step.
+   creating the threads is negligible compared to the large transforms */
+
+typedef struct
+{
+  void (*task)(void *task_arg, int k);
+  void *task_arg;
+  int k;
+} fourstep_thread_t;
+
+#if defined(_WIN32)
+static DWORD WINAPI fourstep_thread_fn(LPVOID p)
+{
+  fourstep_thread_t *t = (fourstep_thread_t*)p;
+  t->task(t->task_arg, t->k);
+  return 0;
+}
+#elif !defined(PFFFT_FOURSTEP_NO_THREADS)
+static void *fourstep_thread_fn(void *p)
+{
+  fourstep_thread_t *t = (fourstep_thread_t*)p;
+  t->task(t->task_arg, t->k);
+  return NULL;
+}
+#endif
+
+static void fourstep_parallel_for(void *pool, int count, void (*task)(void *task_arg, int k), void *task_arg)
+{
+  int k;
+#if defined(_WIN32) || !defined(PFFFT_FOURSTEP_NO_THREADS)
+  fourstep_thread_t *t = (fourstep_thread_t*)malloc((size_t)count * sizeof(fourstep_thread_t));
+#  if defined(_WIN32)
+  HANDLE *h = (HANDLE*)malloc((size_t)count * sizeof(HANDLE));
+#  else
+  pthread_t *h = (pthread_t*)malloc((size_t)count * sizeof(pthread_t));
+#  endif
+  int *started = (int*)malloc((size_t)count * sizeof(int));
+  (void)pool;
+  /* task 0 runs in the calling thread */
+  for (k = 1; k < count; ++k) {
+    t[k].task = task;
+    t[k].task_arg = task_arg;
+    t[k].k = k;
+#  if defined(_WIN32)
+    h[k] = CreateThread(NULL, 0, fourstep_thread_fn, &t[k], 0, NULL);
+    started[k] = (h[k] != NULL);
+#  else
+    started[k] = (pthread_create(&h[k], NULL, fourstep_thread_fn, &t[k]) == 0);
+#  endif
+    if (!started[k])
+      task(task_arg, k);  /* run it here - if the thread can't be created */
+  }
+  task(task_arg, 0);
+  for (k = 1; k < count; ++k) {
+    if (!started[k])
+      continue;
+#  if defined(_WIN32)
+    WaitForSingleObject(h[k], INFINITE);
+    CloseHandle(h[k]);
+#  else
+    pthread_join(h[k], NULL);
+#  endif
+  }
+  free(started);
+  free(h);
+  free(t);
+#else
+  (void)pool;
+  for (k = 0; k < count; ++k)
+    task(task_arg, k);
+#endif
+}
+
+
+PFFFT_FourStep_Setup *pffft_fourstep_new_setup(int N, pffft_transform_t transform, int num_tasks,
+                                               pffft_parallel_for_t parallel_for, void *pool)
+{
+  PFFFT_FourStep_Setup *s;
+  const int M = (transform == PFFFT_REAL) ? N / 2 : N;
+  int N1, N2, Nmax, nblocks;
+
+  if (N <= 0 || (transform == PFFFT_REAL && (N % 4) != 0))
+    return NULL;
+
+  /* N1 <= N2: use the biggest N1 <= sqrt(M) with valid sizes N1 and N2 */
+  for (N1 = (int)sqrt((double)M); N1 > 0; --N1) {
+    if ( (M % N1) == 0
+         && pffft_is_valid_size(N1, PFFFT_COMPLEX)
+         && pffft_is_valid_size(M / N1, PFFFT_COMPLEX) )
+      break;
+  }
+  if (N1 <= 0)
+    return NULL;
+  N2 = M / N1;
+  Nmax = (N1 > N2) ? N1 : N2;
+
+  s = (PFFFT_FourStep_Setup*)malloc(sizeof(PFFFT_FourStep_Setup));
+  memset(s, 0, sizeof(PFFFT_FourStep_Setup));
+  s->N = N;
+  s->transform = transform;
+  s->M = M;
+  s->N1 = N1;
+  s->N2 = N2;
+  s->s1 = pffft_new_setup(N1, PFFFT_COMPLEX);
+  s->s2 = pffft_new_setup(N2, PFFFT_COMPLEX);
+  if (!s->s1 || !s->s2) {
+    pffft_fourstep_destroy_setup(s);
+    return NULL;
+  }
+
+  s->tw_lo = fourstep_twiddles(N1, 1.0, M);
+  s->tw_hi = fourstep_twiddles(N2, N1, M);
+
+  if (transform == PFFFT_REAL) {
+    const int K = N / 4 + 1;
+    s->Lr = (int)sqrt((double)K) + 1;
+    s->rtw_lo = fourstep_twiddles(s->Lr, 1.0, N);
+    s->rtw_hi = fourstep_twiddles(K / s->Lr + 1, s->Lr, N);
+  }
+
+  /* each task needs at least one block of the gather/scatter steps */
+  nblocks = (N1 + FOURSTEP_BLOCK - 1) / FOURSTEP_BLOCK;
+  if (num_tasks <= 0)
+    num_tasks = fourstep_num_cpus();
+  if (num_tasks > nblocks)
+    num_tasks = nblocks;
+  s->num_tasks = num_tasks;
+  s->parallel_for = parallel_for ? parallel_for : fourstep_parallel_for;
+  s->pool = pool;
+
+  s->task_stride = (FOURSTEP_BLOCK + 1) * 2 * Nmax;
+  s->task_mem = (float*)pffft_aligned_malloc((size_t)num_tasks * (size_t)s->task_stride * sizeof(float));
+  return s;
+}
+
+void pffft_fourstep_destroy_setup(PFFFT_FourStep_Setup *s)
+{
+  if (!s)
+    return;
+  if (s->s1)
+    pffft_destroy_setup(s->s1);
+  if (s->s2)
+    pffft_destroy_setup(s->s2);
+  pffft_aligned_free(s->tw_lo);
+  pffft_aligned_free(s->tw_hi);
+  pffft_aligned_free(s->rtw_lo);
+  pffft_aligned_free(s->rtw_hi);
+  pffft_aligned_free(s->task_mem);
+  free(s);
+}
+
+void pffft_fourstep_factors(const PFFFT_FourStep_Setup *s, int *N1, int *N2)
+{
+  if (N1)
+    *N1 = s->N1;
+  if (N2)
+    *N2 = s->N2;
+}
+
+
+/* range [*beg, *end) of 'n' items for task k */
+static void fourstep_task_range(int n, int num_tasks, int k, int *beg, int *end)
+{
+  *beg = (int)( ((long long)n * k) / num_tasks );
+  *end = (int)( ((long long)n * (k+1)) / num_tasks );
+}
+
+
+/* step 1 and 2: input as matrix of N1 rows x N2 columns.
+   transform the columns n2 (length N1), multiply with W_M^(n2*k1)
+   and store as matrix 'work' of N1 rows k1 x N2 columns n2.
+   input and work may alias: a block of columns is gathered completely,
+   before it's written back to the same positions */
+static void fourstep_columns_task(void *arg, int k)
+{
+  const fourstep_call_t *c = (const fourstep_call_t*)arg;
+  const PFFFT_FourStep_Setup *s = c->s;
+  const int N1 = s->N1, N2 = s->N2;
+  const float *x = c->input;
+  float *w = c->work;
+  float *RESTRICT tmp = s->task_mem + (size_t)k * s->task_stride;
+  float *RESTRICT pwork = tmp + FOURSTEP_BLOCK * 2 * (N1 > N2 ? N1 : N2);
+  const float *RESTRICT lo = s->tw_lo;
+  const float *RESTRICT hi = s->tw_hi;
+  const float conj_sign = (c->direction == PFFFT_FORWARD) ? 1.0f : -1.0f;
+  int ia[FOURSTEP_BLOCK], ib[FOURSTEP_BLOCK], da[FOURSTEP_BLOCK], db[FOURSTEP_BLOCK];
+  int blk_beg, blk_end, blk, n1, k1, j;
+
+  fourstep_task_range((N2 + FOURSTEP_BLOCK - 1) / FOURSTEP_BLOCK, s->num_tasks, k, &blk_beg, &blk_end);
+  for (blk = blk_beg; blk < blk_end; ++blk) {
+    const int c0 = blk * FOURSTEP_BLOCK;
+    const int nb = (N2 - c0 < FOURSTEP_BLOCK) ? (N2 - c0) : FOURSTEP_BLOCK;
+
+    /* gather columns c0 .. c0+nb-1 */
+    for (n1 = 0; n1 < N1; ++n1) {
+      const float *src = x + 2 * ((size_t)n1 * N2 + c0);
+      for (j = 0; j < nb; ++j) {
+        tmp[2 * (j * N1 + n1)] = src[2*j];
+        tmp[2 * (j * N1 + n1) + 1] = src[2*j+1];
+      }
+    }
+
+    pffft_transform_ordered_batch(s->s1, nb, tmp, 2 * N1, tmp, 2 * N1, pwork, c->direction);
+
+    /* twiddle index p = n2 * k1 < M, split into p / N1 and p % N1 */
+    for (j = 0; j < nb; ++j) {
+      ia[j] = ib[j] = 0;
+      da[j] = (c0 + j) / N1;
+      db[j] = (c0 + j) % N1;
+    }
+    for (k1 = 0; k1 < N1; ++k1) {
+      float *dst = w + 2 * ((size_t)k1 * N2 + c0);
+      for (j = 0; j < nb; ++j) {
+        const float hr = hi[2*ia[j]], hi_ = hi[2*ia[j]+1];
+        const float lr = lo[2*ib[j]], li = lo[2*ib[j]+1];
+        const float tr = hr * lr - hi_ * li;
+        const float ti = (hr * li + hi_ * lr) * conj_sign;
+        const float vr = tmp[2 * (j * N1 + k1)];
+        const float vi = tmp[2 * (j * N1 + k1) + 1];
+        dst[2*j] = vr * tr - vi * ti;
+        dst[2*j+1] = vr * ti + vi * tr;
+        ia[j] += da[j];
+        ib[j] += db[j];
+        if (ib[j] >= N1) {
+          ib[j] -= N1;
+          ++ia[j];
+        }
+      }
+    }
+  }
+}
+
+/* step 3 and 4: transform the rows k1 of 'work' (length N2)
+   and store transposed: output[k1 + N1 * k2] */
+static void fourstep_rows_task(void *arg, int k)
+{
+  const fourstep_call_t *c = (const fourstep_call_t*)arg;
+  const PFFFT_FourStep_Setup *s = c->s;
+  const int N1 = s->N1, N2 = s->N2;
+  float *RESTRICT y = c->output;
+  float *RESTRICT tmp = s->task_mem + (size_t)k * s->task_stride;
+  float *RESTRICT pwork = tmp + FOURSTEP_BLOCK * 2 * (N1 > N2 ? N1 : N2);
+  int blk_beg, blk_end, blk, k2, j;
+
+  fourstep_task_range((N1 + FOURSTEP_BLOCK - 1) / FOURSTEP_BLOCK, s->num_tasks, k, &blk_beg, &blk_end);
+  for (blk = blk_beg; blk < blk_end; ++blk) {
+    const int r0 = blk * FOURSTEP_BLOCK;
+    const int nb = (N1 - r0 < FOURSTEP_BLOCK) ? (N1 - r0) : FOURSTEP_BLOCK;
+
+    pffft_transform_ordered_batch(s->s2, nb, c->work + 2 * (size_t)r0 * N2, 2 * N2,
+                                  tmp, 2 * N2, pwork, c->direction);
+
+    for (k2 = 0; k2 < N2; ++k2) {
+      float *dst = y + 2 * ((size_t)k2 * N1 + r0);
+      for (j = 0; j < nb; ++j) {
+        dst[2*j] = tmp[2 * (j * N2 + k2)];
+        dst[2*j+1] = tmp[2 * (j * N2 + k2) + 1];
+      }
+    }
+  }
+}
+
+
+/* in-place step 3: transform the rows k1 of 'work' (length N2) in place */
+static void fourstep_rows_inplace_task(void *arg, int k)
+{
+  const fourstep_call_t *c = (const fourstep_call_t*)arg;
+  const PFFFT_FourStep_Setup *s = c->s;
+  const int N1 = s->N1, N2 = s->N2;
+  float *pwork = s->task_mem + (size_t)k * s->task_stride + FOURSTEP_BLOCK * 2 * (N1 > N2 ? N1 : N2);
+  int blk_beg, blk_end, blk;
+
+  fourstep_task_range((N1 + FOURSTEP_BLOCK - 1) / FOURSTEP_BLOCK, s->num_tasks, k, &blk_beg, &blk_end);
+  for (blk = blk_beg; blk < blk_end; ++blk) {
+    const int r0 = blk * FOURSTEP_BLOCK;
+    const int nb = (N1 - r0 < FOURSTEP_BLOCK) ? (N1 - r0) : FOURSTEP_BLOCK;
+    float *rows = c->work + 2 * (size_t)r0 * N2;
+    pffft_transform_ordered_batch(s->s2, nb, rows, 2 * N2, rows, 2 * N2, pwork, c->direction);
+  }
+}
+
+/* in-place step 4, when N2 = r * N1: the N1 x N2 matrix are r squares
+   of N1 x N1 side by side. first, transpose each square in place - in
+   tiles of FOURSTEP_BLOCK x FOURSTEP_BLOCK, the tile rows interleaved
+   over the tasks. then row k1 of square b holds output row b * N1 + k1 */
+static void fourstep_transpose_squares_task(void *arg, int k)
+{
+  const fourstep_call_t *c = (const fourstep_call_t*)arg;
+  const PFFFT_FourStep_Setup *s = c->s;
+  const int N1 = s->N1, N2 = s->N2;
+  const int ntiles = (N1 + FOURSTEP_BLOCK - 1) / FOURSTEP_BLOCK;
+  int b, ti, tj, i, j;
+
+  for (ti = k; ti < ntiles; ti += s->num_tasks) {
+    const int i0 = ti * FOURSTEP_BLOCK;
+    const int i1 = (i0 + FOURSTEP_BLOCK < N1) ? (i0 + FOURSTEP_BLOCK) : N1;
+    for (b = 0; b < N2 / N1; ++b) {
+      float *RESTRICT sq = c->work + 2 * (size_t)b * N1;
+      for (tj = ti; tj < ntiles; ++tj) {
+        const int j0 = tj * FOURSTEP_BLOCK;
+        const int j1 = (j0 + FOURSTEP_BLOCK < N1) ? (j0 + FOURSTEP_BLOCK) : N1;
+        for (i = i0; i < i1; ++i) {
+          for (j = (ti == tj) ? i + 1 : j0; j < j1; ++j) {
+            float *p = sq + 2 * ((size_t)i * N2 + j);
+            float *q = sq + 2 * ((size_t)j * N2 + i);
+            const float tr = p[0], tim = p[1];
+            p[0] = q[0];
+            p[1] = q[1];
+            q[0] = tr;
+            q[1] = tim;
+          }
+        }
+      }
+    }
+  }
+}
+
+/* in-place step 4, when N2 = r * N1: after fourstep_transpose_squares_task(),
+   the segment of N1 complex values at segment position i * r + b belongs
+   to position b * N1 + i. follow the cycles of this permutation with one
+   segment in 'buf' and a flag per segment */
+static void fourstep_permute_segments(const PFFFT_FourStep_Setup *s, float *data, float *buf,
+                                      unsigned char *done)
+{
+  const int N1 = s->N1, N2 = s->N2, r = N2 / N1;
+  const size_t seg_bytes = 2 * (size_t)N1 * sizeof(float);
+  int start, pos, src;
+
+  for (start = 0; start < N2; ++start) {
+    if (done[start])
+      continue;
+    memcpy(buf, data + 2 * (size_t)start * N1, seg_bytes);
+    for (pos = start; ; pos = src) {
+      src = (pos % N1) * r + pos / N1;  /* segment, which moves to 'pos' */
+      done[pos] = 1;
+      if (src == start)
+        break;
+      memcpy(data + 2 * (size_t)pos * N1, data + 2 * (size_t)src * N1, seg_bytes);
+    }
+    memcpy(data + 2 * (size_t)pos * N1, buf, seg_bytes);
+  }
+}
+
+/* in-place step 4 for other N1, N2: follow the cycles of the transposition
+   element by element, with one bit per complex value in 'done' */
+static void fourstep_transpose_cycles(const PFFFT_FourStep_Setup *s, float *data, unsigned char *done)
+{
+  const int N1 = s->N1, N2 = s->N2, M = s->M;
+  int start, pos, src;
+
+  for (start = 0; start < M; ++start) {
+    float tr, ti;
+    if (done[start >> 3] & (1 << (start & 7)))
+      continue;
+    tr = data[2 * (size_t)start];
+    ti = data[2 * (size_t)start + 1];
+    for (pos = start; ; pos = src) {
+      src = (pos % N1) * N2 + pos / N1;  /* output[k1 + N1 * k2] = work[k1 * N2 + k2] */
+      done[pos >> 3] |= (unsigned char)(1 << (pos & 7));
+      if (src == start)
+        break;
+      data[2 * (size_t)pos] = data[2 * (size_t)src];
+      data[2 * (size_t)pos + 1] = data[2 * (size_t)src + 1];
+    }
+    data[2 * (size_t)pos] = tr;
+    data[2 * (size_t)pos + 1] = ti;
+  }
+}
+
+
+/* W_N^k for the real split step */
+static void fourstep_real_twiddle(const PFFFT_FourStep_Setup *s, int k, float *wr, float *wi)
+{
+  const float *hi = s->rtw_hi + 2 * (k / s->Lr);
+  const float *lo = s->rtw_lo + 2 * (k % s->Lr);
+  *wr = hi[0] * lo[0] - hi[1] * lo[1];
+  *wi = hi[0] * lo[1] + hi[1] * lo[0];
+}
+
+/* forward real: output holds Z = complex FFT of z[n] = x[2n] + i x[2n+1];
+   split into X[k] = E[k] + W_N^k O[k] in place - on pairs k, M-k:
+   E[k] = (Z[k] + conj(Z[M-k])) / 2,  O[k] = (Z[k] - conj(Z[M-k])) / 2i */
+static void fourstep_real_post_task(void *arg, int k)
+{
+  const fourstep_call_t *c = (const fourstep_call_t*)arg;
+  const PFFFT_FourStep_Setup *s = c->s;
+  const int M = s->M;
+  float *RESTRICT y = c->output;
+  int beg, end, i;
+
+  fourstep_task_range(M / 2, s->num_tasks, k, &beg, &end);
+  if (k == 0) {
+    const float zr = y[0], zi = y[1];
+    y[0] = zr + zi;   /* DC */
+    y[1] = zr - zi;   /* Nyquist */
+  }
+  for (i = beg + 1; i <= end; ++i) {
+    const int m = M - i;
+    float wr, wi;
+    const float ar = y[2*i], ai = y[2*i+1];
+    const float br = y[2*m], bi = y[2*m+1];
+    const float er = 0.5f * (ar + br), ei = 0.5f * (ai - bi);
+    const float or_ = 0.5f * (ai + bi), oi = -0.5f * (ar - br);
+    float tr, ti;
+    fourstep_real_twiddle(s, i, &wr, &wi);
+    tr = wr * or_ - wi * oi;
+    ti = wr * oi + wi * or_;
+    y[2*i] = er + tr;
+    y[2*i+1] = ei + ti;
+    y[2*m] = er - tr;
+    y[2*m+1] = -(ei - ti);
+  }
+}
+
+/* backward real: prepare Z from X into output, that the complex backward
+   transform delivers z[n] = x[2n] + i x[2n+1], scaled by N  (=2M):
+   Z[k] = (X[k] + conj(X[M-k])) + i conj(W_N^k) (X[k] - conj(X[M-k])) */
+static void fourstep_real_pre_task(void *arg, int k)
+{
+  const fourstep_call_t *c = (const fourstep_call_t*)arg;
+  const PFFFT_FourStep_Setup *s = c->s;
+  const int M = s->M;
+  const float *RESTRICT x = c->input;
+  float *RESTRICT y = c->output;
+  int beg, end, i;
+
+  fourstep_task_range(M / 2, s->num_tasks, k, &beg, &end);
+  if (k == 0) {
+    const float d = x[0], q = x[1];
+    y[0] = d + q;
+    y[1] = d - q;
+  }
+  for (i = beg + 1; i <= end; ++i) {
+    const int m = M - i;
+    float wr, wi;
+    const float ar = x[2*i], ai = x[2*i+1];
+    const float br = x[2*m], bi = x[2*m+1];
+    const float er = ar + br, ei = ai - bi;
+    const float dr = ar - br, di = ai + bi;
+    float tr, ti;
+    fourstep_real_twiddle(s, i, &wr, &wi);
+    /* t = i * conj(w) * d */
+    tr = -(wr * di - wi * dr);
+    ti = wr * dr + wi * di;
+    y[2*i] = er + tr;
+    y[2*i+1] = ei + ti;
+    y[2*m] = er - tr;
+    y[2*m+1] = -(ei - ti);
+  }
+}
+
+
+void pffft_fourstep_transform_ordered(PFFFT_FourStep_Setup *s, const float *input, float *output,
+                                      float *work, pffft_direction_t direction)
+{
+  fourstep_call_t c;
+  float *allocated = NULL;
+
+  if (!work)
+    work = allocated = (float*)pffft_aligned_malloc(2 * (size_t)s->M * sizeof(float));
+
+  c.s = s;
+  c.input = input;
+  c.output = output;
+  c.work = work;
+  c.direction = direction;
+
+  if (s->transform == PFFFT_REAL && direction == PFFFT_BACKWARD) {
+    /* input and output may alias: each task reads and writes the same pairs */
+    s->parallel_for(s->pool, s->num_tasks, fourstep_real_pre_task, &c);
+    c.input = output;
+  }
+
+  s->parallel_for(s->pool, s->num_tasks, fourstep_columns_task, &c);
+  s->parallel_for(s->pool, s->num_tasks, fourstep_rows_task, &c);
+
+  if (s->transform == PFFFT_REAL && direction == PFFFT_FORWARD)
+    s->parallel_for(s->pool, s->num_tasks, fourstep_real_post_task, &c);
+
+  if (allocated)
+    pffft_aligned_free(allocated);
+}
+
+void pffft_fourstep_transform_inplace(PFFFT_FourStep_Setup *s, float *data, pffft_direction_t direction)
+{
+  const int squares = (s->N2 % s->N1) == 0;
+  unsigned char *done;
+  fourstep_call_t c;
+
+  c.s = s;
+  c.input = data;
+  c.output = data;
+  c.work = data;
+  c.direction = direction;
+
+  if (s->transform == PFFFT_REAL && direction == PFFFT_BACKWARD)
+    s->parallel_for(s->pool, s->num_tasks, fourstep_real_pre_task, &c);
+
+  s->parallel_for(s->pool, s->num_tasks, fourstep_columns_task, &c);
+  s->parallel_for(s->pool, s->num_tasks, fourstep_rows_inplace_task, &c);
+
+  if (squares) {
+    s->parallel_for(s->pool, s->num_tasks, fourstep_transpose_squares_task, &c);
+    done = (unsigned char*)calloc((size_t)s->N2, 1);
+    fourstep_permute_segments(s, data, s->task_mem, done);
+  } else {
+    done = (unsigned char*)calloc(((size_t)s->M + 7) / 8, 1);
+    fourstep_transpose_cycles(s, data, done);
+  }
+  free(done);
+
+  if (s->transform == PFFFT_REAL && direction == PFFFT_FORWARD)
+    s->parallel_for(s->pool, s->num_tasks, fourstep_real_post_task, &c);
+}
@@ -0,0 +1,107 @@
+
+/*
+   PFFFT_FOURSTEP : multithreaded transform for very large N
+
+   The 'four-step' decomposition splits a (complex) transform of length
+   N = N1 * N2 into N2 transforms of length N1, a twiddle multiplication,
+   N1 transforms of length N2 and a transposition. The sub-transforms
+   are computed with pffft and are small enough to stay in the caches,
+   and they are independent, that they are distributed over threads.
+   Real transforms of length N are computed with a complex transform
+   of length N/2 and a final (or initial) split step.
+
+   This is worth for sizes where the whole array doesn't fit into the
+   L2 cache, say N >= 2^20. For smaller N use pffft directly.
+
+   Restrictions:
+
+   - 1D transforms only, with 32-bit single precision.
+
+   - only ordered transforms: input and output have the same format as
+   pffft_transform_ordered(). There is no internal layout, which could
+   be used with pffft_zconvolve_accumulate().
+
+   - all (float*) pointers have to be "simd-compatible" aligned, see
+   pffft.h. Allocate them with pffft_aligned_malloc().
+*/
+
+#ifndef PFFFT_FOURSTEP_H
+#define PFFFT_FOURSTEP_H
+
+#include "pffft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /* opaque struct holding internal stuff (precomputed twiddle factors,
+     setups of the sub-transforms and temporary data of each task).
+     this struct can't be shared by many threads, as it contains
+     temporary data of the transform.
+  */
+  typedef struct PFFFT_FourStep_Setup PFFFT_FourStep_Setup;
+
+  /* interface to a (caller provided) thread pool:
+     call task(task_arg, k) for each k in 0 .. count-1 - potentially
+     concurrent - and return when all calls have finished.
+  */
+  typedef void (*pffft_parallel_for_t)(void *pool, int count,
+                                       void (*task)(void *task_arg, int k), void *task_arg);
+
+  /*
+    prepare a transform of length N, which needs to be factorizable
+    into N1 * N2 (N/2 = N1 * N2 for real transforms), where N1 and N2
+    have to be valid complex sizes for pffft, see pffft_is_valid_size().
+    returns NULL if N is not suitable.
+
+    each of the ordered transforms is split into 'num_tasks' tasks.
+    num_tasks <= 0 takes the number of available CPUs.
+
+    with 'parallel_for' == NULL, threads are created for each step of
+    the transform - or the tasks run one after the other, when compiled
+    without thread support. otherwise 'parallel_for' is called with 'pool'
+    and all tasks of a step.
+  */
+  PFFFT_FourStep_Setup *pffft_fourstep_new_setup(int N, pffft_transform_t transform, int num_tasks,
+                                                 pffft_parallel_for_t parallel_for, void *pool);
+
+  void pffft_fourstep_destroy_setup(PFFFT_FourStep_Setup *setup);
+
+  /* retrieve the factorization (of N or N/2) into N1 * N2, as chosen by the setup */
+  void pffft_fourstep_factors(const PFFFT_FourStep_Setup *setup, int *N1, int *N2);
+
+  /*
+     Perform the transform, similar to pffft_transform_ordered():
+     same order of the frequency components, same format for real
+     transforms and no scaling.
+
+     'work' needs room for N floats (real) or 2*N floats (complex)
+     transforms. If 'work' is NULL, it is allocated and freed temporarily
+     on the heap, the sizes are too big for the stack.
+
+     input and output may alias.
+  */
+  void pffft_fourstep_transform_ordered(PFFFT_FourStep_Setup *setup, const float *input, float *output,
+                                        float *work, pffft_direction_t direction);
+
+  /*
+     same transform as pffft_fourstep_transform_ordered() - in place,
+     without the N (2*N) floats of 'work': the setup's temporary data
+     of O(sqrt(N)) per task is all what's used. this halves the memory
+     of large transforms, e.g. for many concurrent transforms.
+
+     the final transposition is done in place: with N2 a multiple of N1,
+     e.g. for powers of 2, the squares of N1 x N1 are transposed, then
+     segments of N1 values are permuted along their cycles - needing a
+     temporary flag per segment, N2 bytes. for other factorizations, the
+     cycles are followed element by element with a temporary bitmap of
+     N/8 (N/16 for real transforms) bytes, which is slower. the
+     permutation runs in the calling thread.
+  */
+  void pffft_fourstep_transform_inplace(PFFFT_FourStep_Setup *setup, float *data, pffft_direction_t direction);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PFFFT_FOURSTEP_H */
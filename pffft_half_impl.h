@@ -0,0 +1,163 @@
+/* conversion between float and the 16-bit storage formats of
+ * pffft_transform_half(): IEEE 754 half precision (FP16) and bfloat16 (BF16),
+ * both with rounding to nearest even.
+ *
+ * FP16 is converted with F16C on x86 (the AVX2 and AVX-512 builds) and with
+ * NEON on aarch64, BF16 with SSE2 or NEON - else with the scalar functions.
+ *
+ * this file is only for library internal use: pffft_priv_impl.h includes it
+ * in the float builds, that each architecture specific build gets its own
+ * conversion. it requires pffft.h
+ */
+
+#if !defined(PFFFT_SIMD_DISABLE) && ( defined(__F16C__) || ( defined(_MSC_VER) && defined(__AVX2__) ) )
+#  include <immintrin.h>
+#  define HALF_F16C 1
+#endif
+#if !defined(PFFFT_SIMD_DISABLE) && ( defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 ) )
+#  include <emmintrin.h>
+#  define HALF_SSE2 1
+#endif
+#if !defined(PFFFT_SIMD_DISABLE) && defined(__aarch64__) && ( defined(__ARM_NEON) || defined(__ARM_NEON__) )
+#  include <arm_neon.h>
+#  define HALF_NEON 1
+#endif
+
+typedef union { uint32_t u; float f; } half_bits_t;
+
+/* FP16 <-> float after F. Giesen's half_to_float() and float_to_half_fast3_rtne() */
+static float half_fp16_to_float(unsigned short h) {
+  const uint32_t shifted_exp = 0x7c00u << 13;
+  half_bits_t o, magic;
+  uint32_t exp;
+  magic.u = 113u << 23;
+  o.u = (uint32_t)(h & 0x7fff) << 13;
+  exp = shifted_exp & o.u;
+  o.u += (127u - 15u) << 23;
+  if (exp == shifted_exp)       /* Inf/NaN */
+    o.u += (128u - 16u) << 23;
+  else if (exp == 0) {          /* zero/subnormal */
+    o.u += 1u << 23;
+    o.f -= magic.f;
+  }
+  o.u |= (uint32_t)(h & 0x8000) << 16;
+  return o.f;
+}
+
+static unsigned short half_float_to_fp16(float x) {
+  half_bits_t f, denorm_magic;
+  uint32_t sign, o;
+  denorm_magic.u = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+  f.f = x;
+  sign = f.u & 0x80000000u;
+  f.u ^= sign;
+  if (f.u >= ((127u + 16u) << 23))         /* Inf or NaN - or overflow to Inf */
+    o = (f.u > (255u << 23)) ? 0x7e00 : 0x7c00;
+  else if (f.u < (113u << 23)) {           /* subnormal or zero */
+    f.f += denorm_magic.f;
+    o = f.u - denorm_magic.u;
+  }
+  else {
+    const uint32_t mant_odd = (f.u >> 13) & 1;
+    f.u += ((uint32_t)(15 - 127) << 23) + 0xfff;
+    f.u += mant_odd;
+    o = f.u >> 13;
+  }
+  return (unsigned short)( o | (sign >> 16) );
+}
+
+static float half_bf16_to_float(unsigned short h) {
+  half_bits_t o;
+  o.u = (uint32_t)h << 16;
+  return o.f;
+}
+
+static unsigned short half_float_to_bf16(float x) {
+  half_bits_t f;
+  f.f = x;
+  if ( (f.u & 0x7fffffffu) > 0x7f800000u )   /* NaN: keep it quiet, don't round */
+    return (unsigned short)( (f.u >> 16) | 0x0040 );
+  f.u += 0x7fffu + ( (f.u >> 16) & 1 );
+  return (unsigned short)(f.u >> 16);
+}
+
+#if defined(HALF_SSE2)
+/* float to BF16 in the lower 16 bits of each sign extended 32-bit lane - for _mm_packs_epi32() */
+static __m128i half_bf16_sse2(__m128 x) {
+  const __m128i u = _mm_castps_si128(x);
+  const __m128i nan = _mm_castps_si128(_mm_cmpunord_ps(x, x));
+  const __m128i rnd = _mm_add_epi32( _mm_set1_epi32(0x7fff), _mm_and_si128(_mm_srli_epi32(u, 16), _mm_set1_epi32(1)) );
+  const __m128i r = _mm_add_epi32(u, rnd);
+  const __m128i q = _mm_or_si128(u, _mm_set1_epi32(0x00400000));
+  return _mm_srai_epi32( _mm_or_si128( _mm_and_si128(nan, q), _mm_andnot_si128(nan, r) ), 16 );
+}
+#endif
+
+#if defined(HALF_NEON)
+static uint16x4_t half_bf16_neon(float32x4_t x) {
+  const uint32x4_t u = vreinterpretq_u32_f32(x);
+  const uint32x4_t nan = vmvnq_u32(vceqq_f32(x, x));
+  const uint32x4_t rnd = vaddq_u32( vdupq_n_u32(0x7fff), vandq_u32(vshrq_n_u32(u, 16), vdupq_n_u32(1)) );
+  const uint32x4_t r = vaddq_u32(u, rnd);
+  const uint32x4_t q = vorrq_u32(u, vdupq_n_u32(0x00400000));
+  return vshrn_n_u32( vbslq_u32(nan, q, r), 16 );
+}
+#endif
+
+
+static void half_to_float_n(pffft_half_t format, const unsigned short *in, float *out, int n) {
+  int i = 0;
+  if (format == PFFFT_HALF_FP16) {
+#if defined(HALF_F16C)
+    for (; i + 8 <= n; i += 8)
+      _mm256_storeu_ps( out + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(in + i))) );
+#elif defined(HALF_NEON)
+    for (; i + 4 <= n; i += 4)
+      vst1q_f32( out + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(in + i))) );
+#endif
+    for (; i < n; ++i)
+      out[i] = half_fp16_to_float(in[i]);
+  }
+  else {
+#if defined(HALF_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8) {
+      const __m128i h = _mm_loadu_si128((const __m128i*)(in + i));
+      _mm_storeu_ps( out + i, _mm_castsi128_ps(_mm_unpacklo_epi16(zero, h)) );
+      _mm_storeu_ps( out + i + 4, _mm_castsi128_ps(_mm_unpackhi_epi16(zero, h)) );
+    }
+#elif defined(HALF_NEON)
+    for (; i + 4 <= n; i += 4)
+      vst1q_f32( out + i, vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(in + i), 16)) );
+#endif
+    for (; i < n; ++i)
+      out[i] = half_bf16_to_float(in[i]);
+  }
+}
+
+static void float_to_half_n(pffft_half_t format, const float *in, unsigned short *out, int n) {
+  int i = 0;
+  if (format == PFFFT_HALF_FP16) {
+#if defined(HALF_F16C)
+    for (; i + 8 <= n; i += 8)
+      _mm_storeu_si128( (__m128i*)(out + i), _mm256_cvtps_ph(_mm256_loadu_ps(in + i), 0 /* nearest even */) );
+#elif defined(HALF_NEON)
+    for (; i + 4 <= n; i += 4)
+      vst1_u16( out + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(in + i))) );
+#endif
+    for (; i < n; ++i)
+      out[i] = half_float_to_fp16(in[i]);
+  }
+  else {
+#if defined(HALF_SSE2)
+    for (; i + 8 <= n; i += 8)
+      _mm_storeu_si128( (__m128i*)(out + i), _mm_packs_epi32(half_bf16_sse2(_mm_loadu_ps(in + i)),
+                                                             half_bf16_sse2(_mm_loadu_ps(in + i + 4))) );
+#elif defined(HALF_NEON)
+    for (; i + 4 <= n; i += 4)
+      vst1_u16( out + i, half_bf16_neon(vld1q_f32(in + i)) );
+#endif
+    for (; i < n; ++i)
+      out[i] = half_float_to_bf16(in[i]);
+  }
+}
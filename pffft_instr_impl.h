@@ -0,0 +1,92 @@
+/* optional instrumentation of the hot paths: counters of calls, samples
+ * and cycles per setup, see pffft_get_instr_snapshot() in pffft.h.
+ *
+ * compiled in with PFFFT_ENABLE_INSTRUMENTATION, e.g. with the CMake option
+ * PFFFT_USE_INSTRUMENTATION. without, all INSTR_*() macros are empty:
+ * there's neither a field in the setups nor any code in the hot paths.
+ *
+ * usage in a function of the hot path:
+ *   INSTR_BEGIN();
+ *   ... the work ...
+ *   INSTR_END(&s->instr.func[PFFFT_INSTR_TRANSFORM], samples);
+ *
+ * 'cycles' are the time stamp counter on x86 and the virtual counter on
+ * aarch64 - else nanoseconds. the counters are updated with relaxed atomic
+ * additions: one setup can be used from several threads at the same time.
+ *
+ * this file is only for library internal use: pffft_priv_impl.h and
+ * pffastconv_priv_impl.h include it. it requires pffft.h or pffft_double.h
+ */
+
+#if defined(PFFFT_ENABLE_INSTRUMENTATION)
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#else
+#  include <time.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  define INSTR_CYCLES()  ((unsigned long long)__rdtsc())
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+/* the builtin - as <x86intrin.h> clashes with the arch specific simd macros */
+#  define INSTR_CYCLES()  ((unsigned long long)__builtin_ia32_rdtsc())
+#elif defined(__GNUC__) && defined(__aarch64__)
+static unsigned long long instr_cycles(void) {
+  unsigned long long v;
+  __asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r"(v));
+  return v;
+}
+#  define INSTR_CYCLES()  instr_cycles()
+#elif defined(TIME_UTC)
+static unsigned long long instr_cycles(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+#  define INSTR_CYCLES()  instr_cycles()
+#else
+#  define INSTR_CYCLES()  ((unsigned long long)clock() * (1000000000ULL / CLOCKS_PER_SEC))
+#endif
+
+#if defined(_MSC_VER)
+#  define INSTR_ATOMIC_ADD(p, v)  _InterlockedExchangeAdd64((volatile __int64*)(p), (__int64)(v))
+#  define INSTR_ATOMIC_LOAD(p)    ((unsigned long long)_InterlockedOr64((volatile __int64*)(p), 0))
+#  define INSTR_ATOMIC_CLEAR(p)   _InterlockedExchange64((volatile __int64*)(p), 0)
+#elif defined(__GNUC__)
+#  define INSTR_ATOMIC_ADD(p, v)  __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+#  define INSTR_ATOMIC_LOAD(p)    __atomic_load_n((p), __ATOMIC_RELAXED)
+#  define INSTR_ATOMIC_CLEAR(p)   __atomic_store_n((p), 0ULL, __ATOMIC_RELAXED)
+#else
+#  define INSTR_ATOMIC_ADD(p, v)  (*(p) += (v))
+#  define INSTR_ATOMIC_LOAD(p)    (*(p))
+#  define INSTR_ATOMIC_CLEAR(p)   (*(p) = 0)
+#endif
+
+static void instr_count(pffft_instr_counter_t *c, unsigned long long samples, unsigned long long cycles) {
+  INSTR_ATOMIC_ADD(&c->calls, 1ULL);
+  INSTR_ATOMIC_ADD(&c->samples, samples);
+  INSTR_ATOMIC_ADD(&c->cycles, cycles);
+}
+
+static void instr_read(const pffft_instr_counter_t *c, pffft_instr_counter_t *out) {
+  out->calls = INSTR_ATOMIC_LOAD(&c->calls);
+  out->samples = INSTR_ATOMIC_LOAD(&c->samples);
+  out->cycles = INSTR_ATOMIC_LOAD(&c->cycles);
+}
+
+static void instr_clear(pffft_instr_counter_t *c) {
+  INSTR_ATOMIC_CLEAR(&c->calls);
+  INSTR_ATOMIC_CLEAR(&c->samples);
+  INSTR_ATOMIC_CLEAR(&c->cycles);
+}
+
+#define INSTR_BEGIN()                   const unsigned long long instr_t0 = INSTR_CYCLES()
+#define INSTR_END(counter, samples)     instr_count((counter), (unsigned long long)(samples), INSTR_CYCLES() - instr_t0)
+
+#else
+
+#define INSTR_BEGIN()                   ((void)0)
+#define INSTR_END(counter, samples)     ((void)0)
+
+#endif
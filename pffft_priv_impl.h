@@ -58,6 +58,11 @@
  * it's only for library internal use
  */
 
+#include "pffft_instr_impl.h"
+#if defined(FUNC_TRANSFORM_HALF)
+#include "pffft_half_impl.h"
+#endif
+
 
 /* define own constants required to turn off g++ extensions .. */
 #ifndef M_PI
@@ -87,6 +92,11 @@ int FUNC_MIN_FFT_SIZE(pffft_transform_t transform) {
 int FUNC_IS_VALID_SIZE(int N, pffft_transform_t cplx) {
   const int N_min = FUNC_MIN_FFT_SIZE(cplx);
   int R = N;
+  if (N < 2)  /* without SIMD, N_min is 1: no passes - no native transform */
+    return 0;
+  while (R >= 13*N_min && (R % 13) == 0)  R /= 13;
+  while (R >= 11*N_min && (R % 11) == 0)  R /= 11;
+  while (R >= 7*N_min && (R % 7) == 0)  R /= 7;
   while (R >= 5*N_min && (R % 5) == 0)  R /= 5;
   while (R >= 3*N_min && (R % 3) == 0)  R /= 3;
   while (R >= 2*N_min && (R % 2) == 0)  R /= 2;
@@ -147,12 +157,12 @@ static NEVER_INLINE(void) passf2_ps(int ido, int l1, const v4sf *cc, v4sf *ch, c
 static NEVER_INLINE(void) passf3_ps(int ido, int l1, const v4sf *cc, v4sf *ch,
                                     const float *wa1, const float *wa2, float fsign) {
   static const float taur = -0.5f;
-  float taui = 0.866025403784439f*fsign;
+  float taui = 0.866025403784439*fsign;
   int i, k;
   v4sf tr2, ti2, cr2, ci2, cr3, ci3, dr2, di2, dr3, di3;
   int l1ido = l1*ido;
   float wr1, wi1, wr2, wi2;
-  assert(ido > 2);
+  assert(ido >= 2);
   for (k=0; k< l1ido; k += ido, cc+= 3*ido, ch +=ido) {
     for (i=0; i<ido-1; i+=2) {
       tr2 = VADD(cc[i+ido], cc[i+2*ido]);
@@ -252,10 +262,10 @@ static NEVER_INLINE(void) passf4_ps(int ido, int l1, const v4sf *cc, v4sf *ch,
 static NEVER_INLINE(void) passf5_ps(int ido, int l1, const v4sf *cc, v4sf *ch,
                                     const float *wa1, const float *wa2, 
                                     const float *wa3, const float *wa4, float fsign) {  
-  static const float tr11 = .309016994374947f;
-  const float ti11 = .951056516295154f*fsign;
-  static const float tr12 = -.809016994374947f;
-  const float ti12 = .587785252292473f*fsign;
+  static const float tr11 = .309016994374947;
+  const float ti11 = .951056516295154*fsign;
+  static const float tr12 = -.809016994374947;
+  const float ti12 = .587785252292473*fsign;
 
   /* Local variables */
   int i, k;
@@ -267,7 +277,7 @@ static NEVER_INLINE(void) passf5_ps(int ido, int l1, const v4sf *cc, v4sf *ch,
 #define cc_ref(a_1,a_2) cc[(a_2-1)*ido + a_1 + 1]
 #define ch_ref(a_1,a_3) ch[(a_3-1)*l1*ido + a_1 + 1]
 
-  assert(ido > 2);
+  assert(ido >= 2);
   for (k = 0; k < l1; ++k, cc += 5*ido, ch += ido) {
     for (i = 0; i < ido-1; i += 2) {
       ti5 = VSUB(cc_ref(i  , 2), cc_ref(i  , 5));
@@ -316,7 +326,188 @@ static NEVER_INLINE(void) passf5_ps(int ido, int l1, const v4sf *cc, v4sf *ch,
 #undef cc_ref
 }
 
-static NEVER_INLINE(void) radf2_ps(int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT ch, const float *wa1) {
+/*
+  8-point complex dft of xr[], xi[] - in-place, as two 4-point dfts of the
+  even and odd samples. fsign = -1 for the forward, +1 for the backward dft
+*/
+static ALWAYS_INLINE(void) cdft8_ps(v4sf *xr, v4sf *xi, float fsign) {
+  static const float hsqt2 = (float)0.7071067811865475;
+  v4sf fs = LD_PS1(fsign), c = LD_PS1(hsqt2);
+  v4sf er[4], ei[4], or_[4], oi[4];
+  v4sf tr, ti;
+  int j;
+  for (j = 0; j < 2; ++j) {
+    /* 4-point dft of x[j], x[j+2], x[j+4], x[j+6] */
+    v4sf *yr = (j ? or_ : er), *yi = (j ? oi : ei);
+    v4sf t0r = VADD(xr[j], xr[j+4]), t0i = VADD(xi[j], xi[j+4]);
+    v4sf t1r = VSUB(xr[j], xr[j+4]), t1i = VSUB(xi[j], xi[j+4]);
+    v4sf t2r = VADD(xr[j+2], xr[j+6]), t2i = VADD(xi[j+2], xi[j+6]);
+    v4sf sui = VMUL(fs, VSUB(xi[j+2], xi[j+6])), sur = VMUL(fs, VSUB(xr[j+2], xr[j+6]));
+    yr[0] = VADD(t0r, t2r); yi[0] = VADD(t0i, t2i);
+    yr[2] = VSUB(t0r, t2r); yi[2] = VSUB(t0i, t2i);
+    yr[1] = VSUB(t1r, sui); yi[1] = VADD(t1i, sur);
+    yr[3] = VADD(t1r, sui); yi[3] = VSUB(t1i, sur);
+  }
+  /* odd part times w^q, w = exp(fsign*i*2pi/8) */
+  tr = VMUL(c, VSUB(or_[1], VMUL(fs, oi[1])));
+  ti = VMUL(c, VADD(oi[1], VMUL(fs, or_[1])));
+  or_[1] = tr; oi[1] = ti;
+  tr = VMUL(fs, oi[2]);
+  oi[2] = VMUL(fs, or_[2]);
+  or_[2] = VSUB(VZERO(), tr);
+  tr = VMUL(c, VADD(or_[3], VMUL(fs, oi[3])));
+  ti = VMUL(c, VSUB(VMUL(fs, or_[3]), oi[3]));
+  or_[3] = VSUB(VZERO(), tr); oi[3] = ti;
+  for (j = 0; j < 4; ++j) {
+    xr[j]   = VADD(er[j], or_[j]); xi[j]   = VADD(ei[j], oi[j]);
+    xr[j+4] = VSUB(er[j], or_[j]); xi[j+4] = VSUB(ei[j], oi[j]);
+  }
+}
+
+static ALWAYS_INLINE(void) passf8_ps_inl(int ido, int l1, const v4sf *cc, v4sf *ch,
+                                         const float *wa, float fsign) {
+  int i, j, k;
+  int l1ido = l1*ido;
+  v4sf xr[8], xi[8];
+  for (k=0; k < l1ido; k += ido, ch += ido, cc += 8*ido) {
+    for (i=0; i<ido-1; i+=2) {
+      for (j=0; j < 8; ++j) {
+        xr[j] = cc[i + j*ido + 0];
+        xi[j] = cc[i + j*ido + 1];
+      }
+      cdft8_ps(xr, xi, fsign);
+      ch[i] = xr[0];
+      ch[i + 1] = xi[0];
+      for (j=1; j < 8; ++j) {
+        if (ido > 2) {
+          float wr = wa[(j-1)*ido + i], wi = fsign*wa[(j-1)*ido + i + 1];
+          VCPLXMUL(xr[j], xi[j], LD_PS1(wr), LD_PS1(wi));
+        }
+        ch[i + j*l1ido] = xr[j];
+        ch[i + j*l1ido + 1] = xi[j];
+      }
+    }
+  }
+}
+
+/*
+  passf8 and passb8 has been merged here, fsign = -1 for passf8, +1 for passb8.
+  the 7 twiddle tables are at wa + (j-1)*ido, j = 1 .. 7. the sign is made
+  a compile time constant, which saves multiplications in cdft8_ps()
+*/
+static NEVER_INLINE(void) passf8_ps(int ido, int l1, const v4sf *cc, v4sf *ch,
+                                    const float *wa, float fsign) {
+  if (fsign < 0)
+    passf8_ps_inl(ido, l1, cc, ch, wa, -1.f);
+  else
+    passf8_ps_inl(ido, l1, cc, ch, wa, 1.f);
+} /* passf8 */
+
+/* cos(2*pi*j/ip) and sin(2*pi*j/ip), j = 0 .. ip-1: the constants of the
+   radix-7, -11 and -13 passes */
+#define RADP_IDX(ip)  ( (ip) == 7 ? 0 : (ip) == 11 ? 1 : 2 )
+static const float radp_cos[3][13] = {
+  { 1.0, 0.6234898018587336, -0.2225209339563143, -0.9009688679024190, -0.9009688679024191,
+    -0.2225209339563146, 0.6234898018587334 },
+  { 1.0, 0.8412535328311812, 0.4154150130018864, -0.1423148382732850, -0.6548607339452850,
+    -0.9594929736144974, -0.9594929736144975, -0.6548607339452852, -0.1423148382732852,
+    0.4154150130018860, 0.8412535328311812 },
+  { 1.0, 0.8854560256532099, 0.5680647467311559, 0.1205366802553230, -0.3546048870425355,
+    -0.7485107481711012, -0.9709418174260520, -0.9709418174260521, -0.7485107481711013,
+    -0.3546048870425359, 0.1205366802553232, 0.5680647467311548, 0.8854560256532100 } };
+static const float radp_sin[3][13] = {
+  { 0.0, 0.7818314824680298, 0.9749279121818236, 0.4338837391175582, -0.4338837391175580,
+    -0.9749279121818236, -0.7818314824680299 },
+  { 0.0, 0.5406408174555976, 0.9096319953545183, 0.9898214418809328, 0.7557495743542583,
+    0.2817325568414297, -0.2817325568414294, -0.7557495743542582, -0.9898214418809327,
+    -0.9096319953545186, -0.5406408174555974 },
+  { 0.0, 0.4647231720437685, 0.8229838658936564, 0.9927088740980540, 0.9350162426854148,
+    0.6631226582407952, 0.2393156642875577, -0.2393156642875574, -0.6631226582407950,
+    -0.9350162426854147, -0.9927088740980540, -0.8229838658936570, -0.4647231720437684 } };
+
+/*
+  complex dft of the odd prime length ip (7, 11 or 13) of xr[], xi[] - in-place.
+  the samples j and ip-j are combined to sums and differences: these need
+  real multiplications with the cosines and sines, only.
+  fsign = -1 for the forward, +1 for the backward dft
+*/
+static ALWAYS_INLINE(void) cdftp_ps(const int ip, v4sf *xr, v4sf *xi, float fsign) {
+  const float *tc = radp_cos[RADP_IDX(ip)], *ts = radp_sin[RADP_IDX(ip)];
+  v4sf fs = LD_PS1(fsign);
+  v4sf sr[6], si[6], dr[6], di[6];
+  v4sf y0r = xr[0], y0i = xi[0];
+  int j, q;
+  for (j = 1; 2*j < ip; ++j) {
+    sr[j-1] = VADD(xr[j], xr[ip-j]); si[j-1] = VADD(xi[j], xi[ip-j]);
+    dr[j-1] = VMUL(fs, VSUB(xr[j], xr[ip-j])); di[j-1] = VMUL(fs, VSUB(xi[j], xi[ip-j]));
+    y0r = VADD(y0r, sr[j-1]); y0i = VADD(y0i, si[j-1]);
+  }
+  for (q = 1; 2*q < ip; ++q) {
+    /* y[q] = a + i*b, y[ip-q] = a - i*b */
+    v4sf ar = xr[0], ai = xi[0], br = VZERO(), bi = VZERO();
+    for (j = 1; 2*j < ip; ++j) {
+      const int t = (j*q) % ip;
+      ar = VMADD(LD_PS1(tc[t]), sr[j-1], ar); ai = VMADD(LD_PS1(tc[t]), si[j-1], ai);
+      br = VMADD(LD_PS1(ts[t]), dr[j-1], br); bi = VMADD(LD_PS1(ts[t]), di[j-1], bi);
+    }
+    xr[q]    = VSUB(ar, bi); xi[q]    = VADD(ai, br);
+    xr[ip-q] = VADD(ar, bi); xi[ip-q] = VSUB(ai, br);
+  }
+  xr[0] = y0r; xi[0] = y0i;
+}
+
+static ALWAYS_INLINE(void) passfp_ps_inl(const int ip, int ido, int l1, const v4sf *cc, v4sf *ch,
+                                         const float *wa, float fsign) {
+  int i, j, k;
+  int l1ido = l1*ido;
+  v4sf xr[13], xi[13];
+  for (k=0; k < l1ido; k += ido, ch += ido, cc += ip*ido) {
+    for (i=0; i<ido-1; i+=2) {
+      for (j=0; j < ip; ++j) {
+        xr[j] = cc[i + j*ido + 0];
+        xi[j] = cc[i + j*ido + 1];
+      }
+      cdftp_ps(ip, xr, xi, fsign);
+      ch[i] = xr[0];
+      ch[i + 1] = xi[0];
+      for (j=1; j < ip; ++j) {
+        if (ido > 2) {
+          float wr = wa[(j-1)*ido + i], wi = fsign*wa[(j-1)*ido + i + 1];
+          VCPLXMUL(xr[j], xi[j], LD_PS1(wr), LD_PS1(wi));
+        }
+        ch[i + j*l1ido] = xr[j];
+        ch[i + j*l1ido + 1] = xi[j];
+      }
+    }
+  }
+}
+
+/*
+  passf7/11/13 and passb7/11/13 have been merged here, fsign = -1 for the
+  forward, +1 for the backward pass. the twiddle tables are at
+  wa + (j-1)*ido, j = 1 .. ip-1 - like for passf8_ps()
+*/
+static NEVER_INLINE(void) passfp_ps(int ip, int ido, int l1, const v4sf *cc, v4sf *ch,
+                                    const float *wa, float fsign) {
+  switch (ip) {
+    case 7:
+      if (fsign < 0) passfp_ps_inl(7, ido, l1, cc, ch, wa, -1.f);
+      else           passfp_ps_inl(7, ido, l1, cc, ch, wa, 1.f);
+      break;
+    case 11:
+      if (fsign < 0) passfp_ps_inl(11, ido, l1, cc, ch, wa, -1.f);
+      else           passfp_ps_inl(11, ido, l1, cc, ch, wa, 1.f);
+      break;
+    case 13:
+      if (fsign < 0) passfp_ps_inl(13, ido, l1, cc, ch, wa, -1.f);
+      else           passfp_ps_inl(13, ido, l1, cc, ch, wa, 1.f);
+      break;
+    default:
+      assert(0);
+  }
+} /* passfp */
+
+static ALWAYS_INLINE(void) radf2_ps_inl(int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT ch, const float *wa1) {
   static const float minus_one = -1.f;
   int i, k, l1ido = l1*ido;
   for (k=0; k < l1ido; k += ido) {
@@ -345,8 +536,12 @@ static NEVER_INLINE(void) radf2_ps(int ido, int l1, const v4sf * RESTRICT cc, v4
   }
 } /* radf2 */
 
+static NEVER_INLINE(void) radf2_ps(int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT ch, const float *wa1) {
+  radf2_ps_inl(ido, l1, cc, ch, wa1);
+}
+
 
-static NEVER_INLINE(void) radb2_ps(int ido, int l1, const v4sf *cc, v4sf *ch, const float *wa1) {
+static ALWAYS_INLINE(void) radb2_ps_inl(int ido, int l1, const v4sf *cc, v4sf *ch, const float *wa1) {
   static const float minus_two=-2;
   int i, k, l1ido = l1*ido;
   v4sf a,b,c,d, tr2, ti2;
@@ -379,10 +574,14 @@ static NEVER_INLINE(void) radb2_ps(int ido, int l1, const v4sf *cc, v4sf *ch, co
   }
 } /* radb2 */
 
+static NEVER_INLINE(void) radb2_ps(int ido, int l1, const v4sf *cc, v4sf *ch, const float *wa1) {
+  radb2_ps_inl(ido, l1, cc, ch, wa1);
+}
+
 static void radf3_ps(int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT ch,
                      const float *wa1, const float *wa2) {
   static const float taur = -0.5f;
-  static const float taui = 0.866025403784439f;
+  static const float taui = 0.866025403784439;
   int i, k, ic;
   v4sf ci2, di2, di3, cr2, dr2, dr3, ti2, ti3, tr2, tr3, wr1, wi1, wr2, wi2;
   for (k=0; k<l1; k++) {
@@ -424,8 +623,8 @@ static void radb3_ps(int ido, int l1, const v4sf *RESTRICT cc, v4sf *RESTRICT ch
                      const float *wa1, const float *wa2)
 {
   static const float taur = -0.5f;
-  static const float taui = 0.866025403784439f;
-  static const float taui_2 = 0.866025403784439f*2;
+  static const float taui = 0.866025403784439;
+  static const float taui_2 = 0.866025403784439*2;
   int i, k, ic;
   v4sf ci2, ci3, di2, di3, cr2, cr3, dr2, dr3, ti2, tr2;
   for (k=0; k<l1; k++) {
@@ -462,8 +661,8 @@ static void radb3_ps(int ido, int l1, const v4sf *RESTRICT cc, v4sf *RESTRICT ch
   }
 } /* radb3 */
 
-static NEVER_INLINE(void) radf4_ps(int ido, int l1, const v4sf *RESTRICT cc, v4sf * RESTRICT ch,
-                                   const float * RESTRICT wa1, const float * RESTRICT wa2, const float * RESTRICT wa3)
+static ALWAYS_INLINE(void) radf4_ps_inl(int ido, int l1, const v4sf *RESTRICT cc, v4sf * RESTRICT ch,
+                                        const float * RESTRICT wa1, const float * RESTRICT wa2, const float * RESTRICT wa3)
 {
   static const float minus_hsqt2 = (float)-0.7071067811865475;
   int i, k, l1ido = l1*ido;
@@ -545,9 +744,14 @@ static NEVER_INLINE(void) radf4_ps(int ido, int l1, const v4sf *RESTRICT cc, v4s
   }
 } /* radf4 */
 
+static NEVER_INLINE(void) radf4_ps(int ido, int l1, const v4sf *RESTRICT cc, v4sf * RESTRICT ch,
+                                   const float * RESTRICT wa1, const float * RESTRICT wa2, const float * RESTRICT wa3) {
+  radf4_ps_inl(ido, l1, cc, ch, wa1, wa2, wa3);
+}
+
 
-static NEVER_INLINE(void) radb4_ps(int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT ch,
-                                   const float * RESTRICT wa1, const float * RESTRICT wa2, const float *RESTRICT wa3)
+static ALWAYS_INLINE(void) radb4_ps_inl(int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT ch,
+                                        const float * RESTRICT wa1, const float * RESTRICT wa2, const float *RESTRICT wa3)
 {
   static const float minus_sqrt2 = (float)-1.414213562373095;
   static const float two = 2.f;
@@ -626,13 +830,18 @@ static NEVER_INLINE(void) radb4_ps(int ido, int l1, const v4sf * RESTRICT cc, v4
   }
 } /* radb4 */
 
+static NEVER_INLINE(void) radb4_ps(int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT ch,
+                                   const float * RESTRICT wa1, const float * RESTRICT wa2, const float *RESTRICT wa3) {
+  radb4_ps_inl(ido, l1, cc, ch, wa1, wa2, wa3);
+}
+
 static void radf5_ps(int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT ch, 
                      const float *wa1, const float *wa2, const float *wa3, const float *wa4)
 {
-  static const float tr11 = .309016994374947f;
-  static const float ti11 = .951056516295154f;
-  static const float tr12 = -.809016994374947f;
-  static const float ti12 = .587785252292473f;
+  static const float tr11 = .309016994374947;
+  static const float ti11 = .951056516295154;
+  static const float tr12 = -.809016994374947;
+  static const float ti12 = .587785252292473;
 
   /* System generated locals */
   int cc_offset, ch_offset;
@@ -716,10 +925,10 @@ static void radf5_ps(int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT
 static void radb5_ps(int ido, int l1, const v4sf *RESTRICT cc, v4sf *RESTRICT ch, 
                   const float *wa1, const float *wa2, const float *wa3, const float *wa4)
 {
-  static const float tr11 = .309016994374947f;
-  static const float ti11 = .951056516295154f;
-  static const float tr12 = -.809016994374947f;
-  static const float ti12 = .587785252292473f;
+  static const float tr11 = .309016994374947;
+  static const float ti11 = .951056516295154;
+  static const float tr12 = -.809016994374947;
+  static const float ti12 = .587785252292473;
 
   int cc_offset, ch_offset;
 
@@ -802,11 +1011,295 @@ static void radb5_ps(int ido, int l1, const v4sf *RESTRICT cc, v4sf *RESTRICT ch
 #undef ch_ref
 } /* radb5 */
 
-static NEVER_INLINE(v4sf *) rfftf1_ps(int n, const v4sf *input_readonly, v4sf *work1, v4sf *work2, 
+/* cos(j*pi/8) and sin(j*pi/8): twiddles of the elements at ido-1 in radf8 / radb8 */
+static const float rad8_cos[8] = { 1.0, 0.9238795325112867, 0.7071067811865476, 0.3826834323650898,
+                                   0.0, -0.3826834323650898, -0.7071067811865476, -0.9238795325112867 };
+static const float rad8_sin[8] = { 0.0, 0.3826834323650898, 0.7071067811865476, 0.9238795325112867,
+                                   1.0, 0.9238795325112867, 0.7071067811865476, 0.3826834323650898 };
+
+/* the 7 twiddle tables are at wa + (j-1)*ido, j = 1 .. 7 */
+static NEVER_INLINE(void) radf8_ps(int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT ch,
+                                   const float *wa) {
+  static const float hsqt2 = (float)0.7071067811865475;
+  static const float minus_one = -1.f;
+  static const float one = 1.f;
+  int i, j, k, l1ido = l1*ido;
+  v4sf xr[8], xi[8];
+  for (k=0; k < l1ido; k += ido) {
+    /* real inputs: two real 4-point dfts of the even and odd samples */
+    const v4sf *x = cc + k;
+    v4sf *y = ch + 8*k;
+    v4sf t0 = VADD(x[0], x[4*l1ido]), t1 = VSUB(x[0], x[4*l1ido]);
+    v4sf t2 = VADD(x[2*l1ido], x[6*l1ido]), u = VSUB(x[2*l1ido], x[6*l1ido]);
+    v4sf p0 = VADD(x[l1ido], x[5*l1ido]), p1 = VSUB(x[l1ido], x[5*l1ido]);
+    v4sf p2 = VADD(x[3*l1ido], x[7*l1ido]), v = VSUB(x[3*l1ido], x[7*l1ido]);
+    v4sf a = SVMUL(hsqt2, VSUB(p1, v)), b = SVMUL(hsqt2, VADD(p1, v));
+    v4sf e0 = VADD(t0, t2), o0 = VADD(p0, p2);
+    y[0]         = VADD(e0, o0);
+    y[2*ido - 1] = VADD(t1, a);
+    y[2*ido]     = SVMUL(minus_one, VADD(u, b));
+    y[4*ido - 1] = VSUB(t0, t2);
+    y[4*ido]     = VSUB(p2, p0);
+    y[6*ido - 1] = VSUB(t1, a);
+    y[6*ido]     = VSUB(u, b);
+    y[8*ido - 1] = VSUB(e0, o0);
+  }
+  if (ido < 2) return;
+  if (ido != 2) {
+    for (k=0; k < l1ido; k += ido) {
+      const v4sf *x = cc + k;
+      v4sf *y = ch + 8*k;
+      for (i=2; i<ido; i+=2) {
+        xr[0] = x[i - 1];
+        xi[0] = x[i];
+        for (j=1; j < 8; ++j) {
+          xr[j] = x[i - 1 + j*l1ido];
+          xi[j] = x[i + j*l1ido];
+          VCPLXMULCONJ(xr[j], xi[j], LD_PS1(wa[(j-1)*ido + i - 2]), LD_PS1(wa[(j-1)*ido + i - 1]));
+        }
+        cdft8_ps(xr, xi, minus_one);
+        /* the upper half goes conjugated to the mirrored frequencies */
+        for (j=0; j < 4; ++j) {
+          y[i - 1 + 2*j*ido]     = xr[j];
+          y[i + 2*j*ido]         = xi[j];
+          y[2*(4-j)*ido - i - 1] = xr[j+4];
+          y[2*(4-j)*ido - i]     = SVMUL(minus_one, xi[j+4]);
+        }
+      }
+    }
+    if (ido % 2 == 1) return;
+  }
+  for (k=0; k < l1ido; k += ido) {
+    const v4sf *x = cc + k + ido-1;
+    v4sf *y = ch + 8*k + ido-1;
+    /* the dft of x[j]*exp(i*j*pi/8) is the conjugate of the wanted one */
+    for (j=0; j < 8; ++j) {
+      xr[j] = SVMUL(rad8_cos[j], x[j*l1ido]);
+      xi[j] = SVMUL(rad8_sin[j], x[j*l1ido]);
+    }
+    cdft8_ps(xr, xi, one);
+    for (j=0; j < 4; ++j) {
+      y[2*j*ido]     = xr[j];
+      y[2*j*ido + 1] = SVMUL(minus_one, xi[j]);
+    }
+  }
+} /* radf8 */
+
+
+static NEVER_INLINE(void) radb8_ps(int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT ch,
+                                   const float *wa) {
+  static const float sqrt2 = (float)1.414213562373095;
+  static const float two = 2.f;
+  static const float minus_one = -1.f;
+  static const float one = 1.f;
+  int i, j, k, l1ido = l1*ido;
+  v4sf xr[8], xi[8];
+  for (k=0; k < l1ido; k += ido) {
+    /* real outputs: inverse dfts of the sums and of the differences of
+       the lower and upper half */
+    const v4sf *y = cc + 8*k;
+    v4sf *x = ch + k;
+    v4sf y0 = y[0], y4 = y[8*ido - 1];
+    v4sf y1r = y[2*ido - 1], y1i = y[2*ido];
+    v4sf y3r = y[6*ido - 1], y3i = y[6*ido];
+    v4sf a0 = VADD(y0, y4), a2 = SVMUL(two, y[4*ido - 1]);
+    v4sf a1r = SVMUL(two, VADD(y1r, y3r)), a1i = SVMUL(two, VSUB(y1i, y3i));
+    v4sf b0 = VSUB(y0, y4), b2 = SVMUL(two, y[4*ido]);
+    v4sf dr = VSUB(y1r, y3r), di = VADD(y1i, y3i);
+    v4sf b1r = SVMUL(sqrt2, VSUB(dr, di)), b1i = SVMUL(sqrt2, VADD(dr, di));
+    v4sf e = VADD(a0, a2), f = VSUB(a0, a2);
+    v4sf g = VSUB(b0, b2), h = VADD(b0, b2);
+    x[0]       = VADD(e, a1r);
+    x[2*l1ido] = VSUB(f, a1i);
+    x[4*l1ido] = VSUB(e, a1r);
+    x[6*l1ido] = VADD(f, a1i);
+    x[1*l1ido] = VADD(g, b1r);
+    x[3*l1ido] = VSUB(h, b1i);
+    x[5*l1ido] = VSUB(g, b1r);
+    x[7*l1ido] = VADD(h, b1i);
+  }
+  if (ido < 2) return;
+  if (ido != 2) {
+    for (k = 0; k < l1ido; k += ido) {
+      const v4sf *y = cc + 8*k;
+      v4sf *x = ch + k;
+      for (i = 2; i < ido; i += 2) {
+        for (j=0; j < 4; ++j) {
+          xr[j]   = y[i - 1 + 2*j*ido];
+          xi[j]   = y[i + 2*j*ido];
+          xr[j+4] = y[2*(4-j)*ido - i - 1];
+          xi[j+4] = SVMUL(minus_one, y[2*(4-j)*ido - i]);
+        }
+        cdft8_ps(xr, xi, one);
+        x[i - 1] = xr[0];
+        x[i]     = xi[0];
+        for (j=1; j < 8; ++j) {
+          VCPLXMUL(xr[j], xi[j], LD_PS1(wa[(j-1)*ido + i - 2]), LD_PS1(wa[(j-1)*ido + i - 1]));
+          x[i - 1 + j*l1ido] = xr[j];
+          x[i + j*l1ido]     = xi[j];
+        }
+      }
+    }
+    if (ido % 2 == 1) return;
+  }
+  for (k = 0; k < l1ido; k += ido) {
+    const v4sf *y = cc + 8*k + ido-1;
+    v4sf *x = ch + k + ido-1;
+    for (j=0; j < 4; ++j) {
+      xr[j]   = y[2*j*ido];
+      xi[j]   = y[2*j*ido + 1];
+      xr[7-j] = xr[j];
+      xi[7-j] = SVMUL(minus_one, xi[j]);
+    }
+    cdft8_ps(xr, xi, one);
+    for (j=0; j < 8; ++j)
+      x[j*l1ido] = VSUB(SVMUL(rad8_cos[j], xr[j]), SVMUL(rad8_sin[j], xi[j]));
+  }
+} /* radb8 */
+
+/* real radix-7, -11 and -13 passes. the odd factors are at the end of
+   ifac[], see rffti1_ps(): ido is the product of the factors behind - it's
+   odd and there is no element at the Nyquist frequency */
+static ALWAYS_INLINE(void) radfp_ps_inl(const int ip, int ido, int l1, const v4sf * RESTRICT cc,
+                                        v4sf * RESTRICT ch, const float *wa) {
+  static const float minus_one = -1.f;
+  const float *tc = radp_cos[RADP_IDX(ip)], *ts = radp_sin[RADP_IDX(ip)];
+  int i, j, k, q, l1ido = l1*ido;
+  v4sf xr[13], xi[13];
+  assert(ido % 2 == 1);
+  for (k=0; k < l1ido; k += ido) {
+    /* real inputs: cosine and sine sums of the pairs j, ip-j */
+    const v4sf *x = cc + k;
+    v4sf *y = ch + ip*k;
+    v4sf s[6], d[6], y0 = x[0];
+    for (j=1; 2*j < ip; ++j) {
+      s[j-1] = VADD(x[j*l1ido], x[(ip-j)*l1ido]);
+      d[j-1] = VSUB(x[j*l1ido], x[(ip-j)*l1ido]);
+      y0 = VADD(y0, s[j-1]);
+    }
+    for (q=1; 2*q < ip; ++q) {
+      v4sf re = x[0], im = VZERO();
+      for (j=1; 2*j < ip; ++j) {
+        const int t = (j*q) % ip;
+        re = VMADD(LD_PS1(tc[t]), s[j-1], re);
+        im = VMADD(LD_PS1(ts[t]), d[j-1], im);
+      }
+      y[2*q*ido - 1] = re;
+      y[2*q*ido]     = SVMUL(minus_one, im);
+    }
+    y[0] = y0;
+  }
+  for (k=0; k < l1ido; k += ido) {
+    const v4sf *x = cc + k;
+    v4sf *y = ch + ip*k;
+    for (i=2; i<ido; i+=2) {
+      xr[0] = x[i - 1];
+      xi[0] = x[i];
+      for (j=1; j < ip; ++j) {
+        xr[j] = x[i - 1 + j*l1ido];
+        xi[j] = x[i + j*l1ido];
+        VCPLXMULCONJ(xr[j], xi[j], LD_PS1(wa[(j-1)*ido + i - 2]), LD_PS1(wa[(j-1)*ido + i - 1]));
+      }
+      cdftp_ps(ip, xr, xi, minus_one);
+      /* the upper half goes conjugated to the mirrored frequencies */
+      for (q=0; 2*q < ip; ++q) {
+        y[i - 1 + 2*q*ido] = xr[q];
+        y[i + 2*q*ido]     = xi[q];
+      }
+      for (q=1; 2*q < ip; ++q) {
+        y[2*q*ido - i - 1] = xr[ip-q];
+        y[2*q*ido - i]     = SVMUL(minus_one, xi[ip-q]);
+      }
+    }
+  }
+}
+
+static ALWAYS_INLINE(void) radbp_ps_inl(const int ip, int ido, int l1, const v4sf * RESTRICT cc,
+                                        v4sf * RESTRICT ch, const float *wa) {
+  static const float minus_one = -1.f;
+  static const float one = 1.f;
+  const float *tc = radp_cos[RADP_IDX(ip)], *ts = radp_sin[RADP_IDX(ip)];
+  int i, j, k, q, l1ido = l1*ido;
+  v4sf xr[13], xi[13];
+  assert(ido % 2 == 1);
+  for (k=0; k < l1ido; k += ido) {
+    /* real outputs: cosine and sine sums of the frequencies q */
+    const v4sf *y = cc + ip*k;
+    v4sf *x = ch + k;
+    v4sf r[6], m[6], x0 = y[0];
+    for (q=1; 2*q < ip; ++q) {
+      r[q-1] = VADD(y[2*q*ido - 1], y[2*q*ido - 1]);
+      m[q-1] = VADD(y[2*q*ido], y[2*q*ido]);
+      x0 = VADD(x0, r[q-1]);
+    }
+    for (j=1; 2*j < ip; ++j) {
+      v4sf a = y[0], b = VZERO();
+      for (q=1; 2*q < ip; ++q) {
+        const int t = (j*q) % ip;
+        a = VMADD(LD_PS1(tc[t]), r[q-1], a);
+        b = VMADD(LD_PS1(ts[t]), m[q-1], b);
+      }
+      x[j*l1ido]      = VSUB(a, b);
+      x[(ip-j)*l1ido] = VADD(a, b);
+    }
+    x[0] = x0;
+  }
+  for (k=0; k < l1ido; k += ido) {
+    const v4sf *y = cc + ip*k;
+    v4sf *x = ch + k;
+    for (i=2; i<ido; i+=2) {
+      for (q=0; 2*q < ip; ++q) {
+        xr[q] = y[i - 1 + 2*q*ido];
+        xi[q] = y[i + 2*q*ido];
+      }
+      for (q=1; 2*q < ip; ++q) {
+        xr[ip-q] = y[2*q*ido - i - 1];
+        xi[ip-q] = SVMUL(minus_one, y[2*q*ido - i]);
+      }
+      cdftp_ps(ip, xr, xi, one);
+      x[i - 1] = xr[0];
+      x[i]     = xi[0];
+      for (j=1; j < ip; ++j) {
+        VCPLXMUL(xr[j], xi[j], LD_PS1(wa[(j-1)*ido + i - 2]), LD_PS1(wa[(j-1)*ido + i - 1]));
+        x[i - 1 + j*l1ido] = xr[j];
+        x[i + j*l1ido]     = xi[j];
+      }
+    }
+  }
+}
+
+/* the ip-1 twiddle tables are at wa + (j-1)*ido, j = 1 .. ip-1 */
+static NEVER_INLINE(void) radfp_ps(int ip, int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT ch,
+                                   const float *wa) {
+  switch (ip) {
+    case 7:  radfp_ps_inl(7, ido, l1, cc, ch, wa); break;
+    case 11: radfp_ps_inl(11, ido, l1, cc, ch, wa); break;
+    case 13: radfp_ps_inl(13, ido, l1, cc, ch, wa); break;
+    default: assert(0);
+  }
+} /* radfp */
+
+static NEVER_INLINE(void) radbp_ps(int ip, int ido, int l1, const v4sf * RESTRICT cc, v4sf * RESTRICT ch,
+                                   const float *wa) {
+  switch (ip) {
+    case 7:  radbp_ps_inl(7, ido, l1, cc, ch, wa); break;
+    case 11: radbp_ps_inl(11, ido, l1, cc, ch, wa); break;
+    case 13: radbp_ps_inl(13, ido, l1, cc, ch, wa); break;
+    default: assert(0);
+  }
+} /* radbp */
+
+/* the fftpack drivers below process 'count' transforms with each pass,
+   reusing the pass's twiddle factors: transform c reads from / writes to
+   input_readonly + c*in_stride, work1 + c*stride1 and work2 + c*stride2
+   (strides in v4sf units). */
+static NEVER_INLINE(v4sf *) rfftf1_ps(int n, int count, const v4sf *input_readonly, int in_stride,
+                                      v4sf *work1, int stride1, v4sf *work2, int stride2,
                                       const float *wa, const int *ifac) {  
   v4sf *in  = (v4sf*)input_readonly;
   v4sf *out = (in == work2 ? work1 : work2);
-  int nf = ifac[1], k1;
+  int is = in_stride, os = (out == work1 ? stride1 : stride2);
+  int nf = ifac[1], k1, c;
   int l2 = n;
   int iw = n-1;
   assert(in != out && work1 != work2);
@@ -816,44 +1309,58 @@ static NEVER_INLINE(v4sf *) rfftf1_ps(int n, const v4sf *input_readonly, v4sf *w
     int l1 = l2 / ip;
     int ido = n / l2;
     iw -= (ip - 1)*ido;
-    switch (ip) {
-      case 5: {
-        int ix2 = iw + ido;
-        int ix3 = ix2 + ido;
-        int ix4 = ix3 + ido;
-        radf5_ps(ido, l1, in, out, &wa[iw], &wa[ix2], &wa[ix3], &wa[ix4]);
-      } break;
-      case 4: {
-        int ix2 = iw + ido;
-        int ix3 = ix2 + ido;
-        radf4_ps(ido, l1, in, out, &wa[iw], &wa[ix2], &wa[ix3]);
-      } break;
-      case 3: {
-        int ix2 = iw + ido;
-        radf3_ps(ido, l1, in, out, &wa[iw], &wa[ix2]);
-      } break;
-      case 2:
-        radf2_ps(ido, l1, in, out, &wa[iw]);
-        break;
-      default:
-        assert(0);
-        break;
+    for (c = 0; c < count; ++c) {
+      const v4sf *cin = in + c*is;
+      v4sf *cout = out + c*os;
+      switch (ip) {
+        case 13:
+        case 11:
+        case 7:
+          radfp_ps(ip, ido, l1, cin, cout, &wa[iw]);
+          break;
+        case 8:
+          radf8_ps(ido, l1, cin, cout, &wa[iw]);
+          break;
+        case 5: {
+          int ix2 = iw + ido;
+          int ix3 = ix2 + ido;
+          int ix4 = ix3 + ido;
+          radf5_ps(ido, l1, cin, cout, &wa[iw], &wa[ix2], &wa[ix3], &wa[ix4]);
+        } break;
+        case 4: {
+          int ix2 = iw + ido;
+          int ix3 = ix2 + ido;
+          radf4_ps(ido, l1, cin, cout, &wa[iw], &wa[ix2], &wa[ix3]);
+        } break;
+        case 3: {
+          int ix2 = iw + ido;
+          radf3_ps(ido, l1, cin, cout, &wa[iw], &wa[ix2]);
+        } break;
+        case 2:
+          radf2_ps(ido, l1, cin, cout, &wa[iw]);
+          break;
+        default:
+          assert(0);
+          break;
+      }
     }
     l2 = l1;
     if (out == work2) {
-      out = work1; in = work2;
+      out = work1; in = work2; os = stride1; is = stride2;
     } else {
-      out = work2; in = work1;
+      out = work2; in = work1; os = stride2; is = stride1;
     }
   }
   return in; /* this is in fact the output .. */
 } /* rfftf1 */
 
-static NEVER_INLINE(v4sf *) rfftb1_ps(int n, const v4sf *input_readonly, v4sf *work1, v4sf *work2, 
+static NEVER_INLINE(v4sf *) rfftb1_ps(int n, int count, const v4sf *input_readonly, int in_stride,
+                                      v4sf *work1, int stride1, v4sf *work2, int stride2,
                                       const float *wa, const int *ifac) {  
   v4sf *in  = (v4sf*)input_readonly;
   v4sf *out = (in == work2 ? work1 : work2);
-  int nf = ifac[1], k1;
+  int is = in_stride, os = (out == work1 ? stride1 : stride2);
+  int nf = ifac[1], k1, c;
   int l1 = 1;
   int iw = 0;
   assert(in != out);
@@ -861,41 +1368,60 @@ static NEVER_INLINE(v4sf *) rfftb1_ps(int n, const v4sf *input_readonly, v4sf *w
     int ip = ifac[k1 + 1];
     int l2 = ip*l1;
     int ido = n / l2;
-    switch (ip) {
-      case 5: {
-        int ix2 = iw + ido;
-        int ix3 = ix2 + ido;
-        int ix4 = ix3 + ido;
-        radb5_ps(ido, l1, in, out, &wa[iw], &wa[ix2], &wa[ix3], &wa[ix4]);
-      } break;
-      case 4: {
-        int ix2 = iw + ido;
-        int ix3 = ix2 + ido;
-        radb4_ps(ido, l1, in, out, &wa[iw], &wa[ix2], &wa[ix3]);
-      } break;
-      case 3: {
-        int ix2 = iw + ido;
-        radb3_ps(ido, l1, in, out, &wa[iw], &wa[ix2]);
-      } break;
-      case 2:
-        radb2_ps(ido, l1, in, out, &wa[iw]);
-        break;
-      default:
-        assert(0);
-        break;
+    for (c = 0; c < count; ++c) {
+      const v4sf *cin = in + c*is;
+      v4sf *cout = out + c*os;
+      switch (ip) {
+        case 13:
+        case 11:
+        case 7:
+          radbp_ps(ip, ido, l1, cin, cout, &wa[iw]);
+          break;
+        case 8:
+          radb8_ps(ido, l1, cin, cout, &wa[iw]);
+          break;
+        case 5: {
+          int ix2 = iw + ido;
+          int ix3 = ix2 + ido;
+          int ix4 = ix3 + ido;
+          radb5_ps(ido, l1, cin, cout, &wa[iw], &wa[ix2], &wa[ix3], &wa[ix4]);
+        } break;
+        case 4: {
+          int ix2 = iw + ido;
+          int ix3 = ix2 + ido;
+          radb4_ps(ido, l1, cin, cout, &wa[iw], &wa[ix2], &wa[ix3]);
+        } break;
+        case 3: {
+          int ix2 = iw + ido;
+          radb3_ps(ido, l1, cin, cout, &wa[iw], &wa[ix2]);
+        } break;
+        case 2:
+          radb2_ps(ido, l1, cin, cout, &wa[iw]);
+          break;
+        default:
+          assert(0);
+          break;
+      }
     }
     l1 = l2;
     iw += (ip - 1)*ido;
 
     if (out == work2) {
-      out = work1; in = work2;
+      out = work1; in = work2; os = stride1; is = stride2;
     } else {
-      out = work2; in = work1;
+      out = work2; in = work1; os = stride2; is = stride1;
     }
   }
   return in; /* this is in fact the output .. */
 }
 
+/* radix-8 passes need fewer round trips through memory, but more registers:
+   they are only preferred for transforms larger than the caches, having
+   'bytes' of data */
+#ifndef PFFFT_RADIX8_MIN_BYTES
+#define PFFFT_RADIX8_MIN_BYTES  (64 * 1024)
+#endif
+
 static int decompose(int n, int *ifac, const int *ntryh) {
   int nl = n, nf = 0, i, j = 0;
   for (j=0; ntryh[j]; ++j) {
@@ -925,10 +1451,11 @@ static int decompose(int n, int *ifac, const int *ntryh) {
 
 static void rffti1_ps(int n, float *wa, int *ifac)
 {
-  static const int ntryh[] = { 4,2,3,5,0 };
+  static const int ntryh[] = { 4,2,3,5,7,11,13,0 };
+  static const int ntryh8[] = { 8,4,2,3,5,7,11,13,0 };
   int k1, j, ii;
 
-  int nf = decompose(n,ifac,ntryh);
+  int nf = decompose(n,ifac,(n*sizeof(v4sf) >= PFFFT_RADIX8_MIN_BYTES ? ntryh8 : ntryh));
   float argh = (2*(float)M_PI) / n;
   int is = 0;
   int nfm1 = nf - 1;
@@ -958,10 +1485,11 @@ static void rffti1_ps(int n, float *wa, int *ifac)
 
 static void cffti1_ps(int n, float *wa, int *ifac)
 {
-  static const int ntryh[] = { 5,3,4,2,0 };
+  static const int ntryh[] = { 13,11,7,5,3,4,2,0 };
+  static const int ntryh8[] = { 13,11,7,5,3,8,4,2,0 };
   int k1, j, ii;
 
-  int nf = decompose(n,ifac,ntryh);
+  int nf = decompose(n,ifac,(2*n*sizeof(v4sf) >= PFFFT_RADIX8_MIN_BYTES ? ntryh8 : ntryh));
   float argh = (2*(float)M_PI) / n;
   int i = 1;
   int l1 = 1;
@@ -974,7 +1502,7 @@ static void cffti1_ps(int n, float *wa, int *ifac)
     int ipm = ip - 1;
     for (j=1; j<=ipm; j++) {
       float argld;
-      int i1 = i, fi = 0;
+      int fi = 0;
       wa[i-1] = 1;
       wa[i] = 0;
       ld += l1;
@@ -985,20 +1513,19 @@ static void cffti1_ps(int n, float *wa, int *ifac)
         wa[i-1] = FUNC_COS(fi*argld);
         wa[i] = FUNC_SIN(fi*argld);
       }
-      if (ip > 5) {
-        wa[i1-1] = wa[i-1];
-        wa[i1] = wa[i];
-      }
     }
     l1 = l2;
   }
 } /* cffti1 */
 
 
-static v4sf *cfftf1_ps(int n, const v4sf *input_readonly, v4sf *work1, v4sf *work2, const float *wa, const int *ifac, int isign) {
+static v4sf *cfftf1_ps(int n, int count, const v4sf *input_readonly, int in_stride,
+                       v4sf *work1, int stride1, v4sf *work2, int stride2,
+                       const float *wa, const int *ifac, int isign) {
   v4sf *in  = (v4sf*)input_readonly;
   v4sf *out = (in == work2 ? work1 : work2); 
-  int nf = ifac[1], k1;
+  int is = in_stride, os = (out == work1 ? stride1 : stride2);
+  int nf = ifac[1], k1, c;
   int l1 = 1;
   int iw = 0;
   assert(in != out && work1 != work2);
@@ -1007,40 +1534,157 @@ static v4sf *cfftf1_ps(int n, const v4sf *input_readonly, v4sf *work1, v4sf *wor
     int l2 = ip*l1;
     int ido = n / l2;
     int idot = ido + ido;
-    switch (ip) {
-      case 5: {
-        int ix2 = iw + idot;
-        int ix3 = ix2 + idot;
-        int ix4 = ix3 + idot;
-        passf5_ps(idot, l1, in, out, &wa[iw], &wa[ix2], &wa[ix3], &wa[ix4], isign);
-      } break;
-      case 4: {
-        int ix2 = iw + idot;
-        int ix3 = ix2 + idot;
-        passf4_ps(idot, l1, in, out, &wa[iw], &wa[ix2], &wa[ix3], isign);
-      } break;
-      case 2: {
-        passf2_ps(idot, l1, in, out, &wa[iw], isign);
-      } break;
-      case 3: {
-        int ix2 = iw + idot;
-        passf3_ps(idot, l1, in, out, &wa[iw], &wa[ix2], isign);
-      } break;
-      default:
-        assert(0);
+    for (c = 0; c < count; ++c) {
+      const v4sf *cin = in + c*is;
+      v4sf *cout = out + c*os;
+      switch (ip) {
+        case 13:
+        case 11:
+        case 7:
+          passfp_ps(ip, idot, l1, cin, cout, &wa[iw], isign);
+          break;
+        case 8:
+          passf8_ps(idot, l1, cin, cout, &wa[iw], isign);
+          break;
+        case 5: {
+          int ix2 = iw + idot;
+          int ix3 = ix2 + idot;
+          int ix4 = ix3 + idot;
+          passf5_ps(idot, l1, cin, cout, &wa[iw], &wa[ix2], &wa[ix3], &wa[ix4], isign);
+        } break;
+        case 4: {
+          int ix2 = iw + idot;
+          int ix3 = ix2 + idot;
+          passf4_ps(idot, l1, cin, cout, &wa[iw], &wa[ix2], &wa[ix3], isign);
+        } break;
+        case 2: {
+          passf2_ps(idot, l1, cin, cout, &wa[iw], isign);
+        } break;
+        case 3: {
+          int ix2 = iw + idot;
+          passf3_ps(idot, l1, cin, cout, &wa[iw], &wa[ix2], isign);
+        } break;
+        default:
+          assert(0);
+      }
     }
     l1 = l2;
     iw += (ip - 1)*idot;
     if (out == work2) {
-      out = work1; in = work2;
+      out = work1; in = work2; os = stride1; is = stride2;
     } else {
-      out = work2; in = work1;
+      out = work2; in = work1; os = stride2; is = stride1;
     }
   }
 
   return in; /* this is in fact the output .. */
 }
 
+/* codelets: real fft drivers for the small power of two lengths n (= N/SIMD_SZ).
+   with n known at compile time, so is the factorization from decompose()
+   - a leading 2 for odd powers of two, then 4's - and the inlined passes
+   run with constant ido and l1: the compiler can unroll all their loops.
+   the codelets give the same results as rfftf1_ps() and rfftb1_ps() - with
+   the same number of passes - and are selected in select_codelets().
+   the complex passes didn't get faster this way: cfftf1_ps() is used */
+#define POW2_NF(n)      ( ((n) <= 4) ? 1 : ((n) <= 16) ? 2 : ((n) <= 64) ? 3 : 4 )
+#define POW2_HAS_2(n)   ( ((n) & 0x2AAAAAAA) != 0 )
+
+static ALWAYS_INLINE(v4sf *) rfftf1_pow2_ps(const int n, int count, const v4sf *input_readonly, int in_stride,
+                                            v4sf *work1, int stride1, v4sf *work2, int stride2,
+                                            const float *wa) {
+  v4sf *in  = (v4sf*)input_readonly;
+  v4sf *out = (in == work2 ? work1 : work2);
+  int is = in_stride, os = (out == work1 ? stride1 : stride2);
+  int k1, c;
+  int l2 = n;
+  int iw = n-1;
+  for (k1 = 1; k1 <= POW2_NF(n); ++k1) {
+    const int ip = (k1 == POW2_NF(n) && POW2_HAS_2(n)) ? 2 : 4;
+    const int l1 = l2 / ip;
+    const int ido = n / l2;
+    iw -= (ip - 1)*ido;
+    for (c = 0; c < count; ++c) {
+      if (ip == 4)
+        radf4_ps_inl(ido, l1, in + c*is, out + c*os, &wa[iw], &wa[iw + ido], &wa[iw + 2*ido]);
+      else
+        radf2_ps_inl(ido, l1, in + c*is, out + c*os, &wa[iw]);
+    }
+    l2 = l1;
+    if (out == work2) {
+      out = work1; in = work2; os = stride1; is = stride2;
+    } else {
+      out = work2; in = work1; os = stride2; is = stride1;
+    }
+  }
+  return in;
+}
+
+static ALWAYS_INLINE(v4sf *) rfftb1_pow2_ps(const int n, int count, const v4sf *input_readonly, int in_stride,
+                                            v4sf *work1, int stride1, v4sf *work2, int stride2,
+                                            const float *wa) {
+  v4sf *in  = (v4sf*)input_readonly;
+  v4sf *out = (in == work2 ? work1 : work2);
+  int is = in_stride, os = (out == work1 ? stride1 : stride2);
+  int k1, c;
+  int l1 = 1;
+  int iw = 0;
+  for (k1 = 1; k1 <= POW2_NF(n); ++k1) {
+    const int ip = (k1 == 1 && POW2_HAS_2(n)) ? 2 : 4;
+    const int l2 = ip*l1;
+    const int ido = n / l2;
+    for (c = 0; c < count; ++c) {
+      if (ip == 4)
+        radb4_ps_inl(ido, l1, in + c*is, out + c*os, &wa[iw], &wa[iw + ido], &wa[iw + 2*ido]);
+      else
+        radb2_ps_inl(ido, l1, in + c*is, out + c*os, &wa[iw]);
+    }
+    l1 = l2;
+    iw += (ip - 1)*ido;
+    if (out == work2) {
+      out = work1; in = work2; os = stride1; is = stride2;
+    } else {
+      out = work2; in = work1; os = stride2; is = stride1;
+    }
+  }
+  return in;
+}
+
+/* the codelets have to match the drivers' signatures: n and ifac are unused */
+#define POW2_CODELETS(n)                                                                        \
+static NEVER_INLINE(v4sf *) rfftf1_##n##_codelet(int n_, int count, const v4sf *in, int is,     \
+    v4sf *work1, int stride1, v4sf *work2, int stride2, const float *wa, const int *ifac) {     \
+  (void)n_; (void)ifac;                                                                         \
+  return rfftf1_pow2_ps(n, count, in, is, work1, stride1, work2, stride2, wa);                  \
+}                                                                                               \
+static NEVER_INLINE(v4sf *) rfftb1_##n##_codelet(int n_, int count, const v4sf *in, int is,     \
+    v4sf *work1, int stride1, v4sf *work2, int stride2, const float *wa, const int *ifac) {     \
+  (void)n_; (void)ifac;                                                                         \
+  return rfftb1_pow2_ps(n, count, in, is, work1, stride1, work2, stride2, wa);                  \
+}
+
+POW2_CODELETS(4)
+POW2_CODELETS(8)
+POW2_CODELETS(16)
+POW2_CODELETS(32)
+POW2_CODELETS(64)
+
+typedef v4sf *(*rfft1_driver_t)(int n, int count, const v4sf *input_readonly, int in_stride,
+                                v4sf *work1, int stride1, v4sf *work2, int stride2,
+                                const float *wa, const int *ifac);
+
+static const struct {
+  int n;
+  rfft1_driver_t rfftf1, rfftb1;
+} pow2_codelets[] = {
+  { 4,  rfftf1_4_codelet,  rfftb1_4_codelet },
+  { 8,  rfftf1_8_codelet,  rfftb1_8_codelet },
+  { 16, rfftf1_16_codelet, rfftb1_16_codelet },
+  { 32, rfftf1_32_codelet, rfftb1_32_codelet },
+  { 64, rfftf1_64_codelet, rfftb1_64_codelet },
+  { 0, 0, 0 }
+};
+
 
 struct SETUP_STRUCT {
   int     N;
@@ -1048,25 +1692,74 @@ struct SETUP_STRUCT {
   int ifac[15];
   pffft_transform_t transform;
   v4sf *data;     /* allocated room for twiddle coefs */
-  float *e;       /* points into 'data', N/4*3 elements */
-  float *twiddle; /* points into 'data', N/4 elements */
+  float *e;       /* points into 'data', N/SIMD_SZ*(SIMD_SZ-1) elements */
+  float *twiddle; /* points into 'data', N/SIMD_SZ elements */
+  int Nrows;      /* number of rows of 2D transforms: 1 for 1D transforms */
+  int col_ifac[15];
+  float *col_twiddle; /* twiddles of the complex column transforms of length Nrows */
+  int external;   /* 1: data and col_twiddle are in caller's memory, see FUNC_DESERIALIZE()
+                     2: the whole setup is, see FUNC_INIT_SETUP_INPLACE() */
+  rfft1_driver_t rfftf1, rfftb1; /* rfftf1_ps() and rfftb1_ps() - or codelets */
+  SETUP_STRUCT *blue;  /* sizes without native factorization: complex setup of the
+                          convolution in Bluestein's algorithm - or 0 */
+  int Lblue, Mblue;    /* lengths of the chirp-z transform and of the convolution */
+  float *chirp;        /* points into 'data': exp(-i*pi*n^2/Lblue), n = 0 .. Lblue-1 */
+  float *blue_b;       /* points into 'data': spectrum of the chirp filter, internal layout of 'blue' */
+  float *split;        /* points into 'data': exp(-2i*pi*k/N), k = 0 .. Lblue-1 for real transforms */
+#if defined(PFFFT_ENABLE_INSTRUMENTATION)
+  pffft_instr_snapshot_t instr;  /* hot path counters, see FUNC_GET_INSTR() */
+#endif
 };
 
-SETUP_STRUCT *FUNC_NEW_SETUP(int N, pffft_transform_t transform) {
-  SETUP_STRUCT *s = 0;
+void FUNC_DESTROY(SETUP_STRUCT *s);
+static SETUP_STRUCT *new_setup_bluestein(int N, pffft_transform_t transform);
+
+/* the struct - and in-place setups have the twiddles behind it */
+#define PFFFT_SETUP_HDR_BYTES  ( (sizeof(SETUP_STRUCT) + 63) & ~(size_t)63 )
+
+/* use the codelets for real transforms of length n = N/SIMD_SZ - if there
+   is one. the environment variable PFFFT_NO_CODELETS=1 keeps the generic
+   drivers, e.g. for benchmarking. requires s->transform and s->Ncvec */
+static void select_codelets(SETUP_STRUCT *s) {
+  const char *env = getenv("PFFFT_NO_CODELETS");
+  int k;
+  s->rfftf1 = rfftf1_ps;
+  s->rfftb1 = rfftb1_ps;
+  if (s->transform != PFFFT_REAL || (env && atoi(env)))
+    return;
+  for (k = 0; k < s->ifac[1]; ++k) {
+    if (s->ifac[2+k] > 4)
+      return;  /* factorization with radix-8, see PFFFT_RADIX8_MIN_BYTES */
+  }
+  for (k = 0; pow2_codelets[k].n; ++k) {
+    if (pow2_codelets[k].n == 2*s->Ncvec) {
+      s->rfftf1 = pow2_codelets[k].rfftf1;
+      s->rfftb1 = pow2_codelets[k].rfftb1;
+    }
+  }
+}
+
+static size_t setup_data_bytes(int N, pffft_transform_t transform) {
+  return 2 * (size_t)((transform == PFFFT_REAL ? N/2 : N)/SIMD_SZ) * sizeof(v4sf);
+}
+
+/* fill the setup - having room for the twiddles at 'data'.
+   returns 0, if N is not decomposable with the allowed prime factors */
+static int init_setup(SETUP_STRUCT *s, int N, pffft_transform_t transform, v4sf *data) {
   int k, m;
-  /* unfortunately, the fft size must be a multiple of 16 for complex FFTs 
-     and 32 for real FFTs -- a lot of stuff would need to be rewritten to
-     handle other cases (or maybe just switch to a scalar fft, I don't know..) */
-  if (transform == PFFFT_REAL)    { if ((N%(2*SIMD_SZ*SIMD_SZ)) || N<=0) return s; }
-  if (transform == PFFFT_COMPLEX) { if ((N%(  SIMD_SZ*SIMD_SZ)) || N<=0) return s; }
-  s = (SETUP_STRUCT*)malloc(sizeof(SETUP_STRUCT));
   /* assert((N % 32) == 0); */
   s->N = N;
   s->transform = transform;  
+  s->Nrows = 1;
+  s->col_twiddle = 0;
+  s->external = 0;
+  s->blue = 0;
+#if defined(PFFFT_ENABLE_INSTRUMENTATION)
+  memset(&s->instr, 0, sizeof(s->instr));
+#endif
   /* nb of complex simd vectors */
   s->Ncvec = (transform == PFFFT_REAL ? N/2 : N)/SIMD_SZ;
-  s->data = (v4sf*)FUNC_ALIGNED_MALLOC(2*s->Ncvec * sizeof(v4sf));
+  s->data = data;
   s->e = (float*)s->data;
   s->twiddle = (float*)(s->data + (2*s->Ncvec*(SIMD_SZ-1))/SIMD_SZ);  
 
@@ -1076,8 +1769,8 @@ SETUP_STRUCT *FUNC_NEW_SETUP(int N, pffft_transform_t transform) {
       int j = k%SIMD_SZ;
       for (m=0; m < SIMD_SZ-1; ++m) {
         float A = -2*(float)M_PI*(m+1)*k / N;
-        s->e[(2*(i*3 + m) + 0) * SIMD_SZ + j] = FUNC_COS(A);
-        s->e[(2*(i*3 + m) + 1) * SIMD_SZ + j] = FUNC_SIN(A);
+        s->e[(2*(i*(SIMD_SZ-1) + m) + 0) * SIMD_SZ + j] = FUNC_COS(A);
+        s->e[(2*(i*(SIMD_SZ-1) + m) + 1) * SIMD_SZ + j] = FUNC_SIN(A);
       }
     }
     rffti1_ps(N/SIMD_SZ, s->twiddle, s->ifac);
@@ -1087,30 +1780,244 @@ SETUP_STRUCT *FUNC_NEW_SETUP(int N, pffft_transform_t transform) {
       int j = k%SIMD_SZ;
       for (m=0; m < SIMD_SZ-1; ++m) {
         float A = -2*(float)M_PI*(m+1)*k / N;
-        s->e[(2*(i*3 + m) + 0)*SIMD_SZ + j] = FUNC_COS(A);
-        s->e[(2*(i*3 + m) + 1)*SIMD_SZ + j] = FUNC_SIN(A);
+        s->e[(2*(i*(SIMD_SZ-1) + m) + 0)*SIMD_SZ + j] = FUNC_COS(A);
+        s->e[(2*(i*(SIMD_SZ-1) + m) + 1)*SIMD_SZ + j] = FUNC_SIN(A);
       }
     }
     cffti1_ps(N/SIMD_SZ, s->twiddle, s->ifac);
   }
 
+  select_codelets(s);
+
   /* check that N is decomposable with allowed prime factors */
   for (k=0, m=1; k < s->ifac[1]; ++k) { m *= s->ifac[2+k]; }
-  if (m != N/SIMD_SZ) {
+  return (m == N/SIMD_SZ);
+}
+
+SETUP_STRUCT *FUNC_NEW_SETUP(int N, pffft_transform_t transform) {
+  SETUP_STRUCT *s = 0;
+  /* unfortunately, the native fft size must be a multiple of 16 for complex
+     FFTs and 32 for real FFTs - factorizable with 2, 3, 5, 7, 11 and 13.
+     other sizes use Bluestein's algorithm, see new_setup_bluestein() */
+  if (N <= 0)
+    return s;
+  if (!FUNC_IS_VALID_SIZE(N, transform))
+    return new_setup_bluestein(N, transform);
+  s = (SETUP_STRUCT*)malloc(sizeof(SETUP_STRUCT));
+  if (!init_setup(s, N, transform, (v4sf*)FUNC_ALIGNED_MALLOC(setup_data_bytes(N, transform)))) {
     FUNC_DESTROY(s); s = 0;
   }
+  return s;
+}
+
+size_t FUNC_SETUP_SIZE(int N, pffft_transform_t transform) {
+  if (N <= 0 || !FUNC_IS_VALID_SIZE(N, transform))
+    return 0;
+  return PFFFT_SETUP_HDR_BYTES + setup_data_bytes(N, transform);
+}
 
+SETUP_STRUCT *FUNC_INIT_SETUP_INPLACE(void *mem, int N, pffft_transform_t transform) {
+  SETUP_STRUCT *s = (SETUP_STRUCT*)mem;
+  if (!mem || ((uintptr_t)mem % 64) || !FUNC_SETUP_SIZE(N, transform))
+    return 0;
+  if (!init_setup(s, N, transform, (v4sf*)((char*)mem + PFFFT_SETUP_HDR_BYTES)))
+    return 0;
+  s->external = 2;
   return s;
 }
 
+SETUP_STRUCT *FUNC_NEW_SETUP_2D(int Nrows, int N, pffft_transform_t transform) {
+  SETUP_STRUCT *s = 0;
+  int k, m;
+  /* the real DC and Nyquist columns are transformed together: Nrows needs to be even.
+     'work' holds at least one strip of columns, see transform_2d(): N >= 2*SIMD_SZ */
+  if (Nrows <= 0 || (transform == PFFFT_REAL && Nrows > 1 && (Nrows % 2))
+      || (Nrows > 1 && N < 2*SIMD_SZ))
+    return s;
+  s = FUNC_NEW_SETUP(N, transform);
+  if (!s || Nrows == 1)
+    return s;
+  if (s->blue) {  /* the rows need the native transform */
+    FUNC_DESTROY(s);
+    return 0;
+  }
+  s->Nrows = Nrows;
+  s->col_twiddle = (float*)FUNC_ALIGNED_MALLOC(2*Nrows * sizeof(float));
+  cffti1_ps(Nrows, s->col_twiddle, s->col_ifac);
+
+  /* check that Nrows is decomposable with allowed prime factors */
+  for (k=0, m=1; k < s->col_ifac[1]; ++k) { m *= s->col_ifac[2+k]; }
+  if (m != Nrows) {
+    FUNC_DESTROY(s); s = 0;
+  }
+  return s;
+}
 
 void FUNC_DESTROY(SETUP_STRUCT *s) {
-  if (!s)
+  if (!s || s->external == 2)   /* nothing to free for in-place setups */
     return;
-  FUNC_ALIGNED_FREE(s->data);
+  if (!s->external) {
+    FUNC_ALIGNED_FREE(s->data);
+    if (s->col_twiddle)
+      FUNC_ALIGNED_FREE(s->col_twiddle);
+  }
+  if (s->blue)
+    FUNC_DESTROY(s->blue);
   free(s);
 }
 
+int FUNC_WORK_SIZE(const SETUP_STRUCT *s) {
+  if (s->blue)  /* see transform_bluestein() */
+    return 6 * s->Mblue + 2 * s->Lblue;
+  if (s->Nrows > 1)
+    return 2 * s->Nrows * s->N;
+  return (s->transform == PFFFT_REAL) ? s->N : 2 * s->N;
+}
+
+/* serialized setup: header, padded to PFFFT_BLOB_ALIGN bytes,
+   followed by 'data' and 'col_twiddle' - each padded likewise */
+#define PFFFT_BLOB_MAGIC    0x50464654u  /* "PFFT" - also detects other byte order */
+#define PFFFT_BLOB_VERSION  1
+#define PFFFT_BLOB_ALIGN    64
+#define PFFFT_BLOB_PAD(n)   ( ((n) + PFFFT_BLOB_ALIGN - 1) & ~(size_t)(PFFFT_BLOB_ALIGN - 1) )
+
+typedef struct {
+  unsigned magic;
+  int version;
+  int scalar_size;  /* sizeof(float) or sizeof(double) */
+  int simd_size;    /* the twiddle layout depends on SIMD_SZ */
+  int N;
+  int transform;
+  int Nrows;
+  int Ncvec;
+  int ifac[15];
+  int col_ifac[15];
+} setup_blob_header;
+
+static size_t setup_blob_data_bytes(int Ncvec) { return 2 * (size_t)Ncvec * sizeof(v4sf); }
+static size_t setup_blob_col_bytes(int Nrows) { return (Nrows > 1) ? 2 * (size_t)Nrows * sizeof(float) : 0; }
+
+size_t FUNC_SERIALIZED_SIZE(const SETUP_STRUCT *s) {
+  if (s->blue)
+    return 0;  /* Bluestein setups are not serialized */
+  return PFFFT_BLOB_PAD(sizeof(setup_blob_header))
+    + PFFFT_BLOB_PAD(setup_blob_data_bytes(s->Ncvec))
+    + PFFFT_BLOB_PAD(setup_blob_col_bytes(s->Nrows));
+}
+
+size_t FUNC_SERIALIZE(const SETUP_STRUCT *s, void *blob, size_t blob_size) {
+  const size_t total = FUNC_SERIALIZED_SIZE(s);
+  char *p = (char*)blob;
+  setup_blob_header h;
+  if (!total || blob_size < total)
+    return 0;
+  memset(blob, 0, total);
+  h.magic = PFFFT_BLOB_MAGIC;
+  h.version = PFFFT_BLOB_VERSION;
+  h.scalar_size = (int)sizeof(float);
+  h.simd_size = SIMD_SZ;
+  h.N = s->N;
+  h.transform = (int)s->transform;
+  h.Nrows = s->Nrows;
+  h.Ncvec = s->Ncvec;
+  memcpy(h.ifac, s->ifac, sizeof(h.ifac));
+  memcpy(h.col_ifac, s->col_ifac, sizeof(h.col_ifac));
+  memcpy(p, &h, sizeof(h));
+  p += PFFFT_BLOB_PAD(sizeof(h));
+  memcpy(p, s->data, setup_blob_data_bytes(s->Ncvec));
+  p += PFFFT_BLOB_PAD(setup_blob_data_bytes(s->Ncvec));
+  if (s->Nrows > 1)
+    memcpy(p, s->col_twiddle, setup_blob_col_bytes(s->Nrows));
+  return total;
+}
+
+static int setup_blob_check_factors(const int *ifac, int n) {
+  int k, m;
+  if (ifac[1] < 0 || ifac[1] > 13)
+    return 0;
+  for (k=0, m=1; k < ifac[1]; ++k) { m *= ifac[2+k]; }
+  return m == n;
+}
+
+SETUP_STRUCT *FUNC_DESERIALIZE(const void *blob, size_t blob_size, int zero_copy) {
+  const char *p = (const char*)blob;
+  SETUP_STRUCT *s = 0;
+  setup_blob_header h;
+  size_t data_bytes, col_bytes;
+
+  if (blob_size < sizeof(h))
+    return s;
+  memcpy(&h, p, sizeof(h));
+  if (h.magic != PFFFT_BLOB_MAGIC || h.version != PFFFT_BLOB_VERSION
+      || h.scalar_size != (int)sizeof(float) || h.simd_size != SIMD_SZ
+      || (h.transform != PFFFT_REAL && h.transform != PFFFT_COMPLEX)
+      || h.N <= 0 || h.Nrows <= 0
+      || h.Ncvec != (h.transform == PFFFT_REAL ? h.N/2 : h.N)/SIMD_SZ
+      || !setup_blob_check_factors(h.ifac, h.N/SIMD_SZ)
+      || (h.Nrows > 1 && !setup_blob_check_factors(h.col_ifac, h.Nrows)))
+    return s;
+  data_bytes = setup_blob_data_bytes(h.Ncvec);
+  col_bytes = setup_blob_col_bytes(h.Nrows);
+  if (blob_size < PFFFT_BLOB_PAD(sizeof(h)) + PFFFT_BLOB_PAD(data_bytes) + PFFFT_BLOB_PAD(col_bytes))
+    return s;
+  /* SIMD loads of the twiddles need the blob's alignment */
+  if (zero_copy && ((uintptr_t)blob % PFFFT_BLOB_ALIGN) != 0)
+    return s;
+
+  s = (SETUP_STRUCT*)malloc(sizeof(SETUP_STRUCT));
+  s->N = h.N;
+  s->Ncvec = h.Ncvec;
+  memcpy(s->ifac, h.ifac, sizeof(s->ifac));
+  s->transform = (pffft_transform_t)h.transform;
+  s->Nrows = h.Nrows;
+  memcpy(s->col_ifac, h.col_ifac, sizeof(s->col_ifac));
+  s->external = zero_copy;
+  s->blue = 0;
+#if defined(PFFFT_ENABLE_INSTRUMENTATION)
+  memset(&s->instr, 0, sizeof(s->instr));
+#endif
+  p += PFFFT_BLOB_PAD(sizeof(h));
+  if (zero_copy) {
+    s->data = (v4sf*)p;
+    s->col_twiddle = (h.Nrows > 1) ? (float*)(p + PFFFT_BLOB_PAD(data_bytes)) : 0;
+  } else {
+    s->data = (v4sf*)FUNC_ALIGNED_MALLOC(data_bytes);
+    memcpy(s->data, p, data_bytes);
+    s->col_twiddle = 0;
+    if (h.Nrows > 1) {
+      s->col_twiddle = (float*)FUNC_ALIGNED_MALLOC(col_bytes);
+      memcpy(s->col_twiddle, p + PFFFT_BLOB_PAD(data_bytes), col_bytes);
+    }
+  }
+  s->e = (float*)s->data;
+  s->twiddle = (float*)(s->data + (2*s->Ncvec*(SIMD_SZ-1))/SIMD_SZ);
+  select_codelets(s);
+  return s;
+}
+
+#if ( SIMD_SZ >= 4 )
+
+/* tile of the spectral product a * b * scaling - nv vectors, that are nv/2 vector pairs:
+   FUNC_ZCONVOLVE_TRANSFORM_BW() feeds these into the preprocess steps,
+   without writing the complete product to memory */
+static ALWAYS_INLINE(void) zconvolve_tile(const v4sf *a, const v4sf *b, v4sf vscal, v4sf *ab, int nv) {
+  int k;
+  for (k=0; k < nv; k += 2) {
+    v4sf ar = a[k], ai = a[k+1], br = b[k], bi = b[k+1];
+    VCPLXMUL(ar, ai, br, bi);
+    ab[k]   = VMUL(ar, vscal);
+    ab[k+1] = VMUL(ai, vscal);
+  }
+}
+
+/* first tile of real transforms: lane 0 of the first vector pair holds the real 0- and half-frequency bins */
+static ALWAYS_INLINE(void) zconvolve_tile_real_dc(const v4sf *a, const v4sf *b, float scaling, v4sf *ab) {
+  ((v4sf_union*)ab)[0].f[0] = ((const v4sf_union*)a)[0].f[0] * ((const v4sf_union*)b)[0].f[0] * scaling;
+  ((v4sf_union*)ab)[1].f[0] = ((const v4sf_union*)a)[1].f[0] * ((const v4sf_union*)b)[1].f[0] * scaling;
+}
+
+#endif
+
 #if ( SIMD_SZ == 4 )    /* !defined(PFFFT_SIMD_DISABLE) */
 
 /* [0 0 1 2 3 4 5 6 7 8] -> [0 8 7 6 5 4 3 2 1] */
@@ -1147,7 +2054,7 @@ static void unreversed_copy(int N, const v4sf *in, v4sf *out, int out_stride) {
   UNINTERLEAVE2(h0, g1, out[0], out[1]);
 }
 
-void FUNC_ZREORDER(SETUP_STRUCT *setup, const float *in, float *out, pffft_direction_t direction) {
+static void zreorder_1d(SETUP_STRUCT *setup, const float *in, float *out, pffft_direction_t direction) {
   int k, N = setup->N, Ncvec = setup->Ncvec;
   const v4sf *vin = (const v4sf*)in;
   v4sf *vout = (v4sf*)out;
@@ -1228,16 +2135,24 @@ void FUNC_CPLX_FINALIZE(int Ncvec, const v4sf *in, v4sf *out, const v4sf *e) {
   }
 }
 
-void FUNC_CPLX_PREPROCESS(int Ncvec, const v4sf *in, v4sf *out, const v4sf *e) {
+/* b != NULL: preprocess the product in * b * scaling, see FUNC_ZCONVOLVE_TRANSFORM_BW() */
+void FUNC_CPLX_PREPROCESS(int Ncvec, const v4sf *in, const v4sf *b, float scaling, v4sf *out, const v4sf *e) {
   int k, dk = Ncvec/SIMD_SZ; /* number of 4x4 matrix blocks */
   v4sf r0, i0, r1, i1, r2, i2, r3, i3;
   v4sf sr0, dr0, sr1, dr1, si0, di0, si1, di1;
-  assert(in != out);
+  v4sf tile[8], vscal = LD_PS1(scaling);
+  const v4sf *x;
+  assert(in != out && b != out);
   for (k=0; k < dk; ++k) {    
-    r0 = in[8*k+0]; i0 = in[8*k+1];
-    r1 = in[8*k+2]; i1 = in[8*k+3];
-    r2 = in[8*k+4]; i2 = in[8*k+5];
-    r3 = in[8*k+6]; i3 = in[8*k+7];
+    x = in + 8*k;
+    if (b) {
+      zconvolve_tile(x, b + 8*k, vscal, tile, 8);
+      x = tile;
+    }
+    r0 = x[0]; i0 = x[1];
+    r1 = x[2]; i1 = x[3];
+    r2 = x[4]; i2 = x[5];
+    r3 = x[6]; i3 = x[7];
 
     sr0 = VADD(r0,r2); dr0 = VSUB(r0, r2);
     sr1 = VADD(r1,r3); dr1 = VSUB(r1, r3);
@@ -1412,20 +2327,28 @@ static ALWAYS_INLINE(void) FUNC_REAL_PREPROCESS_4X4(const v4sf *in,
   *out++ = i3;
 }
 
-static NEVER_INLINE(void) FUNC_REAL_PREPROCESS(int Ncvec, const v4sf *in, v4sf *out, const v4sf *e) {
+/* b != NULL: preprocess the product in * b * scaling, see FUNC_ZCONVOLVE_TRANSFORM_BW() */
+static NEVER_INLINE(void) FUNC_REAL_PREPROCESS(int Ncvec, const v4sf *in, const v4sf *b, float scaling, v4sf *out, const v4sf *e) {
   int k, dk = Ncvec/SIMD_SZ; /* number of 4x4 matrix blocks */
   /* fftpack order is f0r f1r f1i f2r f2i ... f(n-1)r f(n-1)i f(n)r */
 
   v4sf_union Xr, Xi, *uout = (v4sf_union*)out;
   float cr0, ci0, cr1, ci1, cr2, ci2, cr3, ci3;
   static const float s = (float)M_SQRT2;
-  assert(in != out);
+  v4sf tile[8], vscal = LD_PS1(scaling);
+  const v4sf *x = in;
+  assert(in != out && b != out);
+  if (b) {
+    zconvolve_tile(in, b, vscal, tile, 8);
+    zconvolve_tile_real_dc(in, b, scaling, tile);
+    x = tile;
+  }
   for (k=0; k < 4; ++k) {
-    Xr.f[k] = ((float*)in)[8*k];
-    Xi.f[k] = ((float*)in)[8*k+4];
+    Xr.f[k] = ((const float*)x)[8*k];
+    Xi.f[k] = ((const float*)x)[8*k+4];
   }
 
-  FUNC_REAL_PREPROCESS_4X4(in, e, out+1, 1); /* will write only 6 values */
+  FUNC_REAL_PREPROCESS_4X4(x, e, out+1, 1); /* will write only 6 values */
 
   /*
     [Xr0 Xr1 Xr2 Xr3 Xi0 Xi1 Xi2 Xi3]
@@ -1440,7 +2363,12 @@ static NEVER_INLINE(void) FUNC_REAL_PREPROCESS(int Ncvec, const v4sf *in, v4sf *
     [ci3] [0  -s   0   s   0  -s   0  -s]
   */
   for (k=1; k < dk; ++k) {    
-    FUNC_REAL_PREPROCESS_4X4(in+8*k, e + k*6, out-1+k*8, 0);
+    x = in + 8*k;
+    if (b) {
+      zconvolve_tile(x, b + 8*k, vscal, tile, 8);
+      x = tile;
+    }
+    FUNC_REAL_PREPROCESS_4X4(x, e + k*6, out-1+k*8, 0);
   }
 
   cr0=(Xr.f[0]+Xi.f[0]) + 2*Xr.f[2]; uout[0].f[0] = cr0;
@@ -1454,59 +2382,388 @@ static NEVER_INLINE(void) FUNC_REAL_PREPROCESS(int Ncvec, const v4sf *in, v4sf *
 }
 
 
-void FUNC_TRANSFORM_INTERNAL(SETUP_STRUCT *setup, const float *finput, float *foutput, v4sf *scratch,
-                             pffft_direction_t direction, int ordered) {
-  int k, Ncvec   = setup->Ncvec;
-  int nf_odd = (setup->ifac[1] & 1);
+#elif ( SIMD_SZ > 4 )
 
-  /* temporary buffer is allocated on the stack if the scratch pointer is NULL */
-  int stack_allocate = (scratch == 0 ? Ncvec*2 : 1);
-  VLA_ARRAY_ON_STACK(v4sf, scratch_on_stack, stack_allocate);
+/*
+   generic variants of the zreorder / finalize / preprocess steps for
+   vectors of 8 or 16 elements: the SIMD_SZ x SIMD_SZ blocks are
+   transposed with VTRANSPOSE_S() and the butterflies of the 4x4 matrix
+   transforms above are replaced by a SIMD_SZ-point DFT across the vectors.
 
-  const v4sf *vinput = (const v4sf*)finput;
-  v4sf *voutput      = (v4sf*)foutput;
+   for each block k (with q = SIMD_SZ*k + lane) the output layout is
+
+   - complex:  vector pair m holds X[q + m*N/SIMD_SZ], m = 0 .. SIMD_SZ-1
+   - real:     vector pair 2p holds X[q + p*n] and pair 2p+1 holds X[(p+1)*n - q],
+               p = 0 .. SIMD_SZ/2-1, n = N/SIMD_SZ. lane 0 of the first block
+               is special: X[0] and X[N/2] share pair 0, pair 2p+1 holds X[n/2 + p*n]
+*/
+
+#if ( SIMD_SZ == 8 )
+#  define VTRANSPOSE_S(r)  VTRANSPOSE8(r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7])
+#  define VDFT_S           vdft8_ps
+/* cos(pi*k/SIMD_SZ) for k = 0 .. SIMD_SZ/2 */
+static const float wide_cos_tab[SIMD_SZ/2+1] = {
+  1.0, 0.92387953251128675613, 0.70710678118654752440, 0.38268343236508977173, 0.0 };
+#elif ( SIMD_SZ == 16 )
+#  define VTRANSPOSE_S(r)  VTRANSPOSE16(r)
+#  define VDFT_S           vdft16_ps
+/* cos(pi*k/SIMD_SZ) for k = 0 .. SIMD_SZ/2 */
+static const float wide_cos_tab[SIMD_SZ/2+1] = {
+  1.0, 0.98078528040323044913, 0.92387953251128675613, 0.83146961230254523708,
+  0.70710678118654752440, 0.55557023301960222474, 0.38268343236508977173, 0.19509032201612826785, 0.0 };
+#else
+#  error "SIMD_SZ not supported by the generic finalize/preprocess"
+#endif
+
+/* cos(pi*k/SIMD_SZ) for any k >= 0 */
+static ALWAYS_INLINE(float) wide_cos(int k) {
+  k %= 2*SIMD_SZ;
+  if (k > SIMD_SZ) k = 2*SIMD_SZ - k;
+  return (k > SIMD_SZ/2) ? -wide_cos_tab[SIMD_SZ - k] : wide_cos_tab[k];
+}
+
+/* sin(pi*k/SIMD_SZ) for any k >= 0 */
+static ALWAYS_INLINE(float) wide_sin(int k) {
+  return wide_cos(k + 3*SIMD_SZ/2);
+}
+
+/* 4-point DFT of the complex vectors x[0], x[is], x[2*is], x[3*is]: isign = -1 forward, +1 backward */
+static ALWAYS_INLINE(void) vdft4_ps(const v4sf *xr, const v4sf *xi, int is,
+                                    v4sf *yr, v4sf *yi, int os, int isign) {
+  v4sf sr0 = VADD(xr[0], xr[2*is]), dr0 = VSUB(xr[0], xr[2*is]);
+  v4sf sr1 = VADD(xr[is], xr[3*is]), dr1 = VSUB(xr[is], xr[3*is]);
+  v4sf si0 = VADD(xi[0], xi[2*is]), di0 = VSUB(xi[0], xi[2*is]);
+  v4sf si1 = VADD(xi[is], xi[3*is]), di1 = VSUB(xi[is], xi[3*is]);
+  yr[0] = VADD(sr0, sr1); yi[0] = VADD(si0, si1);
+  yr[2*os] = VSUB(sr0, sr1); yi[2*os] = VSUB(si0, si1);
+  if (isign < 0) {
+    yr[os] = VADD(dr0, di1); yi[os] = VSUB(di0, dr1);
+    yr[3*os] = VSUB(dr0, di1); yi[3*os] = VADD(di0, dr1);
+  } else {
+    yr[os] = VSUB(dr0, di1); yi[os] = VADD(di0, dr1);
+    yr[3*os] = VADD(dr0, di1); yi[3*os] = VSUB(di0, dr1);
+  }
+}
+
+/* radix-2 combination of the L/2-point DFTs of the even (e) and odd (o) inputs */
+static ALWAYS_INLINE(void) vdft_combine_ps(int L, v4sf *er, v4sf *ei, v4sf *or_, v4sf *oi,
+                                           v4sf *yr, v4sf *yi, int os, int isign) {
+  int m;
+  for (m = 1; m < L/2; ++m) {
+    /* twiddle exp(isign*2*pi*i*m/L) */
+    const int k = m * (2*SIMD_SZ / L);
+    v4sf wr = LD_PS1(wide_cos(k)), wi = LD_PS1(isign * wide_sin(k));
+    VCPLXMUL(or_[m], oi[m], wr, wi);
+  }
+  for (m = 0; m < L/2; ++m) {
+    yr[m*os]       = VADD(er[m], or_[m]); yi[m*os]       = VADD(ei[m], oi[m]);
+    yr[(m+L/2)*os] = VSUB(er[m], or_[m]); yi[(m+L/2)*os] = VSUB(ei[m], oi[m]);
+  }
+}
+
+/* 8-point DFT of the complex vectors x[0], x[is], .. x[7*is] */
+static ALWAYS_INLINE(void) vdft8_ps(const v4sf *xr, const v4sf *xi, int is,
+                                    v4sf *yr, v4sf *yi, int os, int isign) {
+  v4sf er[4], ei[4], or_[4], oi[4];
+  vdft4_ps(xr,    xi,    2*is, er,  ei, 1, isign);
+  vdft4_ps(xr+is, xi+is, 2*is, or_, oi, 1, isign);
+  vdft_combine_ps(8, er, ei, or_, oi, yr, yi, os, isign);
+}
+
+#if ( SIMD_SZ >= 16 )
+/* 16-point DFT of the complex vectors x[0], x[is], .. x[15*is] */
+static ALWAYS_INLINE(void) vdft16_ps(const v4sf *xr, const v4sf *xi, int is,
+                                     v4sf *yr, v4sf *yi, int os, int isign) {
+  v4sf er[8], ei[8], or_[8], oi[8];
+  vdft8_ps(xr,    xi,    2*is, er,  ei, 1, isign);
+  vdft8_ps(xr+is, xi+is, 2*is, or_, oi, 1, isign);
+  vdft_combine_ps(16, er, ei, or_, oi, yr, yi, os, isign);
+}
+#endif
+
+static void zreorder_1d(SETUP_STRUCT *setup, const float *in, float *out, pffft_direction_t direction) {
+  int k, m, j, Ncvec = setup->Ncvec;
+  const v4sf *vin = (const v4sf*)in;
+  v4sf *vout = (v4sf*)out;
+  assert(in != out);
+  if (setup->transform == PFFFT_REAL) {
+    const int n = 2*Ncvec, dk = Ncvec/SIMD_SZ;
+    for (k=0; k < dk; ++k) {
+      for (m=0; m < SIMD_SZ; m += 2) {
+        /* X[q + (m/2)*n] for q = SIMD_SZ*k .. SIMD_SZ*k + SIMD_SZ-1 */
+        const int v = 2*(SIMD_SZ*k + m), c = (SIMD_SZ*k + (m/2)*n)/SIMD_SZ;
+        if (direction == PFFFT_FORWARD) {
+          INTERLEAVE2(vin[v], vin[v+1], vout[2*c], vout[2*c+1]);
+        } else {
+          UNINTERLEAVE2(vin[2*c], vin[2*c+1], vout[v], vout[v+1]);
+        }
+      }
+      for (m=1; m < SIMD_SZ; m += 2) {
+        /* X[(m/2+1)*n - q], mirrored */
+        const float *fr = in + 2*(SIMD_SZ*k + m)*SIMD_SZ;
+        float *gr = out + 2*(SIMD_SZ*k + m)*SIMD_SZ;
+        for (j=0; j < SIMD_SZ; ++j) {
+          const int q = SIMD_SZ*k + j;
+          const int c = q ? (m/2+1)*n - q : n/2 + (m/2)*n;
+          if (direction == PFFFT_FORWARD) {
+            out[2*c] = fr[j]; out[2*c+1] = fr[j+SIMD_SZ];
+          } else {
+            gr[j] = in[2*c]; gr[j+SIMD_SZ] = in[2*c+1];
+          }
+        }
+      }
+    }
+  } else {
+    if (direction == PFFFT_FORWARD) {
+      for (k=0; k < Ncvec; ++k) {
+        int kk = (k/SIMD_SZ) + (k%SIMD_SZ)*(Ncvec/SIMD_SZ);
+        INTERLEAVE2(vin[k*2], vin[k*2+1], vout[kk*2], vout[kk*2+1]);
+      }
+    } else {
+      for (k=0; k < Ncvec; ++k) {
+        int kk = (k/SIMD_SZ) + (k%SIMD_SZ)*(Ncvec/SIMD_SZ);
+        UNINTERLEAVE2(vin[kk*2], vin[kk*2+1], vout[k*2], vout[k*2+1]);
+      }
+    }
+  }
+}
+
+void FUNC_CPLX_FINALIZE(int Ncvec, const v4sf *in, v4sf *out, const v4sf *e) {
+  int k, j, dk = Ncvec/SIMD_SZ; /* number of SIMD_SZ x SIMD_SZ matrix blocks */
+  v4sf r[SIMD_SZ], i[SIMD_SZ];
+  assert(in != out);
+  for (k=0; k < dk; ++k) {
+    for (j=0; j < SIMD_SZ; ++j) {
+      r[j] = in[2*(SIMD_SZ*k + j)]; i[j] = in[2*(SIMD_SZ*k + j) + 1];
+    }
+    VTRANSPOSE_S(r);
+    VTRANSPOSE_S(i);
+    for (j=1; j < SIMD_SZ; ++j) {
+      VCPLXMUL(r[j], i[j], e[2*((SIMD_SZ-1)*k + j-1)], e[2*((SIMD_SZ-1)*k + j-1) + 1]);
+    }
+    VDFT_S(r, i, 1, out + 2*SIMD_SZ*k, out + 2*SIMD_SZ*k + 1, 2, -1);
+  }
+}
+
+/* b != NULL: preprocess the product in * b * scaling, see FUNC_ZCONVOLVE_TRANSFORM_BW() */
+void FUNC_CPLX_PREPROCESS(int Ncvec, const v4sf *in, const v4sf *b, float scaling, v4sf *out, const v4sf *e) {
+  int k, j, dk = Ncvec/SIMD_SZ; /* number of SIMD_SZ x SIMD_SZ matrix blocks */
+  v4sf r[SIMD_SZ], i[SIMD_SZ];
+  v4sf tile[2*SIMD_SZ], vscal = LD_PS1(scaling);
+  const v4sf *x;
+  assert(in != out && b != out);
+  for (k=0; k < dk; ++k) {
+    x = in + 2*SIMD_SZ*k;
+    if (b) {
+      zconvolve_tile(x, b + 2*SIMD_SZ*k, vscal, tile, 2*SIMD_SZ);
+      x = tile;
+    }
+    VDFT_S(x, x + 1, 2, r, i, 1, +1);
+    for (j=1; j < SIMD_SZ; ++j) {
+      VCPLXMULCONJ(r[j], i[j], e[2*((SIMD_SZ-1)*k + j-1)], e[2*((SIMD_SZ-1)*k + j-1) + 1]);
+    }
+    VTRANSPOSE_S(r);
+    VTRANSPOSE_S(i);
+    for (j=0; j < SIMD_SZ; ++j) {
+      out[2*(SIMD_SZ*k + j)] = r[j]; out[2*(SIMD_SZ*k + j) + 1] = i[j];
+    }
+  }
+}
+
+static NEVER_INLINE(void) FUNC_REAL_FINALIZE(int Ncvec, const v4sf *in, v4sf *out, const v4sf *e) {
+  int k, j, p, dk = Ncvec/SIMD_SZ; /* number of SIMD_SZ x SIMD_SZ matrix blocks */
+  /* fftpack order is f0r f1r f1i f2r f2i ... f(n-1)r f(n-1)i f(n)r */
+  v4sf r[SIMD_SZ], i[SIMD_SZ], yr[SIMD_SZ], yi[SIMD_SZ];
+  v4sf_union cr, ci, *uout = (v4sf_union*)out;
+  v4sf zero = VZERO();
+  float xr, xi;
+
+  cr.v = in[0]; ci.v = in[Ncvec*2-1];
+  assert(in != out);
+  for (k=0; k < dk; ++k) {
+    /* Y[q] is at in[2q-1] (real) and in[2q] (imag), Y[0] is purely real */
+    r[0] = (k ? in[2*SIMD_SZ*k - 1] : in[0]);
+    i[0] = (k ? in[2*SIMD_SZ*k] : zero);
+    for (j=1; j < SIMD_SZ; ++j) {
+      r[j] = in[2*(SIMD_SZ*k + j) - 1]; i[j] = in[2*(SIMD_SZ*k + j)];
+    }
+    VTRANSPOSE_S(r);
+    VTRANSPOSE_S(i);
+    for (j=1; j < SIMD_SZ; ++j) {
+      VCPLXMUL(r[j], i[j], e[2*((SIMD_SZ-1)*k + j-1)], e[2*((SIMD_SZ-1)*k + j-1) + 1]);
+    }
+    VDFT_S(r, i, 1, yr, yi, 1, -1);
+    for (p=0; p < SIMD_SZ/2; ++p) {
+      /* the upper half of the spectrum is stored as conjugated mirror */
+      out[2*SIMD_SZ*k + 4*p + 0] = yr[p];
+      out[2*SIMD_SZ*k + 4*p + 1] = yi[p];
+      out[2*SIMD_SZ*k + 4*p + 2] = yr[SIMD_SZ-1-p];
+      out[2*SIMD_SZ*k + 4*p + 3] = VSUB(zero, yi[SIMD_SZ-1-p]);
+    }
+  }
+
+  /* lane 0 of the first block: X[N/2] from Y[0], X[n/2 + p*n] from Y[n/2] */
+  xr = 0;
+  for (j=0; j < SIMD_SZ; ++j)
+    xr += (j & 1) ? -cr.f[j] : cr.f[j];
+  uout[1].f[0] = xr;
+  for (p=0; p < SIMD_SZ/2; ++p) {
+    xr = xi = 0;
+    for (j=0; j < SIMD_SZ; ++j) {
+      xr += ci.f[j] * wide_cos(j*(2*p+1));
+      xi -= ci.f[j] * wide_sin(j*(2*p+1));
+    }
+    uout[4*p+2].f[0] = xr;
+    uout[4*p+3].f[0] = xi;
+  }
+}
+
+/* b != NULL: preprocess the product in * b * scaling, see FUNC_ZCONVOLVE_TRANSFORM_BW() */
+static NEVER_INLINE(void) FUNC_REAL_PREPROCESS(int Ncvec, const v4sf *in, const v4sf *b, float scaling, v4sf *out, const v4sf *e) {
+  int k, j, p, dk = Ncvec/SIMD_SZ; /* number of SIMD_SZ x SIMD_SZ matrix blocks */
+  /* fftpack order is f0r f1r f1i f2r f2i ... f(n-1)r f(n-1)i f(n)r */
+  v4sf r[SIMD_SZ], i[SIMD_SZ], xr[SIMD_SZ], xi[SIMD_SZ];
+  v4sf tile[2*SIMD_SZ], vscal = LD_PS1(scaling);
+  const v4sf *x = in;
+  const v4sf_union *uin;
+  v4sf_union t, cn;
+  v4sf zero = VZERO();
+  assert(in != out && b != out);
+  if (b) {
+    /* the first block also provides the special values in lane 0 */
+    zconvolve_tile(in, b, vscal, tile, 2*SIMD_SZ);
+    zconvolve_tile_real_dc(in, b, scaling, tile);
+    x = tile;
+  }
+  uin = (const v4sf_union*)x;
+
+  for (j=0; j < SIMD_SZ; ++j) {
+    /* Y[n/2] from X[n/2 + p*n] */
+    float c = 0;
+    for (p=0; p < SIMD_SZ/2; ++p) {
+      c += 2*( uin[4*p+2].f[0] * wide_cos(j*(2*p+1)) - uin[4*p+3].f[0] * wide_sin(j*(2*p+1)) );
+    }
+    cn.f[j] = c;
+  }
+
+  for (k=0; k < dk; ++k) {
+    if (k) {
+      x = in + 2*SIMD_SZ*k;
+      if (b) {
+        zconvolve_tile(x, b + 2*SIMD_SZ*k, vscal, tile, 2*SIMD_SZ);
+        x = tile;
+      }
+    }
+    for (p=0; p < SIMD_SZ/2; ++p) {
+      xr[p] = x[4*p + 0];
+      xi[p] = x[4*p + 1];
+      xr[SIMD_SZ-1-p] = x[4*p + 2];
+      xi[SIMD_SZ-1-p] = VSUB(zero, x[4*p + 3]);
+    }
+    if (k == 0) {
+      /* lane 0 holds X[0] and X[N/2] and needs X[m*n] = conj(X[(SIMD_SZ-m)*n]) for m > SIMD_SZ/2 */
+      t.v = xr[0]; t.f[0] = uin[0].f[0]; xr[0] = t.v;
+      t.v = xi[0]; t.f[0] = 0;           xi[0] = t.v;
+      t.v = xr[SIMD_SZ/2]; t.f[0] = uin[1].f[0]; xr[SIMD_SZ/2] = t.v;
+      t.v = xi[SIMD_SZ/2]; t.f[0] = 0;           xi[SIMD_SZ/2] = t.v;
+      for (p=SIMD_SZ/2+1; p < SIMD_SZ; ++p) {
+        t.v = xr[p]; t.f[0] =  uin[4*(SIMD_SZ-p)+0].f[0]; xr[p] = t.v;
+        t.v = xi[p]; t.f[0] = -uin[4*(SIMD_SZ-p)+1].f[0]; xi[p] = t.v;
+      }
+    }
+    VDFT_S(xr, xi, 1, r, i, 1, +1);
+    for (j=1; j < SIMD_SZ; ++j) {
+      VCPLXMULCONJ(r[j], i[j], e[2*((SIMD_SZ-1)*k + j-1)], e[2*((SIMD_SZ-1)*k + j-1) + 1]);
+    }
+    VTRANSPOSE_S(r);
+    VTRANSPOSE_S(i);
+    if (k == 0) {
+      out[0] = r[0];
+    } else {
+      out[2*SIMD_SZ*k - 1] = r[0]; out[2*SIMD_SZ*k] = i[0];
+    }
+    for (j=1; j < SIMD_SZ; ++j) {
+      out[2*(SIMD_SZ*k + j) - 1] = r[j]; out[2*(SIMD_SZ*k + j)] = i[j];
+    }
+  }
+  out[2*Ncvec-1] = cn.v;
+}
+
+#endif /* SIMD_SZ > 4 */
+
+#if ( SIMD_SZ >= 4 )
+
+void FUNC_TRANSFORM_INTERNAL(SETUP_STRUCT *setup, int count, const float *finput, int input_stride,
+                             float *foutput, int output_stride, v4sf *scratch,
+                             pffft_direction_t direction, int ordered) {
+  int k, c, Ncvec   = setup->Ncvec;
+  int nf_odd = (setup->ifac[1] & 1);
+
+  /* temporary buffer is allocated on the stack if the scratch pointer is NULL */
+  int stack_allocate = (scratch == 0 ? Ncvec*2 : 1);
+  VLA_ARRAY_ON_STACK(v4sf, scratch_on_stack, stack_allocate);
+
+  const v4sf *vinput = (const v4sf*)finput;
+  v4sf *voutput      = (v4sf*)foutput;
   v4sf *buff[2]      = { voutput, scratch ? scratch : scratch_on_stack };
+  /* strides of the transforms in the buffers - in v4sf units */
+  int is             = input_stride / SIMD_SZ;
+  int bs[2]          = { output_stride / SIMD_SZ, Ncvec*2 };
   int ib = (nf_odd ^ ordered ? 1 : 0);
 
   assert(VALIGNED(finput) && VALIGNED(foutput));
+  assert(count == 1 || (scratch && (input_stride % SIMD_SZ) == 0 && (output_stride % SIMD_SZ) == 0));
+  assert(finput != foutput || input_stride == output_stride);
 
   /* assert(finput != foutput); */
   if (direction == PFFFT_FORWARD) {
     ib = !ib;
     if (setup->transform == PFFFT_REAL) { 
-      ib = (rfftf1_ps(Ncvec*2, vinput, buff[ib], buff[!ib],
+      ib = (setup->rfftf1(Ncvec*2, count, vinput, is, buff[ib], bs[ib], buff[!ib], bs[!ib],
                       setup->twiddle, &setup->ifac[0]) == buff[0] ? 0 : 1);      
-      FUNC_REAL_FINALIZE(Ncvec, buff[ib], buff[!ib], (v4sf*)setup->e);
+      for (c=0; c < count; ++c)
+        FUNC_REAL_FINALIZE(Ncvec, buff[ib] + c*bs[ib], buff[!ib] + c*bs[!ib], (v4sf*)setup->e);
     } else {
-      v4sf *tmp = buff[ib];
-      for (k=0; k < Ncvec; ++k) {
-        UNINTERLEAVE2(vinput[k*2], vinput[k*2+1], tmp[k*2], tmp[k*2+1]);
+      for (c=0; c < count; ++c) {
+        const v4sf *in = vinput + c*is;
+        v4sf *tmp = buff[ib] + c*bs[ib];
+        for (k=0; k < Ncvec; ++k) {
+          UNINTERLEAVE2(in[k*2], in[k*2+1], tmp[k*2], tmp[k*2+1]);
+        }
       }
-      ib = (cfftf1_ps(Ncvec, buff[ib], buff[!ib], buff[ib], 
+      ib = (cfftf1_ps(Ncvec, count, buff[ib], bs[ib], buff[!ib], bs[!ib], buff[ib], bs[ib],
                       setup->twiddle, &setup->ifac[0], -1) == buff[0] ? 0 : 1);
-      FUNC_CPLX_FINALIZE(Ncvec, buff[ib], buff[!ib], (v4sf*)setup->e);
+      for (c=0; c < count; ++c)
+        FUNC_CPLX_FINALIZE(Ncvec, buff[ib] + c*bs[ib], buff[!ib] + c*bs[!ib], (v4sf*)setup->e);
     }
     if (ordered) {
-      FUNC_ZREORDER(setup, (float*)buff[!ib], (float*)buff[ib], PFFFT_FORWARD);
+      for (c=0; c < count; ++c)
+        zreorder_1d(setup, (float*)(buff[!ib] + c*bs[!ib]), (float*)(buff[ib] + c*bs[ib]), PFFFT_FORWARD);
     } else ib = !ib;
   } else {
     if (vinput == buff[ib]) { 
       ib = !ib; /* may happen when finput == foutput */
     }
     if (ordered) {
-      FUNC_ZREORDER(setup, (float*)vinput, (float*)buff[ib], PFFFT_BACKWARD);
-      vinput = buff[ib]; ib = !ib;
+      for (c=0; c < count; ++c)
+        zreorder_1d(setup, (float*)(vinput + c*is), (float*)(buff[ib] + c*bs[ib]), PFFFT_BACKWARD);
+      vinput = buff[ib]; is = bs[ib]; ib = !ib;
     }
     if (setup->transform == PFFFT_REAL) {
-      FUNC_REAL_PREPROCESS(Ncvec, vinput, buff[ib], (v4sf*)setup->e);
-      ib = (rfftb1_ps(Ncvec*2, buff[ib], buff[0], buff[1], 
+      for (c=0; c < count; ++c)
+        FUNC_REAL_PREPROCESS(Ncvec, vinput + c*is, 0, 1, buff[ib] + c*bs[ib], (v4sf*)setup->e);
+      ib = (setup->rfftb1(Ncvec*2, count, buff[ib], bs[ib], buff[0], bs[0], buff[1], bs[1],
                       setup->twiddle, &setup->ifac[0]) == buff[0] ? 0 : 1);
     } else {
-      FUNC_CPLX_PREPROCESS(Ncvec, vinput, buff[ib], (v4sf*)setup->e);
-      ib = (cfftf1_ps(Ncvec, buff[ib], buff[0], buff[1], 
+      for (c=0; c < count; ++c)
+        FUNC_CPLX_PREPROCESS(Ncvec, vinput + c*is, 0, 1, buff[ib] + c*bs[ib], (v4sf*)setup->e);
+      ib = (cfftf1_ps(Ncvec, count, buff[ib], bs[ib], buff[0], bs[0], buff[1], bs[1],
                       setup->twiddle, &setup->ifac[0], +1) == buff[0] ? 0 : 1);
-      for (k=0; k < Ncvec; ++k) {
-        INTERLEAVE2(buff[ib][k*2], buff[ib][k*2+1], buff[ib][k*2], buff[ib][k*2+1]);
+      for (c=0; c < count; ++c) {
+        v4sf *out = buff[ib] + c*bs[ib];
+        for (k=0; k < Ncvec; ++k) {
+          INTERLEAVE2(out[k*2], out[k*2+1], out[k*2], out[k*2+1]);
+        }
       }
     }
   }
@@ -1514,16 +2771,65 @@ void FUNC_TRANSFORM_INTERNAL(SETUP_STRUCT *setup, const float *finput, float *fo
   if (buff[ib] != voutput) {
     /* extra copy required -- this situation should only happen when finput == foutput */
     assert(finput==foutput);
-    for (k=0; k < Ncvec; ++k) {
-      v4sf a = buff[ib][2*k], b = buff[ib][2*k+1];
-      voutput[2*k] = a; voutput[2*k+1] = b;
+    for (c=0; c < count; ++c) {
+      const v4sf *in = buff[ib] + c*bs[ib];
+      v4sf *out = voutput + c*bs[0];
+      for (k=0; k < Ncvec; ++k) {
+        v4sf a = in[2*k], b = in[2*k+1];
+        out[2*k] = a; out[2*k+1] = b;
+      }
     }
     ib = !ib;
   }
   assert(buff[ib] == voutput);
 }
 
-void FUNC_ZCONVOLVE_ACCUMULATE(SETUP_STRUCT *s, const float *a, const float *b, float *ab, float scaling) {
+/* FUNC_TRANSFORM_INTERNAL() backward - unordered, count = 1 - of the product a * b * scaling:
+   the product is formed tile-wise within the preprocess step, which saves the complete
+   pass writing - and reading back - the product spectrum */
+static void zconvolve_transform_backward_1d(SETUP_STRUCT *setup, const float *a, const float *b,
+                                            float *foutput, v4sf *scratch, float scaling) {
+  int k, Ncvec = setup->Ncvec;
+  int nf_odd = (setup->ifac[1] & 1);
+
+  /* temporary buffer is allocated on the stack if the scratch pointer is NULL */
+  int stack_allocate = (scratch == 0 ? Ncvec*2 : 1);
+  VLA_ARRAY_ON_STACK(v4sf, scratch_on_stack, stack_allocate);
+
+  const v4sf *va = (const v4sf*)a, *vb = (const v4sf*)b;
+  v4sf *voutput = (v4sf*)foutput;
+  v4sf *buff[2] = { voutput, scratch ? scratch : scratch_on_stack };
+  int ib = (nf_odd ? 1 : 0);
+
+  assert(VALIGNED(a) && VALIGNED(b) && VALIGNED(foutput));
+  assert(b != foutput);
+  if (va == buff[ib]) {
+    ib = !ib; /* may happen when a == foutput */
+  }
+  if (setup->transform == PFFFT_REAL) {
+    FUNC_REAL_PREPROCESS(Ncvec, va, vb, scaling, buff[ib], (v4sf*)setup->e);
+    ib = (setup->rfftb1(Ncvec*2, 1, buff[ib], 0, buff[0], 0, buff[1], 0,
+                    setup->twiddle, &setup->ifac[0]) == buff[0] ? 0 : 1);
+  } else {
+    FUNC_CPLX_PREPROCESS(Ncvec, va, vb, scaling, buff[ib], (v4sf*)setup->e);
+    ib = (cfftf1_ps(Ncvec, 1, buff[ib], 0, buff[0], 0, buff[1], 0,
+                    setup->twiddle, &setup->ifac[0], +1) == buff[0] ? 0 : 1);
+    for (k=0; k < Ncvec; ++k) {
+      INTERLEAVE2(buff[ib][k*2], buff[ib][k*2+1], buff[ib][k*2], buff[ib][k*2+1]);
+    }
+  }
+
+  if (buff[ib] != voutput) {
+    /* extra copy required -- when a == foutput */
+    assert(va == voutput);
+    for (k=0; k < Ncvec; ++k) {
+      v4sf x = buff[ib][2*k], y = buff[ib][2*k+1];
+      voutput[2*k] = x; voutput[2*k+1] = y;
+    }
+  }
+}
+
+static void zconvolve_accumulate_1d(SETUP_STRUCT *s, const float *a, const float *b, float *ab, float scaling) {
   int Ncvec = s->Ncvec;
   const v4sf * RESTRICT va = (const v4sf*)a;
   const v4sf * RESTRICT vb = (const v4sf*)b;
@@ -1621,7 +2927,7 @@ void FUNC_ZCONVOLVE_ACCUMULATE(SETUP_STRUCT *s, const float *a, const float *b,
   }
 }
 
-void FUNC_ZCONVOLVE_NO_ACCU(SETUP_STRUCT *s, const float *a, const float *b, float *ab, float scaling) {
+static void zconvolve_no_accu_1d(SETUP_STRUCT *s, const float *a, const float *b, float *ab, float scaling) {
   v4sf vscal = LD_PS1(scaling);
   const v4sf * RESTRICT va = (const v4sf*)a;
   const v4sf * RESTRICT vb = (const v4sf*)b;
@@ -1676,12 +2982,74 @@ void FUNC_ZCONVOLVE_NO_ACCU(SETUP_STRUCT *s, const float *a, const float *b, flo
 }
 
 
-#else  /* #if ( SIMD_SZ == 4 )   * !defined(PFFFT_SIMD_DISABLE) */
+
+/* real valued spectrum b - packed with FUNC_ZREAL_PACK(): the first vector pair of
+   the complex layout is kept (it carries the real 0- and half-frequency components
+   of real transforms), then one vector of real parts for each further vector pair */
+static void zreal_pack_1d(SETUP_STRUCT *s, const float *b, float *rb) {
+  const int Ncvec = s->Ncvec;
+  const v4sf * RESTRICT vb = (const v4sf*)b;
+  v4sf * RESTRICT vrb = (v4sf*)rb;
+  int k;
+  assert(VALIGNED(b) && VALIGNED(rb));
+  vrb[0] = vb[0];
+  vrb[1] = vb[1];
+  for (k=1; k < Ncvec; ++k)
+    vrb[k+1] = vb[2*k];
+}
+
+static void zconvolve_real_1d(SETUP_STRUCT *s, const float *a, const float *rb, float *ab, float scaling, int accumulate) {
+  v4sf vscal = LD_PS1(scaling);
+  const v4sf * RESTRICT va = (const v4sf*)a;
+  const v4sf * RESTRICT vb = (const v4sf*)rb;
+  v4sf * RESTRICT vab = (v4sf*)ab;
+  const int Ncvec = s->Ncvec;
+  float sar, sai, sbr, sbi, sabr, sabi;
+  v4sf var, vai, vbr, vbi;
+  int k;
+
+  assert(VALIGNED(a) && VALIGNED(rb) && VALIGNED(ab));
+  sar = ((v4sf_union*)va)[0].f[0];
+  sai = ((v4sf_union*)va)[1].f[0];
+  sbr = ((v4sf_union*)vb)[0].f[0];
+  sbi = ((v4sf_union*)vb)[1].f[0];
+  sabr = accumulate ? ((v4sf_union*)vab)[0].f[0] : 0.0f;
+  sabi = accumulate ? ((v4sf_union*)vab)[1].f[0] : 0.0f;
+
+  /* first vector pair: complex multiplication */
+  var = va[0]; vai = va[1];
+  vbr = vb[0]; vbi = vb[1];
+  VCPLXMUL(var, vai, vbr, vbi);
+  if (accumulate) {
+    vab[0] = VMADD(var, vscal, vab[0]);
+    vab[1] = VMADD(vai, vscal, vab[1]);
+    for (k=1; k < Ncvec; ++k) {
+      vbr = VMUL(vb[k+1], vscal);
+      vab[2*k+0] = VMADD(va[2*k+0], vbr, vab[2*k+0]);
+      vab[2*k+1] = VMADD(va[2*k+1], vbr, vab[2*k+1]);
+    }
+  } else {
+    vab[0] = VMUL(var, vscal);
+    vab[1] = VMUL(vai, vscal);
+    for (k=1; k < Ncvec; ++k) {
+      vbr = VMUL(vb[k+1], vscal);
+      vab[2*k+0] = VMUL(va[2*k+0], vbr);
+      vab[2*k+1] = VMUL(va[2*k+1], vbr);
+    }
+  }
+
+  if (s->transform == PFFFT_REAL) {
+    ((v4sf_union*)vab)[0].f[0] = sabr + sar*sbr*scaling;
+    ((v4sf_union*)vab)[1].f[0] = sabi + sai*sbi*scaling;
+  }
+}
+
+#else  /* #if ( SIMD_SZ >= 4 )   * !defined(PFFFT_SIMD_DISABLE) */
 
 /* standard routine using scalar floats, without SIMD stuff. */
 
-#define pffft_zreorder_nosimd FUNC_ZREORDER
-void pffft_zreorder_nosimd(SETUP_STRUCT *setup, const float *in, float *out, pffft_direction_t direction) {
+#define pffft_zreorder_nosimd zreorder_1d
+static void pffft_zreorder_nosimd(SETUP_STRUCT *setup, const float *in, float *out, pffft_direction_t direction) {
   int k, N = setup->N;
   if (setup->transform == PFFFT_COMPLEX) {
     for (k=0; k < 2*N; ++k) out[k] = in[k];
@@ -1701,46 +3069,54 @@ void pffft_zreorder_nosimd(SETUP_STRUCT *setup, const float *in, float *out, pff
 }
 
 #define pffft_transform_internal_nosimd FUNC_TRANSFORM_INTERNAL
-void pffft_transform_internal_nosimd(SETUP_STRUCT *setup, const float *input, float *output, float *scratch,
+void pffft_transform_internal_nosimd(SETUP_STRUCT *setup, int count, const float *input, int input_stride,
+                                    float *output, int output_stride, float *scratch,
                                     pffft_direction_t direction, int ordered) {
-  int Ncvec   = setup->Ncvec;
+  int c, Ncvec   = setup->Ncvec;
   int nf_odd = (setup->ifac[1] & 1);
 
   /* temporary buffer is allocated on the stack if the scratch pointer is NULL */
   int stack_allocate = (scratch == 0 ? Ncvec*2 : 1);
   VLA_ARRAY_ON_STACK(v4sf, scratch_on_stack, stack_allocate);
   float *buff[2];
+  int is = input_stride, bs[2];
   int ib;
   if (scratch == 0) scratch = scratch_on_stack;
   buff[0] = output; buff[1] = scratch;
+  bs[0] = output_stride; bs[1] = Ncvec*2;
+  assert(count == 1 || scratch != scratch_on_stack);
+  assert(input != output || input_stride == output_stride);
 
   if (setup->transform == PFFFT_COMPLEX) ordered = 0; /* it is always ordered. */
   ib = (nf_odd ^ ordered ? 1 : 0);
 
   if (direction == PFFFT_FORWARD) {
     if (setup->transform == PFFFT_REAL) {
-      ib = (rfftf1_ps(Ncvec*2, input, buff[ib], buff[!ib],
+      ib = (setup->rfftf1(Ncvec*2, count, input, is, buff[ib], bs[ib], buff[!ib], bs[!ib],
                       setup->twiddle, &setup->ifac[0]) == buff[0] ? 0 : 1);      
     } else {
-      ib = (cfftf1_ps(Ncvec, input, buff[ib], buff[!ib], 
+      ib = (cfftf1_ps(Ncvec, count, input, is, buff[ib], bs[ib], buff[!ib], bs[!ib],
                       setup->twiddle, &setup->ifac[0], -1) == buff[0] ? 0 : 1);
     }
     if (ordered) {
-      FUNC_ZREORDER(setup, buff[ib], buff[!ib], PFFFT_FORWARD); ib = !ib;
+      for (c=0; c < count; ++c)
+        zreorder_1d(setup, buff[ib] + c*bs[ib], buff[!ib] + c*bs[!ib], PFFFT_FORWARD);
+      ib = !ib;
     }
   } else {    
     if (input == buff[ib]) { 
       ib = !ib; /* may happen when finput == foutput */
     }
     if (ordered) {
-      FUNC_ZREORDER(setup, input, buff[!ib], PFFFT_BACKWARD); 
-      input = buff[!ib];
+      for (c=0; c < count; ++c)
+        zreorder_1d(setup, input + c*is, buff[!ib] + c*bs[!ib], PFFFT_BACKWARD); 
+      input = buff[!ib]; is = bs[!ib];
     }
     if (setup->transform == PFFFT_REAL) {
-      ib = (rfftb1_ps(Ncvec*2, input, buff[ib], buff[!ib], 
+      ib = (setup->rfftb1(Ncvec*2, count, input, is, buff[ib], bs[ib], buff[!ib], bs[!ib],
                       setup->twiddle, &setup->ifac[0]) == buff[0] ? 0 : 1);
     } else {
-      ib = (cfftf1_ps(Ncvec, input, buff[ib], buff[!ib], 
+      ib = (cfftf1_ps(Ncvec, count, input, is, buff[ib], bs[ib], buff[!ib], bs[!ib],
                       setup->twiddle, &setup->ifac[0], +1) == buff[0] ? 0 : 1);
     }
   }
@@ -1748,17 +3124,21 @@ void pffft_transform_internal_nosimd(SETUP_STRUCT *setup, const float *input, fl
     int k;
     /* extra copy required -- this situation should happens only when finput == foutput */
     assert(input==output);
-    for (k=0; k < Ncvec; ++k) {
-      float a = buff[ib][2*k], b = buff[ib][2*k+1];
-      output[2*k] = a; output[2*k+1] = b;
+    for (c=0; c < count; ++c) {
+      const float *in = buff[ib] + c*bs[ib];
+      float *out = output + c*bs[0];
+      for (k=0; k < Ncvec; ++k) {
+        float a = in[2*k], b = in[2*k+1];
+        out[2*k] = a; out[2*k+1] = b;
+      }
     }
     ib = !ib;
   }
   assert(buff[ib] == output);
 }
 
-#define pffft_zconvolve_accumulate_nosimd FUNC_ZCONVOLVE_ACCUMULATE
-void pffft_zconvolve_accumulate_nosimd(SETUP_STRUCT *s, const float *a, const float *b,
+#define pffft_zconvolve_accumulate_nosimd zconvolve_accumulate_1d
+static void pffft_zconvolve_accumulate_nosimd(SETUP_STRUCT *s, const float *a, const float *b,
                                        float *ab, float scaling) {
   int NcvecMulTwo = 2*s->Ncvec;  /* int Ncvec = s->Ncvec; */
   int k; /* was i -- but always used "2*i" - except at for() */
@@ -1779,16 +3159,16 @@ void pffft_zconvolve_accumulate_nosimd(SETUP_STRUCT *s, const float *a, const fl
   }
 }
 
-#define pffft_zconvolve_no_accu_nosimd FUNC_ZCONVOLVE_NO_ACCU
-void pffft_zconvolve_no_accu_nosimd(SETUP_STRUCT *s, const float *a, const float *b,
+#define pffft_zconvolve_no_accu_nosimd zconvolve_no_accu_1d
+static void pffft_zconvolve_no_accu_nosimd(SETUP_STRUCT *s, const float *a, const float *b,
                                     float *ab, float scaling) {
   int NcvecMulTwo = 2*s->Ncvec;  /* int Ncvec = s->Ncvec; */
   int k; /* was i -- but always used "2*i" - except at for() */
 
   if (s->transform == PFFFT_REAL) {
     /* take care of the fftpack ordering */
-    ab[0] += a[0]*b[0]*scaling;
-    ab[NcvecMulTwo-1] += a[NcvecMulTwo-1]*b[NcvecMulTwo-1]*scaling;
+    ab[0] = a[0]*b[0]*scaling;
+    ab[NcvecMulTwo-1] = a[NcvecMulTwo-1]*b[NcvecMulTwo-1]*scaling;
     ++ab; ++a; ++b; NcvecMulTwo -= 2;
   }
   for (k=0; k < NcvecMulTwo; k += 2) {
@@ -1801,16 +3181,1071 @@ void pffft_zconvolve_no_accu_nosimd(SETUP_STRUCT *s, const float *a, const float
   }
 }
 
+/* real valued spectrum b - packed: with the fftpack ordering of real transforms,
+   the 0- and half-frequency components go first - then the real parts of the pairs */
+#define pffft_zreal_pack_nosimd zreal_pack_1d
+static void pffft_zreal_pack_nosimd(SETUP_STRUCT *s, const float *b, float *rb) {
+  const int Ncvec = s->Ncvec;
+  int k;
+  if (s->transform == PFFFT_REAL) {
+    rb[0] = b[0];
+    rb[1] = b[2*Ncvec-1];
+    for (k=1; k < Ncvec; ++k)
+      rb[k+1] = b[2*k-1];
+  } else {
+    rb[0] = b[0];
+    rb[1] = b[1];
+    for (k=1; k < Ncvec; ++k)
+      rb[k+1] = b[2*k];
+  }
+}
+
+#define pffft_zconvolve_real_nosimd zconvolve_real_1d
+static void pffft_zconvolve_real_nosimd(SETUP_STRUCT *s, const float *a, const float *rb,
+                                        float *ab, float scaling, int accumulate) {
+  const int Ncvec = s->Ncvec;
+  /* pair k of the complex layout starts at 2*k + off */
+  const int off = (s->transform == PFFFT_REAL) ? -1 : 0;
+  int k;
+  float ar, ai, br, bi;
+
+  if (s->transform == PFFFT_REAL) {
+    /* take care of the fftpack ordering */
+    ar = a[0]*rb[0]*scaling;
+    ai = a[2*Ncvec-1]*rb[1]*scaling;
+    ab[0] = accumulate ? ab[0] + ar : ar;
+    ab[2*Ncvec-1] = accumulate ? ab[2*Ncvec-1] + ai : ai;
+  } else {
+    ar = a[0]; ai = a[1];
+    br = rb[0]; bi = rb[1];
+    VCPLXMUL(ar, ai, br, bi);
+    ab[0] = accumulate ? ab[0] + ar*scaling : ar*scaling;
+    ab[1] = accumulate ? ab[1] + ai*scaling : ai*scaling;
+  }
+  for (k=1; k < Ncvec; ++k) {
+    br = rb[k+1] * scaling;
+    ar = a[2*k+off] * br;
+    ai = a[2*k+off+1] * br;
+    ab[2*k+off]   = accumulate ? ab[2*k+off] + ar : ar;
+    ab[2*k+off+1] = accumulate ? ab[2*k+off+1] + ai : ai;
+  }
+}
+
+
+#endif /* #if ( SIMD_SZ >= 4 )    * !defined(PFFFT_SIMD_DISABLE) */
+
+
+/* interleaving the passes of many transforms does only pay off, as long as
+   the data of all interleaved transforms stays in the first level cache:
+   larger batches are processed in groups */
+#ifndef PFFFT_BATCH_CACHE_BYTES
+#define PFFFT_BATCH_CACHE_BYTES  (16 * 1024)
+#endif
+
+static void FUNC_TRANSFORM_BATCH_INTERNAL(SETUP_STRUCT *setup, int count, const float *input, int input_stride,
+                                          float *output, int output_stride, float *work,
+                                          pffft_direction_t direction, int ordered) {
+  /* input, output and scratch of each transform */
+  const int bytes_per_transform = 3 * 2 * setup->Ncvec * (int)sizeof(v4sf);
+  int c, group = PFFFT_BATCH_CACHE_BYTES / bytes_per_transform;
+  int stack_allocate;
+  if (count <= 0)
+    return;
+  if (group < 1)
+    group = 1;
+  if (group > count)
+    group = count;
+
+  /* 'work' has room for a single transform, only: the scratch of
+     interleaved groups is small enough to be put on the stack */
+  stack_allocate = (work == 0 || group > 1) ? group * 2 * setup->Ncvec : 1;
+  {
+    VLA_ARRAY_ON_STACK(v4sf, work_on_stack, stack_allocate);
+    v4sf *scratch = (work && group == 1) ? (v4sf*)work : work_on_stack;
+    for (c=0; c < count; c += group) {
+      const int n = (count - c < group) ? (count - c) : group;
+      FUNC_TRANSFORM_INTERNAL(setup, n, input + c*input_stride, input_stride,
+                              output + c*output_stride, output_stride,
+                              scratch, direction, ordered);
+    }
+  }
+}
+
+
+/* 2D transforms: the rows are transformed with the 1D transform of length N,
+   then the columns with a complex transform of length Nrows. a column of
+   v4sf pairs (real and imag parts of SIMD_SZ bins) is an independent
+   complex transform in each SIMD lane, thus the columns are transformed in
+   strips - gathered from the rows, without transposition.
+   for real transforms, the real DC and Nyquist columns are transformed
+   together as one complex column DC + i*Nyquist, which is split into the
+   two spectra afterwards: rows 0 < k < Nrows/2 hold the bin of the DC column,
+   rows Nrows/2 < k hold the bin of the Nyquist column. the rows 0 and Nrows/2
+   keep the real DC and Nyquist values, as in the 1D layout.
+   ATTENTION: for SIMD_SZ == 1, the real layout is the one of fftpack */
+
+#define PFFFT_2D_CACHE_LINE   64
+#define PFFFT_2D_MAX_STRIPS   8
+
+/* offsets of real and imag part of bin pair p within a row - in v4sf */
+static ALWAYS_INLINE(void) pair_offsets_2d(const SETUP_STRUCT *s, int p, int *re, int *im) {
+#if ( SIMD_SZ == 1 )
+  if (s->transform == PFFFT_REAL) {
+    *re = (p ? 2*p-1 : 0);
+    *im = (p ? 2*p : 2*s->Ncvec-1);
+    return;
+  }
+#else
+  (void)s;
+#endif
+  *re = 2*p;
+  *im = 2*p+1;
+}
+
+/* split / merge the DC + i*Nyquist column - in SIMD lane 0 of the strip */
+static void split_real_columns_2d(int Nrows, v4sf *strip, pffft_direction_t direction) {
+  float *f = (float*)strip;
+  int k;
+  for (k=1; k < Nrows/2; ++k) {
+    float *zk = f + 2*k*SIMD_SZ;
+    float *zm = f + 2*(Nrows-k)*SIMD_SZ;
+    const float ar = zk[0], ai = zk[SIMD_SZ], br = zm[0], bi = zm[SIMD_SZ];
+    if (direction == PFFFT_FORWARD) {
+      /* Z = A + iB:  A[k] = (Z[k] + conj(Z[-k])) / 2,  B[-k] = (Z[-k] - conj(Z[k])) / 2i */
+      zk[0] = 0.5f * (ar + br);  zk[SIMD_SZ] = 0.5f * (ai - bi);
+      zm[0] = 0.5f * (ai + bi);  zm[SIMD_SZ] = 0.5f * (ar - br);
+    } else {
+      /* Z[k] = A[k] + i conj(B[-k]),  Z[-k] = conj(A[k]) + i B[-k] */
+      zk[0] = ar + bi;  zk[SIMD_SZ] = ai + br;
+      zm[0] = ar - bi;  zm[SIMD_SZ] = br - ai;
+    }
+  }
+}
+
+/* transform columns of src (in row layout) into dst, which may alias.
+   buf needs room for 4*Nrows*nstrips v4sf */
+static void transform_columns_2d(SETUP_STRUCT *s, const v4sf *src, v4sf *dst, v4sf *buf,
+                                 int nstrips, pffft_direction_t direction) {
+  const int Nrows = s->Nrows, Ncvec = s->Ncvec;
+  const int rs = 2*Ncvec, ss = 2*Nrows;  /* strides of rows and strips */
+  const int split = (s->transform == PFFFT_REAL);
+  int re[PFFFT_2D_MAX_STRIPS] = { 0 }, im[PFFFT_2D_MAX_STRIPS] = { 0 };
+  int p0, r, j;
+  for (p0=0; p0 < Ncvec; p0 += nstrips) {
+    const int nb = (Ncvec - p0 < nstrips) ? (Ncvec - p0) : nstrips;
+    v4sf *out;
+    for (j=0; j < nb; ++j)
+      pair_offsets_2d(s, p0+j, &re[j], &im[j]);
+    for (r=0; r < Nrows; ++r) {
+      const v4sf *row = src + r*rs;
+      for (j=0; j < nb; ++j) {
+        buf[j*ss + 2*r]   = row[re[j]];
+        buf[j*ss + 2*r+1] = row[im[j]];
+      }
+    }
+    if (split && p0 == 0 && direction == PFFFT_BACKWARD)
+      split_real_columns_2d(Nrows, buf, direction);
+    out = cfftf1_ps(Nrows, nb, buf, ss, buf + nb*ss, ss, buf, ss,
+                    s->col_twiddle, s->col_ifac, (direction == PFFFT_FORWARD ? -1 : +1));
+    if (split && p0 == 0 && direction == PFFFT_FORWARD)
+      split_real_columns_2d(Nrows, out, direction);
+    for (r=0; r < Nrows; ++r) {
+      v4sf *row = dst + r*rs;
+      for (j=0; j < nb; ++j) {
+        row[re[j]] = out[j*ss + 2*r];
+        row[im[j]] = out[j*ss + 2*r+1];
+      }
+    }
+  }
+}
+
+static void transform_2d(SETUP_STRUCT *setup, const float *input, float *output, float *work,
+                         pffft_direction_t direction, int ordered) {
+  const int Nrows = setup->Nrows, Ncvec = setup->Ncvec;
+  const int Nf = 2*Ncvec*SIMD_SZ;   /* floats per row */
+  /* strips of at least one cache line per row */
+  int nstrips = PFFFT_2D_CACHE_LINE / (2*SIMD_SZ*(int)sizeof(float));
+  int r, k, stack_allocate;
+  if (nstrips > PFFFT_2D_MAX_STRIPS) nstrips = PFFFT_2D_MAX_STRIPS;
+  /* 'work' of 2*Nrows*N floats holds the strips: 4*Nrows*nstrips vectors.
+     without SIMD, this limits nstrips for small N */
+  if (nstrips > setup->N / (2*SIMD_SZ)) nstrips = setup->N / (2*SIMD_SZ);
+  if (nstrips < 1) nstrips = 1;
+
+  /* room for the strips - and for one row, when reordering */
+  stack_allocate = 1;
+  if (!work)
+    stack_allocate = (4*Nrows*nstrips > 2*Ncvec) ? 4*Nrows*nstrips : 2*Ncvec;
+  {
+    VLA_ARRAY_ON_STACK(v4sf, work_on_stack, stack_allocate);
+    v4sf *buf = work ? (v4sf*)work : work_on_stack;
+    if (direction == PFFFT_FORWARD) {
+      FUNC_TRANSFORM_BATCH_INTERNAL(setup, Nrows, input, Nf, output, Nf, work, direction, 0);
+      transform_columns_2d(setup, (const v4sf*)output, (v4sf*)output, buf, nstrips, direction);
+      if (ordered) {
+        for (r=0; r < Nrows; ++r) {
+          v4sf *row = (v4sf*)(output + r*Nf);
+          zreorder_1d(setup, (float*)row, (float*)buf, PFFFT_FORWARD);
+          for (k=0; k < 2*Ncvec; ++k) row[k] = buf[k];
+        }
+      }
+    } else {
+      const float *in = input;
+      if (ordered) {
+        for (r=0; r < Nrows; ++r) {
+          v4sf *row = (v4sf*)(output + r*Nf);
+          zreorder_1d(setup, input + r*Nf, (float*)buf, PFFFT_BACKWARD);
+          for (k=0; k < 2*Ncvec; ++k) row[k] = buf[k];
+        }
+        in = output;
+      }
+      transform_columns_2d(setup, (const v4sf*)in, (v4sf*)output, buf, nstrips, direction);
+      FUNC_TRANSFORM_BATCH_INTERNAL(setup, Nrows, output, Nf, output, Nf, work, direction, 0);
+    }
+  }
+}
+
+/* rows 0 and Nrows/2 of real 2D spectra have the real DC and Nyquist
+   values in their first bin pair, like 1D spectra. the other rows have
+   a complex bin there, which is fixed after the (1D) row operation */
+static void zconvolve_2d(SETUP_STRUCT *s, const float *a, const float *b, float *ab,
+                         float scaling, int accumulate) {
+  const int Nrows = s->Nrows, Nf = 2*s->Ncvec*SIMD_SZ;
+  int r, re, im;
+  pair_offsets_2d(s, 0, &re, &im);
+  re *= SIMD_SZ;
+  im *= SIMD_SZ;
+  for (r=0; r < Nrows; ++r) {
+    const float *ra = a + r*Nf, *rb = b + r*Nf;
+    float *rab = ab + r*Nf;
+    const float ar = ra[re], ai = ra[im], br = rb[re], bi = rb[im];
+    const float abr = (accumulate ? rab[re] : 0), abi = (accumulate ? rab[im] : 0);
+    if (accumulate)
+      zconvolve_accumulate_1d(s, ra, rb, rab, scaling);
+    else
+      zconvolve_no_accu_1d(s, ra, rb, rab, scaling);
+    if (s->transform == PFFFT_REAL && r != 0 && 2*r != Nrows) {
+      rab[re] = abr + (ar*br - ai*bi) * scaling;
+      rab[im] = abi + (ar*bi + ai*br) * scaling;
+    }
+  }
+}
+
+
+/* Bluestein's algorithm, for the sizes without native factorization: the
+   dft of length L is a cyclic convolution with the chirp c[n] = exp(-i*pi*n^2/L)
+
+     X[k] = c[k] * sum_n (x[n]*c[n]) * conj(c[k-n])
+
+   which is computed with the native complex transform of length
+   M >= 2*L-1 - and zconvolve. the backward dft is the conjugated forward
+   dft of the conjugated input. real transforms need an even N: the even
+   and odd samples are the real and imag parts of a complex dft of length
+   L = N/2, which is split into the spectrum afterwards. the spectra of
+   these setups are always in the ordered layout - also for pffft_transform() */
+static SETUP_STRUCT *new_setup_bluestein(int N, pffft_transform_t transform) {
+  const int L = (transform == PFFFT_REAL ? N/2 : N);
+  SETUP_STRUCT *s = 0;
+  float *b;
+  int n, M;
+  if (transform == PFFFT_REAL && (N % 2))
+    return s;
+  M = FUNC_NEAREST_SIZE(2*L - 1, PFFFT_COMPLEX, 1);
+  s = (SETUP_STRUCT*)malloc(sizeof(SETUP_STRUCT));
+  if (!s)
+    return s;
+  memset(s, 0, sizeof(SETUP_STRUCT));
+  s->N = N;
+  s->transform = transform;
+  s->Nrows = 1;
+  s->rfftf1 = rfftf1_ps;
+  s->rfftb1 = rfftb1_ps;
+  s->Lblue = L;
+  s->Mblue = M;
+  s->blue = FUNC_NEW_SETUP(M, PFFFT_COMPLEX);
+  /* blue_b first: it's read with SIMD loads */
+  s->data = (v4sf*)FUNC_ALIGNED_MALLOC((2*(size_t)M + 4*(size_t)L) * sizeof(float));
+  b = (float*)FUNC_ALIGNED_MALLOC(4*(size_t)M * sizeof(float));
+  if (!s->blue || !s->data || !b) {
+    FUNC_ALIGNED_FREE(b);
+    FUNC_DESTROY(s);
+    return 0;
+  }
+  s->blue_b = (float*)s->data;
+  s->chirp = s->blue_b + 2*M;
+  s->split = s->chirp + 2*L;
+
+  for (n=0; n < L; ++n) {
+    /* n^2 modulo 2L keeps the argument small */
+    const double A = M_PI * (double)(((long long)n * n) % (2*(long long)L)) / L;
+    s->chirp[2*n]   = (float)cos(A);
+    s->chirp[2*n+1] = (float)-sin(A);
+    s->split[2*n]   = (float)cos(-2*M_PI * n / N);
+    s->split[2*n+1] = (float)sin(-2*M_PI * n / N);
+  }
+  /* the filter conj(c[m]) at m = -(L-1) .. L-1 - cyclic in M */
+  memset(b, 0, 2*(size_t)M * sizeof(float));
+  for (n=0; n < L; ++n) {
+    b[2*n] = s->chirp[2*n];
+    b[2*n+1] = -s->chirp[2*n+1];
+    if (n) {
+      b[2*(M-n)] = b[2*n];
+      b[2*(M-n)+1] = b[2*n+1];
+    }
+  }
+  FUNC_TRANSFORM_INTERNAL(s->blue, 1, b, 0, s->blue_b, 0, (v4sf*)(b + 2*M), PFFFT_FORWARD, 0);
+  FUNC_ALIGNED_FREE(b);
+  return s;
+}
+
+/* complex dft of length L of in[] into out[] - both may alias.
+   buf needs room for 6*M floats */
+static void dft_bluestein(const SETUP_STRUCT *s, const float *in, float *out, float *buf,
+                          pffft_direction_t direction) {
+  const int L = s->Lblue, M = s->Mblue;
+  const float *c = s->chirp;
+  const float conj = (direction == PFFFT_FORWARD ? 1.f : -1.f);
+  float *a = buf, *fa = buf + 2*M, *scratch = buf + 4*M;
+  int n;
+  for (n=0; n < L; ++n) {
+    const float xr = in[2*n], xi = conj*in[2*n+1];
+    a[2*n]   = xr*c[2*n] - xi*c[2*n+1];
+    a[2*n+1] = xr*c[2*n+1] + xi*c[2*n];
+  }
+  for (n=2*L; n < 2*M; ++n)
+    a[n] = 0;
+  FUNC_TRANSFORM_INTERNAL(s->blue, 1, a, 0, fa, 0, (v4sf*)scratch, PFFFT_FORWARD, 0);
+  zconvolve_no_accu_1d(s->blue, fa, s->blue_b, fa, (float)(1.0 / M));
+  FUNC_TRANSFORM_INTERNAL(s->blue, 1, fa, 0, a, 0, (v4sf*)scratch, PFFFT_BACKWARD, 0);
+  for (n=0; n < L; ++n) {
+    const float yr = a[2*n]*c[2*n] - a[2*n+1]*c[2*n+1];
+    const float yi = a[2*n]*c[2*n+1] + a[2*n+1]*c[2*n];
+    out[2*n] = yr;
+    out[2*n+1] = conj*yi;
+  }
+}
+
+/* real transforms: the complex spectrum z of the even + i*odd samples
+   to the spectrum X of the N real samples - and back:
+     X[k] = E[k] + exp(-2i*pi*k/N) O[k],  E[k] = (z[k] + conj(z[L-k])) / 2,
+                                          O[k] = (z[k] - conj(z[L-k])) / 2i
+   the backward direction delivers 2*z, matching the unscaled transforms */
+static void split_bluestein(const SETUP_STRUCT *s, const float *in, float *out,
+                            pffft_direction_t direction) {
+  const int L = s->Lblue;
+  const float *w = s->split;
+  int k;
+  if (direction == PFFFT_FORWARD) {
+    out[0] = in[0] + in[1];
+    out[1] = in[0] - in[1];
+    for (k=1; k < L; ++k) {
+      const float zr = in[2*k], zi = in[2*k+1], yr = in[2*(L-k)], yi = in[2*(L-k)+1];
+      const float er = 0.5f*(zr + yr), ei = 0.5f*(zi - yi);
+      const float or_ = 0.5f*(zi + yi), oi = 0.5f*(yr - zr);
+      out[2*k]   = er + w[2*k]*or_ - w[2*k+1]*oi;
+      out[2*k+1] = ei + w[2*k]*oi + w[2*k+1]*or_;
+    }
+  } else {
+    for (k=0; k < L; ++k) {
+      const float xr = (k ? in[2*k] : in[0]), xi = (k ? in[2*k+1] : 0);
+      const float yr = (k ? in[2*(L-k)] : in[1]), yi = (k ? in[2*(L-k)+1] : 0);
+      const float er = xr + yr, ei = xi - yi;
+      const float dr = xr - yr, di = xi + yi;
+      const float or_ = dr*w[2*k] + di*w[2*k+1], oi = di*w[2*k] - dr*w[2*k+1];
+      out[2*k]   = er - oi;
+      out[2*k+1] = ei + or_;
+    }
+  }
+}
+
+/* the scratch of transform_bluestein(): 6*M + 2*L floats */
+#define BLUESTEIN_WORK_SIZE(s)  (6*(size_t)(s)->Mblue + 2*(size_t)(s)->Lblue)
+
+/* work: BLUESTEIN_WORK_SIZE() floats - or NULL, to allocate them on the heap,
+   as they are too large for the stack. when that fails, output is left unchanged */
+static void transform_bluestein(const SETUP_STRUCT *s, int count, const float *input, int input_stride,
+                                float *output, int output_stride, float *work, pffft_direction_t direction) {
+  const int M = s->Mblue;
+  float *buf = (work ? work : (float*)FUNC_ALIGNED_MALLOC(BLUESTEIN_WORK_SIZE(s) * sizeof(float)));
+  float *z;
+  int c;
+  if (!buf)
+    return;
+  z = buf + 6*M;
+  for (c=0; c < count; ++c) {
+    const float *in = input + c*input_stride;
+    float *out = output + c*output_stride;
+    if (s->transform == PFFFT_COMPLEX) {
+      dft_bluestein(s, in, out, buf, direction);
+    } else if (direction == PFFFT_FORWARD) {
+      dft_bluestein(s, in, z, buf, direction);
+      split_bluestein(s, z, out, direction);
+    } else {
+      split_bluestein(s, in, z, direction);
+      dft_bluestein(s, z, out, buf, direction);
+    }
+  }
+  if (!work)
+    FUNC_ALIGNED_FREE(buf);
+}
+
+/* spectra in the ordered layout: the real DC and Nyquist values of real
+   transforms are in the first pair */
+static void zconvolve_bluestein(const SETUP_STRUCT *s, const float *a, const float *b, float *ab,
+                                float scaling, int accumulate) {
+  const int Nf = (s->transform == PFFFT_REAL ? s->N : 2*s->N);
+  int k = 0;
+  if (s->transform == PFFFT_REAL) {
+    const float dc = a[0]*b[0]*scaling, ny = a[1]*b[1]*scaling;
+    ab[0] = (accumulate ? ab[0] + dc : dc);
+    ab[1] = (accumulate ? ab[1] + ny : ny);
+    k = 2;
+  }
+  for (; k < Nf; k += 2) {
+    const float ar = a[k], ai = a[k+1], br = b[k], bi = b[k+1];
+    const float re = (ar*br - ai*bi)*scaling, im = (ar*bi + ai*br)*scaling;
+    ab[k]   = (accumulate ? ab[k] + re : re);
+    ab[k+1] = (accumulate ? ab[k+1] + im : im);
+  }
+}
 
-#endif /* #if ( SIMD_SZ == 4 )    * !defined(PFFFT_SIMD_DISABLE) */
 
+/* samples of one (2D) transform - for the instrumentation */
+#define INSTR_SAMPLES(s)  ((unsigned long long)(s)->Nrows * (unsigned long long)(s)->N)
 
 void FUNC_TRANSFORM_UNORDRD(SETUP_STRUCT *setup, const float *input, float *output, float *work, pffft_direction_t direction) {
-  FUNC_TRANSFORM_INTERNAL(setup, input, output, (v4sf*)work, direction, 0);
+  INSTR_BEGIN();
+  if (setup->blue)
+    transform_bluestein(setup, 1, input, 0, output, 0, work, direction);
+  else if (setup->Nrows > 1)
+    transform_2d(setup, input, output, work, direction, 0);
+  else
+    FUNC_TRANSFORM_INTERNAL(setup, 1, input, 0, output, 0, (v4sf*)work, direction, 0);
+  INSTR_END(&setup->instr.func[PFFFT_INSTR_TRANSFORM], INSTR_SAMPLES(setup));
 }
 
 void FUNC_TRANSFORM_ORDERED(SETUP_STRUCT *setup, const float *input, float *output, float *work, pffft_direction_t direction) {
-  FUNC_TRANSFORM_INTERNAL(setup, input, output, (v4sf*)work, direction, 1);
+  INSTR_BEGIN();
+  if (setup->blue)
+    transform_bluestein(setup, 1, input, 0, output, 0, work, direction);
+  else if (setup->Nrows > 1)
+    transform_2d(setup, input, output, work, direction, 1);
+  else
+    FUNC_TRANSFORM_INTERNAL(setup, 1, input, 0, output, 0, (v4sf*)work, direction, 1);
+  INSTR_END(&setup->instr.func[PFFFT_INSTR_TRANSFORM], INSTR_SAMPLES(setup));
+}
+
+void FUNC_TRANSFORM_BATCH(SETUP_STRUCT *setup, int count, const float *input, int input_stride,
+                          float *output, int output_stride, float *work, pffft_direction_t direction) {
+  int c;
+  INSTR_BEGIN();
+  if (setup->blue)
+    transform_bluestein(setup, count, input, input_stride, output, output_stride, work, direction);
+  else if (setup->Nrows > 1) {
+    for (c=0; c < count; ++c)
+      transform_2d(setup, input + c*input_stride, output + c*output_stride, work, direction, 0);
+  } else
+    FUNC_TRANSFORM_BATCH_INTERNAL(setup, count, input, input_stride, output, output_stride, work, direction, 0);
+  INSTR_END(&setup->instr.func[PFFFT_INSTR_TRANSFORM], count * INSTR_SAMPLES(setup));
+}
+
+void FUNC_TRANSFORM_ORD_BATCH(SETUP_STRUCT *setup, int count, const float *input, int input_stride,
+                              float *output, int output_stride, float *work, pffft_direction_t direction) {
+  int c;
+  INSTR_BEGIN();
+  if (setup->blue)
+    transform_bluestein(setup, count, input, input_stride, output, output_stride, work, direction);
+  else if (setup->Nrows > 1) {
+    for (c=0; c < count; ++c)
+      transform_2d(setup, input + c*input_stride, output + c*output_stride, work, direction, 1);
+  } else
+    FUNC_TRANSFORM_BATCH_INTERNAL(setup, count, input, input_stride, output, output_stride, work, direction, 1);
+  INSTR_END(&setup->instr.func[PFFFT_INSTR_TRANSFORM], count * INSTR_SAMPLES(setup));
+}
+
+/* two real signals - e.g. stereo channels - with one call: as a batch of
+   two transforms, when the distance of the buffers fits into the strides.
+   packing them into one complex transform of length N doesn't pay off:
+   a real transform already costs about half of a complex one */
+static void transform_pair(SETUP_STRUCT *setup, const float *input_a, const float *input_b,
+                           float *output_a, float *output_b, float *work, pffft_direction_t direction,
+                           int ordered) {
+  /* distances of the addresses: the buffers may belong to different arrays */
+  const ptrdiff_t ib = (ptrdiff_t)((uintptr_t)input_b - (uintptr_t)input_a);
+  const ptrdiff_t ob = (ptrdiff_t)((uintptr_t)output_b - (uintptr_t)output_a);
+  const ptrdiff_t is = ib / (ptrdiff_t)sizeof(float), os = ob / (ptrdiff_t)sizeof(float);
+  /* a batch transforms either all in-place - with a common stride - or none */
+  const int inplace_a = (input_a == output_a), inplace_b = (input_b == output_b);
+  if (ib % (ptrdiff_t)sizeof(float) == 0 && ob % (ptrdiff_t)sizeof(float) == 0
+      && is == (int)is && os == (int)os && inplace_a == inplace_b && (!inplace_a || is == os)) {
+    if (ordered)
+      FUNC_TRANSFORM_ORD_BATCH(setup, 2, input_a, (int)is, output_a, (int)os, work, direction);
+    else
+      FUNC_TRANSFORM_BATCH(setup, 2, input_a, (int)is, output_a, (int)os, work, direction);
+  } else {
+    if (ordered) {
+      FUNC_TRANSFORM_ORDERED(setup, input_a, output_a, work, direction);
+      FUNC_TRANSFORM_ORDERED(setup, input_b, output_b, work, direction);
+    } else {
+      FUNC_TRANSFORM_UNORDRD(setup, input_a, output_a, work, direction);
+      FUNC_TRANSFORM_UNORDRD(setup, input_b, output_b, work, direction);
+    }
+  }
+}
+
+void FUNC_TRANSFORM_PAIR(SETUP_STRUCT *setup, const float *input_a, const float *input_b,
+                         float *output_a, float *output_b, float *work, pffft_direction_t direction) {
+  transform_pair(setup, input_a, input_b, output_a, output_b, work, direction, 0);
+}
+
+void FUNC_TRANSFORM_ORD_PAIR(SETUP_STRUCT *setup, const float *input_a, const float *input_b,
+                             float *output_a, float *output_b, float *work, pffft_direction_t direction) {
+  transform_pair(setup, input_a, input_b, output_a, output_b, work, direction, 1);
+}
+
+#if defined(FUNC_TRANSFORM_HALF)
+
+/* 16-bit storage: groups of transforms are converted into a float buffer,
+   transformed in-place there with the batch transform and converted back */
+static void transform_half(SETUP_STRUCT *setup, pffft_half_t format, int count,
+                           const unsigned short *input, int input_stride,
+                           unsigned short *output, int output_stride,
+                           float *work, pffft_direction_t direction, int ordered) {
+  const int nf = (setup->transform == PFFFT_REAL ? 1 : 2) * setup->N * setup->Nrows;
+  /* floats per transform in the buffer: keeps the alignment */
+  const int bs = (nf + 2*SIMD_SZ - 1) / (2*SIMD_SZ) * (2*SIMD_SZ);
+  int c, k, group = PFFFT_BATCH_CACHE_BYTES / (3 * bs * (int)sizeof(float));
+  int stack_allocate;
+  if (count <= 0)
+    return;
+  if (group < 1)
+    group = 1;
+  if (group > count)
+    group = count;
+
+  /* 'work' has room for the buffer and the work of a single transform -
+     Bluestein's sizes need more, they allocate their own */
+  stack_allocate = (work == 0 || group > 1) ? group * bs / SIMD_SZ : 1;
+  {
+    VLA_ARRAY_ON_STACK(v4sf, buf_on_stack, stack_allocate);
+    float *buf = (work && group == 1) ? work : (float*)buf_on_stack;
+    float *twork = (work && group == 1 && !setup->blue) ? work + bs : 0;
+    for (c=0; c < count; c += group) {
+      const int n = (count - c < group) ? (count - c) : group;
+      for (k=0; k < n; ++k)
+        half_to_float_n(format, input + (c+k)*input_stride, buf + k*bs, nf);
+      if (ordered)
+        FUNC_TRANSFORM_ORD_BATCH(setup, n, buf, bs, buf, bs, twork, direction);
+      else
+        FUNC_TRANSFORM_BATCH(setup, n, buf, bs, buf, bs, twork, direction);
+      for (k=0; k < n; ++k)
+        float_to_half_n(format, buf + k*bs, output + (c+k)*output_stride, nf);
+    }
+  }
+}
+
+void FUNC_TRANSFORM_HALF(SETUP_STRUCT *setup, pffft_half_t format, int count,
+                         const unsigned short *input, int input_stride,
+                         unsigned short *output, int output_stride,
+                         float *work, pffft_direction_t direction) {
+  transform_half(setup, format, count, input, input_stride, output, output_stride, work, direction, 0);
+}
+
+void FUNC_TRANSFORM_ORD_HALF(SETUP_STRUCT *setup, pffft_half_t format, int count,
+                             const unsigned short *input, int input_stride,
+                             unsigned short *output, int output_stride,
+                             float *work, pffft_direction_t direction) {
+  transform_half(setup, format, count, input, input_stride, output, output_stride, work, direction, 1);
+}
+
+void FUNC_HALF_TO_FLOAT(pffft_half_t format, const unsigned short *input, float *output, int count) {
+  half_to_float_n(format, input, output, count);
+}
+
+void FUNC_FLOAT_TO_HALF(pffft_half_t format, const float *input, unsigned short *output, int count) {
+  float_to_half_n(format, input, output, count);
+}
+
+#endif
+
+void FUNC_ZREORDER(SETUP_STRUCT *setup, const float *in, float *out, pffft_direction_t direction) {
+  const int Nf = 2*setup->Ncvec*SIMD_SZ;
+  int r;
+  INSTR_BEGIN();
+  if (setup->blue) {  /* ordered layout, already */
+    if (in != out)
+      memmove(out, in, (setup->transform == PFFFT_REAL ? 1 : 2) * (size_t)setup->N * sizeof(float));
+  } else {
+    for (r=0; r < setup->Nrows; ++r)
+      zreorder_1d(setup, in + r*Nf, out + r*Nf, direction);
+  }
+  INSTR_END(&setup->instr.func[PFFFT_INSTR_ZREORDER], INSTR_SAMPLES(setup));
+}
+
+/* |X|^2 of the unordered spectrum, in the order of zreorder_1d().
+   packed: 'in' is a power accumulator of FUNC_ZPOWER_ACCUMULATE() - with
+   the squares already summed up - instead of a spectrum */
+static void zpower_1d(SETUP_STRUCT *setup, const float *in, float *out, int packed) {
+#if ( SIMD_SZ == 1 )
+  const int N = setup->N;
+  int k;
+  if (packed) {  /* the accumulator is in natural order */
+    memcpy(out, in, (size_t)((setup->transform == PFFFT_REAL) ? N/2+1 : N) * sizeof(float));
+  } else if (setup->transform == PFFFT_REAL) {  /* fftpack layout */
+    out[0] = in[0] * in[0];
+    for (k=1; k < N/2; ++k)
+      out[k] = in[2*k-1] * in[2*k-1] + in[2*k] * in[2*k];
+    out[N/2] = in[N-1] * in[N-1];
+  } else {
+    for (k=0; k < N; ++k)
+      out[k] = in[2*k] * in[2*k] + in[2*k+1] * in[2*k+1];
+  }
+#else
+  const int Ncvec = setup->Ncvec;
+  const v4sf *vin = (const v4sf*)in;
+  v4sf_union p;
+  int k, m, j;
+  /* power of the vector pair c: vector c+1 of the accumulator - but vector 0 for c = 0 */
+#define ZPOWER_PAIR(c)  ( packed ? vin[(c) ? (c)+1 : 0] : VADD(VMUL(vin[2*(c)], vin[2*(c)]), VMUL(vin[2*(c)+1], vin[2*(c)+1])) )
+  if (setup->transform == PFFFT_REAL) {
+    const int n = 2*Ncvec, dk = Ncvec/SIMD_SZ;
+    for (k=0; k < dk; ++k) {
+      for (m=0; m < SIMD_SZ; ++m) {
+        p.v = ZPOWER_PAIR(SIMD_SZ*k + m);
+        if ((m & 1) == 0) {
+          /* X[q + (m/2)*n] for q = SIMD_SZ*k .. SIMD_SZ*k + SIMD_SZ-1 */
+          memcpy(out + SIMD_SZ*k + (m/2)*n, p.f, sizeof(v4sf));
+        } else {
+          /* X[(m/2+1)*n - q], mirrored */
+          for (j=0; j < SIMD_SZ; ++j) {
+            const int q = SIMD_SZ*k + j;
+            out[q ? (m/2+1)*n - q : n/2 + (m/2)*n] = p.f[j];
+          }
+        }
+      }
+    }
+    /* lane 0 of the first vectors: X[0] and X[N/2] */
+    out[0] = packed ? in[0] : in[0] * in[0];
+    out[setup->N/2] = packed ? in[SIMD_SZ] : in[SIMD_SZ] * in[SIMD_SZ];
+  } else {
+    for (k=0; k < Ncvec; ++k) {
+      const int kk = (k/SIMD_SZ) + (k%SIMD_SZ)*(Ncvec/SIMD_SZ);
+      p.v = ZPOWER_PAIR(k);
+      memcpy(out + SIMD_SZ*kk, p.f, sizeof(v4sf));
+    }
+  }
+#undef ZPOWER_PAIR
+#endif
+}
+
+/* acc += |X|^2 * scaling, in the layout of zreal_pack_1d(): the first
+   vector holds the powers of the first vector pair - with X[0] in lane 0
+   of real transforms, the second vector X[N/2] in lane 0, then one vector
+   for each further vector pair. without SIMD, acc is in natural order */
+static void zpower_accumulate_1d(SETUP_STRUCT *s, const float *a, float *acc, float scaling) {
+#if ( SIMD_SZ == 1 )
+  const int N = s->N;
+  int k;
+  if (s->transform == PFFFT_REAL) {  /* fftpack layout */
+    acc[0] += a[0] * a[0] * scaling;
+    for (k=1; k < N/2; ++k)
+      acc[k] += (a[2*k-1] * a[2*k-1] + a[2*k] * a[2*k]) * scaling;
+    acc[N/2] += a[N-1] * a[N-1] * scaling;
+  } else {
+    for (k=0; k < N; ++k)
+      acc[k] += (a[2*k] * a[2*k] + a[2*k+1] * a[2*k+1]) * scaling;
+  }
+#else
+  const v4sf vscal = LD_PS1(scaling);
+  const v4sf * RESTRICT va = (const v4sf*)a;
+  v4sf * RESTRICT vacc = (v4sf*)acc;
+  const int Ncvec = s->Ncvec;
+  const float sar = ((const v4sf_union*)va)[0].f[0];
+  const float sai = ((const v4sf_union*)va)[1].f[0];
+  const float s0 = ((v4sf_union*)vacc)[0].f[0];
+  const float s1 = ((v4sf_union*)vacc)[1].f[0];
+  int k;
+
+  assert(VALIGNED(a) && VALIGNED(acc));
+  vacc[0] = VMADD(VADD(VMUL(va[0], va[0]), VMUL(va[1], va[1])), vscal, vacc[0]);
+  for (k=1; k+1 < Ncvec; k += 2) {
+    const v4sf p0 = VADD(VMUL(va[2*k+0], va[2*k+0]), VMUL(va[2*k+1], va[2*k+1]));
+    const v4sf p1 = VADD(VMUL(va[2*k+2], va[2*k+2]), VMUL(va[2*k+3], va[2*k+3]));
+    vacc[k+1] = VMADD(p0, vscal, vacc[k+1]);
+    vacc[k+2] = VMADD(p1, vscal, vacc[k+2]);
+  }
+  if (k < Ncvec)
+    vacc[k+1] = VMADD(VADD(VMUL(va[2*k], va[2*k]), VMUL(va[2*k+1], va[2*k+1])), vscal, vacc[k+1]);
+
+  if (s->transform == PFFFT_REAL) {
+    ((v4sf_union*)vacc)[0].f[0] = s0 + sar*sar*scaling;
+    ((v4sf_union*)vacc)[1].f[0] = s1 + sai*sai*scaling;
+  }
+#endif
+}
+
+void FUNC_ZPOWER(SETUP_STRUCT *setup, const float *dft, float *power) {
+  const int N = setup->N;
+  int k;
+  assert(setup->Nrows == 1);
+  INSTR_BEGIN();
+  if (setup->blue) {  /* ordered layout */
+    if (setup->transform == PFFFT_REAL) {
+      power[0] = dft[0] * dft[0];
+      power[N/2] = dft[1] * dft[1];
+      for (k=1; k < N/2; ++k)
+        power[k] = dft[2*k] * dft[2*k] + dft[2*k+1] * dft[2*k+1];
+    } else {
+      for (k=0; k < N; ++k)
+        power[k] = dft[2*k] * dft[2*k] + dft[2*k+1] * dft[2*k+1];
+    }
+  } else
+    zpower_1d(setup, dft, power, 0);
+  INSTR_END(&setup->instr.func[PFFFT_INSTR_ZREORDER], INSTR_SAMPLES(setup));
+}
+
+void FUNC_ZPOWER_ACCUMULATE(SETUP_STRUCT *setup, const float *dft, float *acc, float scaling) {
+  const int N = setup->N;
+  int k;
+  assert(setup->Nrows == 1);
+  INSTR_BEGIN();
+  if (setup->blue) {  /* ordered layout - the accumulator in natural order */
+    if (setup->transform == PFFFT_REAL) {
+      acc[0] += dft[0] * dft[0] * scaling;
+      acc[N/2] += dft[1] * dft[1] * scaling;
+      for (k=1; k < N/2; ++k)
+        acc[k] += (dft[2*k] * dft[2*k] + dft[2*k+1] * dft[2*k+1]) * scaling;
+    } else {
+      for (k=0; k < N; ++k)
+        acc[k] += (dft[2*k] * dft[2*k] + dft[2*k+1] * dft[2*k+1]) * scaling;
+    }
+  } else
+    zpower_accumulate_1d(setup, dft, acc, scaling);
+  INSTR_END(&setup->instr.func[PFFFT_INSTR_ZCONVOLVE], INSTR_SAMPLES(setup));
+}
+
+void FUNC_ZPOWER_UNPACK(SETUP_STRUCT *setup, const float *acc, float *power) {
+  const int N = setup->N;
+  assert(setup->Nrows == 1);
+  INSTR_BEGIN();
+  if (setup->blue)
+    memcpy(power, acc, (size_t)((setup->transform == PFFFT_REAL) ? N/2+1 : N) * sizeof(float));
+  else
+    zpower_1d(setup, acc, power, 1);
+  INSTR_END(&setup->instr.func[PFFFT_INSTR_ZREORDER], INSTR_SAMPLES(setup));
+}
+
+/* spectral operations on the unordered layout of FUNC_TRANSFORM_INTERNAL:
+   the complex bins come in vector pairs - SIMD_SZ real parts in one vector,
+   the imaginary parts in the next one. real transforms keep the real X[0]
+   and X[N/2] in lane 0 of pair 0. without SIMD, pair c is bin c, at 2*c-1
+   in the fftpack layout of real transforms - with X[N/2] at the end.
+   per-bin real values use the packed layout of zreal_pack_1d(): pair 0
+   complete, then one vector per further pair */
+
+/* offset of the real parts of pair c > 0 */
+static ALWAYS_INLINE(int) zpair_offset(const SETUP_STRUCT *s, int c) {
+#if ( SIMD_SZ == 1 )
+  return (s->transform == PFFFT_REAL) ? 2*c-1 : 2*c;
+#else
+  (void)s;
+  return 2*SIMD_SZ*c;
+#endif
+}
+
+/* offset of the imaginary parts of pair 0: X[N/2] of real transforms without SIMD */
+static ALWAYS_INLINE(int) zpair0_im_offset(const SETUP_STRUCT *s) {
+#if ( SIMD_SZ == 1 )
+  return (s->transform == PFFFT_REAL) ? s->N - 1 : 1;
+#else
+  (void)s;
+  return SIMD_SZ;
+#endif
+}
+
+/* the bin of lane j of pair c: the inverse of zreorder_1d().
+   lane 0 of pair 0 is X[0] - for real transforms also X[N/2] */
+static int zpair_bin(const SETUP_STRUCT *s, int c, int j) {
+#if ( SIMD_SZ == 1 )
+  (void)s; (void)j;
+  return c;
+#else
+  const int Ncvec = s->Ncvec;
+  if (s->transform == PFFFT_REAL) {
+    const int n = 2*Ncvec, k = c / SIMD_SZ, m = c % SIMD_SZ, q = SIMD_SZ*k + j;
+    if ((m & 1) == 0)
+      return q + (m/2)*n;
+    return q ? (m/2+1)*n - q : n/2 + (m/2)*n;  /* mirrored */
+  }
+  return SIMD_SZ*((c/SIMD_SZ) + (c%SIMD_SZ)*(Ncvec/SIMD_SZ)) + j;
+#endif
+}
+
+void FUNC_ZBIN_INDEX(SETUP_STRUCT *s, int *re_offset, int *im_offset, int *packed_offset) {
+  const int Ncvec = s->Ncvec;
+  int c, j;
+  assert(!s->blue && s->Nrows == 1);  /* 1D transforms with native sizes only */
+  for (c=0; c < Ncvec; ++c) {
+    for (j=0; j < SIMD_SZ; ++j) {
+      const int b = zpair_bin(s, c, j);
+      if (re_offset)
+        re_offset[b] = c ? zpair_offset(s, c) + j : j;
+      if (im_offset)
+        im_offset[b] = c ? zpair_offset(s, c) + SIMD_SZ + j : zpair0_im_offset(s) + j;
+      if (packed_offset)
+        packed_offset[b] = c ? SIMD_SZ*(c+1) + j : j;
+    }
+  }
+  if (s->transform == PFFFT_REAL) {  /* the real X[0] and X[N/2] */
+    if (re_offset) {
+      re_offset[0] = 0;
+      re_offset[s->N/2] = zpair0_im_offset(s);
+    }
+    if (im_offset)
+      im_offset[0] = im_offset[s->N/2] = -1;
+    if (packed_offset) {
+      packed_offset[0] = 0;
+      packed_offset[s->N/2] = SIMD_SZ;
+    }
+  }
+}
+
+/* |X| or arg(X) of each bin into the packed layout. the unused lanes
+   of the second vector are zeroed: the output is a valid gain for
+   zconvolve_real_1d() */
+static void zmagnitude_1d(SETUP_STRUCT *s, const float *a, float *out, int phase) {
+  const int Ncvec = s->Ncvec;
+  const int real = (s->transform == PFFFT_REAL);
+  const float a0 = a[0], aN = a[zpair0_im_offset(s)];
+  v4sf_union r, i, y;
+  int c, j;
+
+  assert(VALIGNED(a) && VALIGNED(out));
+  for (c=0; c < Ncvec; ++c) {
+    r.v = *(const v4sf*)(a + (c ? zpair_offset(s, c) : 0));
+    i.v = *(const v4sf*)(a + (c ? zpair_offset(s, c) + SIMD_SZ : zpair0_im_offset(s)));
+    if (phase) {
+      for (j=0; j < SIMD_SZ; ++j)
+        y.f[j] = FUNC_ATAN2(i.f[j], r.f[j]);
+    } else {
+      y.v = VADD(VMUL(r.v, r.v), VMUL(i.v, i.v));
+      for (j=0; j < SIMD_SZ; ++j)
+        y.f[j] = FUNC_SQRT(y.f[j]);
+    }
+    *(v4sf*)(out + (c ? SIMD_SZ*(c+1) : 0)) = y.v;
+  }
+  *(v4sf*)(out + SIMD_SZ) = VZERO();
+  if (real) {  /* the real X[0] and X[N/2] */
+    out[0] = phase ? FUNC_ATAN2(0, a0) : (float)fabs(a0);
+    out[SIMD_SZ] = phase ? FUNC_ATAN2(0, aN) : (float)fabs(aN);
+  }
+}
+
+/* ab = a * conj(b) * scaling - or a * conj(b) / (|b|^2 + eps) with divide */
+static void zconj_multiply_1d(SETUP_STRUCT *s, const float *a, const float *b, float *ab,
+                              float scaling, float eps, int divide) {
+  const int Ncvec = s->Ncvec;
+  const int i0 = zpair0_im_offset(s);
+  const v4sf vscal = LD_PS1(scaling), veps = LD_PS1(eps);
+  const float a0 = a[0], aN = a[i0], b0 = b[0], bN = b[i0];
+  int c, j;
+
+  assert(VALIGNED(a) && VALIGNED(b) && VALIGNED(ab));
+  for (c=0; c < Ncvec; ++c) {
+    const int ore = c ? zpair_offset(s, c) : 0;
+    const int oim = c ? ore + SIMD_SZ : i0;
+    v4sf ar = *(const v4sf*)(a + ore), ai = *(const v4sf*)(a + oim);
+    const v4sf br = *(const v4sf*)(b + ore), bi = *(const v4sf*)(b + oim);
+    VCPLXMULCONJ(ar, ai, br, bi);
+    if (divide) {
+      v4sf_union g;
+      g.v = VADD(VADD(VMUL(br, br), VMUL(bi, bi)), veps);
+      for (j=0; j < SIMD_SZ; ++j)
+        g.f[j] = 1.0f / g.f[j];
+      ar = VMUL(ar, g.v);
+      ai = VMUL(ai, g.v);
+    } else {
+      ar = VMUL(ar, vscal);
+      ai = VMUL(ai, vscal);
+    }
+    *(v4sf*)(ab + ore) = ar;
+    *(v4sf*)(ab + oim) = ai;
+  }
+  if (s->transform == PFFFT_REAL) {  /* the real X[0] and X[N/2] */
+    ab[0] = divide ? a0 * b0 / (b0 * b0 + eps) : a0 * b0 * scaling;
+    ab[i0] = divide ? aN * bN / (bN * bN + eps) : aN * bN * scaling;
+  }
+}
+
+/* the phasors exp(-j*2*pi*delay*k/N) of the lanes of pair c */
+static void zdelay_phasors(SETUP_STRUCT *s, int c, double delay, v4sf *pr, v4sf *pi) {
+  v4sf_union r, i;
+  int j;
+  for (j=0; j < SIMD_SZ; ++j) {
+    int b = zpair_bin(s, c, j);
+    double phi;
+    if (s->transform != PFFFT_REAL && 2*b >= s->N)
+      b -= s->N;  /* negative frequency */
+    phi = -2.0 * M_PI * delay * b / s->N;
+    r.f[j] = (float)cos(phi);
+    i.f[j] = (float)sin(phi);
+  }
+  *pr = r.v;
+  *pi = i.v;
+}
+
+/* out = a * exp(-j*2*pi*delay*k/N): for each residue r, the bins of the
+   pairs c = r, r + SIMD_SZ, .. advance by +/- SIMD_SZ (see zpair_bin()).
+   the phasors are advanced by complex multiplication - and recomputed
+   every few pairs, on the irregular first step of mirrored pairs and
+   where complex transforms reach the negative frequencies */
+static void zdelay_1d(SETUP_STRUCT *s, const float *a, float *out, float delay) {
+  const int Ncvec = s->Ncvec, count = Ncvec / SIMD_SZ;
+  const int real = (s->transform == PFFFT_REAL);
+  const int i0 = zpair0_im_offset(s);
+  const float aN = a[i0];
+  int r, i;
+
+  assert(VALIGNED(a) && VALIGNED(out));
+  for (r=0; r < SIMD_SZ; ++r) {
+    const int step = (real && (r & 1)) ? -SIMD_SZ : SIMD_SZ;
+    const int negStart = real ? -1 : Ncvec/2 - r*count;
+    const double phi = -2.0 * M_PI * (double)delay * step / s->N;
+    const v4sf wr = LD_PS1((float)cos(phi)), wi = LD_PS1((float)sin(phi));
+    v4sf pr = VZERO(), pi = VZERO();
+    for (i=0; i < count; ++i) {
+      const int c = SIMD_SZ*i + r;
+      const int ore = c ? zpair_offset(s, c) : 0;
+      const int oim = c ? ore + SIMD_SZ : i0;
+      v4sf xr, xi;
+      if ((i & 31) == 0 || i == 1 || i == negStart)
+        zdelay_phasors(s, c, delay, &pr, &pi);
+      else
+        VCPLXMUL(pr, pi, wr, wi);
+      xr = *(const v4sf*)(a + ore);
+      xi = *(const v4sf*)(a + oim);
+      VCPLXMUL(xr, xi, pr, pi);
+      *(v4sf*)(out + ore) = xr;
+      *(v4sf*)(out + oim) = xi;
+    }
+  }
+  if (real) {  /* X[0] stays, the real X[N/2] of a fractional delay: cos() */
+    out[i0] = aN * (float)cos(M_PI * (double)delay);
+  }
+}
+
+void FUNC_ZMAGNITUDE(SETUP_STRUCT *s, const float *dft, float *mag) {
+  INSTR_BEGIN();
+  assert(!s->blue && s->Nrows == 1);
+  zmagnitude_1d(s, dft, mag, 0);
+  INSTR_END(&s->instr.func[PFFFT_INSTR_ZCONVOLVE], INSTR_SAMPLES(s));
+}
+
+void FUNC_ZPHASE(SETUP_STRUCT *s, const float *dft, float *phase) {
+  INSTR_BEGIN();
+  assert(!s->blue && s->Nrows == 1);
+  zmagnitude_1d(s, dft, phase, 1);
+  INSTR_END(&s->instr.func[PFFFT_INSTR_ZCONVOLVE], INSTR_SAMPLES(s));
+}
+
+void FUNC_ZCONJ_MULTIPLY(SETUP_STRUCT *s, const float *a, const float *b, float *ab, float scaling) {
+  INSTR_BEGIN();
+  assert(!s->blue && s->Nrows == 1);
+  zconj_multiply_1d(s, a, b, ab, scaling, 0, 0);
+  INSTR_END(&s->instr.func[PFFFT_INSTR_ZCONVOLVE], INSTR_SAMPLES(s));
+}
+
+void FUNC_ZDIVIDE(SETUP_STRUCT *s, const float *a, const float *b, float *ab, float eps) {
+  INSTR_BEGIN();
+  assert(!s->blue && s->Nrows == 1);
+  zconj_multiply_1d(s, a, b, ab, 1, eps, 1);
+  INSTR_END(&s->instr.func[PFFFT_INSTR_ZCONVOLVE], INSTR_SAMPLES(s));
+}
+
+void FUNC_ZDELAY(SETUP_STRUCT *s, const float *dft, float *out, float delay) {
+  INSTR_BEGIN();
+  assert(!s->blue && s->Nrows == 1);
+  zdelay_1d(s, dft, out, delay);
+  INSTR_END(&s->instr.func[PFFFT_INSTR_ZCONVOLVE], INSTR_SAMPLES(s));
+}
+
+void FUNC_ZCONVOLVE_ACCUMULATE(SETUP_STRUCT *s, const float *a, const float *b, float *ab, float scaling) {
+  INSTR_BEGIN();
+  if (s->blue)
+    zconvolve_bluestein(s, a, b, ab, scaling, 1);
+  else if (s->Nrows > 1)
+    zconvolve_2d(s, a, b, ab, scaling, 1);
+  else
+    zconvolve_accumulate_1d(s, a, b, ab, scaling);
+  INSTR_END(&s->instr.func[PFFFT_INSTR_ZCONVOLVE], INSTR_SAMPLES(s));
+}
+
+void FUNC_ZCONVOLVE_NO_ACCU(SETUP_STRUCT *s, const float *a, const float *b, float *ab, float scaling) {
+  INSTR_BEGIN();
+  if (s->blue)
+    zconvolve_bluestein(s, a, b, ab, scaling, 0);
+  else if (s->Nrows > 1)
+    zconvolve_2d(s, a, b, ab, scaling, 0);
+  else
+    zconvolve_no_accu_1d(s, a, b, ab, scaling);
+  INSTR_END(&s->instr.func[PFFFT_INSTR_ZCONVOLVE], INSTR_SAMPLES(s));
+}
+
+void FUNC_ZCONVOLVE_TRANSFORM_BW(SETUP_STRUCT *s, const float *a, const float *b, float *output, float *work, float scaling) {
+#if ( SIMD_SZ >= 4 )
+  if (!s->blue && s->Nrows == 1) {
+    INSTR_BEGIN();
+    zconvolve_transform_backward_1d(s, a, b, output, (v4sf*)work, scaling);
+    INSTR_END(&s->instr.func[PFFFT_INSTR_ZCONVOLVE_TRANSFORM_BW], INSTR_SAMPLES(s));
+    return;
+  }
+#endif
+  /* not fused: fftpack layout without SIMD, Bluestein and 2D.
+     the instrumentation counts both calls */
+  FUNC_ZCONVOLVE_NO_ACCU(s, a, b, output, scaling);
+  FUNC_TRANSFORM_UNORDRD(s, output, output, work, PFFFT_BACKWARD);
+}
+
+void FUNC_ZREAL_PACK(SETUP_STRUCT *s, const float *dft_b, float *real_b) {
+  assert(!s->blue && s->Nrows == 1);  /* 1D transforms with native sizes only */
+  zreal_pack_1d(s, dft_b, real_b);
+}
+
+void FUNC_ZCONVOLVE_REAL_ACCUMULATE(SETUP_STRUCT *s, const float *a, const float *real_b, float *ab, float scaling) {
+  INSTR_BEGIN();
+  assert(!s->blue && s->Nrows == 1);
+  zconvolve_real_1d(s, a, real_b, ab, scaling, 1);
+  INSTR_END(&s->instr.func[PFFFT_INSTR_ZCONVOLVE], INSTR_SAMPLES(s));
+}
+
+void FUNC_ZCONVOLVE_REAL_NO_ACCU(SETUP_STRUCT *s, const float *a, const float *real_b, float *ab, float scaling) {
+  INSTR_BEGIN();
+  assert(!s->blue && s->Nrows == 1);
+  zconvolve_real_1d(s, a, real_b, ab, scaling, 0);
+  INSTR_END(&s->instr.func[PFFFT_INSTR_ZCONVOLVE], INSTR_SAMPLES(s));
+}
+
+int FUNC_GET_INSTR(const SETUP_STRUCT *s, pffft_instr_snapshot_t *snapshot) {
+#if defined(PFFFT_ENABLE_INSTRUMENTATION)
+  int f;
+  for (f=0; f < PFFFT_INSTR_NUM; ++f)
+    instr_read(&s->instr.func[f], &snapshot->func[f]);
+  return 1;
+#else
+  (void)s;
+  memset(snapshot, 0, sizeof(*snapshot));
+  return 0;
+#endif
+}
+
+void FUNC_RESET_INSTR(SETUP_STRUCT *s) {
+#if defined(PFFFT_ENABLE_INSTRUMENTATION)
+  int f;
+  for (f=0; f < PFFFT_INSTR_NUM; ++f)
+    instr_clear(&s->instr.func[f]);
+#else
+  (void)s;
+#endif
 }
 
 
@@ -2216,6 +4651,118 @@ int FUNC_VALIDATE_SIMD_EX(FILE * DbgOut)
   return numErrs;
 }
 
+#elif ( SIMD_SZ > 4 )
+
+/* compare all elements of v with ref[], print and count mismatches */
+static int pffft_check_wide(const v4sf_union *v, const float *ref, const char * functxt, FILE * DbgOut, const char * f, int lineNo)
+{
+  int k, numErrs = 0;
+  if (DbgOut) {
+    fprintf(DbgOut, "%s => [", functxt);
+    for (k = 0; k < SIMD_SZ; ++k)
+      fprintf(DbgOut, " %g", v->f[k]);
+    fprintf(DbgOut, " ]\n");
+  }
+  for (k = 0; k < SIMD_SZ; ++k) {
+    if ( !( fabs( v->f[k] - ref[k] ) < 0.01F ) ) {
+      fprintf(stderr, "%s: assert for [%d] at %s(%d)\n  expected %f  value %f\n", functxt, k, f, lineNo, ref[k], v->f[k]);
+      ++numErrs;
+    }
+  }
+  return numErrs;
+}
+
+#define PFFFT_CHECK_WIDE( V, REF, FUNCTXT )  numErrs += pffft_check_wide( &(V), REF, FUNCTXT, DbgOut, __FILE__, __LINE__ )
+
+int FUNC_VALIDATE_SIMD_EX(FILE * DbgOut)
+{
+  int numErrs = 0;
+  int k, j;
+  v4sf_union a, b, c, d, r[SIMD_SZ];
+  float ref[SIMD_SZ], ref2[SIMD_SZ];
+
+  for ( k = 0; k < SIMD_SZ; ++k ) {
+    a.f[k] = (float)(k + 1);
+    b.f[k] = (float)(k + 1 + SIMD_SZ);
+    c.f[k] = (float)(k + 1 + 2*SIMD_SZ);
+  }
+
+  d.v = VZERO();
+  for ( k = 0; k < SIMD_SZ; ++k ) ref[k] = 0;
+  PFFFT_CHECK_WIDE( d, ref, "VZERO()" );
+
+  d.v = LD_PS1(42.0F);
+  for ( k = 0; k < SIMD_SZ; ++k ) ref[k] = 42;
+  PFFFT_CHECK_WIDE( d, ref, "LD_PS1(42)" );
+
+  d.v = VADD(a.v, b.v);
+  for ( k = 0; k < SIMD_SZ; ++k ) ref[k] = a.f[k] + b.f[k];
+  PFFFT_CHECK_WIDE( d, ref, "VADD(a,b)" );
+
+  d.v = VSUB(a.v, b.v);
+  for ( k = 0; k < SIMD_SZ; ++k ) ref[k] = a.f[k] - b.f[k];
+  PFFFT_CHECK_WIDE( d, ref, "VSUB(a,b)" );
+
+  d.v = VMUL(a.v, b.v);
+  for ( k = 0; k < SIMD_SZ; ++k ) ref[k] = a.f[k] * b.f[k];
+  PFFFT_CHECK_WIDE( d, ref, "VMUL(a,b)" );
+
+  d.v = VMADD(a.v, b.v, c.v);
+  for ( k = 0; k < SIMD_SZ; ++k ) ref[k] = a.f[k] * b.f[k] + c.f[k];
+  PFFFT_CHECK_WIDE( d, ref, "VMADD(a,b,c)" );
+
+  INTERLEAVE2(a.v, b.v, c.v, d.v);
+  for ( k = 0; k < SIMD_SZ/2; ++k ) {
+    ref[2*k] = a.f[k];  ref[2*k+1] = b.f[k];
+    ref2[2*k] = a.f[k+SIMD_SZ/2];  ref2[2*k+1] = b.f[k+SIMD_SZ/2];
+  }
+  PFFFT_CHECK_WIDE( c, ref, "INTERLEAVE2(a,b) out1" );
+  PFFFT_CHECK_WIDE( d, ref2, "INTERLEAVE2(a,b) out2" );
+
+  UNINTERLEAVE2(a.v, b.v, c.v, d.v);
+  for ( k = 0; k < SIMD_SZ/2; ++k ) {
+    ref[k] = a.f[2*k];  ref[k+SIMD_SZ/2] = b.f[2*k];
+    ref2[k] = a.f[2*k+1];  ref2[k+SIMD_SZ/2] = b.f[2*k+1];
+  }
+  PFFFT_CHECK_WIDE( c, ref, "UNINTERLEAVE2(a,b) out1" );
+  PFFFT_CHECK_WIDE( d, ref2, "UNINTERLEAVE2(a,b) out2" );
+
+  d.v = VSWAPHL(a.v, b.v);
+  for ( k = 0; k < SIMD_SZ; ++k ) ref[k] = (k < SIMD_SZ/2) ? b.f[k] : a.f[k];
+  PFFFT_CHECK_WIDE( d, ref, "VSWAPHL(a,b)" );
+
+  d.v = VREV_S(a.v);
+  for ( k = 0; k < SIMD_SZ; ++k ) ref[k] = a.f[SIMD_SZ-1-k];
+  PFFFT_CHECK_WIDE( d, ref, "VREV_S(a)" );
+
+  d.v = VREV_C(a.v);
+  for ( k = 0; k < SIMD_SZ; k += 2 ) { ref[k] = a.f[SIMD_SZ-2-k]; ref[k+1] = a.f[SIMD_SZ-1-k]; }
+  PFFFT_CHECK_WIDE( d, ref, "VREV_C(a)" );
+
+  {
+    v4sf t[SIMD_SZ];
+    for ( j = 0; j < SIMD_SZ; ++j ) {
+      for ( k = 0; k < SIMD_SZ; ++k ) r[j].f[k] = (float)(j*SIMD_SZ + k);
+      t[j] = r[j].v;
+    }
+    VTRANSPOSE_S(t);
+    for ( j = 0; j < SIMD_SZ; ++j ) {
+      r[j].v = t[j];
+      for ( k = 0; k < SIMD_SZ; ++k ) ref[k] = (float)(k*SIMD_SZ + j);
+      PFFFT_CHECK_WIDE( r[j], ref, "VTRANSPOSE_S() row" );
+    }
+  }
+
+  return numErrs;
+}
+
+void FUNC_VALIDATE_SIMD_A()
+{
+  int numErrs = FUNC_VALIDATE_SIMD_EX(stdout);
+  assert(numErrs == 0);
+  (void)numErrs;
+}
+
 #else  /* if ( SIMD_SZ == 4 ) */
 
 void FUNC_VALIDATE_SIMD_A()
@@ -0,0 +1,207 @@
+/*
+   PFFFT_PSD : averaged power spectrum (Welch's method) - see pffft_psd.h
+
+   per segment, there are three passes over N samples:
+   - the windowed copy of the segment into an aligned buffer
+   - the unordered forward transform: pffft_transform()
+   - pffft_zpower_accumulate(): |X|^2 is added in the internal layout
+
+   the float sums are folded into double sums every FOLD_SEGMENTS
+   segments: the float pass stays cheap, but the rounding doesn't grow
+   with millions of segments. pffft_psd_read() scales the sums into float
+   and calls pffft_zpower_unpack() once.
+*/
+
+#include "pffft_psd.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FOLD_SEGMENTS 256
+
+
+struct PFFFT_PSD
+{
+  int N;
+  int ns;               /* floats per sample: 1 (real) or 2 (complex) */
+  int nbins;            /* N/2+1 (real) or N (complex) */
+  int nacc;             /* floats of the accumulator: N*ns/2 + pffft_simd_size() */
+  double wsum2;         /* sum of w[n]^2 */
+  PFFFT_Setup *fft;
+  float *window;        /* N * ns floats: duplicated for (re, im) */
+};
+
+struct PFFFT_PSD_Acc
+{
+  const PFFFT_PSD *psd;
+  long long segments;   /* all accumulated segments */
+  int pending;          /* segments in facc, not yet in dacc */
+  float *facc;          /* aligned: float sums of pffft_zpower_accumulate() */
+  double *dacc;         /* double sums, in the same internal layout */
+  float *buf;           /* aligned: windowed segment, transformed in-place - or the scaled sums */
+  float *work;          /* aligned: work of the transform */
+};
+
+
+PFFFT_PSD *pffft_psd_new(int N, pffft_transform_t transform, const float *window)
+{
+  PFFFT_PSD *psd;
+  int ns, k;
+  double wsum2 = 0.0;
+
+  if (N <= 0)
+    return NULL;
+  psd = (PFFFT_PSD*)calloc(1, sizeof(PFFFT_PSD));
+  if (!psd)
+    return NULL;
+  ns = (transform == PFFFT_COMPLEX) ? 2 : 1;
+  psd->N = N;
+  psd->ns = ns;
+  psd->nbins = (ns == 2) ? N : (N / 2 + 1);
+  psd->nacc = ns * N / 2 + pffft_simd_size();
+  psd->fft = pffft_new_setup(N, transform);
+  psd->window = (float*)malloc((size_t)ns * N * sizeof(float));
+  if (!psd->fft || !psd->window) {
+    pffft_psd_destroy(psd);
+    return NULL;
+  }
+
+  for (k = 0; k < N; ++k) {
+    const float w = window ? window[k] : (float)( 0.5 - 0.5 * cos(2.0 * M_PI * k / N) );
+    psd->window[ns*k] = w;
+    if (ns == 2)
+      psd->window[ns*k + 1] = w;
+    wsum2 += (double)w * w;
+  }
+  psd->wsum2 = wsum2;
+  return psd;
+}
+
+
+void pffft_psd_destroy(PFFFT_PSD *psd)
+{
+  if (!psd)
+    return;
+  if (psd->fft)
+    pffft_destroy_setup(psd->fft);
+  free(psd->window);
+  free(psd);
+}
+
+
+int pffft_psd_bins(const PFFFT_PSD *psd)
+{
+  return psd->nbins;
+}
+
+
+PFFFT_PSD_Acc *pffft_psd_acc_new(PFFFT_PSD *psd)
+{
+  PFFFT_PSD_Acc *acc = (PFFFT_PSD_Acc*)calloc(1, sizeof(PFFFT_PSD_Acc));
+  const size_t nf = (size_t)psd->ns * psd->N;
+  const size_t nb = (nf > (size_t)psd->nacc) ? nf : (size_t)psd->nacc;
+  const size_t nw = (size_t)pffft_work_size(psd->fft);
+  if (!acc)
+    return NULL;
+  acc->psd = psd;
+  acc->facc = (float*)pffft_aligned_malloc((size_t)psd->nacc * sizeof(float));
+  acc->dacc = (double*)malloc((size_t)psd->nacc * sizeof(double));
+  acc->buf = (float*)pffft_aligned_malloc(nb * sizeof(float));
+  acc->work = (float*)pffft_aligned_malloc(nw * sizeof(float));
+  if (!acc->facc || !acc->dacc || !acc->buf || !acc->work) {
+    pffft_psd_acc_destroy(acc);
+    return NULL;
+  }
+  pffft_psd_acc_reset(acc);
+  return acc;
+}
+
+
+void pffft_psd_acc_destroy(PFFFT_PSD_Acc *acc)
+{
+  if (!acc)
+    return;
+  pffft_aligned_free(acc->facc);
+  free(acc->dacc);
+  pffft_aligned_free(acc->buf);
+  pffft_aligned_free(acc->work);
+  free(acc);
+}
+
+
+void pffft_psd_acc_reset(PFFFT_PSD_Acc *acc)
+{
+  const int nacc = acc->psd->nacc;
+  int k;
+  memset(acc->facc, 0, (size_t)nacc * sizeof(float));
+  for (k = 0; k < nacc; ++k)
+    acc->dacc[k] = 0.0;
+  acc->segments = 0;
+  acc->pending = 0;
+}
+
+
+long long pffft_psd_acc_segments(const PFFFT_PSD_Acc *acc)
+{
+  return acc->segments;
+}
+
+
+static void psd_fold(PFFFT_PSD_Acc *acc)
+{
+  const int nacc = acc->psd->nacc;
+  int k;
+  for (k = 0; k < nacc; ++k)
+    acc->dacc[k] += acc->facc[k];
+  memset(acc->facc, 0, (size_t)nacc * sizeof(float));
+  acc->pending = 0;
+}
+
+
+void pffft_psd_accumulate(PFFFT_PSD_Acc *acc, const float *input, int numSegments, int hop)
+{
+  const PFFFT_PSD *psd = acc->psd;
+  const int nf = psd->ns * psd->N;
+  const float *w = psd->window;
+  float *buf = acc->buf;
+  int m, k;
+
+  for (m = 0; m < numSegments; ++m) {
+    const float *x = input + (size_t)m * hop * psd->ns;
+    for (k = 0; k < nf; ++k)
+      buf[k] = w[k] * x[k];
+    pffft_transform(psd->fft, buf, buf, acc->work, PFFFT_FORWARD);
+    pffft_zpower_accumulate(psd->fft, buf, acc->facc, 1.0f);
+    ++acc->segments;
+    if (++acc->pending >= FOLD_SEGMENTS)
+      psd_fold(acc);
+  }
+}
+
+
+void pffft_psd_acc_merge(PFFFT_PSD_Acc *dst, const PFFFT_PSD_Acc *src)
+{
+  const int nacc = dst->psd->nacc;
+  int k;
+  for (k = 0; k < nacc; ++k)
+    dst->dacc[k] += (double)src->dacc[k] + src->facc[k];
+  dst->segments += src->segments;
+}
+
+
+void pffft_psd_read(PFFFT_PSD_Acc *acc, float *psd)
+{
+  const PFFFT_PSD *p = acc->psd;
+  const double scale = (acc->segments > 0 && p->wsum2 > 0.0) ? 1.0 / ((double)acc->segments * p->wsum2) : 0.0;
+  float *tmp = acc->buf;
+  int k;
+
+  for (k = 0; k < p->nacc; ++k)
+    tmp[k] = (float)((acc->dacc[k] + acc->facc[k]) * scale);
+  pffft_zpower_unpack(p->fft, tmp, psd);
+}
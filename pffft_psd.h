@@ -0,0 +1,98 @@
+/*
+   PFFFT_PSD : averaged power spectrum (Welch's method)
+
+   Segments of N samples are windowed, transformed and their powers
+   |X[k]|^2 are summed up - with pffft_zpower_accumulate(), in the
+   internal layout of the unordered spectrum. The bins are reordered only
+   once, when the result is read: per segment, there is the windowed
+   copy, the forward transform and one accumulating pass over the
+   spectrum - no pffft_zreorder() and no separate |X|^2 pass.
+
+   The configuration - transform setup and window - is read-only after
+   pffft_psd_new(): threads can share it, each accumulating into its own
+   PFFFT_PSD_Acc, which are merged at the end.
+
+   Restrictions:
+
+   - 32-bit single precision.
+
+   - N has to be supported by pffft_new_setup(), 1D transforms.
+*/
+
+#ifndef PFFFT_PSD_H
+#define PFFFT_PSD_H
+
+#include "pffft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /* opaque struct holding the setup of the transform and the window.
+     it can be shared by many threads.
+  */
+  typedef struct PFFFT_PSD PFFFT_PSD;
+
+  /* opaque struct holding the partial sums and the temporary data of one
+     thread. it can't be shared by many threads.
+  */
+  typedef struct PFFFT_PSD_Acc PFFFT_PSD_Acc;
+
+  /*
+    prepare the averaged power spectrum of segments of length N.
+    with PFFFT_REAL, the input are real samples and there are N/2+1 bins
+    0 .. N/2. with PFFFT_COMPLEX, the input are interleaved complex
+    samples and there are N bins 0 .. N-1.
+
+    'window' has N values and is copied. NULL selects the (periodic) Hann
+    window. returns NULL if N is not supported.
+  */
+  PFFFT_PSD *pffft_psd_new(int N, pffft_transform_t transform, const float *window);
+
+  /* destroy only, when all accumulators of the psd are destroyed */
+  void pffft_psd_destroy(PFFFT_PSD *psd);
+
+  /* number of bins: N/2+1 (real) or N (complex) */
+  int pffft_psd_bins(const PFFFT_PSD *psd);
+
+  /* a new accumulator, with zero segments */
+  PFFFT_PSD_Acc *pffft_psd_acc_new(PFFFT_PSD *psd);
+
+  void pffft_psd_acc_destroy(PFFFT_PSD_Acc *acc);
+
+  /* forget all accumulated segments */
+  void pffft_psd_acc_reset(PFFFT_PSD_Acc *acc);
+
+  /* number of accumulated segments */
+  long long pffft_psd_acc_segments(const PFFFT_PSD_Acc *acc);
+
+  /*
+    accumulate numSegments segments of N (real or complex) samples:
+    segment m starts at sample m * hop of input[] - hop < N gives the
+    overlapping segments of Welch's method, e.g. N/2 for the Hann window.
+    input doesn't need to be aligned.
+  */
+  void pffft_psd_accumulate(PFFFT_PSD_Acc *acc, const float *input, int numSegments, int hop);
+
+  /* add the segments of src - of the same psd - to dst, e.g. the partial
+     sums of several threads. src is unchanged. */
+  void pffft_psd_acc_merge(PFFFT_PSD_Acc *dst, const PFFFT_PSD_Acc *src);
+
+  /*
+    write the pffft_psd_bins() values
+
+      psd[k] = mean over the segments of |X[k]|^2 / sum_n w[n]^2
+
+    the two-sided power per bin: a white noise of variance s^2 gives s^2
+    in each bin. divide by the sample rate for the density per Hz - and
+    double the bins 1 .. N/2-1 of real transforms for the one-sided
+    spectrum. zeros without any segment. psd doesn't need to be aligned.
+    uses the temporary memory of acc - not the partial sums.
+  */
+  void pffft_psd_read(PFFFT_PSD_Acc *acc, float *psd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PFFFT_PSD_H */
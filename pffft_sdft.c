@@ -0,0 +1,337 @@
+/*
+   PFFFT_SDFT : sliding DFT of a few selected bins - see pffft_sdft.h
+
+   state: S[k] = sum_m hist[m] * exp(-2 pi i k m / N), the DFT of the
+   ring of the last N samples in slot order. feeding a sample into slot
+   m adds (x_new - x_old) * exp(-2 pi i k m / N); the differences of a
+   hop are collected in 'diff', in slot order, and summed up per frame
+   in sdft_accumulate(). the frame, starting at the oldest sample in
+   slot wr, is S[k] * exp(+2 pi i k wr / N).
+
+   sdft_accumulate() keeps one bin per SIMD lane and two vectors of bins
+   in flight. the phasor exp(-2 pi i k m / N) of each lane is advanced by
+   a complex multiplication per sample and reloaded from the cos/sin
+   table every SDFT_SEED samples, which bounds its rounding error.
+*/
+
+#include "pffft_sdft.h"
+
+#include "simd/pf_float.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* samples per phasor, before it is reloaded from the table */
+#define SDFT_SEED    32
+/* S is recomputed from the ring every SDFT_RESYNC * N samples */
+#define SDFT_RESYNC  8
+
+
+struct PFFFT_SDFT
+{
+  int N;
+  int hop;
+  int ns;               /* floats per sample: 1 (real) or 2 (complex) */
+  int nbins;            /* requested bins */
+  int nint;             /* internal bins: nbins or 3 * nbins with the Hann window */
+  int ngroups;          /* vectors of internal bins: even, padded with bin 0 */
+  int frame_size;
+  pffft_sdft_window_t window;
+  pffft_stft_output_t output;
+
+  int *bins;            /* ngroups * SIMD_SZ internal bins */
+  int *seed_step;       /* per internal bin: (k * SDFT_SEED) % N */
+  int *idx;             /* per internal bin: table index of the current phasor */
+  float *cos_tab;       /* cos(2 pi m / N), m = 0 .. N-1 */
+  float *sin_tab;       /* sin(2 pi m / N) */
+
+  v4sf *Sre;            /* aligned: ngroups vectors each */
+  v4sf *Sim;
+  v4sf *Tre;            /* per sample phasor step exp(-2 pi i k / N) */
+  v4sf *Tim;
+
+  float *hist;          /* ring of the last N samples */
+  float *diff;          /* x_new - x_old, at the slot of x_new */
+  int wr;               /* write position in hist: the oldest sample */
+  int todo;             /* number of samples until the next frame */
+  int slide;            /* 1: next frame is an update from 'diff'. 0: recompute S from hist */
+  long long since;      /* samples since S was recomputed */
+};
+
+
+PFFFT_SDFT *pffft_sdft_new(int N, int hop, pffft_transform_t transform,
+                           const int *bins, int numBins,
+                           pffft_sdft_window_t window, pffft_stft_output_t output)
+{
+  const int maxBin = (transform == PFFFT_COMPLEX) ? (N - 1) : (N / 2);
+  PFFFT_SDFT *s;
+  int ns, nlanes, k, r;
+
+  if (N < 2 || hop < 1 || !bins || numBins < 1)
+    return NULL;
+  for (r = 0; r < numBins; ++r) {
+    if (bins[r] < 0 || bins[r] > maxBin)
+      return NULL;
+  }
+  s = (PFFFT_SDFT*)calloc(1, sizeof(PFFFT_SDFT));
+  if (!s)
+    return NULL;
+  ns = (transform == PFFFT_COMPLEX) ? 2 : 1;
+  s->N = N;
+  s->hop = hop;
+  s->ns = ns;
+  s->nbins = numBins;
+  s->nint = (window == PFFFT_SDFT_HANN) ? 3 * numBins : numBins;
+  s->ngroups = (s->nint + SIMD_SZ - 1) / SIMD_SZ;
+  s->ngroups += (s->ngroups & 1);
+  s->frame_size = (output == PFFFT_STFT_SPECTRUM) ? 2 * numBins : numBins;
+  s->window = window;
+  s->output = output;
+  nlanes = s->ngroups * SIMD_SZ;
+
+  s->bins = (int*)calloc((size_t)nlanes, sizeof(int));
+  s->seed_step = (int*)malloc((size_t)nlanes * sizeof(int));
+  s->idx = (int*)malloc((size_t)nlanes * sizeof(int));
+  s->cos_tab = (float*)malloc((size_t)N * sizeof(float));
+  s->sin_tab = (float*)malloc((size_t)N * sizeof(float));
+  s->Sre = (v4sf*)pffft_aligned_malloc((size_t)s->ngroups * sizeof(v4sf));
+  s->Sim = (v4sf*)pffft_aligned_malloc((size_t)s->ngroups * sizeof(v4sf));
+  s->Tre = (v4sf*)pffft_aligned_malloc((size_t)s->ngroups * sizeof(v4sf));
+  s->Tim = (v4sf*)pffft_aligned_malloc((size_t)s->ngroups * sizeof(v4sf));
+  s->hist = (float*)malloc((size_t)ns * N * sizeof(float));
+  s->diff = (float*)malloc((size_t)ns * N * sizeof(float));
+  if (!s->bins || !s->seed_step || !s->idx || !s->cos_tab || !s->sin_tab
+      || !s->Sre || !s->Sim || !s->Tre || !s->Tim || !s->hist || !s->diff) {
+    pffft_sdft_destroy(s);
+    return NULL;
+  }
+
+  for (k = 0; k < N; ++k) {
+    s->cos_tab[k] = (float)cos(2.0 * M_PI * k / N);
+    s->sin_tab[k] = (float)sin(2.0 * M_PI * k / N);
+  }
+  for (r = 0; r < numBins; ++r) {
+    if (window == PFFFT_SDFT_HANN) {
+      s->bins[3*r] = (bins[r] == 0) ? (N - 1) : (bins[r] - 1);
+      s->bins[3*r + 1] = bins[r];
+      s->bins[3*r + 2] = (bins[r] == N - 1) ? 0 : (bins[r] + 1);
+    }
+    else
+      s->bins[r] = bins[r];
+  }
+  for (k = 0; k < nlanes; ++k) {
+    float *tr = (float*)s->Tre, *ti = (float*)s->Tim;
+    tr[k] = s->cos_tab[s->bins[k]];
+    ti[k] = -s->sin_tab[s->bins[k]];
+    s->seed_step[k] = (int)( ((long long)s->bins[k] * SDFT_SEED) % N );
+  }
+
+  pffft_sdft_reset(s);
+  return s;
+}
+
+
+void pffft_sdft_destroy(PFFFT_SDFT *s)
+{
+  if (!s)
+    return;
+  free(s->bins);
+  free(s->seed_step);
+  free(s->idx);
+  free(s->cos_tab);
+  free(s->sin_tab);
+  pffft_aligned_free(s->Sre);
+  pffft_aligned_free(s->Sim);
+  pffft_aligned_free(s->Tre);
+  pffft_aligned_free(s->Tim);
+  free(s->hist);
+  free(s->diff);
+  free(s);
+}
+
+
+void pffft_sdft_reset(PFFFT_SDFT *s)
+{
+  memset(s->hist, 0, (size_t)s->ns * s->N * sizeof(float));
+  s->wr = 0;
+  s->todo = s->N;
+  s->slide = 0;
+  s->since = 0;
+}
+
+
+int pffft_sdft_frame_size(const PFFFT_SDFT *s)
+{
+  return s->frame_size;
+}
+
+
+int pffft_sdft_max_frames(const PFFFT_SDFT *s, int inputLen)
+{
+  return (inputLen < s->todo) ? 0 : 1 + (inputLen - s->todo) / s->hop;
+}
+
+
+/* append n samples to the ring - and their differences to the overwritten samples */
+static void sdft_feed(PFFFT_SDFT *s, const float *input, int n)
+{
+  const int ns = s->ns;
+  float *h, *d;
+  int i;
+  if (!s->slide && n > s->N) {
+    /* skipped samples advance the slots as well: same rounding, however the input is chunked */
+    s->wr = (s->wr + (n - s->N) % s->N) % s->N;
+    input += ns * (n - s->N);
+    n = s->N;
+  }
+  for (i = 0; i < n; ++i, input += ns) {
+    h = s->hist + ns * s->wr;
+    if (s->slide) {
+      d = s->diff + ns * s->wr;
+      d[0] = input[0] - h[0];
+      if (ns == 2)
+        d[1] = input[1] - h[1];
+    }
+    h[0] = input[0];
+    if (ns == 2)
+      h[1] = input[1];
+    if (++s->wr == s->N)
+      s->wr = 0;
+  }
+}
+
+
+/* load the phasors exp(-2 pi i k m / N) of two vectors of bins, with the table indices in idx */
+#define SDFT_LOAD_PHASORS(pr0, pi0, pr1, pi1, idx) { \
+    v4sf_union ur0, ui0, ur1, ui1; int l_; \
+    for (l_ = 0; l_ < SIMD_SZ; ++l_) { \
+      ur0.f[l_] = s->cos_tab[idx[l_]];  ui0.f[l_] = -s->sin_tab[idx[l_]]; \
+      ur1.f[l_] = s->cos_tab[idx[SIMD_SZ + l_]];  ui1.f[l_] = -s->sin_tab[idx[SIMD_SZ + l_]]; \
+    } \
+    pr0 = ur0.v; pi0 = ui0.v; pr1 = ur1.v; pi1 = ui1.v; }
+
+
+/* S[k] += sum_{m = m0}^{m0+n-1} x[m] * exp(-2 pi i k m / N), for all bins k */
+static void sdft_accumulate(PFFFT_SDFT *s, const float *x, int m0, int n)
+{
+  const int N = s->N;
+  int g, j, i, l;
+
+  assert(m0 >= 0 && m0 + n <= N);
+  x += s->ns * m0;
+  for (l = 0; l < s->ngroups * SIMD_SZ; ++l)
+    s->idx[l] = (int)( ((long long)s->bins[l] * m0) % N );
+
+  for (g = 0; g < s->ngroups; g += 2) {
+    int *idx = s->idx + g * SIMD_SZ;
+    const int *step = s->seed_step + g * SIMD_SZ;
+    const v4sf tr0 = s->Tre[g], ti0 = s->Tim[g];
+    const v4sf tr1 = s->Tre[g+1], ti1 = s->Tim[g+1];
+    v4sf ar0 = s->Sre[g], ai0 = s->Sim[g];
+    v4sf ar1 = s->Sre[g+1], ai1 = s->Sim[g+1];
+    v4sf pr0, pi0, pr1, pi1;
+
+    for (j = 0; j < n; j += SDFT_SEED) {
+      const int m = (n - j < SDFT_SEED) ? (n - j) : SDFT_SEED;
+      const float *xj = x + s->ns * j;
+      SDFT_LOAD_PHASORS(pr0, pi0, pr1, pi1, idx);
+      for (l = 0; l < 2 * SIMD_SZ; ++l) {
+        idx[l] += step[l];
+        if (idx[l] >= N)
+          idx[l] -= N;
+      }
+      if (s->ns == 1) {
+        for (i = 0; i < m; ++i) {
+          const v4sf xv = LD_PS1(xj[i]);
+          ar0 = VMADD(xv, pr0, ar0);  ai0 = VMADD(xv, pi0, ai0);
+          ar1 = VMADD(xv, pr1, ar1);  ai1 = VMADD(xv, pi1, ai1);
+          VCPLXMUL(pr0, pi0, tr0, ti0);
+          VCPLXMUL(pr1, pi1, tr1, ti1);
+        }
+      } else {
+        for (i = 0; i < m; ++i) {
+          const v4sf xr = LD_PS1(xj[2*i]), xi = LD_PS1(xj[2*i+1]);
+          ar0 = VADD(ar0, VSUB(VMUL(xr, pr0), VMUL(xi, pi0)));
+          ai0 = VADD(ai0, VADD(VMUL(xr, pi0), VMUL(xi, pr0)));
+          ar1 = VADD(ar1, VSUB(VMUL(xr, pr1), VMUL(xi, pi1)));
+          ai1 = VADD(ai1, VADD(VMUL(xr, pi1), VMUL(xi, pr1)));
+          VCPLXMUL(pr0, pi0, tr0, ti0);
+          VCPLXMUL(pr1, pi1, tr1, ti1);
+        }
+      }
+    }
+    s->Sre[g] = ar0;  s->Sim[g] = ai0;
+    s->Sre[g+1] = ar1;  s->Sim[g+1] = ai1;
+  }
+}
+
+
+/* update S with the last hop of samples - or recompute it - and write the frame to 'out' */
+static void sdft_frame(PFFFT_SDFT *s, float *out)
+{
+  const int N = s->N;
+  const float *Sr = (const float*)s->Sre, *Si = (const float*)s->Sim;
+  int r, i;
+
+  if (s->slide) {
+    const int first = (s->wr >= s->hop) ? (s->wr - s->hop) : (s->wr - s->hop + N);
+    const int n1 = (s->hop < N - first) ? s->hop : (N - first);
+    sdft_accumulate(s, s->diff, first, n1);
+    if (n1 < s->hop)
+      sdft_accumulate(s, s->diff, 0, s->hop - n1);
+  } else {
+    for (i = 0; i < s->ngroups; ++i) {
+      s->Sre[i] = VZERO();
+      s->Sim[i] = VZERO();
+    }
+    sdft_accumulate(s, s->hist, 0, N);
+    s->since = 0;
+  }
+  s->since += s->hop;
+  s->slide = (s->hop < N && s->since + s->hop <= (long long)SDFT_RESYNC * N);
+
+  for (r = 0; r < s->nbins; ++r) {
+    float re = 0.0f, im = 0.0f;
+    const int i0 = (s->window == PFFFT_SDFT_HANN) ? 3 * r : r;
+    const int i1 = (s->window == PFFFT_SDFT_HANN) ? 3 * r + 3 : r + 1;
+    for (i = i0; i < i1; ++i) {
+      /* rotate to the frame start: times exp(+2 pi i k wr / N) */
+      const int t = (int)( ((long long)s->bins[i] * s->wr) % N );
+      const float w = (i1 - i0 == 1) ? 1.0f : ((i == i0 + 1) ? 0.5f : -0.25f);
+      re += w * (Sr[i] * s->cos_tab[t] - Si[i] * s->sin_tab[t]);
+      im += w * (Sr[i] * s->sin_tab[t] + Si[i] * s->cos_tab[t]);
+    }
+    if (s->output == PFFFT_STFT_SPECTRUM) {
+      out[2*r] = re;
+      out[2*r + 1] = im;
+    }
+    else if (s->output == PFFFT_STFT_MAGNITUDE)
+      out[r] = sqrtf(re * re + im * im);
+    else
+      out[r] = re * re + im * im;
+  }
+}
+
+
+int pffft_sdft_process(PFFFT_SDFT *s, const float *input, int inputLen, float *frames)
+{
+  int i = 0, frames_out = 0;
+  while (i < inputLen) {
+    const int n = (inputLen - i < s->todo) ? (inputLen - i) : s->todo;
+    sdft_feed(s, input + s->ns * i, n);
+    i += n;
+    s->todo -= n;
+    if (s->todo == 0) {
+      sdft_frame(s, frames + (size_t)frames_out * s->frame_size);
+      s->todo = s->hop;
+      ++frames_out;
+    }
+  }
+  return frames_out;
+}
@@ -0,0 +1,95 @@
+/*
+   PFFFT_SDFT : sliding DFT of a few selected bins (pruned spectrogram)
+
+   Same frames as PFFFT_STFT - DFT of length N of the last N samples,
+   one frame every 'hop' samples - but only for a short list of bins,
+   e.g. for monitoring a few tones or carriers. Instead of a full
+   transform per frame, the bins are updated incrementally with the
+   samples of each hop:
+
+     S[k] += (x_new - x_old) * exp(-2 pi i k m / N)
+
+   where m is the slot of the sample in the ring of the last N samples.
+   S[k] is the DFT of the ring in its slot order; the frame, starting at
+   the oldest sample, is one rotation away. The update costs hop samples
+   per bin - instead of a O(N log N) transform per frame. The bins are
+   processed in parallel, one bin per SIMD lane, with the simd/pf_float.h
+   macros. The rounding errors of the update don't compound, as there is
+   no recursive rotation of S; nevertheless, every 8*N samples, S is
+   recomputed from the ring.
+
+   Restrictions:
+
+   - 32-bit single precision, forward transforms only, not scaled - as
+   PFFFT_STFT.
+
+   - rectangular or (periodic) Hann window. The Hann window is applied in
+   the frequency domain, from the bins k-1, k and k+1.
+
+   - the effort per input sample is proportional to the number of bins
+   (three times with the Hann window), while that of PFFFT_STFT is
+   proportional to log2(N) * N / hop: the sliding DFT pays off for few
+   bins and small hops, e.g. 8 bins of N = 4096 with a hop of 64 are
+   about 5x faster. with hop >= N/4, PFFFT_STFT is usually faster.
+*/
+
+#ifndef PFFFT_SDFT_H
+#define PFFFT_SDFT_H
+
+#include "pffft_stft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /* opaque struct holding the bins, the sliding state and the input history.
+     this struct can't be shared by many threads.
+  */
+  typedef struct PFFFT_SDFT PFFFT_SDFT;
+
+  typedef enum {
+    PFFFT_SDFT_RECT,   /* rectangular window */
+    PFFFT_SDFT_HANN    /* periodic Hann window: same as NULL for pffft_stft_new() */
+  } pffft_sdft_window_t;
+
+  /*
+    prepare a sliding DFT of length N (N >= 2) with a hop of 'hop' samples
+    (hop >= 1), computing only the numBins bins listed in 'bins' - in
+    this order, duplicates allowed. 'bins' is copied.
+
+    with PFFFT_REAL, the input are real samples and the bins have to be
+    in 0 .. N/2; with PFFFT_COMPLEX, the input are interleaved complex
+    samples and the bins have to be in 0 .. N-1.
+
+    a frame has numBins values: complex (re, im) pairs for
+    PFFFT_STFT_SPECTRUM, magnitudes or powers otherwise. frame m is
+    equal - up to rounding - to the listed bins of frame m of PFFFT_STFT.
+    returns NULL if a parameter is not supported.
+  */
+  PFFFT_SDFT *pffft_sdft_new(int N, int hop, pffft_transform_t transform,
+                             const int *bins, int numBins,
+                             pffft_sdft_window_t window, pffft_stft_output_t output);
+
+  void pffft_sdft_destroy(PFFFT_SDFT *sdft);
+
+  /* forget the input history: the next frame needs N new samples again */
+  void pffft_sdft_reset(PFFFT_SDFT *sdft);
+
+  /* number of floats per output frame */
+  int pffft_sdft_frame_size(const PFFFT_SDFT *sdft);
+
+  /* maximum number of frames, which a call with inputLen samples can produce */
+  int pffft_sdft_max_frames(const PFFFT_SDFT *sdft, int inputLen);
+
+  /*
+    process inputLen (real or complex) samples - of any length per call.
+    frame m is written to frames + m * pffft_sdft_frame_size().
+    returns the number of frames. input and frames don't need to be aligned.
+  */
+  int pffft_sdft_process(PFFFT_SDFT *sdft, const float *input, int inputLen, float *frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PFFFT_SDFT_H */
@@ -0,0 +1,210 @@
+/*
+   PFFFT_STFT : streaming short-time Fourier transform - see pffft_stft.h
+
+   per frame, there are three passes over N samples:
+   - the windowed copy out of the input ring (two contiguous segments)
+   - the unordered forward transform: pffft_transform()
+   - power and magnitude frames: pffft_zpower() sums the squares in the
+     SIMD layout of the unordered spectrum and writes the bins in natural
+     order, without pffft_zreorder(). complex frames are reordered into
+     the work memory and unpacked while copying to the output.
+*/
+
+#include "pffft_stft.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+struct PFFFT_STFT
+{
+  int N;
+  int hop;
+  int ns;               /* floats per sample: 1 (real) or 2 (complex) */
+  int nbins;            /* N/2+1 (real) or N (complex) */
+  int frame_size;
+  pffft_stft_output_t output;
+  PFFFT_Setup *setup;
+
+  float *window;        /* N * ns floats: duplicated for (re, im) */
+  float *hist;          /* ring of the last N samples */
+  int wr;               /* write position in hist: the oldest sample */
+  int todo;             /* number of samples until the next frame */
+
+  float *buf;           /* aligned: windowed frame, transformed in-place to the unordered spectrum */
+  float *work;          /* aligned: work of pffft_transform() and the ordered spectrum */
+};
+
+
+PFFFT_STFT *pffft_stft_new(int N, int hop, pffft_transform_t transform,
+                           const float *window, pffft_stft_output_t output)
+{
+  PFFFT_STFT *s;
+  int ns, nf, nw, k;
+
+  if (N <= 0 || hop < 1)
+    return NULL;
+  s = (PFFFT_STFT*)calloc(1, sizeof(PFFFT_STFT));
+  if (!s)
+    return NULL;
+  s->setup = pffft_new_setup(N, transform);
+  if (!s->setup) {
+    free(s);
+    return NULL;
+  }
+  ns = (transform == PFFFT_COMPLEX) ? 2 : 1;
+  nf = ns * N;
+  nw = pffft_work_size(s->setup);
+  s->N = N;
+  s->hop = hop;
+  s->ns = ns;
+  s->nbins = (transform == PFFFT_COMPLEX) ? N : (N/2 + 1);
+  s->frame_size = (output == PFFFT_STFT_SPECTRUM) ? 2 * s->nbins : s->nbins;
+  s->output = output;
+  s->window = (float*)malloc((size_t)nf * sizeof(float));
+  s->hist = (float*)malloc((size_t)nf * sizeof(float));
+  s->buf = (float*)pffft_aligned_malloc((size_t)nf * sizeof(float));
+  /* Bluestein's sizes need more work than the ordered spectrum */
+  s->work = (float*)pffft_aligned_malloc((size_t)(nf > nw ? nf : nw) * sizeof(float));
+  if (!s->window || !s->hist || !s->buf || !s->work) {
+    pffft_stft_destroy(s);
+    return NULL;
+  }
+
+  for (k = 0; k < N; ++k) {
+    const float w = window ? window[k] : (float)( 0.5 - 0.5 * cos(2.0 * M_PI * k / N) );
+    s->window[ns*k] = w;
+    if (ns == 2)
+      s->window[ns*k + 1] = w;
+  }
+
+  pffft_stft_reset(s);
+  return s;
+}
+
+
+void pffft_stft_destroy(PFFFT_STFT *s)
+{
+  if (!s)
+    return;
+  if (s->setup)
+    pffft_destroy_setup(s->setup);
+  free(s->window);
+  free(s->hist);
+  pffft_aligned_free(s->buf);
+  pffft_aligned_free(s->work);
+  free(s);
+}
+
+
+void pffft_stft_reset(PFFFT_STFT *s)
+{
+  memset(s->hist, 0, (size_t)s->ns * s->N * sizeof(float));
+  s->wr = 0;
+  s->todo = s->N;
+}
+
+
+int pffft_stft_frame_size(const PFFFT_STFT *s)
+{
+  return s->frame_size;
+}
+
+
+int pffft_stft_max_frames(const PFFFT_STFT *s, int inputLen)
+{
+  return (inputLen < s->todo) ? 0 : 1 + (inputLen - s->todo) / s->hop;
+}
+
+
+/* append n samples to the ring of the last N samples */
+static void stft_feed(PFFFT_STFT *s, const float *input, int n)
+{
+  const int ns = s->ns;
+  int first;
+  if (n > s->N) {
+    input += ns * (n - s->N);
+    n = s->N;
+  }
+  first = (n < s->N - s->wr) ? n : (s->N - s->wr);
+  memcpy(s->hist + ns * s->wr, input, (size_t)ns * first * sizeof(float));
+  memcpy(s->hist, input + ns * first, (size_t)ns * (n - first) * sizeof(float));
+  s->wr += n;
+  if (s->wr >= s->N)
+    s->wr -= s->N;
+}
+
+
+/* transform the last N samples into the frame 'out' */
+static void stft_frame(PFFFT_STFT *s, float *out)
+{
+  const float *w = s->window;
+  const float *h = s->hist;
+  const int na = s->ns * (s->N - s->wr);  /* floats from the oldest sample to the end of the ring */
+  const int nb = s->ns * s->wr;
+  float *buf = s->buf;
+  int k;
+
+  for (k = 0; k < na; ++k)
+    buf[k] = w[k] * h[nb + k];
+  for (k = 0; k < nb; ++k)
+    buf[na + k] = w[na + k] * h[k];
+
+  pffft_transform(s->setup, buf, buf, s->work, PFFFT_FORWARD);
+
+  if (s->output == PFFFT_STFT_SPECTRUM) {
+    const float *X = s->work;
+    pffft_zreorder(s->setup, buf, s->work, PFFFT_FORWARD);
+    if (s->ns == 2)
+      memcpy(out, X, 2 * (size_t)s->N * sizeof(float));
+    else {
+      /* unpack X[N/2] */
+      out[0] = X[0];
+      out[1] = 0.0f;
+      memcpy(out + 2, X + 2, ((size_t)s->N - 2) * sizeof(float));
+      out[s->N] = X[1];
+      out[s->N + 1] = 0.0f;
+    }
+  } else {
+    pffft_zpower(s->setup, buf, out);
+    if (s->output == PFFFT_STFT_MAGNITUDE) {
+      for (k = 0; k < s->nbins; ++k)
+        out[k] = sqrtf(out[k]);
+    }
+  }
+}
+
+
+int pffft_stft_process_ring(PFFFT_STFT *s, const float *input, int inputLen,
+                            float *ring, int ringFrames, int *ringPos)
+{
+  int i = 0, frames = 0;
+  assert(ringFrames > 0 && *ringPos >= 0 && *ringPos < ringFrames);
+  while (i < inputLen) {
+    const int n = (inputLen - i < s->todo) ? (inputLen - i) : s->todo;
+    stft_feed(s, input + s->ns * i, n);
+    i += n;
+    s->todo -= n;
+    if (s->todo == 0) {
+      stft_frame(s, ring + (size_t)(*ringPos) * s->frame_size);
+      if (++*ringPos >= ringFrames)
+        *ringPos = 0;
+      s->todo = s->hop;
+      ++frames;
+    }
+  }
+  return frames;
+}
+
+
+int pffft_stft_process(PFFFT_STFT *s, const float *input, int inputLen, float *frames)
+{
+  int pos = 0;
+  return pffft_stft_process_ring(s, input, inputLen, frames, pffft_stft_max_frames(s, inputLen) + 1, &pos);
+}
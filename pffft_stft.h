@@ -0,0 +1,95 @@
+/*
+   PFFFT_STFT : streaming short-time Fourier transform (spectrogram)
+
+   Window, hop size and transform length N are configured once; the
+   input is streamed in chunks of any length and each hop of samples
+   emits one frame: the complex spectrum, its magnitude or its power
+   |X|^2 of the windowed last N samples.
+
+   The input is kept in a ring of the last N samples. The window is
+   applied while copying a frame out of this ring into the (aligned)
+   input of pffft_transform(). Power and magnitude frames are computed
+   with pffft_zpower() straight from the unordered spectrum: there is no
+   separate windowing, pffft_zreorder() or |X|^2 pass.
+
+   Frames are written one after the other, or into a caller provided
+   ring of frames, see pffft_stft_process_ring().
+
+   Restrictions:
+
+   - 32-bit single precision, forward transforms only. The frames are
+   not scaled: a full scale sinusoid in a rectangular window delivers
+   N/2 at its frequency bin.
+
+   - N has to be supported by pffft_new_setup().
+*/
+
+#ifndef PFFFT_STFT_H
+#define PFFFT_STFT_H
+
+#include "pffft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /* opaque struct holding the setup of the transform, the window,
+     the input history and temporary data.
+     this struct can't be shared by many threads.
+  */
+  typedef struct PFFFT_STFT PFFFT_STFT;
+
+  typedef enum {
+    PFFFT_STFT_SPECTRUM,   /* complex values: interleaved (re, im) */
+    PFFFT_STFT_MAGNITUDE,  /* |X| */
+    PFFFT_STFT_POWER       /* |X|^2 */
+  } pffft_stft_output_t;
+
+  /*
+    prepare a STFT of length N with a hop of 'hop' samples (hop >= 1,
+    hop > N skips samples between the frames).
+
+    with PFFFT_REAL, the input are real samples and a frame has the N/2+1
+    bins 0 .. N/2 - as complex values, these are N+2 floats, with zero
+    imaginary part at 0 and N/2. with PFFFT_COMPLEX, the input are
+    interleaved complex samples and a frame has the N bins 0 .. N-1.
+
+    'window' has N values and is copied. NULL selects the (periodic) Hann
+    window. returns NULL if N or hop are not supported.
+  */
+  PFFFT_STFT *pffft_stft_new(int N, int hop, pffft_transform_t transform,
+                             const float *window, pffft_stft_output_t output);
+
+  void pffft_stft_destroy(PFFFT_STFT *stft);
+
+  /* forget the input history: the next frame needs N new samples again */
+  void pffft_stft_reset(PFFFT_STFT *stft);
+
+  /* number of floats per output frame */
+  int pffft_stft_frame_size(const PFFFT_STFT *stft);
+
+  /* maximum number of frames, which a call with inputLen samples can produce */
+  int pffft_stft_max_frames(const PFFFT_STFT *stft, int inputLen);
+
+  /*
+    process inputLen (real or complex) samples - of any length per call.
+    frame m is written to frames + m * pffft_stft_frame_size().
+    returns the number of frames. input and frames don't need to be aligned.
+  */
+  int pffft_stft_process(PFFFT_STFT *stft, const float *input, int inputLen, float *frames);
+
+  /*
+    same as pffft_stft_process(), but writes into a ring of ringFrames
+    frames: each frame goes to ring + *ringPos * frame_size, then *ringPos
+    advances - modulo ringFrames. the oldest frames are overwritten, when
+    there are more frames than fit into the ring.
+    returns the number of frames.
+  */
+  int pffft_stft_process_ring(PFFFT_STFT *stft, const float *input, int inputLen,
+                              float *ring, int ringFrames, int *ringPos);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PFFFT_STFT_H */
@@ -0,0 +1,137 @@
+/* Copyright (c) 2013  Julien Pommier ( pommier@modartt.com )
+
+   Redistribution and use of the Software in source and binary forms,
+   with or without modification, is permitted provided that the
+   following conditions are met:
+
+   - Neither the names of NCAR's Computational and Information Systems
+   Laboratory, the University Corporation for Atmospheric Research,
+   nor the names of its sponsors or contributors may be used to
+   endorse or promote products derived from this Software without
+   specific prior written permission.
+
+   - Redistributions of source code must retain the above copyright
+   notices, this list of conditions, and the disclaimer below.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions, and the disclaimer below in the
+   documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+   SOFTWARE.
+*/
+
+#ifndef PF_AVX512_DBL_H
+#define PF_AVX512_DBL_H
+
+/*
+   vector support macros: the rest of the code is independant of
+   AVX-512 -- adding support for other platforms with 8-element
+   vectors should be limited to these macros
+*/
+
+
+/*
+  AVX-512 support macros
+
+  8 lanes raise the minimum transform sizes to 128 (real) and 64 (complex),
+  that's why these are used only when PFFFT_ENABLE_AVX512 is defined
+*/
+#if !defined(SIMD_SZ) && !defined(PFFFT_SIMD_DISABLE) && defined(PFFFT_ENABLE_AVX512) && defined(__AVX512F__)
+#pragma message( __FILE__ ": AVX-512 double macros are defined" )
+
+#include <immintrin.h>
+typedef __m512d v4sf;
+
+/* 8 doubles by simd vector */
+#  define SIMD_SZ 8
+
+typedef union v4sf_union {
+  v4sf  v;
+  double f[SIMD_SZ];
+} v4sf_union;
+
+#  define VARCH "AVX512"
+#  define VREQUIRES_ALIGN 1
+#  define VZERO() _mm512_setzero_pd()
+#  define VMUL(a,b) _mm512_mul_pd(a,b)
+#  define VADD(a,b) _mm512_add_pd(a,b)
+#  define VMADD(a,b,c) _mm512_fmadd_pd(a,b,c)
+#  define VSUB(a,b) _mm512_sub_pd(a,b)
+#  define LD_PS1(p) _mm512_set1_pd(p)
+#  define VLOAD_UNALIGNED(ptr)  _mm512_loadu_pd(ptr)
+#  define VLOAD_ALIGNED(ptr)    _mm512_load_pd(ptr)
+
+/* INTERLEAVE2 (in1, in2, out1, out2) pseudo code:
+out1 = [ in1[0], in2[0], in1[1], in2[1], in1[2], in2[2], in1[3], in2[3] ]
+out2 = [ in1[4], in2[4], in1[5], in2[5], in1[6], in2[6], in1[7], in2[7] ]
+*/
+#  define INTERLEAVE2(in1, in2, out1, out2) {                                           \
+    __m512d tmp__ = _mm512_permutex2var_pd(in1, _mm512_setr_epi64(0, 8, 1, 9, 2, 10, 3, 11), in2);  \
+    out2 = _mm512_permutex2var_pd(in1, _mm512_setr_epi64(4, 12, 5, 13, 6, 14, 7, 15), in2);         \
+    out1 = tmp__;                                                                       \
+}
+
+/* UNINTERLEAVE2(in1, in2, out1, out2) pseudo code:
+out1 = [ in1[0], in1[2], in1[4], in1[6], in2[0], in2[2], in2[4], in2[6] ]
+out2 = [ in1[1], in1[3], in1[5], in1[7], in2[1], in2[3], in2[5], in2[7] ]
+*/
+#  define UNINTERLEAVE2(in1, in2, out1, out2) {                                         \
+    __m512d tmp__ = _mm512_permutex2var_pd(in1, _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14), in2);  \
+    out2 = _mm512_permutex2var_pd(in1, _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15), in2);          \
+    out1 = tmp__;                                                                       \
+}
+
+#  define VTRANSPOSE8(row0, row1, row2, row3, row4, row5, row6, row7) {   \
+    __m512d t0__, t1__, t2__, t3__, t4__, t5__, t6__, t7__;               \
+    __m512d a0__, a1__, b0__, b1__;                                       \
+    t0__ = _mm512_unpacklo_pd(row0, row1);                                \
+    t1__ = _mm512_unpackhi_pd(row0, row1);                                \
+    t2__ = _mm512_unpacklo_pd(row2, row3);                                \
+    t3__ = _mm512_unpackhi_pd(row2, row3);                                \
+    t4__ = _mm512_unpacklo_pd(row4, row5);                                \
+    t5__ = _mm512_unpackhi_pd(row4, row5);                                \
+    t6__ = _mm512_unpacklo_pd(row6, row7);                                \
+    t7__ = _mm512_unpackhi_pd(row6, row7);                                \
+    a0__ = _mm512_shuffle_f64x2(t0__, t2__, 0x44);                        \
+    a1__ = _mm512_shuffle_f64x2(t0__, t2__, 0xEE);                        \
+    b0__ = _mm512_shuffle_f64x2(t4__, t6__, 0x44);                        \
+    b1__ = _mm512_shuffle_f64x2(t4__, t6__, 0xEE);                        \
+    (row0) = _mm512_shuffle_f64x2(a0__, b0__, _MM_SHUFFLE(2,0,2,0));      \
+    (row2) = _mm512_shuffle_f64x2(a0__, b0__, _MM_SHUFFLE(3,1,3,1));      \
+    (row4) = _mm512_shuffle_f64x2(a1__, b1__, _MM_SHUFFLE(2,0,2,0));      \
+    (row6) = _mm512_shuffle_f64x2(a1__, b1__, _MM_SHUFFLE(3,1,3,1));      \
+    a0__ = _mm512_shuffle_f64x2(t1__, t3__, 0x44);                        \
+    a1__ = _mm512_shuffle_f64x2(t1__, t3__, 0xEE);                        \
+    b0__ = _mm512_shuffle_f64x2(t5__, t7__, 0x44);                        \
+    b1__ = _mm512_shuffle_f64x2(t5__, t7__, 0xEE);                        \
+    (row1) = _mm512_shuffle_f64x2(a0__, b0__, _MM_SHUFFLE(2,0,2,0));      \
+    (row3) = _mm512_shuffle_f64x2(a0__, b0__, _MM_SHUFFLE(3,1,3,1));      \
+    (row5) = _mm512_shuffle_f64x2(a1__, b1__, _MM_SHUFFLE(2,0,2,0));      \
+    (row7) = _mm512_shuffle_f64x2(a1__, b1__, _MM_SHUFFLE(3,1,3,1));      \
+}
+
+/* VSWAPHL(a, b) pseudo code:
+return [ b[0], b[1], b[2], b[3], a[4], a[5], a[6], a[7] ]
+*/
+#  define VSWAPHL(a,b)  _mm512_mask_blend_pd(0x0F, a, b)
+
+/* reverse/flip all doubles */
+#  define VREV_S(a)    _mm512_permutexvar_pd(_mm512_setr_epi64(7, 6, 5, 4, 3, 2, 1, 0), a)
+
+/* reverse/flip complex doubles */
+#  define VREV_C(a)    _mm512_permutexvar_pd(_mm512_setr_epi64(6, 7, 4, 5, 2, 3, 0, 1), a)
+
+#  define VALIGNED(ptr) ((((uintptr_t)(ptr)) & 0x3F) == 0)
+
+#endif
+
+#endif /* PF_AVX512_DBL_H */
@@ -0,0 +1,138 @@
+/* Copyright (c) 2013  Julien Pommier ( pommier@modartt.com )
+
+   Redistribution and use of the Software in source and binary forms,
+   with or without modification, is permitted provided that the
+   following conditions are met:
+
+   - Neither the names of NCAR's Computational and Information Systems
+   Laboratory, the University Corporation for Atmospheric Research,
+   nor the names of its sponsors or contributors may be used to
+   endorse or promote products derived from this Software without
+   specific prior written permission.
+
+   - Redistributions of source code must retain the above copyright
+   notices, this list of conditions, and the disclaimer below.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions, and the disclaimer below in the
+   documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+   SOFTWARE.
+*/
+
+#ifndef PF_AVX512_FLT_H
+#define PF_AVX512_FLT_H
+
+/*
+   vector support macros: the rest of the code is independant of
+   AVX-512 -- adding support for other platforms with 16-element
+   vectors should be limited to these macros
+*/
+
+
+/*
+  AVX-512 support macros
+
+  16 lanes raise the minimum transform sizes to 512 (real) and 256 (complex),
+  that's why these are used only when PFFFT_ENABLE_AVX512 is defined
+*/
+#if !defined(SIMD_SZ) && !defined(PFFFT_SIMD_DISABLE) && defined(PFFFT_ENABLE_AVX512) && defined(__AVX512F__)
+#pragma message( __FILE__ ": AVX-512 float macros are defined" )
+
+#include <immintrin.h>
+typedef __m512 v4sf;
+
+/* 16 floats by simd vector */
+#  define SIMD_SZ 16
+
+typedef union v4sf_union {
+  v4sf  v;
+  float f[SIMD_SZ];
+} v4sf_union;
+
+#  define VARCH "AVX512"
+#  define VREQUIRES_ALIGN 1
+#  define VZERO() _mm512_setzero_ps()
+#  define VMUL(a,b) _mm512_mul_ps(a,b)
+#  define VADD(a,b) _mm512_add_ps(a,b)
+#  define VMADD(a,b,c) _mm512_fmadd_ps(a,b,c)
+#  define VSUB(a,b) _mm512_sub_ps(a,b)
+#  define LD_PS1(p) _mm512_set1_ps(p)
+#  define VLOAD_UNALIGNED(ptr)  _mm512_loadu_ps(ptr)
+#  define VLOAD_ALIGNED(ptr)    _mm512_load_ps(ptr)
+
+/* INTERLEAVE2 (in1, in2, out1, out2) pseudo code:
+out1 = [ in1[0], in2[0], in1[1], in2[1], .. in1[7], in2[7] ]
+out2 = [ in1[8], in2[8], in1[9], in2[9], .. in1[15], in2[15] ]
+*/
+#  define INTERLEAVE2(in1, in2, out1, out2) {                                                 \
+    __m512 tmp__ = _mm512_permutex2var_ps(in1,                                                \
+        _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23), in2);      \
+    out2 = _mm512_permutex2var_ps(in1,                                                        \
+        _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31), in2);\
+    out1 = tmp__;                                                                             \
+}
+
+/* UNINTERLEAVE2(in1, in2, out1, out2) pseudo code:
+out1 = [ in1[0], in1[2], .. in1[14], in2[0], in2[2], .. in2[14] ]
+out2 = [ in1[1], in1[3], .. in1[15], in2[1], in2[3], .. in2[15] ]
+*/
+#  define UNINTERLEAVE2(in1, in2, out1, out2) {                                               \
+    __m512 tmp__ = _mm512_permutex2var_ps(in1,                                                \
+        _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30), in2);   \
+    out2 = _mm512_permutex2var_ps(in1,                                                        \
+        _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31), in2);   \
+    out1 = tmp__;                                                                             \
+}
+
+/* transposes the 16x16 matrix in the array of vectors row[0] .. row[15] */
+#  define VTRANSPOSE16(row) {                                                     \
+    __m512 t__[16], u__[16];                                                      \
+    int k__;                                                                      \
+    for (k__ = 0; k__ < 8; ++k__) {                                               \
+      t__[2*k__]   = _mm512_unpacklo_ps(row[2*k__], row[2*k__+1]);                \
+      t__[2*k__+1] = _mm512_unpackhi_ps(row[2*k__], row[2*k__+1]);                \
+    }                                                                             \
+    for (k__ = 0; k__ < 16; k__ += 4) {                                           \
+      u__[k__+0] = _mm512_shuffle_ps(t__[k__+0], t__[k__+2], 0x44);               \
+      u__[k__+1] = _mm512_shuffle_ps(t__[k__+0], t__[k__+2], 0xEE);               \
+      u__[k__+2] = _mm512_shuffle_ps(t__[k__+1], t__[k__+3], 0x44);               \
+      u__[k__+3] = _mm512_shuffle_ps(t__[k__+1], t__[k__+3], 0xEE);               \
+    }                                                                             \
+    for (k__ = 0; k__ < 4; ++k__) {                                               \
+      __m512 a0__ = _mm512_shuffle_f32x4(u__[k__],   u__[k__+4],  0x44);          \
+      __m512 a1__ = _mm512_shuffle_f32x4(u__[k__],   u__[k__+4],  0xEE);          \
+      __m512 b0__ = _mm512_shuffle_f32x4(u__[k__+8], u__[k__+12], 0x44);          \
+      __m512 b1__ = _mm512_shuffle_f32x4(u__[k__+8], u__[k__+12], 0xEE);          \
+      row[k__+0]  = _mm512_shuffle_f32x4(a0__, b0__, _MM_SHUFFLE(2,0,2,0));       \
+      row[k__+4]  = _mm512_shuffle_f32x4(a0__, b0__, _MM_SHUFFLE(3,1,3,1));       \
+      row[k__+8]  = _mm512_shuffle_f32x4(a1__, b1__, _MM_SHUFFLE(2,0,2,0));       \
+      row[k__+12] = _mm512_shuffle_f32x4(a1__, b1__, _MM_SHUFFLE(3,1,3,1));       \
+    }                                                                             \
+}
+
+/* VSWAPHL(a, b) pseudo code:
+return [ b[0], .. b[7], a[8], .. a[15] ]
+*/
+#  define VSWAPHL(a,b)  _mm512_mask_blend_ps(0x00FF, a, b)
+
+/* reverse/flip all floats */
+#  define VREV_S(a)    _mm512_permutexvar_ps(_mm512_setr_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0), a)
+
+/* reverse/flip complex floats */
+#  define VREV_C(a)    _mm512_permutexvar_ps(_mm512_setr_epi32(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1), a)
+
+#  define VALIGNED(ptr) ((((uintptr_t)(ptr)) & 0x3F) == 0)
+
+#endif
+
+#endif /* PF_AVX512_FLT_H */
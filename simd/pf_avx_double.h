@@ -60,12 +60,17 @@ typedef union v4sf_union {
   double f[SIMD_SZ];
 } v4sf_union;
 
+#if defined(__FMA__)
+#  define VARCH "AVX+FMA"
+#  define VMADD(a,b,c) _mm256_fmadd_pd(a,b,c)
+#else
 #  define VARCH "AVX"
+#  define VMADD(a,b,c) _mm256_add_pd(_mm256_mul_pd(a,b), c)
+#endif
 #  define VREQUIRES_ALIGN 1
 #  define VZERO() _mm256_setzero_pd()
 #  define VMUL(a,b) _mm256_mul_pd(a,b)
 #  define VADD(a,b) _mm256_add_pd(a,b)
-#  define VMADD(a,b,c) _mm256_add_pd(_mm256_mul_pd(a,b), c)
 #  define VSUB(a,b) _mm256_sub_pd(a,b)
 #  define LD_PS1(p) _mm256_set1_pd(p)
 #  define VLOAD_UNALIGNED(ptr)  _mm256_loadu_pd(ptr)
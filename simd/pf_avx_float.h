@@ -0,0 +1,141 @@
+/* Copyright (c) 2013  Julien Pommier ( pommier@modartt.com )
+
+   Redistribution and use of the Software in source and binary forms,
+   with or without modification, is permitted provided that the
+   following conditions are met:
+
+   - Neither the names of NCAR's Computational and Information Systems
+   Laboratory, the University Corporation for Atmospheric Research,
+   nor the names of its sponsors or contributors may be used to
+   endorse or promote products derived from this Software without
+   specific prior written permission.
+
+   - Redistributions of source code must retain the above copyright
+   notices, this list of conditions, and the disclaimer below.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions, and the disclaimer below in the
+   documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+   SOFTWARE.
+*/
+
+#ifndef PF_AVX_FLT_H
+#define PF_AVX_FLT_H
+
+/*
+   vector support macros: the rest of the code is independant of
+   AVX -- adding support for other platforms with 8-element
+   vectors should be limited to these macros
+*/
+
+
+/*
+  AVX support macros
+*/
+#if !defined(SIMD_SZ) && !defined(PFFFT_SIMD_DISABLE) && defined(__AVX__)
+#pragma message( __FILE__ ": AVX float macros are defined" )
+
+#include <immintrin.h>
+typedef __m256 v4sf;
+
+/* 8 floats by simd vector */
+#  define SIMD_SZ 8
+
+typedef union v4sf_union {
+  v4sf  v;
+  float f[SIMD_SZ];
+} v4sf_union;
+
+#  define VZERO() _mm256_setzero_ps()
+#  define VMUL(a,b) _mm256_mul_ps(a,b)
+#  define VADD(a,b) _mm256_add_ps(a,b)
+#if defined(__FMA__)
+#  define VARCH "AVX+FMA"
+#  define VMADD(a,b,c) _mm256_fmadd_ps(a,b,c)
+#else
+#  define VARCH "AVX"
+#  define VMADD(a,b,c) _mm256_add_ps(_mm256_mul_ps(a,b), c)
+#endif
+#  define VREQUIRES_ALIGN 1
+#  define VSUB(a,b) _mm256_sub_ps(a,b)
+#  define LD_PS1(p) _mm256_set1_ps(p)
+#  define VLOAD_UNALIGNED(ptr)  _mm256_loadu_ps(ptr)
+#  define VLOAD_ALIGNED(ptr)    _mm256_load_ps(ptr)
+
+/* INTERLEAVE2 (in1, in2, out1, out2) pseudo code:
+out1 = [ in1[0], in2[0], in1[1], in2[1], in1[2], in2[2], in1[3], in2[3] ]
+out2 = [ in1[4], in2[4], in1[5], in2[5], in1[6], in2[6], in1[7], in2[7] ]
+*/
+#  define INTERLEAVE2(in1, in2, out1, out2) {                   \
+    __m256 lo__ = _mm256_unpacklo_ps(in1, in2);                 \
+    __m256 hi__ = _mm256_unpackhi_ps(in1, in2);                 \
+    out1 = _mm256_permute2f128_ps(lo__, hi__, 0x20);            \
+    out2 = _mm256_permute2f128_ps(lo__, hi__, 0x31);            \
+}
+
+/* UNINTERLEAVE2(in1, in2, out1, out2) pseudo code:
+out1 = [ in1[0], in1[2], in1[4], in1[6], in2[0], in2[2], in2[4], in2[6] ]
+out2 = [ in1[1], in1[3], in1[5], in1[7], in2[1], in2[3], in2[5], in2[7] ]
+*/
+#  define UNINTERLEAVE2(in1, in2, out1, out2) {                 \
+    __m256 lo__ = _mm256_permute2f128_ps(in1, in2, 0x20);       \
+    __m256 hi__ = _mm256_permute2f128_ps(in1, in2, 0x31);       \
+    out1 = _mm256_shuffle_ps(lo__, hi__, _MM_SHUFFLE(2,0,2,0)); \
+    out2 = _mm256_shuffle_ps(lo__, hi__, _MM_SHUFFLE(3,1,3,1)); \
+}
+
+#  define VTRANSPOSE8(row0, row1, row2, row3, row4, row5, row6, row7) {  \
+    __m256 t0__, t1__, t2__, t3__, t4__, t5__, t6__, t7__;              \
+    __m256 s0__, s1__, s2__, s3__, s4__, s5__, s6__, s7__;              \
+    t0__ = _mm256_unpacklo_ps(row0, row1);                              \
+    t1__ = _mm256_unpackhi_ps(row0, row1);                              \
+    t2__ = _mm256_unpacklo_ps(row2, row3);                              \
+    t3__ = _mm256_unpackhi_ps(row2, row3);                              \
+    t4__ = _mm256_unpacklo_ps(row4, row5);                              \
+    t5__ = _mm256_unpackhi_ps(row4, row5);                              \
+    t6__ = _mm256_unpacklo_ps(row6, row7);                              \
+    t7__ = _mm256_unpackhi_ps(row6, row7);                              \
+    s0__ = _mm256_shuffle_ps(t0__, t2__, _MM_SHUFFLE(1,0,1,0));         \
+    s1__ = _mm256_shuffle_ps(t0__, t2__, _MM_SHUFFLE(3,2,3,2));         \
+    s2__ = _mm256_shuffle_ps(t1__, t3__, _MM_SHUFFLE(1,0,1,0));         \
+    s3__ = _mm256_shuffle_ps(t1__, t3__, _MM_SHUFFLE(3,2,3,2));         \
+    s4__ = _mm256_shuffle_ps(t4__, t6__, _MM_SHUFFLE(1,0,1,0));         \
+    s5__ = _mm256_shuffle_ps(t4__, t6__, _MM_SHUFFLE(3,2,3,2));         \
+    s6__ = _mm256_shuffle_ps(t5__, t7__, _MM_SHUFFLE(1,0,1,0));         \
+    s7__ = _mm256_shuffle_ps(t5__, t7__, _MM_SHUFFLE(3,2,3,2));         \
+    (row0) = _mm256_permute2f128_ps(s0__, s4__, 0x20);                  \
+    (row1) = _mm256_permute2f128_ps(s1__, s5__, 0x20);                  \
+    (row2) = _mm256_permute2f128_ps(s2__, s6__, 0x20);                  \
+    (row3) = _mm256_permute2f128_ps(s3__, s7__, 0x20);                  \
+    (row4) = _mm256_permute2f128_ps(s0__, s4__, 0x31);                  \
+    (row5) = _mm256_permute2f128_ps(s1__, s5__, 0x31);                  \
+    (row6) = _mm256_permute2f128_ps(s2__, s6__, 0x31);                  \
+    (row7) = _mm256_permute2f128_ps(s3__, s7__, 0x31);                  \
+}
+
+/* VSWAPHL(a, b) pseudo code:
+return [ b[0], b[1], b[2], b[3], a[4], a[5], a[6], a[7] ]
+*/
+#  define VSWAPHL(a,b)  _mm256_blend_ps(a, b, 0x0F)
+
+/* reverse/flip all floats */
+#  define VREV_S(a)    _mm256_permute2f128_ps(_mm256_permute_ps(a, _MM_SHUFFLE(0,1,2,3)), _mm256_permute_ps(a, _MM_SHUFFLE(0,1,2,3)), 0x01)
+
+/* reverse/flip complex floats */
+#  define VREV_C(a)    _mm256_permute2f128_ps(_mm256_permute_ps(a, _MM_SHUFFLE(1,0,3,2)), _mm256_permute_ps(a, _MM_SHUFFLE(1,0,3,2)), 0x01)
+
+#  define VALIGNED(ptr) ((((uintptr_t)(ptr)) & 0x1F) == 0)
+
+#endif
+
+#endif /* PF_AVX_FLT_H */
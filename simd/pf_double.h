@@ -44,11 +44,15 @@
  * general SIMD introduction:
  * https://www.linuxjournal.com/content/introduction-gcc-compiler-intrinsics-vector-processing
  *
- * SSE 1:
+ * SSE 1 / AVX / AVX-512:
  * https://software.intel.com/sites/landingpage/IntrinsicsGuide/
  *
- * ARM NEON:
+ * ARM NEON / SVE:
  * https://developer.arm.com/architectures/instruction-sets/simd-isas/neon/intrinsics
+ * https://developer.arm.com/architectures/instruction-sets/intrinsics/
+ *
+ * RISC-V Vector:
+ * https://github.com/riscv-non-isa/rvv-intrinsic-doc
  *
  * Altivec:
  * https://www.nxp.com/docs/en/reference-manual/ALTIVECPIM.pdf
@@ -59,8 +63,11 @@
 
 typedef double vsfscalar;
 
+#include "pf_avx512_double.h"
 #include "pf_avx_double.h"
 #include "pf_sse2_double.h"
+#include "pf_sve_double.h"
+#include "pf_rvv_double.h"
 #include "pf_neon_double.h"
 
 #ifndef SIMD_SZ
@@ -0,0 +1,90 @@
+/* Copyright (c) 2013  Julien Pommier ( pommier@modartt.com )
+
+   Redistribution and use of the Software in source and binary forms,
+   with or without modification, is permitted provided that the
+   following conditions are met:
+
+   - Neither the names of NCAR's Computational and Information Systems
+   Laboratory, the University Corporation for Atmospheric Research,
+   nor the names of its sponsors or contributors may be used to
+   endorse or promote products derived from this Software without
+   specific prior written permission.
+
+   - Redistributions of source code must retain the above copyright
+   notices, this list of conditions, and the disclaimer below.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions, and the disclaimer below in the
+   documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+   SOFTWARE.
+*/
+
+
+#ifndef PF_RVV_DBL_H
+#define PF_RVV_DBL_H
+
+/*
+  RISC-V Vector (RVV 1.0) support macros
+
+  as for float, only with a vector length fixed at compile time - see
+  pf_rvv_float.h. there is no double code for 2-element vectors: with
+  VLEN 128, a vector is a LMUL=2 register group of 4 doubles. with VLEN
+  256 or 512, one LMUL=1 register holds 4 or 8 doubles.
+*/
+#if !defined(SIMD_SZ) && !defined(PFFFT_SIMD_DISABLE) && defined(PFFFT_ENABLE_RVV) && defined(__riscv_v_intrinsic) \
+    && defined(__riscv_v_fixed_vlen) && (__riscv_v_fixed_vlen == 128 || __riscv_v_fixed_vlen == 256 || __riscv_v_fixed_vlen == 512)
+#pragma message( __FILE__ ": RISC-V Vector double macros are defined" )
+
+#include <riscv_vector.h>
+
+#if ( __riscv_v_fixed_vlen == 128 )
+typedef vfloat64m2_t v4sf __attribute__((riscv_rvv_vector_bits(2 * __riscv_v_fixed_vlen)));
+#  define SIMD_SZ 4
+#  define RVV_F_(op) __riscv_##op##_f64m2
+#  define RVV_U_(op) __riscv_##op##_u64m2
+#  define RVV_B_(op) __riscv_##op##_u64m2_b32
+#  define RVV_U_T_ vuint64m2_t
+#  define RVV_B_T_ vbool32_t
+#else
+typedef vfloat64m1_t v4sf __attribute__((riscv_rvv_vector_bits(__riscv_v_fixed_vlen)));
+/* 4 or 8 doubles by simd vector */
+#  define SIMD_SZ (__riscv_v_fixed_vlen / 64)
+#  define RVV_F_(op) __riscv_##op##_f64m1
+#  define RVV_U_(op) __riscv_##op##_u64m1
+#  define RVV_B_(op) __riscv_##op##_u64m1_b64
+#  define RVV_U_T_ vuint64m1_t
+#  define RVV_B_T_ vbool64_t
+#endif
+
+typedef union v4sf_union {
+  v4sf  v;
+  double f[SIMD_SZ];
+} v4sf_union;
+
+#  define VARCH "RVV"
+#  define VREQUIRES_ALIGN 0
+#  define VZERO() RVV_F_(vfmv_v_f)(0.0, SIMD_SZ)
+#  define VMUL(a,b) RVV_F_(vfmul_vv)(a, b, SIMD_SZ)
+#  define VADD(a,b) RVV_F_(vfadd_vv)(a, b, SIMD_SZ)
+#  define VMADD(a,b,c) RVV_F_(vfmacc_vv)(c, a, b, SIMD_SZ)
+#  define VSUB(a,b) RVV_F_(vfsub_vv)(a, b, SIMD_SZ)
+#  define LD_PS1(p) RVV_F_(vfmv_v_f)(p, SIMD_SZ)
+#  define VLOAD_UNALIGNED(ptr)  RVV_F_(vle64_v)((const double *)(ptr), SIMD_SZ)
+#  define VLOAD_ALIGNED(ptr)    (*((v4sf*)(ptr)))
+#  define VALIGNED(ptr) ((((uintptr_t)(ptr)) & (SIMD_SZ * 8 - 1)) == 0)
+
+#include "pf_rvv_permute.h"
+
+#endif
+
+#endif /* PF_RVV_DBL_H */
@@ -0,0 +1,83 @@
+/* Copyright (c) 2013  Julien Pommier ( pommier@modartt.com )
+
+   Redistribution and use of the Software in source and binary forms,
+   with or without modification, is permitted provided that the
+   following conditions are met:
+
+   - Neither the names of NCAR's Computational and Information Systems
+   Laboratory, the University Corporation for Atmospheric Research,
+   nor the names of its sponsors or contributors may be used to
+   endorse or promote products derived from this Software without
+   specific prior written permission.
+
+   - Redistributions of source code must retain the above copyright
+   notices, this list of conditions, and the disclaimer below.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions, and the disclaimer below in the
+   documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+   SOFTWARE.
+*/
+
+
+#ifndef PF_RVV_FLT_H
+#define PF_RVV_FLT_H
+
+/*
+  RISC-V Vector (RVV 1.0) support macros
+
+  as with SVE, the vector length has to be fixed at compile time, e.g.
+  with -march=rv64gcv_zvl256b -mrvv-vector-bits=zvl, which gives
+  __riscv_v_fixed_vlen and fixed-length vector types: v4sf has to be a
+  complete type. one LMUL=1 register holds 4, 8 or 16 floats with VLEN
+  128, 256 or 512. the binary requires a cpu with exactly this VLEN.
+*/
+#if !defined(SIMD_SZ) && !defined(PFFFT_SIMD_DISABLE) && defined(PFFFT_ENABLE_RVV) && defined(__riscv_v_intrinsic) \
+    && defined(__riscv_v_fixed_vlen) && (__riscv_v_fixed_vlen == 128 || __riscv_v_fixed_vlen == 256 || __riscv_v_fixed_vlen == 512)
+#pragma message( __FILE__ ": RISC-V Vector float macros are defined" )
+
+#include <riscv_vector.h>
+typedef vfloat32m1_t v4sf __attribute__((riscv_rvv_vector_bits(__riscv_v_fixed_vlen)));
+
+/* 4, 8 or 16 floats by simd vector */
+#  define SIMD_SZ (__riscv_v_fixed_vlen / 32)
+
+typedef union v4sf_union {
+  v4sf  v;
+  float f[SIMD_SZ];
+} v4sf_union;
+
+/* intrinsic names for the vector types in use: vfloat32m1_t, vuint32m1_t, vbool32_t */
+#  define RVV_F_(op) __riscv_##op##_f32m1
+#  define RVV_U_(op) __riscv_##op##_u32m1
+#  define RVV_B_(op) __riscv_##op##_u32m1_b32
+#  define RVV_U_T_ vuint32m1_t
+#  define RVV_B_T_ vbool32_t
+
+#  define VARCH "RVV"
+#  define VREQUIRES_ALIGN 0
+#  define VZERO() RVV_F_(vfmv_v_f)(0.0f, SIMD_SZ)
+#  define VMUL(a,b) RVV_F_(vfmul_vv)(a, b, SIMD_SZ)
+#  define VADD(a,b) RVV_F_(vfadd_vv)(a, b, SIMD_SZ)
+#  define VMADD(a,b,c) RVV_F_(vfmacc_vv)(c, a, b, SIMD_SZ)
+#  define VSUB(a,b) RVV_F_(vfsub_vv)(a, b, SIMD_SZ)
+#  define LD_PS1(p) RVV_F_(vfmv_v_f)(p, SIMD_SZ)
+#  define VLOAD_UNALIGNED(ptr)  RVV_F_(vle32_v)((const float *)(ptr), SIMD_SZ)
+#  define VLOAD_ALIGNED(ptr)    (*((v4sf*)(ptr)))
+#  define VALIGNED(ptr) ((((uintptr_t)(ptr)) & (SIMD_SZ * 4 - 1)) == 0)
+
+#include "pf_rvv_permute.h"
+
+#endif
+
+#endif /* PF_RVV_FLT_H */
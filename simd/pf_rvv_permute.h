@@ -0,0 +1,121 @@
+/* Copyright (c) 2013  Julien Pommier ( pommier@modartt.com )
+
+   Redistribution and use of the Software in source and binary forms,
+   with or without modification, is permitted provided that the
+   following conditions are met:
+
+   - Neither the names of NCAR's Computational and Information Systems
+   Laboratory, the University Corporation for Atmospheric Research,
+   nor the names of its sponsors or contributors may be used to
+   endorse or promote products derived from this Software without
+   specific prior written permission.
+
+   - Redistributions of source code must retain the above copyright
+   notices, this list of conditions, and the disclaimer below.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions, and the disclaimer below in the
+   documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+   SOFTWARE.
+*/
+
+
+#ifndef PF_RVV_PERMUTE_H
+#define PF_RVV_PERMUTE_H
+
+/*
+  RISC-V Vector permutation macros - common to float and double:
+  included from pf_rvv_float.h / pf_rvv_double.h, after the definition
+  of SIMD_SZ, of the vector types RVV_U_T_ (indices) and RVV_B_T_ (mask)
+  and of the intrinsic name prefixes RVV_F_(), RVV_U_() and RVV_B_().
+  the permutations are register gathers (vrgather) with index vectors.
+*/
+
+/* element indices [ 0, 1, .. SIMD_SZ-1 ] */
+#define RVV_IDX_() RVV_U_(vid_v)(SIMD_SZ)
+
+/* INTERLEAVE2 (in1, in2, out1, out2) pseudo code:
+out1 = [ in1[0], in2[0], in1[1], in2[1], .. ]  - the lower halves
+out2 = [ .. in1[SIMD_SZ-1], in2[SIMD_SZ-1] ]    - the upper halves
+*/
+#define INTERLEAVE2(in1, in2, out1, out2) {                                           \
+    RVV_U_T_ idx__ = RVV_U_(vsrl_vx)(RVV_IDX_(), 1, SIMD_SZ);                         \
+    RVV_B_T_ odd__ = RVV_B_(vmsne_vx)(RVV_U_(vand_vx)(RVV_IDX_(), 1, SIMD_SZ), 0, SIMD_SZ); \
+    v4sf tmp__ = RVV_F_(vmerge_vvm)(RVV_F_(vrgather_vv)(in1, idx__, SIMD_SZ),          \
+                                    RVV_F_(vrgather_vv)(in2, idx__, SIMD_SZ), odd__, SIMD_SZ); \
+    idx__ = RVV_U_(vadd_vx)(idx__, SIMD_SZ/2, SIMD_SZ);                                \
+    out2 = RVV_F_(vmerge_vvm)(RVV_F_(vrgather_vv)(in1, idx__, SIMD_SZ),                \
+                              RVV_F_(vrgather_vv)(in2, idx__, SIMD_SZ), odd__, SIMD_SZ); \
+    out1 = tmp__;                                                                     \
+}
+
+/* UNINTERLEAVE2(in1, in2, out1, out2) pseudo code:
+out1 = [ in1[0], in1[2], .. in2[0], in2[2], .. ]
+out2 = [ in1[1], in1[3], .. in2[1], in2[3], .. ]
+compress the even/odd elements of each input, then slide in2's above in1's
+*/
+#define UNINTERLEAVE2(in1, in2, out1, out2) {                                         \
+    RVV_B_T_ even__ = RVV_B_(vmseq_vx)(RVV_U_(vand_vx)(RVV_IDX_(), 1, SIMD_SZ), 0, SIMD_SZ); \
+    RVV_B_T_ odd__ = RVV_B_(vmsne_vx)(RVV_U_(vand_vx)(RVV_IDX_(), 1, SIMD_SZ), 0, SIMD_SZ);  \
+    v4sf tmp__ = RVV_F_(vslideup_vx)(RVV_F_(vcompress_vm)(in1, even__, SIMD_SZ),       \
+                                     RVV_F_(vcompress_vm)(in2, even__, SIMD_SZ), SIMD_SZ/2, SIMD_SZ); \
+    out2 = RVV_F_(vslideup_vx)(RVV_F_(vcompress_vm)(in1, odd__, SIMD_SZ),              \
+                               RVV_F_(vcompress_vm)(in2, odd__, SIMD_SZ), SIMD_SZ/2, SIMD_SZ); \
+    out1 = tmp__;                                                                     \
+}
+
+/* transposes the SIMD_SZ x SIMD_SZ matrix in the array of vectors row[]:
+   log2(SIMD_SZ) rounds of interleaving row k with row k + SIMD_SZ/2 */
+#define VTRANSPOSE_ZIP_(row) {                                                        \
+    v4sf t__[SIMD_SZ];                                                                \
+    int k__, s__;                                                                     \
+    for (s__ = 1; s__ < SIMD_SZ; s__ *= 2) {                                          \
+      for (k__ = 0; k__ < SIMD_SZ/2; ++k__)                                           \
+        INTERLEAVE2(row[k__], row[k__+SIMD_SZ/2], t__[2*k__], t__[2*k__+1]);          \
+      for (k__ = 0; k__ < SIMD_SZ; ++k__)                                             \
+        row[k__] = t__[k__];                                                          \
+    }                                                                                 \
+}
+
+#if ( SIMD_SZ == 4 )
+#  define VTRANSPOSE4(x0,x1,x2,x3) {                                                  \
+    v4sf r__[4];                                                                      \
+    r__[0] = x0; r__[1] = x1; r__[2] = x2; r__[3] = x3;                               \
+    VTRANSPOSE_ZIP_(r__);                                                             \
+    x0 = r__[0]; x1 = r__[1]; x2 = r__[2]; x3 = r__[3];                               \
+  }
+#elif ( SIMD_SZ == 8 )
+#  define VTRANSPOSE8(row0, row1, row2, row3, row4, row5, row6, row7) {               \
+    v4sf r__[8];                                                                      \
+    r__[0] = row0; r__[1] = row1; r__[2] = row2; r__[3] = row3;                       \
+    r__[4] = row4; r__[5] = row5; r__[6] = row6; r__[7] = row7;                       \
+    VTRANSPOSE_ZIP_(r__);                                                             \
+    (row0) = r__[0]; (row1) = r__[1]; (row2) = r__[2]; (row3) = r__[3];               \
+    (row4) = r__[4]; (row5) = r__[5]; (row6) = r__[6]; (row7) = r__[7];               \
+}
+#else
+#  define VTRANSPOSE16(row) VTRANSPOSE_ZIP_(row)
+#endif
+
+/* VSWAPHL(a, b) pseudo code:
+return [ b[0], .. b[SIMD_SZ/2-1], a[SIMD_SZ/2], .. a[SIMD_SZ-1] ]
+*/
+#define VSWAPHL(a,b)  RVV_F_(vmerge_vvm)(a, b, RVV_B_(vmsltu_vx)(RVV_IDX_(), SIMD_SZ/2, SIMD_SZ), SIMD_SZ)
+
+/* reverse/flip all elements: index SIMD_SZ-1-k */
+#define VREV_S(a)    RVV_F_(vrgather_vv)(a, RVV_U_(vrsub_vx)(RVV_IDX_(), SIMD_SZ-1, SIMD_SZ), SIMD_SZ)
+
+/* reverse/flip complex elements: index (SIMD_SZ-1-k) ^ 1 */
+#define VREV_C(a)    RVV_F_(vrgather_vv)(a, RVV_U_(vxor_vx)(RVV_U_(vrsub_vx)(RVV_IDX_(), SIMD_SZ-1, SIMD_SZ), 1, SIMD_SZ), SIMD_SZ)
+
+#endif /* PF_RVV_PERMUTE_H */
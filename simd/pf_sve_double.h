@@ -0,0 +1,130 @@
+/* Copyright (c) 2013  Julien Pommier ( pommier@modartt.com )
+
+   Redistribution and use of the Software in source and binary forms,
+   with or without modification, is permitted provided that the
+   following conditions are met:
+
+   - Neither the names of NCAR's Computational and Information Systems
+   Laboratory, the University Corporation for Atmospheric Research,
+   nor the names of its sponsors or contributors may be used to
+   endorse or promote products derived from this Software without
+   specific prior written permission.
+
+   - Redistributions of source code must retain the above copyright
+   notices, this list of conditions, and the disclaimer below.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions, and the disclaimer below in the
+   documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+   SOFTWARE.
+*/
+
+
+#ifndef PF_SVE_DBL_H
+#define PF_SVE_DBL_H
+
+/*
+  ARM SVE support macros
+
+  as for float, only with a vector length fixed at compile time:
+  -msve-vector-bits=256 or 512 - see pf_sve_float.h
+*/
+#if !defined(SIMD_SZ) && !defined(PFFFT_SIMD_DISABLE) && defined(PFFFT_ENABLE_SVE) && defined(__ARM_FEATURE_SVE) \
+    && defined(__ARM_FEATURE_SVE_BITS) && (__ARM_FEATURE_SVE_BITS == 256 || __ARM_FEATURE_SVE_BITS == 512)
+#pragma message( __FILE__ ": ARM SVE double macros are defined" )
+
+#include <arm_sve.h>
+typedef svfloat64_t v4sf __attribute__((arm_sve_vector_bits(__ARM_FEATURE_SVE_BITS)));
+
+/* 4 or 8 doubles by simd vector */
+#  define SIMD_SZ (__ARM_FEATURE_SVE_BITS / 64)
+
+typedef union v4sf_union {
+  v4sf  v;
+  double f[SIMD_SZ];
+} v4sf_union;
+
+#  define VARCH "SVE"
+#  define VREQUIRES_ALIGN 0
+#  define VZERO() svdup_n_f64(0.0)
+#  define VMUL(a,b) svmul_f64_x(svptrue_b64(), a, b)
+#  define VADD(a,b) svadd_f64_x(svptrue_b64(), a, b)
+#  define VMADD(a,b,c) svmla_f64_x(svptrue_b64(), c, a, b)
+#  define VSUB(a,b) svsub_f64_x(svptrue_b64(), a, b)
+#  define LD_PS1(p) svdup_n_f64(p)
+#  define VLOAD_UNALIGNED(ptr)  svld1_f64(svptrue_b64(), (const double *)(ptr))
+#  define VLOAD_ALIGNED(ptr)    (*((v4sf*)(ptr)))
+
+/* INTERLEAVE2 (in1, in2, out1, out2) pseudo code:
+out1 = [ in1[0], in2[0], in1[1], in2[1], .. ]  - the lower halves
+out2 = [ .. in1[SIMD_SZ-1], in2[SIMD_SZ-1] ]    - the upper halves
+*/
+#  define INTERLEAVE2(in1, in2, out1, out2) {   \
+    v4sf tmp__ = svzip1_f64(in1, in2);          \
+    out2 = svzip2_f64(in1, in2);                \
+    out1 = tmp__;                               \
+}
+
+/* UNINTERLEAVE2(in1, in2, out1, out2) pseudo code:
+out1 = [ in1[0], in1[2], .. in2[0], in2[2], .. ]
+out2 = [ in1[1], in1[3], .. in2[1], in2[3], .. ]
+*/
+#  define UNINTERLEAVE2(in1, in2, out1, out2) { \
+    v4sf tmp__ = svuzp1_f64(in1, in2);          \
+    out2 = svuzp2_f64(in1, in2);                \
+    out1 = tmp__;                               \
+}
+
+#if ( __ARM_FEATURE_SVE_BITS == 256 )
+#  define VTRANSPOSE4(x0,x1,x2,x3) {                                    \
+    v4sf t0_ = svzip1_f64(x0, x2), t1_ = svzip2_f64(x0, x2);            \
+    v4sf t2_ = svzip1_f64(x1, x3), t3_ = svzip2_f64(x1, x3);            \
+    x0 = svzip1_f64(t0_, t2_); x1 = svzip2_f64(t0_, t2_);               \
+    x2 = svzip1_f64(t1_, t3_); x3 = svzip2_f64(t1_, t3_);               \
+  }
+#else
+/* 3 rounds of zipping row k with row k + 4 */
+#  define VTRANSPOSE8(row0, row1, row2, row3, row4, row5, row6, row7) {   \
+    v4sf r__[8], t__[8];                                                  \
+    int k__, r2__;                                                        \
+    r__[0] = row0; r__[1] = row1; r__[2] = row2; r__[3] = row3;           \
+    r__[4] = row4; r__[5] = row5; r__[6] = row6; r__[7] = row7;           \
+    for (r2__ = 0; r2__ < 3; ++r2__) {                                    \
+      for (k__ = 0; k__ < 4; ++k__) {                                     \
+        t__[2*k__]   = svzip1_f64(r__[k__], r__[k__+4]);                  \
+        t__[2*k__+1] = svzip2_f64(r__[k__], r__[k__+4]);                  \
+      }                                                                   \
+      for (k__ = 0; k__ < 8; ++k__)                                       \
+        r__[k__] = t__[k__];                                              \
+    }                                                                     \
+    (row0) = r__[0]; (row1) = r__[1]; (row2) = r__[2]; (row3) = r__[3];   \
+    (row4) = r__[4]; (row5) = r__[5]; (row6) = r__[6]; (row7) = r__[7];   \
+}
+#endif
+
+/* VSWAPHL(a, b) pseudo code:
+return [ b[0], .. b[SIMD_SZ/2-1], a[SIMD_SZ/2], .. a[SIMD_SZ-1] ]
+*/
+#  define VSWAPHL(a,b)  svsel_f64(svwhilelt_b64_s32(0, SIMD_SZ/2), b, a)
+
+/* reverse/flip all doubles */
+#  define VREV_S(a)    svrev_f64(a)
+
+/* reverse/flip complex doubles: reverse, then swap the neighbours back */
+#  define VREV_C(a)    svtbl_f64(a, sveor_n_u64_x(svptrue_b64(), svindex_u64(SIMD_SZ - 1, (uint64_t)-1), 1))
+
+#  define VALIGNED(ptr) ((((uintptr_t)(ptr)) & (SIMD_SZ * 8 - 1)) == 0)
+
+#endif
+
+#endif /* PF_SVE_DBL_H */
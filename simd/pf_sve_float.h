@@ -0,0 +1,134 @@
+/* Copyright (c) 2013  Julien Pommier ( pommier@modartt.com )
+
+   Redistribution and use of the Software in source and binary forms,
+   with or without modification, is permitted provided that the
+   following conditions are met:
+
+   - Neither the names of NCAR's Computational and Information Systems
+   Laboratory, the University Corporation for Atmospheric Research,
+   nor the names of its sponsors or contributors may be used to
+   endorse or promote products derived from this Software without
+   specific prior written permission.
+
+   - Redistributions of source code must retain the above copyright
+   notices, this list of conditions, and the disclaimer below.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions, and the disclaimer below in the
+   documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE CONTRIBUTORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+   SOFTWARE.
+*/
+
+
+#ifndef PF_SVE_FLT_H
+#define PF_SVE_FLT_H
+
+/*
+  ARM SVE support macros
+
+  SVE vectors have no size at compile time - but v4sf has to be a
+  complete type: it's used in arrays, unions and in (v4sf*) casts.
+  that's why these are used only when the vector length is fixed at
+  compile time with -msve-vector-bits=256 or 512, which gives
+  __ARM_FEATURE_SVE_BITS and fixed-length vector types.
+  the binary requires a cpu with exactly this vector length.
+  with 128 bits, NEON is used.
+*/
+#if !defined(SIMD_SZ) && !defined(PFFFT_SIMD_DISABLE) && defined(PFFFT_ENABLE_SVE) && defined(__ARM_FEATURE_SVE) \
+    && defined(__ARM_FEATURE_SVE_BITS) && (__ARM_FEATURE_SVE_BITS == 256 || __ARM_FEATURE_SVE_BITS == 512)
+#pragma message( __FILE__ ": ARM SVE float macros are defined" )
+
+#include <arm_sve.h>
+typedef svfloat32_t v4sf __attribute__((arm_sve_vector_bits(__ARM_FEATURE_SVE_BITS)));
+
+/* 8 or 16 floats by simd vector */
+#  define SIMD_SZ (__ARM_FEATURE_SVE_BITS / 32)
+
+typedef union v4sf_union {
+  v4sf  v;
+  float f[SIMD_SZ];
+} v4sf_union;
+
+#  define VARCH "SVE"
+#  define VREQUIRES_ALIGN 0
+#  define VZERO() svdup_n_f32(0.0f)
+#  define VMUL(a,b) svmul_f32_x(svptrue_b32(), a, b)
+#  define VADD(a,b) svadd_f32_x(svptrue_b32(), a, b)
+#  define VMADD(a,b,c) svmla_f32_x(svptrue_b32(), c, a, b)
+#  define VSUB(a,b) svsub_f32_x(svptrue_b32(), a, b)
+#  define LD_PS1(p) svdup_n_f32(p)
+#  define VLOAD_UNALIGNED(ptr)  svld1_f32(svptrue_b32(), (const float *)(ptr))
+#  define VLOAD_ALIGNED(ptr)    (*((v4sf*)(ptr)))
+
+/* INTERLEAVE2 (in1, in2, out1, out2) pseudo code:
+out1 = [ in1[0], in2[0], in1[1], in2[1], .. ]  - the lower halves
+out2 = [ .. in1[SIMD_SZ-1], in2[SIMD_SZ-1] ]    - the upper halves
+*/
+#  define INTERLEAVE2(in1, in2, out1, out2) {   \
+    v4sf tmp__ = svzip1_f32(in1, in2);          \
+    out2 = svzip2_f32(in1, in2);                \
+    out1 = tmp__;                               \
+}
+
+/* UNINTERLEAVE2(in1, in2, out1, out2) pseudo code:
+out1 = [ in1[0], in1[2], .. in2[0], in2[2], .. ]
+out2 = [ in1[1], in1[3], .. in2[1], in2[3], .. ]
+*/
+#  define UNINTERLEAVE2(in1, in2, out1, out2) { \
+    v4sf tmp__ = svuzp1_f32(in1, in2);          \
+    out2 = svuzp2_f32(in1, in2);                \
+    out1 = tmp__;                               \
+}
+
+/* transposes the SIMD_SZ x SIMD_SZ matrix in the array of vectors row[]:
+   log2(SIMD_SZ) rounds of zipping row k with row k + SIMD_SZ/2 */
+#  define VTRANSPOSE_ZIP_(row) {                                  \
+    v4sf t__[SIMD_SZ];                                            \
+    int k__, s__;                                                 \
+    for (s__ = 1; s__ < SIMD_SZ; s__ *= 2) {                      \
+      for (k__ = 0; k__ < SIMD_SZ/2; ++k__)                       \
+        INTERLEAVE2(row[k__], row[k__+SIMD_SZ/2], t__[2*k__], t__[2*k__+1]); \
+      for (k__ = 0; k__ < SIMD_SZ; ++k__)                         \
+        row[k__] = t__[k__];                                      \
+    }                                                             \
+}
+
+#if ( __ARM_FEATURE_SVE_BITS == 256 )
+#  define VTRANSPOSE8(row0, row1, row2, row3, row4, row5, row6, row7) {   \
+    v4sf r__[8];                                                          \
+    r__[0] = row0; r__[1] = row1; r__[2] = row2; r__[3] = row3;           \
+    r__[4] = row4; r__[5] = row5; r__[6] = row6; r__[7] = row7;           \
+    VTRANSPOSE_ZIP_(r__);                                                 \
+    (row0) = r__[0]; (row1) = r__[1]; (row2) = r__[2]; (row3) = r__[3];   \
+    (row4) = r__[4]; (row5) = r__[5]; (row6) = r__[6]; (row7) = r__[7];   \
+}
+#else
+#  define VTRANSPOSE16(row) VTRANSPOSE_ZIP_(row)
+#endif
+
+/* VSWAPHL(a, b) pseudo code:
+return [ b[0], .. b[SIMD_SZ/2-1], a[SIMD_SZ/2], .. a[SIMD_SZ-1] ]
+*/
+#  define VSWAPHL(a,b)  svsel_f32(svwhilelt_b32_s32(0, SIMD_SZ/2), b, a)
+
+/* reverse/flip all floats */
+#  define VREV_S(a)    svrev_f32(a)
+
+/* reverse/flip complex floats: each (re, im) pair is one 64-bit element */
+#  define VREV_C(a)    svreinterpret_f32_f64(svrev_f64(svreinterpret_f64_f32(a)))
+
+#  define VALIGNED(ptr) ((((uintptr_t)(ptr)) & (SIMD_SZ * 4 - 1)) == 0)
+
+#endif
+
+#endif /* PF_SVE_FLT_H */
@@ -33,26 +33,40 @@ int test_float(int TL)
       fprintf(stderr, "testing float, %s, %s ..\tminimum transform %d; nearest transform for %d is %d (%.2f%% off)\n",
           (!dir_i) ? "FORWARD" : "BACKWARD", (!cplx_i) ? "REAL" : "COMPLEX", N_min, TL, NTL, near_off );
 
-      for (int N = (N_min/2); N <= N_max; N += (N_min/2))
+      /* without SIMD, N_min is 1 (complex) or 2 (real) */
+      const int N_step = (N_min >= 2) ? (N_min/2) : 1;
+      for (int N = N_step; N <= N_max; N += N_step)
       {
-        int R = N, f2 = 0, f3 = 0, f5 = 0, tmp_f;
+        int R = N, f2 = 0, f3 = 0, f5 = 0, f7 = 0, f11 = 0, f13 = 0, tmp_f;
+        if (cplx == PFFFT_REAL && (N % 2))
+          continue;   /* Bluestein's algorithm needs even N for real transforms */
         const int factorizable = pffft_is_valid_size(N, cplx);
+        while (R >= 13*N_min && (R % 13) == 0) {  R /= 13; ++f13; }
+        while (R >= 11*N_min && (R % 11) == 0) {  R /= 11; ++f11; }
+        while (R >= 7*N_min && (R % 7) == 0) {  R /= 7; ++f7; }
         while (R >= 5*N_min && (R % 5) == 0) {  R /= 5; ++f5; }
         while (R >= 3*N_min && (R % 3) == 0) {  R /= 3; ++f3; }
         while (R >= 2*N_min && (R % 2) == 0) {  R /= 2; ++f2; }
-        tmp_f = (R == N_min) ? 1 : 0;
+        tmp_f = (R == N_min && N >= 2) ? 1 : 0;
         assert( factorizable == tmp_f );
 
+        /* sizes without native factorization use Bluestein's algorithm:
+           setups for any (even for real) N. in-place setups are native only */
         S = pffft_new_setup(N, cplx);
 
-        if ( S && !factorizable )
+        if ( !S )
         {
-          fprintf(stderr, "fft setup successful, but NOT factorizable into min(=%d), 2^%d, 3^%d, 5^%d for N = %d (R = %d)\n", N_min, f2, f3, f5, N, R);
+          fprintf(stderr, "fft setup UNsuccessful for N = %d\n", N);
           return 1;
         }
-        else if ( !S && factorizable)
+        else if ( pffft_setup_size(N, cplx) && !factorizable )
         {
-          fprintf(stderr, "fft setup UNsuccessful, but factorizable into min(=%d), 2^%d, 3^%d, 5^%d for N = %d (R = %d)\n", N_min, f2, f3, f5, N, R);
+          fprintf(stderr, "native fft setup, but NOT factorizable into min(=%d), 2^%d, 3^%d, 5^%d, 7^%d, 11^%d, 13^%d for N = %d (R = %d)\n", N_min, f2, f3, f5, f7, f11, f13, N, R);
+          return 1;
+        }
+        else if ( !pffft_setup_size(N, cplx) && factorizable)
+        {
+          fprintf(stderr, "no native fft setup, but factorizable into min(=%d), 2^%d, 3^%d, 5^%d, 7^%d, 11^%d, 13^%d for N = %d (R = %d)\n", N_min, f2, f3, f5, f7, f11, f13, N, R);
           return 1;
         }
         
@@ -86,26 +100,40 @@ int test_double(int TL)
       fprintf(stderr, "testing double, %s, %s ..\tminimum transform %d; nearest transform for %d is %d (%.2f%% off)\n",
           (!dir_i) ? "FORWARD" : "BACKWARD", (!cplx_i) ? "REAL" : "COMPLEX", N_min, TL, NTL, near_off );
 
-      for (int N = (N_min/2); N <= N_max; N += (N_min/2))
+      /* without SIMD, N_min is 1 (complex) or 2 (real) */
+      const int N_step = (N_min >= 2) ? (N_min/2) : 1;
+      for (int N = N_step; N <= N_max; N += N_step)
       {
-        int R = N, f2 = 0, f3 = 0, f5 = 0, tmp_f;
+        int R = N, f2 = 0, f3 = 0, f5 = 0, f7 = 0, f11 = 0, f13 = 0, tmp_f;
+        if (cplx == PFFFT_REAL && (N % 2))
+          continue;   /* Bluestein's algorithm needs even N for real transforms */
         const int factorizable = pffftd_is_valid_size(N, cplx);
+        while (R >= 13*N_min && (R % 13) == 0) {  R /= 13; ++f13; }
+        while (R >= 11*N_min && (R % 11) == 0) {  R /= 11; ++f11; }
+        while (R >= 7*N_min && (R % 7) == 0) {  R /= 7; ++f7; }
         while (R >= 5*N_min && (R % 5) == 0) {  R /= 5; ++f5; }
         while (R >= 3*N_min && (R % 3) == 0) {  R /= 3; ++f3; }
         while (R >= 2*N_min && (R % 2) == 0) {  R /= 2; ++f2; }
-        tmp_f = (R == N_min) ? 1 : 0;
+        tmp_f = (R == N_min && N >= 2) ? 1 : 0;
         assert( factorizable == tmp_f );
 
+        /* sizes without native factorization use Bluestein's algorithm:
+           setups for any (even for real) N. in-place setups are native only */
         S = pffftd_new_setup(N, cplx);
 
-        if ( S && !factorizable )
+        if ( !S )
+        {
+          fprintf(stderr, "fft setup UNsuccessful for N = %d\n", N);
+          return 1;
+        }
+        else if ( pffftd_setup_size(N, cplx) && !factorizable )
         {
-          fprintf(stderr, "fft setup successful, but NOT factorizable into min(=%d), 2^%d, 3^%d, 5^%d for N = %d (R = %d)\n", N_min, f2, f3, f5, N, R);
+          fprintf(stderr, "native fft setup, but NOT factorizable into min(=%d), 2^%d, 3^%d, 5^%d, 7^%d, 11^%d, 13^%d for N = %d (R = %d)\n", N_min, f2, f3, f5, f7, f11, f13, N, R);
           return 1;
         }
-        else if ( !S && factorizable)
+        else if ( !pffftd_setup_size(N, cplx) && factorizable)
         {
-          fprintf(stderr, "fft setup UNsuccessful, but factorizable into min(=%d), 2^%d, 3^%d, 5^%d for N = %d (R = %d)\n", N_min, f2, f3, f5, N, R);
+          fprintf(stderr, "no native fft setup, but factorizable into min(=%d), 2^%d, 3^%d, 5^%d, 7^%d, 11^%d, 13^%d for N = %d (R = %d)\n", N_min, f2, f3, f5, f7, f11, f13, N, R);
           return 1;
         }
         
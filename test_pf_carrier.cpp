@@ -0,0 +1,126 @@
+/*
+  test of the carrier generators from pf_carrier.h: the SIMD / streaming fill
+  of the periodic patterns at any alignment and size - and the tone generators
+  against sin/cos in double precision
+ */
+
+#include "pf_carrier.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include <algorithm>
+#include <vector>
+
+
+typedef void (*gen_s16_t)(short* output, int size);
+typedef void (*gen_f_t)(float* output, int size);
+
+template <class T, class G>
+static int test_pattern(const char * name, G gen)
+{
+    /* sizes below and above PF_CARRIER_STREAM_BYTES */
+    const int sizes[] = { 4, 8, 60, 1024, 4 * PF_CARRIER_STREAM_BYTES / int(sizeof(T)) / 2 / 4 + 4 };
+    const T guard = T(1234);
+    std::vector<T> ref(8), buf;
+    int ret = 0;
+
+    gen(ref.data(), 4);
+    for (int size : sizes)
+    {
+        buf.assign(2 * size + 16, guard);
+        for (int off = 0; off < 8 && !ret; ++off)
+        {
+            std::fill(buf.begin(), buf.end(), guard);
+            gen(buf.data() + off, size);
+            for (int k = 0; k < 2 * size + 16 && !ret; ++k)
+            {
+                const T expected = (k < off || k >= off + 2 * size) ? guard : ref[(k - off) & 7];
+                if (buf[k] != expected)
+                {
+                    printf("%s: size %d, offset %d: mismatch at %d: FAILED\n", name, size, off, k);
+                    ret = 1;
+                }
+            }
+        }
+    }
+    return ret;
+}
+
+
+static int test_tone(float relative_freq, float amplitude)
+{
+    const int len = 1000003;
+    std::vector<float> yf(2 * len);
+    std::vector<short> ys(2 * len);
+    tone_gen_t gf, gs;
+    double maxErrF = 0.0, maxErrS = 0.0;
+    int off, n, k, ret = 0;
+
+    /* chunks of different sizes */
+    tone_gen_init(&gf, relative_freq, 0.5F, amplitude);
+    tone_gen_init(&gs, relative_freq, 0.5F, amplitude);
+    for (off = 0, k = 0; off < len; off += n, ++k)
+    {
+        n = std::min(1 + (k * 7919) % 5000, len - off);
+        generate_tone_f(yf.data() + 2 * off, n, &gf);
+        generate_tone_s16(ys.data() + 2 * off, n, &gs);
+    }
+
+    for (k = 0; k < len; ++k)
+    {
+        const double phi = 0.5 + 2.0 * M_PI * fmod((double)relative_freq * k, 1.0);
+        const double re = amplitude * cos(phi), im = amplitude * sin(phi);
+        maxErrF = std::max(maxErrF, std::max(fabs(yf[2 * k] - re), fabs(yf[2 * k + 1] - im)));
+        maxErrS = std::max(maxErrS, std::max(fabs(ys[2 * k] - re * SHRT_MAX), fabs(ys[2 * k + 1] - im * SHRT_MAX)));
+    }
+    if (maxErrF > 1E-4 || maxErrS > 4.0)
+        ret = 1;
+    printf("tone %9.6f, amplitude %4.2f: max error float %g, s16 %g LSB: %s\n",
+           relative_freq, amplitude, maxErrF, maxErrS, ret ? "FAILED" : "OK");
+    return ret;
+}
+
+
+int main(int argc, char **argv)
+{
+    int ret = 0;
+    (void)argc;
+    (void)argv;
+
+    ret |= test_pattern<float, gen_f_t>("generate_dc_f", generate_dc_f);
+    ret |= test_pattern<short, gen_s16_t>("generate_dc_s16", generate_dc_s16);
+    ret |= test_pattern<float, gen_f_t>("generate_pos_fs4_f", generate_pos_fs4_f);
+    ret |= test_pattern<short, gen_s16_t>("generate_pos_fs4_s16", generate_pos_fs4_s16);
+    ret |= test_pattern<float, gen_f_t>("generate_neg_fs4_f", generate_neg_fs4_f);
+    ret |= test_pattern<short, gen_s16_t>("generate_neg_fs4_s16", generate_neg_fs4_s16);
+    ret |= test_pattern<short, gen_s16_t>("generate_dc_pos_fs4_s16", generate_dc_pos_fs4_s16);
+    ret |= test_pattern<short, gen_s16_t>("generate_dc_neg_fs4_s16", generate_dc_neg_fs4_s16);
+    ret |= test_pattern<short, gen_s16_t>("generate_pos_neg_fs4_s16", generate_pos_neg_fs4_s16);
+    ret |= test_pattern<short, gen_s16_t>("generate_dc_pos_neg_fs4_s16", generate_dc_pos_neg_fs4_s16);
+    ret |= test_pattern<short, gen_s16_t>("generate_pos_neg_fs2_s16", generate_pos_neg_fs2_s16);
+    ret |= test_pattern<short, gen_s16_t>("generate_dc_pos_neg_fs2_s16", generate_dc_pos_neg_fs2_s16);
+
+    /* the patterns themselves: +fs/4 */
+    {
+        short y[8];
+        const short expected[8] = { SHRT_MAX, 0, 0, SHRT_MAX, -SHRT_MAX, 0, 0, -SHRT_MAX };
+        generate_pos_fs4_s16(y, 4);
+        for (int k = 0; k < 8; ++k)
+            if (y[k] != expected[k])
+                ret = 1;
+    }
+    if (!ret)
+        printf("patterns: OK\n");
+
+    ret |= test_tone(0.01F, 1.0F);
+    ret |= test_tone(-0.3137F, 0.5F);
+    ret |= test_tone(0.4999F, 0.9F);
+    ret |= test_tone(1.0F / 3.0F, 0.25F);
+
+    printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+    return ret;
+}
+
@@ -0,0 +1,172 @@
+/*
+  test of the polyphase channelizer pf_channelizer: compare each channel
+  against mixer, prototype filter and decimation - computed in double precision.
+  a tone at the center of a channel has to stay in this channel.
+ */
+
+#include "pf_channelizer.h"
+#include "pffft.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+
+typedef std::complex<double> cplx;
+
+/* Hann windowed sinc with cutoff at cutoff * samplerate */
+static std::vector<float> prototype(int len, double cutoff)
+{
+    std::vector<double> hd(len);
+    std::vector<float> h(len);
+    double sum = 0.0;
+    for (int k = 0; k < len; ++k)
+    {
+        const double t = k - 0.5 * (len - 1);
+        const double w = 0.5 - 0.5 * cos(2.0 * M_PI * (k + 1) / (len + 1));
+        const double x = 2.0 * M_PI * cutoff * t;
+        hd[k] = w * (fabs(x) < 1E-12 ? 1.0 : sin(x) / x);
+        sum += hd[k];
+    }
+    for (int k = 0; k < len; ++k)
+        h[k] = (float)(hd[k] / sum);   // unity gain at DC
+    return h;
+}
+
+
+static std::vector<complexf> run(channelizer_setup * s, const std::vector<complexf> & x, bool chunked)
+{
+    const int M = channelizer_num_channels(s);
+    std::vector<complexf> y, chunkOut;
+    int off, n, k;
+
+    channelizer_reset(s);
+    for (off = 0, k = 0; off < int(x.size()); off += n, ++k)
+    {
+        n = chunked ? std::min(1 + (k * 7919) % 3000, int(x.size()) - off) : int(x.size());
+        chunkOut.resize((size_t)channelizer_max_output_len(s, n) * M);
+        const int m = channelizer_process(s, x.data() + off, n, chunkOut.data());
+        if (m > channelizer_max_output_len(s, n))
+            return std::vector<complexf>();
+        y.insert(y.end(), chunkOut.begin(), chunkOut.begin() + (size_t)m * M);
+    }
+    return y;
+}
+
+
+static int test_channelizer(int M, int oversampling, int tapsPerBranch)
+{
+    const int D = M / oversampling;
+    const int len = 200 * D + 17;
+    const std::vector<float> h = prototype(tapsPerBranch * M - 3, 0.5 / M);
+    std::vector<complexf> x(len);
+    int k, m, l, ret = 0;
+
+    channelizer_setup * s = channelizer_new_setup(M, oversampling, h.data(), int(h.size()));
+    if (!s)
+    {
+        printf("M %d, oversampling %d: setup failed!\n", M, oversampling);
+        return 1;
+    }
+
+    srand(M + oversampling);
+    for (k = 0; k < len; ++k)
+    {
+        x[k].i = (float)rand() / RAND_MAX - 0.5f;
+        x[k].q = (float)rand() / RAND_MAX - 0.5f;
+    }
+
+    const std::vector<complexf> y = run(s, x, false);
+    const std::vector<complexf> yc = run(s, x, true);
+    const int numOut = int(y.size()) / M;
+    if (numOut != (len + D - 1) / D || y.size() != yc.size()
+        || memcmp(y.data(), yc.data(), y.size() * sizeof(complexf)))
+        ret = 1;
+
+    double errSum = 0.0, refSum = 0.0;
+    for (m = 0; m < numOut && !ret; ++m)
+    {
+        for (k = 0; k < M; ++k)
+        {
+            cplx ref(0.0, 0.0);
+            for (l = 0; l < int(h.size()) && l <= m * D; ++l)
+            {
+                const int n = m * D - l;
+                ref += (double)h[l] * cplx(x[n].i, x[n].q) * std::polar(1.0, -2.0 * M_PI * (double)(((long long)k * n) % M) / M);
+            }
+            errSum += std::norm(cplx(y[m * M + k].i, y[m * M + k].q) - ref);
+            refSum += std::norm(ref);
+        }
+    }
+    const double relErr = sqrt(errSum / (refSum > 0.0 ? refSum : 1.0));
+    if (relErr > 1E-5)
+        ret = 1;
+
+    /* tone at the center of channel c */
+    const int c = M / 3;
+    for (k = 0; k < len; ++k)
+    {
+        const double phi = 2.0 * M_PI * (double)(((long long)c * k) % M) / M;
+        x[k].i = (float)cos(phi);
+        x[k].q = (float)sin(phi);
+    }
+    const std::vector<complexf> yt = run(s, x, false);
+    double maxOther = 0.0, inChannel = 0.0;
+    for (m = tapsPerBranch * oversampling; m < numOut && !ret; ++m)
+    {
+        for (k = 0; k < M; ++k)
+        {
+            const double a = std::abs(cplx(yt[m * M + k].i, yt[m * M + k].q));
+            if (k == c)
+                inChannel = std::max(inChannel, a);
+            else
+                maxOther = std::max(maxOther, a);
+        }
+    }
+    /* the short prototype leaks more into the neighbour channels */
+    if (fabs(inChannel - 1.0) > 0.01 || maxOther > (tapsPerBranch >= 8 ? 0.01 : 0.05))
+        ret = 1;
+
+    printf("M %4d, oversampling %d, %3d taps: %d output steps, relative error %g, tone %g, other channels %g: %s\n",
+           M, oversampling, int(h.size()), numOut, relErr, inChannel, maxOther, ret ? "FAILED" : "OK");
+    channelizer_destroy_setup(s);
+    return ret;
+}
+
+
+int main(int argc, char **argv)
+{
+    int ret = 0;
+    (void)argc;
+    (void)argv;
+
+    const int sizes[] = { 64, 96, 256 };
+    for (int M : sizes)
+    {
+        if (!pffft_is_valid_size(M, PFFFT_COMPLEX))
+            continue;
+        ret |= test_channelizer(M, 1, 8);
+        ret |= test_channelizer(M, 2, 8);
+    }
+    // the minimum size - except without SIMD, where it's 1: no channelizer
+    if (pffft_min_fft_size(PFFFT_COMPLEX) >= 2)
+        ret |= test_channelizer(pffft_min_fft_size(PFFFT_COMPLEX), 2, 3);
+
+    std::vector<float> h = prototype(64, 0.01);
+    if (channelizer_new_setup(64, 3, h.data(), 64) || channelizer_new_setup(17, 1, h.data(), 64)
+        || channelizer_new_setup(1, 1, h.data(), 64)
+        || channelizer_new_setup(64, 1, nullptr, 64))
+    {
+        printf("parameter checks: FAILED\n");
+        ret = 1;
+    }
+
+    printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+    return ret;
+}
+
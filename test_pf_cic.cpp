@@ -0,0 +1,117 @@
+/*
+  test of the CIC decimator cic_decim_*() from pf_cic.h: compare against
+  the equivalent FIR filter - the N-fold convolution of R*M ones -
+  computed in double precision
+ */
+
+#include "pf_cic.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+
+static std::vector<double> cic_taps(int N, int R, int M)
+{
+    std::vector<double> h(1, 1.0);
+    for (int k = 0; k < N; ++k)
+    {
+        std::vector<double> t(h.size() + R * M - 1, 0.0);
+        for (size_t i = 0; i < h.size(); ++i)
+            for (int j = 0; j < R * M; ++j)
+                t[i + j] += h[i];
+        h.swap(t);
+    }
+    return h;
+}
+
+
+static int test_cic(int C, int N, int R, int M, int use_u8)
+{
+    const int len = 3000 + 7 * R;
+    const std::vector<double> h = cic_taps(N, R, M);
+    const double gain = pow((double)R * M, N) * 32768.0;
+    std::vector<int16_t> x16(len * C);
+    std::vector<uint8_t> x8(len * C);
+    std::vector<double> x(len * C);
+    std::vector<float> y;
+    int k, c, j, off, n, numOut = 0, ret = 0;
+    double maxErr = 0.0;
+
+    cic_decim_setup * s = cic_decim_new_setup(C, N, R, M);
+    if (!s)
+    {
+        printf("C %d, N %d, R %d, M %d: setup failed!\n", C, N, R, M);
+        return 1;
+    }
+
+    srand(C * 1000 + N * 100 + R + M);
+    for (k = 0; k < len * C; ++k)
+    {
+        x16[k] = (int16_t)(rand() % 65536 - 32768);
+        x8[k] = (uint8_t)(rand() % 256);
+        x[k] = use_u8 ? (x8[k] * 256.0 - 32614.0) : x16[k];
+    }
+
+    /* chunks of different sizes */
+    y.resize((size_t)cic_decim_max_output_len(s, len) * C);
+    for (off = 0, k = 0; off < len; off += n, ++k)
+    {
+        n = std::min(1 + (k * 97) % 700, len - off);
+        if (use_u8)
+            numOut += cic_decim_u8(s, &x8[off * C], n, &y[numOut * C]);
+        else
+            numOut += cic_decim_s16(s, &x16[off * C], n, &y[numOut * C]);
+    }
+
+    if (numOut != (len - 1) / R + 1)
+        ret = 1;
+    for (k = 0; k < numOut && !ret; ++k)
+    {
+        for (c = 0; c < C; ++c)
+        {
+            double ref = 0.0;
+            for (j = 0; j < int(h.size()) && j <= k * R; ++j)
+                ref += h[j] * x[(k * R - j) * C + c];
+            const double err = fabs(y[k * C + c] - ref / gain);
+            maxErr = std::max(maxErr, err);
+        }
+    }
+    if (maxErr > 1E-5)
+        ret = 1;
+    printf("%s: channels %d, order %d, decimation %3d, delay %d, %s bit: %d outputs, max error %g: %s\n",
+           use_u8 ? "u8 " : "s16", C, N, R, M, cic_decim_wide(s) ? "64" : "32", numOut, maxErr,
+           ret ? "FAILED" : "OK");
+
+    cic_decim_destroy_setup(s);
+    return ret;
+}
+
+
+int main(int argc, char **argv)
+{
+    int ret = 0;
+    (void)argc;
+    (void)argv;
+
+    ret |= test_cic(1, 1, 1, 1, 0);
+    ret |= test_cic(1, 3, 8, 1, 0);
+    ret |= test_cic(2, 3, 16, 1, 0);
+    ret |= test_cic(2, 4, 10, 2, 1);
+    ret |= test_cic(2, 5, 64, 1, 0);
+    ret |= test_cic(3, 2, 7, 2, 0);
+    ret |= test_cic(5, 8, 4, 1, 1);
+    ret |= test_cic(8, 6, 100, 1, 0);
+
+    if (cic_decim_new_setup(2, 8, 1000, 2) || cic_decim_new_setup(2, PF_CIC_MAX_ORDER + 1, 4, 1))
+    {
+        printf("parameter checks: FAILED\n");
+        ret = 1;
+    }
+
+    printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+    return ret;
+}
@@ -0,0 +1,166 @@
+/*
+  test of the multi-channel downconverter pf_ddc: compare each channel
+  against mixer, decimating filter and channel filter - computed
+  one after the other, in double precision
+ */
+
+#include "pf_ddc.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+
+typedef std::complex<double> cplx;
+
+static std::vector<float> random_taps(int n)
+{
+    std::vector<float> h(n);
+    for (int k = 0; k < n; ++k)
+        h[k] = ((float)rand() / RAND_MAX - 0.5f) / n;
+    return h;
+}
+
+static std::vector<cplx> reference(const std::vector<complexf> & x, int len, const ddc_channel_t & conf, int numOut)
+{
+    std::vector<cplx> mixed(len), dec(numOut), y(numOut);
+    int k, j;
+    for (k = 0; k < len; ++k)
+        mixed[k] = cplx(x[k].i, x[k].q) * std::polar(1.0, -2.0 * M_PI * conf.relative_freq * k);
+    for (k = 0; k < numOut; ++k)
+    {
+        const int t = k * conf.decimation;
+        if (!conf.decim_taps)
+            dec[k] = mixed[t];
+        for (j = 0; conf.decim_taps && j < conf.num_decim_taps && j <= t; ++j)
+            dec[k] += (double)conf.decim_taps[j] * mixed[t - j];
+    }
+    for (k = 0; k < numOut; ++k)
+    {
+        if (!conf.chan_taps)
+            y[k] = dec[k];
+        for (j = 0; conf.chan_taps && j < conf.num_chan_taps && j <= k; ++j)
+            y[k] += (double)conf.chan_taps[j] * dec[k - j];
+    }
+    return y;
+}
+
+
+static int test_ddc(int tileLen)
+{
+    const int numChannels = 4;
+    const int len = 20000;
+    std::vector<float> h1 = random_taps(31), h2 = random_taps(64), h3 = random_taps(17), f2 = random_taps(100), f3 = random_taps(300);
+    ddc_channel_t conf[numChannels] = {
+        {  0.15f,   4, h1.data(), int(h1.size()), nullptr, 0 },
+        { -0.3f,   10, h2.data(), int(h2.size()), f2.data(), int(f2.size()) },
+        {  0.01f,   3, h3.data(), int(h3.size()), f3.data(), int(f3.size()) },
+        {  0.0f,    1, nullptr, 0, nullptr, 0 }
+    };
+    std::vector<complexf> x(len);
+    std::vector< std::vector<complexf> > y(numChannels);
+    std::vector<complexf> chunkOut[numChannels];
+    int outLens[numChannels], total[numChannels];
+    int k, c, off, n, ret = 0;
+
+    srand(tileLen);
+    for (k = 0; k < len; ++k)
+    {
+        x[k].i = (float)rand() / RAND_MAX - 0.5f;
+        x[k].q = (float)rand() / RAND_MAX - 0.5f;
+    }
+
+    ddc_setup * s = ddc_new_setup(conf, numChannels, tileLen);
+    if (!s)
+    {
+        printf("tileLen %d: setup failed!\n", tileLen);
+        return 1;
+    }
+
+    /* chunks of different sizes - independent of the tiles */
+    for (c = 0; c < numChannels; ++c)
+        total[c] = 0;
+    for (off = 0, k = 0; off < len; off += n, ++k)
+    {
+        const int chunk = std::min(8 * (1 + (k * 37) % 400), len - off);
+        complexf * outputs[numChannels];
+        for (c = 0; c < numChannels; ++c)
+        {
+            chunkOut[c].resize(ddc_max_output_len(s, c, chunk));
+            outputs[c] = chunkOut[c].data();
+        }
+        n = ddc_process(s, x.data() + off, chunk, outputs, outLens);
+        if (n != chunk - chunk % 8 || n <= 0)
+        {
+            ret = 1;
+            break;
+        }
+        for (c = 0; c < numChannels; ++c)
+        {
+            if (outLens[c] > int(chunkOut[c].size()))
+                ret = 1;
+            y[c].insert(y[c].end(), chunkOut[c].begin(), chunkOut[c].begin() + outLens[c]);
+            total[c] += outLens[c];
+        }
+    }
+
+    /* the float oscillator of the mixer dominates the error: its phase drifts slowly */
+    for (c = 0; c < numChannels && !ret; ++c)
+    {
+        const std::vector<cplx> ref = reference(x, off, conf[c], total[c]);
+        double errSum = 0.0, refSum = 0.0, relErr;
+        const int minOut = off / conf[c].decimation - (conf[c].chan_taps ? 1024 : 1);
+        for (k = 0; k < total[c]; ++k)
+        {
+            errSum += std::norm(cplx(y[c][k].i, y[c][k].q) - ref[k]);
+            refSum += std::norm(ref[k]);
+        }
+        relErr = sqrt(errSum / (refSum > 0.0 ? refSum : 1.0));
+        const int failed = (relErr > 5E-3 || total[c] < minOut) ? 1 : 0;
+        printf("tileLen %4d, channel %d: freq %6.3f, decimation %2d, %5d outputs, relative error %g: %s\n",
+               ddc_tile_len(s), c, conf[c].relative_freq, conf[c].decimation, total[c], relErr, failed ? "FAILED" : "OK");
+        ret |= failed;
+    }
+
+    /* after reset, the output has to start from scratch */
+    if (!ret)
+    {
+        complexf * outputs[numChannels];
+        for (c = 0; c < numChannels; ++c)
+        {
+            chunkOut[c].resize(ddc_max_output_len(s, c, 4096));
+            outputs[c] = chunkOut[c].data();
+        }
+        ddc_reset(s);
+        ddc_process(s, x.data(), 4096, outputs, outLens);
+        for (c = 0; c < numChannels; ++c)
+            if (outLens[c] > total[c] || memcmp(chunkOut[c].data(), y[c].data(), outLens[c] * sizeof(complexf)))
+            {
+                printf("tileLen %d, channel %d: output after reset differs: FAILED\n", tileLen, c);
+                ret = 1;
+            }
+    }
+
+    ddc_destroy_setup(s);
+    return ret;
+}
+
+
+int main(int argc, char **argv)
+{
+    int ret = 0;
+    (void)argc;
+    (void)argv;
+
+    ret |= test_ddc(0);
+    ret |= test_ddc(256);
+    ret |= test_ddc(1000);
+
+    printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+    return ret;
+}
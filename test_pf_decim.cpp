@@ -0,0 +1,165 @@
+/*
+  test of the multi-stage decimator pf_decim: the planned chain has to meet
+  the spec for tones in the passband, in the stopband - and for tones
+  aliasing into the passband. chunked processing has to deliver the same
+  output as one call.
+ */
+
+#include "pf_decim.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+
+typedef std::complex<double> cplx;
+
+/* output amplitude in dB, for a tone at input frequency f with amplitude 0.5 */
+static double tone_gain_db(const decim_spec_t & spec, const decim_plan_t & plan, double f, bool chunked,
+                           std::vector<complexf> * out = nullptr)
+{
+    const int D = plan.decimation;
+    /* group delay and the block latency of the CFIR */
+    const int settle = 2 * plan.final_taps + 2048;
+    const int W = 2048;
+    const int len = (2 * settle + W) * D;
+    const double fo = spec.output_rate;
+    const double fOut = f - floor(f / fo + 0.5) * fo;
+    std::vector<int16_t> x(2 * len);
+    std::vector<complexf> y;
+    int k, off, n;
+
+    for (k = 0; k < len; ++k)
+    {
+        const double phi = 2.0 * M_PI * fmod(f / spec.input_rate * k, 1.0);
+        x[2 * k]     = (int16_t)floor(16384.0 * cos(phi) + 0.5);
+        x[2 * k + 1] = (int16_t)floor(16384.0 * sin(phi) + 0.5);
+    }
+
+    decim_setup * s = decim_new_setup(&spec, &plan);
+    if (!s)
+        return 1000.0;
+    if (chunked)
+    {
+        for (off = 0, n = 0, k = 0; off < len; off += n, ++k)
+        {
+            n = std::min(1 + (k * 7919) % 40000, len - off);
+            std::vector<complexf> chunkOut(decim_max_output_len(s, n));
+            const int m = decim_cs16(s, &x[2 * off], n, chunkOut.data());
+            if (m > int(chunkOut.size()))
+                return 1000.0;
+            y.insert(y.end(), chunkOut.begin(), chunkOut.begin() + m);
+        }
+    }
+    else
+    {
+        y.resize(decim_max_output_len(s, len));
+        y.resize(decim_cs16(s, x.data(), len, y.data()));
+    }
+    decim_destroy_setup(s);
+
+    if (out)
+        *out = y;
+    if (int(y.size()) < settle + W)
+        return 1000.0;
+
+    cplx acc(0.0, 0.0);
+    for (k = settle; k < settle + W; ++k)
+        acc += cplx(y[k].i, y[k].q) * std::polar(1.0, -2.0 * M_PI * fOut / fo * k);
+    return 20.0 * log10(std::abs(acc) / W / 0.5 + 1E-20);
+}
+
+
+static int test_spec(const char * name, const decim_spec_t & spec)
+{
+    decim_plan_t plan;
+    int j, ret = 0;
+    double g;
+
+    if (decim_plan(&spec, &plan))
+    {
+        printf("%s: no plan: FAILED\n", name);
+        return 1;
+    }
+    printf("%s: decimation %d = CIC %d (order %d) * %d halfbands (", name, plan.decimation,
+           plan.cic_decimation, plan.cic_order, plan.num_halfbands);
+    for (j = 0; j < plan.num_halfbands; ++j)
+        printf("%s%d", j ? ", " : "", plan.halfband_taps[j]);
+    printf(" taps) * CFIR %d (%d taps): %.1f ops per output\n",
+           plan.final_decimation, plan.final_taps, plan.ops_per_output);
+
+    const double fp = spec.passband, fo = spec.output_rate, As = spec.stopband_atten_db;
+    const double pass[] = { 0.0, 0.3 * fp, -0.7 * fp, fp };
+    for (double f : pass)
+    {
+        g = tone_gain_db(spec, plan, f, false);
+        const bool ok = fabs(g) <= spec.passband_ripple_db;
+        printf("  passband %10.1f Hz: %8.3f dB: %s\n", f, g, ok ? "OK" : "FAILED");
+        ret |= ok ? 0 : 1;
+    }
+
+    std::vector<double> stop;
+    if (spec.stopband < 0.5 * fo)
+        stop.push_back(0.5 * (spec.stopband + 0.5 * fo));
+    stop.push_back(fo - 0.9 * fp);                                    // aliases of the last stage
+    stop.push_back(fo + 0.5 * fp);
+    stop.push_back(-2.0 * fo - 0.2 * fp);
+    stop.push_back(fo * plan.final_decimation + 0.6 * fp);            // ... of the halfbands
+    stop.push_back(spec.input_rate / plan.cic_decimation - 0.9 * fp); // ... of the CIC
+    stop.push_back(0.5 * spec.input_rate - fo + 0.4 * fp);
+    for (double f : stop)
+    {
+        if (fabs(f) > 0.5 * spec.input_rate || fabs(f) < spec.stopband)
+            continue;
+        g = tone_gain_db(spec, plan, f, false);
+        const bool ok = g <= -As + 1.0;
+        printf("  stopband %10.1f Hz: %8.3f dB: %s\n", f, g, ok ? "OK" : "FAILED");
+        ret |= ok ? 0 : 1;
+    }
+
+    /* any chunks deliver the same output */
+    std::vector<complexf> y1, y2;
+    tone_gain_db(spec, plan, 0.3 * fp, false, &y1);
+    tone_gain_db(spec, plan, 0.3 * fp, true, &y2);
+    if (y1.size() > y2.size() || memcmp(y1.data(), y2.data(), y1.size() * sizeof(complexf)))
+    {
+        printf("  chunked processing differs: FAILED\n");
+        ret = 1;
+    }
+    return ret;
+}
+
+
+int main(int argc, char **argv)
+{
+    int ret = 0;
+    decim_plan_t plan;
+    (void)argc;
+    (void)argv;
+
+    /* input_rate, output_rate, passband, stopband, ripple, attenuation, CIC order */
+    const decim_spec_t rtl = { 2.048E6, 16E3, 5E3, 8E3, 0.1, 80.0, 0 };
+    const decim_spec_t d100 = { 10E6, 100E3, 30E3, 50E3, 0.2, 70.0, 5 };
+    const decim_spec_t audio = { 96E3, 48E3, 18E3, 24E3, 0.1, 60.0, 0 };
+    const decim_spec_t narrow = { 1.2E6, 12E3, 2E3, 3E3, 0.1, 90.0, 3 };
+    ret |= test_spec("rtl-sdr 2.048 MHz -> 16 kHz", rtl);
+    ret |= test_spec("10 MHz -> 100 kHz", d100);
+    ret |= test_spec("96 kHz -> 48 kHz", audio);
+    ret |= test_spec("1.2 MHz -> 12 kHz, narrow", narrow);
+
+    const decim_spec_t bad1 = { 2.048E6, 15E3, 5E3, 8E3, 0.1, 80.0, 0 };
+    const decim_spec_t bad2 = { 2.048E6, 16E3, 8E3, 5E3, 0.1, 80.0, 0 };
+    if (!decim_plan(&bad1, &plan) || !decim_plan(&bad2, &plan) || decim_new_setup(&bad1, nullptr))
+    {
+        printf("parameter checks: FAILED\n");
+        ret = 1;
+    }
+
+    printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+    return ret;
+}
@@ -0,0 +1,302 @@
+/*
+  test of the parallel executor pf_executor: a job list of transforms and
+  fast convolutions of mixed sizes, sharing their setups, has to deliver
+  bitwise the results of the sequential execution - with a single worker,
+  with several, pinned or not, and with different grains.
+  one convolution is checked against the direct linear convolution.
+ */
+
+#include "pf_executor.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+
+struct setup_t
+{
+    PFFFT_Setup * s;
+    int N;
+    int cplx;
+    float * filter;     // unordered spectrum of a short filter
+    int filterLen;      // in floats
+};
+
+struct buffers_t
+{
+    std::vector<float *> in, out, ref;
+    ~buffers_t()
+    {
+        for (size_t k = 0; k < in.size(); ++k)
+        {
+            pffft_aligned_free(in[k]);
+            pffft_aligned_free(out[k]);
+            pffft_aligned_free(ref[k]);
+        }
+    }
+};
+
+
+static float * aligned_floats(int n)
+{
+    return (float*)pffft_aligned_malloc((size_t)n * sizeof(float));
+}
+
+
+static int make_setups(std::vector<setup_t> & setups)
+{
+    static const int sizes[][2] = { {32, 0}, {64, 1}, {96, 0}, {256, 1}, {480, 0}, {1024, 0}, {2048, 1}, {4096, 0} };
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); ++k)
+    {
+        setup_t t;
+        const pffft_transform_t type = sizes[k][1] ? PFFFT_COMPLEX : PFFFT_REAL;
+        if (!pffft_is_valid_size(sizes[k][0], type))
+            continue;
+        t.N = sizes[k][0];
+        t.cplx = sizes[k][1];
+        t.s = pffft_new_setup(t.N, type);
+        if (!t.s)
+            return 1;
+        const int n = (t.cplx ? 2 : 1) * t.N;
+        float * h = aligned_floats(n);
+        float * work = aligned_floats(n);
+        t.filter = aligned_floats(n);
+        t.filterLen = (t.cplx ? 2 : 1) * (t.N / 8);
+        for (int i = 0; i < n; ++i)
+            h[i] = (i < t.filterLen) ? (float)rand() / RAND_MAX - 0.5F : 0.0F;
+        pffft_transform(t.s, h, t.filter, work, PFFFT_FORWARD);
+        pffft_aligned_free(h);
+        pffft_aligned_free(work);
+        setups.push_back(t);
+    }
+    return setups.empty() ? 1 : 0;
+}
+
+
+/* the input of a convolution is at most N - filterLen + 1 samples: the linear convolution */
+static void make_jobs(const std::vector<setup_t> & setups, int numJobs,
+                      std::vector<pf_exec_job_t> & jobs, buffers_t & buf)
+{
+    srand(4711);
+    for (int k = 0; k < numJobs; ++k)
+    {
+        const setup_t & t = setups[rand() % setups.size()];
+        const int n = (t.cplx ? 2 : 1) * t.N;
+        pf_exec_job_t j;
+        memset(&j, 0, sizeof(j));
+        j.type = (pf_exec_job_type_t)(k % 3);
+        j.setup = t.s;
+        j.direction = (k % 2) ? PFFFT_BACKWARD : PFFFT_FORWARD;
+        j.filter = t.filter;
+        j.inputLen = n - t.filterLen + (t.cplx ? 2 : 1) - (rand() % 4) * (t.cplx ? 2 : 1);
+        j.scaling = 1.0F / t.N;
+        buf.in.push_back(aligned_floats(n));
+        buf.out.push_back(aligned_floats(n));
+        buf.ref.push_back(aligned_floats(n));
+        for (int i = 0; i < n; ++i)
+            buf.in.back()[i] = (float)rand() / RAND_MAX - 0.5F;
+        j.input = buf.in.back();
+        j.output = buf.out.back();
+        jobs.push_back(j);
+    }
+}
+
+
+static void reference(const std::vector<pf_exec_job_t> & jobs, buffers_t & buf)
+{
+    int maxN = 0;
+    for (size_t k = 0; k < jobs.size(); ++k)
+        maxN = std::max(maxN, pffft_work_size(jobs[k].setup));
+    float * padded = aligned_floats(maxN);
+    float * work = aligned_floats(maxN);
+    for (size_t k = 0; k < jobs.size(); ++k)
+    {
+        const pf_exec_job_t & j = jobs[k];
+        const int n = pffft_work_size(j.setup);
+        switch (j.type)
+        {
+        case PF_EXEC_TRANSFORM:
+            pffft_transform(j.setup, j.input, buf.ref[k], work, j.direction);
+            break;
+        case PF_EXEC_TRANSFORM_ORDERED:
+            pffft_transform_ordered(j.setup, j.input, buf.ref[k], work, j.direction);
+            break;
+        case PF_EXEC_CONVOLVE:
+            memcpy(padded, j.input, (size_t)j.inputLen * sizeof(float));
+            memset(padded + j.inputLen, 0, (size_t)(n - j.inputLen) * sizeof(float));
+            pffft_transform(j.setup, padded, padded, work, PFFFT_FORWARD);
+            pffft_zconvolve_transform_backward(j.setup, padded, j.filter, buf.ref[k], work, j.scaling);
+            break;
+        }
+    }
+    pffft_aligned_free(padded);
+    pffft_aligned_free(work);
+}
+
+
+/* the executor's convolution of a real job against the direct one */
+static int check_linear(const std::vector<setup_t> & setups, const std::vector<pf_exec_job_t> & jobs, const buffers_t & buf)
+{
+    for (size_t k = 0; k < jobs.size(); ++k)
+    {
+        const pf_exec_job_t & j = jobs[k];
+        const setup_t * t = nullptr;
+        for (size_t s = 0; s < setups.size(); ++s)
+            if (setups[s].s == j.setup)
+                t = &setups[s];
+        if (j.type != PF_EXEC_CONVOLVE || t->cplx)
+            continue;
+        // recover the filter from its spectrum
+        std::vector<float> h(t->N);
+        float * spec = aligned_floats(t->N);
+        float * tmp = aligned_floats(t->N);
+        memcpy(spec, t->filter, t->N * sizeof(float));
+        pffft_transform(t->s, spec, tmp, nullptr, PFFFT_BACKWARD);
+        for (int i = 0; i < t->N; ++i)
+            h[i] = tmp[i] / t->N;
+        double errMax = 0.0;
+        for (int i = 0; i < t->N; ++i)
+        {
+            double y = 0.0;
+            for (int m = 0; m < t->filterLen && m <= i; ++m)
+                if (i - m < j.inputLen)
+                    y += (double)h[m] * j.input[i - m];
+            errMax = std::max(errMax, fabs(y - buf.out[k][i]));
+        }
+        pffft_aligned_free(spec);
+        pffft_aligned_free(tmp);
+        printf("linear convolution N=%d: max error %g: %s\n", t->N, errMax, (errMax > 1E-4) ? "FAILED" : "OK");
+        return (errMax > 1E-4) ? 1 : 0;
+    }
+    return 1;
+}
+
+
+static int test_run(const char * name, int numThreads, int pin, int grain,
+                    const std::vector<pf_exec_job_t> & jobs, buffers_t & buf)
+{
+    std::vector<int> cpus(std::max(1, numThreads));
+    const int hw = (int)std::max(1u, std::thread::hardware_concurrency());
+    long long total = 0, steals = 0;
+    int k, ret = 0, numPinned = 0;
+
+    for (k = 0; k < (int)cpus.size(); ++k)
+        cpus[k] = k % hw;
+    pf_executor * e = pf_executor_new(numThreads, pin ? cpus.data() : nullptr);
+    if (!e)
+    {
+        printf("%s: pf_executor_new() failed!\n", name);
+        return 1;
+    }
+    // twice: the second run reuses the scratch
+    for (int run = 0; run < 2 && !ret; ++run)
+    {
+        for (size_t j = 0; j < jobs.size(); ++j)
+            memset(buf.out[j], 0, (size_t)pffft_work_size(jobs[j].setup) * sizeof(float));
+        if (pf_executor_run(e, jobs.data(), (int)jobs.size(), grain))
+        {
+            printf("%s: pf_executor_run() failed!\n", name);
+            ret = 1;
+        }
+        for (size_t j = 0; j < jobs.size() && !ret; ++j)
+            if (memcmp(buf.out[j], buf.ref[j], (size_t)pffft_work_size(jobs[j].setup) * sizeof(float)))
+            {
+                printf("%s: job %d differs from the sequential result!\n", name, (int)j);
+                ret = 1;
+            }
+    }
+    for (k = 0; k < pf_executor_num_threads(e); ++k)
+    {
+        pf_exec_stats_t st;
+        pf_executor_worker_stats(e, k, &st);
+        total += st.jobs;
+        steals += st.steals;
+        numPinned += st.pinned;
+    }
+    if (total != (long long)jobs.size())
+    {
+        printf("%s: %lld jobs counted - expected %d!\n", name, total, (int)jobs.size());
+        ret = 1;
+    }
+    printf("%-26s %2d workers, %d pinned, %lld steals: %s\n", name,
+           pf_executor_num_threads(e), numPinned, steals, ret ? "FAILED" : "OK");
+    pf_executor_destroy(e);
+    return ret;
+}
+
+
+static int test_invalid()
+{
+    pf_executor * e = pf_executor_new(2, nullptr);
+    PFFFT_Setup * s = pffft_new_setup(64, PFFFT_REAL);
+    PFFFT_Setup * sb = pffft_new_setup(97, PFFFT_COMPLEX);    // Bluestein
+    float * x = aligned_floats(pffft_work_size(sb));
+    pf_exec_job_t j;
+    int ret = 0;
+
+    memset(&j, 0, sizeof(j));
+    j.type = PF_EXEC_CONVOLVE;
+    j.setup = s;
+    j.input = x;
+    j.output = x;
+    j.filter = nullptr;     // missing
+    if (pf_executor_run(e, &j, 1, 1) != -1)
+        ret = 1;
+    j.filter = x;
+    j.inputLen = 65;        // too long
+    if (pf_executor_run(e, &j, 1, 1) != -1)
+        ret = 1;
+    j.setup = sb;           // not for Bluestein's sizes
+    j.inputLen = 2 * 97;
+    if (pf_executor_run(e, &j, 1, 1) != -1)
+        ret = 1;
+    if (pf_executor_run(e, nullptr, 0, 1) != 0)
+        ret = 1;
+    printf("invalid jobs: %s\n", ret ? "FAILED" : "OK");
+    pffft_aligned_free(x);
+    pffft_destroy_setup(s);
+    pffft_destroy_setup(sb);
+    pf_executor_destroy(e);
+    return ret;
+}
+
+
+int main(int argc, char **argv)
+{
+    std::vector<setup_t> setups;
+    std::vector<pf_exec_job_t> jobs;
+    buffers_t buf;
+    int ret = 0;
+    (void)argc;
+    (void)argv;
+
+    srand(1);
+    if (make_setups(setups))
+    {
+        printf("setups failed!\n");
+        return 1;
+    }
+    make_jobs(setups, 3000, jobs, buf);
+    reference(jobs, buf);
+
+    ret |= test_run("1 worker",                  1, 0, 1, jobs, buf);
+    ret |= test_run("4 workers",                 4, 0, 1, jobs, buf);
+    ret |= test_run("4 workers, grain 16",       4, 0, 16, jobs, buf);
+    ret |= test_run("7 workers, pinned",         7, 1, 3, jobs, buf);
+    ret |= test_run("hardware threads",          0, 0, 8, jobs, buf);
+    ret |= check_linear(setups, jobs, buf);
+    ret |= test_invalid();
+
+    for (size_t k = 0; k < setups.size(); ++k)
+    {
+        pffft_aligned_free(setups[k].filter);
+        pffft_destroy_setup(setups[k].s);
+    }
+    printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+    return ret;
+}
@@ -0,0 +1,188 @@
+/*
+  test of the mixers in pf_mixer.h: each available in-place algorithm,
+  with shift_mixer_t, is compared against the mixing in double precision -
+  and the automatic selection has to respect the requested phase error
+ */
+
+#include "pf_mixer.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+
+/* maximum deviation from input[n] * exp(j*(2*pi*f*n + phase0)) */
+static double mix_error(const std::vector<complexf> & x, const std::vector<complexf> & y, int len, float f, float phase0)
+{
+    double maxErr = 0.0;
+    for (int k = 0; k < len; ++k)
+    {
+        const double phi = 2.0 * M_PI * fmod((double)f * k, 1.0) + phase0;
+        const double re = x[k].i * cos(phi) - x[k].q * sin(phi);
+        const double im = x[k].i * sin(phi) + x[k].q * cos(phi);
+        const double err = sqrt((y[k].i - re) * (y[k].i - re) + (y[k].q - im) * (y[k].q - im));
+        if (err > maxErr)
+            maxErr = err;
+    }
+    return maxErr;
+}
+
+
+static int test_algo(int algo, float f, int blockLen)
+{
+    const int numBlocks = 16;
+    const int len = numBlocks * blockLen;
+    const float phase0 = 0.25F;
+    std::vector<complexf> x(len), y;
+    shift_mixer_t m;
+    int k, ret = 0;
+
+    if (!shift_mixer_available(algo, blockLen))
+        return 0;
+
+    srand(algo + blockLen);
+    for (k = 0; k < len; ++k)
+    {
+        const float a = (float)rand() / RAND_MAX * 6.2831853F;
+        x[k].i = cosf(a);
+        x[k].q = sinf(a);
+    }
+    y = x;
+
+    if (shift_mixer_init(&m, f, phase0, blockLen, 0.0F, algo) != algo)
+    {
+        printf("%-22s: init failed!\n", shift_mixer_name(algo));
+        return 1;
+    }
+    for (k = 0; k < numBlocks; ++k)
+        shift_mixer_inp_c(&m, &y[k * blockLen], blockLen);
+
+    const double maxErr = 0.01;
+    const double err = mix_error(x, y, len, f, phase0);
+    if (err > maxErr)
+        ret = 1;
+    printf("%-22s: freq %7.4f, blockLen %5d: max error %g: %s\n",
+           shift_mixer_name(algo), f, blockLen, err, ret ? "FAILED" : "OK");
+    return ret;
+}
+
+
+static int test_auto(float f, int blockLen, float maxPhaseError)
+{
+    const int len = 4 * blockLen;
+    std::vector<complexf> x(len), y(len);
+    shift_mixer_t m;
+    int k, algo, ret = 0;
+
+    algo = shift_mixer_init(&m, f, 0.0F, blockLen, maxPhaseError, PF_MIXER_AUTO);
+    if (algo < 0)
+    {
+        printf("auto: freq %7.4f, blockLen %5d, max phase error %g: no algorithm selected\n", f, blockLen, maxPhaseError);
+        return 0;
+    }
+
+    for (k = 0; k < len; ++k)
+    {
+        x[k].i = 1.0F;
+        x[k].q = 0.0F;
+    }
+    y = x;
+    for (k = 0; k < len; k += blockLen)
+        shift_mixer_inp_c(&m, &y[k], blockLen);
+    const double err = mix_error(x, y, len, f, 0.0F);
+
+    if (m.phase_error > maxPhaseError || (blockLen % m.simd_size) != 0 || err > maxPhaseError)
+        ret = 1;
+    printf("auto: freq %7.4f, blockLen %5d, max phase error %g: selected %s (%.1f MS/s, phase error %g), error %g: %s\n",
+           f, blockLen, maxPhaseError, shift_mixer_name(algo), m.samples_per_sec * 1E-6, m.phase_error,
+           err, ret ? "FAILED" : "OK");
+    return ret;
+}
+
+
+/* the integer NCO: blocks of odd sizes - for the scalar tails - with a new
+ * frequency per block, over many samples. the reference is the exact integer
+ * phase in double precision. the int16 input has to match the float input.
+ */
+static int test_nco(int numBlocks)
+{
+    const double freqs[] = { 0.1234567, -0.31, 1E-7, 0.5, -0.0009 };
+    const int numFreqs = (int)(sizeof(freqs) / sizeof(freqs[0]));
+    std::vector<complexf> x, y, z;
+    std::vector<int16_t> xs;
+    shift_nco_t d = shift_nco_init(freqs[0], 1.0);
+    shift_nco_t ds = d;
+    uint64_t phase = d.phase;
+    double maxErr = 0.0, maxErr16 = 0.0;
+    int b, k, total = 0, ret = 0;
+
+    srand(123);
+    for (b = 0; b < numBlocks; ++b)
+    {
+        const int len = 1 + (b * 7919) % 1000;
+        const double f = freqs[b % numFreqs];
+        x.resize(len);
+        y.resize(len);
+        z.resize(len);
+        xs.resize(2 * len);
+        for (k = 0; k < len; ++k)
+        {
+            xs[2 * k] = (int16_t)(rand() % 65536 - 32768);
+            xs[2 * k + 1] = (int16_t)(rand() % 65536 - 32768);
+            x[k].i = xs[2 * k] / 32768.0F;
+            x[k].q = xs[2 * k + 1] / 32768.0F;
+        }
+        shift_nco_update_freq(&d, f);
+        shift_nco_update_freq(&ds, f);
+        shift_nco_cc(x.data(), y.data(), len, &d);
+        shift_nco_cs16_c(xs.data(), z.data(), len, 1.0F / 32768.0F, &ds);
+        for (k = 0; k < len; ++k)
+        {
+            const double phi = 2.0 * M_PI * ldexp((double)phase, -64);
+            const double re = x[k].i * cos(phi) - x[k].q * sin(phi);
+            const double im = x[k].i * sin(phi) + x[k].q * cos(phi);
+            maxErr = std::max(maxErr, std::max(fabs(y[k].i - re), fabs(y[k].q - im)));
+            maxErr16 = std::max(maxErr16, std::max(fabs((double)z[k].i - y[k].i), fabs((double)z[k].q - y[k].q)));
+            phase += shift_nco_phase_inc(f);
+        }
+        total += len;
+    }
+    // the phase is exact: the same as the reference - and the same for both inputs
+    if (d.phase != phase || ds.phase != phase || maxErr > 1E-5 || maxErr16 > 1E-6)
+        ret = 1;
+    printf("nco: %d samples in %d blocks, max error %g, int16 deviation %g, phase %s: %s\n",
+           total, numBlocks, maxErr, maxErr16, (d.phase == phase) ? "exact" : "drifted", ret ? "FAILED" : "OK");
+    return ret;
+}
+
+
+int main(int argc, char **argv)
+{
+    int ret = 0, algo;
+    (void)argc;
+    (void)argv;
+
+    for (algo = 0; algo < PF_MIXER_NUM_ALGOS; ++algo)
+    {
+        ret |= test_algo(algo, -0.0123F, 1024);
+        ret |= test_algo(algo, 0.2345F, 200);
+    }
+
+    if (shift_mixer_available(PF_MIXER_LIMITED_UNROLL_AVX, 4) || shift_mixer_init(NULL, 0.0F, 0.0F, 4, 0.0F, 99) != -1)
+    {
+        printf("availability checks: FAILED\n");
+        ret = 1;
+    }
+
+    ret |= test_nco(4000);
+
+    ret |= test_auto(-0.0123F, 8192, 1E-3F);
+    ret |= test_auto(0.3F, 1000, 1E-2F);
+    ret |= test_auto(0.1F, 64, 1.0F);
+
+    printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+    return ret;
+}
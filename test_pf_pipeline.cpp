@@ -0,0 +1,343 @@
+/*
+  test of pf_pipeline: the lock-free ring with one producer and one consumer
+  thread - and a chain CIC -> mixer -> pffastconv -> pffft, which has to
+  produce exactly the output of the same stages, called one after the other
+  in a single thread. a stage error has to stop the whole pipeline.
+ */
+
+#include "pf_pipeline.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#ifndef PF_PIPELINE_NO_THREADS
+#include <thread>
+#endif
+
+
+static int test_ring(int numBlocks, int numMsgs)
+{
+    const int blockBytes = 64 * (int)sizeof(int);
+    pf_ring * r = pf_ring_new(numBlocks, blockBytes);
+    int errors = 0, received = 0;
+
+    if (!r)
+    {
+        printf("ring: setup failed!\n");
+        return 1;
+    }
+
+    /* block k has 1 + k % 64 ints with the values k, k+1, .. */
+    auto produce = [&](int k) -> bool {
+        int * b = (int*)pf_ring_write_acquire(r);
+        if (!b)
+            return false;
+        const int n = 1 + k % 64;
+        for (int j = 0; j < n; ++j)
+            b[j] = k + j;
+        pf_ring_write_commit(r, n * (int)sizeof(int));
+        return true;
+    };
+    auto consume = [&]() -> bool {
+        int used = 0;
+        const int * b = (const int *)pf_ring_read_acquire(r, &used);
+        if (!b)
+            return false;
+        const int n = 1 + received % 64;
+        if (used != n * (int)sizeof(int))
+            ++errors;
+        else
+            for (int j = 0; j < n; ++j)
+                errors += (b[j] != received + j) ? 1 : 0;
+        pf_ring_read_release(r);
+        ++received;
+        return true;
+    };
+
+#ifndef PF_PIPELINE_NO_THREADS
+    std::thread producer([&]() {
+        for (int k = 0; k < numMsgs; )
+        {
+            if (produce(k))
+                ++k;
+            else
+                std::this_thread::yield();
+        }
+        pf_ring_close(r);
+    });
+    while (!pf_ring_drained(r))
+    {
+        if (!consume())
+            std::this_thread::yield();
+    }
+    producer.join();
+#else
+    for (int k = 0; k < numMsgs; )
+    {
+        while (k < numMsgs && produce(k))
+            ++k;
+        while (consume())
+            ;
+    }
+    pf_ring_close(r);
+    while (!pf_ring_drained(r))
+        consume();
+#endif
+
+    errors += (received != numMsgs) ? 1 : 0;
+    printf("ring with %d blocks: %d of %d blocks received, %d errors: %s\n",
+           pf_ring_num_blocks(r), received, numMsgs, errors, errors ? "FAILED" : "OK");
+    pf_ring_destroy(r);
+    return errors ? 1 : 0;
+}
+
+
+/*****************************************************************************/
+
+#define SRC_FRAMES      4096    /* I/Q int16 frames per source block */
+#define CIC_DECIM       4
+#define FILTER_LEN      65
+#define FFT_LEN         256
+
+struct source_t
+{
+    int block;
+    int numBlocks;
+    uint32_t seed;      /* for the noise: rand() isn't for threads */
+};
+
+static int noise(source_t * s)
+{
+    s->seed = s->seed * 1664525u + 1013904223u;
+    return (int)((s->seed >> 16) % 2001) - 1000;
+}
+
+static int source_fn(void * user, const void * in, int inBytes, void * out, int outCapacity)
+{
+    source_t * s = (source_t*)user;
+    int16_t * y = (int16_t*)out;
+    (void)in;
+    (void)inBytes;
+    (void)outCapacity;
+    if (s->block >= s->numBlocks)
+        return -1;
+    for (int k = 0; k < SRC_FRAMES; ++k)
+    {
+        const double t = (double)s->block * SRC_FRAMES + k;
+        y[2*k]   = (int16_t)(12000.0 * cos(0.011 * t) + noise(s));
+        y[2*k+1] = (int16_t)(12000.0 * sin(0.011 * t) + noise(s));
+    }
+    ++s->block;
+    return SRC_FRAMES * 2 * (int)sizeof(int16_t);
+}
+
+struct sink_t
+{
+    std::vector<float> data;
+    int abortAfter;     /* blocks: < 0 never */
+};
+
+static int sink_fn(void * user, const void * in, int inBytes, void * out, int outCapacity)
+{
+    sink_t * s = (sink_t*)user;
+    (void)out;
+    (void)outCapacity;
+    if (!in)
+        return 0;
+    if (s->abortAfter == 0)
+        return -1;
+    if (s->abortAfter > 0)
+        --s->abortAfter;
+    const float * x = (const float*)in;
+    s->data.insert(s->data.end(), x, x + inBytes / sizeof(float));
+    return 0;
+}
+
+
+struct chain_t
+{
+    source_t src;
+    pf_stage_cic_t cic;
+    shift_mixer_t mixer;
+    pf_stage_fastconv_t conv;
+    pf_stage_fft_t fft;
+    sink_t sink;
+    int convBlockLen;
+    int bytes[4];       /* output block sizes of source, cic, mixer and fastconv */
+    int ok;
+};
+
+static void chain_init(chain_t & c, int numBlocks, int abortAfter)
+{
+    std::vector<float> h(FILTER_LEN);
+    for (int k = 0; k < FILTER_LEN; ++k)
+        h[k] = (float)(0.54 - 0.46 * cos(2.0 * M_PI * k / (FILTER_LEN - 1))) / FILTER_LEN;
+
+    memset(&c.cic, 0, sizeof(c.cic));
+    memset(&c.conv, 0, sizeof(c.conv));
+    memset(&c.fft, 0, sizeof(c.fft));
+    c.src.block = 0;
+    c.src.numBlocks = numBlocks;
+    c.src.seed = 1234;
+    c.sink.abortAfter = abortAfter;
+    c.sink.data.clear();
+
+    c.cic.setup = cic_decim_new_setup(2, 4, CIC_DECIM, 1);
+    c.cic.numChannels = 2;
+    c.ok = (shift_mixer_init(&c.mixer, 0.0123F, 0.0F, SRC_FRAMES / CIC_DECIM, 1E-3F, PF_MIXER_RECURSIVE_OSC) >= 0);
+    c.convBlockLen = 512;
+    c.conv.setup = pffastconv_new_setup(h.data(), FILTER_LEN, &c.convBlockLen, PFFASTCONV_CPLX_INP_OUT);
+    c.conv.cplx = 1;
+    c.fft.setup = pffft_new_setup(FFT_LEN, PFFFT_COMPLEX);
+    c.fft.N = FFT_LEN;
+    c.fft.cplx = 1;
+    c.fft.direction = PFFFT_FORWARD;
+    c.fft.ordered = 1;
+    c.ok = c.ok && c.cic.setup && c.conv.setup && c.fft.setup;
+
+    const int cicFrames = c.cic.setup ? cic_decim_max_output_len(c.cic.setup, SRC_FRAMES) : 0;
+    c.bytes[0] = SRC_FRAMES * 2 * (int)sizeof(int16_t);
+    c.bytes[1] = cicFrames * (int)sizeof(complexf);
+    c.bytes[2] = c.bytes[1];
+    c.bytes[3] = (cicFrames + c.convBlockLen) * (int)sizeof(complexf);
+}
+
+/* complete transforms from the fastconv output and the rest of the last call */
+static int fft_bytes(const chain_t & c)
+{
+    const int maxIn = c.bytes[3] / (int)sizeof(complexf) + FFT_LEN - 1;
+    return (maxIn / FFT_LEN) * FFT_LEN * (int)sizeof(complexf);
+}
+
+static void chain_free(chain_t & c)
+{
+    cic_decim_destroy_setup(c.cic.setup);
+    pffastconv_destroy_setup(c.conv.setup);
+    pf_stage_fft_free(&c.fft);
+    pffft_destroy_setup(c.fft.setup);
+}
+
+
+/* the reference: all stages one after the other in this thread */
+static void run_sequential(chain_t & c)
+{
+    std::vector<char> b0(c.bytes[0]), b1(c.bytes[1]), b2(c.bytes[2]), b3(c.bytes[3]), b4(fft_bytes(c));
+    int n;
+    while ((n = source_fn(&c.src, nullptr, 0, b0.data(), c.bytes[0])) >= 0)
+    {
+        n = pf_stage_cic_s16(&c.cic, b0.data(), n, b1.data(), c.bytes[1]);
+        n = pf_stage_mixer(&c.mixer, b1.data(), n, b2.data(), c.bytes[2]);
+        n = pf_stage_fastconv(&c.conv, b2.data(), n, b3.data(), c.bytes[3]);
+        n = pf_stage_fft(&c.fft, b3.data(), n, b4.data(), (int)b4.size());
+        if (n > 0)
+            sink_fn(&c.sink, b4.data(), n, nullptr, 0);
+    }
+}
+
+
+/* stage k on core k - as far as there are cores */
+static int cpu(int pin, int stage)
+{
+#ifndef PF_PIPELINE_NO_THREADS
+    const int numCores = (int)std::thread::hardware_concurrency();
+#else
+    const int numCores = 1;
+#endif
+    return pin ? stage % (numCores > 0 ? numCores : 1) : -1;
+}
+
+static int test_chain(int numBlocks, int ringBlocks, int pin)
+{
+    chain_t ref, par;
+    pf_pipeline * p = pf_pipeline_new(ringBlocks);
+    int ret = 0, r;
+
+    chain_init(ref, numBlocks, -1);
+    run_sequential(ref);
+    chain_init(par, numBlocks, -1);
+    if (!p || !ref.ok || !par.ok)
+    {
+        printf("chain: setup failed!\n");
+        return 1;
+    }
+
+    r  = pf_pipeline_add_stage(p, source_fn,        &par.src,   par.bytes[0], cpu(pin, 0));
+    r |= pf_pipeline_add_stage(p, pf_stage_cic_s16,  &par.cic,   par.bytes[1], cpu(pin, 1));
+    r |= pf_pipeline_add_stage(p, pf_stage_mixer,    &par.mixer, par.bytes[2], cpu(pin, 2));
+    r |= pf_pipeline_add_stage(p, pf_stage_fastconv, &par.conv,  par.bytes[3], cpu(pin, 3));
+    r |= pf_pipeline_add_stage(p, pf_stage_fft,      &par.fft,   fft_bytes(par), cpu(pin, 4));
+    r |= pf_pipeline_add_stage(p, sink_fn,           &par.sink,  0, cpu(pin, 5));
+    if (r < 0 || pf_pipeline_run(p) != 0)
+    {
+        printf("chain: pipeline failed!\n");
+        ret = 1;
+    }
+    else if (par.sink.data.size() != ref.sink.data.size() || par.sink.data.empty()
+             || memcmp(par.sink.data.data(), ref.sink.data.data(), ref.sink.data.size() * sizeof(float)))
+    {
+        printf("chain: output differs from the sequential processing: %d vs %d values!\n",
+               (int)par.sink.data.size(), (int)ref.sink.data.size());
+        ret = 1;
+    }
+
+    printf("chain with %d blocks per ring%s: %d transforms: %s\n", ringBlocks,
+           pin ? ", pinned" : "", (int)(ref.sink.data.size() / (2 * FFT_LEN)), ret ? "FAILED" : "OK");
+    for (int k = 0; k < 6; ++k)
+    {
+        pf_stage_stats_t st;
+        pf_pipeline_stage_stats(p, k, &st);
+        printf("  stage %d: %6lld calls, waits for input %5lld, for output %5lld%s\n",
+               k, st.blocks, st.waits_in, st.waits_out, pin ? (st.pinned ? ", pinned" : ", not pinned") : "");
+    }
+
+    pf_pipeline_destroy(p);
+    chain_free(ref);
+    chain_free(par);
+    return ret;
+}
+
+
+/* an error of the sink has to stop all stages - the source would produce for ever */
+static int test_abort()
+{
+    chain_t c;
+    pf_pipeline * p = pf_pipeline_new(2);
+    int ret, r;
+
+    chain_init(c, 1 << 30, 5);
+    pf_pipeline_add_stage(p, source_fn,        &c.src,   c.bytes[0], -1);
+    pf_pipeline_add_stage(p, pf_stage_cic_s16,  &c.cic,   c.bytes[1], -1);
+    pf_pipeline_add_stage(p, pf_stage_mixer,    &c.mixer, c.bytes[2], -1);
+    pf_pipeline_add_stage(p, sink_fn,           &c.sink,  0, -1);
+    r = pf_pipeline_run(p);
+    ret = (r == -1 && c.sink.data.size() == 5 * 2 * SRC_FRAMES / CIC_DECIM) ? 0 : 1;
+    printf("abort by the sink: run() returned %d after %d values: %s\n", r, (int)c.sink.data.size(), ret ? "FAILED" : "OK");
+    pf_pipeline_destroy(p);
+    chain_free(c);
+    return ret;
+}
+
+
+int main(int argc, char **argv)
+{
+    int ret = 0;
+    (void)argc;
+    (void)argv;
+
+    ret |= test_ring(1, 5000);
+    ret |= test_ring(3, 100000);
+    ret |= test_ring(16, 100000);
+
+    ret |= test_chain(100, 2, 0);
+    ret |= test_chain(100, 8, 0);
+    ret |= test_chain(100, 4, 1);
+    ret |= test_abort();
+
+    printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+    return ret;
+}
@@ -0,0 +1,258 @@
+/*
+  test of the polyphase resampler pf_resample: compare rational and
+  arbitrary ratios - real and complex, with and without frequency shift -
+  against the definition with the prototype filter, computed in double
+  precision. the input is fed in chunks of different sizes.
+ */
+
+#include "pf_resample.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+
+typedef std::complex<double> cplx;
+
+/* the definition from pf_resample.h - for the arbitrary ratio with the
+ * same fixed point time and linear interpolation between the phases */
+static std::vector<cplx> reference(const resamp_spec_t & spec, const resamp_setup * s,
+                                   const std::vector<cplx> & x, int numOut)
+{
+    int len, L;
+    const float * h = resamp_prototype(s, &len, &L);
+    std::vector<cplx> y(numOut);
+    long long i = 0;
+    uint64_t frac = 0;
+    const uint64_t step = (spec.interpolation > 0) ? 0 : (uint64_t)llround(4294967296.0 / spec.ratio);
+
+    for (int n = 0; n < numOut; ++n)
+    {
+        int q0;
+        double a = 0.0;
+        if (spec.interpolation > 0)
+        {
+            // reduced ratio: L from the setup, M = decimation * L / interpolation
+            const long long Mr = (long long)spec.decimation * L / spec.interpolation;
+            const long long t = (long long)n * Mr;
+            i = t / L;
+            q0 = (int)(t % L);
+        }
+        else
+        {
+            q0 = (int)(frac >> 24);
+            a = (double)(frac & 0xFFFFFF) / 16777216.0;
+        }
+        cplx y0 = 0.0, y1 = 0.0;
+        for (long long j = 0; j <= i; ++j)
+        {
+            const long long k0 = q0 + j * L, k1 = q0 + 1 + j * L;
+            if (k0 < len)
+                y0 += (double)h[k0] * x[i - j];
+            if (k1 < len)
+                y1 += (double)h[k1] * x[i - j];
+        }
+        y[n] = (spec.interpolation > 0) ? y0 : (y0 + a * (y1 - y0));
+        if (spec.interpolation <= 0)
+        {
+            const uint64_t t = frac + step;
+            i += (long long)(t >> 32);
+            frac = t & 0xFFFFFFFFu;
+        }
+    }
+    return y;
+}
+
+
+static int test_resample(const char * name, const resamp_spec_t & spec, int cplxInput, int len)
+{
+    std::vector<cplx> x(len), xm(len), ref;
+    std::vector<complexf> xc(len), yc;
+    std::vector<float> xf(len), yf;
+    std::vector<complexf> outc;
+    std::vector<float> outf;
+    resamp_setup * s = resamp_new_setup(&spec);
+    int k, off, n, chunk, total = 0, ret = 0;
+    double errSum = 0.0, refSum = 0.0, relErr;
+
+    if (!s)
+    {
+        printf("%s: setup failed!\n", name);
+        return 1;
+    }
+
+    srand(len);
+    for (k = 0; k < len; ++k)
+    {
+        const double re = (double)rand() / RAND_MAX - 0.5;
+        const double im = cplxInput ? ((double)rand() / RAND_MAX - 0.5) : 0.0;
+        x[k] = cplx(re, im);
+        xc[k].i = (float)re;
+        xc[k].q = (float)im;
+        xf[k] = (float)re;
+        xm[k] = x[k];
+        if (cplxInput && spec.shift_freq != 0.0F)
+            xm[k] *= std::polar(1.0, 2.0 * M_PI * (double)spec.shift_freq * k);
+    }
+
+    /* chunks of different sizes - independent of the tiles. multiples of 8 for the mixer */
+    for (off = 0, k = 0; off < len; off += n, ++k)
+    {
+        int outLen = 0;
+        chunk = std::min(8 * (1 + (k * 37) % 500), len - off);
+        if (cplxInput)
+        {
+            outc.resize(resamp_max_output_len(s, chunk));
+            n = resamp_process_c(s, xc.data() + off, chunk, outc.data(), &outLen);
+            yc.insert(yc.end(), outc.begin(), outc.begin() + outLen);
+        }
+        else
+        {
+            outf.resize(resamp_max_output_len(s, chunk));
+            n = resamp_process_f(s, xf.data() + off, chunk, outf.data(), &outLen);
+            yf.insert(yf.end(), outf.begin(), outf.begin() + outLen);
+        }
+        if (n != chunk || outLen > resamp_max_output_len(s, chunk))
+        {
+            printf("%s: consumed %d of %d, %d outputs of max %d!\n", name, n, chunk, outLen, resamp_max_output_len(s, chunk));
+            ret = 1;
+            break;
+        }
+        total += outLen;
+    }
+
+    /* all outputs, whose time is within the input */
+    if (spec.interpolation > 0)
+    {
+        int L;
+        resamp_prototype(s, nullptr, &L);
+        const long long Mr = (long long)spec.decimation * L / spec.interpolation;
+        if (total != (int)(((long long)len * L + Mr - 1) / Mr))
+        {
+            printf("%s: %d outputs - expected %lld!\n", name, total, ((long long)len * L + Mr - 1) / Mr);
+            ret = 1;
+        }
+    }
+
+    ref = reference(spec, s, xm, total);
+    for (k = 0; k < total; ++k)
+    {
+        const cplx y = cplxInput ? cplx(yc[k].i, yc[k].q) : cplx(yf[k], 0.0);
+        errSum += std::norm(y - ref[k]);
+        refSum += std::norm(ref[k]);
+    }
+    relErr = sqrt(errSum / (refSum > 0.0 ? refSum : 1.0));
+    /* the float oscillator of the mixer dominates the error: its phase drifts slowly */
+    if (relErr > ((spec.shift_freq != 0.0F) ? 5E-3 : 1E-5))
+        ret = 1;
+
+    /* after reset, the output has to start from scratch */
+    if (!ret && total > 0)
+    {
+        int outLen = 0;
+        const int n0 = std::min(len, 4096);
+        resamp_reset(s);
+        if (cplxInput)
+        {
+            outc.resize(resamp_max_output_len(s, n0));
+            resamp_process_c(s, xc.data(), n0, outc.data(), &outLen);
+            if (outLen > total || memcmp(outc.data(), yc.data(), outLen * sizeof(complexf)))
+                ret = 1;
+        }
+        else
+        {
+            outf.resize(resamp_max_output_len(s, n0));
+            resamp_process_f(s, xf.data(), n0, outf.data(), &outLen);
+            if (outLen > total || memcmp(outf.data(), yf.data(), outLen * sizeof(float)))
+                ret = 1;
+        }
+        if (ret)
+            printf("%s: output after reset differs!\n", name);
+    }
+
+    {
+        int plen, L;
+        resamp_prototype(s, &plen, &L);
+        printf("%-28s %s: %d phases of %d taps, %6d outputs, relative error %g: %s\n", name,
+               cplxInput ? "complex" : "real   ", L, plen / L, total, relErr, ret ? "FAILED" : "OK");
+    }
+    resamp_destroy_setup(s);
+    return ret;
+}
+
+
+/* quality of the filter: a tone in the passband against the ideal delayed tone */
+static int test_tone(const char * name, const resamp_spec_t & spec, double freq, double minSnrDb)
+{
+    const int len = 40000;
+    const double ratio = (spec.interpolation > 0) ? (double)spec.interpolation / spec.decimation : spec.ratio;
+    std::vector<complexf> x(len), y;
+    resamp_setup * s = resamp_new_setup(&spec);
+    int k, outLen = 0, plen, L;
+    double errSum = 0.0, refSum = 0.0, delay, snr;
+
+    if (!s)
+    {
+        printf("%s: setup failed!\n", name);
+        return 1;
+    }
+    resamp_prototype(s, &plen, &L);
+    delay = 0.5 * (plen - 1) / L;     // in input samples
+    for (k = 0; k < len; ++k)
+    {
+        x[k].i = (float)cos(2.0 * M_PI * freq * k);
+        x[k].q = (float)sin(2.0 * M_PI * freq * k);
+    }
+    y.resize(resamp_max_output_len(s, len));
+    resamp_process_c(s, x.data(), len, y.data(), &outLen);
+
+    /* skip the transient of the filter */
+    for (k = 0; k < outLen; ++k)
+    {
+        const double t = k / ratio - delay;
+        if (t < 2.0 * delay + 10.0)
+            continue;
+        const cplx r = std::polar(1.0, 2.0 * M_PI * freq * t);
+        errSum += std::norm(cplx(y[k].i, y[k].q) - r);
+        refSum += 1.0;
+    }
+    snr = 10.0 * log10(refSum / (errSum > 0.0 ? errSum : 1E-30));
+    printf("%-28s tone %.3f: SNR %.1f dB: %s\n", name, freq, snr, (snr < minSnrDb) ? "FAILED" : "OK");
+    resamp_destroy_setup(s);
+    return (snr < minSnrDb) ? 1 : 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    int ret = 0, c;
+    (void)argc;
+    (void)argv;
+
+    for (c = 0; c < 2; ++c)
+    {
+        //                                     L    M   ratio    pb   atten  shift
+        ret |= test_resample("48k -> 44.1k, 147/160",   { 147, 160, 0.0,    0.0,  0.0,  0.0F }, c, 20000);
+        ret |= test_resample("25/24",                   { 25,  24,  0.0,    0.0,  0.0,  0.0F }, c, 20000);
+        ret |= test_resample("interpolation 5",         { 5,   1,   0.0,    0.0,  0.0,  0.0F }, c, 8000);
+        ret |= test_resample("decimation 7",            { 2,   14,  0.0,    0.0,  0.0,  0.0F }, c, 20000);
+        ret |= test_resample("decimation 100, short",   { 1,   100, 0.0,    0.01, 10.0, 0.0F }, c, 30000);
+        ret |= test_resample("arbitrary 0.91873",       { 0,   0,   0.91873, 0.0, 0.0,  0.0F }, c, 20000);
+        ret |= test_resample("arbitrary 3.3",           { 0,   0,   3.3,    0.0,  60.0, 0.0F }, c, 6000);
+    }
+    ret |= test_resample("25/24, shift 0.1",           { 25,  24,  0.0,    0.0,  0.0,  0.1F }, 1, 20000);
+    ret |= test_resample("arbitrary 0.6, shift -0.2",  { 0,   0,   0.6,    0.0,  0.0, -0.2F }, 1, 20000);
+
+    ret |= test_tone("147/160",          { 147, 160, 0.0,   0.0, 0.0, 0.0F }, 0.15, 70.0);
+    ret |= test_tone("arbitrary 1.0417", { 0,   0,   1.0417, 0.0, 0.0, 0.0F }, -0.3, 60.0);
+    ret |= test_tone("arbitrary 0.333",  { 0,   0,   0.333, 0.0, 0.0, 0.0F }, 0.05, 60.0);
+
+    printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+    return ret;
+}
@@ -0,0 +1,155 @@
+/*
+  test of the zero-latency convolution pf_zlconv: compare against
+  the direct convolution - block by block, without any delay
+ */
+
+#include "pf_zlconv.h"
+#include "pffft.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+
+static int test_zlconv(int filterLen, int blockLen, int maxPartLen, int flags)
+{
+    const int numBlocks = (3 * filterLen) / blockLen + 8;
+    const int len = numBlocks * blockLen;
+    std::vector<float> h(filterLen), x(len), y(len);
+    double errSum = 0.0, refSum = 0.0, relErr;
+    int k, j, off, n, numStages, ret = 0;
+
+    srand(filterLen + blockLen);
+    for (k = 0; k < filterLen; ++k)
+        h[k] = ((float)rand() / RAND_MAX - 0.5f) * expf(-3.0f * k / filterLen);
+    for (k = 0; k < len; ++k)
+        x[k] = (float)rand() / RAND_MAX - 0.5f;
+
+    zlconv_setup * s = zlconv_new_setup(h.data(), filterLen, blockLen, maxPartLen, flags);
+    if (!s)
+    {
+        printf("filterLen %d, blockLen %d: setup failed!\n", filterLen, blockLen);
+        return 1;
+    }
+
+    /* push 1, 2 or 3 blocks per call */
+    for (off = 0, k = 0; off < len; off += n, ++k)
+    {
+        const int chunk = blockLen * std::min(1 + k % 3, (len - off) / blockLen);
+        n = zlconv_process(s, x.data() + off, y.data() + off, chunk);
+        if (n != chunk)
+        {
+            ret = 1;
+            break;
+        }
+    }
+
+    for (k = 0; k < len && !ret; ++k)
+    {
+        double ref = 0.0;
+        for (j = 0; j < filterLen && j <= k; ++j)
+            ref += (double)h[j] * x[k - j];
+        errSum += (y[k] - ref) * (y[k] - ref);
+        refSum += ref * ref;
+    }
+    relErr = sqrt(errSum / (refSum > 0.0 ? refSum : 1.0));
+    if (relErr > 1E-5)
+        ret = 1;
+
+    numStages = zlconv_num_stages(s);
+    printf("filterLen %6d, blockLen %4d%s: stages", filterLen, blockLen,
+           (flags & ZLCONV_BACKGROUND) ? ", background" : "");
+    for (k = 0; k < numStages; ++k)
+    {
+        int partLen, numParts, background;
+        zlconv_stage_info(s, k, &partLen, &numParts, &background);
+        printf(" %dx%d%s", numParts, partLen, background ? "*" : "");
+    }
+    printf(": relative error %g: %s\n", relErr, ret ? "FAILED" : "OK");
+
+    /* after reset, the output has to start from scratch */
+    if (!ret)
+    {
+        std::vector<float> z(blockLen);
+        zlconv_reset(s);
+        zlconv_process(s, x.data(), z.data(), blockLen);
+        if (memcmp(z.data(), y.data(), blockLen * sizeof(float)))
+        {
+            printf("filterLen %d, blockLen %d: output after zlconv_reset() differs!\n", filterLen, blockLen);
+            ret = 1;
+        }
+    }
+
+    zlconv_destroy_setup(s);
+    return ret;
+}
+
+
+/* mean and worst-case time per block: the background stages flatten the peaks */
+static void bench_zlconv(int filterLen, int blockLen, int flags)
+{
+    const int numBlocks = 4096;
+    std::vector<float> h(filterLen), x(blockLen), y(blockLen);
+    double sum = 0.0, worst = 0.0;
+    int k;
+
+    for (k = 0; k < filterLen; ++k)
+        h[k] = (float)rand() / RAND_MAX - 0.5f;
+    for (k = 0; k < blockLen; ++k)
+        x[k] = (float)rand() / RAND_MAX - 0.5f;
+    zlconv_setup * s = zlconv_new_setup(h.data(), filterLen, blockLen, 0, flags);
+    if (!s)
+        return;
+    for (k = 0; k < numBlocks; ++k)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        zlconv_process(s, x.data(), y.data(), blockLen);
+        const double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        sum += dt;
+        worst = std::max(worst, dt);
+    }
+    printf("filterLen %7d, blockLen %4d%-12s: mean %8.2f us, worst %8.2f us per block\n", filterLen, blockLen,
+           (flags & ZLCONV_BACKGROUND) ? ", background" : "", 1E6 * sum / numBlocks, 1E6 * worst);
+    zlconv_destroy_setup(s);
+}
+
+
+int main(int argc, char **argv)
+{
+    // the stages transform 2 * blockLen: at least the minimum real size of the build
+    const int B = std::max(64, pffft_min_fft_size(PFFFT_REAL) / 2);
+    int ret = 0;
+
+    if (argc > 1 && !strcmp(argv[1], "--bench"))
+    {
+        bench_zlconv(1 << 17, 2 * B, 0);
+        bench_zlconv(1 << 17, 2 * B, ZLCONV_BACKGROUND);
+        bench_zlconv(1 << 17, 8 * B, 0);
+        bench_zlconv(1 << 17, 8 * B, ZLCONV_BACKGROUND);
+        return 0;
+    }
+
+    ret |= test_zlconv(20, B, 0, 0);
+    ret |= test_zlconv(200, B, 0, 0);
+    ret |= test_zlconv(3000, B, 0, 0);
+    ret |= test_zlconv(3000, B, 0, ZLCONV_BACKGROUND);
+    ret |= test_zlconv(12000, 2 * B, 0, ZLCONV_BACKGROUND);
+    ret |= test_zlconv(12000, 2 * B, 8 * B, ZLCONV_BACKGROUND);
+    ret |= test_zlconv(5000, 4 * B, 4 * B, 0);
+
+    /* missing filter - and unsuitable block length: the factor 17 is no valid size in any build */
+    const float h1 = 1.0f;
+    if (zlconv_new_setup(NULL, 100, B, 0, 0) || zlconv_new_setup(&h1, 1, 17 * B, 0, 0))
+    {
+        printf("zlconv_new_setup() should fail for unsuitable parameters!\n");
+        ret = 1;
+    }
+
+    printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+    return ret;
+}
@@ -863,6 +863,436 @@ int test(int FILTERLEN, int convFlags, const int testOutLen, int printDbg, int p
   return retErr;
 }
 
+/* serialized and in-place setups have to deliver identical results */
+int test_serialize(int filterLen, int flags)
+{
+  const int cplxFactor = (flags & PFFASTCONV_CPLX_INP_OUT) ? 2 : 1;
+  const int outFactor = (flags & (PFFASTCONV_CPLX_INP_OUT | PFFASTCONV_CPLX_FILTER)) ? 2 : 1;
+  const int inputLen = 4096;
+  float *H = (float*)malloc((unsigned)(2 * filterLen) * sizeof(float));
+  float *X = (float*)malloc((unsigned)(cplxFactor * inputLen) * sizeof(float));
+  float *Y = (float*)malloc((unsigned)(outFactor * inputLen) * sizeof(float));
+  float *Z = (float*)malloc((unsigned)(outFactor * inputLen) * sizeof(float));
+  PFFASTCONV_Setup *s, *sd;
+  void *blob;
+  size_t blobSize;
+  int i, zeroCopy, blkLen = 512, nY, nZ, retErr = 0;
+
+  for ( i = 0; i < 2 * filterLen; ++i )
+    H[i] = (float)( (i * 37) % 101 ) / 101.0F - 0.5F;
+  for ( i = 0; i < cplxFactor * inputLen; ++i )
+    X[i] = (float)( (i * 61) % 97 ) / 97.0F - 0.5F;
+
+  s = pffastconv_new_setup( H, filterLen, &blkLen, flags );
+  blobSize = pffastconv_serialized_size( s );
+  blob = pffastconv_malloc( blobSize );
+  if ( pffastconv_serialize_setup( s, blob, blobSize - 1 ) != 0
+      || pffastconv_serialize_setup( s, blob, blobSize ) != blobSize )
+    retErr = 1;
+  nY = pffastconv_apply( s, X, inputLen, Y, 1 );
+
+  for ( zeroCopy = 0; zeroCopy < 2 && !retErr; ++zeroCopy ) {
+    sd = pffastconv_deserialize_setup( blob, blobSize, zeroCopy );
+    if ( !sd ) {
+      retErr = 1;
+      break;
+    }
+    nZ = pffastconv_apply( sd, X, inputLen, Z, 1 );
+    if ( nZ != nY || memcmp( Y, Z, (unsigned)(outFactor * nY) * sizeof(float) ) )
+      retErr = 1;
+    pffastconv_destroy_setup( sd );
+  }
+  /* corrupted or truncated blobs are rejected */
+  ((unsigned char*)blob)[0] ^= 1;
+  if ( pffastconv_deserialize_setup( blob, blobSize, 0 ) )
+    retErr = 1;
+  ((unsigned char*)blob)[0] ^= 1;
+  if ( pffastconv_deserialize_setup( blob, blobSize - 1, 0 ) )
+    retErr = 1;
+
+  /* setup in caller provided memory */
+  {
+    int blkLenInpl = 512;
+    size_t memSize = pffastconv_setup_size( filterLen, &blkLenInpl, flags );
+    void *mem = pffastconv_malloc( memSize );
+    sd = pffastconv_init_setup_inplace( mem, H, filterLen, &blkLenInpl, flags );
+    if ( !sd || blkLenInpl != blkLen ) {
+      retErr = 1;
+    } else {
+      nZ = pffastconv_apply( sd, X, inputLen, Z, 1 );
+      if ( nZ != nY || memcmp( Y, Z, (unsigned)(outFactor * nY) * sizeof(float) ) )
+        retErr = 1;
+      pffastconv_destroy_setup( sd );
+    }
+    pffastconv_free( mem );
+  }
+
+  printf("serialized and in-place setups for filterLen %d, flags %d: %s\n", filterLen, flags, retErr ? "FAILED" : "OK");
+  pffastconv_free( blob );
+  pffastconv_destroy_setup( s );
+  free(H);
+  free(X);
+  free(Y);
+  free(Z);
+  return retErr;
+}
+
+
+/* push the input in chunks of varying length - keeping the unprocessed
+ * samples as required - and compare with the direct convolution.
+ * real or complex filter, real or complex input, partitioned or not */
+int test_chunked(int filterLen, int blkLen, int flags)
+{
+  const int cplxInp = (flags & PFFASTCONV_CPLX_INP_OUT) ? 1 : 0;
+  const int cplxFilter = (flags & PFFASTCONV_CPLX_FILTER) ? 1 : 0;
+  const int inpFactor = cplxInp ? 2 : 1;
+  const int outFactor = (cplxInp || cplxFilter) ? 2 : 1;
+  const int inputLen = 4 * filterLen + 3 * blkLen + 17;
+  const int outLen = inputLen - filterLen + 1;
+  float *H = (float*)malloc((unsigned)(2 * filterLen) * sizeof(float));
+  float *X = (float*)malloc((unsigned)(inpFactor * inputLen) * sizeof(float));
+  float *Y = (float*)malloc((unsigned)(outFactor * inputLen) * sizeof(float));
+  double *R = (double*)malloc((unsigned)(2 * outLen) * sizeof(double));
+  PFFASTCONV_Setup *s;
+  double errSum = 0.0, refSum = 0.0, relErr;
+  int i, j, inpOff = 0, nOut = 0, chunk, n, outBlkLen = blkLen, retErr = 0;
+
+  for ( i = 0; i < 2 * filterLen; ++i )
+    H[i] = (float)( (i * 37) % 101 ) / 101.0F - 0.5F;
+  for ( i = 0; i < inpFactor * inputLen; ++i )
+    X[i] = (float)( (i * 61) % 97 ) / 97.0F - 0.5F;
+  for ( i = 0; i < outLen; ++i ) {
+    double sumRe = 0.0, sumIm = 0.0;
+    for ( j = 0; j < filterLen; ++j ) {
+      const int k = (flags & PFFASTCONV_CORRELATION) ? j : (filterLen - 1 - j);
+      const double xr = X[ inpFactor * (i + j) ];
+      const double xi = cplxInp ? X[ 2 * (i + j) + 1 ] : 0.0;
+      const double hr = cplxFilter ? H[2 * k] : H[k];
+      const double hi = cplxFilter ? H[2 * k + 1] : 0.0;
+      sumRe += xr * hr - xi * hi;
+      sumIm += xr * hi + xi * hr;
+    }
+    R[ outFactor * i ] = sumRe;
+    if ( outFactor == 2 )
+      R[ 2 * i + 1 ] = sumIm;
+  }
+
+  s = pffastconv_new_setup( H, filterLen, &outBlkLen, flags );
+  if ( !s ) {
+    printf("setup for filterLen %d, blockLen %d, flags %d: FAILED\n", filterLen, blkLen, flags);
+    free(H);
+    free(X);
+    free(Y);
+    free(R);
+    return 1;
+  }
+  for ( chunk = 0; inpOff + filterLen <= inputLen; ++chunk ) {
+    /* the chunk includes the kept samples from the last call */
+    int len = filterLen - 1 + ( (chunk * 7) % 3 + 1 ) * outBlkLen / 2;
+    const int flush = ( inpOff + len >= inputLen );
+    if ( flush )
+      len = inputLen - inpOff;
+    n = pffastconv_apply( s, X + inpFactor * inpOff, len, Y + outFactor * nOut, flush );
+    if ( !flush && (flags & PFFASTCONV_PARTITIONED) && n % outBlkLen )
+      retErr = 1;
+    inpOff += n;
+    nOut += n;
+    if ( flush )
+      break;
+  }
+  if ( nOut != outLen )
+    retErr = 1;
+  for ( i = 0; i < outFactor * outLen && !retErr; ++i ) {
+    errSum += ( Y[i] - R[i] ) * ( Y[i] - R[i] );
+    refSum += R[i] * R[i];
+  }
+  relErr = sqrt( errSum / ( refSum > 0.0 ? refSum : 1.0 ) );
+  if ( relErr > 1E-5 )
+    retErr = 1;
+
+  printf("%s %s convolution with %s filterLen %d",
+         (flags & PFFASTCONV_PARTITIONED) ? "partitioned" : "block", cplxInp ? "cplx" : "real",
+         cplxFilter ? "cplx" : "real", filterLen);
+  if ( flags & PFFASTCONV_PARTITIONED )
+    printf(" in %d partitions of %d", ( filterLen + outBlkLen - 1 ) / outBlkLen, outBlkLen);
+  printf(": %d outputs, relative error %g: %s\n", nOut, relErr, retErr ? "FAILED" : "OK");
+  pffastconv_destroy_setup( s );
+  free(H);
+  free(X);
+  free(Y);
+  free(R);
+  return retErr;
+}
+
+
+/* each output of a multi filter setup has to match the single filter setup
+ * with the same filter - also after serialization */
+int test_multi(int filterLen, int numFilters, int flags)
+{
+  const int cplxInp = (flags & PFFASTCONV_CPLX_INP_OUT) ? 1 : 0;
+  const int cplxFilter = (flags & PFFASTCONV_CPLX_FILTER) ? 1 : 0;
+  const int inpFactor = cplxInp ? 2 : 1;
+  const int outFactor = (cplxInp || cplxFilter) ? 2 : 1;
+  const int coeffLen = (cplxFilter ? 2 : 1) * filterLen;
+  const int inputLen = 4096;
+  float *H = (float*)malloc((unsigned)(numFilters * coeffLen) * sizeof(float));
+  float *X = (float*)malloc((unsigned)(inpFactor * inputLen) * sizeof(float));
+  float *Y = (float*)malloc((unsigned)(outFactor * inputLen) * sizeof(float));
+  float *Z = (float*)malloc((unsigned)(numFilters * outFactor * inputLen) * sizeof(float));
+  float **outputs = (float**)malloc((unsigned)numFilters * sizeof(float*));
+  PFFASTCONV_Setup *s, *s1;
+  void *blob;
+  size_t blobSize;
+  double errSum = 0.0, refSum = 0.0, relErr;
+  int i, f, blkLen = 512, blkLen1, nY, nZ, retErr = 0;
+
+  for ( i = 0; i < numFilters * coeffLen; ++i )
+    H[i] = (float)( (i * 37) % 101 ) / 101.0F - 0.5F;
+  for ( i = 0; i < inpFactor * inputLen; ++i )
+    X[i] = (float)( (i * 61) % 97 ) / 97.0F - 0.5F;
+  for ( f = 0; f < numFilters; ++f )
+    outputs[f] = Z + f * outFactor * inputLen;
+
+  s = pffastconv_new_setup_multi( H, numFilters, filterLen, &blkLen, flags );
+  blobSize = pffastconv_serialized_size( s );
+  blob = pffastconv_malloc( blobSize );
+  if ( pffastconv_serialize_setup( s, blob, blobSize ) != blobSize )
+    retErr = 1;
+  pffastconv_destroy_setup( s );
+  s = pffastconv_deserialize_setup( blob, blobSize, 0 );
+  if ( !s || pffastconv_new_setup_multi( H, 0, filterLen, &blkLen, flags ) )
+    retErr = 1;
+
+  nZ = retErr ? 0 : pffastconv_apply_multi( s, X, inputLen, outputs, 1 );
+  for ( f = 0; f < numFilters && !retErr; ++f ) {
+    blkLen1 = 512;
+    s1 = pffastconv_new_setup( H + f * coeffLen, filterLen, &blkLen1, flags );
+    nY = pffastconv_apply( s1, X, inputLen, Y, 1 );
+    if ( nY != nZ || blkLen1 != blkLen )
+      retErr = 1;
+    for ( i = 0; i < outFactor * nY && !retErr; ++i ) {
+      errSum += ( outputs[f][i] - Y[i] ) * ( outputs[f][i] - Y[i] );
+      refSum += Y[i] * Y[i];
+    }
+    pffastconv_destroy_setup( s1 );
+  }
+  relErr = sqrt( errSum / ( refSum > 0.0 ? refSum : 1.0 ) );
+  if ( relErr > 1E-6 )
+    retErr = 1;
+
+  printf("%d filters of filterLen %d, flags %d sharing the input spectrum: relative error %g: %s\n",
+         numFilters, filterLen, flags, relErr, retErr ? "FAILED" : "OK");
+  pffastconv_free( blob );
+  pffastconv_destroy_setup( s );
+  free(H);
+  free(X);
+  free(Y);
+  free(Z);
+  free(outputs);
+  return retErr;
+}
+
+
+/* a symmetric filter with PFFASTCONV_SYMMETRIC - using the packed real spectrum -
+ * has to deliver the same output as without the flag. with PFFASTCONV_DIRECT_OUT,
+ * the input is limited to one block */
+int test_symmetric(int filterLen, int flags)
+{
+  const int inpFactor = (flags & PFFASTCONV_CPLX_INP_OUT) ? 2 : 1;
+  const int maxInputLen = 4096;
+  float *H = (float*)malloc((unsigned)filterLen * sizeof(float));
+  float *X = (float*)pffastconv_malloc((unsigned)(inpFactor * maxInputLen) * sizeof(float));
+  float *Y = (float*)pffastconv_malloc((unsigned)(inpFactor * maxInputLen) * sizeof(float));
+  float *Z = (float*)pffastconv_malloc((unsigned)(inpFactor * maxInputLen) * sizeof(float));
+  PFFASTCONV_Setup *s, *sr;
+  void *blob;
+  size_t blobSize;
+  double errSum = 0.0, refSum = 0.0, relErr;
+  int i, blkLen = 512, blkLenRef = 512, inputLen = maxInputLen, nY, nZ, retErr = 0;
+
+  for ( i = 0; i < filterLen; ++i )
+    H[i] = H[filterLen - 1 - i] = (float)( (i * 37) % 101 ) / 101.0F - 0.5F;
+  for ( i = 0; i < inpFactor * maxInputLen; ++i )
+    X[i] = (float)( (i * 61) % 97 ) / 97.0F - 0.5F;
+
+  s = pffastconv_new_setup( H, filterLen, &blkLen, flags | PFFASTCONV_SYMMETRIC );
+  sr = pffastconv_new_setup( H, filterLen, &blkLenRef, flags );
+  if ( flags & PFFASTCONV_DIRECT_OUT )
+    inputLen = blkLen;
+  /* through serialization: the packed spectrum has its own size */
+  blobSize = pffastconv_serialized_size( s );
+  blob = pffastconv_malloc( blobSize );
+  if ( pffastconv_serialize_setup( s, blob, blobSize ) != blobSize )
+    retErr = 1;
+  pffastconv_destroy_setup( s );
+  s = pffastconv_deserialize_setup( blob, blobSize, 1 );
+  if ( !s )
+    retErr = 1;
+
+  nY = retErr ? 0 : pffastconv_apply( s, X, inputLen, Y, 1 );
+  nZ = pffastconv_apply( sr, X, inputLen, Z, 1 );
+  if ( nY != nZ || blkLen != blkLenRef )
+    retErr = 1;
+  for ( i = 0; i < inpFactor * nY && !retErr; ++i ) {
+    errSum += ( Y[i] - Z[i] ) * ( Y[i] - Z[i] );
+    refSum += Z[i] * Z[i];
+  }
+  relErr = sqrt( errSum / ( refSum > 0.0 ? refSum : 1.0 ) );
+  if ( relErr > 1E-5 )
+    retErr = 1;
+
+  printf("symmetric filterLen %d, flags %d: %d outputs, relative error %g: %s\n",
+         filterLen, flags, nY, relErr, retErr ? "FAILED" : "OK");
+  pffastconv_destroy_setup( s );
+  pffastconv_destroy_setup( sr );
+  pffastconv_free( blob );
+  free(H);
+  pffastconv_free(X);
+  pffastconv_free(Y);
+  pffastconv_free(Z);
+  return retErr;
+}
+
+
+/* push the input into pffastconv_stream() in chunks of varying length - from single samples
+ * up to several blocks, at aligned and unaligned positions. returns the number of outputs */
+static int stream_chunks(PFFASTCONV_Setup *s, const float *X, int inputLen, int inpFactor,
+                         float *Y, int outFactor, int blkLen, int *retErr)
+{
+  static const int chunks[] = { 1, 7, 1000, 3, 16, 16384, 0, 64, 2 };
+  int k, n, chunk, inpOff = 0, nOut = 0;
+
+  for ( k = 0; inpOff < inputLen; ++k ) {
+    chunk = chunks[ k % (sizeof(chunks) / sizeof(chunks[0])) ];
+    if ( chunk > inputLen - inpOff )
+      chunk = inputLen - inpOff;
+    n = pffastconv_stream( s, X + inpFactor * inpOff, chunk, Y + outFactor * nOut );
+    if ( n < 0 || n > chunk + blkLen )
+      *retErr = 1;
+    inpOff += chunk;
+    nOut += n;
+  }
+  return nOut;
+}
+
+/* compare the chunked stream with the causal direct convolution */
+int test_stream(int filterLen, int blkLen, int flags)
+{
+  const int cplxInp = (flags & PFFASTCONV_CPLX_INP_OUT) ? 1 : 0;
+  const int cplxFilter = (flags & PFFASTCONV_CPLX_FILTER) ? 1 : 0;
+  const int inpFactor = cplxInp ? 2 : 1;
+  const int outFactor = (cplxInp || cplxFilter) ? 2 : 1;
+  const int inputLen = 3 * filterLen + 20 * blkLen;
+  float *H = (float*)malloc((unsigned)(2 * filterLen) * sizeof(float));
+  float *X = (float*)pffastconv_malloc((unsigned)(inpFactor * inputLen) * sizeof(float));
+  float *Y, *Z;
+  PFFASTCONV_Setup *s;
+  double errSum = 0.0, refSum = 0.0, relErr;
+  int i, j, nOut, outBlkLen = blkLen, retErr = 0;
+
+  for ( i = 0; i < 2 * filterLen; ++i )
+    H[i] = (float)( (i * 37) % 101 ) / 101.0F - 0.5F;
+  if ( flags & PFFASTCONV_SYMMETRIC ) {
+    for ( i = 0; i < filterLen / 2; ++i )
+      H[filterLen - 1 - i] = H[i];
+  }
+  for ( i = 0; i < inpFactor * inputLen; ++i )
+    X[i] = (float)( (i * 61) % 97 ) / 97.0F - 0.5F;
+
+  s = pffastconv_new_setup( H, filterLen, &outBlkLen, flags );
+  Y = (float*)pffastconv_malloc((unsigned)(outFactor * (inputLen + 2 * outBlkLen)) * sizeof(float));
+  Z = (float*)pffastconv_malloc((unsigned)(outFactor * (inputLen + 2 * outBlkLen)) * sizeof(float));
+  nOut = stream_chunks( s, X, inputLen, inpFactor, Y, outFactor, outBlkLen, &retErr );
+  if ( nOut > inputLen || nOut < inputLen - 2 * outBlkLen )
+    retErr = 1;
+
+  for ( i = 0; i < nOut && !retErr; ++i ) {
+    double sumRe = 0.0, sumIm = 0.0;
+    for ( j = 0; j < filterLen && j <= i; ++j ) {
+      const int kf = (flags & PFFASTCONV_CORRELATION) ? (filterLen - 1 - j) : j;
+      const double xr = X[ inpFactor * (i - j) ];
+      const double xi = cplxInp ? X[ 2 * (i - j) + 1 ] : 0.0;
+      const double hr = cplxFilter ? H[2 * kf] : H[kf];
+      const double hi = cplxFilter ? H[2 * kf + 1] : 0.0;
+      sumRe += xr * hr - xi * hi;
+      sumIm += xr * hi + xi * hr;
+    }
+    errSum += ( Y[outFactor * i] - sumRe ) * ( Y[outFactor * i] - sumRe );
+    refSum += sumRe * sumRe;
+    if ( outFactor == 2 ) {
+      errSum += ( Y[2 * i + 1] - sumIm ) * ( Y[2 * i + 1] - sumIm );
+      refSum += sumIm * sumIm;
+    }
+  }
+  relErr = sqrt( errSum / ( refSum > 0.0 ? refSum : 1.0 ) );
+  if ( relErr > 1E-5 )
+    retErr = 1;
+
+  /* after reset, the stream restarts from scratch */
+  pffastconv_reset( s );
+  if ( stream_chunks( s, X, inputLen, inpFactor, Z, outFactor, outBlkLen, &retErr ) != nOut
+       || memcmp( Y, Z, (unsigned)(outFactor * nOut) * sizeof(float) ) )
+    retErr = 1;
+
+  printf("streaming %s%s convolution with %s filterLen %d, blockLen %d: %d outputs, relative error %g: %s\n",
+         (flags & PFFASTCONV_PARTITIONED) ? "partitioned " : "", cplxInp ? "cplx" : "real",
+         cplxFilter ? "cplx" : "real", filterLen, outBlkLen, nOut, relErr, retErr ? "FAILED" : "OK");
+  pffastconv_destroy_setup( s );
+  free(H);
+  pffastconv_free(X);
+  pffastconv_free(Y);
+  pffastconv_free(Z);
+  return retErr;
+}
+
+
+int test_instr(int filterLen, int blkLen)
+{
+  const int inputLen = 4 * blkLen;
+  float *H = (float*)malloc((unsigned)filterLen * sizeof(float));
+  float *X = (float*)pffastconv_malloc((unsigned)inputLen * sizeof(float));
+  float *Y = (float*)pffastconv_malloc((unsigned)inputLen * sizeof(float));
+  pffft_instr_counter_t apply;
+  pffft_instr_snapshot_t fft;
+  PFFASTCONV_Setup *s;
+  int i, enabled, nOut, outBlkLen = blkLen, retErr = 0;
+  unsigned long long fftCalls = 0;
+
+  for ( i = 0; i < filterLen; ++i )
+    H[i] = (float)( (i * 37) % 101 ) / 101.0F - 0.5F;
+  for ( i = 0; i < inputLen; ++i )
+    X[i] = (float)( (i * 61) % 97 ) / 97.0F - 0.5F;
+
+  s = pffastconv_new_setup( H, filterLen, &outBlkLen, 0 );
+  nOut = pffastconv_apply( s, X, inputLen, Y, 1 );
+  enabled = pffastconv_get_instr_snapshot( s, &apply, &fft );
+  for ( i = 0; i < PFFFT_INSTR_NUM; ++i )
+    fftCalls += fft.func[i].calls;
+
+  if ( enabled ) {
+    if ( apply.calls != 1 || apply.samples != (unsigned long long)nOut || !fftCalls )
+      retErr = 1;
+    pffastconv_reset_instr( s );
+    pffastconv_get_instr_snapshot( s, &apply, &fft );
+    for ( i = 0; i < PFFFT_INSTR_NUM; ++i )
+      if ( fft.func[i].calls || fft.func[i].samples || fft.func[i].cycles )
+        retErr = 1;
+    if ( apply.calls || apply.samples || apply.cycles )
+      retErr = 1;
+  }
+  else if ( apply.calls || apply.samples || fftCalls )
+    retErr = 1;
+
+  printf("instrumentation %s: apply() %d outputs, %llu fft calls: %s\n",
+         enabled ? "enabled" : "disabled", nOut, fftCalls, retErr ? "FAILED" : "OK");
+  pffastconv_destroy_setup( s );
+  free(H);
+  pffastconv_free(X);
+  pffastconv_free(Y);
+  return retErr;
+}
+
+
 /* small functions inside pffft.c that will detect (compiler) bugs with respect to simd instructions */
 void validate_pffft_simd();
 int  validate_pffft_simd_ex(FILE * DbgOut);
@@ -912,6 +1342,43 @@ int main(int argc, char **argv)
   }
 
 
+  result |= test_serialize(100, 0);
+  result |= test_serialize(100, PFFASTCONV_CPLX_INP_OUT);
+  result |= test_serialize(1000, PFFASTCONV_PARTITIONED);
+  result |= test_serialize(100, PFFASTCONV_CPLX_FILTER | PFFASTCONV_CPLX_INP_OUT);
+  result |= test_serialize(1000, PFFASTCONV_PARTITIONED | PFFASTCONV_CPLX_FILTER);
+  result |= test_chunked(16000, 256, PFFASTCONV_PARTITIONED);
+  result |= test_chunked(1000, 64, PFFASTCONV_PARTITIONED | PFFASTCONV_CORRELATION);
+  result |= test_chunked(100, 256, PFFASTCONV_PARTITIONED);
+  result |= test_chunked(777, 128, PFFASTCONV_PARTITIONED | PFFASTCONV_CPLX_INP_OUT);
+  result |= test_chunked(100, 512, 0);
+  result |= test_chunked(100, 512, PFFASTCONV_CPLX_FILTER | PFFASTCONV_CPLX_INP_OUT);
+  result |= test_chunked(333, 64, PFFASTCONV_CPLX_FILTER | PFFASTCONV_CPLX_INP_OUT | PFFASTCONV_CORRELATION);
+  result |= test_chunked(100, 512, PFFASTCONV_CPLX_FILTER);
+  result |= test_chunked(2000, 256, PFFASTCONV_CPLX_FILTER | PFFASTCONV_CPLX_INP_OUT | PFFASTCONV_PARTITIONED);
+  result |= test_chunked(2000, 256, PFFASTCONV_CPLX_FILTER | PFFASTCONV_PARTITIONED);
+  result |= test_multi(100, 4, 0);
+  result |= test_multi(100, 3, PFFASTCONV_CPLX_INP_OUT);
+  result |= test_multi(100, 3, PFFASTCONV_CPLX_INP_OUT | PFFASTCONV_CPLX_SINGLE_FFT);
+  result |= test_multi(100, 3, PFFASTCONV_CPLX_FILTER | PFFASTCONV_CPLX_INP_OUT);
+  result |= test_multi(1000, 5, PFFASTCONV_PARTITIONED);
+  result |= test_multi(1000, 2, PFFASTCONV_PARTITIONED | PFFASTCONV_CPLX_FILTER);
+  result |= test_symmetric(101, 0);
+  result |= test_symmetric(64, 0);
+  result |= test_symmetric(33, PFFASTCONV_CPLX_INP_OUT);
+  result |= test_symmetric(64, PFFASTCONV_CPLX_INP_OUT | PFFASTCONV_CPLX_SINGLE_FFT);
+  result |= test_symmetric(255, PFFASTCONV_DIRECT_OUT);
+  result |= test_symmetric(1, 0);
+  result |= test_stream(100, 256, 0);
+  result |= test_stream(100, 256, PFFASTCONV_CORRELATION);
+  result |= test_stream(101, 256, PFFASTCONV_SYMMETRIC);
+  result |= test_stream(60, 128, PFFASTCONV_CPLX_INP_OUT);
+  result |= test_stream(60, 128, PFFASTCONV_CPLX_INP_OUT | PFFASTCONV_CPLX_SINGLE_FFT);
+  result |= test_stream(60, 128, PFFASTCONV_CPLX_FILTER);
+  result |= test_stream(1000, 64, PFFASTCONV_PARTITIONED);
+  result |= test_stream(300, 64, PFFASTCONV_PARTITIONED | PFFASTCONV_CPLX_INP_OUT);
+  result |= test_instr(100, 256);
+
   if (testOutLens)
   {
     for ( k = 0; k < 3; ++k )
@@ -0,0 +1,147 @@
+/*
+  test of the C++ wrapper pffastconv.hpp - for float and double:
+  compare against the direct convolution, computed in double precision
+ */
+
+#include "pffastconv.hpp"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+
+template<typename T>
+static double direct_error(const std::vector<T> & h, int filterLen, const pffft::AlignedVector<T> & x,
+                           const T * y, int numOut, int flags, int causal)
+{
+  const int cplxInp = (flags & pffft::detail::PFFASTCONV_CPLX_INP_OUT) ? 1 : 0;
+  const int cplxFilter = (flags & pffft::detail::PFFASTCONV_CPLX_FILTER) ? 1 : 0;
+  const int inpFactor = cplxInp ? 2 : 1;
+  const int outFactor = (cplxInp || cplxFilter) ? 2 : 1;
+  double errSum = 0.0, refSum = 0.0;
+  int i, j;
+
+  for (i = 0; i < numOut; ++i)
+  {
+    double sumRe = 0.0, sumIm = 0.0;
+    for (j = 0; j < filterLen; ++j)
+    {
+      /* pffastconv_apply() starts with the first complete window - pffastconv_stream() with the first sample */
+      const int xi = causal ? (i - j) : (i + filterLen - 1 - j);
+      if (xi < 0)
+        break;
+      const double xr = x[inpFactor * xi];
+      const double xim = cplxInp ? x[2 * xi + 1] : 0.0;
+      const double hr = cplxFilter ? h[2 * j] : h[j];
+      const double him = cplxFilter ? h[2 * j + 1] : 0.0;
+      sumRe += xr * hr - xim * him;
+      sumIm += xr * him + xim * hr;
+    }
+    errSum += (y[outFactor * i] - sumRe) * (y[outFactor * i] - sumRe);
+    refSum += sumRe * sumRe;
+    if (outFactor == 2)
+    {
+      errSum += (y[2 * i + 1] - sumIm) * (y[2 * i + 1] - sumIm);
+      refSum += sumIm * sumIm;
+    }
+  }
+  return sqrt(errSum / (refSum > 0.0 ? refSum : 1.0));
+}
+
+
+template<typename T>
+static int test_fastconv(int filterLen, int blockLen, int flags, double maxErr)
+{
+  typedef pffft::FastConvolution<T> Conv;
+  const int cplxFilter = (flags & pffft::detail::PFFASTCONV_CPLX_FILTER) ? 1 : 0;
+  std::vector<T> h((cplxFilter ? 2 : 1) * filterLen);
+  int k, ret = 0;
+
+  srand(filterLen + flags);
+  for (k = 0; k < int(h.size()); ++k)
+    h[k] = T(rand()) / T(RAND_MAX) - T(0.5);
+  if (flags & pffft::detail::PFFASTCONV_SYMMETRIC)
+    for (k = 0; k < filterLen / 2; ++k)
+      h[filterLen - 1 - k] = h[k];
+
+  Conv conv(h.data(), filterLen, blockLen, flags);
+  if (!conv.isValid())
+  {
+    printf("%s filterLen %d, flags %d: setup failed!\n", sizeof(T) == sizeof(float) ? "float" : "double", filterLen, flags);
+    return 1;
+  }
+
+  /* DIRECT_INP/OUT require inputLen <= blockLen: one block per apply() */
+  const int nx = (flags & (pffft::detail::PFFASTCONV_DIRECT_INP | pffft::detail::PFFASTCONV_DIRECT_OUT))
+      ? conv.getBlockLen() : (4 * conv.getBlockLen() + filterLen);
+  pffft::AlignedVector<T> x(conv.inputFactor() * nx), y, z;
+  for (k = 0; k < int(x.size()); ++k)
+    x[k] = T(rand()) / T(RAND_MAX) - T(0.5);
+
+  /* with PFFASTCONV_CORRELATION, the filter is applied flipped */
+  std::vector<T> hc(h);
+  if (flags & pffft::detail::PFFASTCONV_CORRELATION)
+    for (k = 0; k < filterLen; ++k)
+      for (int c = 0; c <= cplxFilter; ++c)
+        hc[(cplxFilter + 1) * k + c] = h[(cplxFilter + 1) * (filterLen - 1 - k) + c];
+
+  conv.apply(x, y, true);
+  const int numApply = int(y.size()) / conv.outputFactor();
+  const double errApply = direct_error(hc, filterLen, x, y.data(), numApply, flags, 0);
+
+  /* streaming: the causal convolution */
+  double errStream = 0.0;
+  int numStream = 0;
+  if (!(flags & (pffft::detail::PFFASTCONV_DIRECT_INP | pffft::detail::PFFASTCONV_DIRECT_OUT)))
+  {
+    Conv sconv(h.data(), filterLen, blockLen, flags);
+    sconv.stream(x, z);
+    numStream = int(z.size()) / sconv.outputFactor();
+    errStream = direct_error(hc, filterLen, x, z.data(), numStream, flags, 1);
+  }
+
+  if (numApply <= 0 || errApply > maxErr || errStream > maxErr)
+    ret = 1;
+  printf("%-6s filterLen %4d, blockLen %4d, flags %3d: %d outputs, relative error %g, stream %d outputs, error %g: %s\n",
+         sizeof(T) == sizeof(float) ? "float" : "double", filterLen, conv.getBlockLen(), flags,
+         numApply, errApply, numStream, errStream, ret ? "FAILED" : "OK");
+  return ret;
+}
+
+
+template<typename T>
+static int test_all(double maxErr)
+{
+  int ret = 0;
+  ret |= test_fastconv<T>(100, 256, 0, maxErr);
+  ret |= test_fastconv<T>(100, 256, pffft::detail::PFFASTCONV_CORRELATION, maxErr);
+  ret |= test_fastconv<T>(101, 256, pffft::detail::PFFASTCONV_SYMMETRIC, maxErr);
+  ret |= test_fastconv<T>(60, 128, pffft::detail::PFFASTCONV_CPLX_INP_OUT, maxErr);
+  ret |= test_fastconv<T>(60, 128, pffft::detail::PFFASTCONV_CPLX_INP_OUT | pffft::detail::PFFASTCONV_CPLX_SINGLE_FFT, maxErr);
+  ret |= test_fastconv<T>(60, 128, pffft::detail::PFFASTCONV_CPLX_FILTER, maxErr);
+  ret |= test_fastconv<T>(60, 128, pffft::detail::PFFASTCONV_CPLX_INP_OUT | pffft::detail::PFFASTCONV_CPLX_FILTER, maxErr);
+  ret |= test_fastconv<T>(64, 256, pffft::detail::PFFASTCONV_DIRECT_INP | pffft::detail::PFFASTCONV_DIRECT_OUT, maxErr);
+  ret |= test_fastconv<T>(3000, 128, pffft::detail::PFFASTCONV_PARTITIONED, maxErr);
+  return ret;
+}
+
+
+int main(int argc, char **argv)
+{
+  int ret = 0;
+  (void)argc;
+  (void)argv;
+
+#if defined(PFFFT_ENABLE_FLOAT) || ( !defined(PFFFT_ENABLE_FLOAT) && !defined(PFFFT_ENABLE_DOUBLE) )
+  ret |= test_all<float>(1E-5);
+#endif
+#if defined(PFFFT_ENABLE_DOUBLE)
+  ret |= test_all<double>(1E-13);
+#endif
+
+  printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+  return ret;
+}
@@ -0,0 +1,215 @@
+/*
+  test of pffastconv_xcorr: the peaks of real and complex streams -
+  over all lags and over lag windows - against a brute force
+  cross-correlation, and the sub-sample interpolation of a pulse with a
+  fractional delay. with '--bench', compare the time per stream of the
+  full lag range with that of a small TDOA window.
+ */
+
+#include "pffastconv_xcorr.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_MSC_VER)
+#pragma warning( disable : 4244 )
+#endif
+
+
+static float frand(unsigned *state)
+{
+  *state = *state * 1664525u + 1013904223u;
+  return (float)((*state >> 8) / 8388608.0 - 1.0);
+}
+
+
+/* c[lag] of the definition - in double */
+static void ref_xcorr(const float *x, int L, const float *r, int M, int ns, int lag, double *re, double *im)
+{
+  int n;
+  *re = *im = 0.0;
+  for (n = 0; n < M; ++n) {
+    if (n + lag < 0 || n + lag >= L)
+      continue;
+    if (ns == 1)
+      *re += (double)x[n + lag] * r[n];
+    else {
+      const double xr = x[2*(n+lag)], xi = x[2*(n+lag)+1], rr = r[2*n], ri = r[2*n+1];
+      *re += xr * rr + xi * ri;
+      *im += xi * rr - xr * ri;
+    }
+  }
+}
+
+
+static int test_peaks(int M, int L, int minLag, int maxLag, pffft_transform_t transform)
+{
+  const int ns = (transform == PFFFT_COMPLEX) ? 2 : 1;
+  const int numStreams = 5, stride = ns * L + 3;
+  const int lo = (minLag < -(M-1)) ? -(M-1) : minLag, hi = (maxLag > L-1) ? (L-1) : maxLag;
+  PFFASTCONV_XCorr *xc;
+  pffastconv_xcorr_peak_t peaks[5];
+  float *r, *x;
+  unsigned state = 1234u + (unsigned)(M * 7 + L);
+  int s, k, ret = 0;
+
+  r = (float*)malloc((size_t)ns * M * sizeof(float));
+  x = (float*)malloc((size_t)numStreams * stride * sizeof(float));
+  for (k = 0; k < ns * M; ++k)
+    r[k] = frand(&state);
+  for (k = 0; k < numStreams * stride; ++k)
+    x[k] = 0.5f * frand(&state);
+  /* hide the reference in each stream - with a different delay and gain */
+  for (s = 0; s < numStreams; ++s) {
+    const int d = lo + (s * 37 + 5) % (hi - lo + 1);
+    for (k = 0; k < M; ++k) {
+      if (k + d < 0 || k + d >= L)
+        continue;
+      x[s * stride + ns * (k + d)] += (1.0f + 0.25f * s) * r[ns * k];
+      if (ns == 2)
+        x[s * stride + 2 * (k + d) + 1] += (1.0f + 0.25f * s) * r[2 * k + 1];
+    }
+  }
+
+  xc = pffastconv_xcorr_new(r, M, L, minLag, maxLag, transform);
+  if (!xc) {
+    printf("%s M = %d, L = %d: setup failed!\n", (ns == 2) ? "complex" : "real", M, L);
+    free(r);
+    free(x);
+    return 1;
+  }
+  pffastconv_xcorr_peaks(xc, x, numStreams, stride, peaks);
+
+  for (s = 0; s < numStreams; ++s) {
+    double best = -1.0, bre = 0.0, bim = 0.0, re, im, scale = 0.0;
+    int lag, bestLag = lo;
+    for (lag = lo; lag <= hi; ++lag) {
+      ref_xcorr(x + s * stride, L, r, M, ns, lag, &re, &im);
+      if (re * re + im * im > best) {
+        best = re * re + im * im;
+        bestLag = lag;
+        bre = re;
+        bim = im;
+      }
+    }
+    scale = sqrt(best);
+    if (peaks[s].lag != bestLag || fabs(peaks[s].re - bre) > 1E-4 * scale || fabs(peaks[s].im - bim) > 1E-4 * scale
+        || peaks[s].frac < -0.5f || peaks[s].frac > 0.5f || peaks[s].value < 0.999 * scale) {
+      printf("%s M = %d, L = %d, lags %d .. %d, stream %d: peak at %d %+.3f = (%g, %g) - expected %d = (%g, %g)!\n",
+             (ns == 2) ? "complex" : "real", M, L, minLag, maxLag, s,
+             peaks[s].lag, peaks[s].frac, peaks[s].re, peaks[s].im, bestLag, bre, bim);
+      ret = 1;
+    }
+  }
+  if (!ret)
+    printf("%s M = %d, L = %d, lags %d .. %d: N = %d: successful\n", (ns == 2) ? "complex" : "real",
+           M, L, minLag, maxLag, pffastconv_xcorr_fft_size(xc));
+
+  pffastconv_xcorr_destroy(xc);
+  free(r);
+  free(x);
+  return ret;
+}
+
+
+/* gaussian pulse, delayed by a fractional number of samples */
+static int test_interpolation(pffft_transform_t transform)
+{
+  const int ns = (transform == PFFFT_COMPLEX) ? 2 : 1;
+  const int M = 64, L = 512;
+  const double delays[] = { 100.0, 100.3, 211.5, 300.8 };
+  PFFASTCONV_XCorr *xc;
+  pffastconv_xcorr_peak_t peak;
+  float r[2 * 64], x[2 * 512];
+  int d, k, ret = 0;
+
+  for (k = 0; k < M; ++k) {
+    const double t = (k - 32) / 4.0;
+    r[ns * k] = (float)exp(-0.5 * t * t);
+    if (ns == 2)
+      r[2 * k + 1] = 0.5f * r[2 * k];
+  }
+  xc = pffastconv_xcorr_new(r, M, L, 0, L - M, transform);
+  for (d = 0; d < 4; ++d) {
+    double pos;
+    memset(x, 0, sizeof(x));
+    for (k = 0; k < L; ++k) {
+      const double t = (k - 32 - delays[d]) / 4.0;
+      x[ns * k] = (float)exp(-0.5 * t * t);
+      if (ns == 2)
+        x[2 * k + 1] = 0.5f * x[2 * k];
+    }
+    pffastconv_xcorr_peaks(xc, x, 1, 0, &peak);
+    pos = peak.lag + peak.frac;
+    if (fabs(pos - delays[d]) > 0.05) {
+      printf("%s pulse delayed by %g: peak at %d %+.3f!\n", (ns == 2) ? "complex" : "real", delays[d], peak.lag, peak.frac);
+      ret = 1;
+    }
+  }
+  if (!ret)
+    printf("%s pulse: fractional delays successful\n", (ns == 2) ? "complex" : "real");
+  pffastconv_xcorr_destroy(xc);
+  return ret;
+}
+
+
+static void bench_xcorr(int L, int D, int numStreams)
+{
+  PFFASTCONV_XCorr *full, *win;
+  pffastconv_xcorr_peak_t *peaks = (pffastconv_xcorr_peak_t*)malloc((size_t)numStreams * sizeof(pffastconv_xcorr_peak_t));
+  float *x = (float*)malloc((size_t)numStreams * L * sizeof(float));
+  unsigned state = 42u;
+  clock_t t0, t1, t2;
+  int k;
+
+  for (k = 0; k < numStreams * L; ++k)
+    x[k] = frand(&state);
+  full = pffastconv_xcorr_new(x, L, L, -L, L, PFFFT_REAL);
+  win = pffastconv_xcorr_new(x, L, L, -D, D, PFFFT_REAL);
+  t0 = clock();
+  pffastconv_xcorr_peaks(full, x, numStreams, L, peaks);
+  t1 = clock();
+  pffastconv_xcorr_peaks(win, x, numStreams, L, peaks);
+  t2 = clock();
+  printf("L = %5d: all lags (N = %5d) %8.1f us, lags +/- %d (N = %5d) %8.1f us per stream\n",
+         L, pffastconv_xcorr_fft_size(full), 1E6 * (t1 - t0) / CLOCKS_PER_SEC / numStreams,
+         D, pffastconv_xcorr_fft_size(win), 1E6 * (t2 - t1) / CLOCKS_PER_SEC / numStreams);
+  pffastconv_xcorr_destroy(full);
+  pffastconv_xcorr_destroy(win);
+  free(peaks);
+  free(x);
+}
+
+
+int main(int argc, char **argv)
+{
+  static const float one[1] = { 1.0f };
+  int ret = 0, t;
+
+  if (argc > 1 && !strcmp(argv[1], "--bench")) {
+    bench_xcorr(4096, 64, 1000);
+    bench_xcorr(16384, 256, 250);
+    return 0;
+  }
+
+  for (t = 0; t < 2; ++t) {
+    const pffft_transform_t transform = (t == 0) ? PFFFT_REAL : PFFFT_COMPLEX;
+    ret |= test_peaks(100, 1000, -100000, 100000, transform);   /* all lags */
+    ret |= test_peaks(500, 500, -40, 40, transform);            /* TDOA: equal lengths, small window */
+    ret |= test_peaks(64, 700, 10, 300, transform);             /* positive lags only */
+    ret |= test_peaks(300, 200, -250, -20, transform);          /* negative lags only */
+    ret |= test_interpolation(transform);
+  }
+
+  /* unsuitable parameters: no reference, empty lag window */
+  if (pffastconv_xcorr_new(NULL, 1, 100, 0, 10, PFFFT_REAL) || pffastconv_xcorr_new(one, 1, 100, 200, 300, PFFFT_REAL)) {
+    printf("pffastconv_xcorr_new() should fail without reference or for an empty lag window!\n");
+    ret = 1;
+  }
+
+  printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+  return ret;
+}
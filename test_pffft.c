@@ -75,6 +75,16 @@ typedef double pffft_scalar;
 
 int test(int N, int cplx, int useOrdered) {
   int Nfloat = (cplx ? N*2 : N);
+#ifdef PFFFT_ENABLE_FLOAT
+  const int Nmin = pffft_min_fft_size(cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+#else
+  const int Nmin = pffftd_min_fft_size(cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+#endif
+  if (N < Nmin) {
+    /* wider SIMD vectors raise the minimum transform size */
+    printf("skipping %s fft of size %d: minimum size is %d\n", (cplx ? "complex" : "real"), N, Nmin);
+    return 0;
+  }
 #ifdef PFFFT_ENABLE_FLOAT
   pffft_scalar *X = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
   pffft_scalar *Y = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
@@ -265,6 +275,1218 @@ int test(int N, int cplx, int useOrdered) {
   return retError;
 }
 
+/* compare pffft_transform_batch() and pffft_transform_pair() against single transforms:
+   results have to be identical */
+int test_batch(int N, int cplx, int useOrdered) {
+  const int count = 3;
+  const int Nfloat = (cplx ? N*2 : N);
+  const int stride = Nfloat + 64;  /* keeps alignment of each transform */
+  const int Ntotal = count * stride;
+#ifdef PFFFT_ENABLE_FLOAT
+  const int Nmin = pffft_min_fft_size(cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+#else
+  const int Nmin = pffftd_min_fft_size(cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+#endif
+  pffft_scalar *X, *Y, *Z, *R, *W;
+  int k, c, dir, inplace, retError = 0;
+  if (N < Nmin)
+    return 0;
+
+#ifdef PFFFT_ENABLE_FLOAT
+  PFFFT_Setup *s = pffft_new_setup(N, cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+  X = pffft_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  Y = pffft_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  Z = pffft_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  R = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  W = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+#else
+  PFFFTD_Setup *s = pffftd_new_setup(N, cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+  X = pffftd_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  Y = pffftd_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  Z = pffftd_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  R = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  W = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+#endif
+  assert(s);
+
+  for (k = 0; k < Ntotal; ++k)
+    X[k] = (pffft_scalar)( (((long long)k * 7919) % 1000) / 500.0 - 1.0 );
+
+  for (dir = 0; dir < 2; ++dir) {
+    pffft_direction_t direction = (dir == 0 ? PFFFT_FORWARD : PFFFT_BACKWARD);
+    /* with and without work memory */
+#ifdef PFFFT_ENABLE_FLOAT
+    if (useOrdered) {
+      pffft_transform_ordered_batch(s, count, X, stride, Y, stride, W, direction);
+      pffft_transform_ordered_batch(s, count, X, stride, Z, stride, NULL, direction);
+    } else {
+      pffft_transform_batch(s, count, X, stride, Y, stride, W, direction);
+      pffft_transform_batch(s, count, X, stride, Z, stride, NULL, direction);
+    }
+#else
+    if (useOrdered) {
+      pffftd_transform_ordered_batch(s, count, X, stride, Y, stride, W, direction);
+      pffftd_transform_ordered_batch(s, count, X, stride, Z, stride, NULL, direction);
+    } else {
+      pffftd_transform_batch(s, count, X, stride, Y, stride, W, direction);
+      pffftd_transform_batch(s, count, X, stride, Z, stride, NULL, direction);
+    }
+#endif
+    for (c = 0; c < count; ++c) {
+#ifdef PFFFT_ENABLE_FLOAT
+      if (useOrdered)
+        pffft_transform_ordered(s, X + c*stride, R, W, direction);
+      else
+        pffft_transform(s, X + c*stride, R, W, direction);
+#else
+      if (useOrdered)
+        pffftd_transform_ordered(s, X + c*stride, R, W, direction);
+      else
+        pffftd_transform(s, X + c*stride, R, W, direction);
+#endif
+      for (k = 0; k < Nfloat; ++k) {
+        if (Y[c*stride + k] != R[k] || Z[c*stride + k] != R[k]) {
+          printf("%s %s batch %s fft of size %d: transform %d differs at %d\n",
+                 (useOrdered ? "ordered" : "unordered"), (dir == 0 ? "forward" : "backward"),
+                 (cplx ? "complex" : "real"), N, c, k);
+          retError = 1;
+          break;
+        }
+      }
+    }
+
+    /* a pair of transforms without a common stride: 0 and 2 into Y and Z -
+       also with b in-place (in Z), while a is not */
+    for (inplace = 0; inplace < 2; ++inplace) {
+      const pffft_scalar *Xb = X + 2*stride;
+      if (inplace) {
+        memcpy(Z + stride, Xb, (size_t)Nfloat * sizeof(pffft_scalar));
+        Xb = Z + stride;
+      }
+#ifdef PFFFT_ENABLE_FLOAT
+      if (useOrdered)
+        pffft_transform_ordered_pair(s, X, Xb, Y, Z + stride, W, direction);
+      else
+        pffft_transform_pair(s, X, Xb, Y, Z + stride, W, direction);
+#else
+      if (useOrdered)
+        pffftd_transform_ordered_pair(s, X, Xb, Y, Z + stride, W, direction);
+      else
+        pffftd_transform_pair(s, X, Xb, Y, Z + stride, W, direction);
+#endif
+      for (c = 0; c < count; c += 2) {
+        const pffft_scalar *P = (c == 0) ? Y : Z + stride;
+#ifdef PFFFT_ENABLE_FLOAT
+        if (useOrdered)
+          pffft_transform_ordered(s, X + c*stride, R, W, direction);
+        else
+          pffft_transform(s, X + c*stride, R, W, direction);
+#else
+        if (useOrdered)
+          pffftd_transform_ordered(s, X + c*stride, R, W, direction);
+        else
+          pffftd_transform(s, X + c*stride, R, W, direction);
+#endif
+        for (k = 0; k < Nfloat; ++k) {
+          if (P[k] != R[k]) {
+            printf("%s %s pair%s %s fft of size %d: transform %d differs at %d\n",
+                   (useOrdered ? "ordered" : "unordered"), (dir == 0 ? "forward" : "backward"),
+                   (inplace ? ", b in-place," : ""), (cplx ? "complex" : "real"), N, c, k);
+            retError = 1;
+            break;
+          }
+        }
+      }
+    }
+  }
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_destroy_setup(s);
+  pffft_aligned_free(X);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(Z);
+  pffft_aligned_free(R);
+  pffft_aligned_free(W);
+#else
+  pffftd_destroy_setup(s);
+  pffftd_aligned_free(X);
+  pffftd_aligned_free(Y);
+  pffftd_aligned_free(Z);
+  pffftd_aligned_free(R);
+  pffftd_aligned_free(W);
+#endif
+  return retError;
+}
+
+#ifdef PFFFT_ENABLE_FLOAT
+
+/* FP16/BF16 conversion: all 16-bit patterns round trip, halfway cases round to even.
+   bulk conversions (vectorized) have to agree with single values (scalar) */
+int test_half_conversion() {
+  const int n = 65536;
+  unsigned short *H = (unsigned short*)malloc(n * sizeof(unsigned short));
+  unsigned short *G = (unsigned short*)malloc(n * sizeof(unsigned short));
+  float *F = (float*)malloc(n * sizeof(float));
+  union { unsigned u; float f; } b;
+  int fmt, k, retError = 0;
+
+  for (fmt = 0; fmt < 2; ++fmt) {
+    const pffft_half_t format = (fmt == 0) ? PFFFT_HALF_FP16 : PFFFT_HALF_BF16;
+    const unsigned exp_mask = (fmt == 0) ? 0x7c00 : 0x7f80;
+    int errs = 0;
+    for (k = 0; k < n; ++k)
+      H[k] = (unsigned short)k;
+    pffft_half_to_float(format, H, F, n);
+    pffft_float_to_half(format, F, G, n);
+    for (k = 0; k < n; ++k) {
+      float f1;
+      unsigned short g1;
+      const int isnan = ( (k & exp_mask) == exp_mask && (k & ~exp_mask & 0x7fff) != 0 );
+      pffft_half_to_float(format, H + k, &f1, 1);
+      pffft_float_to_half(format, &f1, &g1, 1);
+      if (isnan) {
+        if ( f1 == f1 || (G[k] & exp_mask) != exp_mask || (G[k] & ~exp_mask & 0x7fff) == 0 )
+          ++errs;
+      }
+      else if ( G[k] != H[k] || g1 != H[k] || f1 != F[k] )
+        ++errs;
+    }
+
+    /* halfway between two neighbouring finite values */
+    for (k = 0; k + 1 < (int)exp_mask; ++k) {
+      float m;
+      unsigned short g1;
+      if (fmt == 0)
+        m = 0.5f * (F[k] + F[k+1]);
+      else {
+        b.u = ((unsigned)k << 16) | 0x8000u;
+        m = b.f;
+      }
+      F[k] = m;
+      H[k] = (unsigned short)( (k & 1) ? k + 1 : k );
+      pffft_float_to_half(format, &m, &g1, 1);
+      if (g1 != H[k])
+        ++errs;
+    }
+    pffft_float_to_half(format, F, G, (int)exp_mask - 1);
+    for (k = 0; k + 1 < (int)exp_mask; ++k) {
+      if (G[k] != H[k])
+        ++errs;
+    }
+    if (errs) {
+      printf("%s conversion: %d errors!\n", (fmt == 0 ? "FP16" : "BF16"), errs);
+      retError = 1;
+    }
+  }
+  if (!retError)
+    printf("FP16/BF16 conversion successful\n");
+  free(H);
+  free(G);
+  free(F);
+  return retError;
+}
+
+/* pffft_transform_half() against the float transform of the same 16-bit input values */
+int test_half(int N, int cplx, int useOrdered) {
+  const int count = 3;
+  const int Nfloat = (cplx ? N*2 : N);
+  const int stride = Nfloat + 3;  /* no alignment needed */
+  const int Ntotal = count * stride;
+  const int Nmin = pffft_min_fft_size(cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+  unsigned short *H, *Y;
+  float *X, *R, *W;
+  PFFFT_Setup *s;
+  int k, c, fmt, dir, retError = 0;
+  if (N < Nmin)
+    return 0;
+
+  s = pffft_new_setup(N, cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+  assert(s);
+  H = (unsigned short*)malloc((unsigned)Ntotal * sizeof(unsigned short));
+  Y = (unsigned short*)malloc((unsigned)Ntotal * sizeof(unsigned short));
+  X = pffft_aligned_malloc((unsigned)Nfloat * sizeof(float));
+  R = pffft_aligned_malloc((unsigned)Nfloat * sizeof(float));
+  W = pffft_aligned_malloc(2 * (unsigned)Nfloat * sizeof(float));
+
+  for (fmt = 0; fmt < 2; ++fmt) {
+    const pffft_half_t format = (fmt == 0) ? PFFFT_HALF_FP16 : PFFFT_HALF_BF16;
+    /* rounding of the output: 2^-11 (FP16) and 2^-8 (BF16) relative to each value */
+    const float tol = (fmt == 0) ? 1E-3f : 8E-3f;
+    for (k = 0; k < Ntotal; ++k) {
+      const float v = (float)( (((long long)k * 7919) % 1000) / 500.0 - 1.0 );
+      pffft_float_to_half(format, &v, H + k, 1);
+    }
+    for (dir = 0; dir < 2; ++dir) {
+      const pffft_direction_t direction = (dir == 0 ? PFFFT_FORWARD : PFFFT_BACKWARD);
+      int work;
+      for (work = 0; work < 3; ++work) {
+        /* with and without work memory - and in-place */
+        unsigned short *out = (work == 2) ? H : Y;
+        if (work == 2)
+          memcpy(Y, H, (unsigned)Ntotal * sizeof(unsigned short));
+        if (useOrdered)
+          pffft_transform_ordered_half(s, format, count, H, stride, out, stride, (work == 1 ? W : NULL), direction);
+        else
+          pffft_transform_half(s, format, count, H, stride, out, stride, (work == 1 ? W : NULL), direction);
+        for (c = 0; c < count; ++c) {
+          float maxR = 0.0f, maxErr = 0.0f;
+          pffft_half_to_float(format, (work == 2 ? Y : H) + c*stride, X, Nfloat);
+          if (useOrdered)
+            pffft_transform_ordered(s, X, R, NULL, direction);
+          else
+            pffft_transform(s, X, R, NULL, direction);
+          pffft_half_to_float(format, out + c*stride, X, Nfloat);
+          for (k = 0; k < Nfloat; ++k) {
+            const float e = fabsf(X[k] - R[k]);
+            maxR = (fabsf(R[k]) > maxR) ? fabsf(R[k]) : maxR;
+            maxErr = (e > maxErr) ? e : maxErr;
+          }
+          if (maxErr > tol * maxR) {
+            printf("%s %s %s %s fft of size %d: transform %d error %g (relative to %g)!\n",
+                   (fmt == 0 ? "FP16" : "BF16"), (useOrdered ? "ordered" : "unordered"),
+                   (dir == 0 ? "forward" : "backward"), (cplx ? "complex" : "real"), N, c, maxErr, maxR);
+            retError = 1;
+          }
+        }
+        if (work == 2)
+          memcpy(H, Y, (unsigned)Ntotal * sizeof(unsigned short));
+      }
+    }
+  }
+
+  pffft_destroy_setup(s);
+  free(H);
+  free(Y);
+  pffft_aligned_free(X);
+  pffft_aligned_free(R);
+  pffft_aligned_free(W);
+  return retError;
+}
+
+#endif
+
+/* setup cache: shared setups, reference counting and eviction */
+int test_setup_cache(int N) {
+  size_t bytes;
+  int retError = 0;
+#ifdef PFFFT_ENABLE_FLOAT
+  PFFFT_Setup *s1, *s2, *s3;
+  pffft_clear_setup_cache();
+  s1 = pffft_acquire_setup(N, PFFFT_REAL);
+  s2 = pffft_acquire_setup(N, PFFFT_REAL);
+  s3 = pffft_acquire_setup(N, PFFFT_COMPLEX);
+#else
+  PFFFTD_Setup *s1, *s2, *s3;
+  pffftd_clear_setup_cache();
+  s1 = pffftd_acquire_setup(N, PFFFT_REAL);
+  s2 = pffftd_acquire_setup(N, PFFFT_REAL);
+  s3 = pffftd_acquire_setup(N, PFFFT_COMPLEX);
+#endif
+
+  if (!s1 || s1 != s2 || !s3 || s3 == s1) {
+    printf("setup cache for size %d: repeated requests don't deliver the shared setup!\n", N);
+    retError = 1;
+  }
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_release_setup(s1);
+  pffft_release_setup(s2);
+  pffft_release_setup(s3);
+  bytes = pffft_setup_cache_bytes();
+  /* released setups stay in the cache */
+  s1 = pffft_acquire_setup(N, PFFFT_REAL);
+  if (s1 != s2 || pffft_setup_cache_bytes() != bytes)
+    retError = 1;
+  /* the released complex setup doesn't fit the limit - the referenced one stays */
+  pffft_set_setup_cache_limit(1);
+  if (pffft_setup_cache_bytes() == 0 || pffft_setup_cache_bytes() == bytes)
+    retError = 1;
+  pffft_release_setup(s1);
+  if (pffft_setup_cache_bytes() != 0)
+    retError = 1;
+  if (pffft_acquire_setup(N+1, PFFFT_REAL) != NULL)
+    retError = 1;
+  pffft_set_setup_cache_limit((size_t)-1);
+#else
+  pffftd_release_setup(s1);
+  pffftd_release_setup(s2);
+  pffftd_release_setup(s3);
+  bytes = pffftd_setup_cache_bytes();
+  s1 = pffftd_acquire_setup(N, PFFFT_REAL);
+  if (s1 != s2 || pffftd_setup_cache_bytes() != bytes)
+    retError = 1;
+  pffftd_set_setup_cache_limit(1);
+  if (pffftd_setup_cache_bytes() == 0 || pffftd_setup_cache_bytes() == bytes)
+    retError = 1;
+  pffftd_release_setup(s1);
+  if (pffftd_setup_cache_bytes() != 0)
+    retError = 1;
+  if (pffftd_acquire_setup(N+1, PFFFT_REAL) != NULL)
+    retError = 1;
+  pffftd_set_setup_cache_limit((size_t)-1);
+#endif
+  if (retError)
+    printf("setup cache for size %d: failed!\n", N);
+  else
+    printf("setup cache for size %d successful\n", N);
+  return retError;
+}
+
+/* serialized setups - copied and zero-copy - have to deliver identical results */
+int test_serialize(int Nrows, int N, int cplx) {
+  const int Nfloat = Nrows * (cplx ? N*2 : N);
+  pffft_scalar *X, *Y, *Z;
+  unsigned char *blob;
+  size_t blobSize;
+  int k, zero_copy, retError = 0;
+#ifdef PFFFT_ENABLE_FLOAT
+  PFFFT_Setup *s = pffft_new_setup_2d(Nrows, N, cplx ? PFFFT_COMPLEX : PFFFT_REAL), *sd;
+  blobSize = pffft_serialized_size(s);
+  blob = (unsigned char*)pffft_aligned_malloc(blobSize);
+  X = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Y = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  if (pffft_serialize_setup(s, blob, blobSize - 1) != 0 || pffft_serialize_setup(s, blob, blobSize) != blobSize)
+    retError = 1;
+#else
+  PFFFTD_Setup *s = pffftd_new_setup_2d(Nrows, N, cplx ? PFFFT_COMPLEX : PFFFT_REAL), *sd;
+  blobSize = pffftd_serialized_size(s);
+  blob = (unsigned char*)pffftd_aligned_malloc(blobSize);
+  X = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Y = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  if (pffftd_serialize_setup(s, blob, blobSize - 1) != 0 || pffftd_serialize_setup(s, blob, blobSize) != blobSize)
+    retError = 1;
+#endif
+  for (k = 0; k < Nfloat; ++k)
+    X[k] = (pffft_scalar)( ((k * 7919) % 1000) / 500.0 - 1.0 );
+
+  for (zero_copy = 0; zero_copy < 2; ++zero_copy) {
+#ifdef PFFFT_ENABLE_FLOAT
+    sd = pffft_deserialize_setup(blob, blobSize, zero_copy);
+    if (!sd) { retError = 1; break; }
+    pffft_transform_ordered(s, X, Y, NULL, PFFFT_FORWARD);
+    pffft_transform_ordered(sd, X, Z, NULL, PFFFT_FORWARD);
+    pffft_destroy_setup(sd);
+#else
+    sd = pffftd_deserialize_setup(blob, blobSize, zero_copy);
+    if (!sd) { retError = 1; break; }
+    pffftd_transform_ordered(s, X, Y, NULL, PFFFT_FORWARD);
+    pffftd_transform_ordered(sd, X, Z, NULL, PFFFT_FORWARD);
+    pffftd_destroy_setup(sd);
+#endif
+    if (memcmp(Y, Z, (unsigned)Nfloat * sizeof(pffft_scalar)))
+      retError = 1;
+  }
+
+  /* other versions, truncated or misaligned (zero-copy) blobs are rejected */
+  blob[4] ^= 1;
+#ifdef PFFFT_ENABLE_FLOAT
+  if (pffft_deserialize_setup(blob, blobSize, 0)) retError = 1;
+  blob[4] ^= 1;
+  if (pffft_deserialize_setup(blob, blobSize - 1, 0)) retError = 1;
+  memmove(blob + 16, blob, blobSize - 16);
+  if (pffft_deserialize_setup(blob + 16, blobSize - 16, 1)) retError = 1;
+  pffft_destroy_setup(s);
+  pffft_aligned_free(blob);
+  pffft_aligned_free(X);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(Z);
+#else
+  if (pffftd_deserialize_setup(blob, blobSize, 0)) retError = 1;
+  blob[4] ^= 1;
+  if (pffftd_deserialize_setup(blob, blobSize - 1, 0)) retError = 1;
+  memmove(blob + 16, blob, blobSize - 16);
+  if (pffftd_deserialize_setup(blob + 16, blobSize - 16, 1)) retError = 1;
+  pffftd_destroy_setup(s);
+  pffftd_aligned_free(blob);
+  pffftd_aligned_free(X);
+  pffftd_aligned_free(Y);
+  pffftd_aligned_free(Z);
+#endif
+  printf("serialized %s setup of size %d x %d %s\n", (cplx ? "complex" : "real"), Nrows, N,
+         retError ? "FAILED!" : "successful");
+  return retError;
+}
+
+/* sizes with factors 7, 11, 13 - and any other size with Bluestein's algorithm:
+   compare ordered output against a DFT in double, check the round trip of the
+   unordered transform and a cyclic shift by one with zconvolve */
+int test_any_size(int N, int cplx) {
+  const pffft_transform_t transform = cplx ? PFFFT_COMPLEX : PFFFT_REAL;
+  const int Nfloat = (cplx ? N*2 : N);
+  const double tol = (sizeof(pffft_scalar) == sizeof(float) ? 1E-5 : 1E-12);
+  pffft_scalar *X, *Y, *Z, *D, *W;
+  double err = 0.0, pwr = 0.0, errRT = 0.0, errShift = 0.0;
+  int k, n, retError = 0;
+#ifdef PFFFT_ENABLE_FLOAT
+  PFFFT_Setup *s = pffft_new_setup(N, transform);
+  X = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Y = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  D = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+#else
+  PFFFTD_Setup *s = pffftd_new_setup(N, transform);
+  X = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Y = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  D = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+#endif
+  if (!s) {
+    printf("%s fft of size %d: setup failed!\n", (cplx ? "complex" : "real"), N);
+    return 1;
+  }
+  /* the round trip with 'work' - the other transforms allocate it */
+#ifdef PFFFT_ENABLE_FLOAT
+  W = pffft_aligned_malloc((unsigned)pffft_work_size(s) * sizeof(pffft_scalar));
+#else
+  W = pffftd_aligned_malloc((unsigned)pffftd_work_size(s) * sizeof(pffft_scalar));
+#endif
+
+  for (k = 0; k < Nfloat; ++k) {
+    X[k] = (pffft_scalar)( ((k * 7919) % 1000) / 500.0 - 1.0 );
+    D[k] = (pffft_scalar)( k == (cplx ? 2 : 1) % Nfloat ? 1.0 : 0.0 );  /* delay by one sample */
+  }
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_transform_ordered(s, X, Y, NULL, PFFFT_FORWARD);
+#else
+  pffftd_transform_ordered(s, X, Y, NULL, PFFFT_FORWARD);
+#endif
+  for (k = 0; k < (cplx ? N : N/2 + 1); ++k) {
+    double re = 0.0, im = 0.0, yr, yi;
+    for (n = 0; n < N; ++n) {
+      const double phi = -2.0 * M_PI * (double)(((long long)k * n) % N) / N;
+      const double xr = (cplx ? X[2*n] : X[n]), xi = (cplx ? X[2*n+1] : 0.0);
+      re += xr * cos(phi) - xi * sin(phi);
+      im += xr * sin(phi) + xi * cos(phi);
+    }
+    if (cplx || (k > 0 && 2*k < N)) {
+      yr = Y[2*k];  yi = Y[2*k+1];
+    } else {
+      yr = Y[k ? 1 : 0];  yi = 0.0;
+    }
+    err += (yr - re) * (yr - re) + (yi - im) * (yi - im);
+    pwr += re * re + im * im;
+  }
+  err = sqrt(err / pwr);
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_transform(s, X, Y, W, PFFFT_FORWARD);
+  pffft_transform(s, Y, Z, W, PFFFT_BACKWARD);
+#else
+  pffftd_transform(s, X, Y, W, PFFFT_FORWARD);
+  pffftd_transform(s, Y, Z, W, PFFFT_BACKWARD);
+#endif
+  for (k = 0; k < Nfloat; ++k)
+    errRT += (Z[k] / N - X[k]) * (Z[k] / N - X[k]);
+  errRT = sqrt(errRT / Nfloat);
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_transform(s, D, Z, NULL, PFFFT_FORWARD);
+  pffft_zconvolve_no_accu(s, Y, Z, D, (pffft_scalar)(1.0 / N));
+  pffft_transform(s, D, Z, NULL, PFFFT_BACKWARD);
+#else
+  pffftd_transform(s, D, Z, NULL, PFFFT_FORWARD);
+  pffftd_zconvolve_no_accu(s, Y, Z, D, (pffft_scalar)(1.0 / N));
+  pffftd_transform(s, D, Z, NULL, PFFFT_BACKWARD);
+#endif
+  for (k = 0; k < Nfloat; ++k) {
+    const int m = (k + Nfloat - (cplx ? 2 : 1)) % Nfloat;
+    errShift += (Z[k] - X[m]) * (Z[k] - X[m]);
+  }
+  errShift = sqrt(errShift / Nfloat);
+
+  if (err > tol || errRT > tol || errShift > tol)
+    retError = 1;
+  printf("%s fft of size %d: relative error %g, round trip %g, zconvolve %g: %s\n",
+         (cplx ? "complex" : "real"), N, err, errRT, errShift, retError ? "FAILED!" : "successful");
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_destroy_setup(s);
+  pffft_aligned_free(X);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(Z);
+  pffft_aligned_free(D);
+  pffft_aligned_free(W);
+#else
+  pffftd_destroy_setup(s);
+  pffftd_aligned_free(X);
+  pffftd_aligned_free(Y);
+  pffftd_aligned_free(Z);
+  pffftd_aligned_free(D);
+  pffftd_aligned_free(W);
+#endif
+  return retError;
+}
+
+/* a zero-phase kernel has a real valued spectrum: the multiplication with its
+   packed real parts has to match the one with the complete spectrum */
+int test_zconvolve_real(int N, int cplx) {
+  const pffft_transform_t transform = cplx ? PFFFT_COMPLEX : PFFFT_REAL;
+  const int Nfloat = (cplx ? N*2 : N);
+  pffft_scalar *X, *B, *R, *Y, *Z;
+  double err = 0.0, pwr = 0.0;
+  int k, n, retError = 0;
+#ifdef PFFFT_ENABLE_FLOAT
+  PFFFT_Setup *s;
+  int Nreal;
+  if (!pffft_is_valid_size(N, transform))
+    return 0;  /* not for Bluestein sizes */
+  s = pffft_new_setup(N, transform);
+  Nreal = Nfloat / 2 + pffft_simd_size();
+  X = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  B = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  R = pffft_aligned_malloc((unsigned)Nreal * sizeof(pffft_scalar));
+  Y = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+#else
+  PFFFTD_Setup *s;
+  int Nreal;
+  if (!pffftd_is_valid_size(N, transform))
+    return 0;  /* not for Bluestein sizes */
+  s = pffftd_new_setup(N, transform);
+  Nreal = Nfloat / 2 + pffftd_simd_size();
+  X = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  B = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  R = pffftd_aligned_malloc((unsigned)Nreal * sizeof(pffft_scalar));
+  Y = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+#endif
+
+  memset(B, 0, (unsigned)Nfloat * sizeof(pffft_scalar));
+  for (k = 0; k < Nfloat; ++k)
+    X[k] = (pffft_scalar)( ((k * 7919) % 1000) / 500.0 - 1.0 );
+  for (n = 0; n < 8; ++n) {  /* b[n] == b[N-n] */
+    const pffft_scalar v = (pffft_scalar)( 1.0 / (1 + n) );
+    B[(cplx ? 2 : 1) * n] = v;
+    B[(cplx ? 2 : 1) * ((N - n) % N)] = v;
+  }
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_transform(s, X, X, NULL, PFFFT_FORWARD);
+  pffft_transform(s, B, B, NULL, PFFFT_FORWARD);
+  pffft_zreal_pack(s, B, R);
+  pffft_zconvolve_no_accu(s, X, B, Y, 0.5f);
+  pffft_zconvolve_accumulate(s, X, B, Y, 0.25f);
+  pffft_zconvolve_real_no_accu(s, X, R, Z, 0.5f);
+  pffft_zconvolve_real_accumulate(s, X, R, Z, 0.25f);
+#else
+  pffftd_transform(s, X, X, NULL, PFFFT_FORWARD);
+  pffftd_transform(s, B, B, NULL, PFFFT_FORWARD);
+  pffftd_zreal_pack(s, B, R);
+  pffftd_zconvolve_no_accu(s, X, B, Y, 0.5);
+  pffftd_zconvolve_accumulate(s, X, B, Y, 0.25);
+  pffftd_zconvolve_real_no_accu(s, X, R, Z, 0.5);
+  pffftd_zconvolve_real_accumulate(s, X, R, Z, 0.25);
+#endif
+  for (k = 0; k < Nfloat; ++k) {
+    err += (Z[k] - Y[k]) * (Z[k] - Y[k]);
+    pwr += Y[k] * Y[k];
+  }
+  err = sqrt(err / pwr);
+  if (err > (sizeof(pffft_scalar) == sizeof(float) ? 1E-6 : 1E-14))
+    retError = 1;
+  printf("%s fft of size %d: zconvolve with packed real spectrum: relative error %g: %s\n",
+         (cplx ? "complex" : "real"), N, err, retError ? "FAILED!" : "successful");
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_destroy_setup(s);
+  pffft_aligned_free(X);
+  pffft_aligned_free(B);
+  pffft_aligned_free(R);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(Z);
+#else
+  pffftd_destroy_setup(s);
+  pffftd_aligned_free(X);
+  pffftd_aligned_free(B);
+  pffftd_aligned_free(R);
+  pffftd_aligned_free(Y);
+  pffftd_aligned_free(Z);
+#endif
+  return retError;
+}
+
+/* the fused multiplication and backward transform has to match
+   zconvolve_no_accu() followed by the backward transform - also in-place into dft_a */
+int test_zconvolve_transform_backward(int N, int cplx) {
+  const pffft_transform_t transform = cplx ? PFFFT_COMPLEX : PFFFT_REAL;
+  const int Nfloat = (cplx ? N*2 : N);
+  pffft_scalar *X, *B, *Y, *Z, *W;
+  double err = 0.0, errInp = 0.0, pwr = 0.0;
+  int k, retError = 0;
+#ifdef PFFFT_ENABLE_FLOAT
+  PFFFT_Setup *s = pffft_new_setup(N, transform);
+  X = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  B = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Y = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  W = pffft_aligned_malloc((unsigned)pffft_work_size(s) * sizeof(pffft_scalar));
+#else
+  PFFFTD_Setup *s = pffftd_new_setup(N, transform);
+  X = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  B = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Y = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  W = pffftd_aligned_malloc((unsigned)pffftd_work_size(s) * sizeof(pffft_scalar));
+#endif
+
+  for (k = 0; k < Nfloat; ++k) {
+    X[k] = (pffft_scalar)( ((k * 7919) % 1000) / 500.0 - 1.0 );
+    B[k] = (pffft_scalar)( ((k * 104729) % 997) / 498.5 - 1.0 );
+  }
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_transform(s, X, X, NULL, PFFFT_FORWARD);
+  pffft_transform(s, B, B, NULL, PFFFT_FORWARD);
+  pffft_zconvolve_no_accu(s, X, B, Y, 0.5f);
+  pffft_transform(s, Y, Y, W, PFFFT_BACKWARD);
+  pffft_zconvolve_transform_backward(s, X, B, Z, W, 0.5f);
+#else
+  pffftd_transform(s, X, X, NULL, PFFFT_FORWARD);
+  pffftd_transform(s, B, B, NULL, PFFFT_FORWARD);
+  pffftd_zconvolve_no_accu(s, X, B, Y, 0.5);
+  pffftd_transform(s, Y, Y, W, PFFFT_BACKWARD);
+  pffftd_zconvolve_transform_backward(s, X, B, Z, W, 0.5);
+#endif
+  for (k = 0; k < Nfloat; ++k) {
+    err += (Z[k] - Y[k]) * (Z[k] - Y[k]);
+    pwr += Y[k] * Y[k];
+  }
+
+  /* output aliasing dft_a - without work */
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_zconvolve_transform_backward(s, X, B, X, NULL, 0.5f);
+#else
+  pffftd_zconvolve_transform_backward(s, X, B, X, NULL, 0.5);
+#endif
+  for (k = 0; k < Nfloat; ++k)
+    errInp += (X[k] - Y[k]) * (X[k] - Y[k]);
+
+  err = sqrt(err / pwr);
+  errInp = sqrt(errInp / pwr);
+  if (err > (sizeof(pffft_scalar) == sizeof(float) ? 1E-6 : 1E-14) || errInp > (sizeof(pffft_scalar) == sizeof(float) ? 1E-6 : 1E-14))
+    retError = 1;
+  printf("%s fft of size %d: zconvolve_transform_backward: relative error %g, in-place %g: %s\n",
+         (cplx ? "complex" : "real"), N, err, errInp, retError ? "FAILED!" : "successful");
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_destroy_setup(s);
+  pffft_aligned_free(X);
+  pffft_aligned_free(B);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(Z);
+  pffft_aligned_free(W);
+#else
+  pffftd_destroy_setup(s);
+  pffftd_aligned_free(X);
+  pffftd_aligned_free(B);
+  pffftd_aligned_free(Y);
+  pffftd_aligned_free(Z);
+  pffftd_aligned_free(W);
+#endif
+  return retError;
+}
+
+/* pffft_zpower() of the unordered spectrum against the power of the ordered spectrum */
+int test_zpower(int N, int cplx) {
+  const int Nfloat = (cplx ? N*2 : N);
+  const int nbins = (cplx ? N : N/2 + 1);
+  pffft_scalar *X, *Y, *Z, *P;
+  double maxErr = 0.0, maxP = 0.0;
+  int k, retError = 0;
+#ifdef PFFFT_ENABLE_FLOAT
+  PFFFT_Setup *s = pffft_new_setup(N, cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+  X = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Y = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+#else
+  PFFFTD_Setup *s = pffftd_new_setup(N, cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+  X = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Y = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+#endif
+  /* unaligned output */
+  P = (pffft_scalar*)malloc((unsigned)(nbins + 1) * sizeof(pffft_scalar));
+  assert(s);
+  for (k = 0; k < Nfloat; ++k)
+    X[k] = (pffft_scalar)( ((k * 7919) % 1000) / 500.0 - 1.0 );
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_transform(s, X, Y, NULL, PFFFT_FORWARD);
+  pffft_zreorder(s, Y, Z, PFFFT_FORWARD);
+  pffft_zpower(s, Y, P + 1);
+#else
+  pffftd_transform(s, X, Y, NULL, PFFFT_FORWARD);
+  pffftd_zreorder(s, Y, Z, PFFFT_FORWARD);
+  pffftd_zpower(s, Y, P + 1);
+#endif
+  for (k = 0; k < nbins; ++k) {
+    double ref;
+    if (!cplx && k == 0)
+      ref = (double)Z[0] * Z[0];
+    else if (!cplx && k == N/2)
+      ref = (double)Z[1] * Z[1];
+    else
+      ref = (double)Z[2*k] * Z[2*k] + (double)Z[2*k+1] * Z[2*k+1];
+    maxP = (ref > maxP) ? ref : maxP;
+    maxErr = (fabs(P[1+k] - ref) > maxErr) ? fabs(P[1+k] - ref) : maxErr;
+  }
+  if (maxErr > 1E-6 * maxP) {
+    printf("zpower of %s fft of size %d: error %g of %g!\n", (cplx ? "complex" : "real"), N, maxErr, maxP);
+    retError = 1;
+  }
+  else
+    printf("zpower of %s fft of size %d successful\n", (cplx ? "complex" : "real"), N);
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_destroy_setup(s);
+  pffft_aligned_free(X);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(Z);
+#else
+  pffftd_destroy_setup(s);
+  pffftd_aligned_free(X);
+  pffftd_aligned_free(Y);
+  pffftd_aligned_free(Z);
+#endif
+  free(P);
+  return retError;
+}
+
+/* the spectral operations on the unordered layout against the same
+   operations on the ordered spectrum, bin by bin - located with pffft_zbin_index() */
+int test_zspectral_ops(int N, int cplx) {
+  const int Nfloat = (cplx ? N*2 : N);
+  const int nbins = (cplx ? N : N/2 + 1);
+  const double delay = 2.375, eps = 0.5;
+  pffft_scalar *X, *B, *Y, *Z, *ZB, *M, *P, *C, *D, *S;
+  int *re, *im, *pk;
+  double maxErr[6] = { 0 }, maxRef = 0.0, maxRefD = 0.0;
+  int k, retError = 0, Nsimd;
+#ifdef PFFFT_ENABLE_FLOAT
+  PFFFT_Setup *s;
+  if (!pffft_is_valid_size(N, cplx ? PFFFT_COMPLEX : PFFFT_REAL))
+    return 0;  /* not for Bluestein sizes */
+  s = pffft_new_setup(N, cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+  Nsimd = pffft_simd_size();
+  X = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  B = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Y = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  ZB = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  M = pffft_aligned_malloc((unsigned)(Nfloat/2 + Nsimd) * sizeof(pffft_scalar));
+  P = pffft_aligned_malloc((unsigned)(Nfloat/2 + Nsimd) * sizeof(pffft_scalar));
+  C = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  D = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  S = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+#else
+  PFFFTD_Setup *s;
+  if (!pffftd_is_valid_size(N, cplx ? PFFFT_COMPLEX : PFFFT_REAL))
+    return 0;  /* not for Bluestein sizes */
+  s = pffftd_new_setup(N, cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+  Nsimd = pffftd_simd_size();
+  X = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  B = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Y = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  ZB = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  M = pffftd_aligned_malloc((unsigned)(Nfloat/2 + Nsimd) * sizeof(pffft_scalar));
+  P = pffftd_aligned_malloc((unsigned)(Nfloat/2 + Nsimd) * sizeof(pffft_scalar));
+  C = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  D = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  S = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+#endif
+  re = (int*)malloc((unsigned)nbins * sizeof(int));
+  im = (int*)malloc((unsigned)nbins * sizeof(int));
+  pk = (int*)malloc((unsigned)nbins * sizeof(int));
+  assert(s);
+  for (k = 0; k < Nfloat; ++k) {
+    X[k] = (pffft_scalar)( ((k * 7919) % 1000) / 500.0 - 1.0 );
+    B[k] = (pffft_scalar)( ((k * 104729) % 997) / 498.5 - 1.0 );
+  }
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_transform(s, X, Y, NULL, PFFFT_FORWARD);
+  pffft_transform(s, B, B, NULL, PFFFT_FORWARD);
+  pffft_zreorder(s, Y, Z, PFFFT_FORWARD);
+  pffft_zreorder(s, B, ZB, PFFFT_FORWARD);
+  pffft_zbin_index(s, re, im, pk);
+  pffft_zmagnitude(s, Y, M);
+  pffft_zphase(s, Y, P);
+  pffft_zconj_multiply(s, Y, B, C, 0.5f);
+  pffft_zdivide(s, Y, B, D, (float)eps);
+  pffft_zdelay(s, Y, S, (float)delay);
+#else
+  pffftd_transform(s, X, Y, NULL, PFFFT_FORWARD);
+  pffftd_transform(s, B, B, NULL, PFFFT_FORWARD);
+  pffftd_zreorder(s, Y, Z, PFFFT_FORWARD);
+  pffftd_zreorder(s, B, ZB, PFFFT_FORWARD);
+  pffftd_zbin_index(s, re, im, pk);
+  pffftd_zmagnitude(s, Y, M);
+  pffftd_zphase(s, Y, P);
+  pffftd_zconj_multiply(s, Y, B, C, 0.5);
+  pffftd_zdivide(s, Y, B, D, eps);
+  pffftd_zdelay(s, Y, S, delay);
+#endif
+  for (k = 0; k < nbins; ++k) {
+    /* X[k] and B[k] from the ordered spectra */
+    const int edge = (!cplx && (k == 0 || k == N/2));
+    const double xr = edge ? Z[k ? 1 : 0] : Z[2*k], xi = edge ? 0.0 : Z[2*k+1];
+    const double br = edge ? ZB[k ? 1 : 0] : ZB[2*k], bi = edge ? 0.0 : ZB[2*k+1];
+    const double kk = (cplx && 2*k >= N) ? k - N : k;
+    const double phi = -2.0 * M_PI * delay * kk / N;
+    const double mag = sqrt(xr*xr + xi*xi), b2 = br*br + bi*bi;
+    double ph, ref[2], e;
+    /* the bin index */
+    if (Y[re[k]] != xr || (edge ? im[k] != -1 : Y[im[k]] != xi))
+      maxErr[0] = 1.0;
+    /* magnitude and phase: the phase error weighted by the magnitude */
+    maxErr[1] = (fabs(M[pk[k]] - mag) > maxErr[1]) ? fabs(M[pk[k]] - mag) : maxErr[1];
+    ph = P[pk[k]] - atan2(xi, xr);
+    ph = fabs(ph - 2.0 * M_PI * floor(ph / (2.0 * M_PI) + 0.5));
+    maxErr[2] = (ph * mag > maxErr[2]) ? ph * mag : maxErr[2];
+    maxRef = (mag > maxRef) ? mag : maxRef;
+    /* cross spectrum */
+    ref[0] = 0.5 * (xr*br + xi*bi);
+    ref[1] = 0.5 * (xi*br - xr*bi);
+    e = fabs(C[re[k]] - ref[0]) + (edge ? 0.0 : fabs(C[im[k]] - ref[1]));
+    maxErr[3] = (e > maxErr[3]) ? e : maxErr[3];
+    maxRefD = (fabs(ref[0]) + fabs(ref[1]) > maxRefD) ? fabs(ref[0]) + fabs(ref[1]) : maxRefD;
+    /* division */
+    ref[0] = (xr*br + xi*bi) / (b2 + eps);
+    ref[1] = (xi*br - xr*bi) / (b2 + eps);
+    e = fabs(D[re[k]] - ref[0]) + (edge ? 0.0 : fabs(D[im[k]] - ref[1]));
+    maxErr[4] = (e > maxErr[4]) ? e : maxErr[4];
+    /* delay */
+    ref[0] = edge ? xr * (k ? cos(M_PI * delay) : 1.0) : xr * cos(phi) - xi * sin(phi);
+    ref[1] = xr * sin(phi) + xi * cos(phi);
+    e = fabs(S[re[k]] - ref[0]) + (edge ? 0.0 : fabs(S[im[k]] - ref[1]));
+    maxErr[5] = (e > maxErr[5]) ? e : maxErr[5];
+  }
+  {
+    const double tol = (sizeof(pffft_scalar) == sizeof(float)) ? 1E-5 : 1E-12;
+    if (maxErr[0] != 0.0 || maxErr[1] > tol * maxRef || maxErr[2] > tol * maxRef || maxErr[3] > tol * maxRefD
+        || maxErr[4] > tol * maxRef || maxErr[5] > tol * maxRef)
+      retError = 1;
+    printf("%s fft of size %d: spectral ops on the unordered layout: errors index %g, magnitude %g, phase %g, "
+           "conj_multiply %g, divide %g, delay %g: %s\n", (cplx ? "complex" : "real"), N,
+           maxErr[0], maxErr[1] / maxRef, maxErr[2] / maxRef, maxErr[3] / maxRefD, maxErr[4] / maxRef,
+           maxErr[5] / maxRef, retError ? "FAILED!" : "successful");
+  }
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_destroy_setup(s);
+  pffft_aligned_free(X);
+  pffft_aligned_free(B);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(Z);
+  pffft_aligned_free(ZB);
+  pffft_aligned_free(M);
+  pffft_aligned_free(P);
+  pffft_aligned_free(C);
+  pffft_aligned_free(D);
+  pffft_aligned_free(S);
+#else
+  pffftd_destroy_setup(s);
+  pffftd_aligned_free(X);
+  pffftd_aligned_free(B);
+  pffftd_aligned_free(Y);
+  pffftd_aligned_free(Z);
+  pffftd_aligned_free(ZB);
+  pffftd_aligned_free(M);
+  pffftd_aligned_free(P);
+  pffftd_aligned_free(C);
+  pffftd_aligned_free(D);
+  pffftd_aligned_free(S);
+#endif
+  free(re);
+  free(im);
+  free(pk);
+  return retError;
+}
+
+/* setup in caller provided memory has to deliver identical results */
+int test_inplace_setup(int N, int cplx) {
+  const pffft_transform_t transform = cplx ? PFFFT_COMPLEX : PFFFT_REAL;
+  const int Nfloat = (cplx ? N*2 : N);
+  pffft_scalar *X, *Y, *Z;
+  char *mem;
+  size_t bytes;
+  int k, retError = 0;
+#ifdef PFFFT_ENABLE_FLOAT
+  PFFFT_Setup *s = pffft_new_setup(N, transform), *si;
+  bytes = pffft_setup_size(N, transform);
+  mem = (char*)pffft_aligned_malloc(bytes + 64);
+  X = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Y = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffft_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  si = pffft_init_setup_inplace(mem, N, transform);
+  if (!bytes || !si || pffft_setup_size(N+1, transform) != 0
+      || pffft_work_size(s) != Nfloat
+      || pffft_init_setup_inplace(mem + 16, N, transform) != NULL)
+    retError = 1;
+#else
+  PFFFTD_Setup *s = pffftd_new_setup(N, transform), *si;
+  bytes = pffftd_setup_size(N, transform);
+  mem = (char*)pffftd_aligned_malloc(bytes + 64);
+  X = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Y = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  Z = pffftd_aligned_malloc((unsigned)Nfloat * sizeof(pffft_scalar));
+  si = pffftd_init_setup_inplace(mem, N, transform);
+  if (!bytes || !si || pffftd_setup_size(N+1, transform) != 0
+      || pffftd_work_size(s) != Nfloat
+      || pffftd_init_setup_inplace(mem + 16, N, transform) != NULL)
+    retError = 1;
+#endif
+  /* mark the bytes behind the setup: they must not be touched */
+  memset(mem + bytes, 0x55, 64);
+#ifdef PFFFT_ENABLE_FLOAT
+  si = pffft_init_setup_inplace(mem, N, transform);
+#else
+  si = pffftd_init_setup_inplace(mem, N, transform);
+#endif
+  for (k = 0; k < Nfloat; ++k)
+    X[k] = (pffft_scalar)( ((k * 7919) % 1000) / 500.0 - 1.0 );
+  if (si) {
+#ifdef PFFFT_ENABLE_FLOAT
+    pffft_transform_ordered(s, X, Y, NULL, PFFFT_FORWARD);
+    pffft_transform_ordered(si, X, Z, NULL, PFFFT_FORWARD);
+    pffft_destroy_setup(si);
+#else
+    pffftd_transform_ordered(s, X, Y, NULL, PFFFT_FORWARD);
+    pffftd_transform_ordered(si, X, Z, NULL, PFFFT_FORWARD);
+    pffftd_destroy_setup(si);
+#endif
+    if (memcmp(Y, Z, (unsigned)Nfloat * sizeof(pffft_scalar)))
+      retError = 1;
+  }
+  for (k = 0; k < 64; ++k)
+    if (mem[bytes + k] != 0x55)
+      retError = 1;
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_destroy_setup(s);
+  pffft_aligned_free(mem);
+  pffft_aligned_free(X);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(Z);
+#else
+  pffftd_destroy_setup(s);
+  pffftd_aligned_free(mem);
+  pffftd_aligned_free(X);
+  pffftd_aligned_free(Y);
+  pffftd_aligned_free(Z);
+#endif
+  printf("in-place %s setup of size %d (%d bytes) %s\n", (cplx ? "complex" : "real"), N, (int)bytes,
+         retError ? "FAILED!" : "successful");
+  return retError;
+}
+
+/* 2D transform: compare ordered output against a (separable) DFT in double,
+   check the round trip and the circular 2D convolution with zconvolve */
+int test_2d(int Nrows, int N, int cplx) {
+  const int Nfloat = (cplx ? N*2 : N);
+  const int Ntotal = Nrows * Nfloat;
+  const int Nspec = (cplx ? N : N/2 + 1);  /* columns of reference spectrum */
+#ifdef PFFFT_ENABLE_FLOAT
+  const double tol = 1E-5;
+  PFFFT_Setup *s = pffft_new_setup_2d(Nrows, N, cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+#else
+  const double tol = 1E-12;
+  PFFFTD_Setup *s = pffftd_new_setup_2d(Nrows, N, cplx ? PFFFT_COMPLEX : PFFFT_REAL);
+#endif
+  pffft_scalar *X, *Y, *Z, *A, *B, *W;
+  double *R, *C, maxAbs = 0.0, maxErr = 0.0, convErr = 0.0;
+  int k, n, r, q, retError = 0;
+
+  if (!s) {
+    printf("2D %s fft of size %d x %d: setup failed!\n", (cplx ? "complex" : "real"), Nrows, N);
+    return 1;
+  }
+#ifdef PFFFT_ENABLE_FLOAT
+  X = pffft_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  Y = pffft_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  Z = pffft_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  A = pffft_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  B = pffft_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  if (pffft_work_size(s) != 2 * Nrows * N) {
+    printf("2D %s fft of size %d x %d: pffft_work_size() = %d, expected %d!\n",
+           (cplx ? "complex" : "real"), Nrows, N, pffft_work_size(s), 2 * Nrows * N);
+    retError = 1;
+  }
+  W = pffft_aligned_malloc((unsigned)pffft_work_size(s) * sizeof(pffft_scalar));
+#else
+  X = pffftd_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  Y = pffftd_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  Z = pffftd_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  A = pffftd_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  B = pffftd_aligned_malloc((unsigned)Ntotal * sizeof(pffft_scalar));
+  if (pffftd_work_size(s) != 2 * Nrows * N) {
+    printf("2D %s fft of size %d x %d: pffftd_work_size() = %d, expected %d!\n",
+           (cplx ? "complex" : "real"), Nrows, N, pffftd_work_size(s), 2 * Nrows * N);
+    retError = 1;
+  }
+  W = pffftd_aligned_malloc((unsigned)pffftd_work_size(s) * sizeof(pffft_scalar));
+#endif
+  R = (double*)malloc(2 * sizeof(double) * Nrows * Nspec);
+  C = (double*)malloc(2 * sizeof(double) * Nrows * Nspec);
+
+  for (k = 0; k < Ntotal; ++k) {
+    X[k] = (pffft_scalar)( ((k * 7919) % 1000) / 500.0 - 1.0 );
+    A[k] = (pffft_scalar)( ((k * 104729) % 997) / 498.5 - 1.0 );
+  }
+
+  /* reference: DFT of the rows, then of the columns */
+  for (r = 0; r < Nrows; ++r) {
+    for (k = 0; k < Nspec; ++k) {
+      double re = 0.0, im = 0.0;
+      for (n = 0; n < N; ++n) {
+        const double phi = -2.0 * M_PI * (double)((long)n * k % N) / N;
+        const double xr = (cplx ? X[r*Nfloat + 2*n] : X[r*Nfloat + n]);
+        const double xi = (cplx ? X[r*Nfloat + 2*n+1] : 0.0);
+        re += xr * cos(phi) - xi * sin(phi);
+        im += xr * sin(phi) + xi * cos(phi);
+      }
+      R[2*(r*Nspec + k)] = re;
+      R[2*(r*Nspec + k)+1] = im;
+    }
+  }
+  for (q = 0; q < Nrows; ++q) {
+    for (k = 0; k < Nspec; ++k) {
+      double re = 0.0, im = 0.0;
+      for (r = 0; r < Nrows; ++r) {
+        const double phi = -2.0 * M_PI * (double)(r * q % Nrows) / Nrows;
+        re += R[2*(r*Nspec + k)] * cos(phi) - R[2*(r*Nspec + k)+1] * sin(phi);
+        im += R[2*(r*Nspec + k)] * sin(phi) + R[2*(r*Nspec + k)+1] * cos(phi);
+      }
+      C[2*(q*Nspec + k)] = re;
+      C[2*(q*Nspec + k)+1] = im;
+      if (fabs(re) > maxAbs) maxAbs = fabs(re);
+      if (fabs(im) > maxAbs) maxAbs = fabs(im);
+    }
+  }
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_transform_ordered(s, X, Y, W, PFFFT_FORWARD);
+#else
+  pffftd_transform_ordered(s, X, Y, W, PFFFT_FORWARD);
+#endif
+  for (q = 0; q < Nrows; ++q) {
+    for (k = 0; k < Nfloat/2; ++k) {
+      double er, ei;   /* expected value of entry k in row q */
+      if (cplx || k > 0) {
+        er = C[2*(q*Nspec + k)];
+        ei = C[2*(q*Nspec + k)+1];
+      } else if (q == 0 || 2*q == Nrows) {
+        er = C[2*(q*Nspec)];
+        ei = C[2*(q*Nspec + N/2)];
+      } else if (2*q < Nrows) {
+        er = C[2*(q*Nspec)];
+        ei = C[2*(q*Nspec)+1];
+      } else {
+        er = C[2*(q*Nspec + N/2)];
+        ei = C[2*(q*Nspec + N/2)+1];
+      }
+      er = fabs(Y[q*Nfloat + 2*k] - er);
+      ei = fabs(Y[q*Nfloat + 2*k+1] - ei);
+      if (er > maxErr) maxErr = er;
+      if (ei > maxErr) maxErr = ei;
+    }
+  }
+  if (maxErr > tol * maxAbs) {
+    printf("2D %s fft of size %d x %d: ordered forward differs from DFT: max err %g of %g\n",
+           (cplx ? "complex" : "real"), Nrows, N, maxErr, maxAbs);
+    retError = 1;
+  }
+
+  /* round trip - in-place without work memory */
+  memcpy(Z, Y, (unsigned)Ntotal * sizeof(pffft_scalar));
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_transform_ordered(s, Z, Z, NULL, PFFFT_BACKWARD);
+#else
+  pffftd_transform_ordered(s, Z, Z, NULL, PFFFT_BACKWARD);
+#endif
+  for (k = 0, maxErr = 0.0; k < Ntotal; ++k) {
+    const double e = fabs(Z[k] / ((double)Nrows * N) - X[k]);
+    if (e > maxErr) maxErr = e;
+  }
+  if (maxErr > 100.0 * tol) {
+    printf("2D %s fft of size %d x %d: backward doesn't match original signal: max err %g\n",
+           (cplx ? "complex" : "real"), Nrows, N, maxErr);
+    retError = 1;
+  }
+
+  /* circular 2D convolution of X and A */
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_transform(s, X, Y, W, PFFFT_FORWARD);
+  pffft_transform(s, A, B, W, PFFFT_FORWARD);
+  memset(Z, 0, (unsigned)Ntotal * sizeof(pffft_scalar));
+  pffft_zconvolve_accumulate(s, Y, B, Z, (pffft_scalar)(0.5 / ((double)Nrows * N)));
+  pffft_zconvolve_accumulate(s, Y, B, Z, (pffft_scalar)(0.5 / ((double)Nrows * N)));
+  pffft_zconvolve_no_accu(s, Y, B, Y, (pffft_scalar)(1.0 / ((double)Nrows * N)));
+  pffft_transform(s, Z, Z, W, PFFFT_BACKWARD);
+  pffft_transform(s, Y, Y, W, PFFFT_BACKWARD);
+#else
+  pffftd_transform(s, X, Y, W, PFFFT_FORWARD);
+  pffftd_transform(s, A, B, W, PFFFT_FORWARD);
+  memset(Z, 0, (unsigned)Ntotal * sizeof(pffft_scalar));
+  pffftd_zconvolve_accumulate(s, Y, B, Z, (pffft_scalar)(0.5 / ((double)Nrows * N)));
+  pffftd_zconvolve_accumulate(s, Y, B, Z, (pffft_scalar)(0.5 / ((double)Nrows * N)));
+  pffftd_zconvolve_no_accu(s, Y, B, Y, (pffft_scalar)(1.0 / ((double)Nrows * N)));
+  pffftd_transform(s, Z, Z, W, PFFFT_BACKWARD);
+  pffftd_transform(s, Y, Y, W, PFFFT_BACKWARD);
+#endif
+  for (q = 0; q < Nrows; ++q) {
+    for (k = 0; k < N; ++k) {
+      double re = 0.0, im = 0.0;
+      for (r = 0; r < Nrows; ++r) {
+        for (n = 0; n < N; ++n) {
+          const int xi = ((q - r + Nrows) % Nrows) * Nfloat, ai = r * Nfloat;
+          const int xn = (k - n + N) % N;
+          if (cplx) {
+            re += X[xi + 2*xn] * (double)A[ai + 2*n] - X[xi + 2*xn+1] * (double)A[ai + 2*n+1];
+            im += X[xi + 2*xn] * (double)A[ai + 2*n+1] + X[xi + 2*xn+1] * (double)A[ai + 2*n];
+          } else
+            re += X[xi + xn] * (double)A[ai + n];
+        }
+      }
+      if (cplx) {
+        const int o = q*Nfloat + 2*k;
+        re = fabs(Z[o] - re) + fabs(Z[o+1] - im) + fabs(Y[o] - re) + fabs(Y[o+1] - im);
+      } else
+        re = fabs(Z[q*Nfloat + k] - re) + fabs(Y[q*Nfloat + k] - re);
+      if (re > convErr) convErr = re;
+    }
+  }
+  if (convErr > 100.0 * tol * sqrt((double)Nrows * N)) {
+    printf("2D %s fft of size %d x %d: zconvolve doesn't match circular convolution: max err %g\n",
+           (cplx ? "complex" : "real"), Nrows, N, convErr);
+    retError = 1;
+  }
+
+#ifdef PFFFT_ENABLE_FLOAT
+  pffft_destroy_setup(s);
+  pffft_aligned_free(X);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(Z);
+  pffft_aligned_free(A);
+  pffft_aligned_free(B);
+  pffft_aligned_free(W);
+#else
+  pffftd_destroy_setup(s);
+  pffftd_aligned_free(X);
+  pffftd_aligned_free(Y);
+  pffftd_aligned_free(Z);
+  pffftd_aligned_free(A);
+  pffftd_aligned_free(B);
+  pffftd_aligned_free(W);
+#endif
+  free(R);
+  free(C);
+  if (!retError)
+    printf("2D %s fft of size %d x %d successful\n", (cplx ? "complex" : "real"), Nrows, N);
+  return retError;
+}
+
 /* small functions inside pffft.c that will detect (compiler) bugs with respect to simd instructions */
 void validate_pffft_simd();
 int  validate_pffft_simd_ex(FILE * DbgOut);
@@ -348,10 +1570,75 @@ int main(int argc, char **argv)
     resN |= result;
     resFFT |= result;
 
+    result = test_batch(N, 1 /* cplx fft */, 1 /* useOrdered */)
+           | test_batch(N, 0 /* cplx fft */, 1 /* useOrdered */)
+           | test_batch(N, 1 /* cplx fft */, 0 /* useOrdered */)
+           | test_batch(N, 0 /* cplx fft */, 0 /* useOrdered */);
+    resN |= result;
+    resFFT |= result;
+
+#ifdef PFFFT_ENABLE_FLOAT
+    result = test_half(N, 1 /* cplx fft */, 1 /* useOrdered */)
+           | test_half(N, 0 /* cplx fft */, 1 /* useOrdered */)
+           | test_half(N, 1 /* cplx fft */, 0 /* useOrdered */)
+           | test_half(N, 0 /* cplx fft */, 0 /* useOrdered */);
+    resN |= result;
+    resFFT |= result;
+#endif
+
     if (!resN)
       printf("tests for size %d succeeded successfully.\n", N);
   }
 
+  /* native radix-7, -11 and -13 passes - and Bluestein's algorithm */
+  for ( k = 0; k < 2; ++k )
+  {
+#ifdef PFFFT_ENABLE_FLOAT
+    const int Nm = pffft_min_fft_size(k ? PFFFT_COMPLEX : PFFFT_REAL);
+#else
+    const int Nm = pffftd_min_fft_size(k ? PFFFT_COMPLEX : PFFFT_REAL);
+#endif
+    resFFT |= test_any_size(7 * Nm, k) | test_any_size(11 * Nm, k) | test_any_size(13 * Nm, k)
+            | test_any_size(2 * 7 * 11 * Nm, k) | test_any_size(3 * 5 * 13 * Nm, k);
+    resFFT |= test_any_size(2, k) | test_any_size(38, k) | test_any_size(2 * 97, k)
+            | test_any_size(2 * 1009, k) | test_any_size(Nm + 2, k);
+  }
+  resFFT |= test_any_size(1, 1) | test_any_size(5, 1) | test_any_size(97, 1) | test_any_size(1009, 1);
+
+  resFFT |= test_zconvolve_real(1024, 0) | test_zconvolve_real(1024, 1)
+          | test_zconvolve_real(3*256, 0) | test_zconvolve_real(5*64, 1);
+  resFFT |= test_zconvolve_transform_backward(1024, 0) | test_zconvolve_transform_backward(1024, 1)
+          | test_zconvolve_transform_backward(3*256, 0) | test_zconvolve_transform_backward(5*64, 1)
+          | test_zconvolve_transform_backward(64, 0) | test_zconvolve_transform_backward(97, 1);
+  resFFT |= test_zpower(1024, 0) | test_zpower(1024, 1) | test_zpower(3*256, 0) | test_zpower(5*64, 1)
+          | test_zpower(16384, 0) | test_zpower(2*97, 0) | test_zpower(97, 1);
+  resFFT |= test_zspectral_ops(1024, 0) | test_zspectral_ops(1024, 1) | test_zspectral_ops(3*256, 0)
+          | test_zspectral_ops(5*64, 1) | test_zspectral_ops(16384, 0) | test_zspectral_ops(4096, 1);
+  resFFT |= test_setup_cache(1024);
+#ifdef PFFFT_ENABLE_FLOAT
+  resFFT |= test_half_conversion();
+#endif
+  resFFT |= test_inplace_setup(1024, 0) | test_inplace_setup(1024, 1)
+          | test_inplace_setup(3*512, 0) | test_inplace_setup(5*256, 1);
+  resFFT |= test_serialize(1, 1024, 0) | test_serialize(1, 1024, 1)
+          | test_serialize(6, 512, 0) | test_serialize(5, 512, 1);
+
+  /* 2D transforms: odd/even numbers of rows, from the minimum row length
+     up to the sizes, where the wider SIMD architectures take over */
+  for ( k = 0; k <= 4; ++k )
+  {
+#ifdef PFFFT_ENABLE_FLOAT
+    const int Nc = pffft_nearest_transform_size(2, PFFFT_COMPLEX, 1) << k;  /* N >= 2 without SIMD */
+    const int Nr = pffft_min_fft_size(PFFFT_REAL) << k;
+#else
+    const int Nc = pffftd_nearest_transform_size(2, PFFFT_COMPLEX, 1) << k;
+    const int Nr = pffftd_min_fft_size(PFFFT_REAL) << k;
+#endif
+    result = test_2d(5, Nc, 1) | test_2d(8, Nc, 1)
+           | test_2d(2, Nr, 0) | test_2d(6, Nr, 0) | test_2d(8, Nr, 0);
+    resFFT |= result;
+  }
+
   if (!resFFT) {
 #ifdef PFFFT_ENABLE_FLOAT
     printf("all pffft transform tests (FORWARD/BACKWARD, REAL/COMPLEX, float) succeeded successfully.\n");
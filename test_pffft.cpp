@@ -56,6 +56,16 @@
 
 #define PWR2LOG(PWR) ((PWR) < 1E-30 ? 10.0 * log10(1E-30) : 10.0 * log10(PWR))
 
+template<typename A, typename B>
+bool
+equalValues(const A & a, const B & b, int n)
+{
+  for (int k = 0; k < n; ++k)
+    if (a[k] != b[k])
+      return false;
+  return true;
+}
+
 template<typename T>
 bool
 Ttest(int N, bool useOrdered)
@@ -68,6 +78,12 @@ Ttest(int N, bool useOrdered)
   const double EXPECTED_DYN_RANGE = Fft::isDoubleScalar() ? 215.0 : 140.0;
 
   assert(Fft::isPowerOfTwo(N));
+  if (N < Fft::minFFtsize()) {
+    // wider SIMD vectors raise the minimum transform size
+    printf("skipping %s fft of size %d: minimum size is %d\n", (cplx ? "cplx" : "real"), N,
+           Fft::minFFtsize());
+    return false;
+  }
 
   Fft fft = Fft(N);  // instantiate and prepareLength() for length N
 
@@ -247,11 +263,180 @@ Ttest(int N, bool useOrdered)
     }
   }
 
+  if (useOrdered) {
+    // batch of scaled copies of the last signal: has to match single transforms
+    const int count = 3;
+    const int S = fft.getSpectrumSize();
+    pffft::AlignedVector<T> Xb(count * N), Zb(count * N);
+    pffft::AlignedVector<FftComplex> Yb(count * S);
+    for (m = 0; m < count; ++m)
+      for (j = 0; j < N; ++j)
+        Xb[m * N + j] = X[j] * FftScalar(m + 1);
+
+    fft.forwardBatch(count, Xb, Yb);
+    fft.inverseBatch(count, Yb, Zb);
+    for (m = 0; m < count; ++m) {
+      fft.forward(&Xb[m * N], Y.data());
+      fft.inverse(Y.data(), Z.data());
+      for (j = 0; j < S; ++j) {
+        if (Y[j] != Yb[m * S + j]) {
+          retError = true;
+          printf("%s fft %d: forwardBatch() doesn't match forward() for signal %d!\n",
+                 (cplx ? "cplx" : "real"), N, m);
+          break;
+        }
+      }
+      for (j = 0; j < N; ++j) {
+        if (Z[j] != Zb[m * N + j]) {
+          retError = true;
+          printf("%s fft %d: inverseBatch() doesn't match inverse() for signal %d!\n",
+                 (cplx ? "cplx" : "real"), N, m);
+          break;
+        }
+      }
+    }
+  }
+
+  {
+    // Span<> API on (AlignedVector's) memory: has to deliver identical results
+    const int S = fft.getSpectrumSize();
+    pffft::AlignedVector<FftComplex> Yv = fft.spectrumVector();
+    pffft::AlignedVector<FftScalar> Rv = fft.internalLayoutVector();
+    pffft::AlignedVector<FftScalar> Cv = fft.internalLayoutVector();
+    pffft::AlignedVector<T> Zv = fft.valueVector();
+    pffft::Span<const T> xs(X);
+    pffft::Span<FftComplex> ys;
+    pffft::Span<T> zs;
+
+    if (useOrdered) {
+      fft.forward(X, Y);
+      ys = fft.forward(xs, Yv);
+      fft.inverse(Y, Z);
+      zs = fft.inverse(ys, Zv);
+    } else {
+      fft.forwardToInternalLayout(X, R);
+      pffft::Span<FftScalar> rs = fft.forwardToInternalLayout(xs, Rv);
+      fft.reorderSpectrum(R, Y);
+      ys = fft.reorderSpectrum(rs, Yv);
+      fft.inverseFromInternalLayout(R, Z);
+      zs = fft.inverseFromInternalLayout(rs, pffft::Span<T>(Zv.data(), N));
+      fft.convolve(R, R, Cv, FftScalar(1) / N);
+      rs = fft.convolve(rs, rs, rs, FftScalar(1) / N);   // may alias
+      if (rs.size() != fft.getInternalLayoutSize() || !equalValues(rs, Cv, rs.size())) {
+        retError = true;
+        printf("%s fft %d: convolve() with Span<> doesn't match AlignedVector<>!\n",
+               (cplx ? "cplx" : "real"), N);
+      }
+    }
+    if (ys.size() != S || !equalValues(ys, Y, S) || zs.size() != N || !equalValues(zs, Z, N)) {
+      retError = true;
+      printf("%s fft %d: Span<> API doesn't match AlignedVector<> API!\n",
+             (cplx ? "cplx" : "real"), N);
+    }
+  }
+
+  if (useOrdered) {
+    // 2D transform of identical rows: all energy is in row 0 of the spectrum
+    const int rows = 4;
+    const int S = fft.getSpectrumSize();
+    const double tol = (Fft::isDoubleScalar() ? 1E-9 : 1E-3) * N;
+    pffft::Fft2D<T> fft2d(rows, N);
+    pffft::AlignedVector<T> X2 = fft2d.valueVector(), Z2 = fft2d.valueVector();
+    pffft::AlignedVector<FftComplex> Y2 = fft2d.spectrumVector();
+    for (m = 0; m < rows; ++m)
+      for (j = 0; j < N; ++j)
+        X2[m * N + j] = X[j];
+
+    fft.forward(X, Y);
+    fft2d.forward(X2, Y2);
+    fft2d.inverse(Y2, Z2);
+    for (m = 0; m < rows && !retError; ++m) {
+      for (j = 0; j < S; ++j) {
+        const FftComplex expected = (m ? FftComplex(0) : Y[j] * FftScalar(rows));
+        if (std::abs(Y2[m * S + j] - expected) > tol) {
+          retError = true;
+          printf("%s fft %d: Fft2D::forward() of %d identical rows is wrong in row %d!\n",
+                 (cplx ? "cplx" : "real"), N, rows, m);
+          break;
+        }
+      }
+    }
+    for (j = 0; j < rows * N; ++j) {
+      if (std::abs(Z2[j] / FftScalar(rows * N) - X2[j]) > tol / N) {
+        retError = true;
+        printf("%s fft %d: Fft2D::inverse() doesn't restore the input!\n",
+               (cplx ? "cplx" : "real"), N);
+        break;
+      }
+    }
+  }
+
   // using the std::vector<> base classes .. no need for alignedFree() for X, Y, Z and R
 
   return retError;
 }
 
+// FixedFft<T, N> with AlignedArray<>s on the stack: has to match Fft<T>
+template<typename T, int N>
+bool
+TtestFixed()
+{
+  typedef pffft::FixedFft<T, N> Fft;
+  typedef typename Fft::Scalar  FftScalar;
+  typedef typename Fft::Complex FftComplex;
+
+  const bool cplx = Fft::isComplexTransform();
+  Fft fixed;
+  pffft::Fft<T> fft(N);
+  typename Fft::ValueArray X, Z;
+  typename Fft::SpectrumArray Y;
+  typename Fft::InternalLayoutArray R, C;
+  pffft::AlignedVector<T> Xv = fft.valueVector(), Zv = fft.valueVector();
+  pffft::AlignedVector<FftComplex> Yv = fft.spectrumVector();
+  pffft::AlignedVector<FftScalar> Rv = fft.internalLayoutVector();
+  int k;
+
+  if (!fixed.isValid() || fixed.getLength() != N || Fft::SpectrumSize != fft.getSpectrumSize()
+      || Fft::InternalLayoutSize != fft.getInternalLayoutSize()
+      || !Fft::isSimdAligned(X.data()) || !Fft::isSimdAligned(Y.data())) {
+    printf("%s FixedFft<%d>: invalid setup!\n", (cplx ? "cplx" : "real"), N);
+    return true;
+  }
+
+  for (k = 0; k < N; ++k)
+    X[k] = Xv[k] = T( FftScalar( (k * 7919) % 257 ) / FftScalar(256) );
+  fixed.forward(X, Y);
+  fft.forward(Xv, Yv);
+  fixed.inverse(Y, Z);
+  fft.inverse(Yv, Zv);
+  fixed.forwardToInternalLayout(X, R);
+  fft.forwardToInternalLayout(Xv, Rv);
+  fixed.convolve(R, R, C, FftScalar(1));
+  fixed.convolveAccumulate(R, R, C, FftScalar(-1));
+
+  bool retError = !equalValues(Y, Yv, Fft::SpectrumSize) || !equalValues(Z, Zv, N)
+                  || !equalValues(R, Rv, Fft::InternalLayoutSize);
+  for (k = 0; k < Fft::InternalLayoutSize; ++k)
+    if (std::abs(C[k]) > FftScalar(1E-6) * N * N)
+      retError = true;
+  if (retError)
+    printf("%s FixedFft<%d> doesn't match Fft!\n", (cplx ? "cplx" : "real"), N);
+  return retError;
+}
+
+bool
+testFixed()
+{
+  return false
+#ifdef PFFFT_ENABLE_FLOAT
+    || TtestFixed< float, 1024 >() || TtestFixed< std::complex<float>, 480 >()
+#endif
+#ifdef PFFFT_ENABLE_DOUBLE
+    || TtestFixed< double, 1024 >() || TtestFixed< std::complex<double>, 480 >()
+#endif
+    ;
+}
+
 bool
 test(int N, bool useComplex, bool useOrdered)
 {
@@ -285,7 +470,7 @@ test(int N, bool useComplex, bool useOrdered)
 int
 main(int argc, char** argv)
 {
-  int N, result, resN, resAll, k, resNextPw2, resIsPw2, resFFT;
+  int N, result, resN, resAll, k, resNextPw2, resIsPw2, resFFT, resFixed;
 
   int inp_power_of_two[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 511, 512, 513 };
   int ref_power_of_two[] = { 1, 2, 4, 4, 8, 8, 8, 8, 16, 512, 512, 1024 };
@@ -367,7 +552,11 @@ main(int argc, char** argv)
 #endif
            ") succeeded successfully.\n");
 
-  resAll = resNextPw2 | resIsPw2 | resFFT;
+  resFixed = testFixed() ? 1 : 0;
+  if (!resFixed)
+    printf("tests for FixedFft<> succeeded successfully.\n");
+
+  resAll = resNextPw2 | resIsPw2 | resFFT | resFixed;
   if (!resAll)
     printf("all tests succeeded successfully.\n");
   else
@@ -0,0 +1,253 @@
+/*
+  test of pffft_dct: DCT/DST of types II, III and IV against their
+  definitions - for SIMD-compatible lengths and others - in-place and
+  inverse, and the MDCT against its definition and for perfect
+  reconstruction. with '--bench', compare the execution time of DCT-II
+  and DCT-III against fftpack's cosqb() and cosqf().
+ */
+
+#include "pffft.h"
+#include "pffft_dct.h"
+#ifdef HAVE_FFTPACK
+#include "fftpack.h"
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_MSC_VER)
+#pragma warning( disable : 4244 )
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+static const char *type_names[] = { "DCT-II", "DCT-III", "DCT-IV", "DST-II", "DST-III", "DST-IV" };
+
+
+static void ref_dct(int N, pffft_dct_t type, const float *in, double *out)
+{
+  int k, n;
+  for (k = 0; k < N; ++k) {
+    double sum = 0.0;
+    for (n = 0; n < N; ++n) {
+      switch (type) {
+      case PFFFT_DCT_II:  sum += in[n] * cos(M_PI * (2*n+1) * k / (2.0 * N)); break;
+      case PFFFT_DCT_IV:  sum += in[n] * cos(M_PI * (2*n+1) * (2*k+1) / (4.0 * N)); break;
+      case PFFFT_DST_II:  sum += in[n] * sin(M_PI * (2*n+1) * (k+1) / (2.0 * N)); break;
+      case PFFFT_DST_IV:  sum += in[n] * sin(M_PI * (2*n+1) * (2*k+1) / (4.0 * N)); break;
+      /* type III: k is the output (sample) index, n the input (coefficient) index */
+      case PFFFT_DCT_III: sum += in[n] * (n == 0 ? 0.5 : cos(M_PI * (2*k+1) * n / (2.0 * N))); break;
+      case PFFFT_DST_III: sum += in[n] * (n == N-1 ? 0.5 * ((k & 1) ? -1 : 1) : sin(M_PI * (2*k+1) * (n+1) / (2.0 * N))); break;
+      }
+    }
+    out[k] = sum;
+  }
+}
+
+
+static int test_dct(int N, pffft_dct_t type)
+{
+  PFFFT_DCT_Setup *s = pffft_dct_new_setup(N, type);
+  pffft_dct_t inv_type = (type == PFFFT_DCT_II) ? PFFFT_DCT_III : (type == PFFFT_DCT_III) ? PFFFT_DCT_II
+                       : (type == PFFFT_DST_II) ? PFFFT_DST_III : (type == PFFFT_DST_III) ? PFFFT_DST_II : type;
+  PFFFT_DCT_Setup *si = pffft_dct_new_setup(N, inv_type);
+  float *x, *X, *Y, *work;
+  double *ref, maxRef = 0.0, err = 0.0, errInv = 0.0, maxX = 0.0;
+  int k, ret = 0;
+
+  if (!s || !si) {
+    printf("%s N = %d: setup failed!\n", type_names[type], N);
+    pffft_dct_destroy_setup(s);
+    pffft_dct_destroy_setup(si);
+    return 1;
+  }
+  x = (float*)pffft_aligned_malloc((size_t)N * sizeof(float));
+  X = (float*)pffft_aligned_malloc((size_t)N * sizeof(float));
+  Y = (float*)pffft_aligned_malloc((size_t)N * sizeof(float));
+  work = (float*)pffft_aligned_malloc((size_t)N * sizeof(float));
+  ref = (double*)malloc((size_t)N * sizeof(double));
+  for (k = 0; k < N; ++k) {
+    x[k] = (float)( (((k + 3) * 7919) % 1000) / 500.0 - 1.0 );
+    maxX = (fabs(x[k]) > maxX) ? fabs(x[k]) : maxX;
+  }
+
+  ref_dct(N, type, x, ref);
+  pffft_dct_transform(s, x, X, work);
+  for (k = 0; k < N; ++k) {
+    const double e = fabs(X[k] - ref[k]);
+    maxRef = (fabs(ref[k]) > maxRef) ? fabs(ref[k]) : maxRef;
+    err = (e > err) ? e : err;
+  }
+  err /= maxRef;
+
+  /* in-place gives the same */
+  memcpy(Y, x, (size_t)N * sizeof(float));
+  pffft_dct_transform(s, Y, Y, work);
+  if (memcmp(X, Y, (size_t)N * sizeof(float))) {
+    printf("%s N = %d: in-place transform differs!\n", type_names[type], N);
+    ret = 1;
+  }
+
+  /* inverse: N/2 * x */
+  pffft_dct_transform(si, X, Y, work);
+  for (k = 0; k < N; ++k) {
+    const double e = fabs(Y[k] * 2.0 / N - x[k]);
+    errInv = (e > errInv) ? e : errInv;
+  }
+  errInv /= maxX;
+
+  if (err > 1E-5 || errInv > 1E-5) {
+    printf("%s N = %d: relative error %g, inverse %g!\n", type_names[type], N, err, errInv);
+    ret = 1;
+  }
+  if (!ret)
+    printf("%s N = %d: relative error %g, inverse %g: successful\n", type_names[type], N, err, errInv);
+
+  pffft_dct_destroy_setup(s);
+  pffft_dct_destroy_setup(si);
+  pffft_aligned_free(x);
+  pffft_aligned_free(X);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(work);
+  free(ref);
+  return ret;
+}
+
+
+static int test_mdct(int M, int blocks)
+{
+  const int L = M * blocks;
+  PFFFT_MDCT *m = pffft_mdct_new(M, NULL);
+  float *x, *X, *y;
+  double maxErr = 0.0, maxRef = 0.0, recErr = 0.0;
+  int b, k, n, ret = 0;
+
+  if (!m) {
+    printf("MDCT M = %d: setup failed!\n", M);
+    return 1;
+  }
+  x = (float*)malloc((size_t)L * sizeof(float));
+  X = (float*)malloc((size_t)M * sizeof(float));
+  y = (float*)malloc((size_t)L * sizeof(float));
+  for (k = 0; k < L; ++k)
+    x[k] = (float)( (((k + 1) * 7919) % 1000) / 500.0 - 1.0 );
+
+  for (b = 0; b < blocks; ++b) {
+    pffft_mdct_forward(m, x + b * M, X);
+    /* definition: block of the 2M samples from x[(b-1)*M] on - with zeros before x[0] */
+    for (k = 0; k < M; ++k) {
+      double sum = 0.0, e;
+      for (n = 0; n < 2 * M; ++n) {
+        const int i = (b - 1) * M + n;
+        const double w = sin(M_PI * (n + 0.5) / (2.0 * M));
+        if (i >= 0)
+          sum += w * x[i] * cos(M_PI / M * (n + 0.5 + M / 2.0) * (k + 0.5));
+      }
+      e = fabs(X[k] - sum);
+      maxErr = (e > maxErr) ? e : maxErr;
+      maxRef = (fabs(sum) > maxRef) ? fabs(sum) : maxRef;
+    }
+    pffft_mdct_inverse(m, X, y + b * M);
+  }
+  maxErr /= maxRef;
+
+  /* perfect reconstruction - with a delay of M samples */
+  for (k = 0; k + M < L; ++k) {
+    const double e = fabs(y[k + M] - x[k]);
+    recErr = (e > recErr) ? e : recErr;
+  }
+  if (maxErr > 1E-5 || recErr > 1E-5) {
+    printf("MDCT M = %d: relative error %g, reconstruction error %g!\n", M, maxErr, recErr);
+    ret = 1;
+  }
+  else
+    printf("MDCT M = %d: relative error %g, reconstruction error %g: successful\n", M, maxErr, recErr);
+
+  pffft_mdct_destroy(m);
+  free(x);
+  free(X);
+  free(y);
+  return ret;
+}
+
+
+static void bench_dct(int N)
+{
+  const int iters = (1 << 24) / N;
+  PFFFT_DCT_Setup *s2 = pffft_dct_new_setup(N, PFFFT_DCT_II);
+  PFFFT_DCT_Setup *s3 = pffft_dct_new_setup(N, PFFFT_DCT_III);
+  float *x = (float*)pffft_aligned_malloc((size_t)N * sizeof(float));
+  float *work = (float*)pffft_aligned_malloc((size_t)N * sizeof(float));
+  clock_t t0, t1, t2;
+  int k, i;
+#ifdef HAVE_FFTPACK
+  float *wsave = (float*)malloc((3 * (size_t)N + 15) * sizeof(float));
+  clock_t t3, t4;
+  cosqi(N, wsave);
+#endif
+
+  for (k = 0; k < N; ++k)
+    x[k] = (float)( ((k * 7919) % 1000) / 500.0 - 1.0 );
+  t0 = clock();
+  for (i = 0; i < iters; ++i)
+    pffft_dct_transform(s2, x, x, work);
+  t1 = clock();
+  for (i = 0; i < iters; ++i)
+    pffft_dct_transform(s3, x, x, work);
+  t2 = clock();
+  printf("N = %5d: pffft_dct DCT-II %7.1f ns, DCT-III %7.1f ns", N,
+         1E9 * (t1 - t0) / CLOCKS_PER_SEC / iters, 1E9 * (t2 - t1) / CLOCKS_PER_SEC / iters);
+#ifdef HAVE_FFTPACK
+  for (i = 0; i < iters; ++i)
+    cosqb(N, x, wsave);
+  t3 = clock();
+  for (i = 0; i < iters; ++i)
+    cosqf(N, x, wsave);
+  t4 = clock();
+  printf(" - fftpack cosqb %7.1f ns, cosqf %7.1f ns",
+         1E9 * (t3 - t2) / CLOCKS_PER_SEC / iters, 1E9 * (t4 - t3) / CLOCKS_PER_SEC / iters);
+  free(wsave);
+#endif
+  printf("\n");
+
+  pffft_dct_destroy_setup(s2);
+  pffft_dct_destroy_setup(s3);
+  pffft_aligned_free(x);
+  pffft_aligned_free(work);
+}
+
+
+int main(int argc, char **argv)
+{
+  static const int sizes[] = { 32, 64, 96, 160, 256, 1024, 2 * 3 * 5 * 7 };
+  int ret = 0, t, i;
+
+  if (argc > 1 && !strcmp(argv[1], "--bench")) {
+    bench_dct(256);
+    bench_dct(1024);
+    bench_dct(4096);
+    return 0;
+  }
+
+  for (i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); ++i) {
+    for (t = 0; t < 6; ++t)
+      ret |= test_dct(sizes[i], (pffft_dct_t)t);
+  }
+  ret |= test_mdct(64, 9);
+  ret |= test_mdct(256, 5);
+
+  /* unsuitable parameters */
+  if (pffft_dct_new_setup(33, PFFFT_DCT_II) || pffft_mdct_new(33, NULL)) {
+    printf("pffft_dct_new_setup() / pffft_mdct_new() should fail for odd lengths!\n");
+    ret = 1;
+  }
+
+  printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+  return ret;
+}
@@ -0,0 +1,293 @@
+/*
+  test of pffft_fixed: compare the Q15 and Q31 transforms against a
+  DFT in double precision - for full scale and for small signals -
+  and a fast convolution against the direct circular convolution.
+  with '--bench', compare the execution times with pffft (float)
+ */
+
+#include "pffft.h"
+#include "pffft_fixed.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_MSC_VER)
+#pragma warning( disable : 4244 )
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+/* reference: ordered spectrum as pffft_transform_ordered(), unscaled */
+static void ref_dft(const double *x, double *X, int N, int cplx)
+{
+  const int M = cplx ? N : N / 2 + 1;
+  int k, n;
+  for (k = 0; k < M; ++k) {
+    double re = 0.0, im = 0.0;
+    for (n = 0; n < N; ++n) {
+      const double phi = -2.0 * M_PI * (double)(((long long)k * n) % N) / N;
+      const double xr = cplx ? x[2 * n] : x[n];
+      const double xi = cplx ? x[2 * n + 1] : 0.0;
+      re += xr * cos(phi) - xi * sin(phi);
+      im += xr * sin(phi) + xi * cos(phi);
+    }
+    if (cplx) {
+      X[2 * k] = re;
+      X[2 * k + 1] = im;
+    }
+    else if (k == 0)
+      X[0] = re;
+    else if (k == N / 2)
+      X[1] = re;
+    else {
+      X[2 * k] = re;
+      X[2 * k + 1] = im;
+    }
+  }
+}
+
+static double rel_rms_err(const double *a, const double *ref, int n)
+{
+  double e = 0.0, p = 0.0;
+  int k;
+  for (k = 0; k < n; ++k) {
+    e += (a[k] - ref[k]) * (a[k] - ref[k]);
+    p += ref[k] * ref[k];
+  }
+  return sqrt(e / (p > 0.0 ? p : 1.0));
+}
+
+
+/* transform 'amplitude' scaled noise forward and backward, for both types */
+static int test_fixed(int N, int cplx, double amplitude)
+{
+  const pffft_transform_t transform = cplx ? PFFFT_COMPLEX : PFFFT_REAL;
+  const int n = cplx ? 2 * N : N;
+  PFFFT_Fixed_Setup *s = pffft_fixed_new_setup(N, transform);
+  int16_t *x15 = (int16_t*)malloc((size_t)n * sizeof(int16_t));
+  int16_t *y15 = (int16_t*)malloc((size_t)n * sizeof(int16_t));
+  int32_t *x31 = (int32_t*)malloc((size_t)n * sizeof(int32_t));
+  int32_t *y31 = (int32_t*)malloc((size_t)n * sizeof(int32_t));
+  double *x = (double*)malloc((size_t)n * sizeof(double));
+  double *X = (double*)malloc((size_t)n * sizeof(double));
+  double *R = (double*)malloc((size_t)n * sizeof(double));
+  double err[4];
+  int k, e, ret = 0;
+
+  if (!s) {
+    printf("%s N = %d: setup failed!\n", cplx ? "cplx" : "real", N);
+    return 1;
+  }
+
+  srand(N + (int)amplitude);
+  for (k = 0; k < n; ++k) {
+    x15[k] = (int16_t)floor( amplitude * ( 2.0 * rand() / RAND_MAX - 1.0 ) + 0.5 );
+    x31[k] = (int32_t)x15[k] * 65536;
+    x[k] = x15[k];
+  }
+  ref_dft(x, R, N, cplx);
+
+  /* Q15: forward ordered, then backward from the unordered spectrum */
+  e = pffft_fixed_transform_ordered_q15(s, x15, y15, PFFFT_FORWARD);
+  for (k = 0; k < n; ++k)
+    X[k] = ldexp(y15[k], e);
+  err[0] = rel_rms_err(X, R, n);
+  e = pffft_fixed_transform_q15(s, x15, y15, PFFFT_FORWARD);
+  e += pffft_fixed_transform_q15(s, y15, y15, PFFFT_BACKWARD);
+  for (k = 0; k < n; ++k)
+    X[k] = ldexp(y15[k], e) / N;
+  err[1] = rel_rms_err(X, x, n);
+
+  /* Q31: the same with 16 bits more */
+  e = pffft_fixed_transform_ordered_q31(s, x31, y31, PFFFT_FORWARD);
+  for (k = 0; k < n; ++k)
+    X[k] = ldexp(y31[k], e - 16);
+  err[2] = rel_rms_err(X, R, n);
+  e = pffft_fixed_transform_q31(s, x31, y31, PFFFT_FORWARD);
+  e += pffft_fixed_transform_q31(s, y31, y31, PFFFT_BACKWARD);
+  for (k = 0; k < n; ++k)
+    X[k] = ldexp(y31[k], e - 16) / N;
+  err[3] = rel_rms_err(X, x, n);
+
+  /* the block floating point keeps the relative precision for small signals */
+  if (err[0] > 3E-3 || err[1] > 3E-3 || err[2] > 5E-8 || err[3] > 5E-8) {
+    printf("%s N = %5d, amplitude %6g: relative errors Q15 %g / %g, Q31 %g / %g - too high!\n",
+           cplx ? "cplx" : "real", N, amplitude, err[0], err[1], err[2], err[3]);
+    ret = 1;
+  }
+  else
+    printf("%s N = %5d, amplitude %6g: relative errors Q15 %.2e / %.2e, Q31 %.2e / %.2e: OK\n",
+           cplx ? "cplx" : "real", N, amplitude, err[0], err[1], err[2], err[3]);
+
+  pffft_fixed_destroy_setup(s);
+  free(x15);
+  free(y15);
+  free(x31);
+  free(y31);
+  free(x);
+  free(X);
+  free(R);
+  return ret;
+}
+
+
+/* circular convolution with the unordered spectra and pffft_fixed_zconvolve_q15() */
+static int test_zconvolve(int N, int cplx)
+{
+  const pffft_transform_t transform = cplx ? PFFFT_COMPLEX : PFFFT_REAL;
+  const int n = cplx ? 2 * N : N;
+  PFFFT_Fixed_Setup *s = pffft_fixed_new_setup(N, transform);
+  int16_t *a = (int16_t*)malloc((size_t)n * sizeof(int16_t));
+  int16_t *b = (int16_t*)malloc((size_t)n * sizeof(int16_t));
+  int16_t *A = (int16_t*)malloc((size_t)n * sizeof(int16_t));
+  int16_t *B = (int16_t*)malloc((size_t)n * sizeof(int16_t));
+  double *Y = (double*)malloc((size_t)n * sizeof(double));
+  double *R = (double*)calloc((size_t)n, sizeof(double));
+  double err;
+  int i, j, e, ea, eb, ret = 0;
+
+  srand(N);
+  for (i = 0; i < n; ++i) {
+    a[i] = (int16_t)( rand() % 20001 - 10000 );
+    b[i] = (int16_t)( (i < 32) ? rand() % 2001 - 1000 : 0 );   /* short filter */
+  }
+  for (i = 0; i < N; ++i) {
+    for (j = 0; j < N; ++j) {
+      const int m = (i + j) % N;
+      if (cplx) {
+        R[2 * m] += (double)a[2 * i] * b[2 * j] - (double)a[2 * i + 1] * b[2 * j + 1];
+        R[2 * m + 1] += (double)a[2 * i] * b[2 * j + 1] + (double)a[2 * i + 1] * b[2 * j];
+      }
+      else
+        R[m] += (double)a[i] * b[j];
+    }
+  }
+
+  ea = pffft_fixed_transform_q15(s, a, A, PFFFT_FORWARD);
+  eb = pffft_fixed_transform_q15(s, b, B, PFFFT_FORWARD);
+  e = pffft_fixed_zconvolve_q15(s, A, ea, B, eb, A);
+  e += pffft_fixed_transform_q15(s, A, A, PFFFT_BACKWARD);
+  for (i = 0; i < n; ++i)
+    Y[i] = ldexp(A[i], e) / N;
+  err = rel_rms_err(Y, R, n);
+
+  if (err > 3E-3) {
+    printf("%s N = %5d: fast convolution Q15: relative error %g - too high!\n", cplx ? "cplx" : "real", N, err);
+    ret = 1;
+  }
+  else
+    printf("%s N = %5d: fast convolution Q15: relative error %.2e: OK\n", cplx ? "cplx" : "real", N, err);
+
+  pffft_fixed_destroy_setup(s);
+  free(a);
+  free(b);
+  free(A);
+  free(B);
+  free(Y);
+  free(R);
+  return ret;
+}
+
+
+static double wall_seconds(void)
+{
+#if defined(CLOCK_MONOTONIC) && !defined(_WIN32)
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1E-9 * ts.tv_nsec;
+#else
+  return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+static void bench_fixed(int N, int cplx)
+{
+  const pffft_transform_t transform = cplx ? PFFFT_COMPLEX : PFFFT_REAL;
+  const int n = cplx ? 2 * N : N;
+  const int iters = (1 << 22) / N;
+  PFFFT_Setup *ref = pffft_new_setup(N, transform);
+  PFFFT_Fixed_Setup *s = pffft_fixed_new_setup(N, transform);
+  float *X = (float*)pffft_aligned_malloc((size_t)n * sizeof(float));
+  float *Y = (float*)pffft_aligned_malloc((size_t)n * sizeof(float));
+  float *W = (float*)pffft_aligned_malloc((size_t)n * sizeof(float));
+  int16_t *x15 = (int16_t*)malloc((size_t)n * sizeof(int16_t));
+  int16_t *y15 = (int16_t*)malloc((size_t)n * sizeof(int16_t));
+  int32_t *x31 = (int32_t*)malloc((size_t)n * sizeof(int32_t));
+  int32_t *y31 = (int32_t*)malloc((size_t)n * sizeof(int32_t));
+  double t0, t_ref = 0.0, t15, t31;
+  int k;
+
+  for (k = 0; k < n; ++k) {
+    x15[k] = (int16_t)( rand() % 65536 - 32768 );
+    x31[k] = (int32_t)x15[k] * 65536;
+    X[k] = x15[k];
+  }
+  if (ref) {
+    t0 = wall_seconds();
+    for (k = 0; k < iters; ++k)
+      pffft_transform(ref, X, Y, W, PFFFT_FORWARD);
+    t_ref = (wall_seconds() - t0) / iters;
+  }
+  t0 = wall_seconds();
+  for (k = 0; k < iters; ++k)
+    pffft_fixed_transform_q15(s, x15, y15, PFFFT_FORWARD);
+  t15 = (wall_seconds() - t0) / iters;
+  t0 = wall_seconds();
+  for (k = 0; k < iters; ++k)
+    pffft_fixed_transform_q31(s, x31, y31, PFFFT_FORWARD);
+  t31 = (wall_seconds() - t0) / iters;
+  printf("%s N = %6d: pffft float %8.2f us, Q15 %8.2f us, Q31 %8.2f us (%s)\n",
+         cplx ? "cplx" : "real", N, 1E6 * t_ref, 1E6 * t15, 1E6 * t31, pffft_fixed_simd_arch());
+
+  pffft_aligned_free(X);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(W);
+  free(x15);
+  free(y15);
+  free(x31);
+  free(y31);
+  pffft_fixed_destroy_setup(s);
+  pffft_destroy_setup(ref);
+}
+
+
+int main(int argc, char **argv)
+{
+  const int sizes[] = { 4, 8, 16, 64, 256, 1024, 4096, 0 };
+  int k, cplx, ret = 0;
+
+  if (argc > 1 && !strcmp(argv[1], "--bench")) {
+    for (k = 6; k <= 16; k += 2)
+      for (cplx = 0; cplx < 2; ++cplx)
+        bench_fixed(1 << k, cplx);
+    return 0;
+  }
+
+  printf("pffft_fixed with %s\n", pffft_fixed_simd_arch());
+  for (k = 0; sizes[k]; ++k) {
+    for (cplx = 0; cplx < 2; ++cplx) {
+      ret |= test_fixed(sizes[k], cplx, 32767.0);
+      ret |= test_fixed(sizes[k], cplx, 100.0);
+    }
+  }
+  ret |= test_fixed(2, 1, 32767.0);
+  for (cplx = 0; cplx < 2; ++cplx) {
+    ret |= test_zconvolve(64, cplx);
+    ret |= test_zconvolve(1024, cplx);
+  }
+
+  /* unsuitable sizes */
+  if (pffft_fixed_new_setup(96, PFFFT_COMPLEX) || pffft_fixed_new_setup(2, PFFFT_REAL)) {
+    printf("pffft_fixed_new_setup() should fail for N = 96 or real N = 2!\n");
+    ret = 1;
+  }
+
+  printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+  return ret;
+}
@@ -0,0 +1,216 @@
+/*
+  test of pffft_fourstep: compare against pffft_transform_ordered() -
+  also pffft_fourstep_transform_inplace() - and with '--bench', compare the execution times for large N
+ */
+
+#include "pffft.h"
+#include "pffft_fourstep.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_MSC_VER)
+#pragma warning( disable : 4244 )
+#endif
+
+
+/* trivial caller provided "pool": count calls and run sequentially */
+static void serial_parallel_for(void *pool, int count, void (*task)(void *task_arg, int k), void *task_arg)
+{
+  int k;
+  ++*(int*)pool;
+  for (k = count - 1; k >= 0; --k)
+    task(task_arg, k);
+}
+
+
+static double rel_rms_err(const float *a, const float *ref, int n)
+{
+  double e = 0.0, p = 0.0;
+  int k;
+  for (k = 0; k < n; ++k) {
+    e += (a[k] - ref[k]) * (double)(a[k] - ref[k]);
+    p += ref[k] * (double)ref[k];
+  }
+  return sqrt(e / (p > 0.0 ? p : 1.0));
+}
+
+
+static int test_fourstep(int N, int cplx, int num_tasks, int use_pool, int in_place)
+{
+  const pffft_transform_t transform = cplx ? PFFFT_COMPLEX : PFFFT_REAL;
+  const int Nfloat = cplx ? 2 * N : N;
+  int ret = 0, k, pool_calls = 0, N1 = 0, N2 = 0;
+  double err_fwd, err_bwd;
+  PFFFT_Setup *ref;
+  PFFFT_FourStep_Setup *s;
+  float *X, *Y, *Z, *R, *W;
+
+  ref = pffft_new_setup(N, transform);
+  s = pffft_fourstep_new_setup(N, transform, num_tasks,
+                               use_pool ? serial_parallel_for : NULL, &pool_calls);
+  if (!ref || !s) {
+    printf("%s N = %d: setup failed!\n", cplx ? "cplx" : "real", N);
+    pffft_destroy_setup(ref);
+    pffft_fourstep_destroy_setup(s);
+    return 1;
+  }
+  pffft_fourstep_factors(s, &N1, &N2);
+
+  X = (float*)pffft_aligned_malloc((size_t)Nfloat * sizeof(float));
+  Y = (float*)pffft_aligned_malloc((size_t)Nfloat * sizeof(float));
+  Z = (float*)pffft_aligned_malloc((size_t)Nfloat * sizeof(float));
+  R = (float*)pffft_aligned_malloc((size_t)Nfloat * sizeof(float));
+  W = (float*)pffft_aligned_malloc((size_t)Nfloat * sizeof(float));
+
+  srand(N);
+  for (k = 0; k < Nfloat; ++k)
+    X[k] = (float)rand() / RAND_MAX - 0.5f;
+
+  pffft_transform_ordered(ref, X, R, W, PFFFT_FORWARD);  /* too big for the stack */
+
+  if (in_place == 2) {
+    memcpy(Y, X, (size_t)Nfloat * sizeof(float));
+    pffft_fourstep_transform_inplace(s, Y, PFFFT_FORWARD);
+  } else if (in_place) {
+    memcpy(Y, X, (size_t)Nfloat * sizeof(float));
+    pffft_fourstep_transform_ordered(s, Y, Y, NULL, PFFFT_FORWARD);
+  } else {
+    pffft_fourstep_transform_ordered(s, X, Y, W, PFFFT_FORWARD);
+  }
+  err_fwd = rel_rms_err(Y, R, Nfloat);
+
+  if (in_place == 2) {
+    memcpy(Z, Y, (size_t)Nfloat * sizeof(float));
+    pffft_fourstep_transform_inplace(s, Z, PFFFT_BACKWARD);
+  } else if (in_place) {
+    memcpy(Z, Y, (size_t)Nfloat * sizeof(float));
+    pffft_fourstep_transform_ordered(s, Z, Z, W, PFFFT_BACKWARD);
+  } else {
+    pffft_fourstep_transform_ordered(s, Y, Z, W, PFFFT_BACKWARD);
+  }
+  for (k = 0; k < Nfloat; ++k)
+    Z[k] /= N;
+  err_bwd = rel_rms_err(Z, X, Nfloat);
+
+  if (err_fwd > 1E-5 || err_bwd > 1E-5) {
+    printf("%s N = %d = %d x %d, %d tasks%s%s: relative error forward %g, backward %g - too high!\n",
+           cplx ? "cplx" : "real", N, N1, N2, num_tasks, use_pool ? ", pool" : "",
+           in_place == 2 ? ", without work" : in_place ? ", in-place" : "", err_fwd, err_bwd);
+    ret = 1;
+  }
+  if (use_pool && pool_calls == 0) {
+    printf("%s N = %d: caller provided pool was not used!\n", cplx ? "cplx" : "real", N);
+    ret = 1;
+  }
+  if (!ret)
+    printf("%s N = %d = %d x %d, %d tasks%s%s: OK\n", cplx ? "cplx" : "real", N, N1, N2,
+           num_tasks, use_pool ? ", pool" : "",
+           in_place == 2 ? ", without work" : in_place ? ", in-place" : "");
+
+  pffft_aligned_free(X);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(Z);
+  pffft_aligned_free(R);
+  pffft_aligned_free(W);
+  pffft_fourstep_destroy_setup(s);
+  pffft_destroy_setup(ref);
+  return ret;
+}
+
+
+static double wall_seconds(void)
+{
+#if defined(CLOCK_MONOTONIC) && !defined(_WIN32)
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1E-9 * ts.tv_nsec;
+#else
+  return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+static void bench_fourstep(int N, int cplx, int num_tasks)
+{
+  const pffft_transform_t transform = cplx ? PFFFT_COMPLEX : PFFFT_REAL;
+  const int Nfloat = cplx ? 2 * N : N;
+  const int iters = 8;
+  PFFFT_Setup *ref = pffft_new_setup(N, transform);
+  PFFFT_FourStep_Setup *s = pffft_fourstep_new_setup(N, transform, num_tasks, NULL, NULL);
+  float *X = (float*)pffft_aligned_malloc((size_t)Nfloat * sizeof(float));
+  float *Y = (float*)pffft_aligned_malloc((size_t)Nfloat * sizeof(float));
+  float *W = (float*)pffft_aligned_malloc((size_t)Nfloat * sizeof(float));
+  double t0, t_ref = 0.0, t_fs = 0.0, t_ip = 0.0;
+  int k;
+
+  for (k = 0; k < Nfloat; ++k)
+    X[k] = (float)rand() / RAND_MAX - 0.5f;
+  if (ref) {
+    t0 = wall_seconds();
+    for (k = 0; k < iters; ++k)
+      pffft_transform_ordered(ref, X, Y, W, PFFFT_FORWARD);
+    t_ref = (wall_seconds() - t0) / iters;
+  }
+  if (s) {
+    t0 = wall_seconds();
+    for (k = 0; k < iters; ++k)
+      pffft_fourstep_transform_ordered(s, X, Y, W, PFFFT_FORWARD);
+    t_fs = (wall_seconds() - t0) / iters;
+    t0 = wall_seconds();
+    for (k = 0; k < iters; ++k)
+      pffft_fourstep_transform_inplace(s, Y, PFFFT_FORWARD);
+    t_ip = (wall_seconds() - t0) / iters;
+  }
+  printf("%s N = %8d: pffft %9.3f ms, fourstep with %d tasks %9.3f ms, in place %9.3f ms\n",
+         cplx ? "cplx" : "real", N, 1E3 * t_ref, num_tasks, 1E3 * t_fs, 1E3 * t_ip);
+
+  pffft_aligned_free(X);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(W);
+  pffft_fourstep_destroy_setup(s);
+  pffft_destroy_setup(ref);
+}
+
+
+int main(int argc, char **argv)
+{
+  /* in units of the square of the minimum complex size: N1 and N2 need to be
+     valid sizes. with SSE, that's N = 4096, 2^14, 3 * 2^12, 5 * 9 * 2^10, 2^16 */
+  const int units[] = { 16, 64, 48, 180, 256, 0 };
+  const int Nmin = pffft_min_fft_size(PFFFT_COMPLEX);
+  int k, cplx, ret = 0;
+
+  if (argc > 1 && !strcmp(argv[1], "--bench")) {
+    const int num_tasks = (argc > 2) ? atoi(argv[2]) : 0;
+    for (k = 16; k <= 24; k += 2)
+      for (cplx = 0; cplx < 2; ++cplx)
+        bench_fourstep(1 << k, cplx, num_tasks);
+    return 0;
+  }
+
+  for (k = 0; units[k]; ++k) {
+    const int N = units[k] * Nmin * Nmin;
+    if (N > (1 << 22))  /* keeps the test short with the wide SIMD vectors */
+      continue;
+    for (cplx = 0; cplx < 2; ++cplx) {
+      ret |= test_fourstep(N, cplx, 1, 0, 0);
+      ret |= test_fourstep(N, cplx, 3, 0, 0);
+      ret |= test_fourstep(N, cplx, 4, 1, 0);
+      ret |= test_fourstep(N, cplx, 2, 0, 1);
+      ret |= test_fourstep(N, cplx, 3, 0, 2);
+      ret |= test_fourstep(N, cplx, 2, 1, 2);
+    }
+  }
+
+  /* unsuitable sizes */
+  if (pffft_fourstep_new_setup(4096 + 2, PFFFT_REAL, 1, NULL, NULL)) {
+    printf("pffft_fourstep_new_setup() should fail for N = %d!\n", 4096 + 2);
+    ret = 1;
+  }
+
+  printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+  return ret;
+}
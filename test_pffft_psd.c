@@ -0,0 +1,281 @@
+/*
+  test of pffft_psd: the averaged power spectrum of real and complex
+  signals - with native and Bluestein sizes - against a direct DFT in
+  double precision, and the merged partial sums of several accumulators
+  against a single one. with '--bench', compare against the separate
+  passes of ordered transform, |X|^2 and sum per segment.
+ */
+
+#include "pffft_psd.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#if defined(_MSC_VER)
+#pragma warning( disable : 4244 )
+#endif
+
+
+static float frand(unsigned *state)
+{
+  *state = *state * 1664525u + 1013904223u;
+  return (float)((*state >> 8) / 8388608.0 - 1.0);
+}
+
+
+/* Welch's estimate with a direct DFT - in double */
+static void ref_psd(const float *x, int N, int ns, int numSegments, int hop, const float *win, double *P)
+{
+  const int nbins = (ns == 2) ? N : (N / 2 + 1);
+  double wsum2 = 0.0;
+  int m, b, n;
+
+  for (n = 0; n < N; ++n)
+    wsum2 += (double)win[n] * win[n];
+  for (b = 0; b < nbins; ++b)
+    P[b] = 0.0;
+  for (m = 0; m < numSegments; ++m) {
+    const float *s = x + (size_t)m * hop * ns;
+    for (b = 0; b < nbins; ++b) {
+      double re = 0.0, im = 0.0;
+      for (n = 0; n < N; ++n) {
+        const double ph = -2.0 * M_PI * (double)((long long)b * n % N) / N;
+        const double xr = win[n] * (double)s[ns * n], xi = (ns == 2) ? win[n] * (double)s[2 * n + 1] : 0.0;
+        re += xr * cos(ph) - xi * sin(ph);
+        im += xr * sin(ph) + xi * cos(ph);
+      }
+      P[b] += re * re + im * im;
+    }
+  }
+  for (b = 0; b < nbins; ++b)
+    P[b] /= numSegments * wsum2;
+}
+
+
+static int test_psd(int N, int hop, int numSegments, pffft_transform_t transform, int userWindow)
+{
+  const int ns = (transform == PFFFT_COMPLEX) ? 2 : 1;
+  const int len = ns * ((numSegments - 1) * hop + N);
+  const char *name = (ns == 2) ? "complex" : "real";
+  PFFFT_PSD *psd;
+  PFFFT_PSD_Acc *acc;
+  float *x = (float*)malloc((size_t)len * sizeof(float));
+  float *win = (float*)malloc((size_t)N * sizeof(float));
+  float *P;
+  double *R, maxErr = 0.0, maxP = 0.0;
+  unsigned state = 777u + (unsigned)N;
+  int k, nbins, ret = 0;
+
+  for (k = 0; k < len; ++k)
+    x[k] = frand(&state);
+  /* a tone on top of the noise */
+  for (k = 0; k < len / ns; ++k)
+    x[ns * k] += 4.0f * (float)cos(2.0 * M_PI * 5.3 * k / N);
+  for (k = 0; k < N; ++k)
+    win[k] = userWindow ? (float)(0.54 - 0.46 * cos(2.0 * M_PI * k / N)) : (float)(0.5 - 0.5 * cos(2.0 * M_PI * k / N));
+
+  psd = pffft_psd_new(N, transform, userWindow ? win : NULL);
+  acc = psd ? pffft_psd_acc_new(psd) : NULL;
+  if (!acc) {
+    printf("%s PSD N = %d: setup failed!\n", name, N);
+    pffft_psd_destroy(psd);
+    free(x);
+    free(win);
+    return 1;
+  }
+  nbins = pffft_psd_bins(psd);
+  P = (float*)malloc((size_t)nbins * sizeof(float));
+  R = (double*)malloc((size_t)nbins * sizeof(double));
+
+  /* in two calls */
+  pffft_psd_accumulate(acc, x, numSegments / 2, hop);
+  pffft_psd_accumulate(acc, x + (size_t)ns * (numSegments / 2) * hop, numSegments - numSegments / 2, hop);
+  pffft_psd_read(acc, P);
+  ref_psd(x, N, ns, numSegments, hop, win, R);
+
+  for (k = 0; k < nbins; ++k)
+    maxP = (R[k] > maxP) ? R[k] : maxP;
+  for (k = 0; k < nbins; ++k) {
+    const double e = fabs(P[k] - R[k]) / maxP;
+    maxErr = (e > maxErr) ? e : maxErr;
+  }
+  if (nbins != ((ns == 2) ? N : (N / 2 + 1)) || pffft_psd_acc_segments(acc) != numSegments || maxErr > 1E-4) {
+    printf("%s PSD N = %d hop %d, %d segments: relative error %g!\n", name, N, hop, numSegments, maxErr);
+    ret = 1;
+  }
+  else
+    printf("%s PSD N = %d hop %d, %d segments: relative error %g: successful\n", name, N, hop, numSegments, maxErr);
+
+  pffft_psd_acc_destroy(acc);
+  pffft_psd_destroy(psd);
+  free(x);
+  free(win);
+  free(P);
+  free(R);
+  return ret;
+}
+
+
+/* per-thread partial sums: segments split over three accumulators, merged - and reset */
+static int test_merge(int N, pffft_transform_t transform)
+{
+  const int ns = (transform == PFFFT_COMPLEX) ? 2 : 1;
+  const int hop = N / 2, numSegments = 700;   /* more than one fold of the float sums */
+  const int len = ns * ((numSegments - 1) * hop + N);
+  const int split[4] = { 0, 100, 450, 700 };
+  const char *name = (ns == 2) ? "complex" : "real";
+  PFFFT_PSD *psd = pffft_psd_new(N, transform, NULL);
+  PFFFT_PSD_Acc *all = pffft_psd_acc_new(psd);
+  PFFFT_PSD_Acc *part[3];
+  float *x = (float*)malloc((size_t)len * sizeof(float));
+  float *P = (float*)malloc((size_t)pffft_psd_bins(psd) * sizeof(float));
+  float *Q = (float*)malloc((size_t)pffft_psd_bins(psd) * sizeof(float));
+  double maxErr = 0.0, maxP = 0.0;
+  unsigned state = 99u;
+  int k, t, ret = 0;
+
+  for (k = 0; k < len; ++k)
+    x[k] = frand(&state);
+  pffft_psd_accumulate(all, x, numSegments, hop);
+  pffft_psd_read(all, P);
+
+  for (t = 0; t < 3; ++t) {
+    part[t] = pffft_psd_acc_new(psd);
+    pffft_psd_accumulate(part[t], x + (size_t)ns * split[t] * hop, split[t+1] - split[t], hop);
+  }
+  pffft_psd_acc_reset(all);
+  for (t = 0; t < 3; ++t)
+    pffft_psd_acc_merge(all, part[t]);
+  pffft_psd_read(all, Q);
+
+  for (k = 0; k < pffft_psd_bins(psd); ++k)
+    maxP = (P[k] > maxP) ? P[k] : maxP;
+  for (k = 0; k < pffft_psd_bins(psd); ++k) {
+    const double e = fabs((double)P[k] - Q[k]) / maxP;
+    maxErr = (e > maxErr) ? e : maxErr;
+  }
+  if (pffft_psd_acc_segments(all) != numSegments || maxErr > 1E-5) {
+    printf("%s PSD N = %d: merged partial sums differ by %g!\n", name, N, maxErr);
+    ret = 1;
+  }
+  else
+    printf("%s PSD N = %d: merged partial sums successful\n", name, N);
+
+  /* no segments: zeros */
+  pffft_psd_acc_reset(all);
+  pffft_psd_read(all, P);
+  for (k = 0; k < pffft_psd_bins(psd); ++k) {
+    if (P[k] != 0.0f) {
+      printf("%s PSD N = %d: not zero after reset!\n", name, N);
+      ret = 1;
+      break;
+    }
+  }
+
+  for (t = 0; t < 3; ++t)
+    pffft_psd_acc_destroy(part[t]);
+  pffft_psd_acc_destroy(all);
+  pffft_psd_destroy(psd);
+  free(x);
+  free(P);
+  free(Q);
+  return ret;
+}
+
+
+/* real PSD: pffft_psd against window, ordered transform, |X|^2 and sum passes */
+static void bench_psd(int N)
+{
+  const int hop = N / 2, numSegments = (1 << 22) / hop;
+  const int len = (numSegments - 1) * hop + N;
+  PFFFT_PSD *psd = pffft_psd_new(N, PFFFT_REAL, NULL);
+  PFFFT_PSD_Acc *acc = pffft_psd_acc_new(psd);
+  PFFFT_Setup *ps = pffft_new_setup(N, PFFFT_REAL);
+  float *x = (float*)malloc((size_t)len * sizeof(float));
+  float *P = (float*)malloc((size_t)(N / 2 + 1) * sizeof(float));
+  float *win = (float*)malloc((size_t)N * sizeof(float));
+  float *X = (float*)pffft_aligned_malloc((size_t)N * sizeof(float));
+  float *Y = (float*)pffft_aligned_malloc((size_t)N * sizeof(float));
+  float *W = (float*)pffft_aligned_malloc((size_t)N * sizeof(float));
+  float *pw = (float*)pffft_aligned_malloc((size_t)(N / 2 + 1) * sizeof(float));
+  clock_t t0, t1, t2, t_psd = 0, t_sep = 0;
+  int k, b, m, r;
+
+  for (k = 0; k < len; ++k)
+    x[k] = (float)( (((k % 1000) * 7919) % 1000) / 500.0 - 1.0 );
+  for (k = 0; k < N; ++k)
+    win[k] = (float)( 0.5 - 0.5 * cos(2.0 * M_PI * k / N) );
+
+  /* best of 5 runs */
+  for (r = 0; r < 5; ++r) {
+    pffft_psd_acc_reset(acc);
+    memset(P, 0, (size_t)(N / 2 + 1) * sizeof(float));
+    t0 = clock();
+    pffft_psd_accumulate(acc, x, numSegments, hop);
+    pffft_psd_read(acc, P);
+    t1 = clock();
+    for (m = 0; m < numSegments; ++m) {
+      const float *s = x + (size_t)m * hop;
+      for (k = 0; k < N; ++k)
+        X[k] = win[k] * s[k];
+      pffft_transform_ordered(ps, X, Y, W, PFFFT_FORWARD);
+      pw[0] = Y[0] * Y[0];
+      pw[N/2] = Y[1] * Y[1];
+      for (b = 1; b < N/2; ++b)
+        pw[b] = Y[2*b] * Y[2*b] + Y[2*b+1] * Y[2*b+1];
+      for (b = 0; b <= N/2; ++b)
+        P[b] += pw[b];
+    }
+    t2 = clock();
+    if (r == 0 || t1 - t0 < t_psd)
+      t_psd = t1 - t0;
+    if (r == 0 || t2 - t1 < t_sep)
+      t_sep = t2 - t1;
+  }
+  printf("real PSD N = %5d hop %5d: %d segments, pffft_psd %7.2f ms, separate passes %7.2f ms\n",
+         N, hop, numSegments, 1E3 * t_psd / CLOCKS_PER_SEC, 1E3 * t_sep / CLOCKS_PER_SEC);
+
+  pffft_psd_acc_destroy(acc);
+  pffft_psd_destroy(psd);
+  pffft_destroy_setup(ps);
+  free(x);
+  free(P);
+  free(win);
+  pffft_aligned_free(X);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(W);
+  pffft_aligned_free(pw);
+}
+
+
+int main(int argc, char **argv)
+{
+  int ret = 0, t;
+
+  if (argc > 1 && !strcmp(argv[1], "--bench")) {
+    bench_psd(256);
+    bench_psd(1024);
+    bench_psd(4096);
+    return 0;
+  }
+
+  for (t = 0; t < 2; ++t) {
+    const pffft_transform_t transform = (t == 0) ? PFFFT_REAL : PFFFT_COMPLEX;
+    ret |= test_psd(256, 128, 9, transform, 0);
+    ret |= test_psd(3 * 128, 100, 5, transform, 1);
+    ret |= test_psd(512, 512, 3, transform, 0);
+    ret |= test_psd(2 * 97, 50, 6, transform, 0);     /* Bluestein */
+    ret |= test_merge(256, transform);
+    ret |= test_merge(2 * 97, transform);             /* Bluestein */
+  }
+
+  printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+  return ret;
+}
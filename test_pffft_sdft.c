@@ -0,0 +1,204 @@
+/*
+  test of pffft_sdft: compare the selected bins against the frames of
+  pffft_stft, over many hops - beyond the periodic recomputation - and
+  streamed in chunks of varying length. with '--bench', compare the
+  execution time against pffft_stft.
+ */
+
+#include "pffft.h"
+#include "pffft_sdft.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_MSC_VER)
+#pragma warning( disable : 4244 )
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+static int test_sdft(int N, int hop, int cplx, const int *bins, int numBins,
+                     pffft_sdft_window_t window, pffft_stft_output_t output, int L)
+{
+  static const char *names[] = { "spectrum", "magnitude", "power" };
+  const int ns = cplx ? 2 : 1;
+  const int chunks[] = { 1, 7, 100, 3, 1000, 64 };
+  const int vpb = (output == PFFFT_STFT_SPECTRUM) ? 2 : 1;   /* values per bin */
+  PFFFT_SDFT *s;
+  PFFFT_STFT *ref;
+  float *x, *win, *A, *B, *R;
+  double maxErr = 0.0;
+  int k, m, i, c, r, fs, rfs, nframes, nA, nB, nR, ret = 0;
+
+  win = (float*)malloc((size_t)N * sizeof(float));
+  for (k = 0; k < N; ++k)
+    win[k] = 1.0f;
+  s = pffft_sdft_new(N, hop, cplx ? PFFFT_COMPLEX : PFFFT_REAL, bins, numBins, window, output);
+  ref = pffft_stft_new(N, hop, cplx ? PFFFT_COMPLEX : PFFFT_REAL,
+                       (window == PFFFT_SDFT_RECT) ? win : NULL, output);
+  if (!s || !ref) {
+    printf("%s SDFT N = %d hop %d: setup failed!\n", cplx ? "cplx" : "real", N, hop);
+    pffft_sdft_destroy(s);
+    pffft_stft_destroy(ref);
+    free(win);
+    return 1;
+  }
+  fs = pffft_sdft_frame_size(s);
+  rfs = pffft_stft_frame_size(ref);
+  nframes = pffft_sdft_max_frames(s, L);
+  x = (float*)malloc((size_t)ns * L * sizeof(float));
+  A = (float*)malloc((size_t)nframes * fs * sizeof(float));
+  B = (float*)malloc((size_t)(nframes + 1) * fs * sizeof(float));
+  R = (float*)malloc((size_t)nframes * rfs * sizeof(float));
+  for (k = 0; k < ns * L; ++k)
+    x[k] = (float)( (((k % 1000) * 7919) % 1000) / 500.0 - 1.0 );
+
+  /* all at once */
+  nA = pffft_sdft_process(s, x, L, A);
+  nR = pffft_stft_process(ref, x, L, R);
+
+  /* chunked: identical frames */
+  pffft_sdft_reset(s);
+  for (i = 0, c = 0, nB = 0; i < L; i += k, ++c) {
+    k = chunks[c % 6];
+    if (k > L - i)
+      k = L - i;
+    nB += pffft_sdft_process(s, x + ns * i, k, B + (size_t)nB * fs);
+  }
+
+  if (nA != nframes || nB != nframes || nR != nframes
+      || memcmp(A, B, (size_t)nframes * fs * sizeof(float))) {
+    printf("%s SDFT N = %d hop %d: %d / %d / %d frames of expected %d - or chunked output differs!\n",
+           cplx ? "cplx" : "real", N, hop, nA, nB, nR, nframes);
+    ret = 1;
+  }
+
+  for (m = 0; m < nframes; ++m) {
+    const float *a = A + (size_t)m * fs;
+    const float *f = R + (size_t)m * rfs;
+    double maxRef = 0.0, err = 0.0;
+    for (k = 0; k < rfs; ++k)
+      maxRef = (fabs(f[k]) > maxRef) ? fabs(f[k]) : maxRef;
+    for (r = 0; r < numBins; ++r) {
+      for (k = 0; k < vpb; ++k) {
+        const double e = fabs(a[vpb * r + k] - f[vpb * bins[r] + k]);
+        err = (e > err) ? e : err;
+      }
+    }
+    err /= (maxRef > 0.0 ? maxRef : 1.0);
+    maxErr = (err > maxErr) ? err : maxErr;
+  }
+  if (maxErr > 1E-5) {
+    printf("%s SDFT %s N = %d hop %d: relative error %g!\n", cplx ? "cplx" : "real", names[output], N, hop, maxErr);
+    ret = 1;
+  }
+  if (!ret)
+    printf("%s SDFT %s N = %d hop %d %s, %d bins: %d frames, relative error %g: successful\n",
+           cplx ? "cplx" : "real", names[output], N, hop, (window == PFFFT_SDFT_HANN) ? "hann" : "rect",
+           numBins, nframes, maxErr);
+
+  pffft_sdft_destroy(s);
+  pffft_stft_destroy(ref);
+  free(win);
+  free(x);
+  free(A);
+  free(B);
+  free(R);
+  return ret;
+}
+
+
+/* power of a few bins of a real signal: pffft_sdft against the full frames of pffft_stft */
+static void bench_sdft(int N, int hop, int numBins)
+{
+  const int L = 1 << 22;
+  int *bins = (int*)malloc((size_t)numBins * sizeof(int));
+  PFFFT_SDFT *s;
+  PFFFT_STFT *ref = pffft_stft_new(N, hop, PFFFT_REAL, NULL, PFFFT_STFT_POWER);
+  float *x = (float*)malloc((size_t)L * sizeof(float));
+  float *P, *Q;
+  clock_t t0, t1, t2, t_sdft = 0, t_stft = 0;
+  int k, r, frames = 0;
+
+  for (k = 0; k < numBins; ++k)
+    bins[k] = 1 + (int)( (long long)k * (N/2 - 2) / numBins );
+  s = pffft_sdft_new(N, hop, PFFFT_REAL, bins, numBins, PFFFT_SDFT_HANN, PFFFT_STFT_POWER);
+  P = (float*)malloc((size_t)pffft_sdft_max_frames(s, L) * numBins * sizeof(float));
+  Q = (float*)malloc((size_t)pffft_stft_max_frames(ref, L) * pffft_stft_frame_size(ref) * sizeof(float));
+  for (k = 0; k < L; ++k)
+    x[k] = (float)( (((k % 1000) * 7919) % 1000) / 500.0 - 1.0 );
+  memset(P, 0, (size_t)pffft_sdft_max_frames(s, L) * numBins * sizeof(float));
+  memset(Q, 0, (size_t)pffft_stft_max_frames(ref, L) * pffft_stft_frame_size(ref) * sizeof(float));
+
+  /* best of 5 runs */
+  for (r = 0; r < 5; ++r) {
+    pffft_sdft_reset(s);
+    pffft_stft_reset(ref);
+    t0 = clock();
+    frames = pffft_sdft_process(s, x, L, P);
+    t1 = clock();
+    pffft_stft_process(ref, x, L, Q);
+    t2 = clock();
+    if (r == 0 || t1 - t0 < t_sdft)
+      t_sdft = t1 - t0;
+    if (r == 0 || t2 - t1 < t_stft)
+      t_stft = t2 - t1;
+  }
+  printf("real power N = %5d hop %5d, %3d bins: %d frames, pffft_sdft %7.2f ms, pffft_stft %7.2f ms\n",
+         N, hop, numBins, frames, 1E3 * t_sdft / CLOCKS_PER_SEC, 1E3 * t_stft / CLOCKS_PER_SEC);
+
+  pffft_sdft_destroy(s);
+  pffft_stft_destroy(ref);
+  free(bins);
+  free(x);
+  free(P);
+  free(Q);
+}
+
+
+int main(int argc, char **argv)
+{
+  static const int bins1[] = { 0, 5, 17, 5, 31, 32 };
+  static const int bins2[] = { 1, 95, 96, 150, 191 };
+  int ret = 0, cplx, o;
+
+  if (argc > 1 && !strcmp(argv[1], "--bench")) {
+    bench_sdft(4096, 64, 1);
+    bench_sdft(4096, 64, 8);
+    bench_sdft(4096, 1024, 8);
+    bench_sdft(16384, 256, 4);
+    bench_sdft(16384, 256, 16);
+    bench_sdft(16384, 4096, 16);
+    return 0;
+  }
+
+  for (cplx = 0; cplx < 2; ++cplx) {
+    for (o = 0; o < 3; ++o) {
+      ret |= test_sdft(64, 3, cplx, bins1, 6, PFFFT_SDFT_RECT, (pffft_stft_output_t)o, 3000);
+      ret |= test_sdft(64, 3, cplx, bins1, 6, PFFFT_SDFT_HANN, (pffft_stft_output_t)o, 3000);
+    }
+    ret |= test_sdft(192, 50, cplx, bins2, cplx ? 5 : 3, PFFFT_SDFT_HANN, PFFFT_STFT_SPECTRUM, 192 * 20);
+    ret |= test_sdft(192, 1, cplx, bins2 + 1, 1, PFFFT_SDFT_RECT, PFFFT_STFT_SPECTRUM, 192 * 10);
+    ret |= test_sdft(64, 100, cplx, bins1, 6, PFFFT_SDFT_HANN, PFFFT_STFT_POWER, 2000);     /* hop > N */
+    ret |= test_sdft(1024, 256, cplx, bins2, 5, PFFFT_SDFT_RECT, PFFFT_STFT_SPECTRUM, 1024 * 20);
+  }
+
+  /* unsuitable parameters */
+  if (pffft_sdft_new(64, 3, PFFFT_REAL, bins2, 2, PFFFT_SDFT_RECT, PFFFT_STFT_POWER)) {
+    printf("pffft_sdft_new() should fail for real bins > N/2!\n");
+    ret = 1;
+  }
+  if (pffft_sdft_new(64, 0, PFFFT_COMPLEX, bins1, 2, PFFFT_SDFT_RECT, PFFFT_STFT_POWER)) {
+    printf("pffft_sdft_new() should fail for hop = 0!\n");
+    ret = 1;
+  }
+
+  printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+  return ret;
+}
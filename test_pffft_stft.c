@@ -0,0 +1,226 @@
+/*
+  test of pffft_stft: compare the frames against a DFT of the windowed input,
+  streamed in chunks of varying length, and with '--bench', compare the
+  execution time against separate window, transform and magnitude passes
+ */
+
+#include "pffft.h"
+#include "pffft_stft.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_MSC_VER)
+#pragma warning( disable : 4244 )
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+/* frame m of the windowed input x, as expected from pffft_stft */
+static void ref_frame(const float *x, const float *win, int N, int cplx, pffft_stft_output_t output, double *out)
+{
+  const int nbins = cplx ? N : (N/2 + 1);
+  int b, n;
+  for (b = 0; b < nbins; ++b) {
+    double re = 0.0, im = 0.0;
+    for (n = 0; n < N; ++n) {
+      const double phi = -2.0 * M_PI * (double)((long long)b * n % N) / N;
+      const double xr = win[n] * (double)(cplx ? x[2*n] : x[n]);
+      const double xi = cplx ? win[n] * (double)x[2*n+1] : 0.0;
+      re += xr * cos(phi) - xi * sin(phi);
+      im += xr * sin(phi) + xi * cos(phi);
+    }
+    if (output == PFFFT_STFT_SPECTRUM) {
+      out[2*b] = re;
+      out[2*b+1] = im;
+    }
+    else if (output == PFFFT_STFT_MAGNITUDE)
+      out[b] = sqrt(re * re + im * im);
+    else
+      out[b] = re * re + im * im;
+  }
+}
+
+
+static int test_stft(int N, int hop, int cplx, pffft_stft_output_t output, int rect)
+{
+  static const char *names[] = { "spectrum", "magnitude", "power" };
+  const int ns = cplx ? 2 : 1;
+  const int L = N + 7 * hop + 13;   /* samples */
+  const int chunks[] = { 1, 7, 100, 3, 1000, 64 };
+  PFFFT_STFT *s;
+  float *x, *win, *A, *B, *ring;
+  double *ref, maxErr = 0.0;
+  int k, m, i, c, fs, nframes, nA, nB, ringPos = 0, nring, ret = 0;
+
+  win = (float*)malloc((size_t)N * sizeof(float));
+  for (k = 0; k < N; ++k)
+    win[k] = rect ? 1.0f : (float)( 0.5 - 0.5 * cos(2.0 * M_PI * k / N) );
+  s = pffft_stft_new(N, hop, cplx ? PFFFT_COMPLEX : PFFFT_REAL, rect ? win : NULL, output);
+  if (!s) {
+    printf("%s STFT N = %d hop %d: setup failed!\n", cplx ? "cplx" : "real", N, hop);
+    free(win);
+    return 1;
+  }
+  fs = pffft_stft_frame_size(s);
+  nframes = pffft_stft_max_frames(s, L);
+  x = (float*)malloc((size_t)ns * L * sizeof(float));
+  A = (float*)malloc((size_t)nframes * fs * sizeof(float));
+  B = (float*)malloc((size_t)(nframes + 1) * fs * sizeof(float));
+  ring = (float*)malloc(3 * (size_t)fs * sizeof(float));
+  ref = (double*)malloc((size_t)fs * sizeof(double));
+  for (k = 0; k < ns * L; ++k)
+    x[k] = (float)( ((k * 7919) % 1000) / 500.0 - 1.0 );
+
+  /* all at once */
+  nA = pffft_stft_process(s, x, L, A);
+
+  /* chunked: identical frames - and into a ring of 3 frames */
+  pffft_stft_reset(s);
+  for (i = 0, c = 0, nB = 0; i < L; i += k, ++c) {
+    k = chunks[c % 6];
+    if (k > L - i)
+      k = L - i;
+    nB += pffft_stft_process(s, x + ns * i, k, B + (size_t)nB * fs);
+  }
+  pffft_stft_reset(s);
+  nring = pffft_stft_process_ring(s, x, L, ring, 3, &ringPos);
+
+  if (nA != nframes || nB != nframes || nring != nframes || ringPos != nframes % 3
+      || memcmp(A, B, (size_t)nframes * fs * sizeof(float))) {
+    printf("%s STFT N = %d hop %d: %d / %d / %d frames of expected %d - or chunked output differs!\n",
+           cplx ? "cplx" : "real", N, hop, nA, nB, nring, nframes);
+    ret = 1;
+  }
+  for (m = (nframes > 3 ? nframes - 3 : 0); m < nframes; ++m) {
+    if (memcmp(A + (size_t)m * fs, ring + (size_t)(m % 3) * fs, (size_t)fs * sizeof(float))) {
+      printf("%s STFT N = %d hop %d: frame %d in the ring differs!\n", cplx ? "cplx" : "real", N, hop, m);
+      ret = 1;
+    }
+  }
+
+  for (m = 0; m < nA && m < nframes; ++m) {
+    double maxRef = 0.0, err = 0.0;
+    ref_frame(x + (size_t)ns * m * hop, win, N, cplx, output, ref);
+    for (k = 0; k < fs; ++k) {
+      const double e = fabs(A[(size_t)m * fs + k] - ref[k]);
+      maxRef = (fabs(ref[k]) > maxRef) ? fabs(ref[k]) : maxRef;
+      err = (e > err) ? e : err;
+    }
+    err /= (maxRef > 0.0 ? maxRef : 1.0);
+    maxErr = (err > maxErr) ? err : maxErr;
+  }
+  if (maxErr > 1E-5) {
+    printf("%s STFT %s N = %d hop %d: relative error %g!\n", cplx ? "cplx" : "real", names[output], N, hop, maxErr);
+    ret = 1;
+  }
+  if (!ret)
+    printf("%s STFT %s N = %d hop %d%s: %d frames, relative error %g: successful\n",
+           cplx ? "cplx" : "real", names[output], N, hop, rect ? " (rect)" : "", nframes, maxErr);
+
+  pffft_stft_destroy(s);
+  free(win);
+  free(x);
+  free(A);
+  free(B);
+  free(ring);
+  free(ref);
+  return ret;
+}
+
+
+/* power spectrogram of a real signal: pffft_stft against window, ordered transform and |X|^2 passes */
+static void bench_stft(int N, int hop)
+{
+  const int L = 1 << 22;
+  const int nbins = N/2 + 1;
+  PFFFT_STFT *s = pffft_stft_new(N, hop, PFFFT_REAL, NULL, PFFFT_STFT_POWER);
+  PFFFT_Setup *ps = pffft_new_setup(N, PFFFT_REAL);
+  float *x = (float*)malloc((size_t)L * sizeof(float));
+  float *P = (float*)malloc((size_t)pffft_stft_max_frames(s, L) * nbins * sizeof(float));
+  float *win = (float*)malloc((size_t)N * sizeof(float));
+  float *X = (float*)pffft_aligned_malloc((size_t)N * sizeof(float));
+  float *Y = (float*)pffft_aligned_malloc((size_t)N * sizeof(float));
+  float *W = (float*)pffft_aligned_malloc((size_t)N * sizeof(float));
+  clock_t t0, t1, t2, t_stft = 0, t_sep = 0;
+  int k, b, m, r, frames = 0;
+
+  for (k = 0; k < L; ++k)
+    x[k] = (float)( (((k % 1000) * 7919) % 1000) / 500.0 - 1.0 );
+  for (k = 0; k < N; ++k)
+    win[k] = (float)( 0.5 - 0.5 * cos(2.0 * M_PI * k / N) );
+  memset(P, 0, (size_t)pffft_stft_max_frames(s, L) * nbins * sizeof(float));
+
+  /* best of 5 runs */
+  for (r = 0; r < 5; ++r) {
+    pffft_stft_reset(s);
+    t0 = clock();
+    frames = pffft_stft_process(s, x, L, P);
+    t1 = clock();
+    for (m = 0; m + N <= L; m += hop) {
+      float *p = P + (size_t)(m / hop) * nbins;
+      for (k = 0; k < N; ++k)
+        X[k] = win[k] * x[m + k];
+      pffft_transform_ordered(ps, X, Y, W, PFFFT_FORWARD);
+      p[0] = Y[0] * Y[0];
+      p[N/2] = Y[1] * Y[1];
+      for (b = 1; b < N/2; ++b)
+        p[b] = Y[2*b] * Y[2*b] + Y[2*b+1] * Y[2*b+1];
+    }
+    t2 = clock();
+    if (r == 0 || t1 - t0 < t_stft)
+      t_stft = t1 - t0;
+    if (r == 0 || t2 - t1 < t_sep)
+      t_sep = t2 - t1;
+  }
+  printf("real power STFT N = %5d hop %5d: %d frames, pffft_stft %7.2f ms, separate passes %7.2f ms\n",
+         N, hop, frames, 1E3 * t_stft / CLOCKS_PER_SEC, 1E3 * t_sep / CLOCKS_PER_SEC);
+
+  pffft_stft_destroy(s);
+  pffft_destroy_setup(ps);
+  free(x);
+  free(P);
+  free(win);
+  pffft_aligned_free(X);
+  pffft_aligned_free(Y);
+  pffft_aligned_free(W);
+}
+
+
+int main(int argc, char **argv)
+{
+  int ret = 0, cplx, o;
+
+  if (argc > 1 && !strcmp(argv[1], "--bench")) {
+    bench_stft(256, 64);
+    bench_stft(1024, 256);
+    bench_stft(4096, 1024);
+    bench_stft(4096, 4096);
+    return 0;
+  }
+
+  for (cplx = 0; cplx < 2; ++cplx) {
+    for (o = 0; o < 3; ++o) {
+      ret |= test_stft(256, 64, cplx, (pffft_stft_output_t)o, 0);
+      ret |= test_stft(256, 256, cplx, (pffft_stft_output_t)o, 1);
+    }
+    ret |= test_stft(3 * 128, 100, cplx, PFFFT_STFT_SPECTRUM, 0);
+    ret |= test_stft(128, 300, cplx, PFFFT_STFT_POWER, 1);          /* hop > N */
+    ret |= test_stft(2 * 97, 1, cplx, PFFFT_STFT_SPECTRUM, 0);      /* Bluestein */
+  }
+
+  /* unsuitable parameters */
+  if (pffft_stft_new(256, 0, PFFFT_REAL, NULL, PFFFT_STFT_POWER)) {
+    printf("pffft_stft_new() should fail for hop = 0!\n");
+    ret = 1;
+  }
+
+  printf("%s\n", ret ? "some tests FAILED!" : "all tests passed.");
+  return ret;
+}